@@ -19,9 +19,13 @@
 #ifndef MIRROR_PLAYER_IMPL_PROXY_H
 #define MIRROR_PLAYER_IMPL_PROXY_H
 
+#include <memory>
+#include <mutex>
+
 #include "cast_engine_common.h"
 #include "i_mirror_player_impl.h"
 #include "iremote_proxy.h"
+#include "mirror_input_ring.h"
 #include "oh_remote_control_event.h"
 
 namespace OHOS {
@@ -44,9 +48,20 @@ public:
 
     int32_t SetAppInfo(const AppInfo &appInfo) override;
     int32_t SetSurface(sptr<IBufferProducer> producer) override;
+    int32_t SetupInputRing(sptr<Ashmem> &ashmem) override;
+    int32_t DrainInputRing() override;
 
 private:
+    std::shared_ptr<MirrorInputRing> GetInputRing();
+    int32_t QueueInputEvent(MirrorInputRing::EventKind kind, const OHRemoteControlEvent &event);
+    int32_t NotifyInputRing();
+    int32_t SendInputEvent(uint32_t code, const OHRemoteControlEvent &event);
+
     static inline BrokerDelegator<MirrorPlayerImplProxy> delegator_;
+    std::mutex inputRingMutex_;
+    std::shared_ptr<MirrorInputRing> inputRing_;
+    // Set once the service can not hand out a ring, the events then go one binder call each.
+    bool isInputRingUnsupported_{ false };
 };
 } // namespace CastEngineClient
 } // namespace CastEngine
@@ -22,6 +22,7 @@
 #include "i_stream_player.h"
 #include "i_stream_player_ipc.h"
 #include "cast_engine_common.h"
+#include "stream_player_state_mirror.h"
 
 namespace OHOS {
 namespace CastEngine {
@@ -70,8 +71,12 @@ public:
     int32_t GetMediaCapabilities(std::string &jsonCapabilities) override;
 
 private:
+    bool IsServiceAlive();
+
     static const int GET_FAILED = -1;
     sptr<IStreamPlayerIpc> proxy_;
+    // Serves the getters locally while a listener is registered, as only then are the player events pushed here.
+    std::shared_ptr<StreamPlayerStateMirror> stateMirror_{ std::make_shared<StreamPlayerStateMirror>() };
 };
 } // namespace CastEngineClient
 } // namespace CastEngine
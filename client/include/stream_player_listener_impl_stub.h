@@ -24,13 +24,15 @@
 #include "cast_stub_helper.h"
 #include "iremote_stub.h"
 #include "pixel_map.h"
+#include "stream_player_state_mirror.h"
 
 namespace OHOS {
 namespace CastEngine {
 namespace CastEngineClient {
 class StreamPlayerListenerImplStub : public IRemoteStub<IStreamPlayerListenerImpl> {
 public:
-    explicit StreamPlayerListenerImplStub(std::shared_ptr<IStreamPlayerListener> userListener);
+    StreamPlayerListenerImplStub(std::shared_ptr<IStreamPlayerListener> userListener,
+        std::shared_ptr<StreamPlayerStateMirror> stateMirror);
     ~StreamPlayerListenerImplStub() override;
 
     int OnRemoteRequest(uint32_t code, MessageParcel &data, MessageParcel &reply, MessageOption &option) override;
@@ -75,6 +77,7 @@ private:
     void OnAvailableCapabilityChanged(const StreamCapability &streamCapability) override;
 
     std::shared_ptr<IStreamPlayerListener> userListener_;
+    std::shared_ptr<StreamPlayerStateMirror> stateMirror_;
 };
 } // namespace CastEngineClient
 } // namespace CastEngine
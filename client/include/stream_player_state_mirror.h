@@ -0,0 +1,92 @@
+/*
+ * Copyright (C) 2023-2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * Description: client side mirror of the stream player state, kept current by the pushed player events.
+ * Author: zhangge
+ * Create: 2023-06-05
+ */
+
+#ifndef STREAM_PLAYER_STATE_MIRROR_H
+#define STREAM_PLAYER_STATE_MIRROR_H
+
+#include <chrono>
+#include <mutex>
+#include <optional>
+
+#include "cast_engine_common.h"
+
+namespace OHOS {
+namespace CastEngine {
+namespace CastEngineClient {
+/*
+ * Serves the read only getters of the stream player without an IPC. Every field is filled by the event that reports
+ * it, and a getter whose field has not been reported yet returns false so that the caller asks the service instead.
+ * While playing, the position is extrapolated from the last report at the current speed, for at most
+ * MAX_POSITION_AGE_MS, as the service only syncs it every few seconds. A setter that succeeded updates its field
+ * right away, as the event that confirms it may come late or not at all.
+ */
+class StreamPlayerStateMirror {
+public:
+    StreamPlayerStateMirror() = default;
+    ~StreamPlayerStateMirror() = default;
+
+    void Invalidate();
+    void InvalidatePosition();
+
+    void OnVolumeSet(int volume);
+
+    void OnStateChanged(PlayerStates state);
+    void OnPositionChanged(int position, int duration);
+    void OnSeekDone(int position);
+    void OnVolumeChanged(int volume, int maxVolume);
+    void OnLoopModeChanged(LoopMode loopMode);
+    void OnPlaySpeedChanged(PlaybackSpeed speed);
+    void OnAvailableCapabilityChanged(const StreamCapability &streamCapability);
+
+    bool GetPlayerStatus(PlayerStates &playerStates);
+    bool GetPosition(int &position);
+    bool GetDuration(int &duration);
+    bool GetVolume(int &volume, int &maxVolume);
+    bool GetLoopMode(LoopMode &loopMode);
+    bool GetPlaySpeed(PlaybackSpeed &playbackSpeed);
+    bool GetAvailableCapability(StreamCapability &streamCapability);
+
+private:
+    static constexpr int64_t MAX_POSITION_AGE_MS = 15000;
+    static constexpr int64_t SPEED_SCALE = 1000;
+
+    struct Volume {
+        int volume;
+        int maxVolume;
+    };
+
+    static int64_t GetSpeedPerMille(PlaybackSpeed speed);
+    int64_t GetPositionLocked(std::chrono::steady_clock::time_point now) const;
+    void AnchorPositionLocked(int64_t position);
+    bool IsPlayingLocked() const;
+
+    std::mutex mutex_;
+    std::optional<PlayerStates> state_;
+    std::optional<int64_t> position_;
+    std::chrono::steady_clock::time_point positionTime_;
+    std::optional<int> duration_;
+    std::optional<Volume> volume_;
+    std::optional<LoopMode> loopMode_;
+    std::optional<PlaybackSpeed> speed_;
+    std::optional<StreamCapability> capability_;
+};
+} // namespace CastEngineClient
+} // namespace CastEngine
+} // namespace OHOS
+
+#endif // STREAM_PLAYER_STATE_MIRROR_H
@@ -91,43 +91,93 @@ int32_t MirrorPlayerImplProxy::Pause(const std::string &deviceId)
 
 int32_t MirrorPlayerImplProxy::DeliverInputEvent(const OHRemoteControlEvent &event)
 {
-    MessageParcel data, reply;
-    MessageOption option;
+    CLOGD("In, eventType:%d", static_cast<uint32_t>(event.eventType));
+    return QueueInputEvent(MirrorInputRing::EventKind::DELIVER, event);
+}
 
+int32_t MirrorPlayerImplProxy::InjectEvent(const OHRemoteControlEvent &event)
+{
     CLOGD("In, eventType:%d", static_cast<uint32_t>(event.eventType));
+    return QueueInputEvent(MirrorInputRing::EventKind::INJECT, event);
+}
 
-    if (!data.WriteInterfaceToken(GetDescriptor())) {
-        CLOGE("Failed to write the interface token");
-        return CAST_ENGINE_ERROR;
+std::shared_ptr<MirrorInputRing> MirrorPlayerImplProxy::GetInputRing()
+{
+    std::lock_guard<std::mutex> lock(inputRingMutex_);
+    if (inputRing_ || isInputRingUnsupported_) {
+        return inputRing_;
     }
-    if (!WriteRemoteControlEvent(data, event)) {
-        CLOGE("Failed to write the remote control event");
+
+    sptr<Ashmem> ashmem;
+    if (SetupInputRing(ashmem) == CAST_ENGINE_SUCCESS) {
+        inputRing_ = MirrorInputRing::Attach(ashmem);
+    }
+    if (!inputRing_) {
+        CLOGW("Input ring is unavailable, fall back to one ipc request per event");
+        isInputRingUnsupported_ = true;
+    }
+    return inputRing_;
+}
+
+/*
+ * Once the ring is up every event goes through it, so the order of the events never depends on the path they took.
+ * The result only tells whether the event was queued, the service logs the events it fails to handle.
+ */
+int32_t MirrorPlayerImplProxy::QueueInputEvent(MirrorInputRing::EventKind kind, const OHRemoteControlEvent &event)
+{
+    auto ring = GetInputRing();
+    if (!ring) {
+        return SendInputEvent(kind == MirrorInputRing::EventKind::INJECT ? INJECT_EVENT : DELIVER_INPUT_EVENT, event);
+    }
+
+    auto result = ring->Push(kind, event);
+    if (result == MirrorInputRing::PushResult::FULL) {
+        // The service fell behind, drain in place rather than drop or reorder the event.
+        int32_t ret = DrainInputRing();
+        if (ret != CAST_ENGINE_SUCCESS) {
+            return ret;
+        }
+        result = ring->Push(kind, event);
+    }
+    if (result == MirrorInputRing::PushResult::FULL) {
+        CLOGE("Input ring is still full after a drain");
         return CAST_ENGINE_ERROR;
     }
+    if (result == MirrorInputRing::PushResult::NOTIFY) {
+        int32_t ret = NotifyInputRing();
+        if (ret != CAST_ENGINE_SUCCESS) {
+            ring->ResetNotify();
+            return ret;
+        }
+    }
+    return CAST_ENGINE_SUCCESS;
+}
 
-    int32_t ret = Remote()->SendRequest(DELIVER_INPUT_EVENT, data, reply, option);
-    if (ret == ERR_UNKNOWN_TRANSACTION) {
-        CLOGE("No permission when deliver input event");
-        return ERR_NO_PERMISSION;
-    } else if (ret == ERR_INVALID_DATA) {
-        CLOGE("Invalid parameter when deliver input event");
-        return ERR_INVALID_PARAM;
-    } else if (ret != ERR_NONE) {
-        CLOGE("Failed to send ipc request when deliver input event");
+int32_t MirrorPlayerImplProxy::NotifyInputRing()
+{
+    MessageParcel data;
+    MessageParcel reply;
+    MessageOption option(MessageOption::TF_ASYNC);
+
+    if (!data.WriteInterfaceToken(GetDescriptor())) {
+        CLOGE("Failed to write the interface token");
         return CAST_ENGINE_ERROR;
     }
 
-    return reply.ReadInt32();
+    int32_t ret = Remote()->SendRequest(DRAIN_INPUT_RING, data, reply, option);
+    if (ret != ERR_NONE) {
+        CLOGE("Failed to send ipc request when notify input ring, ret:%{public}d", ret);
+        return CAST_ENGINE_ERROR;
+    }
+    return CAST_ENGINE_SUCCESS;
 }
 
-int32_t MirrorPlayerImplProxy::InjectEvent(const OHRemoteControlEvent &event)
+int32_t MirrorPlayerImplProxy::SendInputEvent(uint32_t code, const OHRemoteControlEvent &event)
 {
     MessageParcel data;
     MessageParcel reply;
     MessageOption option;
 
-    CLOGD("In, eventType:%d", static_cast<uint32_t>(event.eventType));
-
     if (!data.WriteInterfaceToken(GetDescriptor())) {
         CLOGE("Failed to write the interface token");
         return CAST_ENGINE_ERROR;
@@ -137,7 +187,7 @@ int32_t MirrorPlayerImplProxy::InjectEvent(const OHRemoteControlEvent &event)
         return CAST_ENGINE_ERROR;
     }
 
-    int32_t ret = Remote()->SendRequest(INJECT_EVENT, data, reply, option);
+    int32_t ret = Remote()->SendRequest(code, data, reply, option);
     if (ret == ERR_UNKNOWN_TRANSACTION) {
         CLOGE("No permission when deliver input event");
         return ERR_NO_PERMISSION;
@@ -279,6 +329,54 @@ int32_t MirrorPlayerImplProxy::SetSurface(sptr<IBufferProducer> producer)
     return reply.ReadInt32();
 }
 
+int32_t MirrorPlayerImplProxy::SetupInputRing(sptr<Ashmem> &ashmem)
+{
+    MessageParcel data;
+    MessageParcel reply;
+    MessageOption option;
+
+    if (!data.WriteInterfaceToken(GetDescriptor())) {
+        CLOGE("Failed to write the interface token");
+        return CAST_ENGINE_ERROR;
+    }
+
+    int32_t ret = Remote()->SendRequest(SETUP_INPUT_RING, data, reply, option);
+    if (ret == ERR_UNKNOWN_TRANSACTION) {
+        CLOGE("No permission when setting up input ring");
+        return ERR_NO_PERMISSION;
+    } else if (ret != ERR_NONE) {
+        CLOGE("Failed to send ipc request when setting up input ring");
+        return CAST_ENGINE_ERROR;
+    }
+    int32_t errorCode = reply.ReadInt32();
+    CHECK_AND_RETURN_RET_LOG(errorCode != CAST_ENGINE_SUCCESS, errorCode, "CastEngine Errors");
+    ashmem = reply.ReadAshmem();
+    return ashmem ? CAST_ENGINE_SUCCESS : CAST_ENGINE_ERROR;
+}
+
+int32_t MirrorPlayerImplProxy::DrainInputRing()
+{
+    MessageParcel data;
+    MessageParcel reply;
+    MessageOption option;
+
+    if (!data.WriteInterfaceToken(GetDescriptor())) {
+        CLOGE("Failed to write the interface token");
+        return CAST_ENGINE_ERROR;
+    }
+
+    int32_t ret = Remote()->SendRequest(DRAIN_INPUT_RING, data, reply, option);
+    if (ret == ERR_UNKNOWN_TRANSACTION) {
+        CLOGE("No permission when draining input ring");
+        return ERR_NO_PERMISSION;
+    } else if (ret != ERR_NONE) {
+        CLOGE("Failed to send ipc request when draining input ring");
+        return CAST_ENGINE_ERROR;
+    }
+
+    return reply.ReadInt32();
+}
+
 } // namespace CastEngineClient
 } // namespace CastEngine
 } // namespace OHOS
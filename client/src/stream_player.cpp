@@ -32,13 +32,26 @@ StreamPlayer::~StreamPlayer()
     CLOGD("destructor in");
 }
 
+bool StreamPlayer::IsServiceAlive()
+{
+    // The mirror stops being fed once the service is gone, the proxy then reports the error instead.
+    sptr<IRemoteObject> remote = proxy_ ? proxy_->AsObject() : nullptr;
+    if (remote == nullptr || remote->IsObjectDead()) {
+        stateMirror_->Invalidate();
+        return false;
+    }
+    return true;
+}
+
 int32_t StreamPlayer::RegisterListener(std::shared_ptr<IStreamPlayerListener> listener)
 {
     if (listener == nullptr) {
         CLOGE("listener is null");
         return ERR_INVALID_PARAM;
     }
-    sptr<IStreamPlayerListenerImpl> listenerStub = new (std::nothrow) StreamPlayerListenerImplStub(listener);
+    stateMirror_->Invalidate();
+    sptr<IStreamPlayerListenerImpl> listenerStub =
+        new (std::nothrow) StreamPlayerListenerImplStub(listener, stateMirror_);
     if (listenerStub == nullptr) {
         CLOGE("Failed to new a stream player listener");
         return CAST_ENGINE_ERROR;
@@ -49,6 +62,7 @@ int32_t StreamPlayer::RegisterListener(std::shared_ptr<IStreamPlayerListener> li
 
 int32_t StreamPlayer::UnregisterListener()
 {
+    stateMirror_->Invalidate();
     return proxy_ ? proxy_->UnregisterListener() : CAST_ENGINE_ERROR;
 }
 
@@ -119,7 +133,13 @@ int32_t StreamPlayer::Previous()
 
 int32_t StreamPlayer::Seek(int position)
 {
-    return proxy_ ? proxy_->Seek(position) : CAST_ENGINE_ERROR;
+    int32_t ret = proxy_ ? proxy_->Seek(position) : CAST_ENGINE_ERROR;
+    if (ret != CAST_ENGINE_SUCCESS) {
+        return ret;
+    }
+    // The position is unknown until the seek is done.
+    stateMirror_->InvalidatePosition();
+    return ret;
 }
 
 int32_t StreamPlayer::FastForward(int delta)
@@ -134,7 +154,12 @@ int32_t StreamPlayer::FastRewind(int delta)
 
 int32_t StreamPlayer::SetVolume(int volume)
 {
-    return proxy_ ? proxy_->SetVolume(volume) : CAST_ENGINE_ERROR;
+    int32_t ret = proxy_ ? proxy_->SetVolume(volume) : CAST_ENGINE_ERROR;
+    if (ret != CAST_ENGINE_SUCCESS) {
+        return ret;
+    }
+    stateMirror_->OnVolumeSet(volume);
+    return ret;
 }
 
 int32_t StreamPlayer::SetMute(bool mute)
@@ -144,7 +169,12 @@ int32_t StreamPlayer::SetMute(bool mute)
 
 int32_t StreamPlayer::SetLoopMode(const LoopMode mode)
 {
-    return proxy_ ? proxy_->SetLoopMode(mode) : CAST_ENGINE_ERROR;
+    int32_t ret = proxy_ ? proxy_->SetLoopMode(mode) : CAST_ENGINE_ERROR;
+    if (ret != CAST_ENGINE_SUCCESS) {
+        return ret;
+    }
+    stateMirror_->OnLoopModeChanged(mode);
+    return ret;
 }
 
 int32_t StreamPlayer::SetAvailableCapability(const StreamCapability &streamCapability)
@@ -154,7 +184,12 @@ int32_t StreamPlayer::SetAvailableCapability(const StreamCapability &streamCapab
 
 int32_t StreamPlayer::SetSpeed(const PlaybackSpeed speed)
 {
-    return proxy_ ? proxy_->SetSpeed(speed) : CAST_ENGINE_ERROR;
+    int32_t ret = proxy_ ? proxy_->SetSpeed(speed) : CAST_ENGINE_ERROR;
+    if (ret != CAST_ENGINE_SUCCESS) {
+        return ret;
+    }
+    stateMirror_->OnPlaySpeedChanged(speed);
+    return ret;
 }
 
 int32_t StreamPlayer::SendData(const DataType dataType, const std::string &dataStr)
@@ -164,21 +199,33 @@ int32_t StreamPlayer::SendData(const DataType dataType, const std::string &dataS
 
 int32_t StreamPlayer::GetPlayerStatus(PlayerStates &playerStates)
 {
+    if (IsServiceAlive() && stateMirror_->GetPlayerStatus(playerStates)) {
+        return CAST_ENGINE_SUCCESS;
+    }
     return proxy_ ? proxy_->GetPlayerStatus(playerStates) : CAST_ENGINE_ERROR;
 }
 
 int32_t StreamPlayer::GetPosition(int &position)
 {
+    if (IsServiceAlive() && stateMirror_->GetPosition(position)) {
+        return CAST_ENGINE_SUCCESS;
+    }
     return proxy_ ? proxy_->GetPosition(position) : CAST_ENGINE_ERROR;
 }
 
 int32_t StreamPlayer::GetDuration(int &duration)
 {
+    if (IsServiceAlive() && stateMirror_->GetDuration(duration)) {
+        return CAST_ENGINE_SUCCESS;
+    }
     return proxy_ ? proxy_->GetDuration(duration) : CAST_ENGINE_ERROR;
 }
 
 int32_t StreamPlayer::GetVolume(int &volume, int &maxVolume)
 {
+    if (IsServiceAlive() && stateMirror_->GetVolume(volume, maxVolume)) {
+        return CAST_ENGINE_SUCCESS;
+    }
     return proxy_ ? proxy_->GetVolume(volume, maxVolume) : CAST_ENGINE_ERROR;
 }
 
@@ -189,16 +236,25 @@ int32_t StreamPlayer::GetMute(bool &mute)
 
 int32_t StreamPlayer::GetLoopMode(LoopMode &loopMode)
 {
+    if (IsServiceAlive() && stateMirror_->GetLoopMode(loopMode)) {
+        return CAST_ENGINE_SUCCESS;
+    }
     return proxy_ ? proxy_->GetLoopMode(loopMode) : CAST_ENGINE_ERROR;
 }
 
 int32_t StreamPlayer::GetAvailableCapability(StreamCapability &streamCapability)
 {
+    if (IsServiceAlive() && stateMirror_->GetAvailableCapability(streamCapability)) {
+        return CAST_ENGINE_SUCCESS;
+    }
     return proxy_ ? proxy_->GetAvailableCapability(streamCapability) : CAST_ENGINE_ERROR;
 }
 
 int32_t StreamPlayer::GetPlaySpeed(PlaybackSpeed &playbackSpeed)
 {
+    if (IsServiceAlive() && stateMirror_->GetPlaySpeed(playbackSpeed)) {
+        return CAST_ENGINE_SUCCESS;
+    }
     return proxy_ ? proxy_->GetPlaySpeed(playbackSpeed) : CAST_ENGINE_ERROR;
 }
 
@@ -214,6 +270,7 @@ int32_t StreamPlayer::ProvideKeyResponse(const std::string &mediaId, const std::
 
 int32_t StreamPlayer::Release()
 {
+    stateMirror_->Invalidate();
     return proxy_ ? proxy_->Release() : CAST_ENGINE_ERROR;
 }
 
@@ -820,7 +820,7 @@ int32_t StreamPlayerImplProxy::ProvideKeyResponse(const std::string &mediaId, co
     }
 
     if (len != 0) {
-        if (!data.WriteBuffer(response.data(), len)) {
+        if (!data.WriteRawData(response.data(), len)) {
             CLOGE("StreamPlayerImplProxy ProvideKeyResponse write response failed");
             return IPC_PROXY_ERR;
         }
@@ -36,8 +36,8 @@ int StreamPlayerListenerImplStub::OnRemoteRequest(uint32_t code, MessageParcel &
     return EXECUTE_SINGLE_STUB_TASK(code, data, reply);
 }
 
-StreamPlayerListenerImplStub::StreamPlayerListenerImplStub(std::shared_ptr<IStreamPlayerListener> userListener)
-    : userListener_(userListener)
+StreamPlayerListenerImplStub::StreamPlayerListenerImplStub(std::shared_ptr<IStreamPlayerListener> userListener,
+    std::shared_ptr<StreamPlayerStateMirror> stateMirror) : userListener_(userListener), stateMirror_(stateMirror)
 {
     FILL_SINGLE_STUB_TASK(ON_PLAYER_STATUS_CHANGED, &StreamPlayerListenerImplStub::DoOnStateChangedTask);
     FILL_SINGLE_STUB_TASK(ON_POSITION_CHANGED, &StreamPlayerListenerImplStub::DoOnPositionChangedTask);
@@ -71,6 +71,9 @@ int32_t StreamPlayerListenerImplStub::DoOnStateChangedTask(MessageParcel &data,
     int32_t state = data.ReadInt32();
     bool isPlayWhenReady = data.ReadBool();
     PlayerStates playbackState = static_cast<PlayerStates>(state);
+    if (stateMirror_ != nullptr) {
+        stateMirror_->OnStateChanged(playbackState);
+    }
     userListener_->OnStateChanged(playbackState, isPlayWhenReady);
 
     return ERR_NONE;
@@ -82,6 +85,9 @@ int32_t StreamPlayerListenerImplStub::DoOnPositionChangedTask(MessageParcel &dat
     int32_t position = data.ReadInt32();
     int32_t bufferPosition = data.ReadInt32();
     int32_t duration = data.ReadInt32();
+    if (stateMirror_ != nullptr) {
+        stateMirror_->OnPositionChanged(position, duration);
+    }
     userListener_->OnPositionChanged(position, bufferPosition, duration);
 
     return ERR_NONE;
@@ -90,12 +96,12 @@ int32_t StreamPlayerListenerImplStub::DoOnPositionChangedTask(MessageParcel &dat
 int32_t StreamPlayerListenerImplStub::DoOnMediaItemChangedTask(MessageParcel &data, MessageParcel &reply)
 {
     static_cast<void>(reply);
-    auto mediaInfo = ReadMediaInfo(data);
-    if (mediaInfo == nullptr) {
+    MediaInfo mediaInfo;
+    if (!ReadMediaInfo(data, mediaInfo)) {
         CLOGE("DoOnMediaItemChangedTask,mediaInfo is null");
         return ERR_NULL_OBJECT;
     }
-    userListener_->OnMediaItemChanged(*mediaInfo);
+    userListener_->OnMediaItemChanged(mediaInfo);
 
     return ERR_NONE;
 }
@@ -105,6 +111,9 @@ int32_t StreamPlayerListenerImplStub::DoOnVolumeChangedTask(MessageParcel &data,
     static_cast<void>(reply);
     int32_t volume = data.ReadInt32();
     int32_t maxVolume = data.ReadInt32();
+    if (stateMirror_ != nullptr) {
+        stateMirror_->OnVolumeChanged(volume, maxVolume);
+    }
     userListener_->OnVolumeChanged(volume, maxVolume);
 
     return ERR_NONE;
@@ -115,6 +124,9 @@ int32_t StreamPlayerListenerImplStub::DoOnLoopModeChangedTask(MessageParcel &dat
     static_cast<void>(reply);
     int32_t mode = data.ReadInt32();
     LoopMode loopMode = static_cast<LoopMode>(mode);
+    if (stateMirror_ != nullptr) {
+        stateMirror_->OnLoopModeChanged(loopMode);
+    }
     userListener_->OnLoopModeChanged(loopMode);
 
     return ERR_NONE;
@@ -125,6 +137,9 @@ int32_t StreamPlayerListenerImplStub::DoOnPlaySpeedChangedTask(MessageParcel &da
     static_cast<void>(reply);
     int32_t speed = data.ReadInt32();
     PlaybackSpeed speedMode = static_cast<PlaybackSpeed>(speed);
+    if (stateMirror_ != nullptr) {
+        stateMirror_->OnPlaySpeedChanged(speedMode);
+    }
     userListener_->OnPlaySpeedChanged(speedMode);
 
     return ERR_NONE;
@@ -171,6 +186,9 @@ int32_t StreamPlayerListenerImplStub::DoOnSeekDoneTask(MessageParcel &data, Mess
 {
     static_cast<void>(reply);
     int32_t position = data.ReadInt32();
+    if (stateMirror_ != nullptr) {
+        stateMirror_->OnSeekDone(position);
+    }
     userListener_->OnSeekDone(position);
 
     return ERR_NONE;
@@ -188,12 +206,12 @@ int32_t StreamPlayerListenerImplStub::DoOnEndOfStreamTask(MessageParcel &data, M
 int32_t StreamPlayerListenerImplStub::DoOnPlayRequestTask(MessageParcel &data, MessageParcel &reply)
 {
     static_cast<void>(reply);
-    auto mediaInfo = ReadMediaInfo(data);
-    if (mediaInfo == nullptr) {
+    MediaInfo mediaInfo;
+    if (!ReadMediaInfo(data, mediaInfo)) {
         CLOGE("DoOnPlayRequestTask, mediaInfo is null");
         return ERR_NULL_OBJECT;
     }
-    userListener_->OnPlayRequest(*mediaInfo);
+    userListener_->OnPlayRequest(mediaInfo);
 
     return ERR_NONE;
 }
@@ -232,7 +250,7 @@ int32_t StreamPlayerListenerImplStub::DoOnKeyRequestTask(MessageParcel &data, Me
     std::string mediaId = data.ReadString();
     std::vector<uint8_t> request;
     int32_t requestSize = data.ReadInt32();
-    const uint8_t *requestBuf = data.ReadBuffer(static_cast<size_t>(requestSize));
+    const auto *requestBuf = static_cast<const uint8_t *>(data.ReadRawData(static_cast<size_t>(requestSize)));
     if (requestSize == 0 || requestBuf == nullptr) {
         CLOGE("invalid buffer, len = %{public}d", requestSize);
         return ERR_NULL_OBJECT;
@@ -247,6 +265,9 @@ int32_t StreamPlayerListenerImplStub::DoOnAvailableCapabilityChangedTask(Message
 {
     static_cast<void>(reply);
     auto streamCapability = ReadStreamCapability(data);
+    if (stateMirror_ != nullptr) {
+        stateMirror_->OnAvailableCapabilityChanged(streamCapability);
+    }
     userListener_->OnAvailableCapabilityChanged(streamCapability);
 
     return ERR_NONE;
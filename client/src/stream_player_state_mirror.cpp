@@ -0,0 +1,233 @@
+/*
+ * Copyright (C) 2023-2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * Description: client side mirror of the stream player state, kept current by the pushed player events.
+ * Author: zhangge
+ * Create: 2023-06-05
+ */
+
+#include "stream_player_state_mirror.h"
+
+#include <algorithm>
+
+namespace OHOS {
+namespace CastEngine {
+namespace CastEngineClient {
+void StreamPlayerStateMirror::Invalidate()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    state_.reset();
+    position_.reset();
+    duration_.reset();
+    volume_.reset();
+    loopMode_.reset();
+    speed_.reset();
+    capability_.reset();
+}
+
+void StreamPlayerStateMirror::InvalidatePosition()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    position_.reset();
+}
+
+void StreamPlayerStateMirror::OnVolumeSet(int volume)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    // Only the volume is set, the maximum still has to come from a report.
+    if (volume_.has_value()) {
+        volume_->volume = volume;
+    }
+}
+
+int64_t StreamPlayerStateMirror::GetSpeedPerMille(PlaybackSpeed speed)
+{
+    switch (speed) {
+        case PlaybackSpeed::SPEED_FORWARD_0_50_X:
+            return 500;
+        case PlaybackSpeed::SPEED_FORWARD_0_75_X:
+            return 750;
+        case PlaybackSpeed::SPEED_FORWARD_1_25_X:
+            return 1250;
+        case PlaybackSpeed::SPEED_FORWARD_1_50_X:
+            return 1500;
+        case PlaybackSpeed::SPEED_FORWARD_1_75_X:
+            return 1750;
+        case PlaybackSpeed::SPEED_FORWARD_2_00_X:
+            return 2000;
+        case PlaybackSpeed::SPEED_FORWARD_3_00_X:
+            return 3000;
+        default:
+            return SPEED_SCALE;
+    }
+}
+
+bool StreamPlayerStateMirror::IsPlayingLocked() const
+{
+    return state_ == PlayerStates::PLAYER_STARTED;
+}
+
+int64_t StreamPlayerStateMirror::GetPositionLocked(std::chrono::steady_clock::time_point now) const
+{
+    int64_t position = *position_;
+    if (IsPlayingLocked()) {
+        int64_t elapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(now - positionTime_).count();
+        position += elapsedMs * GetSpeedPerMille(speed_.value_or(PlaybackSpeed::SPEED_FORWARD_1_00_X)) / SPEED_SCALE;
+    }
+    if (duration_.has_value() && *duration_ > 0) {
+        position = std::min<int64_t>(position, *duration_);
+    }
+    return position;
+}
+
+void StreamPlayerStateMirror::AnchorPositionLocked(int64_t position)
+{
+    position_ = position;
+    positionTime_ = std::chrono::steady_clock::now();
+}
+
+void StreamPlayerStateMirror::OnStateChanged(PlayerStates state)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    // Freeze or restart the extrapolation at the position reached so far.
+    if (position_.has_value()) {
+        AnchorPositionLocked(GetPositionLocked(std::chrono::steady_clock::now()));
+    }
+    state_ = state;
+}
+
+void StreamPlayerStateMirror::OnPositionChanged(int position, int duration)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    // A negative value means the field is not carried by this report.
+    if (position >= 0) {
+        AnchorPositionLocked(position);
+    }
+    if (duration >= 0) {
+        duration_ = duration;
+    }
+}
+
+void StreamPlayerStateMirror::OnSeekDone(int position)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (position >= 0) {
+        AnchorPositionLocked(position);
+    }
+}
+
+void StreamPlayerStateMirror::OnVolumeChanged(int volume, int maxVolume)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    volume_ = Volume{ volume, maxVolume };
+}
+
+void StreamPlayerStateMirror::OnLoopModeChanged(LoopMode loopMode)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    loopMode_ = loopMode;
+}
+
+void StreamPlayerStateMirror::OnPlaySpeedChanged(PlaybackSpeed speed)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (position_.has_value()) {
+        AnchorPositionLocked(GetPositionLocked(std::chrono::steady_clock::now()));
+    }
+    speed_ = speed;
+}
+
+void StreamPlayerStateMirror::OnAvailableCapabilityChanged(const StreamCapability &streamCapability)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    capability_ = streamCapability;
+}
+
+bool StreamPlayerStateMirror::GetPlayerStatus(PlayerStates &playerStates)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!state_.has_value()) {
+        return false;
+    }
+    playerStates = *state_;
+    return true;
+}
+
+bool StreamPlayerStateMirror::GetPosition(int &position)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!state_.has_value() || !position_.has_value()) {
+        return false;
+    }
+    auto now = std::chrono::steady_clock::now();
+    if (IsPlayingLocked() &&
+        std::chrono::duration_cast<std::chrono::milliseconds>(now - positionTime_).count() > MAX_POSITION_AGE_MS) {
+        return false;
+    }
+    position = static_cast<int>(GetPositionLocked(now));
+    return true;
+}
+
+bool StreamPlayerStateMirror::GetDuration(int &duration)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!duration_.has_value()) {
+        return false;
+    }
+    duration = *duration_;
+    return true;
+}
+
+bool StreamPlayerStateMirror::GetVolume(int &volume, int &maxVolume)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!volume_.has_value()) {
+        return false;
+    }
+    volume = volume_->volume;
+    maxVolume = volume_->maxVolume;
+    return true;
+}
+
+bool StreamPlayerStateMirror::GetLoopMode(LoopMode &loopMode)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!loopMode_.has_value()) {
+        return false;
+    }
+    loopMode = *loopMode_;
+    return true;
+}
+
+bool StreamPlayerStateMirror::GetPlaySpeed(PlaybackSpeed &playbackSpeed)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!speed_.has_value()) {
+        return false;
+    }
+    playbackSpeed = *speed_;
+    return true;
+}
+
+bool StreamPlayerStateMirror::GetAvailableCapability(StreamCapability &streamCapability)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!capability_.has_value()) {
+        return false;
+    }
+    streamCapability = *capability_;
+    return true;
+}
+} // namespace CastEngineClient
+} // namespace CastEngine
+} // namespace OHOS
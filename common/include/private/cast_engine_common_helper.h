@@ -33,6 +33,7 @@ StreamCapability ReadStreamCapability(MessageParcel &parcel);
 
 bool WriteMediaInfo(MessageParcel &parcel, const MediaInfo &mediaInfo);
 std::unique_ptr<MediaInfo> ReadMediaInfo(MessageParcel &parcel);
+bool ReadMediaInfo(MessageParcel &parcel, MediaInfo &mediaInfo);
 
 bool WriteMediaInfoHolder(MessageParcel &parcel, const MediaInfoHolder &mediaInfoHolder);
 std::unique_ptr<MediaInfoHolder> ReadMediaInfoHolder(MessageParcel &parcel);
@@ -51,6 +52,8 @@ std::unique_ptr<AuthInfo> ReadAuthInfo(Parcel &parcel);
 
 bool WriteRemoteControlEvent(Parcel &parcel, const OHRemoteControlEvent &event);
 std::unique_ptr<OHRemoteControlEvent> ReadRemoteControlEvent(Parcel &parcel);
+// Checks an event that arrived as raw bytes, so that every enum and length it carries is in range.
+bool IsValidRemoteControlEvent(const OHRemoteControlEvent &event);
 
 bool WriteDeviceStateInfo(Parcel &parcel, const DeviceStateInfo &stateInfo);
 std::unique_ptr<DeviceStateInfo> ReadDeviceStateInfo(Parcel &parcel);
@@ -19,6 +19,7 @@
 #ifndef CAST_ENGINE_DFX_H
 #define CAST_ENGINE_DFX_H
 
+#include <mutex>
 #include <string>
 #include <cast_engine_common.h>
 #include "hisysevent.h"
@@ -42,8 +43,10 @@ public:
     static std::string GetConnectInfo();
     static std::string GetSequentialId();
     static std::string GetBizPackageName();
+    static std::string DumpMetrics();
 
 private:
+    static std::mutex jsonMutex_;
     static json jsonSteamInfo_;
     static json jsonLocalDeviceInfo_;
     static json jsonRemoteDeviceInfo_;
@@ -184,7 +187,7 @@ inline std::string GetAnonymousDeviceID(const std::string& deviceId)
 
 int GetBIZSceneType(int protocols);
 
-static int32_t CAST_RADAR_SUCCESS = 0;
+inline constexpr int32_t CAST_RADAR_SUCCESS = 0;
 using RadarParamInt = std::map<std::string, int32_t>;
 using RadarParamString = std::map<std::string, std::string>;
 void HiSysEventWriteWrap(const std::string& funcName, const RadarParamInt& paramInt,
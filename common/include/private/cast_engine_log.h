@@ -19,6 +19,10 @@
 #ifndef CAST_ENGINE_LOG_H
 #define CAST_ENGINE_LOG_H
 
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
 #include "hilog/log_cpp.h"
 #include "parameters.h"
 
@@ -33,24 +37,111 @@ inline constexpr unsigned int CASTPLUS_LOG_END = CASTPLUS_LOG_BEGIN + 0x10;
 
 inline constexpr bool DEBUG = true;
 
+/*
+ * Log levels used for both the compile-time and the runtime filter. A log statement whose level is below
+ * CAST_ENGINE_LOG_MIN_LEVEL is removed by the compiler together with its arguments, so hot paths may keep
+ * verbose logs such as per-frame or per-header traces without paying for them in release builds.
+ */
+#define CAST_LOG_LEVEL_VERBOSE 0
+#define CAST_LOG_LEVEL_DEBUG 1
+#define CAST_LOG_LEVEL_INFO 2
+#define CAST_LOG_LEVEL_WARN 3
+#define CAST_LOG_LEVEL_ERROR 4
+
+#ifndef CAST_ENGINE_LOG_MIN_LEVEL
+#define CAST_ENGINE_LOG_MIN_LEVEL CAST_LOG_LEVEL_VERBOSE
+#endif
+
+inline constexpr int CAST_LOG_MIN_LEVEL = CAST_ENGINE_LOG_MIN_LEVEL;
+inline constexpr char CAST_LOG_LEVEL_PARAM[] = "debug.cast.log.level";
+
+/*
+ * Runtime threshold, read once from the system parameter. It can only raise the compile-time threshold.
+ */
+inline int CastLogRuntimeLevel()
+{
+    static const int level = OHOS::system::GetIntParameter<int>(CAST_LOG_LEVEL_PARAM, CAST_LOG_MIN_LEVEL);
+    return level;
+}
+
+template <int level>
+inline bool CastLogIsLoggable()
+{
+    if constexpr (level < CAST_LOG_MIN_LEVEL) {
+        return false;
+    } else {
+        return level >= CastLogRuntimeLevel();
+    }
+}
+
+/*
+ * Per-callsite rate limiter used by the CLOG*_LIMIT macros. Lock free so that it may sit on the receive threads.
+ */
+class CastLogRateLimiter {
+public:
+    explicit constexpr CastLogRateLimiter(int64_t intervalMs) : intervalMs_(intervalMs) {}
+
+    // Returns true when the caller may log now, and reports how many records were dropped since the last one.
+    bool TryAcquire(uint32_t &suppressed)
+    {
+        int64_t now = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+        int64_t last = lastMs_.load(std::memory_order_relaxed);
+        if (last != 0 && now - last < intervalMs_) {
+            suppressed_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        if (!lastMs_.compare_exchange_strong(last, now, std::memory_order_relaxed)) {
+            suppressed_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        suppressed = suppressed_.exchange(0, std::memory_order_relaxed);
+        return true;
+    }
+
+private:
+    const int64_t intervalMs_;
+    std::atomic<int64_t> lastMs_{ 0 };
+    std::atomic<uint32_t> suppressed_{ 0 };
+};
+
 #define DEFINE_CAST_ENGINE_LABEL(name) \
     static constexpr HiLogLabel CAST_ENGINE_LABEL = { LOG_CORE, OHOS::CastEngine::CAST_ENGINE_LOG_ID, name }
 
-#define CLOGV(format, ...)                                                                                \
+#define CAST_ENGINE_LOG(level, format, ...)                                                               \
     do {                                                                                                  \
-        if (DEBUG) {                                                                                      \
+        if (OHOS::CastEngine::CastLogIsLoggable<level>()) {                                               \
             (void)HiLog::Error(CAST_ENGINE_LABEL, "[%{public}s:%{public}d]: " format, __func__, __LINE__, \
                 ##__VA_ARGS__);                                                                           \
         }                                                                                                 \
     } while (0)
-#define CLOGD(format, ...) \
-    (void)HiLog::Error(CAST_ENGINE_LABEL, "[%{public}s:%{public}d]: " format, __func__, __LINE__, ##__VA_ARGS__)
-#define CLOGI(format, ...) \
-    (void)HiLog::Error(CAST_ENGINE_LABEL, "[%{public}s:%{public}d]: " format, __func__, __LINE__, ##__VA_ARGS__)
-#define CLOGW(format, ...) \
-    (void)HiLog::Error(CAST_ENGINE_LABEL, "[%{public}s:%{public}d]: " format, __func__, __LINE__, ##__VA_ARGS__)
-#define CLOGE(format, ...) \
-    (void)HiLog::Error(CAST_ENGINE_LABEL, "[%{public}s:%{public}d]: " format, __func__, __LINE__, ##__VA_ARGS__)
+
+#define CAST_ENGINE_LOG_LIMIT(level, intervalMs, format, ...)                                                   \
+    do {                                                                                                        \
+        if (OHOS::CastEngine::CastLogIsLoggable<level>()) {                                                     \
+            static OHOS::CastEngine::CastLogRateLimiter castLogLimiter(intervalMs);                             \
+            uint32_t castLogSuppressed = 0;                                                                     \
+            if (castLogLimiter.TryAcquire(castLogSuppressed)) {                                                 \
+                (void)HiLog::Error(CAST_ENGINE_LABEL, "[%{public}s:%{public}d]: (suppressed %{public}u) " format, \
+                    __func__, __LINE__, castLogSuppressed, ##__VA_ARGS__);                                      \
+            }                                                                                                   \
+        }                                                                                                       \
+    } while (0)
+
+#define CLOGV(format, ...) CAST_ENGINE_LOG(CAST_LOG_LEVEL_VERBOSE, format, ##__VA_ARGS__)
+#define CLOGD(format, ...) CAST_ENGINE_LOG(CAST_LOG_LEVEL_DEBUG, format, ##__VA_ARGS__)
+#define CLOGI(format, ...) CAST_ENGINE_LOG(CAST_LOG_LEVEL_INFO, format, ##__VA_ARGS__)
+#define CLOGW(format, ...) CAST_ENGINE_LOG(CAST_LOG_LEVEL_WARN, format, ##__VA_ARGS__)
+#define CLOGE(format, ...) CAST_ENGINE_LOG(CAST_LOG_LEVEL_ERROR, format, ##__VA_ARGS__)
+
+#define CLOGD_LIMIT(intervalMs, format, ...) \
+    CAST_ENGINE_LOG_LIMIT(CAST_LOG_LEVEL_DEBUG, intervalMs, format, ##__VA_ARGS__)
+#define CLOGI_LIMIT(intervalMs, format, ...) \
+    CAST_ENGINE_LOG_LIMIT(CAST_LOG_LEVEL_INFO, intervalMs, format, ##__VA_ARGS__)
+#define CLOGW_LIMIT(intervalMs, format, ...) \
+    CAST_ENGINE_LOG_LIMIT(CAST_LOG_LEVEL_WARN, intervalMs, format, ##__VA_ARGS__)
+#define CLOGE_LIMIT(intervalMs, format, ...) \
+    CAST_ENGINE_LOG_LIMIT(CAST_LOG_LEVEL_ERROR, intervalMs, format, ##__VA_ARGS__)
 
 #undef CHECK_AND_RETURN_RET_LOG
 #define CHECK_AND_RETURN_RET_LOG(cond, ret, fmt, ...)  \
@@ -0,0 +1,256 @@
+/*
+ * Copyright (C) 2023-2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * Description: cast engine runtime metrics, counters, gauges and latency histograms.
+ * Author: zhangge
+ * Create: 2023-06-05
+ */
+
+#ifndef CAST_ENGINE_METRICS_H
+#define CAST_ENGINE_METRICS_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace OHOS {
+namespace CastEngine {
+// channel
+inline constexpr char METRIC_CHANNEL_RX_BYTES[] = "channel.rx_bytes";
+inline constexpr char METRIC_CHANNEL_RX_FRAMES[] = "channel.rx_frames";
+inline constexpr char METRIC_CHANNEL_TX_BYTES[] = "channel.tx_bytes";
+inline constexpr char METRIC_CHANNEL_TX_FRAMES[] = "channel.tx_frames";
+inline constexpr char METRIC_CHANNEL_TX_ERRORS[] = "channel.tx_errors";
+inline constexpr char METRIC_CHANNEL_RX_ERRORS[] = "channel.rx_errors";
+inline constexpr char METRIC_CHANNEL_SEND_US[] = "channel.send_us";
+inline constexpr char METRIC_CHANNEL_OPENED[] = "channel.opened";
+inline constexpr char METRIC_CHANNEL_ALL_READY_US[] = "channel.all_ready_us";
+inline constexpr char METRIC_CHANNEL_CONTROL_QUEUE_WAIT_US[] = "channel.control_queue_wait_us";
+inline constexpr char METRIC_CHANNEL_SEND_BACKPRESSURE[] = "channel.send_backpressure";
+
+// vtp
+inline constexpr char METRIC_VTP_RETRANSMITS[] = "vtp.retransmits";
+inline constexpr char METRIC_VTP_NACKS_SENT[] = "vtp.nacks_sent";
+inline constexpr char METRIC_VTP_FEC_RECOVERED[] = "vtp.fec_recovered";
+inline constexpr char METRIC_VTP_FRAMES_DROPPED[] = "vtp.frames_dropped";
+inline constexpr char METRIC_VTP_HELLOS_REJECTED[] = "vtp.hellos_rejected";
+
+// mirror
+inline constexpr char METRIC_MIRROR_RATE_CHANGES[] = "mirror.rate_changes";
+inline constexpr char METRIC_MIRROR_BITRATE[] = "mirror.bitrate";
+inline constexpr char METRIC_MIRROR_INPUT_EVENTS[] = "mirror.input_events";
+inline constexpr char METRIC_MIRROR_INPUT_DRAINS[] = "mirror.input_drains";
+inline constexpr char METRIC_MIRROR_INPUT_QUEUED_US[] = "mirror.input_queued_us";
+
+// rtsp
+inline constexpr char METRIC_RTSP_RX_MESSAGES[] = "rtsp.rx_messages";
+inline constexpr char METRIC_RTSP_TX_MESSAGES[] = "rtsp.tx_messages";
+inline constexpr char METRIC_RTSP_TX_ERRORS[] = "rtsp.tx_errors";
+inline constexpr char METRIC_RTSP_DECRYPT_ERRORS[] = "rtsp.decrypt_errors";
+inline constexpr char METRIC_RTSP_PARSE_US[] = "rtsp.parse_us";
+inline constexpr char METRIC_RTSP_TRANSACTION_US[] = "rtsp.transaction_us";
+inline constexpr char METRIC_RTSP_TIMEOUTS[] = "rtsp.request_timeouts";
+inline constexpr char METRIC_RTSP_KEEP_ALIVE_LOST[] = "rtsp.keep_alive_lost";
+inline constexpr char METRIC_RTSP_PEER_GONE[] = "rtsp.peer_gone";
+
+// crypto
+inline constexpr char METRIC_CRYPTO_ENCRYPT_US[] = "crypto.encrypt_us";
+inline constexpr char METRIC_CRYPTO_DECRYPT_US[] = "crypto.decrypt_us";
+inline constexpr char METRIC_CRYPTO_BYTES[] = "crypto.bytes";
+
+// stream
+inline constexpr char METRIC_STREAM_RX_ACTIONS[] = "stream.rx_actions";
+inline constexpr char METRIC_STREAM_TX_ACTIONS[] = "stream.tx_actions";
+inline constexpr char METRIC_STREAM_DROPPED_ACTIONS[] = "stream.dropped_actions";
+inline constexpr char METRIC_STREAM_ACTION_HANDLE_US[] = "stream.action_handle_us";
+inline constexpr char METRIC_STREAM_ACTION_ENCODE_US[] = "stream.action_encode_us";
+inline constexpr char METRIC_STREAM_ACTION_DECODE_US[] = "stream.action_decode_us";
+inline constexpr char METRIC_DATA_SOURCE_READ_US[] = "stream.data_source_read_us";
+inline constexpr char METRIC_DATA_SOURCE_READ_BYTES[] = "stream.data_source_read_bytes";
+inline constexpr char METRIC_DATA_SOURCE_REQUESTS[] = "stream.data_source_requests";
+inline constexpr char METRIC_STREAM_TRACK_GAP_US[] = "stream.track_gap_us";
+inline constexpr char METRIC_STREAM_GAPLESS_SWITCHES[] = "stream.gapless_switches";
+inline constexpr char METRIC_STREAM_IMAGE_FIRST_PIXEL_US[] = "stream.image_first_pixel_us";
+
+// artwork
+inline constexpr char METRIC_ARTWORK_CACHE_HITS[] = "artwork.cache_hits";
+inline constexpr char METRIC_ARTWORK_CACHE_MISSES[] = "artwork.cache_misses";
+inline constexpr char METRIC_ARTWORK_CACHE_BYTES[] = "artwork.cache_bytes";
+
+// handler
+inline constexpr char METRIC_HANDLER_MESSAGES[] = "handler.messages";
+inline constexpr char METRIC_HANDLER_LATENCY_US[] = "handler.dispatch_latency_us";
+inline constexpr char METRIC_HANDLER_HANDLE_US[] = "handler.handle_us";
+
+// connect
+inline constexpr char METRIC_CONNECT_TOTAL_US[] = "connect.total_us";
+inline constexpr char METRIC_CONNECT_SUCCESS[] = "connect.success";
+inline constexpr char METRIC_CONNECT_FAILED[] = "connect.failed";
+inline constexpr char METRIC_CONNECT_STAGE_PREFIX[] = "connect.stage.";
+
+// napi
+inline constexpr char METRIC_NAPI_CALLBACK_EVENTS[] = "napi.callback_events";
+inline constexpr char METRIC_NAPI_CALLBACK_COALESCED[] = "napi.callback_coalesced";
+inline constexpr char METRIC_NAPI_CALLBACK_WAIT_US[] = "napi.callback_wait_us";
+inline constexpr char METRIC_NAPI_CALLBACK_BACKLOG[] = "napi.callback_backlog";
+
+// service
+inline constexpr char METRIC_SERVICE_ACTIVE_SESSIONS[] = "service.active_sessions";
+inline constexpr char METRIC_SERVICE_STARTUP_PREFIX[] = "service.startup.";
+inline constexpr char METRIC_SERVICE_COLD_STARTS[] = "service.cold_starts";
+inline constexpr char METRIC_SERVICE_WARM_STARTS[] = "service.warm_starts";
+inline constexpr char METRIC_SERVICE_UNLOAD_CANCELLED[] = "service.unload_cancelled";
+
+/*
+ * Monotonic counter. Writes go to a per-thread shard so that concurrent writers never share a cache line,
+ * reads sum all the shards.
+ */
+class MetricCounter {
+public:
+    MetricCounter() = default;
+    ~MetricCounter() = default;
+
+    void Add(int64_t delta = 1)
+    {
+        shards_[ShardIndex()].value.fetch_add(delta, std::memory_order_relaxed);
+    }
+
+    int64_t Value() const;
+
+private:
+    static constexpr size_t SHARD_COUNT = 16;
+    static constexpr size_t CACHE_LINE_SIZE = 64;
+    struct alignas(CACHE_LINE_SIZE) Shard {
+        std::atomic<int64_t> value{ 0 };
+    };
+
+    static size_t ShardIndex();
+
+    std::array<Shard, SHARD_COUNT> shards_{};
+};
+
+class MetricGauge {
+public:
+    MetricGauge() = default;
+    ~MetricGauge() = default;
+
+    void Set(int64_t value)
+    {
+        value_.store(value, std::memory_order_relaxed);
+    }
+
+    void Add(int64_t delta)
+    {
+        value_.fetch_add(delta, std::memory_order_relaxed);
+    }
+
+    int64_t Value() const
+    {
+        return value_.load(std::memory_order_relaxed);
+    }
+
+private:
+    std::atomic<int64_t> value_{ 0 };
+};
+
+/*
+ * Log-linear histogram: every power of two range is split into SUB_BUCKET_COUNT linear buckets, which keeps the
+ * relative error of any reported percentile under 1 / SUB_BUCKET_COUNT for the whole uint64 range.
+ */
+class MetricHistogram {
+public:
+    struct Snapshot {
+        uint64_t count{ 0 };
+        uint64_t sum{ 0 };
+        uint64_t max{ 0 };
+        uint64_t p50{ 0 };
+        uint64_t p90{ 0 };
+        uint64_t p99{ 0 };
+    };
+
+    MetricHistogram() = default;
+    ~MetricHistogram() = default;
+
+    void Record(uint64_t value);
+    Snapshot GetSnapshot() const;
+
+private:
+    static constexpr int SUB_BUCKET_BITS = 3;
+    static constexpr uint64_t SUB_BUCKET_COUNT = 1 << SUB_BUCKET_BITS;
+    static constexpr int MAX_BIT = 63;
+    static constexpr size_t BUCKET_COUNT = (MAX_BIT - SUB_BUCKET_BITS + 2) * SUB_BUCKET_COUNT;
+
+    static size_t BucketIndex(uint64_t value);
+    static uint64_t BucketLowerBound(size_t index);
+
+    std::array<std::atomic<uint64_t>, BUCKET_COUNT> buckets_{};
+    std::atomic<uint64_t> sum_{ 0 };
+    std::atomic<uint64_t> max_{ 0 };
+};
+
+/*
+ * Name based registry of all metrics in the process. Registration takes a lock and returns a reference that stays
+ * valid for the life of the process, so call sites resolve it once into a function local static and update it
+ * lock free afterwards.
+ */
+class CastEngineMetrics {
+public:
+    static CastEngineMetrics &GetInstance();
+
+    MetricCounter &RegisterCounter(const std::string &name);
+    MetricGauge &RegisterGauge(const std::string &name);
+    MetricHistogram &RegisterHistogram(const std::string &name);
+
+    // Registers every metric declared above, so that a dump lists them even before their first update.
+    void RegisterDefaultMetrics();
+    // Json snapshot of all metrics, stamped with the wall clock time so that dumps of different runs or builds
+    // can be compared by tooling.
+    std::string Dump();
+
+private:
+    CastEngineMetrics() = default;
+    ~CastEngineMetrics() = default;
+
+    std::mutex mutex_;
+    std::map<std::string, std::unique_ptr<MetricCounter>> counters_;
+    std::map<std::string, std::unique_ptr<MetricGauge>> gauges_;
+    std::map<std::string, std::unique_ptr<MetricHistogram>> histograms_;
+};
+
+/*
+ * Records the elapsed time of its scope, in microseconds, into a histogram.
+ */
+class MetricScopedTimer {
+public:
+    explicit MetricScopedTimer(MetricHistogram &histogram)
+        : histogram_(histogram), start_(std::chrono::steady_clock::now()) {}
+
+    ~MetricScopedTimer()
+    {
+        histogram_.Record(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - start_).count()));
+    }
+
+private:
+    MetricHistogram &histogram_;
+    std::chrono::steady_clock::time_point start_;
+};
+} // namespace CastEngine
+} // namespace OHOS
+
+#endif // CAST_ENGINE_METRICS_H
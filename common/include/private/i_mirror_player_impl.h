@@ -21,6 +21,7 @@
 
 #include <string>
 
+#include "ashmem.h"
 #include "iremote_broker.h"
 #include "oh_remote_control_event.h"
 #include "surface_utils.h"
@@ -47,6 +48,9 @@ public:
     virtual int32_t Release() = 0;
     virtual int32_t GetDisplayId(std::string &displayId) = 0;
     virtual int32_t ResizeVirtualScreen(uint32_t width, uint32_t height) = 0;
+    // Hands out the shared memory ring the input events are queued into, see MirrorInputRing.
+    virtual int32_t SetupInputRing(sptr<Ashmem> &ashmem) = 0;
+    virtual int32_t DrainInputRing() = 0;
 
 protected:
     enum {
@@ -59,6 +63,8 @@ protected:
         SET_APP_INFO,
         GET_DISPLAYID,
         RESIZE_VIRTUAL_SCREEN,
+        SETUP_INPUT_RING,
+        DRAIN_INPUT_RING,
     };
 };
 } // namespace CastEngine
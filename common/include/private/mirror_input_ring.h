@@ -0,0 +1,95 @@
+/*
+ * Copyright (C) 2023-2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * Description: shared memory ring that carries the mirror player input events from the client to the service.
+ * Author: zhangge
+ * Create: 2023-06-05
+ */
+
+#ifndef MIRROR_INPUT_RING_H
+#define MIRROR_INPUT_RING_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+
+#include "ashmem.h"
+#include "oh_remote_control_event.h"
+
+namespace OHOS {
+namespace CastEngine {
+/*
+ * Fixed size input event records in an ashmem region shared by the mirror player client and the service. The client
+ * appends and only rings the service when it has gone idle, so a burst of touch moves costs one binder call instead
+ * of one per event. The service owns the region and treats whatever the client wrote as untrusted: the indices are
+ * bounded and every record is copied out and validated before it is dispatched.
+ */
+class MirrorInputRing {
+public:
+    enum class EventKind : uint32_t {
+        DELIVER = 0,
+        INJECT,
+    };
+
+    enum class PushResult {
+        // Queued into an idle ring, the service has to be rung.
+        NOTIFY,
+        // Queued behind a drain that is already pending.
+        QUEUED,
+        FULL,
+    };
+
+    using Handler = std::function<void(EventKind kind, const OHRemoteControlEvent &event, int64_t queuedUs)>;
+
+    // Service side, allocates the region.
+    static std::shared_ptr<MirrorInputRing> Create();
+    // Client side, maps the region handed out by the service.
+    static std::shared_ptr<MirrorInputRing> Attach(const sptr<Ashmem> &ashmem);
+
+    MirrorInputRing(const sptr<Ashmem> &ashmem, uint8_t *base, size_t size, uint32_t capacity);
+    ~MirrorInputRing();
+
+    sptr<Ashmem> GetAshmem() const
+    {
+        return ashmem_;
+    }
+
+    PushResult Push(EventKind kind, const OHRemoteControlEvent &event);
+    // Lets the next push ring the service again after a ring that could not be delivered.
+    void ResetNotify();
+    // Hands every queued record to the handler in order, returns the number of records handled.
+    size_t Drain(const Handler &handler);
+
+private:
+    struct Header;
+    struct Record;
+
+    static size_t GetRecordsOffset();
+    static uint8_t *Map(const sptr<Ashmem> &ashmem, size_t size);
+    Header &GetHeader() const;
+    Record &GetRecord(uint32_t index) const;
+
+    sptr<Ashmem> ashmem_;
+    uint8_t *base_;
+    size_t size_;
+    // Kept out of the shared header, which the client can write.
+    uint32_t capacity_;
+    // Serializes the producers on the client and the drains on the service.
+    std::mutex mutex_;
+};
+} // namespace CastEngine
+} // namespace OHOS
+
+#endif // MIRROR_INPUT_RING_H
@@ -18,7 +18,10 @@
 
 #include "cast_engine_common_helper.h"
 
+#include <array>
+#include <cinttypes>
 #include <optional>
+#include <unistd.h>
 #include "cast_engine_log.h"
 #include "securec.h"
 
@@ -29,6 +32,125 @@ constexpr uint32_t MAX_DRM_CAPABILITY_SIZE = 50;
 
 namespace {
 constexpr int SESSION_KEY_LENGTH = 16;
+// Bumped whenever a packed layout below changes, so that a peer built against another layout fails the read instead
+// of misparsing it.
+constexpr uint32_t CAST_REMOTE_DEVICE_LAYOUT_VERSION = 1;
+constexpr uint32_t MEDIA_INFO_LAYOUT_VERSION = 2;
+constexpr uint32_t MEDIA_URL_PATH = 0;
+constexpr uint32_t MEDIA_URL_LOCAL_FD = 1;
+
+struct CastRemoteDeviceScalars {
+    int32_t deviceType;
+    int32_t capability;
+    int32_t subDeviceType;
+    int32_t channelType;
+    int32_t sessionId;
+    uint32_t mediumTypes;
+    uint32_t protocolCapabilities;
+    uint32_t isLegacy;
+    uint32_t isTrushed;
+};
+
+struct MediaInfoScalars {
+    uint32_t mediaSize;
+    uint32_t startPosition;
+    uint32_t duration;
+    uint32_t closingCreditsPosition;
+};
+
+/*
+ * The short strings of a struct travel as one table: the total size, the length of every string and then all their
+ * bytes back to back. That is three writes in total instead of a length, a copy and a padding per string, and the
+ * reader assigns every string straight from the parcel memory. The writer is not zero-copy: every WriteBuffer pads
+ * to four bytes, so the bytes are gathered into one scratch string first.
+ */
+template<size_t N>
+bool WriteStringTable(Parcel &parcel, const std::array<const std::string *, N> &strings)
+{
+    std::array<uint32_t, N> lengths{};
+    size_t tableSize = 0;
+    for (size_t i = 0; i < N; i++) {
+        lengths[i] = static_cast<uint32_t>(strings[i]->size());
+        tableSize += strings[i]->size();
+    }
+    if (tableSize > UINT32_MAX) {
+        CLOGE("string table is too large: %{public}zu", tableSize);
+        return false;
+    }
+    std::string table;
+    table.reserve(tableSize);
+    for (const auto *str : strings) {
+        table.append(*str);
+    }
+    return parcel.WriteUint32(static_cast<uint32_t>(tableSize)) &&
+        parcel.WriteBuffer(lengths.data(), sizeof(lengths)) &&
+        (tableSize == 0 || parcel.WriteBuffer(table.data(), tableSize));
+}
+
+template<size_t N>
+bool ReadStringTable(Parcel &parcel, const std::array<std::string *, N> &strings)
+{
+    uint32_t tableSize = parcel.ReadUint32();
+    std::array<uint32_t, N> lengths{};
+    const uint8_t *lengthBuf = parcel.ReadBuffer(sizeof(lengths));
+    if (lengthBuf == nullptr || memcpy_s(lengths.data(), sizeof(lengths), lengthBuf, sizeof(lengths)) != EOK) {
+        CLOGE("Read string lengths failed");
+        return false;
+    }
+    uint64_t total = 0;
+    for (uint32_t length : lengths) {
+        total += length;
+    }
+    if (total != tableSize) {
+        CLOGE("string table size mismatch, %{public}u != %{public}" PRIu64, tableSize, total);
+        return false;
+    }
+    const char *table = nullptr;
+    if (tableSize != 0) {
+        table = reinterpret_cast<const char *>(parcel.ReadBuffer(tableSize));
+        if (table == nullptr) {
+            CLOGE("Read string table failed, size %{public}u", tableSize);
+            return false;
+        }
+    }
+    size_t offset = 0;
+    for (size_t i = 0; i < N; i++) {
+        strings[i]->assign(table + offset, lengths[i]);
+        offset += lengths[i];
+    }
+    return true;
+}
+
+/*
+ * Raw data goes inline while small and through an ashmem region once it is too large for the binder buffer. A parcel
+ * holds at most one such region, so every parcel writes at most one blob.
+ */
+bool WriteBlob(MessageParcel &parcel, const std::string &blob)
+{
+    if (blob.size() > UINT32_MAX) {
+        CLOGE("blob is too large: %{public}zu", blob.size());
+        return false;
+    }
+    return parcel.WriteUint32(static_cast<uint32_t>(blob.size())) &&
+        (blob.empty() || parcel.WriteRawData(blob.data(), blob.size()));
+}
+
+bool ReadBlob(MessageParcel &parcel, std::string &blob)
+{
+    uint32_t size = parcel.ReadUint32();
+    if (size == 0) {
+        blob.clear();
+        return true;
+    }
+    const auto *data = static_cast<const char *>(parcel.ReadRawData(size));
+    if (data == nullptr) {
+        CLOGE("Read blob failed, size %{public}u", size);
+        return false;
+    }
+    blob.assign(data, size);
+    return true;
+}
+
 bool WriteVideoSize(Parcel &parcel, const VideoSize &videoSize)
 {
     return parcel.WriteInt32(videoSize.width) && parcel.WriteInt32(videoSize.height);
@@ -140,27 +262,24 @@ int GetLocalFd(const std::string &url)
 
 bool WriteCastRemoteDevice(Parcel &parcel, const CastRemoteDevice &device)
 {
-    bool res = parcel.WriteInt32(static_cast<int32_t>(device.deviceType)) &&
-        parcel.WriteInt32(static_cast<int32_t>(device.capability)) &&
-        parcel.WriteInt32(static_cast<int32_t>(device.subDeviceType)) &&
-        parcel.WriteInt32(static_cast<int32_t>(device.channelType)) && parcel.WriteString(device.deviceId) &&
-        parcel.WriteString(device.deviceName) && parcel.WriteString(device.ipAddress) &&
-        parcel.WriteString(device.networkId) && parcel.WriteString(device.localIpAddress) &&
-        parcel.WriteBool(device.isLegacy) && parcel.WriteInt32(device.sessionId) &&
-        parcel.WriteUint32(device.mediumTypes) && parcel.WriteUint32(device.protocolCapabilities) &&
-        parcel.WriteString(device.modelName) && parcel.WriteString(device.manufacturerName) &&
-        parcel.WriteBool(device.isTrushed);
-    if (device.sessionKeyLength == SESSION_KEY_LENGTH && device.sessionKey) {
-        res = res && parcel.WriteUint32(device.sessionKeyLength);
-        res = res && parcel.WriteBuffer(device.sessionKey, device.sessionKeyLength);
-    } else {
-        parcel.WriteUint32(0);
-    }
     uint32_t drmCapabilitySize = device.drmCapabilities.size();
     if (drmCapabilitySize > MAX_DRM_CAPABILITY_SIZE) {
         CLOGE("drmCapabilitySize(%{public}u) is invalid", drmCapabilitySize);
         return false;
     }
+    CastRemoteDeviceScalars scalars = { static_cast<int32_t>(device.deviceType),
+        static_cast<int32_t>(device.capability), static_cast<int32_t>(device.subDeviceType),
+        static_cast<int32_t>(device.channelType), device.sessionId, device.mediumTypes, device.protocolCapabilities,
+        device.isLegacy, device.isTrushed };
+    bool res = parcel.WriteUint32(CAST_REMOTE_DEVICE_LAYOUT_VERSION) && parcel.WriteBuffer(&scalars, sizeof(scalars)) &&
+        WriteStringTable<7>(parcel, { &device.deviceId, &device.deviceName, &device.ipAddress, &device.networkId,
+            &device.localIpAddress, &device.modelName, &device.manufacturerName });
+    if (device.sessionKeyLength == SESSION_KEY_LENGTH && device.sessionKey) {
+        res = res && parcel.WriteUint32(device.sessionKeyLength);
+        res = res && parcel.WriteBuffer(device.sessionKey, device.sessionKeyLength);
+    } else {
+        res = res && parcel.WriteUint32(0);
+    }
     res = res && parcel.WriteUint32(drmCapabilitySize);
     for (auto iter = device.drmCapabilities.begin(); iter != device.drmCapabilities.end(); iter++) {
         res = res && parcel.WriteString(*iter);
@@ -170,60 +289,60 @@ bool WriteCastRemoteDevice(Parcel &parcel, const CastRemoteDevice &device)
 
 bool ReadCastRemoteDevice(Parcel &parcel, CastRemoteDevice &device)
 {
-    auto remote = ReadCastRemoteDevice(parcel);
-    if (remote == nullptr) {
-        CLOGE("ReadCastRemoteDevice failed");
+    uint32_t version = parcel.ReadUint32();
+    if (version != CAST_REMOTE_DEVICE_LAYOUT_VERSION) {
+        CLOGE("Unsupported remote device layout %{public}u", version);
         return false;
     }
-
-    device = *remote;
-    return true;
-}
-
-std::unique_ptr<CastRemoteDevice> ReadCastRemoteDevice(Parcel &parcel)
-{
-    auto device = std::make_unique<CastRemoteDevice>();
-    auto deviceType = parcel.ReadInt32();
-    auto capability = parcel.ReadInt32();
-    auto subDeviceType = parcel.ReadInt32();
-    auto channelType = parcel.ReadInt32();
-    if (!IsDeviceType(deviceType) || !IsSubDeviceType(subDeviceType) ||
-        !IsChannelType(channelType) || !IsCapabilityType(capability)) {
+    CastRemoteDeviceScalars scalars{};
+    const uint8_t *scalarBuf = parcel.ReadBuffer(sizeof(scalars));
+    if (scalarBuf == nullptr || memcpy_s(&scalars, sizeof(scalars), scalarBuf, sizeof(scalars)) != EOK) {
+        CLOGE("ReadCastRemoteDevice scalars failed");
+        return false;
+    }
+    if (!IsDeviceType(scalars.deviceType) || !IsSubDeviceType(scalars.subDeviceType) ||
+        !IsChannelType(scalars.channelType) || !IsCapabilityType(scalars.capability)) {
         CLOGE("ReadCastRemoteDevice error");
-        return nullptr;
+        return false;
     }
-    device->deviceType = static_cast<DeviceType>(deviceType);
-    device->capability = static_cast<CapabilityType>(capability);
-    device->subDeviceType = static_cast<SubDeviceType>(subDeviceType);
-    device->channelType = static_cast<ChannelType>(channelType);
-    device->deviceId = parcel.ReadString();
-    device->deviceName = parcel.ReadString();
-    device->ipAddress = parcel.ReadString();
-    device->networkId = parcel.ReadString();
-    device->localIpAddress = parcel.ReadString();
-    device->isLegacy = parcel.ReadBool();
-    device->sessionId = parcel.ReadInt32();
-    device->mediumTypes = parcel.ReadUint32();
-    device->protocolCapabilities = parcel.ReadUint32();
-    device->modelName = parcel.ReadString();
-    device->manufacturerName = parcel.ReadString();
-    device->isTrushed = parcel.ReadBool();
-    device->sessionKeyLength = parcel.ReadUint32();
-    if (device->sessionKeyLength == SESSION_KEY_LENGTH) {
-        device->sessionKey = parcel.ReadBuffer(static_cast<size_t>(device->sessionKeyLength));
+    device.deviceType = static_cast<DeviceType>(scalars.deviceType);
+    device.capability = static_cast<CapabilityType>(scalars.capability);
+    device.subDeviceType = static_cast<SubDeviceType>(scalars.subDeviceType);
+    device.channelType = static_cast<ChannelType>(scalars.channelType);
+    device.sessionId = scalars.sessionId;
+    device.mediumTypes = scalars.mediumTypes;
+    device.protocolCapabilities = scalars.protocolCapabilities;
+    device.isLegacy = scalars.isLegacy != 0;
+    device.isTrushed = scalars.isTrushed != 0;
+    if (!ReadStringTable<7>(parcel, { &device.deviceId, &device.deviceName, &device.ipAddress, &device.networkId,
+        &device.localIpAddress, &device.modelName, &device.manufacturerName })) {
+        return false;
+    }
+    device.sessionKeyLength = parcel.ReadUint32();
+    if (device.sessionKeyLength == SESSION_KEY_LENGTH) {
+        device.sessionKey = parcel.ReadBuffer(static_cast<size_t>(device.sessionKeyLength));
     } else {
-        device->sessionKeyLength = 0;
-        device->sessionKey = nullptr;
+        device.sessionKeyLength = 0;
+        device.sessionKey = nullptr;
     }
     uint32_t drmCapabilitySize = parcel.ReadUint32();
     if (drmCapabilitySize > MAX_DRM_CAPABILITY_SIZE) {
         CLOGE("drmCapabilitySize(%{public}u) is invalid", drmCapabilitySize);
-        return nullptr;
+        return false;
     }
+    device.drmCapabilities.clear();
     for (uint32_t i = 0; i < drmCapabilitySize; i++) {
-        device->drmCapabilities.push_back(parcel.ReadString());
+        device.drmCapabilities.push_back(parcel.ReadString());
     }
+    return true;
+}
 
+std::unique_ptr<CastRemoteDevice> ReadCastRemoteDevice(Parcel &parcel)
+{
+    auto device = std::make_unique<CastRemoteDevice>();
+    if (!ReadCastRemoteDevice(parcel, *device)) {
+        return nullptr;
+    }
     return device;
 }
 
@@ -259,75 +378,142 @@ StreamCapability ReadStreamCapability(MessageParcel &parcel)
     return streamCapability;
 }
 
-bool WriteMediaInfo(MessageParcel &parcel, const MediaInfo &mediaInfo)
+namespace {
+// Everything but the lyrics, which go in the one blob of the parcel.
+bool WriteMediaInfoFields(MessageParcel &parcel, const MediaInfo &mediaInfo)
 {
     if (mediaInfo.mediaUrl.empty()) {
         CLOGE("mediaUrl is empty");
         return false;
     }
+    if (!parcel.WriteUint32(MEDIA_INFO_LAYOUT_VERSION)) {
+        return false;
+    }
+    static const std::string noUrl;
+    const std::string *mediaUrl = &mediaInfo.mediaUrl;
     int fd = GetLocalFd(mediaInfo.mediaUrl);
     if (fd != INVALID_VALUE) {
-        if (!parcel.WriteString("localFd") || !parcel.WriteFileDescriptor(fd)) {
+        if (!parcel.WriteUint32(MEDIA_URL_LOCAL_FD) || !parcel.WriteFileDescriptor(fd)) {
             CLOGE("Write local fd failed, fd = %{public}d", fd);
             return false;
         }
-    } else if (!parcel.WriteString("path") || !parcel.WriteString(mediaInfo.mediaUrl)) {
+        mediaUrl = &noUrl;
+    } else if (!parcel.WriteUint32(MEDIA_URL_PATH)) {
         CLOGE("Write path failed");
         return false;
     }
-    return parcel.WriteString(mediaInfo.mediaId) && parcel.WriteString(mediaInfo.mediaName) &&
-        parcel.WriteString(mediaInfo.mediaType) && parcel.WriteUint32(mediaInfo.mediaSize) &&
-        parcel.WriteString(mediaInfo.albumCoverUrl) && parcel.WriteString(mediaInfo.albumTitle) &&
-        parcel.WriteString(mediaInfo.mediaArtist) && parcel.WriteString(mediaInfo.lrcUrl) &&
-        parcel.WriteString(mediaInfo.lrcContent) && parcel.WriteString(mediaInfo.appIconUrl) &&
-        parcel.WriteString(mediaInfo.appName) && parcel.WriteUint32(mediaInfo.startPosition) &&
-        parcel.WriteUint32(mediaInfo.duration) && parcel.WriteUint32(mediaInfo.closingCreditsPosition) &&
-        parcel.WriteString(mediaInfo.drmType);
+    MediaInfoScalars scalars = { static_cast<uint32_t>(mediaInfo.mediaSize), mediaInfo.startPosition,
+        mediaInfo.duration, mediaInfo.closingCreditsPosition };
+    return parcel.WriteBuffer(&scalars, sizeof(scalars)) &&
+        WriteStringTable<11>(parcel, { mediaUrl, &mediaInfo.mediaId, &mediaInfo.mediaName, &mediaInfo.mediaType,
+            &mediaInfo.albumCoverUrl, &mediaInfo.albumTitle, &mediaInfo.mediaArtist, &mediaInfo.lrcUrl,
+            &mediaInfo.appIconUrl, &mediaInfo.appName, &mediaInfo.drmType });
 }
 
-std::unique_ptr<MediaInfo> ReadMediaInfo(MessageParcel &parcel)
+void CloseLocalFd(int &fd)
 {
-    auto mediaInfo = std::make_unique<MediaInfo>();
-    if (mediaInfo == nullptr) {
-        CLOGE("Failed to malloc mediaInfo");
-        return nullptr;
+    if (fd != INVALID_VALUE) {
+        close(fd);
+        fd = INVALID_VALUE;
     }
-    std::string urlType = parcel.ReadString();
-    if (urlType == "localFd") {
+}
+
+// The counterpart of WriteMediaInfoFields. The fd of a local file, if any, is handed out even on success, so that
+// the caller can close it when a later read fails.
+bool ReadMediaInfoFields(MessageParcel &parcel, MediaInfo &mediaInfo, int &fd)
+{
+    fd = INVALID_VALUE;
+    uint32_t version = parcel.ReadUint32();
+    if (version != MEDIA_INFO_LAYOUT_VERSION) {
+        CLOGE("Unsupported media info layout %{public}u", version);
+        return false;
+    }
+    uint32_t urlType = parcel.ReadUint32();
+    if (urlType == MEDIA_URL_LOCAL_FD) {
         CLOGD("localFd");
-        mediaInfo->mediaUrl = std::to_string(parcel.ReadFileDescriptor());
+        fd = parcel.ReadFileDescriptor();
     } else {
         CLOGD("online or localPath");
-        mediaInfo->mediaUrl = parcel.ReadString();
-    }
-    mediaInfo->mediaId = parcel.ReadString();
-    mediaInfo->mediaName = parcel.ReadString();
-    mediaInfo->mediaType = parcel.ReadString();
-    mediaInfo->mediaSize = parcel.ReadUint32();
-    mediaInfo->albumCoverUrl = parcel.ReadString();
-    mediaInfo->albumTitle = parcel.ReadString();
-    mediaInfo->mediaArtist = parcel.ReadString();
-    mediaInfo->lrcUrl = parcel.ReadString();
-    mediaInfo->lrcContent = parcel.ReadString();
-    mediaInfo->appIconUrl = parcel.ReadString();
-    mediaInfo->appName = parcel.ReadString();
-    mediaInfo->startPosition = parcel.ReadUint32();
-    mediaInfo->duration = parcel.ReadUint32();
-    mediaInfo->closingCreditsPosition = parcel.ReadUint32();
-    mediaInfo->drmType = parcel.ReadString();
+    }
+    MediaInfoScalars scalars{};
+    const uint8_t *scalarBuf = parcel.ReadBuffer(sizeof(scalars));
+    if (scalarBuf == nullptr || memcpy_s(&scalars, sizeof(scalars), scalarBuf, sizeof(scalars)) != EOK) {
+        CLOGE("ReadMediaInfo scalars failed");
+        CloseLocalFd(fd);
+        return false;
+    }
+    mediaInfo.mediaSize = scalars.mediaSize;
+    mediaInfo.startPosition = scalars.startPosition;
+    mediaInfo.duration = scalars.duration;
+    mediaInfo.closingCreditsPosition = scalars.closingCreditsPosition;
+    if (!ReadStringTable<11>(parcel, { &mediaInfo.mediaUrl, &mediaInfo.mediaId, &mediaInfo.mediaName,
+        &mediaInfo.mediaType, &mediaInfo.albumCoverUrl, &mediaInfo.albumTitle, &mediaInfo.mediaArtist,
+        &mediaInfo.lrcUrl, &mediaInfo.appIconUrl, &mediaInfo.appName, &mediaInfo.drmType })) {
+        CloseLocalFd(fd);
+        return false;
+    }
+    if (urlType == MEDIA_URL_LOCAL_FD) {
+        mediaInfo.mediaUrl = std::to_string(fd);
+    }
+    return true;
+}
 
+void CloseLocalFds(std::vector<int> &fds)
+{
+    for (int &fd : fds) {
+        CloseLocalFd(fd);
+    }
+}
+} // namespace
+
+bool WriteMediaInfo(MessageParcel &parcel, const MediaInfo &mediaInfo)
+{
+    return WriteMediaInfoFields(parcel, mediaInfo) && WriteBlob(parcel, mediaInfo.lrcContent);
+}
+
+bool ReadMediaInfo(MessageParcel &parcel, MediaInfo &mediaInfo)
+{
+    int fd = INVALID_VALUE;
+    if (!ReadMediaInfoFields(parcel, mediaInfo, fd)) {
+        return false;
+    }
+    if (!ReadBlob(parcel, mediaInfo.lrcContent)) {
+        CloseLocalFd(fd);
+        return false;
+    }
+    return true;
+}
+
+std::unique_ptr<MediaInfo> ReadMediaInfo(MessageParcel &parcel)
+{
+    auto mediaInfo = std::make_unique<MediaInfo>();
+    if (!ReadMediaInfo(parcel, *mediaInfo)) {
+        return nullptr;
+    }
     return mediaInfo;
 }
 
+/*
+ * Every item carries the length of its lyrics, and the lyrics of all the items follow the list as the one blob of
+ * the parcel, so that a list with several long lyrics does not need several ashmem regions. The blob takes a single
+ * buffer, so the lyrics are copied into one string before they are written.
+ */
 bool WriteMediaInfoHolder(MessageParcel &parcel, const MediaInfoHolder &mediaInfoHolder)
 {
     bool ret = parcel.WriteUint32(mediaInfoHolder.currentIndex);
     ret = ret && parcel.WriteUint32(mediaInfoHolder.progressRefreshInterval);
     ret = ret && parcel.WriteUint32(static_cast<uint32_t>(mediaInfoHolder.mediaInfoList.size()));
-    for (auto iter = mediaInfoHolder.mediaInfoList.begin(); iter != mediaInfoHolder.mediaInfoList.end(); iter++) {
-        ret = ret && WriteMediaInfo(parcel, *iter);
+    std::string lyrics;
+    for (const auto &mediaInfo : mediaInfoHolder.mediaInfoList) {
+        if (mediaInfo.lrcContent.size() > UINT32_MAX - lyrics.size()) {
+            CLOGE("lyrics of the list are too large");
+            return false;
+        }
+        ret = ret && WriteMediaInfoFields(parcel, mediaInfo) &&
+            parcel.WriteUint32(static_cast<uint32_t>(mediaInfo.lrcContent.size()));
+        lyrics.append(mediaInfo.lrcContent);
     }
-    return ret;
+    return ret && WriteBlob(parcel, lyrics);
 }
 
 std::unique_ptr<MediaInfoHolder> ReadMediaInfoHolder(MessageParcel &parcel)
@@ -344,12 +530,30 @@ std::unique_ptr<MediaInfoHolder> ReadMediaInfoHolder(MessageParcel &parcel)
         CLOGE("The number of list exceeds the upper limit. infoListSize: %{public}u", infoListSize);
         return nullptr;
     }
-    for (uint32_t i = 0; i < infoListSize; i++) {
-        auto mediaInfo = ReadMediaInfo(parcel);
-        if (mediaInfo == nullptr) {
+    mediaInfoHolder->mediaInfoList.resize(infoListSize);
+    std::vector<uint32_t> lyricsLengths;
+    std::vector<int> fds;
+    uint64_t lyricsSize = 0;
+    for (auto &mediaInfo : mediaInfoHolder->mediaInfoList) {
+        int fd = INVALID_VALUE;
+        if (!ReadMediaInfoFields(parcel, mediaInfo, fd)) {
+            CloseLocalFds(fds);
             return nullptr;
         }
-        mediaInfoHolder->mediaInfoList.push_back(*mediaInfo);
+        fds.push_back(fd);
+        lyricsLengths.push_back(parcel.ReadUint32());
+        lyricsSize += lyricsLengths.back();
+    }
+    std::string lyrics;
+    if (!ReadBlob(parcel, lyrics) || lyrics.size() != lyricsSize) {
+        CLOGE("Read lyrics failed, %{public}zu != %{public}" PRIu64, lyrics.size(), lyricsSize);
+        CloseLocalFds(fds);
+        return nullptr;
+    }
+    size_t offset = 0;
+    for (size_t i = 0; i < lyricsLengths.size(); i++) {
+        mediaInfoHolder->mediaInfoList[i].lrcContent.assign(lyrics, offset, lyricsLengths[i]);
+        offset += lyricsLengths[i];
     }
     return mediaInfoHolder;
 }
@@ -747,6 +951,40 @@ std::unique_ptr<OHRemoteControlEvent> ReadRemoteControlEvent(Parcel &parcel)
     return remoteControlEvent;
 }
 
+bool IsValidRemoteControlEvent(const OHRemoteControlEvent &event)
+{
+    switch (event.eventType) {
+        case XcomponentEventType::REMOTECONTROL_TOUCH: {
+            const auto &touchEvent = event.touchEvent;
+            if (!IsTouchEventType(touchEvent.type) || touchEvent.numPoints > OH_MAX_TOUCH_POINTS_NUMBER) {
+                return false;
+            }
+            for (uint32_t i = 0; i < touchEvent.numPoints; i++) {
+                if (!IsTouchEventType(touchEvent.touchPoints[i].type)) {
+                    return false;
+                }
+            }
+            return true;
+        }
+        case XcomponentEventType::REMOTECONTROL_MOUSE:
+            return IsMouseEventAction(event.mouseEvent.action) && IsMouseEventButton(event.mouseEvent.button);
+        case XcomponentEventType::REMOTECONTROL_WHEEL:
+            return IsWheelEventDirection(event.wheelEvent.direction);
+        case XcomponentEventType::REMOTECONTROL_KEY:
+            return IsKeyEventType(event.keyEvent.type);
+        case XcomponentEventType::REMOTECONTROL_INPUT_METHOD:
+            if (!IsInputMethodEventType(event.inputMethodEvent.type)) {
+                return false;
+            }
+            return event.inputMethodEvent.type != InputMethodEventType::OH_NATIVEXCOMPONENT_INPUT_CONTENT ||
+                event.inputMethodEvent.contentEvent.msgLen <= OH_MAX_CONTENT_LEN;
+        case XcomponentEventType::REMOTECONTROL_VIRTUAL_KEY:
+            return IsVirtualKeyEventType(event.virtualKeyEvent.type);
+        default:
+            return false;
+    }
+}
+
 bool WriteDeviceStateInfo(Parcel &parcel, const DeviceStateInfo &stateInfo)
 {
     return parcel.WriteInt32(static_cast<int32_t>(stateInfo.deviceState)) &&
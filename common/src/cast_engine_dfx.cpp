@@ -21,6 +21,7 @@
 #include <string>
 
 #include "cast_engine_log.h"
+#include "cast_engine_metrics.h"
 #include "hisysevent.h"
 #include "json.hpp"
 
@@ -30,6 +31,7 @@ namespace OHOS {
 namespace CastEngine {
 DEFINE_CAST_ENGINE_LABEL("Cast-Dfx");
 
+std::mutex CastEngineDfx::jsonMutex_;
 json CastEngineDfx::jsonSteamInfo_ = {};
 json CastEngineDfx::jsonLocalDeviceInfo_ = {};
 json CastEngineDfx::jsonRemoteDeviceInfo_ = {};
@@ -47,24 +49,28 @@ void CastEngineDfx::WriteErrorEvent(int32_t errorCode)
 void CastEngineDfx::SetStreamInfo(const std::string &streamInfoKey, const std::string &streamInfoValue)
 {
     CLOGD("In.");
+    std::lock_guard<std::mutex> lock(jsonMutex_);
     jsonSteamInfo_[streamInfoKey] = streamInfoValue;
 }
 
 std::string CastEngineDfx::GetStreamInfo()
 {
     CLOGD("In.");
+    std::lock_guard<std::mutex> lock(jsonMutex_);
     return jsonSteamInfo_.dump();
 }
 
 void CastEngineDfx::SetLocalDeviceInfo(const std::string &localDeviceInfoKey, const std::string &localDeviceInfoValue)
 {
     CLOGD("In.");
+    std::lock_guard<std::mutex> lock(jsonMutex_);
     jsonLocalDeviceInfo_[localDeviceInfoKey] = localDeviceInfoValue;
 }
 
 std::string CastEngineDfx::GetLocalDeviceInfo()
 {
     CLOGD("In.");
+    std::lock_guard<std::mutex> lock(jsonMutex_);
     return jsonLocalDeviceInfo_.dump();
 }
 
@@ -72,24 +78,28 @@ void CastEngineDfx::SetRemoteDeviceInfo(const std::string &remoteDeviceInfoKey,
     const std::string &remoteDeviceInfoValue)
 {
     CLOGD("In.");
+    std::lock_guard<std::mutex> lock(jsonMutex_);
     jsonRemoteDeviceInfo_[remoteDeviceInfoKey] = remoteDeviceInfoValue;
 }
 
 std::string CastEngineDfx::GetRemoteDeviceInfo()
 {
     CLOGD("In.");
+    std::lock_guard<std::mutex> lock(jsonMutex_);
     return jsonRemoteDeviceInfo_.dump();
 }
 
 void CastEngineDfx::SetConnectInfo(const std::string &connectInfoKey, const std::string &connectInfoValue)
 {
     CLOGD("In.");
+    std::lock_guard<std::mutex> lock(jsonMutex_);
     jsonConnectInfo_[connectInfoKey] = connectInfoValue;
 }
 
 std::string CastEngineDfx::GetConnectInfo()
 {
     CLOGD("In.");
+    std::lock_guard<std::mutex> lock(jsonMutex_);
     return jsonConnectInfo_.dump();
 }
 
@@ -112,6 +122,12 @@ std::string CastEngineDfx::GetBizPackageName()
     return PACKAGE_NAME;
 }
 
+std::string CastEngineDfx::DumpMetrics()
+{
+    CLOGD("In.");
+    return CastEngineMetrics::GetInstance().Dump();
+}
+
 int GetBIZSceneType(int protocols)
 {
     static std::map<ProtocolType, BIZSceneType> typeRelation {
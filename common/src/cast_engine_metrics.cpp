@@ -0,0 +1,216 @@
+/*
+ * Copyright (C) 2023-2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * Description: cast engine runtime metrics, counters, gauges and latency histograms.
+ * Author: zhangge
+ * Create: 2023-06-05
+ */
+
+#include "cast_engine_metrics.h"
+
+#include "cast_engine_log.h"
+#include "json.hpp"
+
+using nlohmann::json;
+
+namespace OHOS {
+namespace CastEngine {
+DEFINE_CAST_ENGINE_LABEL("Cast-Metrics");
+
+namespace {
+constexpr uint64_t PERCENT_50 = 50;
+constexpr uint64_t PERCENT_90 = 90;
+constexpr uint64_t PERCENT_99 = 99;
+constexpr uint64_t PERCENT_ALL = 100;
+
+size_t PercentileBucket(const uint64_t *counts, size_t size, uint64_t total, uint64_t percent)
+{
+    uint64_t target = (total * percent + PERCENT_ALL - 1) / PERCENT_ALL;
+    uint64_t seen = 0;
+    for (size_t bucket = 0; bucket < size; bucket++) {
+        seen += counts[bucket];
+        if (seen >= target) {
+            return bucket;
+        }
+    }
+    return size - 1;
+}
+} // namespace
+
+size_t MetricCounter::ShardIndex()
+{
+    static std::atomic<size_t> nextIndex{ 0 };
+    thread_local size_t index = nextIndex.fetch_add(1, std::memory_order_relaxed) % SHARD_COUNT;
+    return index;
+}
+
+int64_t MetricCounter::Value() const
+{
+    int64_t total = 0;
+    for (const auto &shard : shards_) {
+        total += shard.value.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+size_t MetricHistogram::BucketIndex(uint64_t value)
+{
+    if (value < SUB_BUCKET_COUNT) {
+        return static_cast<size_t>(value);
+    }
+    int msb = MAX_BIT - __builtin_clzll(value);
+    int shift = msb - SUB_BUCKET_BITS;
+    uint64_t sub = (value >> shift) & (SUB_BUCKET_COUNT - 1);
+    return static_cast<size_t>(msb - SUB_BUCKET_BITS + 1) * SUB_BUCKET_COUNT + sub;
+}
+
+uint64_t MetricHistogram::BucketLowerBound(size_t index)
+{
+    if (index < SUB_BUCKET_COUNT) {
+        return index;
+    }
+    int msb = static_cast<int>(index / SUB_BUCKET_COUNT) + SUB_BUCKET_BITS - 1;
+    uint64_t sub = index % SUB_BUCKET_COUNT;
+    return (SUB_BUCKET_COUNT + sub) << (msb - SUB_BUCKET_BITS);
+}
+
+void MetricHistogram::Record(uint64_t value)
+{
+    buckets_[BucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+    sum_.fetch_add(value, std::memory_order_relaxed);
+    uint64_t currentMax = max_.load(std::memory_order_relaxed);
+    while (value > currentMax && !max_.compare_exchange_weak(currentMax, value, std::memory_order_relaxed)) {
+    }
+}
+
+MetricHistogram::Snapshot MetricHistogram::GetSnapshot() const
+{
+    Snapshot snapshot;
+    std::array<uint64_t, BUCKET_COUNT> counts{};
+    uint64_t total = 0;
+    for (size_t i = 0; i < BUCKET_COUNT; i++) {
+        counts[i] = buckets_[i].load(std::memory_order_relaxed);
+        total += counts[i];
+    }
+    snapshot.count = total;
+    snapshot.sum = sum_.load(std::memory_order_relaxed);
+    snapshot.max = max_.load(std::memory_order_relaxed);
+    if (total == 0) {
+        return snapshot;
+    }
+
+    snapshot.p50 = BucketLowerBound(PercentileBucket(counts.data(), BUCKET_COUNT, total, PERCENT_50));
+    snapshot.p90 = BucketLowerBound(PercentileBucket(counts.data(), BUCKET_COUNT, total, PERCENT_90));
+    snapshot.p99 = BucketLowerBound(PercentileBucket(counts.data(), BUCKET_COUNT, total, PERCENT_99));
+    return snapshot;
+}
+
+CastEngineMetrics &CastEngineMetrics::GetInstance()
+{
+    static CastEngineMetrics instance{};
+    return instance;
+}
+
+MetricCounter &CastEngineMetrics::RegisterCounter(const std::string &name)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto &counter = counters_[name];
+    if (!counter) {
+        counter = std::make_unique<MetricCounter>();
+    }
+    return *counter;
+}
+
+MetricGauge &CastEngineMetrics::RegisterGauge(const std::string &name)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto &gauge = gauges_[name];
+    if (!gauge) {
+        gauge = std::make_unique<MetricGauge>();
+    }
+    return *gauge;
+}
+
+MetricHistogram &CastEngineMetrics::RegisterHistogram(const std::string &name)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto &histogram = histograms_[name];
+    if (!histogram) {
+        histogram = std::make_unique<MetricHistogram>();
+    }
+    return *histogram;
+}
+
+void CastEngineMetrics::RegisterDefaultMetrics()
+{
+    CLOGI("In.");
+    for (const char *name : { METRIC_CHANNEL_RX_BYTES, METRIC_CHANNEL_RX_FRAMES, METRIC_CHANNEL_TX_BYTES,
+        METRIC_CHANNEL_TX_FRAMES, METRIC_CHANNEL_TX_ERRORS, METRIC_CHANNEL_RX_ERRORS, METRIC_CHANNEL_OPENED,
+        METRIC_RTSP_RX_MESSAGES, METRIC_RTSP_TX_MESSAGES, METRIC_RTSP_TX_ERRORS, METRIC_RTSP_DECRYPT_ERRORS,
+        METRIC_RTSP_TIMEOUTS, METRIC_RTSP_KEEP_ALIVE_LOST, METRIC_RTSP_PEER_GONE,
+        METRIC_CRYPTO_BYTES, METRIC_STREAM_RX_ACTIONS, METRIC_STREAM_TX_ACTIONS, METRIC_STREAM_DROPPED_ACTIONS,
+        METRIC_DATA_SOURCE_READ_BYTES, METRIC_DATA_SOURCE_REQUESTS,
+        METRIC_STREAM_GAPLESS_SWITCHES, METRIC_ARTWORK_CACHE_HITS,
+        METRIC_ARTWORK_CACHE_MISSES, METRIC_HANDLER_MESSAGES, METRIC_CONNECT_SUCCESS, METRIC_CONNECT_FAILED,
+        METRIC_SERVICE_COLD_STARTS, METRIC_SERVICE_WARM_STARTS, METRIC_SERVICE_UNLOAD_CANCELLED,
+        METRIC_VTP_RETRANSMITS, METRIC_VTP_NACKS_SENT, METRIC_VTP_FEC_RECOVERED, METRIC_VTP_FRAMES_DROPPED,
+        METRIC_VTP_HELLOS_REJECTED,
+        METRIC_CHANNEL_SEND_BACKPRESSURE, METRIC_MIRROR_RATE_CHANGES, METRIC_NAPI_CALLBACK_EVENTS,
+        METRIC_NAPI_CALLBACK_COALESCED, METRIC_MIRROR_INPUT_EVENTS, METRIC_MIRROR_INPUT_DRAINS }) {
+        RegisterCounter(name);
+    }
+    for (const char *name : { METRIC_CHANNEL_SEND_US, METRIC_RTSP_PARSE_US, METRIC_RTSP_TRANSACTION_US,
+        METRIC_CRYPTO_ENCRYPT_US,
+        METRIC_CRYPTO_DECRYPT_US, METRIC_STREAM_ACTION_HANDLE_US, METRIC_STREAM_ACTION_ENCODE_US,
+        METRIC_STREAM_ACTION_DECODE_US, METRIC_DATA_SOURCE_READ_US, METRIC_HANDLER_LATENCY_US,
+        METRIC_HANDLER_HANDLE_US, METRIC_CONNECT_TOTAL_US, METRIC_STREAM_TRACK_GAP_US,
+        METRIC_STREAM_IMAGE_FIRST_PIXEL_US, METRIC_CHANNEL_ALL_READY_US, METRIC_CHANNEL_CONTROL_QUEUE_WAIT_US,
+        METRIC_NAPI_CALLBACK_WAIT_US, METRIC_MIRROR_INPUT_QUEUED_US }) {
+        RegisterHistogram(name);
+    }
+    RegisterGauge(METRIC_SERVICE_ACTIVE_SESSIONS);
+    RegisterGauge(METRIC_ARTWORK_CACHE_BYTES);
+    RegisterGauge(METRIC_MIRROR_BITRATE);
+    RegisterGauge(METRIC_NAPI_CALLBACK_BACKLOG);
+}
+
+std::string CastEngineMetrics::Dump()
+{
+    json counters = json::object();
+    json gauges = json::object();
+    json histograms = json::object();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto &[name, counter] : counters_) {
+            counters[name] = counter->Value();
+        }
+        for (const auto &[name, gauge] : gauges_) {
+            gauges[name] = gauge->Value();
+        }
+        for (const auto &[name, histogram] : histograms_) {
+            auto snapshot = histogram->GetSnapshot();
+            histograms[name] = { { "count", snapshot.count }, { "sum", snapshot.sum }, { "max", snapshot.max },
+                { "p50", snapshot.p50 }, { "p90", snapshot.p90 }, { "p99", snapshot.p99 } };
+        }
+    }
+
+    json metrics;
+    metrics["timestamp"] = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    metrics["counters"] = counters;
+    metrics["gauges"] = gauges;
+    metrics["histograms"] = histograms;
+    return metrics.dump();
+}
+} // namespace CastEngine
+} // namespace OHOS
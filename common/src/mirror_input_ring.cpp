@@ -0,0 +1,227 @@
+/*
+ * Copyright (C) 2023-2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * Description: shared memory ring that carries the mirror player input events from the client to the service.
+ * Author: zhangge
+ * Create: 2023-06-05
+ */
+
+#include "mirror_input_ring.h"
+
+#include <atomic>
+#include <chrono>
+#include <new>
+#include <sys/mman.h>
+#include <type_traits>
+
+#include "cast_engine_common_helper.h"
+#include "cast_engine_log.h"
+#include "securec.h"
+
+namespace OHOS {
+namespace CastEngine {
+DEFINE_CAST_ENGINE_LABEL("Cast-MirrorInputRing");
+
+namespace {
+constexpr uint32_t RING_MAGIC = 0x4d495252; // "MIRR"
+constexpr uint32_t RING_VERSION = 1;
+// A power of two, so that index % capacity stays continuous when the indices wrap.
+constexpr uint32_t RING_CAPACITY = 128;
+constexpr size_t CACHE_LINE_SIZE = 64;
+
+int64_t NowUs()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+} // namespace
+
+static_assert(std::is_trivially_copyable_v<OHRemoteControlEvent>, "input events are copied bytewise");
+static_assert(std::atomic<uint32_t>::is_always_lock_free, "ring indices are shared between processes");
+
+// The indices run freely and wrap at 2^32, a slot is index % capacity. head is only written by the client, tail and
+// the layout fields only by the service.
+struct MirrorInputRing::Header {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t capacity;
+    uint32_t recordSize;
+    alignas(CACHE_LINE_SIZE) std::atomic<uint32_t> head;
+    alignas(CACHE_LINE_SIZE) std::atomic<uint32_t> tail;
+    // Set by the producer that finds the ring idle and rings the service, cleared by the service once drained.
+    alignas(CACHE_LINE_SIZE) std::atomic<uint32_t> isDrainPending;
+};
+
+struct MirrorInputRing::Record {
+    uint32_t kind;
+    uint32_t reserved;
+    // steady clock, which is the system wide monotonic clock on both ends.
+    int64_t queuedTimeUs;
+    OHRemoteControlEvent event;
+};
+
+MirrorInputRing::MirrorInputRing(const sptr<Ashmem> &ashmem, uint8_t *base, size_t size, uint32_t capacity)
+    : ashmem_(ashmem), base_(base), size_(size), capacity_(capacity)
+{
+}
+
+size_t MirrorInputRing::GetRecordsOffset()
+{
+    return (sizeof(Header) + CACHE_LINE_SIZE - 1) / CACHE_LINE_SIZE * CACHE_LINE_SIZE;
+}
+
+MirrorInputRing::~MirrorInputRing()
+{
+    if (base_ != nullptr) {
+        munmap(base_, size_);
+    }
+}
+
+uint8_t *MirrorInputRing::Map(const sptr<Ashmem> &ashmem, size_t size)
+{
+    void *base = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, ashmem->GetAshmemFd(), 0);
+    if (base == MAP_FAILED) {
+        CLOGE("mmap input ring failed, errno %{public}d", errno);
+        return nullptr;
+    }
+    return static_cast<uint8_t *>(base);
+}
+
+std::shared_ptr<MirrorInputRing> MirrorInputRing::Create()
+{
+    size_t size = GetRecordsOffset() + sizeof(Record) * RING_CAPACITY;
+    sptr<Ashmem> ashmem = Ashmem::CreateAshmem("cast_mirror_input", static_cast<int32_t>(size));
+    if (ashmem == nullptr) {
+        CLOGE("Create input ring ashmem failed");
+        return nullptr;
+    }
+    uint8_t *base = Map(ashmem, size);
+    if (base == nullptr) {
+        return nullptr;
+    }
+    auto *header = new (base) Header{};
+    header->magic = RING_MAGIC;
+    header->version = RING_VERSION;
+    header->capacity = RING_CAPACITY;
+    header->recordSize = sizeof(Record);
+    CLOGI("input ring created, %{public}u records of %{public}zu bytes", RING_CAPACITY, sizeof(Record));
+    return std::make_shared<MirrorInputRing>(ashmem, base, size, RING_CAPACITY);
+}
+
+std::shared_ptr<MirrorInputRing> MirrorInputRing::Attach(const sptr<Ashmem> &ashmem)
+{
+    if (ashmem == nullptr) {
+        return nullptr;
+    }
+    int32_t ashmemSize = ashmem->GetAshmemSize();
+    if (ashmemSize < static_cast<int32_t>(GetRecordsOffset())) {
+        CLOGE("input ring is too small: %{public}d", ashmemSize);
+        return nullptr;
+    }
+    size_t size = static_cast<size_t>(ashmemSize);
+    uint8_t *base = Map(ashmem, size);
+    if (base == nullptr) {
+        return nullptr;
+    }
+    const auto *header = reinterpret_cast<const Header *>(base);
+    uint32_t capacity = header->capacity;
+    if (header->magic != RING_MAGIC || header->version != RING_VERSION || header->recordSize != sizeof(Record) ||
+        capacity == 0 || (capacity & (capacity - 1)) != 0 ||
+        GetRecordsOffset() + static_cast<size_t>(capacity) * sizeof(Record) > size) {
+        CLOGE("Unsupported input ring, version %{public}u record %{public}u", header->version, header->recordSize);
+        munmap(base, size);
+        return nullptr;
+    }
+    return std::make_shared<MirrorInputRing>(ashmem, base, size, capacity);
+}
+
+MirrorInputRing::Header &MirrorInputRing::GetHeader() const
+{
+    return *reinterpret_cast<Header *>(base_);
+}
+
+MirrorInputRing::Record &MirrorInputRing::GetRecord(uint32_t index) const
+{
+    return reinterpret_cast<Record *>(base_ + GetRecordsOffset())[index % capacity_];
+}
+
+MirrorInputRing::PushResult MirrorInputRing::Push(EventKind kind, const OHRemoteControlEvent &event)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    Header &header = GetHeader();
+    uint32_t head = header.head.load(std::memory_order_relaxed);
+    if (head - header.tail.load(std::memory_order_acquire) >= capacity_) {
+        return PushResult::FULL;
+    }
+    Record &record = GetRecord(head);
+    record.kind = static_cast<uint32_t>(kind);
+    record.queuedTimeUs = NowUs();
+    if (memcpy_s(&record.event, sizeof(record.event), &event, sizeof(event)) != EOK) {
+        CLOGE("copy input event failed");
+    }
+    // Publishing head before looking at the pending flag pairs with the service clearing the flag before it looks at
+    // head again, so either the running drain sees this record or this push rings a new one.
+    header.head.store(head + 1);
+    return header.isDrainPending.exchange(1) == 0 ? PushResult::NOTIFY : PushResult::QUEUED;
+}
+
+void MirrorInputRing::ResetNotify()
+{
+    GetHeader().isDrainPending.store(0);
+}
+
+size_t MirrorInputRing::Drain(const Handler &handler)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    Header &header = GetHeader();
+    size_t handled = 0;
+    bool isRecheck = false;
+    while (true) {
+        uint32_t tail = header.tail.load(std::memory_order_relaxed);
+        uint32_t head = header.head.load();
+        if (head - tail > capacity_) {
+            CLOGE("input ring indices are corrupt, head %{public}u tail %{public}u", head, tail);
+            header.tail.store(head, std::memory_order_release);
+            continue;
+        }
+        if (head == tail) {
+            if (isRecheck) {
+                break;
+            }
+            header.isDrainPending.store(0);
+            isRecheck = true;
+            continue;
+        }
+        int64_t nowUs = NowUs();
+        for (; tail != head; tail++) {
+            Record record;
+            if (memcpy_s(&record, sizeof(record), &GetRecord(tail), sizeof(Record)) != EOK) {
+                CLOGE("copy input record failed");
+                continue;
+            }
+            // Release each slot before dispatching so that a slow handler does not stall the producer.
+            header.tail.store(tail + 1, std::memory_order_release);
+            if (record.kind > static_cast<uint32_t>(EventKind::INJECT) || !IsValidRemoteControlEvent(record.event)) {
+                CLOGE("Drop invalid input record, kind %{public}u", record.kind);
+                continue;
+            }
+            handler(static_cast<EventKind>(record.kind), record.event,
+                nowUs > record.queuedTimeUs ? nowUs - record.queuedTimeUs : 0);
+            handled++;
+        }
+        isRecheck = false;
+    }
+    return handled;
+}
+} // namespace CastEngine
+} // namespace OHOS
@@ -416,7 +416,7 @@ enum AudioSampleFormat : uint8_t {
     SAMPLE_S24LE = 2,
     SAMPLE_S32LE = 3,
     SAMPLE_F32LE = 4,
-    INVALID_WIDTH = -1
+    INVALID_WIDTH = 0xFF
 };
 
 // channel
@@ -666,6 +666,7 @@ enum class EXPORT EventId {
     MIRROR_HICAR_NOTIFY_SCREEN_PARAM,
     CAST_CAPABILITY,
     FIRST_FRAME_RENDER,
+    MIRROR_VIDEO_RATE_CHANGED,
     MIRROR_END = 1999,
     STREAM_BEGIN = 2000,
     STEAM_DEVICE_DISCONNECTED,
@@ -19,16 +19,26 @@
 #ifndef NAPI_CALLBACK_H
 #define NAPI_CALLBACK_H
 
+#include <array>
+#include <chrono>
+#include <deque>
 #include <functional>
 #include <list>
+#include <memory>
+#include <mutex>
 #include "napi/native_api.h"
 #include "napi/native_common.h"
 #include "napi/native_node_api.h"
-#include "uv.h"
 
 namespace OHOS {
 namespace CastEngine {
 namespace CastEngineClient {
+/*
+ * Events are queued from any thread and delivered on the JS thread through one threadsafe function, which is woken
+ * once per batch rather than once per event. An event handled as latest only keeps a single slot in the queue: a
+ * newer one replaces the arguments of the one still waiting, so a busy JS thread sees the last position or volume
+ * instead of a backlog of stale ones.
+ */
 class NapiCallback final : public std::enable_shared_from_this<NapiCallback> {
 public:
     using NapiArgsGetter = std::function<void(napi_env env, int &argc, napi_value *argv)>;
@@ -38,31 +48,39 @@ public:
 
     napi_env GetEnv() const;
 
-    void HandleEvent(int32_t event, NapiArgsGetter &getter);
+    void HandleEvent(int32_t event, NapiArgsGetter &getter, bool isLatestOnly = false);
     napi_status AddCallback(napi_env env, int32_t event, napi_value callback);
     napi_status RemoveCallback(napi_env env, int32_t event, napi_value callback);
     bool IsCallbackListEmpty();
 
 private:
-    struct DataContext {
-        napi_env env;
-        napi_ref method;
-        NapiArgsGetter getter;
-        std::shared_ptr<NapiCallback> callback;
+    struct PendingEvent {
         int32_t event;
+        bool isLatestOnly;
+        NapiArgsGetter getter;
+        std::chrono::steady_clock::time_point queuedTime;
     };
-    void Call(napi_ref method, NapiArgsGetter &getter, int32_t event);
-    void AfterWorkCallback(std::shared_ptr<DataContext> context);
+    static void CallJs(napi_env env, napi_value jsCallback, void *context, void *data);
+    static void Finalize(napi_env env, void *data, void *hint);
+    napi_status CreateThreadsafeFunctionLocked(napi_env env);
+    void DispatchPendingEvents(napi_env env);
+    void Call(napi_env env, napi_ref method, const NapiArgsGetter &getter, int32_t event);
     bool IsCallbackValid(napi_env env, napi_ref ref, int32_t event);
     napi_status ReleaseRef(napi_env env, napi_ref ref);
 
     static constexpr int EVENT_TYPE_MAX = 30;
     static constexpr size_t ARGC_MAX = 6;
+    static constexpr size_t BACKLOG_WARNING = 64;
 
     napi_env env_ = nullptr;
-    uv_loop_s *loop_ = nullptr;
+    napi_threadsafe_function tsfn_ = nullptr;
     std::mutex lock_;
     std::list<napi_ref> callbacks_[EVENT_TYPE_MAX] {};
+    std::mutex queueLock_;
+    std::deque<PendingEvent> pendingEvents_;
+    std::array<NapiArgsGetter, EVENT_TYPE_MAX> latestGetters_ {};
+    std::array<bool, EVENT_TYPE_MAX> isLatestQueued_ {};
+    bool isScheduled_ = false;
 };
 } // namespace CastEngineClient
 } // namespace CastEngine
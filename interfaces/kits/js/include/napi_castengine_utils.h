@@ -98,6 +98,8 @@ bool GetJSFuncParams(napi_env env, napi_callback_info info, napi_value argv[], s
 bool CheckJSParamsType(napi_env env, napi_value argv[], size_t expectedArgc, napi_valuetype expectedTypes[]);
 void CallJSFunc(napi_env env, napi_ref func, size_t argc, napi_value argv[]);
 napi_value GetUndefinedValue(napi_env env);
+// Js string for a property name, created once per env and reused by every later lookup or definition.
+napi_value GetPropertyKey(napi_env env, const char *name);
 bool Equals(napi_env env, napi_value value, napi_ref copy);
 napi_status GetRefByCallback(napi_env env, std::list<napi_ref> &callbackList, napi_value callback,
     napi_ref &callbackRef);
@@ -82,7 +82,7 @@ public:
     napi_status RemoveCallback(napi_env env, int32_t event, napi_value callback);
 
 private:
-    void HandleEvent(int32_t event, NapiArgsGetter &getter);
+    void HandleEvent(int32_t event, NapiArgsGetter &getter, bool isLatestOnly = false);
 
     std::mutex lock_;
     std::shared_ptr<NapiCallback> callback_;
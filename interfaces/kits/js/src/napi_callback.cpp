@@ -18,6 +18,7 @@
 
 #include <memory>
 #include "cast_engine_log.h"
+#include "cast_engine_metrics.h"
 #include "napi_callback.h"
 #include "napi_castengine_utils.h"
 
@@ -28,14 +29,16 @@ DEFINE_CAST_ENGINE_LABEL("Cast-Napi-Callback");
 
 NapiCallback::NapiCallback(napi_env env) : env_(env)
 {
-    if (env != nullptr) {
-        NAPI_CALL_RETURN_VOID(env, napi_get_uv_event_loop(env, &loop_));
-    }
 }
 
 NapiCallback::~NapiCallback()
 {
     CLOGD("no memory leak for queue-callback");
+    // Pending events are dropped; the context goes with the finalizer on the JS thread.
+    if (tsfn_ != nullptr) {
+        napi_release_threadsafe_function(tsfn_, napi_tsfn_abort);
+        tsfn_ = nullptr;
+    }
     env_ = nullptr;
 }
 
@@ -44,84 +47,129 @@ napi_env NapiCallback::GetEnv() const
     return env_;
 }
 
-void NapiCallback::AfterWorkCallback(std::shared_ptr<DataContext> context)
+napi_status NapiCallback::CreateThreadsafeFunctionLocked(napi_env env)
 {
-    int argc = 0;
-    napi_handle_scope scope = nullptr;
-    napi_open_handle_scope(context->env, &scope);
-    napi_value argv[ARGC_MAX] = { nullptr };
-    if (context->getter) {
-        argc = ARGC_MAX;
-        context->getter(context->env, argc, argv);
+    if (tsfn_ != nullptr) {
+        return napi_ok;
+    }
+    napi_value resourceName = nullptr;
+    napi_status status = napi_create_string_utf8(env, "CastEngineCallback", NAPI_AUTO_LENGTH, &resourceName);
+    if (status != napi_ok) {
+        CLOGE("napi_create_string_utf8 failed");
+        return status;
+    }
+    auto *context = new (std::nothrow) std::weak_ptr<NapiCallback>(shared_from_this());
+    if (context == nullptr) {
+        CLOGE("no memory for context");
+        return napi_generic_failure;
     }
+    constexpr size_t unlimitedQueue = 0;
+    constexpr size_t initialThreadCount = 1;
+    status = napi_create_threadsafe_function(env, nullptr, nullptr, resourceName, unlimitedQueue,
+        initialThreadCount, context, Finalize, context, CallJs, &tsfn_);
+    if (status != napi_ok) {
+        CLOGE("napi_create_threadsafe_function failed");
+        delete context;
+        tsfn_ = nullptr;
+        return status;
+    }
+    // A registered callback must not keep the event loop of the app alive.
+    napi_unref_threadsafe_function(env, tsfn_);
+    return napi_ok;
+}
 
-    napi_value undefined = nullptr;
-    if (napi_get_undefined(context->env, &undefined) != napi_ok) {
-        CLOGE("napi_get_undefined failed");
-        napi_close_handle_scope(context->env, scope);
+void NapiCallback::Finalize(napi_env env, void *data, void *hint)
+{
+    delete static_cast<std::weak_ptr<NapiCallback> *>(data);
+}
+
+void NapiCallback::CallJs(napi_env env, napi_value jsCallback, void *context, void *data)
+{
+    if (env == nullptr || context == nullptr) {
         return;
     }
-    if (!IsCallbackValid(context->env, context->method, context->event)) {
-        CLOGE("callback is invalid event:%{public}d", context->event);
-        napi_close_handle_scope(context->env, scope);
+    auto callback = static_cast<std::weak_ptr<NapiCallback> *>(context)->lock();
+    if (!callback) {
+        CLOGE("callback is nullptr");
         return;
     }
-    napi_value callback = nullptr;
-    if (napi_get_reference_value(context->env, context->method, &callback) != napi_ok) {
-        CLOGE("napi_get_reference_value failed");
-        ReleaseRef(context->env, context->method);
-        napi_close_handle_scope(context->env, scope);
-        return;
+    callback->DispatchPendingEvents(env);
+}
+
+void NapiCallback::DispatchPendingEvents(napi_env env)
+{
+    static auto &delivered = CastEngineMetrics::GetInstance().RegisterCounter(METRIC_NAPI_CALLBACK_EVENTS);
+    static auto &backlog = CastEngineMetrics::GetInstance().RegisterGauge(METRIC_NAPI_CALLBACK_BACKLOG);
+    static auto &waitUs = CastEngineMetrics::GetInstance().RegisterHistogram(METRIC_NAPI_CALLBACK_WAIT_US);
+    std::deque<PendingEvent> events;
+    {
+        std::lock_guard<std::mutex> lockGuard(queueLock_);
+        events.swap(pendingEvents_);
+        for (auto &pending : events) {
+            if (pending.isLatestOnly) {
+                pending.getter = std::move(latestGetters_[pending.event]);
+                latestGetters_[pending.event] = nullptr;
+                isLatestQueued_[pending.event] = false;
+            }
+        }
+        isScheduled_ = false;
     }
-    napi_value callResult = nullptr;
-    if (napi_call_function(context->env, undefined, callback, argc, argv, &callResult) != napi_ok) {
-        CLOGE("napi_call_function failed");
+    backlog.Set(static_cast<int64_t>(events.size()));
+    if (events.size() >= BACKLOG_WARNING) {
+        CLOGW("%{public}zu events waited for the JS thread", events.size());
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    for (const auto &pending : events) {
+        waitUs.Record(static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::microseconds>(now - pending.queuedTime).count()));
+        std::list<napi_ref> refs;
+        {
+            std::lock_guard<std::mutex> lockGuard(lock_);
+            refs = callbacks_[pending.event];
+        }
+        for (auto ref : refs) {
+            Call(env, ref, pending.getter, pending.event);
+        }
+        delivered.Add();
     }
-    ReleaseRef(context->env, context->method);
-    napi_close_handle_scope(context->env, scope);
 }
 
-void NapiCallback::Call(napi_ref method, NapiArgsGetter &getter, int32_t event)
+void NapiCallback::Call(napi_env env, napi_ref method, const NapiArgsGetter &getter, int32_t event)
 {
-    CLOGD("Start to have JS call");
-    if (loop_ == nullptr) {
-        CLOGE("loop_ is nullptr");
-        return;
-    }
-    if (method == nullptr) {
-        CLOGE("method is nullptr");
-        return;
+    int argc = 0;
+    napi_handle_scope scope = nullptr;
+    napi_open_handle_scope(env, &scope);
+    napi_value argv[ARGC_MAX] = { nullptr };
+    if (getter) {
+        argc = ARGC_MAX;
+        getter(env, argc, argv);
     }
 
-    auto *work = new (std::nothrow) uv_work_t;
-    if (work == nullptr) {
-        CLOGE("no memory for uv_work_t");
+    napi_value undefined = nullptr;
+    if (napi_get_undefined(env, &undefined) != napi_ok) {
+        CLOGE("napi_get_undefined failed");
+        napi_close_handle_scope(env, scope);
         return;
     }
-    auto callback = shared_from_this();
-    work->data = new (std::nothrow) DataContext { env_, method, std::move(getter), callback, event };
-    if (work->data == nullptr) {
-        CLOGE("no memory for DataContext");
-        delete work;
+    if (!IsCallbackValid(env, method, event)) {
+        CLOGE("callback is invalid event:%{public}d", event);
+        napi_close_handle_scope(env, scope);
         return;
     }
-    int res = uv_queue_work(loop_, work, [](uv_work_t *work) {}, [](uv_work_t *work, int status) {
-        std::shared_ptr<DataContext> context(static_cast<DataContext *>(work->data), [work](DataContext *ptr) {
-            delete ptr;
-            delete work;
-        });
-        if (!context->callback) {
-            CLOGE("callback is nullptr");
-            return;
-        }
-        context->callback->AfterWorkCallback(context);
-    });
-    if (res != 0) {
-        CLOGE("uv queue work failed");
-        delete static_cast<DataContext *>(work->data);
-        delete work;
+    napi_value callback = nullptr;
+    if (napi_get_reference_value(env, method, &callback) != napi_ok) {
+        CLOGE("napi_get_reference_value failed");
+        ReleaseRef(env, method);
+        napi_close_handle_scope(env, scope);
         return;
     }
+    napi_value callResult = nullptr;
+    if (napi_call_function(env, undefined, callback, argc, argv, &callResult) != napi_ok) {
+        CLOGE("napi_call_function failed");
+    }
+    ReleaseRef(env, method);
+    napi_close_handle_scope(env, scope);
 }
 
 napi_status NapiCallback::AddCallback(napi_env env, int32_t event, napi_value callback)
@@ -132,6 +180,9 @@ napi_status NapiCallback::AddCallback(napi_env env, int32_t event, napi_value ca
     }
     CLOGI("Add callback %{public}d", event);
     std::lock_guard<std::mutex> lockGuard(lock_);
+    if (CreateThreadsafeFunctionLocked(env) != napi_ok) {
+        return napi_generic_failure;
+    }
     constexpr int initialRefCount = 1;
     napi_ref ref = nullptr;
     if (GetRefByCallback(env, callbacks_[event], callback, ref) != napi_ok) {
@@ -179,20 +230,44 @@ napi_status NapiCallback::RemoveCallback(napi_env env, int32_t event, napi_value
     return ReleaseRef(env, ref);
 }
 
-void NapiCallback::HandleEvent(int32_t event, NapiArgsGetter &getter)
+void NapiCallback::HandleEvent(int32_t event, NapiArgsGetter &getter, bool isLatestOnly)
 {
+    static auto &coalesced = CastEngineMetrics::GetInstance().RegisterCounter(METRIC_NAPI_CALLBACK_COALESCED);
     if ((event >= EVENT_TYPE_MAX) || (event < 0)) {
         CLOGE("event %{public}d is invalid", event);
         return;
     }
-    std::lock_guard<std::mutex> lockGuard(lock_);
-    if (callbacks_[event].empty()) {
-        CLOGE("not register callback event=%{public}d", event);
+    {
+        std::lock_guard<std::mutex> lockGuard(lock_);
+        if (callbacks_[event].empty() || tsfn_ == nullptr) {
+            CLOGE("not register callback event=%{public}d", event);
+            return;
+        }
+    }
+
+    std::lock_guard<std::mutex> lockGuard(queueLock_);
+    if (isLatestOnly) {
+        latestGetters_[event] = std::move(getter);
+        if (isLatestQueued_[event]) {
+            coalesced.Add();
+            return;
+        }
+        isLatestQueued_[event] = true;
+        pendingEvents_.push_back({ event, true, nullptr, std::chrono::steady_clock::now() });
+    } else {
+        pendingEvents_.push_back({ event, false, std::move(getter), std::chrono::steady_clock::now() });
+    }
+    if (isScheduled_) {
         return;
     }
-    for (auto ref = callbacks_[event].begin(); ref != callbacks_[event].end(); ++ref) {
-        Call(*ref, getter, event);
+    if (napi_call_threadsafe_function(tsfn_, nullptr, napi_tsfn_nonblocking) != napi_ok) {
+        CLOGE("napi_call_threadsafe_function failed");
+        pendingEvents_.clear();
+        latestGetters_.fill(nullptr);
+        isLatestQueued_.fill(false);
+        return;
     }
+    isScheduled_ = true;
 }
 
 bool NapiCallback::IsCallbackValid(napi_env env, napi_ref ref, int32_t event)
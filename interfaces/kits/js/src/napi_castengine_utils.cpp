@@ -17,7 +17,10 @@
  */
 
 #include <uv.h>
+#include <functional>
+#include <map>
 #include <memory>
+#include <unordered_map>
 #include "securec.h"
 #include "napi/native_api.h"
 #include "napi/native_node_api.h"
@@ -34,6 +37,140 @@ namespace CastEngine {
 namespace CastEngineClient {
 DEFINE_CAST_ENGINE_LABEL("Cast-Napi-Utils");
 
+namespace {
+// What napi_set_named_property gives a plain data property.
+constexpr napi_property_attributes JS_DATA_PROPERTY =
+    static_cast<napi_property_attributes>(napi_writable | napi_enumerable | napi_configurable);
+
+// An env only ever runs on its own thread, so the keys of every env live in the map of that thread. The transparent
+// comparator looks a key up by its const char * name, without building a std::string for it.
+using PropertyKeyMap = std::map<std::string, napi_ref, std::less<>>;
+thread_local std::unordered_map<napi_env, PropertyKeyMap> g_propertyKeys;
+
+void ReleasePropertyKeys(void *data)
+{
+    auto env = static_cast<napi_env>(data);
+    auto keys = g_propertyKeys.find(env);
+    if (keys == g_propertyKeys.end()) {
+        return;
+    }
+    for (auto &[name, ref] : keys->second) {
+        napi_delete_reference(env, ref);
+    }
+    g_propertyKeys.erase(keys);
+}
+
+napi_property_descriptor JsProperty(napi_env env, const char *name, napi_value value)
+{
+    napi_value key = GetPropertyKey(env, name);
+    return { key == nullptr ? name : nullptr, key, nullptr, nullptr, nullptr, value, JS_DATA_PROPERTY, nullptr };
+}
+
+napi_value CreateJsString(napi_env env, const std::string &str)
+{
+    napi_value value = nullptr;
+    NAPI_CALL(env, napi_create_string_utf8(env, str.c_str(), str.size(), &value));
+    return value;
+}
+
+napi_value CreateJsInt32(napi_env env, int32_t number)
+{
+    napi_value value = nullptr;
+    NAPI_CALL(env, napi_create_int32(env, number, &value));
+    return value;
+}
+
+napi_value CreateJsUint32(napi_env env, uint32_t number)
+{
+    napi_value value = nullptr;
+    NAPI_CALL(env, napi_create_uint32(env, number, &value));
+    return value;
+}
+
+napi_value CreateJsBool(napi_env env, bool flag)
+{
+    napi_value value = nullptr;
+    NAPI_CALL(env, napi_get_boolean(env, flag, &value));
+    return value;
+}
+
+template<size_t N>
+napi_value CreateJsObject(napi_env env, const napi_property_descriptor (&properties)[N])
+{
+    // A value that failed to be created has already thrown, defining the object with it would throw again.
+    for (size_t i = 0; i < N; i++) {
+        if (properties[i].value == nullptr) {
+            CLOGE("Create value of property %{public}zu failed", i);
+            return nullptr;
+        }
+    }
+    napi_value result = nullptr;
+    NAPI_CALL(env, napi_create_object(env, &result));
+    NAPI_CALL(env, napi_define_properties(env, result, N, properties));
+    return result;
+}
+
+// A missing field reads as undefined, so one keyed get answers both whether it is there and what it holds.
+bool GetJsField(napi_env env, napi_value object, const char *fieldStr, napi_valuetype expectedType,
+    napi_value &field, bool isOptional = false)
+{
+    if (object == nullptr) {
+        CLOGE("args is nullptr");
+        return false;
+    }
+    napi_value key = GetPropertyKey(env, fieldStr);
+    napi_status status = key != nullptr ? napi_get_property(env, object, key, &field) :
+        napi_get_named_property(env, object, fieldStr, &field);
+    if (status != napi_ok) {
+        CLOGE("napi_get_property failed: %{public}s", fieldStr);
+        return false;
+    }
+    napi_valuetype valueType = napi_undefined;
+    status = napi_typeof(env, field, &valueType);
+    if (status != napi_ok || valueType == napi_undefined) {
+        if (!isOptional) {
+            CLOGE("Js obj no property: %{public}s", fieldStr);
+        }
+        return false;
+    }
+    if (valueType != expectedType) {
+        CLOGE("Wrong argument type of %{public}s: %{public}d", fieldStr, valueType);
+        return false;
+    }
+    return true;
+}
+} // namespace
+
+napi_value GetPropertyKey(napi_env env, const char *name)
+{
+    auto keys = g_propertyKeys.find(env);
+    if (keys == g_propertyKeys.end()) {
+        if (napi_add_env_cleanup_hook(env, ReleasePropertyKeys, env) != napi_ok) {
+            CLOGE("napi_add_env_cleanup_hook failed");
+            return nullptr;
+        }
+        keys = g_propertyKeys.emplace(env, PropertyKeyMap()).first;
+    }
+    napi_value key = nullptr;
+    auto cached = keys->second.find(name);
+    if (cached != keys->second.end()) {
+        if (napi_get_reference_value(env, cached->second, &key) == napi_ok && key != nullptr) {
+            return key;
+        }
+        napi_delete_reference(env, cached->second);
+        keys->second.erase(cached);
+    }
+    if (napi_create_string_utf8(env, name, NAPI_AUTO_LENGTH, &key) != napi_ok) {
+        CLOGE("napi_create_string_utf8 failed");
+        return nullptr;
+    }
+    napi_ref ref = nullptr;
+    if (napi_create_reference(env, key, 1, &ref) == napi_ok) {
+        keys->second.emplace(name, ref);
+    }
+    return key;
+}
+
 napi_value GetUndefinedValue(napi_env env)
 {
     napi_value result {};
@@ -155,39 +292,27 @@ bool ParseBool(napi_env env, napi_value args)
 
 napi_value ConvertDeviceListToJS(napi_env env, const vector<CastRemoteDevice> &devices)
 {
-    int count = 0;
     napi_value devicesList = nullptr;
-    NAPI_CALL(env, napi_create_array(env, &devicesList));
-    for (CastRemoteDevice vec : devices) {
-        napi_value deviceResult = ConvertCastRemoteDeviceToJS(env, vec);
-        NAPI_CALL(env, napi_set_element(env, devicesList, count, deviceResult));
-        count++;
-    }
-
-    if (devicesList == nullptr) {
-        CLOGE("devicesList is null");
+    NAPI_CALL(env, napi_create_array_with_length(env, devices.size(), &devicesList));
+    uint32_t index = 0;
+    for (const auto &device : devices) {
+        napi_value deviceResult = ConvertCastRemoteDeviceToJS(env, device);
+        if (deviceResult == nullptr) {
+            return nullptr;
+        }
+        NAPI_CALL(env, napi_set_element(env, devicesList, index++, deviceResult));
     }
     return devicesList;
 }
 
 napi_value ConvertDeviceStateInfoToJS(napi_env env, const DeviceStateInfo &stateEvent)
 {
-    napi_value stateEventCallback = nullptr;
-    NAPI_CALL(env, napi_create_object(env, &stateEventCallback));
-
-    napi_value deviceState = nullptr;
-    NAPI_CALL(env, napi_create_int32(env, static_cast<int32_t>(stateEvent.deviceState), &deviceState));
-    NAPI_CALL(env, napi_set_named_property(env, stateEventCallback, "deviceState", deviceState));
-
-    napi_value deviceId = nullptr;
-    NAPI_CALL(env, napi_create_string_utf8(env, stateEvent.deviceId.c_str(), NAPI_AUTO_LENGTH, &deviceId));
-    NAPI_CALL(env, napi_set_named_property(env, stateEventCallback, "deviceId", deviceId));
-
-    napi_value reasonCode = nullptr;
-    NAPI_CALL(env, napi_create_int32(env, static_cast<int32_t>(stateEvent.reasonCode), &reasonCode));
-    NAPI_CALL(env, napi_set_named_property(env, stateEventCallback, "reasonCode", reasonCode));
-
-    return stateEventCallback;
+    napi_property_descriptor properties[] = {
+        JsProperty(env, "deviceState", CreateJsInt32(env, static_cast<int32_t>(stateEvent.deviceState))),
+        JsProperty(env, "deviceId", CreateJsString(env, stateEvent.deviceId)),
+        JsProperty(env, "reasonCode", CreateJsInt32(env, static_cast<int32_t>(stateEvent.reasonCode))),
+    };
+    return CreateJsObject(env, properties);
 }
 
 CastRemoteDevice GetCastRemoteDeviceFromJS(napi_env env, napi_value &object)
@@ -215,14 +340,7 @@ WindowProperty GetWindowPropertyFromJS(napi_env env, napi_value &object)
     WindowProperty windowProperty = WindowProperty();
 
     napi_value windowPropertyCallback = nullptr;
-    bool hasProperty = false;
-    napi_status status = napi_has_named_property(env, object, "windowProperty", &hasProperty);
-    if (status == napi_ok && hasProperty) {
-        status = napi_get_named_property(env, object, "windowProperty", &windowPropertyCallback);
-        if (status != napi_ok) {
-            CLOGE("napi_get_named_property failed.");
-            return windowProperty;
-        }
+    if (GetJsField(env, object, "windowProperty", napi_object, windowPropertyCallback, true)) {
         uint32_t width = JsObjectToUint32(env, windowPropertyCallback, "width");
         uint32_t height = JsObjectToUint32(env, windowPropertyCallback, "height");
         uint32_t startX = JsObjectToUint32(env, windowPropertyCallback, "startX");
@@ -264,16 +382,13 @@ bool GetProtocolTypesFromJS(napi_env env, napi_value &object, int &protocolTypes
 bool GetMediaInfoHolderFromJS(napi_env env, napi_value &object, MediaInfoHolder &mediaInfoHolder)
 {
     napi_value mediaInfoList = nullptr;
-    bool hasProperty = false;
 
     mediaInfoHolder.currentIndex = JsObjectToUint32(env, object, "currentIndex");
     mediaInfoHolder.progressRefreshInterval = JsObjectToUint32(env, object, "progressRefreshInterval");
-    NAPI_CALL_BASE(env, napi_has_named_property(env, object, "mediaInfoList", &hasProperty), false);
-    if (!hasProperty) {
+    if (!GetJsField(env, object, "mediaInfoList", napi_object, mediaInfoList)) {
         CLOGE("mediaInfoList is not exit");
         return false;
     }
-    NAPI_CALL_BASE(env, napi_get_named_property(env, object, "mediaInfoList", &mediaInfoList), false);
     bool isArray = false;
     NAPI_CALL_BASE(env, napi_is_array(env, mediaInfoList, &isArray), false);
     if (!isArray) {
@@ -286,12 +401,13 @@ bool GetMediaInfoHolderFromJS(napi_env env, napi_value &object, MediaInfoHolder
         CLOGE("mediaInfoList len is invalid");
         return false;
     }
+    mediaInfoHolder.mediaInfoList.reserve(arrLen);
     for (uint32_t i = 0; i < arrLen; i++) {
         napi_value item = nullptr;
         NAPI_CALL_BASE(env, napi_get_element(env, mediaInfoList, i, &item), false);
         MediaInfo mediaInfo = MediaInfo{};
         GetMediaInfoFromJS(env, item, mediaInfo);
-        mediaInfoHolder.mediaInfoList.push_back(mediaInfo);
+        mediaInfoHolder.mediaInfoList.push_back(std::move(mediaInfo));
     }
     return true;
 }
@@ -325,27 +441,13 @@ CastSessionProperty GetCastSessionPropertyFromJS(napi_env env, napi_value &objec
     int32_t endTypeInt = JsObjectToInt32(env, object, "endType");
     EndType endType = static_cast<EndType>(endTypeInt);
     napi_value audioPropertyCallback = nullptr;
-    bool hasProperty = false;
-    napi_status status = napi_has_named_property(env, object, "audioProperty", &hasProperty);
-    if (status == napi_ok && hasProperty) {
-        status = napi_get_named_property(env, object, "audioProperty", &audioPropertyCallback);
-        if (status != napi_ok) {
-            CLOGE("napi_get_named_property failed.");
-            return castSessionProperty;
-        }
+    if (GetJsField(env, object, "audioProperty", napi_object, audioPropertyCallback, true)) {
         AudioProperty audioProperty = GetAudioPropertyFromJS(env, audioPropertyCallback);
         castSessionProperty.audioProperty = audioProperty;
     }
 
     napi_value videoPropertyCallback = nullptr;
-    hasProperty = false;
-    status = napi_has_named_property(env, object, "videoProperty", &hasProperty);
-    if (status == napi_ok && hasProperty) {
-        status = napi_get_named_property(env, object, "videoProperty", &videoPropertyCallback);
-        if (status != napi_ok) {
-            CLOGE("napi_get_named_property failed.");
-            return castSessionProperty;
-        }
+    if (GetJsField(env, object, "videoProperty", napi_object, videoPropertyCallback, true)) {
         VideoProperty videoProperty = GetVideoPropertyFromJS(env, videoPropertyCallback);
         castSessionProperty.videoProperty = videoProperty;
     }
@@ -444,98 +546,41 @@ napi_status GetRefByCallback(napi_env env, std::list<napi_ref> &callbackList,
 
 napi_value ConvertCastRemoteDeviceToJS(napi_env env, const CastRemoteDevice &castRemoteDevice)
 {
-    napi_value result = nullptr;
-    NAPI_CALL(env, napi_create_object(env, &result));
-    napi_value deviceId = nullptr;
-    NAPI_CALL(env, napi_create_string_utf8(env, castRemoteDevice.deviceId.c_str(), NAPI_AUTO_LENGTH, &deviceId));
-    NAPI_CALL(env, napi_set_named_property(env, result, "deviceId", deviceId));
-    napi_value deviceName = nullptr;
     CLOGD("ConvertCastRemoteDeviceToJS deviceName %{public}s", castRemoteDevice.deviceName.c_str());
-    NAPI_CALL(env, napi_create_string_utf8(env, castRemoteDevice.deviceName.c_str(), NAPI_AUTO_LENGTH, &deviceName));
-    NAPI_CALL(env, napi_set_named_property(env, result, "deviceName", deviceName));
-    napi_value deviceType = nullptr;
-    NAPI_CALL(env, napi_create_int32(env, static_cast<int32_t>(castRemoteDevice.deviceType), &deviceType));
-    NAPI_CALL(env, napi_set_named_property(env, result, "deviceType", deviceType));
-    napi_value subDeviceType = nullptr;
-    NAPI_CALL(env, napi_create_int32(env, static_cast<int32_t>(castRemoteDevice.subDeviceType), &subDeviceType));
-    NAPI_CALL(env, napi_set_named_property(env, result, "subDeviceType", subDeviceType));
-    napi_value ipAddress = nullptr;
-    NAPI_CALL(env, napi_create_string_utf8(env, castRemoteDevice.ipAddress.c_str(), NAPI_AUTO_LENGTH, &ipAddress));
-    NAPI_CALL(env, napi_set_named_property(env, result, "ipAddress", ipAddress));
-    napi_value channelType = nullptr;
-    NAPI_CALL(env, napi_create_int32(env, static_cast<int32_t>(castRemoteDevice.channelType), &channelType));
-    NAPI_CALL(env, napi_set_named_property(env, result, "channelType", channelType));
-    napi_value networkId = nullptr;
-    NAPI_CALL(env, napi_create_string_utf8(env, castRemoteDevice.networkId.c_str(), NAPI_AUTO_LENGTH, &networkId));
-    NAPI_CALL(env, napi_set_named_property(env, result, "networkId", networkId));
-    napi_value isLegacy = nullptr;
-    NAPI_CALL(env, napi_get_boolean(env, castRemoteDevice.isLegacy, &isLegacy));
-    NAPI_CALL(env, napi_set_named_property(env, result, "isLegacy", isLegacy));
-    napi_value mediumTypes = nullptr;
-    NAPI_CALL(env, napi_create_int32(env, static_cast<int32_t>(castRemoteDevice.mediumTypes), &mediumTypes));
-    NAPI_CALL(env, napi_set_named_property(env, result, "mediumTypes", mediumTypes));
-    napi_value protocolCapabilities = nullptr;
-    NAPI_CALL(env,
-        napi_create_int32(env, static_cast<int32_t>(castRemoteDevice.protocolCapabilities), &protocolCapabilities));
-    NAPI_CALL(env, napi_set_named_property(env, result, "protocolCapabilities", protocolCapabilities));
-    return result;
+    napi_property_descriptor properties[] = {
+        JsProperty(env, "deviceId", CreateJsString(env, castRemoteDevice.deviceId)),
+        JsProperty(env, "deviceName", CreateJsString(env, castRemoteDevice.deviceName)),
+        JsProperty(env, "deviceType", CreateJsInt32(env, static_cast<int32_t>(castRemoteDevice.deviceType))),
+        JsProperty(env, "subDeviceType", CreateJsInt32(env, static_cast<int32_t>(castRemoteDevice.subDeviceType))),
+        JsProperty(env, "ipAddress", CreateJsString(env, castRemoteDevice.ipAddress)),
+        JsProperty(env, "channelType", CreateJsInt32(env, static_cast<int32_t>(castRemoteDevice.channelType))),
+        JsProperty(env, "networkId", CreateJsString(env, castRemoteDevice.networkId)),
+        JsProperty(env, "isLegacy", CreateJsBool(env, castRemoteDevice.isLegacy)),
+        JsProperty(env, "mediumTypes", CreateJsInt32(env, static_cast<int32_t>(castRemoteDevice.mediumTypes))),
+        JsProperty(env, "protocolCapabilities",
+            CreateJsInt32(env, static_cast<int32_t>(castRemoteDevice.protocolCapabilities))),
+    };
+    return CreateJsObject(env, properties);
 }
 
 string JsObjectToString(napi_env env, napi_value &object, const char *fieldStr)
 {
-    string fieldRef {};
-    if (object == nullptr) {
-        CLOGE("args is nullptr");
-        return fieldRef;
-    }
     napi_value field = nullptr;
-    bool hasProperty = false;
-
-    napi_status status = napi_has_named_property(env, object, fieldStr, &hasProperty);
-    if (status == napi_ok && hasProperty) {
-        status = napi_get_named_property(env, object, fieldStr, &field);
-        if (status != napi_ok) {
-            CLOGE("napi_get_named_property failed.");
-            return fieldRef;
-        }
-        fieldRef = ParseString(env, field);
-        return fieldRef;
-    } else {
-        CLOGE("Js obj to str no property: %{public}s", fieldStr);
+    if (!GetJsField(env, object, fieldStr, napi_string, field)) {
+        return "";
     }
-    return fieldRef;
+    return ParseString(env, field);
 }
 
 int32_t JsObjectToInt32(napi_env env, napi_value &object, const char *fieldStr)
 {
     int32_t fieldRef = 0;
-    if (object == nullptr) {
-        CLOGE("args is nullptr");
+    napi_value field = nullptr;
+    if (!GetJsField(env, object, fieldStr, napi_number, field)) {
         return fieldRef;
     }
-    bool hasProperty = false;
-    napi_status status = napi_has_named_property(env, object, fieldStr, &hasProperty);
-    if (status == napi_ok && hasProperty) {
-        napi_value field;
-        napi_valuetype valueType;
-        status = napi_get_named_property(env, object, fieldStr, &field);
-        if (status != napi_ok) {
-            CLOGE("napi_get_named_property failed.");
-            return fieldRef;
-        }
-        status = napi_typeof(env, field, &valueType);
-        if (status != napi_ok || valueType != napi_number) {
-            CLOGE("Wrong argument type. Number expected.");
-            return fieldRef;
-        }
-        status = napi_get_value_int32(env, field, &fieldRef);
-        if (status != napi_ok) {
-            CLOGE("napi_get_value_int32 failed");
-            return fieldRef;
-        }
-        return fieldRef;
-    } else {
-        CLOGE("Js to int32_t no property: %{public}s", fieldStr);
+    if (napi_get_value_int32(env, field, &fieldRef) != napi_ok) {
+        CLOGE("napi_get_value_int32 failed");
     }
     return fieldRef;
 }
@@ -543,33 +588,12 @@ int32_t JsObjectToInt32(napi_env env, napi_value &object, const char *fieldStr)
 bool JsObjectToBool(napi_env env, napi_value &object, const char *fieldStr)
 {
     bool fieldRef = false;
-    if (object == nullptr) {
-        CLOGE("args is nullptr");
+    napi_value field = nullptr;
+    if (!GetJsField(env, object, fieldStr, napi_boolean, field)) {
         return fieldRef;
     }
-    bool hasProperty = false;
-    napi_status status = napi_has_named_property(env, object, fieldStr, &hasProperty);
-    if (status == napi_ok && hasProperty) {
-        napi_value field;
-        napi_valuetype valueType;
-        status = napi_get_named_property(env, object, fieldStr, &field);
-        if (status != napi_ok) {
-            CLOGE("napi_get_named_property failed.");
-            return fieldRef;
-        }
-        status = napi_typeof(env, field, &valueType);
-        if (status != napi_ok || valueType != napi_boolean) {
-            CLOGE("Wrong argument type. Bool expected.");
-            return fieldRef;
-        }
-        status = napi_get_value_bool(env, field, &fieldRef);
-        if (status != napi_ok) {
-            CLOGE("napi_get_value_bool failed");
-            return fieldRef;
-        }
-        return fieldRef;
-    } else {
-        CLOGE("Js to bool no property: %{public}s", fieldStr);
+    if (napi_get_value_bool(env, field, &fieldRef) != napi_ok) {
+        CLOGE("napi_get_value_bool failed");
     }
     return fieldRef;
 }
@@ -577,33 +601,12 @@ bool JsObjectToBool(napi_env env, napi_value &object, const char *fieldStr)
 uint32_t JsObjectToUint32(napi_env env, napi_value &object, const char *fieldStr)
 {
     uint32_t fieldRef = 0;
-    if (object == nullptr) {
-        CLOGE("args is nullptr");
+    napi_value field = nullptr;
+    if (!GetJsField(env, object, fieldStr, napi_number, field)) {
         return fieldRef;
     }
-    bool hasProperty = false;
-    napi_status status = napi_has_named_property(env, object, fieldStr, &hasProperty);
-    if (status == napi_ok && hasProperty) {
-        napi_value field;
-        napi_valuetype valueType;
-        status = napi_get_named_property(env, object, fieldStr, &field);
-        if (status != napi_ok) {
-            CLOGE("napi_get_named_property failed.");
-            return fieldRef;
-        }
-        status = napi_typeof(env, field, &valueType);
-        if (status != napi_ok || valueType != napi_number) {
-            CLOGE("Wrong argument type. Number expected.");
-            return fieldRef;
-        }
-        status = napi_get_value_uint32(env, field, &fieldRef);
-        if (status != napi_ok) {
-            CLOGE("napi_get_value_uint32 failed");
-            return fieldRef;
-        }
-        return fieldRef;
-    } else {
-        CLOGE("Js to uint32_t no property: %{public}s", fieldStr);
+    if (napi_get_value_uint32(env, field, &fieldRef) != napi_ok) {
+        CLOGE("napi_get_value_uint32 failed");
     }
     return fieldRef;
 }
@@ -611,33 +614,12 @@ uint32_t JsObjectToUint32(napi_env env, napi_value &object, const char *fieldStr
 double JsObjectToDouble(napi_env env, napi_value &object, const char *fieldStr)
 {
     double fieldRef = 0;
-    if (object == nullptr) {
-        CLOGE("args is nullptr");
+    napi_value field = nullptr;
+    if (!GetJsField(env, object, fieldStr, napi_number, field)) {
         return fieldRef;
     }
-    bool hasProperty = false;
-    napi_status status = napi_has_named_property(env, object, fieldStr, &hasProperty);
-    if (status == napi_ok && hasProperty) {
-        napi_value field;
-        napi_valuetype valueType;
-        status = napi_get_named_property(env, object, fieldStr, &field);
-        if (status != napi_ok) {
-            CLOGE("napi_get_named_property failed.");
-            return fieldRef;
-        }
-        status = napi_typeof(env, field, &valueType);
-        if (status != napi_ok || valueType != napi_number) {
-            CLOGE("Wrong argument type. Number expected.");
-            return fieldRef;
-        }
-        status = napi_get_value_double(env, field, &fieldRef);
-        if (status != napi_ok) {
-            CLOGE("napi_get_value_double failed");
-            return fieldRef;
-        }
-        return fieldRef;
-    } else {
-        CLOGE("Js to double no property: %{public}s", fieldStr);
+    if (napi_get_value_double(env, field, &fieldRef) != napi_ok) {
+        CLOGE("napi_get_value_double failed");
     }
     return fieldRef;
 }
@@ -645,33 +627,12 @@ double JsObjectToDouble(napi_env env, napi_value &object, const char *fieldStr)
 int64_t JsObjectToInt64(napi_env env, napi_value &object, const char *fieldStr)
 {
     int64_t fieldRef = 0;
-    if (object == nullptr) {
-        CLOGE("args is nullptr");
+    napi_value field = nullptr;
+    if (!GetJsField(env, object, fieldStr, napi_number, field)) {
         return fieldRef;
     }
-    bool hasProperty = false;
-    napi_status status = napi_has_named_property(env, object, fieldStr, &hasProperty);
-    if (status == napi_ok && hasProperty) {
-        napi_value field;
-        napi_valuetype valueType;
-        status = napi_get_named_property(env, object, fieldStr, &field);
-        if (status != napi_ok) {
-            CLOGE("napi_get_named_property failed");
-            return fieldRef;
-        }
-        status = napi_typeof(env, field, &valueType);
-        if (status != napi_ok || valueType != napi_number) {
-            CLOGE("Wrong argument type. Number expected.");
-            return fieldRef;
-        }
-        status = napi_get_value_int64(env, field, &fieldRef);
-        if (status != napi_ok) {
-            CLOGE("napi_get_value_int64 failed");
-            return fieldRef;
-        }
-        return fieldRef;
-    } else {
-        CLOGE("Js to int64_t no property: %{public}s", fieldStr);
+    if (napi_get_value_int64(env, field, &fieldRef) != napi_ok) {
+        CLOGE("napi_get_value_int64 failed");
     }
     return fieldRef;
 }
@@ -679,66 +640,51 @@ int64_t JsObjectToInt64(napi_env env, napi_value &object, const char *fieldStr)
 napi_value ConvertMediaInfoToJS(napi_env env, const MediaInfo &mediaInfo)
 {
     CLOGD("ConvertMediaInfoToJS start");
-    napi_value result = nullptr;
-    napi_value value = nullptr;
-    NAPI_CALL(env, napi_create_object(env, &result));
-    NAPI_CALL(env, napi_create_string_utf8(env, mediaInfo.mediaId.c_str(), NAPI_AUTO_LENGTH, &value));
-    NAPI_CALL(env, napi_set_named_property(env, result, "mediaId", value));
-    NAPI_CALL(env, napi_create_string_utf8(env, mediaInfo.mediaName.c_str(), NAPI_AUTO_LENGTH, &value));
-    NAPI_CALL(env, napi_set_named_property(env, result, "mediaName", value));
-    NAPI_CALL(env, napi_create_string_utf8(env, mediaInfo.mediaUrl.c_str(), NAPI_AUTO_LENGTH, &value));
-    NAPI_CALL(env, napi_set_named_property(env, result, "mediaUrl", value));
-    NAPI_CALL(env, napi_create_string_utf8(env, mediaInfo.mediaType.c_str(), NAPI_AUTO_LENGTH, &value));
-    NAPI_CALL(env, napi_set_named_property(env, result, "mediaType", value));
-    NAPI_CALL(env, napi_create_string_utf8(env, mediaInfo.albumCoverUrl.c_str(), NAPI_AUTO_LENGTH, &value));
-    NAPI_CALL(env, napi_set_named_property(env, result, "albumCoverUrl", value));
-    NAPI_CALL(env, napi_create_string_utf8(env, mediaInfo.albumTitle.c_str(), NAPI_AUTO_LENGTH, &value));
-    NAPI_CALL(env, napi_set_named_property(env, result, "albumTitle", value));
-    NAPI_CALL(env, napi_create_string_utf8(env, mediaInfo.mediaArtist.c_str(), NAPI_AUTO_LENGTH, &value));
-    NAPI_CALL(env, napi_set_named_property(env, result, "mediaArtist", value));
-    NAPI_CALL(env, napi_create_string_utf8(env, mediaInfo.lrcUrl.c_str(), NAPI_AUTO_LENGTH, &value));
-    NAPI_CALL(env, napi_set_named_property(env, result, "lrcUrl", value));
-    NAPI_CALL(env, napi_create_string_utf8(env, mediaInfo.lrcContent.c_str(), NAPI_AUTO_LENGTH, &value));
-    NAPI_CALL(env, napi_set_named_property(env, result, "lrcContent", value));
-    NAPI_CALL(env, napi_create_string_utf8(env, mediaInfo.appIconUrl.c_str(), NAPI_AUTO_LENGTH, &value));
-    NAPI_CALL(env, napi_set_named_property(env, result, "appIconUrl", value));
-    NAPI_CALL(env, napi_create_string_utf8(env, mediaInfo.appName.c_str(), NAPI_AUTO_LENGTH, &value));
-    NAPI_CALL(env, napi_set_named_property(env, result, "appName", value));
-
-    NAPI_CALL(env, napi_create_uint32(env, mediaInfo.mediaSize, &value));
-    NAPI_CALL(env, napi_set_named_property(env, result, "mediaSize", value));
-    NAPI_CALL(env, napi_create_uint32(env, mediaInfo.startPosition, &value));
-    NAPI_CALL(env, napi_set_named_property(env, result, "startPosition", value));
-    NAPI_CALL(env, napi_create_uint32(env, mediaInfo.duration, &value));
-    NAPI_CALL(env, napi_set_named_property(env, result, "duration", value));
-    NAPI_CALL(env, napi_create_uint32(env, mediaInfo.closingCreditsPosition, &value));
-    NAPI_CALL(env, napi_set_named_property(env, result, "closingCreditsPosition", value));
+    napi_property_descriptor properties[] = {
+        JsProperty(env, "mediaId", CreateJsString(env, mediaInfo.mediaId)),
+        JsProperty(env, "mediaName", CreateJsString(env, mediaInfo.mediaName)),
+        JsProperty(env, "mediaUrl", CreateJsString(env, mediaInfo.mediaUrl)),
+        JsProperty(env, "mediaType", CreateJsString(env, mediaInfo.mediaType)),
+        JsProperty(env, "albumCoverUrl", CreateJsString(env, mediaInfo.albumCoverUrl)),
+        JsProperty(env, "albumTitle", CreateJsString(env, mediaInfo.albumTitle)),
+        JsProperty(env, "mediaArtist", CreateJsString(env, mediaInfo.mediaArtist)),
+        JsProperty(env, "lrcUrl", CreateJsString(env, mediaInfo.lrcUrl)),
+        JsProperty(env, "lrcContent", CreateJsString(env, mediaInfo.lrcContent)),
+        JsProperty(env, "appIconUrl", CreateJsString(env, mediaInfo.appIconUrl)),
+        JsProperty(env, "appName", CreateJsString(env, mediaInfo.appName)),
+        JsProperty(env, "mediaSize", CreateJsUint32(env, mediaInfo.mediaSize)),
+        JsProperty(env, "startPosition", CreateJsUint32(env, mediaInfo.startPosition)),
+        JsProperty(env, "duration", CreateJsUint32(env, mediaInfo.duration)),
+        JsProperty(env, "closingCreditsPosition", CreateJsUint32(env, mediaInfo.closingCreditsPosition)),
+    };
+    napi_value result = CreateJsObject(env, properties);
     CLOGD("ConvertMediaInfoToJS end");
-
     return result;
 }
 
 napi_value ConvertMediaInfoHolderToJS(napi_env env, const MediaInfoHolder &mediaInfoHolder)
 {
     CLOGD("ConvertMediaInfoHolderToJS start");
-    napi_value result = nullptr;
-    napi_value value = nullptr;
     size_t len = mediaInfoHolder.mediaInfoList.size();
     if (len == 0) {
         CLOGE("mediaInfoList len is invalid");
-        return result;
+        return nullptr;
     }
-    NAPI_CALL(env, napi_create_object(env, &result));
-    NAPI_CALL(env, napi_create_uint32(env, mediaInfoHolder.currentIndex, &value));
-    NAPI_CALL(env, napi_set_named_property(env, result, "currentIndex", value));
-    NAPI_CALL(env, napi_create_uint32(env, mediaInfoHolder.progressRefreshInterval, &value));
-    NAPI_CALL(env, napi_set_named_property(env, result, "progressRefreshInterval", value));
-    NAPI_CALL(env, napi_create_array_with_length(env, len, &value));
+    napi_value mediaInfoList = nullptr;
+    NAPI_CALL(env, napi_create_array_with_length(env, len, &mediaInfoList));
     for (size_t i = 0; i < len; i++) {
         napi_value mediaInfo = ConvertMediaInfoToJS(env, mediaInfoHolder.mediaInfoList[i]);
-        NAPI_CALL(env, napi_set_element(env, value, i, mediaInfo));
-    }
-    NAPI_CALL(env, napi_set_named_property(env, result, "mediaInfoList", value));
+        if (mediaInfo == nullptr) {
+            return nullptr;
+        }
+        NAPI_CALL(env, napi_set_element(env, mediaInfoList, i, mediaInfo));
+    }
+    napi_property_descriptor properties[] = {
+        JsProperty(env, "currentIndex", CreateJsUint32(env, mediaInfoHolder.currentIndex)),
+        JsProperty(env, "progressRefreshInterval", CreateJsUint32(env, mediaInfoHolder.progressRefreshInterval)),
+        JsProperty(env, "mediaInfoList", mediaInfoList),
+    };
+    napi_value result = CreateJsObject(env, properties);
     CLOGD("ConvertMediaInfoHolderToJS end");
     return result;
 }
@@ -35,14 +35,14 @@ NapiStreamPlayerListener::~NapiStreamPlayerListener()
     CLOGD("destrcutor in");
 }
 
-void NapiStreamPlayerListener::HandleEvent(int32_t event, NapiArgsGetter &getter)
+void NapiStreamPlayerListener::HandleEvent(int32_t event, NapiArgsGetter &getter, bool isLatestOnly)
 {
     std::lock_guard<std::mutex> lockGuard(lock_);
     if (!callback_) {
         CLOGE("callback_ is nullptr, event:%{public}d", event);
         return;
     }
-    callback_->HandleEvent(event, getter);
+    callback_->HandleEvent(event, getter, isLatestOnly);
 }
 
 void NapiStreamPlayerListener::OnStateChanged(const PlayerStates playbackState, bool isPlayWhenReady)
@@ -77,7 +77,8 @@ void NapiStreamPlayerListener::OnPositionChanged(int position, int bufferPositio
         status = napi_create_bigint_uint64(env, timestamp, &argv[3]);
         CHECK_RETURN_VOID(status == napi_ok, "napi_create_bigint_uint64 failed");
     };
-    HandleEvent(EVENT_POSITION_CHANGED, napiArgsGetter);
+    // Only the newest position matters, older ones still waiting for the JS thread are replaced.
+    HandleEvent(EVENT_POSITION_CHANGED, napiArgsGetter, true);
     CLOGD("OnPositionChanged finish");
 }
 
@@ -100,7 +101,7 @@ void NapiStreamPlayerListener::OnVolumeChanged(int volume, int maxVolume)
         auto status = napi_create_int32(env, volume, &argv[0]);
         CHECK_RETURN_VOID(status == napi_ok, "napi_create_int32 failed");
     };
-    HandleEvent(EVENT_VOLUME_CHANGED, napiArgsGetter);
+    HandleEvent(EVENT_VOLUME_CHANGED, napiArgsGetter, true);
     CLOGD("OnVolumeChanged finish");
 }
 
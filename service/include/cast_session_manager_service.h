@@ -46,6 +46,10 @@ public:
     void OnStart() override;
     void OnStop() override;
     void OnActive(const SystemAbilityOnDemandReason& activeReason) override;
+    int32_t OnIdle(const SystemAbilityOnDemandReason& idleReason) override;
+    void OnAddSystemAbility(int32_t systemAbilityId, const std::string &deviceId) override;
+    void OnRemoveSystemAbility(int32_t systemAbilityId, const std::string &deviceId) override;
+    int Dump(int fd, const std::vector<std::u16string> &args) override;
 
     int32_t RegisterListener(sptr<ICastServiceListenerImpl> listener) override;
     int32_t UnregisterListener() override;
@@ -87,7 +91,7 @@ private:
         uid_t uid_;
     };
 
-    bool CheckAndWaitDevieManagerServiceInit();
+    std::string DumpMetrics();
 
     pid_t myPid_;
     std::shared_mutex mutex_;
@@ -104,6 +108,9 @@ private:
     void RemoveClientDeathRecipientLocked(pid_t pid, sptr<ICastServiceListenerImpl> listener);
     bool AddListenerLocked(sptr<ICastServiceListenerImpl> listener);
     int32_t ReleaseLocked();
+    void UnloadIfIdle();
+    void InitManagersLocked();
+    void DeinitManagersLocked();
     int32_t RemoveListenerLocked(pid_t pid);
     void ClearListenersLocked();
     bool HasListenerLocked();
@@ -0,0 +1,75 @@
+/*
+ * Copyright (C) 2023-2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * Description: warm standby and idle unload policy of the cast service.
+ * Author: zhangge
+ * Create: 2023-06-05
+ */
+
+#ifndef SERVICE_LIFECYCLE_H
+#define SERVICE_LIFECYCLE_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+
+namespace OHOS {
+namespace CastEngine {
+namespace CastEngineService {
+inline constexpr char CAST_IDLE_TIMEOUT_PARAM[] = "persist.cast.idle.timeout_ms";
+
+/*
+ * Keeps the SA loaded for a while after its last client has gone instead of unloading it at once. The time clients
+ * take to come back is smoothed into an average, and the idle timeout is twice that average, bounded by
+ * MIN_IDLE_TIMEOUT_MS and the CAST_IDLE_TIMEOUT_PARAM system parameter. A client arriving before the timeout
+ * cancels the countdown, and the first client after a load counts as a cold start, any later one as a warm start.
+ */
+class ServiceLifecycle {
+public:
+    static ServiceLifecycle &GetInstance();
+
+    void OnClientArrived();
+    // Starts the idle countdown, onIdle runs on a worker thread unless a client arrives before it expires.
+    void OnClientsGone(std::function<void()> onIdle);
+    // True right after an on demand load, or while idle if clients have been coming back before the timeout,
+    // in which case discovery is worth keeping or bringing up ahead of the request.
+    bool IsClientExpected();
+    int GetIdleTimeoutMs();
+
+private:
+    ServiceLifecycle() = default;
+    ~ServiceLifecycle() = default;
+
+    static constexpr int MIN_IDLE_TIMEOUT_MS = 5000;
+    static constexpr int DEFAULT_IDLE_TIMEOUT_MS = 60000;
+    static constexpr int GAP_TIMEOUT_FACTOR = 2;
+    static constexpr int64_t GAP_GAIN_SHIFT = 2;
+
+    int GetIdleTimeoutMsLocked();
+
+    std::mutex mutex_;
+    std::condition_variable cond_;
+    uint64_t generation_{ 0 };
+    bool hasServedClient_{ false };
+    bool isIdle_{ false };
+    bool hasGapSample_{ false };
+    int64_t gapAvgMs_{ 0 };
+    std::chrono::steady_clock::time_point idleSince_;
+};
+} // namespace CastEngineService
+} // namespace CastEngine
+} // namespace OHOS
+
+#endif // SERVICE_LIFECYCLE_H
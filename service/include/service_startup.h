@@ -0,0 +1,79 @@
+/*
+ * Copyright (C) 2023-2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * Description: staged service startup with per stage readiness.
+ * Author: zhangge
+ * Create: 2023-06-05
+ */
+
+#ifndef SERVICE_STARTUP_H
+#define SERVICE_STARTUP_H
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <future>
+#include <mutex>
+
+namespace OHOS {
+namespace CastEngine {
+namespace CastEngineService {
+enum class StartupStage : uint8_t {
+    SOFTBUS_SERVER,
+    DEVICE_MANAGER,
+    DISCOVERY,
+    STAGE_MAX,
+};
+
+/*
+ * The service is published at once and its dependencies come up on their own, each stage settling a shared future.
+ * A request that needs a stage waits on it with a bounded timeout instead of the whole OnStart blocking, and the
+ * time each stage took from OnStart is logged and folded into the "service.startup.*" histograms.
+ */
+class ServiceStartup {
+public:
+    static ServiceStartup &GetInstance();
+
+    void Begin();
+    // Settles the stage, later calls are ignored until the stage is reset.
+    void MarkReady(StartupStage stage, bool isReady);
+    // Makes the stage pending again, e.g. when the subsystem is torn down or its dependency went away.
+    void Reset(StartupStage stage);
+    bool IsReady(StartupStage stage);
+    // Returns false if the stage failed or did not settle within timeoutMs.
+    bool WaitReady(StartupStage stage, int timeoutMs);
+
+private:
+    ServiceStartup();
+    ~ServiceStartup() = default;
+
+    static constexpr size_t STAGE_COUNT = static_cast<size_t>(StartupStage::STAGE_MAX);
+
+    struct Stage {
+        std::promise<bool> promise;
+        std::shared_future<bool> future;
+        bool isSettled{ false };
+        bool isRecorded{ false };
+    };
+
+    void RenewLocked(Stage &stage);
+
+    std::mutex mutex_;
+    std::chrono::steady_clock::time_point start_;
+    std::array<Stage, STAGE_COUNT> stages_;
+};
+} // namespace CastEngineService
+} // namespace CastEngine
+} // namespace OHOS
+
+#endif // SERVICE_STARTUP_H
@@ -20,6 +20,7 @@
 
 #include <algorithm>
 #include <atomic>
+#include <thread>
 
 #include <ipc_skeleton.h>
 #include "if_system_ability_manager.h"
@@ -30,6 +31,7 @@
 #include "cast_engine_dfx.h"
 #include "cast_engine_errors.h"
 #include "cast_engine_log.h"
+#include "cast_engine_metrics.h"
 #include "cast_session_impl.h"
 #include "cast_session_impl_class.h"
 #include "connection_manager.h"
@@ -37,6 +39,8 @@
 #include "softbus_error_code.h"
 #include "hisysevent.h"
 #include "permission.h"
+#include "service_lifecycle.h"
+#include "service_startup.h"
 #include "utils.h"
 #include "bundle_mgr_client.h"
 
@@ -97,54 +101,44 @@ ISessionListener g_SessionListener = {
     OnSessionOpened, OnSessionClosed, OnBytesReceived, nullptr, nullptr, nullptr
 };
 
-// true: softbus service is up, and the session server has been created;
-// false: softbus service is up, but the session server failed to create;
-// nullopt: softbus service is down.
-std::optional<bool> WaitSoftBusInit()
-{
-    constexpr int sleepTime = 50; // uint: ms
-    constexpr int retryTimes = 60 * 20; // total 60s
-    int ret = SoftBusErrNo::SOFTBUS_TRANS_SESSION_ADDPKG_FAILED;
-    int retryTime = 0;
-    while (ret == SoftBusErrNo::SOFTBUS_TRANS_SESSION_ADDPKG_FAILED && retryTime < retryTimes) {
-        CLOGI("create session server");
+// Runs on the startup worker. SOFTBUS_TRANS_SESSION_ADDPKG_FAILED means the softbus service is not up yet, any other
+// error is a transient failure of an up service, both are retried with an exponential backoff for up to 60s.
+bool SetupSessionServer()
+{
+    constexpr int initialBackoffMs = 50;
+    constexpr int maxBackoffMs = 1000;
+    constexpr auto timeout = std::chrono::seconds(60);
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    int backoffMs = initialBackoffMs;
+    int ret = SoftBusErrNo::SOFTBUS_ERR;
+    while (true) {
         ret = CreateSessionServer(PKG_NAME, SessionServer::SESSION_NAME, &SessionServer::g_SessionListener);
         if (ret == SOFTBUS_OK) {
             return true;
         }
-        retryTime++;
-        std::this_thread::sleep_for(std::chrono::milliseconds(sleepTime));
+        if (std::chrono::steady_clock::now() + std::chrono::milliseconds(backoffMs) >= deadline) {
+            break;
+        }
+        CLOGD("create session server ret:%{public}d, retry in %{public}d ms", ret, backoffMs);
+        std::this_thread::sleep_for(std::chrono::milliseconds(backoffMs));
+        backoffMs = std::min(backoffMs * 2, maxBackoffMs);
     }
 
-    if (retryTime == retryTimes) {
+    if (ret == SoftBusErrNo::SOFTBUS_TRANS_SESSION_ADDPKG_FAILED) {
         CLOGE("softbus service is down.");
-        return std::nullopt;
+    } else {
+        CLOGE("CreateSessionServer failed, ret:%{public}d", ret);
     }
-
     return false;
 }
-
-bool SetupSessionServer()
-{
-    int32_t result = SoftBusErrNo::SOFTBUS_ERR;
-    int32_t retryTime = 0;
-    constexpr int32_t retryTimes = 20;
-    while (result != SessionServer::SOFTBUS_OK && retryTime < retryTimes) {
-        CLOGI("retry create session server");
-        result = CreateSessionServer(PKG_NAME, SessionServer::SESSION_NAME, &SessionServer::g_SessionListener);
-        retryTime++;
-    }
-    if (result != SessionServer::SOFTBUS_OK) {
-        CLOGE("CreateSessionServer failed, ret:%d", result);
-        return false;
-    }
-
-    return true;
-}
 }
 
 namespace {
 constexpr int DEVICE_MANAGER_SA_ID = 4802;
+constexpr int DEVICE_MANAGER_WAIT_MS = 10000;
+constexpr int SOFTBUS_SERVER_WAIT_MS = 5000;
+constexpr int DISCOVERY_WAIT_MS = 1000;
+constexpr int32_t UNLOAD_REJECTED = -1;
 } // namespace
 
 CastSessionManagerService::CastSessionManagerService(int32_t saId, bool runOnCreate) : SystemAbility(saId, runOnCreate)
@@ -166,24 +160,47 @@ void CastSessionManagerService::OnStart()
         return;
     }
 
+    CastEngineMetrics::GetInstance().RegisterDefaultMetrics();
+    ServiceStartup::GetInstance().Begin();
     AddSystemAbilityListener(CAST_ENGINE_SA_ID);
-    auto result = SessionServer::WaitSoftBusInit();
-    if (result == std::nullopt) {
-        CastEngineDfx::WriteErrorEvent(SOURCE_CREATE_SESSION_SERVER_FAIL);
-        CLOGE("softbus service is down.");
+    // The device manager stage settles in OnAddSystemAbility, at once if the SA is already up.
+    AddSystemAbilityListener(DEVICE_MANAGER_SA_ID);
+
+    wptr<CastSessionManagerService> weakService(this);
+    std::thread([weakService]() {
+        bool isReady = SessionServer::SetupSessionServer();
+        if (!isReady) {
+            CastEngineDfx::WriteErrorEvent(SOURCE_CREATE_SESSION_SERVER_FAIL);
+        }
+        auto service = weakService.promote();
+        if (service != nullptr) {
+            service->hasServer_ = isReady;
+        }
+        ServiceStartup::GetInstance().MarkReady(StartupStage::SOFTBUS_SERVER, isReady);
+    }).detach();
+}
+
+void CastSessionManagerService::OnAddSystemAbility(int32_t systemAbilityId, const std::string &deviceId)
+{
+    CLOGI("OnAddSystemAbility in, systemAbilityId:%{public}d", systemAbilityId);
+    if (systemAbilityId != DEVICE_MANAGER_SA_ID) {
         return;
     }
+    ServiceStartup::GetInstance().MarkReady(StartupStage::DEVICE_MANAGER, true);
 
-    if (result) {
-        hasServer_ = true;
-        return;
+    // An on demand load is followed by a client registering, so bring discovery up ahead of it.
+    SharedWLock lock(mutex_);
+    if (!HasListenerLocked() && ServiceLifecycle::GetInstance().IsClientExpected()) {
+        InitManagersLocked();
     }
+}
 
-    if (!SessionServer::SetupSessionServer()) {
-        CastEngineDfx::WriteErrorEvent(SOURCE_CREATE_SESSION_SERVER_FAIL);
-        return;
+void CastSessionManagerService::OnRemoveSystemAbility(int32_t systemAbilityId, const std::string &deviceId)
+{
+    CLOGI("OnRemoveSystemAbility in, systemAbilityId:%{public}d", systemAbilityId);
+    if (systemAbilityId == DEVICE_MANAGER_SA_ID) {
+        ServiceStartup::GetInstance().Reset(StartupStage::DEVICE_MANAGER);
     }
-    hasServer_ = true;
 }
 
 void CastSessionManagerService::OnStop()
@@ -198,6 +215,43 @@ void CastSessionManagerService::OnActive(const SystemAbilityOnDemandReason& acti
     isUnloading_.store(false);
 }
 
+int32_t CastSessionManagerService::OnIdle(const SystemAbilityOnDemandReason& idleReason)
+{
+    CLOGI("OnIdle in, reasonValue:%{public}s", idleReason.GetValue().c_str());
+    SharedRLock lock(mutex_);
+    if (HasListenerLocked()) {
+        CLOGI("client arrived during unload, stay loaded");
+        isUnloading_.store(false);
+        return UNLOAD_REJECTED;
+    }
+    return ERR_OK;
+}
+
+int CastSessionManagerService::Dump(int fd, const std::vector<std::u16string> &args)
+{
+    CLOGI("Dump in");
+    if (fd < 0) {
+        return ERR_INVALID_VALUE;
+    }
+
+    std::string metrics = DumpMetrics();
+    if (dprintf(fd, "%s\n", metrics.c_str()) < 0) {
+        CLOGE("Dump metrics failed");
+        return ERR_INVALID_VALUE;
+    }
+    return ERR_OK;
+}
+
+std::string CastSessionManagerService::DumpMetrics()
+{
+    {
+        SharedRLock lock(mutex_);
+        static auto &activeSessions = CastEngineMetrics::GetInstance().RegisterGauge(METRIC_SERVICE_ACTIVE_SESSIONS);
+        activeSessions.Set(static_cast<int64_t>(sessionMap_.size()));
+    }
+    return CastEngineDfx::DumpMetrics();
+}
+
 namespace {
 using namespace OHOS::DistributedHardware;
 constexpr int AV_SESSION_UID = 6700;
@@ -378,26 +432,37 @@ int32_t CastSessionManagerService::RegisterListener(sptr<ICastServiceListenerImp
     HiSysEventWrite(CAST_ENGINE_DFX_DOMAIN_NAME, "CAST_ENGINE_EVE", HiviewDFX::HiSysEvent::EventType::STATISTIC,
         "SEQUENTIAL_ID", CastEngineDfx::GetSequentialId(), "BIZ_PACKAGE_NAME", CastEngineDfx::GetBizPackageName());
 
+    // Wait outside the lock, so that a registration queued behind the device manager does not block other requests.
+    bool isDeviceManagerReady =
+        ServiceStartup::GetInstance().WaitReady(StartupStage::DEVICE_MANAGER, DEVICE_MANAGER_WAIT_MS);
     SharedWLock lock(mutex_);
     if (listener == nullptr) {
         CLOGE("RegisterListener failed, listener is null");
         return CAST_ENGINE_ERROR;
     }
 
+    if (isUnloading_.exchange(false)) {
+        static auto &unloadCancelled =
+            CastEngineMetrics::GetInstance().RegisterCounter(METRIC_SERVICE_UNLOAD_CANCELLED);
+        unloadCancelled.Add();
+        CLOGI("cancel the unload in progress");
+        CancelIdle();
+    }
+
     bool needInitMore = !HasListenerLocked();
     if (!AddListenerLocked(listener)) {
         return CAST_ENGINE_ERROR;
     }
 
     if (needInitMore) {
-        if (!CheckAndWaitDevieManagerServiceInit()) {
+        ServiceLifecycle::GetInstance().OnClientArrived();
+        if (!isDeviceManagerReady) {
             CLOGE("Wait DM SA load timeout");
             ReleaseLocked();
             return CAST_ENGINE_ERROR;
         }
 
-        DiscoveryManager::GetInstance().Init(std::make_shared<DiscoveryManagerListener>(this));
-        ConnectionManager::GetInstance().Init(std::make_shared<ConnectionManagerListener>(this));
+        InitManagersLocked();
         sessionMap_.clear();
     }
 
@@ -432,21 +497,62 @@ int32_t CastSessionManagerService::ReleaseLocked()
     ReportServiceDieLocked();
 
     ClearListenersLocked();
-    DiscoveryManager::GetInstance().Deinit();
-    ConnectionManager::GetInstance().Deinit();
     sessionMap_.clear();
+
+    // Stay loaded until the idle timeout, keeping discovery initialized if a client is likely back before it.
+    wptr<CastSessionManagerService> weakService(this);
+    ServiceLifecycle::GetInstance().OnClientsGone([weakService]() {
+        auto service = weakService.promote();
+        if (service != nullptr) {
+            service->UnloadIfIdle();
+        }
+    });
+    if (ServiceLifecycle::GetInstance().IsClientExpected()) {
+        DiscoveryManager::GetInstance().StopDiscovery();
+    } else {
+        DeinitManagersLocked();
+    }
+    CLOGI("Release success done");
+    return CAST_ENGINE_SUCCESS;
+}
+
+void CastSessionManagerService::UnloadIfIdle()
+{
+    SharedWLock lock(mutex_);
+    if (HasListenerLocked()) {
+        return;
+    }
+    DeinitManagersLocked();
     auto samgr = SystemAbilityManagerClient::GetInstance().GetSystemAbilityManager();
     if (samgr == nullptr) {
         CLOGE("get samgr failed");
-        return CAST_ENGINE_ERROR;
+        return;
     }
+    isUnloading_.store(true);
     int32_t ret = samgr->UnloadSystemAbility(CAST_ENGINE_SA_ID);
     if (ret != ERR_OK) {
+        isUnloading_.store(false);
         CLOGE("remove system ability failed");
-        return CAST_ENGINE_ERROR;
+        return;
     }
-    CLOGI("Release success done");
-    return CAST_ENGINE_SUCCESS;
+    CLOGI("Unload idle service");
+}
+
+void CastSessionManagerService::InitManagersLocked()
+{
+    if (ServiceStartup::GetInstance().IsReady(StartupStage::DISCOVERY)) {
+        return;
+    }
+    DiscoveryManager::GetInstance().Init(std::make_shared<DiscoveryManagerListener>(this));
+    ConnectionManager::GetInstance().Init(std::make_shared<ConnectionManagerListener>(this));
+    ServiceStartup::GetInstance().MarkReady(StartupStage::DISCOVERY, true);
+}
+
+void CastSessionManagerService::DeinitManagersLocked()
+{
+    ServiceStartup::GetInstance().Reset(StartupStage::DISCOVERY);
+    DiscoveryManager::GetInstance().Deinit();
+    ConnectionManager::GetInstance().Deinit();
 }
 
 int32_t CastSessionManagerService::SetLocalDevice(const CastLocalDevice &localDevice)
@@ -489,6 +595,10 @@ sptr<ICastSessionImpl> CastSessionManagerService::GetCastSessionInner(std::strin
 int32_t CastSessionManagerService::CreateCastSession(const CastSessionProperty &property,
     sptr<ICastSessionImpl> &castSession)
 {
+    if (!ServiceStartup::GetInstance().WaitReady(StartupStage::SOFTBUS_SERVER, SOFTBUS_SERVER_WAIT_MS)) {
+        CLOGE("session server is not ready");
+        return ERR_SERVICE_STATE_NOT_MATCH;
+    }
     SharedWLock lock(mutex_);
     CLOGI("CreateCastSession in, protocol:%{public}d, endType:%{public}d.", property.protocolType, property.endType);
     if (serviceStatus_ != ServiceStatus::CONNECTED) {
@@ -561,6 +671,10 @@ int32_t CastSessionManagerService::SetSinkSessionCapacity(int sessionCapacity)
 int32_t CastSessionManagerService::StartDiscovery(int protocols, std::vector<std::string> drmSchemes)
 {
     CLOGI("StartDiscovery in, protocolType = %{public}d, drm shcheme size = %{public}zu", protocols, drmSchemes.size());
+    if (!ServiceStartup::GetInstance().WaitReady(StartupStage::DISCOVERY, DISCOVERY_WAIT_MS)) {
+        CLOGE("discovery is not ready");
+        return ERR_SERVICE_STATE_NOT_MATCH;
+    }
 
     DiscoveryManager::GetInstance().StartDiscovery(protocols, drmSchemes);
     return CAST_ENGINE_SUCCESS;
@@ -586,12 +700,19 @@ int32_t CastSessionManagerService::StartDeviceLogging(int32_t fd, uint32_t maxSi
         }
         return static_cast<int32_t>(LogCodeId::UID_MISMATCH);
     }
-    if (fd >= 0) {
-        close(fd);
+    if (fd < 0) {
+        return CAST_ENGINE_ERROR;
     }
 
-    // 待实现 DfxCastEngineStartDeviceLogging
-    return CAST_ENGINE_ERROR;
+    std::string metrics = DumpMetrics();
+    size_t length = std::min<size_t>(metrics.size(), maxSize);
+    ssize_t written = write(fd, metrics.c_str(), length);
+    close(fd);
+    if (written < 0 || static_cast<size_t>(written) != length) {
+        CLOGE("Write device logging failed");
+        return CAST_ENGINE_ERROR;
+    }
+    return CAST_ENGINE_SUCCESS;
 }
 
 int32_t CastSessionManagerService::SetDiscoverable(bool enable)
@@ -805,26 +926,6 @@ bool CastSessionManagerService::LoadSinkSA(const std::string &networkId)
     }
 }
 
-bool CastSessionManagerService::CheckAndWaitDevieManagerServiceInit()
-{
-    auto samgr = SystemAbilityManagerClient::GetInstance().GetSystemAbilityManager();
-    if (samgr == nullptr) {
-        CLOGE("get samgr failed");
-        return false;
-    }
-    constexpr int32_t sleepTimeMs = 50;
-    constexpr int32_t retryTimes = 200;
-    int32_t retryTime = 0;
-
-    while (samgr->CheckSystemAbility(DEVICE_MANAGER_SA_ID) == nullptr && (retryTime < retryTimes)) {
-        std::this_thread::sleep_for(std::chrono::milliseconds(sleepTimeMs));
-        retryTime++;
-    }
-    CLOGI("retryTime:%{public}d", retryTime);
-
-    return retryTime < retryTimes;
-}
-
 void CastSessionManagerService::CastEngineClientDeathRecipient::OnRemoteDied(const wptr<IRemoteObject> &object)
 {
     CLOGI("Client died, need release resources, client pid_: %{public}d", pid_);
@@ -0,0 +1,74 @@
+/*
+ * Copyright (C) 2023-2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * Description: per connect timeline of the connection establishment stages.
+ * Author: zhangge
+ * Create: 2023-06-05
+ */
+
+#ifndef CONNECT_TIMELINE_H
+#define CONNECT_TIMELINE_H
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+
+namespace OHOS {
+namespace CastEngine {
+namespace CastEngineService {
+enum class ConnectStage : uint8_t {
+    BIND_TARGET,
+    AUTH_FINISH,
+    QUERY_P2P_IP,
+    CONSULT_SESSION_OPENED,
+    P2P_IP_READY,
+    AUTH_SUCCESS,
+    CONSULT_DATA_SENT,
+    STAGE_MAX,
+};
+
+/*
+ * Records, for every device being connected, when each stage completed relative to ConnectDevice. Stages that are
+ * started concurrently show up with overlapping offsets, and the finished timeline is logged in one line and folded
+ * into the "connect.stage.*" histograms of the metrics dump.
+ */
+class ConnectTimeline {
+public:
+    static ConnectTimeline &GetInstance();
+
+    void Begin(const std::string &deviceId);
+    void Mark(const std::string &deviceId, ConnectStage stage);
+    void Finish(const std::string &deviceId, bool isSuccess);
+
+private:
+    ConnectTimeline() = default;
+    ~ConnectTimeline() = default;
+
+    static constexpr int64_t STAGE_NOT_REACHED = -1;
+
+    struct Timeline {
+        std::chrono::steady_clock::time_point start;
+        std::array<int64_t, static_cast<size_t>(ConnectStage::STAGE_MAX)> stageUs;
+    };
+
+    std::mutex mutex_;
+    std::map<std::string, Timeline> timelines_;
+};
+} // namespace CastEngineService
+} // namespace CastEngine
+} // namespace OHOS
+
+#endif // CONNECT_TIMELINE_H
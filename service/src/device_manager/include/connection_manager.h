@@ -45,6 +45,8 @@ using nlohmann::json;
 
 class CastBindTargetCallback : public BindTargetCallback {
 public:
+    CastBindTargetCallback() = default;
+    explicit CastBindTargetCallback(uint64_t ipQueryGeneration) : ipQueryGeneration_(ipQueryGeneration) {}
     void OnBindResult(const PeerTargetId &targetId, int32_t result, int32_t status, std::string content) override;
 private:
     void HandleBindAction(const CastInnerRemoteDevice &device, int action, const json &authInfo);
@@ -53,6 +55,8 @@ private:
     void HandleQueryIpAction(const CastInnerRemoteDevice &remoteDevice, const json &authInfo);
     static const std::map<int32_t, int32_t> RESULT_REASON_MAP;
     static const std::map<int32_t, int32_t> STATUS_REASON_MAP;
+    // Identifies the p2p ip query this callback was created for, 0 for any other bind action.
+    uint64_t ipQueryGeneration_{ 0 };
 };
 
 class CastUnBindTargetCallback : public UnbindTargetCallback {
@@ -74,6 +78,9 @@ public:
     void GrabDevice();
 
     bool OpenConsultSession(const CastInnerRemoteDevice &device);
+    bool OpenConsultSessionAndQueryIp(const CastInnerRemoteDevice &device);
+    void OnP2PIpReady(const CastInnerRemoteDevice &device);
+    bool FinishIpQuery(const std::string &deviceId, uint64_t generation);
     void OnConsultDataReceived(int transportId, const void *data, unsigned int dataLen);
     bool OnConsultSessionOpened(int transportId, bool isSource);
     void OnConsultDataReceivedFromSink(int transportId, const void *data, unsigned int dataLen);
@@ -126,6 +133,9 @@ private:
     std::string GetAuthVersion(const CastInnerRemoteDevice &device);
 
     bool QueryP2PIp(const CastInnerRemoteDevice &device);
+    bool NeedQueryP2PIp(const CastInnerRemoteDevice &device);
+    bool FinishConnectStep(const std::string &deviceId, bool isP2PIp, bool &isAllDone);
+    void ClearConnectPlan(const std::string &deviceId);
 
     void SendConsultData(const CastInnerRemoteDevice &device, int port);
     std::string GetConsultationData(const CastInnerRemoteDevice &device, int port, json &body);
@@ -169,6 +179,17 @@ private:
 
     // For synchronizing result of openSession between OpenConsultSession and OnOpenSession.
     std::mutex openConsultingSessionMutex_;
+
+    // Steps started concurrently once the peer's networkId is known, AUTH_SUCCESS waits for all of them.
+    struct ConnectPlan {
+        bool isConsultSessionOpened{ false };
+        bool isP2PIpReady{ false };
+    };
+    std::mutex planMutex_;
+    std::map<std::string, ConnectPlan> connectPlans_;
+    // The p2p ip query in flight per device. Teardown forgets it, so a result that comes back later is dropped.
+    uint64_t ipQueryGeneration_{ 0 };
+    std::map<std::string, uint64_t> ipQueries_;
 };
 
 class CastDeviceStateCallback : public DeviceStateCallback {
@@ -31,6 +31,7 @@
 #include "device_manager.h"
 #include "event_handler.h"
 #include "json.hpp"
+#include "keyed_task_pool.h"
 
 using nlohmann::json;
 
@@ -116,7 +117,8 @@ private:
 
     void GetAndReportTrustedDevices();
 
-    void ParseDeviceInfo(const DmDeviceInfo &dmDevice, CastInnerRemoteDevice &castDevice);
+    void HandleDeviceInfoFound(const DmDeviceInfo &dmDeviceInfo);
+    void ParseDeviceInfo(const DmDeviceInfo &dmDevice, const json &extraData, CastInnerRemoteDevice &castDevice);
     void ParseCustomData(const json &jsonObj, CastInnerRemoteDevice &castDevice);
     void ParseCapability(const std::string customData, CastInnerRemoteDevice &castDevice);
 
@@ -128,9 +130,10 @@ private:
     void RemoveSameDeviceLocked(const CastInnerRemoteDevice &newDevice);
 
     CastInnerRemoteDevice CreateRemoteDevice(const DmDeviceInfo &dmDeviceInfo);
+    CastInnerRemoteDevice CreateRemoteDevice(const DmDeviceInfo &dmDeviceInfo, const json &extraData);
     void UpdateDeviceStateLocked();
     void SetDeviceNotFresh();
-    void RecordDeviceFoundType(const DmDeviceInfo dmDeviceInfo);
+    void RecordDeviceFoundTypeLocked(const std::string &deviceId, const json &extraData);
 
     std::string Mask(const std::string &str);
     bool IsDrmMatch(const CastInnerRemoteDevice &newDevice);
@@ -138,7 +141,7 @@ private:
 
     std::mutex mutex_;
     int32_t uid_{ 0 };
-    bool isNotifyDevice_{ false };
+    std::atomic<bool> isNotifyDevice_{ false };
     int protocolType_;
     std::vector<std::string> drmSchemes_;
     std::shared_ptr<IDiscoveryManagerListener> listener_;
@@ -147,6 +150,9 @@ private:
     std::unordered_map<CastInnerRemoteDevice, int> remoteDeviceMap_;
     int32_t scanCount_;
     std::atomic<bool> hasStartDiscovery_{ false };
+    // Found devices are parsed off the DM callback thread, in order per device and in parallel across devices.
+    static constexpr size_t PARSE_WORKER_COUNT = 2;
+    KeyedTaskPool parsePool_{ "CastDiscParse", PARSE_WORKER_COUNT };
 };
 } // namespace CastEngineService
 } // namespace CastEngine
@@ -0,0 +1,66 @@
+/*
+ * Copyright (C) 2023-2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * Description: small worker pool that keeps the order of the tasks posted under the same key.
+ * Author: zhangge
+ * Create: 2023-06-05
+ */
+
+#ifndef KEYED_TASK_POOL_H
+#define KEYED_TASK_POOL_H
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace OHOS {
+namespace CastEngine {
+namespace CastEngineService {
+/*
+ * Every key is pinned to one worker by its hash, so the tasks of one key run one after another in posting order,
+ * while the tasks of different keys run in parallel. Workers are started on the first post and live for the life of
+ * the process; Clear only drops the pending tasks, so it never waits for a running task and is safe to call under
+ * the locks that task may take.
+ */
+class KeyedTaskPool {
+public:
+    KeyedTaskPool(const std::string &name, size_t workerCount);
+    ~KeyedTaskPool() = default;
+
+    void Post(const std::string &key, std::function<void()> task);
+    void Clear();
+
+private:
+    struct Worker {
+        std::mutex mutex;
+        std::condition_variable cond;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    static void Run(std::shared_ptr<Worker> worker, std::string name);
+    void StartLocked();
+
+    std::mutex mutex_;
+    std::string name_;
+    size_t workerCount_;
+    std::vector<std::shared_ptr<Worker>> workers_;
+};
+} // namespace CastEngineService
+} // namespace CastEngine
+} // namespace OHOS
+
+#endif // KEYED_TASK_POOL_H
@@ -0,0 +1,113 @@
+/*
+ * Copyright (C) 2023-2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * Description: per connect timeline of the connection establishment stages.
+ * Author: zhangge
+ * Create: 2023-06-05
+ */
+
+#include "connect_timeline.h"
+
+#include "cast_engine_log.h"
+#include "cast_engine_metrics.h"
+#include "utils.h"
+
+namespace OHOS {
+namespace CastEngine {
+namespace CastEngineService {
+DEFINE_CAST_ENGINE_LABEL("Cast-ConnectTimeline");
+
+namespace {
+constexpr int64_t US_PER_MS = 1000;
+
+const std::array<std::string, static_cast<size_t>(ConnectStage::STAGE_MAX)> STAGE_NAMES = {
+    "bind_target",
+    "auth_finish",
+    "query_p2p_ip",
+    "consult_session_opened",
+    "p2p_ip_ready",
+    "auth_success",
+    "consult_data_sent",
+};
+
+int64_t ElapsedUs(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+}
+} // namespace
+
+ConnectTimeline &ConnectTimeline::GetInstance()
+{
+    static ConnectTimeline instance{};
+    return instance;
+}
+
+void ConnectTimeline::Begin(const std::string &deviceId)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto &timeline = timelines_[deviceId];
+    timeline.start = std::chrono::steady_clock::now();
+    timeline.stageUs.fill(STAGE_NOT_REACHED);
+}
+
+void ConnectTimeline::Mark(const std::string &deviceId, ConnectStage stage)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto iter = timelines_.find(deviceId);
+    if (iter == timelines_.end() || stage >= ConnectStage::STAGE_MAX) {
+        return;
+    }
+    auto &stageUs = iter->second.stageUs[static_cast<size_t>(stage)];
+    if (stageUs == STAGE_NOT_REACHED) {
+        stageUs = ElapsedUs(iter->second.start);
+    }
+}
+
+void ConnectTimeline::Finish(const std::string &deviceId, bool isSuccess)
+{
+    Timeline timeline;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto iter = timelines_.find(deviceId);
+        if (iter == timelines_.end()) {
+            return;
+        }
+        timeline = iter->second;
+        timelines_.erase(iter);
+    }
+
+    int64_t totalUs = ElapsedUs(timeline.start);
+    auto &metrics = CastEngineMetrics::GetInstance();
+    metrics.RegisterCounter(isSuccess ? METRIC_CONNECT_SUCCESS : METRIC_CONNECT_FAILED).Add();
+    if (isSuccess) {
+        metrics.RegisterHistogram(METRIC_CONNECT_TOTAL_US).Record(static_cast<uint64_t>(totalUs));
+    }
+
+    std::string stages;
+    for (size_t i = 0; i < STAGE_NAMES.size(); i++) {
+        if (timeline.stageUs[i] == STAGE_NOT_REACHED) {
+            continue;
+        }
+        stages += " " + STAGE_NAMES[i] + ":" + std::to_string(timeline.stageUs[i] / US_PER_MS);
+        if (isSuccess) {
+            metrics.RegisterHistogram(std::string(METRIC_CONNECT_STAGE_PREFIX) + STAGE_NAMES[i] + "_us")
+                .Record(static_cast<uint64_t>(timeline.stageUs[i]));
+        }
+    }
+    CLOGI("device %{public}s connect %{public}s,%{public}s total:%{public}lld, unit:ms",
+        Utils::Mask(deviceId).c_str(), isSuccess ? "success" : "failed", stages.c_str(),
+        static_cast<long long>(totalUs / US_PER_MS));
+}
+} // namespace CastEngineService
+} // namespace CastEngine
+} // namespace OHOS
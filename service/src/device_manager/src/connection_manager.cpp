@@ -28,7 +28,9 @@
 #include "cast_engine_dfx.h"
 #include "cast_engine_errors.h"
 #include "cast_engine_log.h"
+#include "connect_timeline.h"
 #include "discovery_manager.h"
+#include "parameters.h"
 #include "session.h"
 #include "softbus_common.h"
 #include "utils.h"
@@ -476,6 +478,83 @@ bool ConnectionManager::OpenConsultSession(const CastInnerRemoteDevice &device)
     return true;
 }
 
+bool ConnectionManager::OpenConsultSessionAndQueryIp(const CastInnerRemoteDevice &device)
+{
+    if (system::GetBoolParameter(PARAM_CONNECT_PARALLEL, true) && NeedQueryP2PIp(device)) {
+        {
+            std::lock_guard<std::mutex> lock(planMutex_);
+            connectPlans_[device.deviceId] = ConnectPlan{};
+        }
+        // The p2p link only depends on the networkId, so negotiate it while the consult session is being opened
+        // instead of after OnConsultSessionOpened.
+        CLOGI("query p2p ip in parallel with the consult session");
+        ConnectTimeline::GetInstance().Mark(device.deviceId, ConnectStage::QUERY_P2P_IP);
+        if (!QueryP2PIp(device)) {
+            ClearConnectPlan(device.deviceId);
+        }
+    }
+
+    if (!OpenConsultSession(device)) {
+        ClearConnectPlan(device.deviceId);
+        return false;
+    }
+    return true;
+}
+
+void ConnectionManager::OnP2PIpReady(const CastInnerRemoteDevice &device)
+{
+    ConnectTimeline::GetInstance().Mark(device.deviceId, ConnectStage::P2P_IP_READY);
+    bool isAllDone = false;
+    if (FinishConnectStep(device.deviceId, true, isAllDone) && !isAllDone) {
+        CLOGI("p2p ip is ready, wait for the consult session");
+        return;
+    }
+    NotifyConnectStage(device, ConnectStageResult::AUTH_SUCCESS);
+}
+
+bool ConnectionManager::NeedQueryP2PIp(const CastInnerRemoteDevice &device)
+{
+    return IsHuaweiDevice(device) && !IsWifiChannelFirst(device.deviceId);
+}
+
+bool ConnectionManager::FinishConnectStep(const std::string &deviceId, bool isP2PIp, bool &isAllDone)
+{
+    std::lock_guard<std::mutex> lock(planMutex_);
+    auto iter = connectPlans_.find(deviceId);
+    if (iter == connectPlans_.end()) {
+        return false;
+    }
+    auto &plan = iter->second;
+    if (isP2PIp) {
+        plan.isP2PIpReady = true;
+    } else {
+        plan.isConsultSessionOpened = true;
+    }
+    isAllDone = plan.isP2PIpReady && plan.isConsultSessionOpened;
+    if (isAllDone) {
+        connectPlans_.erase(iter);
+    }
+    return true;
+}
+
+void ConnectionManager::ClearConnectPlan(const std::string &deviceId)
+{
+    std::lock_guard<std::mutex> lock(planMutex_);
+    connectPlans_.erase(deviceId);
+    ipQueries_.erase(deviceId);
+}
+
+bool ConnectionManager::FinishIpQuery(const std::string &deviceId, uint64_t generation)
+{
+    std::lock_guard<std::mutex> lock(planMutex_);
+    auto iter = ipQueries_.find(deviceId);
+    if (iter == ipQueries_.end() || iter->second != generation) {
+        return false;
+    }
+    ipQueries_.erase(iter);
+    return true;
+}
+
 void ConnectionManager::OnConsultDataReceived(int transportId, const void *data, unsigned int dataLen)
 {
     std::string dataStr(static_cast<const char *>(data), dataLen);
@@ -557,6 +636,15 @@ bool ConnectionManager::OnConsultSessionOpened(int transportId, bool isSource)
                 return;
             }
 
+            ConnectTimeline::GetInstance().Mark(device->deviceId, ConnectStage::CONSULT_SESSION_OPENED);
+            bool isAllDone = false;
+            if (ConnectionManager::GetInstance().FinishConnectStep(device->deviceId, false, isAllDone)) {
+                if (isAllDone) {
+                    ConnectionManager::GetInstance().NotifyConnectStage(*device, ConnectStageResult::AUTH_SUCCESS);
+                }
+                return;
+            }
+
             bool isWifiChannelFirst = ConnectionManager::GetInstance().IsWifiChannelFirst(device->deviceId);
             if (isWifiChannelFirst) {
                 CLOGE("select wifi channel localip %s, remoteIp %s", (device->localWifiIp).c_str(),
@@ -662,6 +750,7 @@ bool ConnectionManager::ConnectDevice(const CastInnerRemoteDevice &dev, const Pr
         CLOGE("Device(%s) is missing", deviceId.c_str());
         return false;
     }
+    ConnectTimeline::GetInstance().Begin(deviceId);
 
     protocolType_ = protocolType;
     SetConnectingDeviceId(deviceId);
@@ -682,9 +771,10 @@ bool ConnectionManager::ConnectDevice(const CastInnerRemoteDevice &dev, const Pr
     if (IsDeviceTrusted(dev.deviceId, networkId) && IsSingle(dev) && SourceCheckConnectAccess(networkId)) {
         NotifyListenerToLoadSinkSA(networkId);
         if (!CastDeviceDataManager::GetInstance().SetDeviceNetworkId(deviceId, networkId) ||
-            !OpenConsultSession(dev)) {
+            !OpenConsultSessionAndQueryIp(dev)) {
             (void)UpdateDeviceState(deviceId, RemoteDeviceState::FOUND);
             SetConnectingDeviceId("");
+            ConnectTimeline::GetInstance().Finish(deviceId, false);
             return false;
         }
         (void)UpdateDeviceState(deviceId, RemoteDeviceState::CONNECTED);
@@ -693,8 +783,10 @@ bool ConnectionManager::ConnectDevice(const CastInnerRemoteDevice &dev, const Pr
     if (!BindTarget(dev)) {
         (void)UpdateDeviceState(deviceId, RemoteDeviceState::FOUND);
         SetConnectingDeviceId("");
+        ConnectTimeline::GetInstance().Finish(deviceId, false);
         return false;
     }
+    ConnectTimeline::GetInstance().Mark(deviceId, ConnectStage::BIND_TARGET);
     std::unique_lock<std::mutex> lock(mutex_);
     if (isBindTargetMap_.find(deviceId) != isBindTargetMap_.end()) {
         isBindTargetMap_[deviceId] = true;
@@ -709,6 +801,9 @@ void ConnectionManager::DisconnectDevice(const std::string &deviceId)
 {
     CLOGI("DisconnectDevice in, deviceId %{public}s", Utils::Mask(deviceId).c_str());
 
+    ClearConnectPlan(deviceId);
+    ConnectTimeline::GetInstance().Finish(deviceId, false);
+
     std::unique_lock<std::mutex> lock(mutex_);
     connectingDeviceId_ = "";
     DiscoveryManager::GetInstance().StopDiscovery();
@@ -824,6 +919,10 @@ bool ConnectionManager::NotifyConnectStage(const CastInnerRemoteDevice &device,
     if (result == ConnectStageResult::AUTH_FAILED || result == ConnectStageResult::CONNECT_FAIL ||
         result == ConnectStageResult::DISCONNECT_START) {
         UpdateDeviceState(device.deviceId, RemoteDeviceState::FOUND);
+        ClearConnectPlan(device.deviceId);
+        ConnectTimeline::GetInstance().Finish(device.deviceId, false);
+    } else if (result == ConnectStageResult::AUTH_SUCCESS) {
+        ConnectTimeline::GetInstance().Mark(device.deviceId, ConnectStage::AUTH_SUCCESS);
     }
 
     sessionListener->NotifyConnectStage(device.deviceId, result, reasonCode);
@@ -1064,8 +1163,14 @@ bool ConnectionManager::QueryP2PIp(const CastInnerRemoteDevice &dev)
     bindParam["localNetworkId"] = localNetworkId;
     bindParam["remoteNetworkId"] = remoteNetworkId.value();
     CLOGI("QueryP2PIp localNetworkId=%s, remoteNetworkId=%s", localNetworkId.c_str(), remoteNetworkId.value().c_str());
+    uint64_t generation = 0;
+    {
+        std::lock_guard<std::mutex> lock(planMutex_);
+        generation = ++ipQueryGeneration_;
+        ipQueries_[dev.deviceId] = generation;
+    }
     DeviceManager::GetInstance().BindTarget(PKG_NAME, targetId, bindParam,
-        std::make_shared<CastBindTargetCallback>());
+        std::make_shared<CastBindTargetCallback>(generation));
     return true;
 }
 
@@ -1091,8 +1196,11 @@ void ConnectionManager::SendConsultData(const CastInnerRemoteDevice &device, int
     if (ret != SOFTBUS_OK) {
         CLOGE("failed to send consultion data, return:%{public}d", ret);
         CastEngineDfx::WriteErrorEvent(SEND_CONSULTION_DATA_FAIL);
+        ConnectTimeline::GetInstance().Finish(device.deviceId, false);
         return;
     }
+    ConnectTimeline::GetInstance().Mark(device.deviceId, ConnectStage::CONSULT_DATA_SENT);
+    ConnectTimeline::GetInstance().Finish(device.deviceId, true);
     CLOGD("return:%{public}d, data:%s", ret, dataStr.c_str());
 }
 
@@ -1532,6 +1640,7 @@ void CastBindTargetCallback::HandleConnectDeviceAction(const CastInnerRemoteDevi
 
     const std::string networkId = authInfo[NETWORK_ID];
     const std::string deviceId = device.deviceId;
+    ConnectTimeline::GetInstance().Mark(deviceId, ConnectStage::AUTH_FINISH);
     if (!CastDeviceDataManager::GetInstance().SetDeviceNetworkId(device.deviceId, networkId)) {
         return;
     }
@@ -1560,7 +1669,7 @@ void CastBindTargetCallback::HandleConnectDeviceAction(const CastInnerRemoteDevi
             CLOGI("authVersion is 2.0, set sessionkey result is %{public}d", result);
             std::thread([device]() {
                 Utils::SetThreadName("HandleConnectDeviceAction");
-                ConnectionManager::GetInstance().OpenConsultSession(device);
+                ConnectionManager::GetInstance().OpenConsultSessionAndQueryIp(device);
             }).detach();
         }
     }
@@ -1591,6 +1700,10 @@ bool CastBindTargetCallback::GetSessionKey(const json &authInfo, uint8_t *sessio
 void CastBindTargetCallback::HandleQueryIpAction(const CastInnerRemoteDevice &remoteDevice, const json &authInfo)
 {
     CLOGI("query p2p finish, notify session auth success");
+    if (!ConnectionManager::GetInstance().FinishIpQuery(remoteDevice.deviceId, ipQueryGeneration_)) {
+        CLOGW("drop the p2p ip of a query that was cancelled or superseded");
+        return;
+    }
     std::string localIp;
     std::string remoteIp;
     if (authInfo.contains(KEY_LOCAL_P2P_IP) && authInfo[KEY_LOCAL_P2P_IP].is_string()) {
@@ -1613,7 +1726,7 @@ void CastBindTargetCallback::HandleQueryIpAction(const CastInnerRemoteDevice &re
     }
 
     CastDeviceDataManager::GetInstance().SetDeviceIp(remoteDevice.deviceId, localIp, remoteIp);
-    ConnectionManager::GetInstance().NotifyConnectStage(remoteDevice, ConnectStageResult::AUTH_SUCCESS);
+    ConnectionManager::GetInstance().OnP2PIpReady(remoteDevice);
 }
 
 void CastUnBindTargetCallback::OnUnbindResult(const PeerTargetId &targetId, int32_t result, std::string content)
@@ -138,6 +138,7 @@ void DiscoveryManager::Deinit()
     }
 
     StopDiscovery();
+    parsePool_.Clear();
     ResetListener();
     DeviceManager::GetInstance().UnInitDeviceManager(PKG_NAME);
 }
@@ -263,7 +264,14 @@ void DiscoveryManager::OnDeviceInfoFound(uint16_t subscribeId, const DmDeviceInf
 {
     CLOGD("OnDeviceInfoFound in deviceName: %{public}s, deviceId: %{public}s, extra: %{public}s",
           dmDeviceInfo.deviceName, dmDeviceInfo.deviceId, dmDeviceInfo.extraData.c_str());
-    CastInnerRemoteDevice newDevice = CreateRemoteDevice(dmDeviceInfo);
+    parsePool_.Post(dmDeviceInfo.deviceId, [this, dmDeviceInfo]() { HandleDeviceInfoFound(dmDeviceInfo); });
+}
+
+void DiscoveryManager::HandleDeviceInfoFound(const DmDeviceInfo &dmDeviceInfo)
+{
+    // The extra data is parsed once here and the DOM shared by everything below.
+    json extraData = json::parse(dmDeviceInfo.extraData, nullptr, false);
+    CastInnerRemoteDevice newDevice = CreateRemoteDevice(dmDeviceInfo, extraData);
 
     // If the map does not exist, the notification is sent.
     bool isDeviceExist = true;
@@ -292,7 +300,7 @@ void DiscoveryManager::OnDeviceInfoFound(uint16_t subscribeId, const DmDeviceInf
 
     std::lock_guard<std::mutex> lock(mutex_);
     remoteDeviceMap_[newDevice] = scanCount_;
-    RecordDeviceFoundType(dmDeviceInfo);
+    RecordDeviceFoundTypeLocked(dmDeviceInfo.deviceId, extraData);
 }
 
 void DiscoveryManager::NotifyDeviceIsFound(const CastInnerRemoteDevice &newDevice)
@@ -355,7 +363,8 @@ void DiscoveryManager::GetAndReportTrustedDevices()
     }
 }
 
-void DiscoveryManager::ParseDeviceInfo(const DmDeviceInfo &dmDevice, CastInnerRemoteDevice &castDevice)
+void DiscoveryManager::ParseDeviceInfo(const DmDeviceInfo &dmDevice, const json &jsonObj,
+    CastInnerRemoteDevice &castDevice)
 {
     CLOGD("dm device extraData parse, %s", dmDevice.extraData.c_str());
 
@@ -363,7 +372,6 @@ void DiscoveryManager::ParseDeviceInfo(const DmDeviceInfo &dmDevice, CastInnerRe
         .GetDeviceNameByDeviceId(dmDevice.deviceId);
     std::string deviceName = ret.first.empty() ? "" : ret.first;
     std::string discoveryType = ret.second.empty() ? "" : ret.second;
-    json jsonObj = json::parse(dmDevice.extraData, nullptr, false);
     if (jsonObj.is_discarded()) {
         CLOGE("dm device extraData parse error, %s", dmDevice.extraData.c_str());
         return;
@@ -476,6 +484,11 @@ void DiscoveryManager::RemoveSameDeviceLocked(const CastInnerRemoteDevice &newDe
 }
 
 CastInnerRemoteDevice DiscoveryManager::CreateRemoteDevice(const DmDeviceInfo &dmDeviceInfo)
+{
+    return CreateRemoteDevice(dmDeviceInfo, json::parse(dmDeviceInfo.extraData, nullptr, false));
+}
+
+CastInnerRemoteDevice DiscoveryManager::CreateRemoteDevice(const DmDeviceInfo &dmDeviceInfo, const json &extraData)
 {
     auto device = CastDeviceDataManager::GetInstance().GetDeviceByDeviceId(dmDeviceInfo.deviceId);
     CastInnerRemoteDevice newDevice;
@@ -494,7 +507,7 @@ CastInnerRemoteDevice DiscoveryManager::CreateRemoteDevice(const DmDeviceInfo &d
         newDevice.authVersion = AUTH_VERSION_3;
     }
 
-    ParseDeviceInfo(dmDeviceInfo, newDevice);
+    ParseDeviceInfo(dmDeviceInfo, extraData, newDevice);
 
     return newDevice;
 }
@@ -536,14 +549,12 @@ void DiscoveryManager::SetDeviceNotFresh()
     CLOGI("out");
 }
 
-void DiscoveryManager::RecordDeviceFoundType(const DmDeviceInfo dmDevice)
+void DiscoveryManager::RecordDeviceFoundTypeLocked(const std::string &deviceId, const json &jsonObj)
 {
     CLOGI("scanCount_ is %{public}d", scanCount_);
-    std::string deviceId = dmDevice.deviceId;
     if (reportTypeMap_.find(deviceId) == reportTypeMap_.end()) {
         reportTypeMap_.insert({ deviceId, {false, false} });
     }
-    json jsonObj = json::parse(dmDevice.extraData, nullptr, false);
     if (!jsonObj.is_discarded()) {
         if (jsonObj.contains(PARAM_KEY_WIFI_IP) && jsonObj[PARAM_KEY_WIFI_IP].is_string()) {
             reportTypeMap_[deviceId].first = true;
@@ -0,0 +1,87 @@
+/*
+ * Copyright (C) 2023-2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * Description: small worker pool that keeps the order of the tasks posted under the same key.
+ * Author: zhangge
+ * Create: 2023-06-05
+ */
+
+#include "keyed_task_pool.h"
+
+#include <algorithm>
+#include <thread>
+
+#include "cast_engine_log.h"
+#include "utils.h"
+
+namespace OHOS {
+namespace CastEngine {
+namespace CastEngineService {
+DEFINE_CAST_ENGINE_LABEL("Cast-KeyedTaskPool");
+
+KeyedTaskPool::KeyedTaskPool(const std::string &name, size_t workerCount)
+    : name_(name), workerCount_(std::max<size_t>(workerCount, 1))
+{
+}
+
+void KeyedTaskPool::StartLocked()
+{
+    for (size_t i = 0; i < workerCount_; i++) {
+        auto worker = std::make_shared<Worker>();
+        workers_.push_back(worker);
+        std::thread(&KeyedTaskPool::Run, worker, name_ + std::to_string(i)).detach();
+    }
+    CLOGI("%{public}s started %{public}zu workers", name_.c_str(), workerCount_);
+}
+
+void KeyedTaskPool::Run(std::shared_ptr<Worker> worker, std::string name)
+{
+    Utils::SetThreadName(name);
+    while (true) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(worker->mutex);
+            worker->cond.wait(lock, [&worker] { return !worker->tasks.empty(); });
+            task = std::move(worker->tasks.front());
+            worker->tasks.pop_front();
+        }
+        task();
+    }
+}
+
+void KeyedTaskPool::Post(const std::string &key, std::function<void()> task)
+{
+    std::shared_ptr<Worker> worker;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (workers_.empty()) {
+            StartLocked();
+        }
+        worker = workers_[std::hash<std::string>{}(key) % workers_.size()];
+    }
+    std::lock_guard<std::mutex> lock(worker->mutex);
+    worker->tasks.push_back(std::move(task));
+    worker->cond.notify_one();
+}
+
+void KeyedTaskPool::Clear()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto &worker : workers_) {
+        std::lock_guard<std::mutex> workerLock(worker->mutex);
+        worker->tasks.clear();
+    }
+}
+} // namespace CastEngineService
+} // namespace CastEngine
+} // namespace OHOS
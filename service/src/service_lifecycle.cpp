@@ -0,0 +1,124 @@
+/*
+ * Copyright (C) 2023-2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * Description: warm standby and idle unload policy of the cast service.
+ * Author: zhangge
+ * Create: 2023-06-05
+ */
+
+#include "service_lifecycle.h"
+
+#include <algorithm>
+#include <thread>
+
+#include "cast_engine_log.h"
+#include "cast_engine_metrics.h"
+#include "parameters.h"
+
+namespace OHOS {
+namespace CastEngine {
+namespace CastEngineService {
+DEFINE_CAST_ENGINE_LABEL("Cast-ServiceLifecycle");
+
+ServiceLifecycle &ServiceLifecycle::GetInstance()
+{
+    static ServiceLifecycle instance{};
+    return instance;
+}
+
+void ServiceLifecycle::OnClientArrived()
+{
+    static auto &coldStarts = CastEngineMetrics::GetInstance().RegisterCounter(METRIC_SERVICE_COLD_STARTS);
+    static auto &warmStarts = CastEngineMetrics::GetInstance().RegisterCounter(METRIC_SERVICE_WARM_STARTS);
+    std::lock_guard<std::mutex> lock(mutex_);
+    generation_++;
+    cond_.notify_all();
+    if (!hasServedClient_) {
+        hasServedClient_ = true;
+        coldStarts.Add();
+        CLOGI("cold start");
+        return;
+    }
+
+    warmStarts.Add();
+    if (!isIdle_) {
+        return;
+    }
+    isIdle_ = false;
+    int64_t gapMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - idleSince_).count();
+    if (!hasGapSample_) {
+        gapAvgMs_ = gapMs;
+        hasGapSample_ = true;
+    } else {
+        gapAvgMs_ += (gapMs - gapAvgMs_) >> GAP_GAIN_SHIFT;
+    }
+    CLOGI("warm start after %{public}lld ms idle, average %{public}lld ms", static_cast<long long>(gapMs),
+        static_cast<long long>(gapAvgMs_));
+}
+
+void ServiceLifecycle::OnClientsGone(std::function<void()> onIdle)
+{
+    uint64_t generation = 0;
+    int timeoutMs = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        generation = ++generation_;
+        cond_.notify_all();
+        isIdle_ = true;
+        idleSince_ = std::chrono::steady_clock::now();
+        timeoutMs = GetIdleTimeoutMsLocked();
+    }
+    CLOGI("no client, unload in %{public}d ms unless one arrives", timeoutMs);
+
+    std::thread([this, generation, timeoutMs, onIdle = std::move(onIdle)]() {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            if (cond_.wait_for(lock, std::chrono::milliseconds(timeoutMs),
+                [this, generation] { return generation_ != generation; })) {
+                return;
+            }
+        }
+        if (onIdle) {
+            onIdle();
+        }
+    }).detach();
+}
+
+bool ServiceLifecycle::IsClientExpected()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!hasServedClient_) {
+        return true;
+    }
+    return isIdle_ && hasGapSample_ && gapAvgMs_ < GetIdleTimeoutMsLocked();
+}
+
+int ServiceLifecycle::GetIdleTimeoutMs()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return GetIdleTimeoutMsLocked();
+}
+
+int ServiceLifecycle::GetIdleTimeoutMsLocked()
+{
+    int maxTimeoutMs = std::max(OHOS::system::GetIntParameter<int>(CAST_IDLE_TIMEOUT_PARAM, DEFAULT_IDLE_TIMEOUT_MS),
+        MIN_IDLE_TIMEOUT_MS);
+    if (!hasGapSample_) {
+        return maxTimeoutMs;
+    }
+    return static_cast<int>(std::clamp<int64_t>(gapAvgMs_ * GAP_TIMEOUT_FACTOR, MIN_IDLE_TIMEOUT_MS, maxTimeoutMs));
+}
+} // namespace CastEngineService
+} // namespace CastEngine
+} // namespace OHOS
@@ -0,0 +1,145 @@
+/*
+ * Copyright (C) 2023-2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * Description: staged service startup with per stage readiness.
+ * Author: zhangge
+ * Create: 2023-06-05
+ */
+
+#include "service_startup.h"
+
+#include <string>
+
+#include "cast_engine_log.h"
+#include "cast_engine_metrics.h"
+
+namespace OHOS {
+namespace CastEngine {
+namespace CastEngineService {
+DEFINE_CAST_ENGINE_LABEL("Cast-ServiceStartup");
+
+namespace {
+constexpr int64_t US_PER_MS = 1000;
+
+const std::array<std::string, static_cast<size_t>(StartupStage::STAGE_MAX)> STAGE_NAMES = {
+    "softbus_server",
+    "device_manager",
+    "discovery",
+};
+} // namespace
+
+ServiceStartup &ServiceStartup::GetInstance()
+{
+    static ServiceStartup instance{};
+    return instance;
+}
+
+ServiceStartup::ServiceStartup() : start_(std::chrono::steady_clock::now())
+{
+    for (auto &stage : stages_) {
+        RenewLocked(stage);
+    }
+}
+
+void ServiceStartup::RenewLocked(Stage &stage)
+{
+    stage.promise = std::promise<bool>();
+    stage.future = stage.promise.get_future().share();
+    stage.isSettled = false;
+}
+
+void ServiceStartup::Begin()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    start_ = std::chrono::steady_clock::now();
+    for (auto &stage : stages_) {
+        stage.isRecorded = false;
+    }
+}
+
+void ServiceStartup::MarkReady(StartupStage stage, bool isReady)
+{
+    if (stage >= StartupStage::STAGE_MAX) {
+        return;
+    }
+    size_t index = static_cast<size_t>(stage);
+    int64_t elapsedUs = 0;
+    bool needRecord = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto &entry = stages_[index];
+        if (entry.isSettled) {
+            return;
+        }
+        entry.isSettled = true;
+        entry.promise.set_value(isReady);
+        elapsedUs = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - start_).count();
+        needRecord = !entry.isRecorded;
+        entry.isRecorded = true;
+    }
+
+    if (!needRecord) {
+        CLOGI("stage %{public}s %{public}s again", STAGE_NAMES[index].c_str(), isReady ? "ready" : "failed");
+        return;
+    }
+    CLOGI("stage %{public}s %{public}s at %{public}lld ms since start", STAGE_NAMES[index].c_str(),
+        isReady ? "ready" : "failed", static_cast<long long>(elapsedUs / US_PER_MS));
+    if (isReady) {
+        CastEngineMetrics::GetInstance().RegisterHistogram(std::string(METRIC_SERVICE_STARTUP_PREFIX) +
+            STAGE_NAMES[index] + "_us").Record(static_cast<uint64_t>(elapsedUs));
+    }
+}
+
+void ServiceStartup::Reset(StartupStage stage)
+{
+    if (stage >= StartupStage::STAGE_MAX) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto &entry = stages_[static_cast<size_t>(stage)];
+    if (entry.isSettled) {
+        RenewLocked(entry);
+    }
+}
+
+bool ServiceStartup::IsReady(StartupStage stage)
+{
+    if (stage >= StartupStage::STAGE_MAX) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto &entry = stages_[static_cast<size_t>(stage)];
+    return entry.isSettled && entry.future.get();
+}
+
+bool ServiceStartup::WaitReady(StartupStage stage, int timeoutMs)
+{
+    if (stage >= StartupStage::STAGE_MAX) {
+        return false;
+    }
+    std::shared_future<bool> future;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        future = stages_[static_cast<size_t>(stage)].future;
+    }
+    if (future.wait_for(std::chrono::milliseconds(timeoutMs)) != std::future_status::ready) {
+        CLOGW("stage %{public}s not ready in %{public}d ms", STAGE_NAMES[static_cast<size_t>(stage)].c_str(),
+            timeoutMs);
+        return false;
+    }
+    return future.get();
+}
+} // namespace CastEngineService
+} // namespace CastEngine
+} // namespace OHOS
@@ -38,6 +38,7 @@
 #include "channel_manager_listener.h"
 #include "channel_request.h"
 #include "message.h"
+#include "mirror_rate_monitor.h"
 #include "i_rtsp_controller.h"
 #include "oh_remote_control_event.h"
 #include "rtsp_listener.h"
@@ -214,6 +215,9 @@ private:
     bool IsDlnaDevice(CastInnerRemoteDevice remoteDeviceInfo);
 
     void MirrorRcvVideoFrame();
+    void StartMirrorRateMonitor(std::shared_ptr<Channel> channel);
+    void StopMirrorRateMonitor();
+    void OnMirrorRateChanged(uint32_t minBitrate, uint32_t maxBitrate, const MirrorRateController::Rate &rate);
     bool ProcessSetCastMode(const Message &msg);
     void UpdateScreenInfo(uint64_t screenId, uint16_t width, uint16_t height);
     void UpdateDefaultDisplayRotationInfo(int rotation, uint16_t width, uint16_t height);
@@ -254,6 +258,7 @@ private:
     std::function<void(int)> serviceCallback_;
     std::map<pid_t, sptr<ICastSessionListenerImpl>> listeners_;
     sptr<IMirrorPlayerImpl> mirrorPlayer_;
+    std::shared_ptr<MirrorRateMonitor> mirrorRateMonitor_;
     std::shared_ptr<ICastStreamManager> streamManager_;
     int sessionId_{ -1 };
     int rtspPort_{ -1 };
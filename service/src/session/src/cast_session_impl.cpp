@@ -18,6 +18,7 @@
 
 #include "cast_session_impl.h"
 
+#include <algorithm>
 #include <array>
 
 #include "cast_engine_errors.h"
@@ -30,6 +31,7 @@
 #include "ipc_skeleton.h"
 #include "json/json.h"
 #include "mirror_player_impl.h"
+#include "parameters.h"
 #include "permission.h"
 #include "cast_engine_dfx.h"
 #include "wifi_hid2d.h"
@@ -669,9 +671,16 @@ void CastSessionImpl::InitRtspParamInfo(std::shared_ptr<CastRemoteDeviceInfo> re
         .remoteDeviceSubtype = remote.subDeviceType,
     };
     rtspParamInfo_.SetDeviceTypeParamInfo(param);
-    rtspParamInfo_.SetFeatureSet(std::set<int> { ParamInfo::FEATURE_STOP_VTP, ParamInfo::FEATURE_FINE_STYLUS,
+    std::set<int> featureSet { ParamInfo::FEATURE_STOP_VTP, ParamInfo::FEATURE_FINE_STYLUS,
         ParamInfo::FEATURE_SOURCE_MOUSE, ParamInfo::FEATURE_SOURCE_MOUSE_HISTORY,
-        ParamInfo::FEATURE_SEND_EVENT_CHANGE });
+        ParamInfo::FEATURE_SEND_EVENT_CHANGE };
+    if (system::GetBoolParameter(PARAM_CHANNEL_MUX, false)) {
+        featureSet.insert(ParamInfo::FEATURE_CHANNEL_MUX);
+    }
+    if (system::GetBoolParameter(PARAM_VTP_UDP, true)) {
+        featureSet.insert(ParamInfo::FEATURE_UDP_VTP);
+    }
+    rtspParamInfo_.SetFeatureSet(featureSet);
 }
 
 std::string CastSessionImpl::GetCurrentRemoteDeviceId()
@@ -929,6 +938,70 @@ void CastSessionImpl::MirrorRcvVideoFrame()
 {
 }
 
+void CastSessionImpl::StartMirrorRateMonitor(std::shared_ptr<Channel> channel)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (property_.endType != EndType::CAST_SOURCE || property_.protocolType == ProtocolType::CAST_PLUS_STREAM) {
+        return;
+    }
+    // The negotiated video property bounds the rate; what it leaves open falls back to the rtsp defaults.
+    const auto &video = property_.videoProperty;
+    uint32_t maxBitrate = video.maxBitrate > 0 ? video.maxBitrate :
+        (video.bitrate > 0 ? video.bitrate : static_cast<uint32_t>(CastSessionRtsp::VIDEO_BITRATE_MAX));
+    uint32_t minBitrate = std::min(maxBitrate, video.minBitrate > 0 ? video.minBitrate :
+        static_cast<uint32_t>(CastSessionRtsp::VIDEO_BITRATE_MIN));
+    uint32_t startBitrate = video.bitrate > 0 ? video.bitrate : maxBitrate;
+    uint32_t maxFps = video.fps > 0 ? video.fps : static_cast<uint32_t>(CastSessionRtsp::VIDEO_FPS_60);
+    uint32_t minFps = std::min(maxFps, static_cast<uint32_t>(CastSessionRtsp::VIDEO_FPS_MIN));
+    CLOGI("bitrate %{public}u..%{public}u from %{public}u, fps %{public}u..%{public}u", minBitrate, maxBitrate,
+        startBitrate, minFps, maxFps);
+
+    if (mirrorRateMonitor_) {
+        mirrorRateMonitor_->Stop();
+    }
+    wptr<CastSessionImpl> weakSession(this);
+    mirrorRateMonitor_ = std::make_shared<MirrorRateMonitor>(channel,
+        MirrorRateController(minBitrate, maxBitrate, startBitrate, minFps, maxFps),
+        [weakSession, minBitrate, maxBitrate](const MirrorRateController::Rate &rate) {
+            auto session = weakSession.promote();
+            if (session) {
+                session->OnMirrorRateChanged(minBitrate, maxBitrate, rate);
+            }
+        });
+    mirrorRateMonitor_->Start();
+}
+
+void CastSessionImpl::StopMirrorRateMonitor()
+{
+    std::shared_ptr<MirrorRateMonitor> monitor;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        monitor = std::move(mirrorRateMonitor_);
+    }
+    if (monitor) {
+        monitor->Stop();
+    }
+}
+
+void CastSessionImpl::OnMirrorRateChanged(uint32_t minBitrate, uint32_t maxBitrate,
+    const MirrorRateController::Rate &rate)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        property_.videoProperty.bitrate = rate.bitrate;
+        property_.videoProperty.fps = rate.fps;
+    }
+    // The fields follow IMirrorPlayer::SetBitrate and SetFps, so the listener can hand them to the encoder as is.
+    Json::Value root;
+    root["minBitrate"] = minBitrate;
+    root["bitrate"] = rate.bitrate;
+    root["maxBitrate"] = maxBitrate;
+    root["fps"] = rate.fps;
+    Json::StreamWriterBuilder builder;
+    builder["indentation"] = "";
+    OnEvent(EventId::MIRROR_VIDEO_RATE_CHANGED, Json::writeString(builder, root));
+}
+
 bool CastSessionImpl::ProcessPlay(const Message &msg)
 {
     CLOGD("In");
@@ -958,6 +1031,7 @@ bool CastSessionImpl::ProcessDisconnect(const Message &msg)
 
     CLOGD("In");
     SetWifiScene(0);
+    StopMirrorRateMonitor();
     rtspControl_->Action(ActionType::TEARDOWN);
     channelManager_->DestroyAllChannels();
     return true;
@@ -1050,7 +1124,18 @@ std::shared_ptr<ChannelRequest> CastSessionImpl::BuildChannelRequest(const std::
     bool isReceiver = !(property_.endType == EndType::CAST_SOURCE &&
         (moduleType == ModuleType::VIDEO || moduleType == ModuleType::AUDIO));
 
-    return std::make_shared<ChannelRequest>(moduleType, isReceiver, localDevice_, remote, property_);
+    // Peers that predate the udp transport carry vtp over tcp, so both ends must have announced it.
+    bool isUdpVtp = isSupportVtp && rtspControl_ &&
+        IsSupportFeature(rtspControl_->GetNegotiatedFeatureSet(), ParamInfo::FEATURE_UDP_VTP);
+    auto request =
+        std::make_shared<ChannelRequest>(moduleType, isReceiver, localDevice_, remote, property_, isUdpVtp);
+    // RTSP negotiates the mux, and remote control keeps the tcp framing of its peers.
+    if (request->linkType == ChannelLinkType::TCP && moduleType != ModuleType::RTSP &&
+        moduleType != ModuleType::REMOTE_CONTROL && rtspControl_ &&
+        IsSupportFeature(rtspControl_->GetNegotiatedFeatureSet(), ParamInfo::FEATURE_CHANNEL_MUX)) {
+        request->linkType = ChannelLinkType::MUX;
+    }
+    return request;
 }
 
 std::shared_ptr<CastRemoteDeviceInfo> CastSessionImpl::FindRemoteDevice(const std::string &deviceId)
@@ -96,13 +96,13 @@ int32_t CastSessionImplStub::DoAddDeviceTask(MessageParcel &data, MessageParcel
         return ERR_NO_PERMISSION;
     }
 
-    auto device = ReadCastRemoteDevice(data);
-    if (device == nullptr) {
+    CastRemoteDevice device;
+    if (!ReadCastRemoteDevice(data, device)) {
         CLOGE("Invalid remote device object comes");
         return ERR_INVALID_DATA;
     }
 
-    if (!reply.WriteInt32(AddDevice(*device))) {
+    if (!reply.WriteInt32(AddDevice(device))) {
         CLOGE("Failed to write int value");
         return IPC_STUB_WRITE_PARCEL_ERR;
     }
@@ -357,6 +357,11 @@ void CastSessionImpl::ChannelManagerListenerImpl::OnChannelCreated(std::shared_p
         case ModuleType::VIDEO:
             AudioAndVideoWriteWrap(__func__, session->property_.protocolType, moduleType, sessionID);
 
+#ifdef CAST_ENGINE_MIRROR_RATE_ADAPTATION
+            if (moduleType == ModuleType::VIDEO) {
+                session->StartMirrorRateMonitor(channel);
+            }
+#endif
             if (SetAndCheckMediaChannel(moduleType, deviceInfo->remoteDevice)) {
                 session->SendCastMessage(Message(MessageId::MSG_SETUP_SUCCESS, MODULE_ID_MEDIA, remoteDeviceId));
             }
@@ -19,6 +19,7 @@
 #include "cast_session_impl.h"
 #include "cast_engine_log.h"
 #include "cast_engine_dfx.h"
+#include "cast_trace.h"
 #include "utils.h"
 
 namespace OHOS {
@@ -37,6 +38,7 @@ void CastSessionImpl::BaseState::Enter(SessionState state)
     // BaseState and its inherited classes work under the strict control of the session,
     // so the session_ used in the BaseState member function must not be null.
     session->sessionState_ = state;
+    CastTraceRecorder::GetInstance().RecordState(static_cast<uint16_t>(state));
     CLOGI("%{public}s enter", SESSION_STATE_STRING[static_cast<int>(state)].c_str());
 }
 
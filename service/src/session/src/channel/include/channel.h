@@ -26,6 +26,18 @@
 namespace OHOS {
 namespace CastEngine {
 namespace CastEngineService {
+// Cumulative counters of the link a channel sends on, sampled by the rate control of the media it carries.
+struct ChannelLinkStats {
+    uint64_t sentBytes{ 0 };
+    // In the packets of the link: tcp segments and their retransmissions, vtp packets and the ones the receiver nacked.
+    uint64_t sentPackets{ 0 };
+    uint64_t lostPackets{ 0 };
+    // 0 when the link does not measure them.
+    uint32_t rttUs{ 0 };
+    uint32_t rttVarUs{ 0 };
+    uint64_t cwndBytes{ 0 };
+};
+
 class Channel {
 public:
     virtual ~Channel() = default;
@@ -55,6 +67,17 @@ public:
         return false;
     }
 
+    // Bytes accepted by Send but not yet written out, always 0 for a channel that sends synchronously.
+    virtual size_t GetSendQueueDepth()
+    {
+        return 0;
+    }
+
+    virtual bool GetLinkStats(ChannelLinkStats &stats)
+    {
+        return false;
+    }
+
 private:
     ChannelRequest channelRequest_;
     std::shared_ptr<IChannelListener> channelListener_;
@@ -27,7 +27,8 @@ namespace CastEngineService {
 enum class ChannelLinkType {
     SOFT_BUS,
     TCP,
-    VTP
+    VTP,
+    MUX
 };
 
 enum class ModuleType {
@@ -42,6 +42,11 @@ public:
     virtual void OnFilesSent(std::string firstFile, int percent) {}
     virtual void OnFilesReceived(std::string files, int percent) {}
     virtual void OnFileTransError() {}
+    /*
+     * Only reported by a channel that queues what it sends: once when its queue grows past the high watermark and
+     * once when it has drained to the low one. Called on the sending thread of the channel, so it must not block.
+     */
+    virtual void OnSendQueueWatermark(bool isAboveHighWatermark, size_t queuedBytes) {}
 };
 } // namespace CastEngineService
 } // namespace CastEngine
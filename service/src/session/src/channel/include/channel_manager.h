@@ -19,10 +19,12 @@
 #ifndef CHANNEL_MANAGER_H
 #define CHANNEL_MANAGER_H
 
+#include <chrono>
 #include <map>
 #include <mutex>
 #include <string>
 #include <memory>
+#include "cast_engine_metrics.h"
 #include "channel_request.h"
 #include "connection.h"
 #include "channel_listener.h"
@@ -32,6 +34,8 @@
 namespace OHOS {
 namespace CastEngine {
 namespace CastEngineService {
+class MuxTransport;
+
 class ChannelManager {
 public:
     ChannelManager(const int sessionIndex, std::shared_ptr<IChannelManagerListener> channelManagerListener);
@@ -46,24 +50,46 @@ public:
     void DestroyAllChannels();
 
 private:
+    /*
+     * Counts the channels requested but not opened yet, and records how long a burst of requests takes until the
+     * last of them is open, which is what the mux transport saves on.
+     */
+    class ReadyTracker {
+    public:
+        void OnRequested();
+        void OnSettled(bool isOpened);
+        bool IsAllReady();
+
+    private:
+        std::mutex mutex_;
+        int pending_{ 0 };
+        std::chrono::steady_clock::time_point since_;
+    };
+
     class ConnectionListenerInner : public ConnectionListener {
     public:
-        explicit ConnectionListenerInner(std::shared_ptr<IChannelManagerListener> listener)
-            : channelManagerListenerInner_(listener) {};
+        ConnectionListenerInner(std::shared_ptr<IChannelManagerListener> listener,
+            std::shared_ptr<ReadyTracker> readyTracker)
+            : channelManagerListenerInner_(listener), readyTracker_(readyTracker) {};
 
         ~ConnectionListenerInner() {};
 
     private:
         std::shared_ptr<IChannelManagerListener> channelManagerListenerInner_;
+        std::shared_ptr<ReadyTracker> readyTracker_;
 
         bool OnConnectionOpened(std::shared_ptr<Channel> channel) override
         {
+            static auto &opened = CastEngineMetrics::GetInstance().RegisterCounter(METRIC_CHANNEL_OPENED);
+            opened.Add();
+            readyTracker_->OnSettled(true);
             channelManagerListenerInner_->OnChannelCreated(channel);
             return true;
         }
 
         void OnConnectionConnectFailed(ChannelRequest &channelRequest, int errorCode) override
         {
+            readyTracker_->OnSettled(false);
             channelManagerListenerInner_->OnChannelOpenFailed(channelRequest, errorCode);
         }
 
@@ -80,6 +106,7 @@ private:
 
     bool IsRequestValid(const ChannelRequest &request) const;
     std::shared_ptr<Connection> GetConnection(ChannelLinkType linkType);
+    std::shared_ptr<MuxTransport> GetMuxTransport();
 
     static const int RET_ERR = -1;
     int sessionId_{ -1 };
@@ -89,6 +116,10 @@ private:
     std::mutex connectionMapMtx_;
     std::shared_ptr<IChannelManagerListener> channelManagerListener_;
     std::shared_ptr<ConnectionListener> connectionListener_;
+    std::shared_ptr<ReadyTracker> readyTracker_;
+    // One per session, so one per peer; made by the first mux channel and dropped once the link is lost.
+    std::shared_ptr<MuxTransport> muxTransport_;
+    std::mutex muxMtx_;
 };
 } // namespace CastEngineService
 } // namespace CastEngine
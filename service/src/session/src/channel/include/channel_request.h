@@ -32,15 +32,22 @@ struct ChannelRequest {
     ~ChannelRequest() = default;
 
     ChannelRequest(const ModuleType moduleType, bool isReceiver, const CastLocalDevice &localDeviceInfo,
-           const CastInnerRemoteDevice &remoteDeviceInfo, const CastSessionProperty &sessionProperty)
+           const CastInnerRemoteDevice &remoteDeviceInfo, const CastSessionProperty &sessionProperty,
+           bool isUdpVtp = false)
         : moduleType(moduleType),
           isReceiver(isReceiver),
           localDeviceInfo(localDeviceInfo),
           remoteDeviceInfo(remoteDeviceInfo),
           sessionProperty(sessionProperty)
     {
-        linkType =
-            remoteDeviceInfo.channelType == ChannelType::SOFT_BUS ? ChannelLinkType::SOFT_BUS : ChannelLinkType::TCP;
+        // Only the media channels go over udp, the others need the ordering and reliability of tcp.
+        if (remoteDeviceInfo.channelType == ChannelType::SOFT_BUS) {
+            linkType = ChannelLinkType::SOFT_BUS;
+        } else if (isUdpVtp && (moduleType == ModuleType::VIDEO || moduleType == ModuleType::AUDIO)) {
+            linkType = ChannelLinkType::VTP;
+        } else {
+            linkType = ChannelLinkType::TCP;
+        }
     };
 
     bool operator<(const ChannelRequest &request) const
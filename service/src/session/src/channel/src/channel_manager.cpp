@@ -18,9 +18,11 @@
 
 #include "channel_manager.h"
 #include "cast_engine_log.h"
+#include "mux/mux_connection.h"
 #include "softbus/softbus_connection.h"
 #include "tcp/tcp_connection.h"
 #include "utils.h"
+#include "vtp/vtp_connection.h"
 
 namespace OHOS {
 namespace CastEngine {
@@ -31,7 +33,8 @@ ChannelManager::ChannelManager(const int sessionIndex, std::shared_ptr<IChannelM
     : sessionIndex_(sessionIndex), channelManagerListener_(channelManagerListener)
 {
     CLOGD("In, sessionId_ = %{public}d, sessionIndex_ = %{public}d.", sessionId_, sessionIndex_);
-    connectionListener_ = std::make_shared<ConnectionListenerInner>(channelManagerListener_);
+    readyTracker_ = std::make_shared<ReadyTracker>();
+    connectionListener_ = std::make_shared<ConnectionListenerInner>(channelManagerListener_, readyTracker_);
 }
 
 ChannelManager::~ChannelManager()
@@ -48,10 +51,17 @@ std::shared_ptr<Connection> ChannelManager::GetConnection(ChannelLinkType linkTy
             CLOGD("GetConnection, Create SoftBus Connection, linkType = %{public}d.", linkType);
             break;
         case ChannelLinkType::VTP:
+            connection = std::make_shared<VtpConnection>();
+            CLOGD("GetConnection, Create Vtp Connection, linkType = %{public}d.", linkType);
+            break;
         case ChannelLinkType::TCP:
             connection = std::make_shared<TcpConnection>();
             CLOGD("GetConnection, Create Tcp Connection, linkType = %{public}d.", linkType);
             break;
+        case ChannelLinkType::MUX:
+            connection = std::make_shared<MuxConnection>(GetMuxTransport());
+            CLOGD("GetConnection, Create Mux Connection, linkType = %{public}d.", linkType);
+            break;
         default:
             CLOGE("Invalid linkType, linkType = %{public}d.", linkType);
             break;
@@ -59,6 +69,15 @@ std::shared_ptr<Connection> ChannelManager::GetConnection(ChannelLinkType linkTy
     return connection;
 }
 
+std::shared_ptr<MuxTransport> ChannelManager::GetMuxTransport()
+{
+    std::lock_guard<std::mutex> lg(muxMtx_);
+    if (!muxTransport_ || muxTransport_->IsClosed()) {
+        muxTransport_ = std::make_shared<MuxTransport>();
+    }
+    return muxTransport_;
+}
+
 /*
  * server (start listen) or client (start connection)
  *
@@ -69,6 +88,7 @@ std::shared_ptr<Connection> ChannelManager::GetConnection(ChannelLinkType linkTy
  * ----------------------------------
  * source| client| server|  server
  * ----------------------------------
+ * MUX takes the TCP roles for its first channel, the later ones are streams on that connection.
  */
 int ChannelManager::CreateChannel(ChannelRequest &request, std::shared_ptr<IChannelListener> channelListener)
 {
@@ -91,6 +111,7 @@ int ChannelManager::CreateChannel(ChannelRequest &request, std::shared_ptr<IChan
     int remoteCtrl = -1;
     CLOGI("CreateChannel In, linkType = %{public}d, isVtp = %{public}d, isSink = %{public}d.", request.linkType,
         isVtp, isSink);
+    readyTracker_->OnRequested();
     if ((isVtp && isSink) || (!isVtp && !isSink)) {
         CLOGV("CreateChannel In, StartListen.");
         remoteCtrl = connection->StartListen(request, channelListener);
@@ -101,6 +122,8 @@ int ChannelManager::CreateChannel(ChannelRequest &request, std::shared_ptr<IChan
     if (remoteCtrl != -1) {
         std::lock_guard<std::mutex> lg(connectionMapMtx_);
         connectionMap_.insert(std::pair<ChannelRequest, std::shared_ptr<Connection>>(request, connection));
+    } else {
+        readyTracker_->OnSettled(false);
     }
     return remoteCtrl;
 }
@@ -127,6 +150,7 @@ int ChannelManager::CreateChannel(ChannelRequest &request, std::shared_ptr<IChan
     int remoteCtrl = -1;
     CLOGI("CreateChannel In, linkType = %{public}d, isVtp = %{public}d, isSink = %{public}d.", request.linkType,
         isVtp, isSink);
+    readyTracker_->OnRequested();
     if ((isVtp && isSink) || (!isVtp && !isSink)) {
         CLOGV("CreateChannel In, StartConnection.");
         remoteCtrl = connection->StartConnection(request, channelListener);
@@ -137,6 +161,8 @@ int ChannelManager::CreateChannel(ChannelRequest &request, std::shared_ptr<IChan
     if (remoteCtrl != -1) {
         std::lock_guard<std::mutex> lg(connectionMapMtx_);
         connectionMap_.insert(std::pair<ChannelRequest, std::shared_ptr<Connection>>(request, connection));
+    } else {
+        readyTracker_->OnSettled(false);
     }
     return remoteCtrl;
 }
@@ -201,11 +227,45 @@ void ChannelManager::DestroyAllChannels()
         it->second->CloseConnection();
         it = connectionMap_.erase(it);
     }
+
+    std::lock_guard<std::mutex> muxLock(muxMtx_);
+    if (muxTransport_) {
+        muxTransport_->Close();
+        muxTransport_ = nullptr;
+    }
 }
 
 bool ChannelManager::IsAllChannelOpened() const
 {
-    return true;
+    return readyTracker_->IsAllReady();
+}
+
+void ChannelManager::ReadyTracker::OnRequested()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (pending_++ == 0) {
+        since_ = std::chrono::steady_clock::now();
+    }
+}
+
+void ChannelManager::ReadyTracker::OnSettled(bool isOpened)
+{
+    static auto &allReady = CastEngineMetrics::GetInstance().RegisterHistogram(METRIC_CHANNEL_ALL_READY_US);
+    std::lock_guard<std::mutex> lock(mutex_);
+    // The tcp and mux media servers open the audio channel on their own, without a request of its own.
+    if (pending_ == 0) {
+        return;
+    }
+    if (--pending_ == 0 && isOpened) {
+        allReady.Record(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - since_).count()));
+    }
+}
+
+bool ChannelManager::ReadyTracker::IsAllReady()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return pending_ == 0;
 }
 } // namespace CastEngineService
 } // namespace CastEngine
@@ -0,0 +1,170 @@
+/*
+ * Copyright (C) 2023-2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * Description: channel of one module type carried as a stream of the mux transport.
+ * Author: zhangge
+ * Create: 2023-06-05
+ */
+
+#include "mux_connection.h"
+
+#include "cast_engine_log.h"
+#include "cast_engine_metrics.h"
+#include "cast_trace.h"
+
+namespace OHOS {
+namespace CastEngine {
+namespace CastEngineService {
+DEFINE_CAST_ENGINE_LABEL("Cast-MuxConnection");
+
+MuxConnection::~MuxConnection()
+{
+    CLOGD("Enter.");
+}
+
+int MuxConnection::StartConnection(const ChannelRequest &request, std::shared_ptr<IChannelListener> channelListener)
+{
+    CLOGD("Mux Start Connection Enter, moduleType = %{public}d.", request.moduleType);
+    StashRequest(request);
+    SetRequest(request);
+    SetListener(channelListener);
+    transport_->Connect(request);
+    if (!transport_->AddStream(request.moduleType, shared_from_this(), true)) {
+        CLOGE("Mux transport is closed.");
+        return RET_ERR;
+    }
+    return RET_OK;
+}
+
+int MuxConnection::StartListen(const ChannelRequest &request, std::shared_ptr<IChannelListener> channelListener)
+{
+    CLOGD("Mux Start Listen Enter, moduleType = %{public}d.", request.moduleType);
+    StashRequest(request);
+    SetRequest(request);
+    SetListener(channelListener);
+    int port = transport_->Listen(request);
+    if (port == INVALID_PORT || !transport_->AddStream(request.moduleType, shared_from_this(), false)) {
+        CLOGE("Mux listen failed.");
+        return INVALID_PORT;
+    }
+    return port;
+}
+
+std::shared_ptr<MuxConnection> MuxConnection::CreateAudioStream()
+{
+    auto audioConn = std::make_shared<MuxConnection>(transport_);
+    ChannelRequest audioChannelRequest = channelRequest_;
+    audioChannelRequest.moduleType = ModuleType::AUDIO;
+    audioConn->StashRequest(audioChannelRequest);
+    audioConn->SetRequest(audioChannelRequest);
+    audioConn->SetConnectionListener(listener_);
+    audioConn->SetListener(GetListener());
+    return audioConn;
+}
+
+void MuxConnection::OnStreamOpened()
+{
+    isOpened_ = true;
+    CLOGI("Open Session Succ, sessionId = %{public}d, moduleType = %{public}d",
+        channelRequest_.remoteDeviceInfo.sessionId, channelRequest_.moduleType);
+    if (listener_) {
+        listener_->OnConnectionOpened(shared_from_this());
+    }
+}
+
+void MuxConnection::OnStreamData(const uint8_t *buf, int bufLen)
+{
+    static auto &rxBytes = CastEngineMetrics::GetInstance().RegisterCounter(METRIC_CHANNEL_RX_BYTES);
+    static auto &rxFrames = CastEngineMetrics::GetInstance().RegisterCounter(METRIC_CHANNEL_RX_FRAMES);
+    rxFrames.Add();
+    rxBytes.Add(bufLen);
+    CastTraceRecorder::GetInstance().Record(TraceRecordType::CHANNEL_RX,
+        static_cast<uint16_t>(channelRequest_.moduleType), buf, static_cast<uint32_t>(bufLen));
+    if (GetListener()) {
+        GetListener()->OnDataReceived(buf, bufLen, 0);
+    }
+}
+
+void MuxConnection::OnStreamError(int errorCode)
+{
+    if (isClosed_ || !listener_) {
+        return;
+    }
+    if (!isOpened_) {
+        listener_->OnConnectionConnectFailed(channelRequest_, errorCode);
+        return;
+    }
+    static auto &rxErrors = CastEngineMetrics::GetInstance().RegisterCounter(METRIC_CHANNEL_RX_ERRORS);
+    rxErrors.Add();
+    listener_->OnConnectionError(shared_from_this(), errorCode);
+}
+
+void MuxConnection::OnSendQueueWatermark(bool isAboveHighWatermark, size_t queuedBytes)
+{
+    if (!isClosed_ && GetListener()) {
+        GetListener()->OnSendQueueWatermark(isAboveHighWatermark, queuedBytes);
+    }
+}
+
+void MuxConnection::CloseConnection()
+{
+    CLOGI("Mux Close Enter, moduleType = %{public}d.", channelRequest_.moduleType);
+    if (isClosed_.exchange(true)) {
+        return;
+    }
+    transport_->RemoveStream(channelRequest_.moduleType);
+    if (listener_) {
+        listener_->OnConnectionClosed(shared_from_this());
+    }
+}
+
+bool MuxConnection::Send(const uint8_t *buf, int bufLen)
+{
+    CLOGV("Mux Send Enter, len = %{public}d", bufLen);
+    if (buf == nullptr || bufLen <= 0) {
+        CLOGE("Data or length is illegal.");
+        return false;
+    }
+
+    static auto &txBytes = CastEngineMetrics::GetInstance().RegisterCounter(METRIC_CHANNEL_TX_BYTES);
+    static auto &txFrames = CastEngineMetrics::GetInstance().RegisterCounter(METRIC_CHANNEL_TX_FRAMES);
+    static auto &txErrors = CastEngineMetrics::GetInstance().RegisterCounter(METRIC_CHANNEL_TX_ERRORS);
+    static auto &sendTime = CastEngineMetrics::GetInstance().RegisterHistogram(METRIC_CHANNEL_SEND_US);
+    bool ret;
+    {
+        MetricScopedTimer timer(sendTime);
+        ret = transport_->Send(channelRequest_.moduleType, buf, bufLen);
+    }
+    if (!ret) {
+        txErrors.Add();
+        return false;
+    }
+    txFrames.Add();
+    txBytes.Add(bufLen);
+    CastTraceRecorder::GetInstance().Record(TraceRecordType::CHANNEL_TX,
+        static_cast<uint16_t>(channelRequest_.moduleType), buf, static_cast<uint32_t>(bufLen));
+    return true;
+}
+
+size_t MuxConnection::GetSendQueueDepth()
+{
+    return transport_->GetQueuedBytes(channelRequest_.moduleType);
+}
+
+bool MuxConnection::GetLinkStats(ChannelLinkStats &stats)
+{
+    return transport_->GetLinkStats(channelRequest_.moduleType, stats);
+}
+} // namespace CastEngineService
+} // namespace CastEngine
+} // namespace OHOS
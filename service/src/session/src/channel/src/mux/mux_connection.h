@@ -0,0 +1,70 @@
+/*
+ * Copyright (C) 2023-2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * Description: channel of one module type carried as a stream of the mux transport.
+ * Author: zhangge
+ * Create: 2023-06-05
+ */
+
+#ifndef MUX_CONNECTION_H
+#define MUX_CONNECTION_H
+
+#include <atomic>
+#include <memory>
+#include <string>
+
+#include "connection.h"
+#include "channel.h"
+#include "mux_transport.h"
+
+namespace OHOS {
+namespace CastEngine {
+namespace CastEngineService {
+class MuxConnection : public Connection, public Channel, public std::enable_shared_from_this<MuxConnection> {
+public:
+    using Connection::channelRequest_;
+
+    explicit MuxConnection(std::shared_ptr<MuxTransport> transport) : transport_(transport) {};
+    ~MuxConnection() override;
+
+    int StartConnection(const ChannelRequest &request, std::shared_ptr<IChannelListener> channelListener) override;
+    int StartListen(const ChannelRequest &request, std::shared_ptr<IChannelListener> channelListener) override;
+    void CloseConnection() override;
+    bool Send(const uint8_t *buf, int bufLen) override;
+    size_t GetSendQueueDepth() override;
+    bool GetLinkStats(ChannelLinkStats &stats) override;
+    std::string GetType() override
+    {
+        return "MUX";
+    }
+
+    // The tcp media server learns of the audio channel from a second accept, the mux one from its OPEN.
+    std::shared_ptr<MuxConnection> CreateAudioStream();
+    void OnStreamOpened();
+    void OnStreamData(const uint8_t *buf, int bufLen);
+    void OnStreamError(int errorCode);
+    void OnSendQueueWatermark(bool isAboveHighWatermark, size_t queuedBytes);
+
+private:
+    static constexpr int RET_OK = 0;
+    static constexpr int RET_ERR = -1;
+
+    std::shared_ptr<MuxTransport> transport_;
+    std::atomic<bool> isOpened_{ false };
+    std::atomic<bool> isClosed_{ false };
+};
+} // namespace CastEngineService
+} // namespace CastEngine
+} // namespace OHOS
+
+#endif
@@ -0,0 +1,148 @@
+/*
+ * Copyright (C) 2023-2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * Description: send queues of the mux transport, strict priority between classes and deficit round robin inside one.
+ * Author: zhangge
+ * Create: 2023-06-05
+ */
+
+#include "mux_send_scheduler.h"
+
+#include <algorithm>
+
+namespace OHOS {
+namespace CastEngine {
+namespace CastEngineService {
+MuxSendScheduler::Priority MuxSendScheduler::GetPriority(ModuleType moduleType)
+{
+    // RTSP and remote control never ride the mux, they keep their own tcp connection, see CastSessionImpl.
+    switch (moduleType) {
+        case ModuleType::AUTH:
+        case ModuleType::RTCP:
+            return Priority::CONTROL;
+        case ModuleType::AUDIO:
+            return Priority::AUDIO;
+        case ModuleType::VIDEO:
+            return Priority::VIDEO;
+        default:
+            return Priority::BULK;
+    }
+}
+
+void MuxSendScheduler::PushUrgent(Frame frame)
+{
+    urgent_.push_back(std::move(frame));
+}
+
+bool MuxSendScheduler::Push(uint8_t streamId, Priority priority, Frame frame)
+{
+    auto &queue = streams_[streamId];
+    if (queue.frames.empty()) {
+        queue.priority = priority;
+        queue.deficit = 0;
+        rounds_[static_cast<size_t>(priority)].push_back(streamId);
+    }
+    queue.queuedBytes += frame.bytes.size();
+    queue.frames.push_back(std::move(frame));
+    if (queue.isAboveHighWatermark || queue.queuedBytes < HIGH_WATERMARK) {
+        return false;
+    }
+    queue.isAboveHighWatermark = true;
+    return true;
+}
+
+bool MuxSendScheduler::Pop(const SendableChecker &isSendable, Popped &popped)
+{
+    if (!urgent_.empty()) {
+        popped = Popped{ std::move(urgent_.front()) };
+        urgent_.pop_front();
+        return true;
+    }
+
+    for (auto &round : rounds_) {
+        // One pass over the class at most, a stream blocked by flow control just gives up its turn.
+        for (size_t visited = 0; visited < round.size(); visited++) {
+            uint8_t streamId = round.front();
+            auto &queue = streams_[streamId];
+            if (!isSendable(streamId, queue.frames.front())) {
+                round.pop_front();
+                round.push_back(streamId);
+                continue;
+            }
+            size_t frameLen = queue.frames.front().bytes.size();
+            if (queue.deficit < frameLen) {
+                // The stream starts its turn; a frame larger than the quantum is let through on its own.
+                queue.deficit = std::max(queue.deficit + quantum_, frameLen);
+            }
+            popped = Popped{ std::move(queue.frames.front()), true, streamId, queue.priority };
+            queue.frames.pop_front();
+            queue.deficit -= frameLen;
+            queue.queuedBytes -= frameLen;
+            if (queue.isAboveHighWatermark && queue.queuedBytes <= LOW_WATERMARK) {
+                queue.isAboveHighWatermark = false;
+                popped.isBelowLowWatermark = true;
+            }
+            if (queue.frames.empty()) {
+                round.pop_front();
+                streams_.erase(streamId);
+            } else if (queue.deficit < queue.frames.front().bytes.size()) {
+                round.pop_front();
+                round.push_back(streamId);
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
+bool MuxSendScheduler::HasSendable(const SendableChecker &isSendable) const
+{
+    if (!urgent_.empty()) {
+        return true;
+    }
+    for (const auto &[streamId, queue] : streams_) {
+        if (isSendable(streamId, queue.frames.front())) {
+            return true;
+        }
+    }
+    return false;
+}
+
+size_t MuxSendScheduler::GetQueuedBytes(uint8_t streamId) const
+{
+    auto it = streams_.find(streamId);
+    return it == streams_.end() ? 0 : it->second.queuedBytes;
+}
+
+void MuxSendScheduler::Drop(uint8_t streamId)
+{
+    auto it = streams_.find(streamId);
+    if (it == streams_.end()) {
+        return;
+    }
+    auto &round = rounds_[static_cast<size_t>(it->second.priority)];
+    round.erase(std::remove(round.begin(), round.end(), streamId), round.end());
+    streams_.erase(it);
+}
+
+void MuxSendScheduler::Clear()
+{
+    urgent_.clear();
+    streams_.clear();
+    for (auto &round : rounds_) {
+        round.clear();
+    }
+}
+} // namespace CastEngineService
+} // namespace CastEngine
+} // namespace OHOS
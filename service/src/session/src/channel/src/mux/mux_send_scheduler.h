@@ -0,0 +1,110 @@
+/*
+ * Copyright (C) 2023-2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * Description: send queues of the mux transport, strict priority between classes and deficit round robin inside one.
+ * Author: zhangge
+ * Create: 2023-06-05
+ */
+
+#ifndef MUX_SEND_SCHEDULER_H
+#define MUX_SEND_SCHEDULER_H
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "channel_info.h"
+
+namespace OHOS {
+namespace CastEngine {
+namespace CastEngineService {
+/*
+ * Holds the frames waiting for the writer of the mux transport. Transport level frames (OPEN, OPEN_ACK,
+ * WINDOW_UPDATE) go out before anything else. The frames of a stream keep their order and its stream is served
+ * by its class: a class is only served while every higher class is idle or blocked by flow control, and the streams
+ * of one class share it by deficit round robin, each getting up to one quantum of bytes per round.
+ *
+ * The bytes queued per stream are checked against two watermarks: Push reports the stream crossing the high one
+ * and Pop reports it falling back to the low one, so a producer can pause in between. Not thread safe, the mux
+ * transport calls it under its own lock.
+ */
+class MuxSendScheduler {
+public:
+    enum class Priority : uint8_t {
+        CONTROL,
+        AUDIO,
+        VIDEO,
+        BULK,
+    };
+
+    struct Frame {
+        std::vector<uint8_t> bytes;
+        // Payload bytes charged to the flow control window of the stream, 0 for a frame that bypasses it.
+        uint32_t credit{ 0 };
+        std::chrono::steady_clock::time_point queuedTime;
+    };
+
+    struct Popped {
+        Frame frame;
+        bool hasStream{ false };
+        uint8_t streamId{ 0 };
+        Priority priority{ Priority::CONTROL };
+        bool isBelowLowWatermark{ false };
+    };
+
+    // Whether the head frame of the stream may go now.
+    using SendableChecker = std::function<bool(uint8_t streamId, const Frame &frame)>;
+
+    static constexpr size_t HIGH_WATERMARK = 1024 * 1024;
+    static constexpr size_t LOW_WATERMARK = 256 * 1024;
+
+    explicit MuxSendScheduler(size_t quantum) : quantum_(quantum) {}
+    ~MuxSendScheduler() = default;
+
+    static Priority GetPriority(ModuleType moduleType);
+
+    void PushUrgent(Frame frame);
+    bool Push(uint8_t streamId, Priority priority, Frame frame);
+    bool Pop(const SendableChecker &isSendable, Popped &popped);
+    bool HasSendable(const SendableChecker &isSendable) const;
+    size_t GetQueuedBytes(uint8_t streamId) const;
+    void Drop(uint8_t streamId);
+    void Clear();
+
+private:
+    static constexpr size_t PRIORITY_COUNT = 4;
+
+    struct StreamQueue {
+        Priority priority{ Priority::BULK };
+        std::deque<Frame> frames;
+        size_t queuedBytes{ 0 };
+        size_t deficit{ 0 };
+        bool isAboveHighWatermark{ false };
+    };
+
+    size_t quantum_;
+    std::deque<Frame> urgent_;
+    std::map<uint8_t, StreamQueue> streams_;
+    // The active streams of each class in round robin order, the one at the front is being served.
+    std::array<std::deque<uint8_t>, PRIORITY_COUNT> rounds_;
+};
+} // namespace CastEngineService
+} // namespace CastEngine
+} // namespace OHOS
+
+#endif
@@ -0,0 +1,621 @@
+/*
+ * Copyright (C) 2023-2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * Description: one tcp transport per peer carrying every channel of the session as a stream.
+ * Author: zhangge
+ * Create: 2023-06-05
+ */
+
+#include "mux_transport.h"
+
+#include <algorithm>
+#include <thread>
+
+#include "cast_engine_log.h"
+#include "cast_engine_metrics.h"
+#include "mux_connection.h"
+#include "utils.h"
+
+namespace OHOS {
+namespace CastEngine {
+namespace CastEngineService {
+DEFINE_CAST_ENGINE_LABEL("Cast-MuxTransport");
+
+MuxTransport::~MuxTransport()
+{
+    CLOGD("Enter.");
+}
+
+void MuxTransport::ConfigSocket()
+{
+    socket_.SetSendBufferSize(SOCKET_SEND_BUFFER_SIZE);
+    socket_.SetRecvBufferSize(SOCKET_RECV_BUFFER_SIZE);
+    socket_.SetKeepAlive();
+    socket_.SetReuseAddr();
+}
+
+int MuxTransport::Listen(const ChannelRequest &request)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        // Any later channel rides on the transport; its port only has to reach the peer, which has it already.
+        if (state_ != State::IDLE) {
+            return port_;
+        }
+        ConfigSocket();
+        int port = socket_.Bind(request.localDeviceInfo.ipAddress, request.localPort);
+        if (port == INVALID_PORT || !socket_.Listen(SOMAXCONN)) {
+            CLOGE("Mux listen failed.");
+            return INVALID_PORT;
+        }
+        CLOGI("Start mux server socket, bindPort:%{public}s", Utils::Mask(std::to_string(port)).c_str());
+        port_ = port;
+        state_ = State::LISTENING;
+    }
+
+    auto transport = shared_from_this();
+    std::thread([transport] {
+        Utils::SetThreadName("MuxAccept");
+        transport->Accept();
+    }).detach();
+    return port_;
+}
+
+void MuxTransport::Accept()
+{
+    int fd = socket_.Accept();
+    if (fd == INVALID_SOCKET) {
+        OnTransportError(RET_ERR);
+        return;
+    }
+    socket_.SetIPTOS(fd);
+    OnConnected(fd);
+    ReadLooper();
+}
+
+void MuxTransport::Connect(const ChannelRequest &request)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (state_ != State::IDLE) {
+            return;
+        }
+        ConfigSocket();
+        port_ = request.remotePort;
+        state_ = State::CONNECTING;
+    }
+
+    auto transport = shared_from_this();
+    std::string localIp = request.localDeviceInfo.ipAddress;
+    std::string remoteIp = request.remoteDeviceInfo.ipAddress;
+    int localPort = request.localPort;
+    int remotePort = request.remotePort;
+    std::thread([transport, localIp, localPort, remoteIp, remotePort] {
+        Utils::SetThreadName("MuxConnect");
+        transport->DoConnect(localIp, localPort, remoteIp, remotePort);
+    }).detach();
+}
+
+void MuxTransport::DoConnect(const std::string &localIp, int localPort, const std::string &remoteIp, int remotePort)
+{
+    socket_.Bind(localIp, localPort);
+    socket_.SetIPTOS(socket_.GetSocketFd());
+    if (remoteIp.empty() || remotePort == INVALID_PORT || !socket_.Connect(remoteIp, remotePort)) {
+        CLOGE("Mux connect failed.");
+        OnTransportError(RET_ERR);
+        return;
+    }
+    OnConnected(socket_.GetSocketFd());
+    ReadLooper();
+}
+
+void MuxTransport::OnConnected(int fd)
+{
+    std::vector<uint8_t> pendingOpens;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (state_ == State::CLOSED) {
+            return;
+        }
+        peerFd_ = fd;
+        state_ = State::CONNECTED;
+        for (const auto &[streamId, stream] : streams_) {
+            if (stream.isInitiator && !stream.isOpen) {
+                pendingOpens.push_back(streamId);
+            }
+        }
+    }
+    socket_.SetNotSentLowat(fd, SOCKET_NOT_SENT_LOWAT);
+    // The writer hands over whole frames already, an OPEN or WINDOW_UPDATE must not wait for a delayed ack.
+    socket_.SetNoDelay(fd);
+    CLOGI("Mux transport connected, %{public}zu streams waiting", pendingOpens.size());
+    for (uint8_t streamId : pendingOpens) {
+        SendFrame(FrameType::OPEN, streamId, nullptr, 0);
+    }
+
+    auto transport = shared_from_this();
+    std::thread([transport] {
+        Utils::SetThreadName("MuxWriter");
+        transport->WriteLooper();
+    }).detach();
+}
+
+void MuxTransport::ReadLooper()
+{
+    uint8_t header[FRAME_HEADER_LEN] = {};
+    while (true) {
+        int fd = INVALID_SOCKET;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (state_ != State::CONNECTED) {
+                break;
+            }
+            fd = peerFd_;
+        }
+        ssize_t length = socket_.Recv(fd, header, FRAME_HEADER_LEN);
+        if (length == STOP_RECEIVE) {
+            break;
+        }
+        if (length != static_cast<ssize_t>(FRAME_HEADER_LEN)) {
+            OnTransportError(static_cast<int>(length));
+            return;
+        }
+        uint32_t dataLength = Utils::ByteArrayToInt(header + LENGTH_OFFSET, LENGTH_BYTES);
+        if (dataLength > ILLEGAL_LENGTH) {
+            CLOGE("Receive frame length is illegal.");
+            OnTransportError(RET_ERR);
+            return;
+        }
+        std::vector<uint8_t> payload(dataLength);
+        if (dataLength > 0) {
+            length = socket_.Recv(fd, payload.data(), dataLength);
+            if (length == STOP_RECEIVE) {
+                break;
+            }
+            if (length != static_cast<ssize_t>(dataLength)) {
+                OnTransportError(static_cast<int>(length));
+                return;
+            }
+        }
+        HandleFrame(static_cast<FrameType>(header[TYPE_OFFSET]), header[STREAM_ID_OFFSET], header[FLAGS_OFFSET],
+            payload.data(), dataLength);
+    }
+    CLOGI("ReadLooper Out.");
+}
+
+void MuxTransport::WriteLooper()
+{
+    static auto &controlWait = CastEngineMetrics::GetInstance().RegisterHistogram(METRIC_CHANNEL_CONTROL_QUEUE_WAIT_US);
+    auto isSendable = [this](uint8_t streamId, const MuxSendScheduler::Frame &frame) {
+        return IsSendableLocked(streamId, frame);
+    };
+    while (true) {
+        MuxSendScheduler::Popped popped;
+        std::shared_ptr<MuxConnection> drained;
+        size_t queuedBytes = 0;
+        int fd = INVALID_SOCKET;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cond_.wait(lock, [this, &isSendable] {
+                return state_ != State::CONNECTED || scheduler_.HasSendable(isSendable);
+            });
+            if (state_ != State::CONNECTED || !scheduler_.Pop(isSendable, popped)) {
+                break;
+            }
+            auto it = popped.hasStream ? streams_.find(popped.streamId) : streams_.end();
+            if (it != streams_.end()) {
+                it->second.sendCredit -= popped.frame.credit;
+                it->second.sentBytes += popped.frame.credit;
+                if (popped.isBelowLowWatermark) {
+                    drained = it->second.connection;
+                    queuedBytes = scheduler_.GetQueuedBytes(popped.streamId);
+                }
+            }
+            fd = peerFd_;
+            // A Send blocked on a full queue may go on.
+            cond_.notify_all();
+        }
+        if (popped.hasStream && popped.priority == MuxSendScheduler::Priority::CONTROL) {
+            controlWait.Record(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - popped.frame.queuedTime).count()));
+        }
+        if (!WriteFrame(fd, popped.frame.bytes)) {
+            OnTransportError(RET_ERR);
+            return;
+        }
+        if (drained) {
+            drained->OnSendQueueWatermark(false, queuedBytes);
+        }
+    }
+    CLOGI("WriteLooper Out.");
+}
+
+bool MuxTransport::IsSendableLocked(uint8_t streamId, const MuxSendScheduler::Frame &frame)
+{
+    if (frame.credit == 0) {
+        return true;
+    }
+    auto it = streams_.find(streamId);
+    // What a removed stream left queued is flushed ahead of its CLOSE, there is no window to wait for anymore.
+    return it == streams_.end() || (it->second.isOpen && it->second.sendCredit > 0);
+}
+
+void MuxTransport::HandleFrame(FrameType type, uint8_t streamId, uint8_t flags, const uint8_t *payload,
+    uint32_t length)
+{
+    switch (type) {
+        case FrameType::OPEN:
+            HandleOpen(streamId);
+            break;
+        case FrameType::OPEN_ACK:
+            HandleOpenAck(streamId);
+            break;
+        case FrameType::DATA:
+            HandleData(streamId, flags, payload, length);
+            break;
+        case FrameType::WINDOW_UPDATE:
+            HandleWindowUpdate(streamId, payload, length);
+            break;
+        case FrameType::CLOSE:
+            HandleClose(streamId);
+            break;
+        default:
+            CLOGW("Unknown frame type %{public}u", static_cast<uint32_t>(type));
+            break;
+    }
+}
+
+void MuxTransport::HandleOpen(uint8_t streamId)
+{
+    partialData_.erase(streamId);
+    std::shared_ptr<MuxConnection> connection;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = streams_.find(streamId);
+        if (it == streams_.end() && streamId == static_cast<uint8_t>(ModuleType::AUDIO)) {
+            auto video = streams_.find(static_cast<uint8_t>(ModuleType::VIDEO));
+            if (video != streams_.end() && !video->second.isInitiator && video->second.connection) {
+                it = streams_.emplace(streamId, Stream{ video->second.connection->CreateAudioStream() }).first;
+            }
+        }
+        if (it == streams_.end()) {
+            earlyOpens_.insert(streamId);
+            return;
+        }
+        if (it->second.isInitiator || it->second.isOpen) {
+            return;
+        }
+        it->second.isOpen = true;
+        it->second.sendCredit = STREAM_WINDOW;
+        connection = it->second.connection;
+    }
+    SendFrame(FrameType::OPEN_ACK, streamId, nullptr, 0);
+    CLOGI("Stream %{public}u opened by peer", streamId);
+    connection->OnStreamOpened();
+}
+
+void MuxTransport::HandleOpenAck(uint8_t streamId)
+{
+    partialData_.erase(streamId);
+    std::shared_ptr<MuxConnection> connection;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = streams_.find(streamId);
+        if (it == streams_.end() || !it->second.isInitiator || it->second.isOpen) {
+            return;
+        }
+        it->second.isOpen = true;
+        it->second.sendCredit = STREAM_WINDOW;
+        connection = it->second.connection;
+        cond_.notify_all();
+    }
+    CLOGI("Stream %{public}u opened", streamId);
+    connection->OnStreamOpened();
+}
+
+void MuxTransport::HandleData(uint8_t streamId, uint8_t flags, const uint8_t *payload, uint32_t length)
+{
+    std::shared_ptr<MuxConnection> connection;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = streams_.find(streamId);
+        if (it == streams_.end() || !it->second.isOpen) {
+            return;
+        }
+        connection = it->second.connection;
+    }
+    auto partial = partialData_.find(streamId);
+    if ((flags & FLAG_MORE) != 0 || partial != partialData_.end()) {
+        auto &message = partialData_[streamId];
+        if (message.size() + length > ILLEGAL_LENGTH) {
+            CLOGE("Stream %{public}u message length is illegal.", streamId);
+            partialData_.erase(streamId);
+            OnTransportError(RET_ERR);
+            return;
+        }
+        message.insert(message.end(), payload, payload + length);
+        if ((flags & FLAG_MORE) == 0) {
+            std::vector<uint8_t> whole;
+            whole.swap(message);
+            partialData_.erase(streamId);
+            connection->OnStreamData(whole.data(), static_cast<int>(whole.size()));
+        }
+    } else {
+        connection->OnStreamData(payload, static_cast<int>(length));
+    }
+
+    // Grant the credit back only once the data left the transport, so a stalled consumer throttles its sender.
+    uint32_t grant = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = streams_.find(streamId);
+        if (it == streams_.end()) {
+            return;
+        }
+        it->second.unacked += length;
+        if (it->second.unacked >= STREAM_WINDOW / 2) {
+            grant = it->second.unacked;
+            it->second.unacked = 0;
+        }
+    }
+    if (grant > 0) {
+        uint8_t buf[LENGTH_BYTES] = {};
+        Utils::IntToByteArray(static_cast<int>(grant), LENGTH_BYTES, buf);
+        SendFrame(FrameType::WINDOW_UPDATE, streamId, buf, LENGTH_BYTES);
+    }
+}
+
+void MuxTransport::HandleWindowUpdate(uint8_t streamId, const uint8_t *payload, uint32_t length)
+{
+    if (length != LENGTH_BYTES) {
+        return;
+    }
+    uint32_t grant = Utils::ByteArrayToInt(payload, LENGTH_BYTES);
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = streams_.find(streamId);
+    if (it != streams_.end()) {
+        it->second.sendCredit += grant;
+        cond_.notify_all();
+    }
+}
+
+void MuxTransport::HandleClose(uint8_t streamId)
+{
+    std::shared_ptr<MuxConnection> connection;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        earlyOpens_.erase(streamId);
+        auto it = streams_.find(streamId);
+        if (it == streams_.end()) {
+            return;
+        }
+        connection = it->second.connection;
+        streams_.erase(it);
+        scheduler_.Drop(streamId);
+        cond_.notify_all();
+    }
+    partialData_.erase(streamId);
+    CLOGI("Stream %{public}u closed by peer", streamId);
+    if (connection) {
+        connection->OnStreamError(RET_ERR);
+    }
+}
+
+void MuxTransport::OnTransportError(int errorCode)
+{
+    std::map<uint8_t, Stream> streams;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (state_ == State::CLOSED) {
+            return;
+        }
+        state_ = State::CLOSED;
+        streams.swap(streams_);
+        scheduler_.Clear();
+        cond_.notify_all();
+    }
+    CLOGE("Mux transport lost, error = %{public}d, %{public}zu streams affected", errorCode, streams.size());
+    for (auto &[streamId, stream] : streams) {
+        if (stream.connection) {
+            stream.connection->OnStreamError(errorCode);
+        }
+    }
+}
+
+bool MuxTransport::AddStream(ModuleType moduleType, std::shared_ptr<MuxConnection> stream, bool isInitiator)
+{
+    uint8_t streamId = static_cast<uint8_t>(moduleType);
+    bool needOpen = false;
+    bool isOpenedEarly = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (state_ == State::CLOSED) {
+            return false;
+        }
+        Stream entry{ stream, isInitiator };
+        if (isInitiator) {
+            needOpen = state_ == State::CONNECTED;
+        } else if (earlyOpens_.erase(streamId) > 0) {
+            entry.isOpen = true;
+            entry.sendCredit = STREAM_WINDOW;
+            isOpenedEarly = true;
+        }
+        streams_[streamId] = entry;
+    }
+    if (needOpen) {
+        SendFrame(FrameType::OPEN, streamId, nullptr, 0);
+    }
+    if (isOpenedEarly) {
+        SendFrame(FrameType::OPEN_ACK, streamId, nullptr, 0);
+        // Reported asynchronously like every other connection, never from inside CreateChannel.
+        std::thread([stream] {
+            Utils::SetThreadName("MuxStreamOpen");
+            stream->OnStreamOpened();
+        }).detach();
+    }
+    return true;
+}
+
+void MuxTransport::RemoveStream(ModuleType moduleType)
+{
+    uint8_t streamId = static_cast<uint8_t>(moduleType);
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = streams_.find(streamId);
+    if (it == streams_.end()) {
+        return;
+    }
+    bool needClose = state_ == State::CONNECTED && it->second.isOpen;
+    streams_.erase(it);
+    if (needClose) {
+        // Queued behind the data of the stream, so the peer still gets what was sent before the close.
+        scheduler_.Push(streamId, MuxSendScheduler::GetPriority(moduleType),
+            { BuildFrame(FrameType::CLOSE, streamId, 0, nullptr, 0), 0, std::chrono::steady_clock::now() });
+    } else {
+        scheduler_.Drop(streamId);
+    }
+    cond_.notify_all();
+}
+
+bool MuxTransport::Send(ModuleType moduleType, const uint8_t *buf, int bufLen)
+{
+    static auto &backpressure = CastEngineMetrics::GetInstance().RegisterCounter(METRIC_CHANNEL_SEND_BACKPRESSURE);
+    uint8_t streamId = static_cast<uint8_t>(moduleType);
+    auto priority = MuxSendScheduler::GetPriority(moduleType);
+    bool isAboveHighWatermark = false;
+    size_t queuedBytes = 0;
+    std::shared_ptr<MuxConnection> connection;
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        auto isWritable = [this, streamId] {
+            return state_ != State::CONNECTED || scheduler_.GetQueuedBytes(streamId) < SEND_QUEUE_LIMIT;
+        };
+        if (!cond_.wait_for(lock, std::chrono::milliseconds(SEND_BLOCK_TIMEOUT_MS), isWritable)) {
+            CLOGW("Stream %{public}u send queue is full", streamId);
+            return false;
+        }
+        auto it = streams_.find(streamId);
+        if (state_ != State::CONNECTED || it == streams_.end() || !it->second.isOpen) {
+            return false;
+        }
+        auto now = std::chrono::steady_clock::now();
+        for (int offset = 0; offset < bufLen; offset += MAX_FRAME_PAYLOAD) {
+            int length = std::min(MAX_FRAME_PAYLOAD, bufLen - offset);
+            uint8_t flags = offset + length < bufLen ? FLAG_MORE : 0;
+            MuxSendScheduler::Frame frame{ BuildFrame(FrameType::DATA, streamId, flags, buf + offset,
+                static_cast<uint32_t>(length)), static_cast<uint32_t>(length), now };
+            isAboveHighWatermark = scheduler_.Push(streamId, priority, std::move(frame)) || isAboveHighWatermark;
+        }
+        queuedBytes = scheduler_.GetQueuedBytes(streamId);
+        connection = it->second.connection;
+        cond_.notify_all();
+    }
+    if (isAboveHighWatermark) {
+        backpressure.Add();
+        CLOGD("Stream %{public}u queued %{public}zu bytes, above high watermark", streamId, queuedBytes);
+        connection->OnSendQueueWatermark(true, queuedBytes);
+    }
+    return true;
+}
+
+size_t MuxTransport::GetQueuedBytes(ModuleType moduleType)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return scheduler_.GetQueuedBytes(static_cast<uint8_t>(moduleType));
+}
+
+bool MuxTransport::GetLinkStats(ModuleType moduleType, ChannelLinkStats &stats)
+{
+    int fd = INVALID_SOCKET;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = streams_.find(static_cast<uint8_t>(moduleType));
+        if (state_ != State::CONNECTED || it == streams_.end()) {
+            return false;
+        }
+        stats.sentBytes = it->second.sentBytes;
+        fd = peerFd_;
+    }
+    return socket_.GetLinkStats(fd, stats);
+}
+
+std::vector<uint8_t> MuxTransport::BuildFrame(FrameType type, uint8_t streamId, uint8_t flags,
+    const uint8_t *payload, uint32_t length)
+{
+    std::vector<uint8_t> frame(FRAME_HEADER_LEN + length, 0);
+    frame[TYPE_OFFSET] = static_cast<uint8_t>(type);
+    frame[STREAM_ID_OFFSET] = streamId;
+    frame[FLAGS_OFFSET] = flags;
+    Utils::IntToByteArray(static_cast<int>(length), LENGTH_BYTES, frame.data() + LENGTH_OFFSET);
+    if (payload != nullptr && length > 0) {
+        std::copy(payload, payload + length, frame.begin() + FRAME_HEADER_LEN);
+    }
+    return frame;
+}
+
+bool MuxTransport::SendFrame(FrameType type, uint8_t streamId, const uint8_t *payload, uint32_t length)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (state_ != State::CONNECTED) {
+        return false;
+    }
+    scheduler_.PushUrgent({ BuildFrame(type, streamId, 0, payload, length), 0, std::chrono::steady_clock::now() });
+    cond_.notify_all();
+    return true;
+}
+
+bool MuxTransport::WriteFrame(int fd, const std::vector<uint8_t> &frame)
+{
+    size_t sent = 0;
+    while (sent < frame.size()) {
+        int ret = socket_.Send(fd, frame.data() + sent, frame.size() - sent);
+        if (ret <= RET_OK) {
+            return false;
+        }
+        sent += static_cast<size_t>(ret);
+    }
+    return true;
+}
+
+bool MuxTransport::IsClosed()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return state_ == State::CLOSED;
+}
+
+void MuxTransport::Close()
+{
+    int fd = INVALID_SOCKET;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (state_ == State::CLOSED) {
+            return;
+        }
+        state_ = State::CLOSED;
+        fd = peerFd_;
+        peerFd_ = INVALID_SOCKET;
+        streams_.clear();
+        earlyOpens_.clear();
+        scheduler_.Clear();
+        cond_.notify_all();
+    }
+    CLOGI("Mux transport closed.");
+    if (fd != INVALID_SOCKET && fd != socket_.GetSocketFd()) {
+        socket_.Shutdown(fd);
+    }
+    // Also wakes up a pending accept or recv on the socket itself.
+    ::shutdown(socket_.GetSocketFd(), SHUT_RDWR);
+    socket_.Close();
+}
+} // namespace CastEngineService
+} // namespace CastEngine
+} // namespace OHOS
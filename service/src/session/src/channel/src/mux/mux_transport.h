@@ -0,0 +1,155 @@
+/*
+ * Copyright (C) 2023-2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * Description: one tcp transport per peer carrying every channel of the session as a stream.
+ * Author: zhangge
+ * Create: 2023-06-05
+ */
+
+#ifndef MUX_TRANSPORT_H
+#define MUX_TRANSPORT_H
+
+#include <atomic>
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <vector>
+
+#include "channel_info.h"
+#include "channel_request.h"
+#include "mux_send_scheduler.h"
+#include "tcp_socket.h"
+
+namespace OHOS {
+namespace CastEngine {
+namespace CastEngineService {
+class MuxConnection;
+
+/*
+ * Used once both ends negotiated FEATURE_CHANNEL_MUX. The first mux channel of the session sets up the tcp
+ * connection with its own listen or connect role and port; every later channel is a stream on it, keyed by its
+ * ModuleType, so it costs an OPEN frame instead of a connect round trip and a reader thread. The side that would
+ * have connected sends OPEN, the side that would have listened answers OPEN_ACK. Each stream may have at most
+ * STREAM_WINDOW bytes in flight, the receiver grants them back with WINDOW_UPDATE once they are delivered, so a
+ * slow consumer stalls its own stream only.
+ *
+ * Send only queues the message, cut into frames of at most MAX_FRAME_PAYLOAD bytes, and one writer thread puts the
+ * frames on the socket in the order of MuxSendScheduler, so a large file response no longer holds back an rtsp or
+ * remote control message for more than one frame. The stream is told when its queue crosses the high watermark and
+ * when it drains to the low one; Send itself only blocks once SEND_QUEUE_LIMIT bytes are queued.
+ *
+ * Frame: type(1) streamId(1) flags(1) reserved(1) length(4) payload(length)
+ */
+class MuxTransport : public std::enable_shared_from_this<MuxTransport> {
+public:
+    MuxTransport() = default;
+    ~MuxTransport();
+
+    int Listen(const ChannelRequest &request);
+    void Connect(const ChannelRequest &request);
+    bool AddStream(ModuleType moduleType, std::shared_ptr<MuxConnection> stream, bool isInitiator);
+    void RemoveStream(ModuleType moduleType);
+    bool Send(ModuleType moduleType, const uint8_t *buf, int bufLen);
+    size_t GetQueuedBytes(ModuleType moduleType);
+    // The bytes are those of the stream, the tcp figures those of the shared connection.
+    bool GetLinkStats(ModuleType moduleType, ChannelLinkStats &stats);
+    bool IsClosed();
+    void Close();
+
+private:
+    enum class FrameType : uint8_t {
+        OPEN = 1,
+        OPEN_ACK = 2,
+        DATA = 3,
+        CLOSE = 4,
+        WINDOW_UPDATE = 5,
+    };
+
+    enum class State {
+        IDLE,
+        LISTENING,
+        CONNECTING,
+        CONNECTED,
+        CLOSED,
+    };
+
+    struct Stream {
+        std::shared_ptr<MuxConnection> connection;
+        bool isInitiator{ false };
+        bool isOpen{ false };
+        int64_t sendCredit{ 0 };
+        uint32_t unacked{ 0 };
+        uint64_t sentBytes{ 0 };
+    };
+
+    static constexpr int RET_OK = 0;
+    static constexpr int RET_ERR = -1;
+    static constexpr int STOP_RECEIVE = -2;
+    static constexpr int INVALID_SOCKET = -1;
+    static constexpr size_t FRAME_HEADER_LEN = 8;
+    static constexpr size_t TYPE_OFFSET = 0;
+    static constexpr size_t STREAM_ID_OFFSET = 1;
+    static constexpr size_t FLAGS_OFFSET = 2;
+    static constexpr size_t LENGTH_OFFSET = 4;
+    static constexpr unsigned int LENGTH_BYTES = 4;
+    static constexpr uint32_t ILLEGAL_LENGTH = 10 * 1024 * 1024;
+    // More frames of the same message follow.
+    static constexpr uint8_t FLAG_MORE = 0x01;
+    static constexpr int MAX_FRAME_PAYLOAD = 64 * 1024;
+    static constexpr size_t SEND_QUEUE_LIMIT = 4 * MuxSendScheduler::HIGH_WATERMARK;
+    static constexpr int64_t STREAM_WINDOW = 1024 * 1024;
+    static constexpr int SEND_BLOCK_TIMEOUT_MS = 3000;
+    static constexpr int SOCKET_SEND_BUFFER_SIZE = 512 * 1024;
+    static constexpr int SOCKET_RECV_BUFFER_SIZE = 10 * 1024 * 1024;
+    // Keeps the unsent backlog in the scheduler rather than in the kernel, where it could not be reordered.
+    static constexpr int SOCKET_NOT_SENT_LOWAT = 128 * 1024;
+
+    void ConfigSocket();
+    void Accept();
+    void DoConnect(const std::string &localIp, int localPort, const std::string &remoteIp, int remotePort);
+    void OnConnected(int fd);
+    void ReadLooper();
+    void WriteLooper();
+    void HandleFrame(FrameType type, uint8_t streamId, uint8_t flags, const uint8_t *payload, uint32_t length);
+    void HandleOpen(uint8_t streamId);
+    void HandleOpenAck(uint8_t streamId);
+    void HandleData(uint8_t streamId, uint8_t flags, const uint8_t *payload, uint32_t length);
+    void HandleWindowUpdate(uint8_t streamId, const uint8_t *payload, uint32_t length);
+    void HandleClose(uint8_t streamId);
+    void OnTransportError(int errorCode);
+    bool SendFrame(FrameType type, uint8_t streamId, const uint8_t *payload, uint32_t length);
+    bool WriteFrame(int fd, const std::vector<uint8_t> &frame);
+    bool IsSendableLocked(uint8_t streamId, const MuxSendScheduler::Frame &frame);
+    static std::vector<uint8_t> BuildFrame(FrameType type, uint8_t streamId, uint8_t flags, const uint8_t *payload,
+        uint32_t length);
+
+    std::mutex mutex_;
+    std::condition_variable cond_;
+    State state_{ State::IDLE };
+    int port_{ INVALID_PORT };
+    int peerFd_{ INVALID_SOCKET };
+    std::map<uint8_t, Stream> streams_;
+    // OPENs that arrived before the local channel of their module was created.
+    std::set<uint8_t> earlyOpens_;
+    MuxSendScheduler scheduler_{ MAX_FRAME_PAYLOAD + FRAME_HEADER_LEN };
+    // Messages cut into several frames, only touched by the reader thread.
+    std::map<uint8_t, std::vector<uint8_t>> partialData_;
+    TcpSocket socket_;
+};
+} // namespace CastEngineService
+} // namespace CastEngine
+} // namespace OHOS
+
+#endif
@@ -27,6 +27,8 @@
 
 #include "cast_device_data_manager.h"
 #include "cast_engine_log.h"
+#include "cast_engine_metrics.h"
+#include "cast_trace.h"
 #include "securec.h"
 #include "transport.h"
 #include "utils.h"
@@ -210,6 +212,12 @@ void SoftBusConnection::OnConnectionBytesReceived(int sessionId, const void *dat
         return;
     }
 
+    static auto &rxBytes = CastEngineMetrics::GetInstance().RegisterCounter(METRIC_CHANNEL_RX_BYTES);
+    static auto &rxFrames = CastEngineMetrics::GetInstance().RegisterCounter(METRIC_CHANNEL_RX_FRAMES);
+    rxFrames.Add();
+    rxBytes.Add(dataLen);
+    CastTraceRecorder::GetInstance().Record(TraceRecordType::CHANNEL_RX,
+        static_cast<uint16_t>(softBusConn->GetRequest().moduleType), reinterpret_cast<const uint8_t *>(data), dataLen);
     channelListener->OnDataReceived(reinterpret_cast<const uint8_t *>(data), dataLen, 0);
     CLOGD("Out, sessionId = %{public}d, channelListener refCnt = %{public}ld.", sessionId, channelListener.use_count());
     return;
@@ -238,6 +246,10 @@ void SoftBusConnection::OnConnectionStreamReceived(int sessionId, const StreamDa
         return;
     }
 
+    static auto &rxBytes = CastEngineMetrics::GetInstance().RegisterCounter(METRIC_CHANNEL_RX_BYTES);
+    static auto &rxFrames = CastEngineMetrics::GetInstance().RegisterCounter(METRIC_CHANNEL_RX_FRAMES);
+    rxFrames.Add();
+    rxBytes.Add(data->bufLen);
     channelListener->OnDataReceived(reinterpret_cast<uint8_t *>(data->buf), static_cast<unsigned int>(data->bufLen), 0);
     CLOGD("Out, channelListener refCnt = %{public}ld, length = %{public}d.", channelListener.use_count(), data->bufLen);
 }
@@ -548,15 +560,30 @@ bool SoftBusConnection::Send(const uint8_t *buf, int bufLen)
         return false;
     }
 
+    static auto &txBytes = CastEngineMetrics::GetInstance().RegisterCounter(METRIC_CHANNEL_TX_BYTES);
+    static auto &txFrames = CastEngineMetrics::GetInstance().RegisterCounter(METRIC_CHANNEL_TX_FRAMES);
+    static auto &txErrors = CastEngineMetrics::GetInstance().RegisterCounter(METRIC_CHANNEL_TX_ERRORS);
+    static auto &sendTime = CastEngineMetrics::GetInstance().RegisterHistogram(METRIC_CHANNEL_SEND_US);
     int ret;
-    if (softbus_.GetSessionType() == TYPE_BYTES) {
-        CLOGD("SoftBus Send bytes.");
-        ret = softbus_.SendSoftBusBytes(buf, bufLen);
-    } else {
-        CLOGD("SoftBus Send stream.");
-        ret = softbus_.SendSoftBusStream(buf, bufLen);
+    {
+        MetricScopedTimer timer(sendTime);
+        if (softbus_.GetSessionType() == TYPE_BYTES) {
+            CLOGV("SoftBus Send bytes.");
+            ret = softbus_.SendSoftBusBytes(buf, bufLen);
+        } else {
+            CLOGV("SoftBus Send stream.");
+            ret = softbus_.SendSoftBusStream(buf, bufLen);
+        }
+    }
+    if (ret != 0) {
+        txErrors.Add();
+        return false;
     }
-    return (ret == 0) ? true : false;
+    txFrames.Add();
+    txBytes.Add(bufLen);
+    CastTraceRecorder::GetInstance().Record(TraceRecordType::CHANNEL_TX, static_cast<uint16_t>(GetRequest().moduleType),
+        buf, static_cast<uint32_t>(bufLen));
+    return true;
 }
 
 SoftBusWrapper &SoftBusConnection::GetSoftBus()
@@ -138,7 +138,7 @@ int SoftBusWrapper::SendSoftBusStream(const uint8_t *data, unsigned int len) con
     StreamData ext = {};
     StreamFrameInfo frameInfo = {};
 
-    StreamData streamData = { reinterpret_cast<char *>(const_cast<uint8_t *>(data)), len };
+    StreamData streamData = { reinterpret_cast<char *>(const_cast<uint8_t *>(data)), static_cast<int>(len) };
 
     return SendStream(softBusSessionId_, &streamData, &ext, &frameInfo);
 }
@@ -19,6 +19,8 @@
 #include "tcp_connection.h"
 
 #include "cast_engine_log.h"
+#include "cast_engine_metrics.h"
+#include "cast_trace.h"
 #include "securec.h"
 #include "transport.h"
 #include "utils.h"
@@ -216,9 +218,12 @@ void TcpConnection::HandleReceivedData(int socket)
         CLOGE("listener_ is nullptr.");
         return;
     }
+    static auto &rxBytes = CastEngineMetrics::GetInstance().RegisterCounter(METRIC_CHANNEL_RX_BYTES);
+    static auto &rxFrames = CastEngineMetrics::GetInstance().RegisterCounter(METRIC_CHANNEL_RX_FRAMES);
+    static auto &rxErrors = CastEngineMetrics::GetInstance().RegisterCounter(METRIC_CHANNEL_RX_ERRORS);
 
     while (isReceiving_) {
-        CLOGI("TCP Recv Data start.");
+        CLOGV("TCP Recv Data start.");
         int sockfd = socket == INVALID_SOCKET ? socket_.GetSocketFd() : socket;
         uint8_t header[PACKET_HEADER_LEN] = {};
         ssize_t length = socket_.Recv(sockfd, header, sizeof(header));
@@ -227,12 +232,14 @@ void TcpConnection::HandleReceivedData(int socket)
         }
         if (length != PACKET_HEADER_LEN) {
             CLOGE("Receive header data error.");
+            rxErrors.Add();
             listener->OnConnectionError(shared_from_this(), length);
             return;
         }
         uint32_t dataLength = GetReceivedDataLength(header, PACKET_HEADER_LEN);
         if (dataLength > ILLEGAL_LENGTH) {
             CLOGE("Receive payload data length is illegal.");
+            rxErrors.Add();
             listener->OnConnectionError(shared_from_this(), length);
             return;
         }
@@ -246,14 +253,19 @@ void TcpConnection::HandleReceivedData(int socket)
         }
         if (length != dataLength) {
             CLOGE("Receive payload data length is illegal.");
+            rxErrors.Add();
             listener->OnConnectionError(shared_from_this(), length);
             return;
         }
+        rxFrames.Add();
+        rxBytes.Add(PACKET_HEADER_LEN + dataLength);
+        CastTraceRecorder::GetInstance().Record(TraceRecordType::CHANNEL_RX,
+            static_cast<uint16_t>(channelRequest_.moduleType), buf.get(), dataLength);
         if (channelRequest_.moduleType == ModuleType::REMOTE_CONTROL) {
             HandleRemoteControlReceivedData(dataLength, header, buf.get());
             continue;
         }
-        CLOGD("TCP recvFrameLen done, dataLength = %{public}d", dataLength);
+        CLOGV("TCP recvFrameLen done, dataLength = %{public}u", dataLength);
         if (GetListener()) {
             GetListener()->OnDataReceived(buf.get(), dataLength, 0);
         }
@@ -286,7 +298,7 @@ void TcpConnection::HandleRemoteControlReceivedData(uint32_t dataLength, uint8_t
         return;
     }
 
-    CLOGI("TCP recv remote control done, dataLength = %{public}d", PACKET_HEADER_LEN + dataLength);
+    CLOGV("TCP recv remote control done, dataLength = %{public}d", PACKET_HEADER_LEN + dataLength);
     if (GetListener()) {
         GetListener()->OnDataReceived(controlBuf.get(), PACKET_HEADER_LEN + dataLength, 0);
     }
@@ -314,7 +326,7 @@ void TcpConnection::CloseConnection()
 
 bool TcpConnection::Send(const uint8_t *buf, int bufLen)
 {
-    CLOGD("Tcp Send Enter, len = %{public}d", bufLen);
+    CLOGV("Tcp Send Enter, len = %{public}d", bufLen);
     if (buf == nullptr || bufLen <= 0) {
         CLOGE("Data or length is illegal.");
         return false;
@@ -327,15 +339,39 @@ bool TcpConnection::Send(const uint8_t *buf, int bufLen)
         return false;
     }
 
-    CLOGD("Tcp Send, socket = %{public}d, moduleType = %{public}d", remoteSocket_, channelRequest_.moduleType);
+    CLOGV("Tcp Send, socket = %{public}d, moduleType = %{public}d", remoteSocket_, channelRequest_.moduleType);
+    static auto &txBytes = CastEngineMetrics::GetInstance().RegisterCounter(METRIC_CHANNEL_TX_BYTES);
+    static auto &txFrames = CastEngineMetrics::GetInstance().RegisterCounter(METRIC_CHANNEL_TX_FRAMES);
+    static auto &txErrors = CastEngineMetrics::GetInstance().RegisterCounter(METRIC_CHANNEL_TX_ERRORS);
+    static auto &sendTime = CastEngineMetrics::GetInstance().RegisterHistogram(METRIC_CHANNEL_SEND_US);
     int sockfd = remoteSocket_ == INVALID_SOCKET ? socket_.GetSocketFd() : remoteSocket_;
-    int ret = socket_.Send(sockfd, sendBuf.get(), bufLen + PACKET_HEADER_LEN);
-    if (ret <= RET_OK && listener_) {
-        listener_->OnConnectionError(shared_from_this(), ret);
+    int ret;
+    {
+        MetricScopedTimer timer(sendTime);
+        ret = socket_.Send(sockfd, sendBuf.get(), bufLen + PACKET_HEADER_LEN);
+    }
+    if (ret <= RET_OK) {
+        txErrors.Add();
+        if (listener_) {
+            listener_->OnConnectionError(shared_from_this(), ret);
+        }
+    } else {
+        txFrames.Add();
+        txBytes.Add(ret);
+        sentBytes_ += static_cast<uint64_t>(ret);
+        CastTraceRecorder::GetInstance().Record(TraceRecordType::CHANNEL_TX,
+            static_cast<uint16_t>(channelRequest_.moduleType), buf, static_cast<uint32_t>(bufLen));
     }
 
     return ret > RET_OK;
 }
+
+bool TcpConnection::GetLinkStats(ChannelLinkStats &stats)
+{
+    stats.sentBytes = sentBytes_;
+    int sockfd = remoteSocket_ == INVALID_SOCKET ? socket_.GetSocketFd() : remoteSocket_;
+    return socket_.GetLinkStats(sockfd, stats);
+}
 } // namespace CastEngineService
 } // namespace CastEngine
 } // namespace OHOS
\ No newline at end of file
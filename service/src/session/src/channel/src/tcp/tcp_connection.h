@@ -19,6 +19,7 @@
 #ifndef TCP_CONNECTION_H
 #define TCP_CONNECTION_H
 
+#include <atomic>
 #include <memory>
 #include <mutex>
 #include <string>
@@ -44,6 +45,7 @@ public:
     int StartListen(const ChannelRequest &request, std::shared_ptr<IChannelListener> channelListener) override;
     void CloseConnection() override;
     bool Send(const uint8_t *buf, int bufLen) override;
+    bool GetLinkStats(ChannelLinkStats &stats) override;
     std::string GetType() override
     {
         return "TCP";
@@ -84,6 +86,7 @@ private:
     static constexpr int CONTROL_LENGTH_MASK = 0xFFFF;
 
     std::atomic<bool> isReceiving_{ false };
+    std::atomic<uint64_t> sentBytes_{ 0 };
     TcpSocket socket_;
     // 连接的客户端套接字
     int remoteSocket_{ INVALID_SOCKET };
@@ -147,7 +147,9 @@ int TcpSocket::Send(int fd, const uint8_t *buff, size_t length)
 {
     auto ret = ::send(fd, buff, length, SOCKET_FLAG);
     if (ret < RET_OK) {
-        CLOGE("Socket send error: errno = %{public}d, errmsg = %{public}s.", errno, strerror(errno));
+        int error = errno;
+        CLOGE_LIMIT(ERROR_LOG_INTERVAL_MS, "Socket send error: errno = %{public}d, errmsg = %{public}s.", error,
+            strerror(error));
     }
     return ret;
 }
@@ -170,11 +172,15 @@ ssize_t TcpSocket::Recv(int fd, uint8_t *buff, size_t length)
             CLOGE("Socket recv error: errno = %{public}d, errmsg = %{public}s.", error, strerror(error));
             return RET_ERR;
         }
+        if (len == 0) {
+            CLOGI("Socket recv, peer closed.");
+            return RET_ERR;
+        }
 
         recvLen += static_cast<size_t>(len);
     }
 
-    CLOGI("Socket recv DONE!, size:%zu", recvLen);
+    CLOGV("Socket recv DONE!, size:%{public}zu", recvLen);
     return recvLen;
 }
 
@@ -292,6 +298,44 @@ bool TcpSocket::SetIPTOS(int fd)
     CLOGD("Socket IP_TOS success.");
     return true;
 }
+
+bool TcpSocket::SetNotSentLowat(int fd, int bytes)
+{
+    int lowat = bytes;
+    if (setsockopt(fd, IPPROTO_TCP, TCP_NOTSENT_LOWAT, &lowat, sizeof(lowat)) < RET_OK) {
+        CLOGE("Socket TCP_NOTSENT_LOWAT error: errno = %{public}d, errmsg = %{public}s.", errno, strerror(errno));
+        return false;
+    }
+    CLOGD("Socket TCP_NOTSENT_LOWAT success.");
+    return true;
+}
+
+bool TcpSocket::SetNoDelay(int fd)
+{
+    int noDelay = 1;
+    if (setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay)) < RET_OK) {
+        CLOGE("Socket TCP_NODELAY error: errno = %{public}d, errmsg = %{public}s.", errno, strerror(errno));
+        return false;
+    }
+    CLOGD("Socket TCP_NODELAY success.");
+    return true;
+}
+
+bool TcpSocket::GetLinkStats(int fd, ChannelLinkStats &stats)
+{
+    struct tcp_info info {};
+    socklen_t length = sizeof(info);
+    if (getsockopt(fd, IPPROTO_TCP, TCP_INFO, &info, &length) < RET_OK) {
+        CLOGE("Socket TCP_INFO error: errno = %{public}d, errmsg = %{public}s.", errno, strerror(errno));
+        return false;
+    }
+    stats.rttUs = info.tcpi_rtt;
+    stats.rttVarUs = info.tcpi_rttvar;
+    stats.cwndBytes = static_cast<uint64_t>(info.tcpi_snd_cwnd) * info.tcpi_snd_mss;
+    stats.lostPackets = info.tcpi_total_retrans;
+    stats.sentPackets = info.tcpi_snd_mss == 0 ? 0 : stats.sentBytes / info.tcpi_snd_mss + info.tcpi_total_retrans;
+    return true;
+}
 } // namespace CastEngineService
 } // namespace CastEngine
 } // namespace OHOS
\ No newline at end of file
@@ -29,6 +29,8 @@
 #include <sys/socket.h>
 #include <unistd.h>
 
+#include "channel.h"
+
 namespace OHOS {
 namespace CastEngine {
 namespace CastEngineService {
@@ -59,6 +61,12 @@ public:
     // 设置SO_REUSEADDR，对应TCP套接字处于TIME_WAIT状态下的socket可以重复绑定使用
     bool SetReuseAddr();
     bool SetIPTOS(int fd);
+    // 限制内核中尚未发出的数据量，超出部分留在应用层队列中，便于按优先级调度
+    bool SetNotSentLowat(int fd, int bytes);
+    // 关闭Nagle算法，小包立即发出，不再等待对端的延迟确认
+    bool SetNoDelay(int fd);
+    // 由TCP_INFO填充往返时延、拥塞窗口和重传数，发送包数按调用方填入的sentBytes折算
+    bool GetLinkStats(int fd, ChannelLinkStats &stats);
 
 private:
     static constexpr int RANDOM_PORT = 0;
@@ -72,6 +80,7 @@ private:
     static constexpr int RET_OK = 0;
     static constexpr int RET_ERR = -1;
     static constexpr int STOP_RECEIVE = -2;
+    static constexpr int64_t ERROR_LOG_INTERVAL_MS = 1000;
     
     bool stopReceive_{ false };
     int GetBindPort();
@@ -0,0 +1,163 @@
+/*
+ * Copyright (C) 2023-2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * Description: udp socket of the vtp media transport.
+ * Author: zhangge
+ * Create: 2023-06-05
+ */
+
+#include "udp_socket.h"
+
+#include <cerrno>
+#include <netinet/ip.h>
+#include <sys/time.h>
+
+#include "cast_engine_log.h"
+
+namespace OHOS {
+namespace CastEngine {
+namespace CastEngineService {
+DEFINE_CAST_ENGINE_LABEL("Cast-UdpSocket");
+
+UdpSocket::UdpSocket()
+{
+    socket_ = ::socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (socket_ < RET_OK) {
+        CLOGE("Create socket error: errno = %{public}d, errmsg = %{public}s.", errno, strerror(errno));
+    }
+}
+
+UdpSocket::~UdpSocket()
+{
+    if (socket_ > INVALID_SOCKET) {
+        ::close(socket_);
+        socket_ = INVALID_SOCKET;
+    }
+}
+
+int UdpSocket::Bind(const std::string &ip, int port)
+{
+    struct sockaddr_in sockaddr{};
+    sockaddr.sin_family = AF_INET;
+    sockaddr.sin_addr.s_addr = ip.empty() ? htonl(INADDR_ANY) : inet_addr(ip.c_str());
+    sockaddr.sin_port = htons(port == INVALID_PORT ? RANDOM_PORT : port);
+    if (::bind(socket_, reinterpret_cast<struct sockaddr *>(&sockaddr), sizeof(sockaddr)) < RET_OK) {
+        CLOGE("Socket bind error: errno = %{public}d, errmsg = %{public}s.", errno, strerror(errno));
+        return INVALID_PORT;
+    }
+
+    socklen_t addrLen = sizeof(sockaddr);
+    if (getsockname(socket_, reinterpret_cast<struct sockaddr *>(&sockaddr), &addrLen) < RET_OK) {
+        CLOGE("Socket getsockname error: errno = %{public}d, errmsg = %{public}s.", errno, strerror(errno));
+        return INVALID_PORT;
+    }
+    return ntohs(sockaddr.sin_port);
+}
+
+bool UdpSocket::Connect(const std::string &ip, int port)
+{
+    struct sockaddr_in sockaddr{};
+    sockaddr.sin_family = AF_INET;
+    sockaddr.sin_addr.s_addr = inet_addr(ip.c_str());
+    sockaddr.sin_port = htons(port);
+    return Connect(sockaddr);
+}
+
+bool UdpSocket::Connect(const sockaddr_in &peer)
+{
+    // A connected udp socket only exchanges datagrams with that peer, and reports its icmp errors.
+    if (::connect(socket_, reinterpret_cast<const struct sockaddr *>(&peer), sizeof(peer)) < RET_OK) {
+        CLOGE("Socket connect error: errno = %{public}d, errmsg = %{public}s.", errno, strerror(errno));
+        return false;
+    }
+    return true;
+}
+
+ssize_t UdpSocket::Send(const uint8_t *buff, size_t length)
+{
+    ssize_t ret = ::send(socket_, buff, length, MSG_NOSIGNAL);
+    if (ret < RET_OK) {
+        CLOGE("Socket send error: errno = %{public}d, errmsg = %{public}s.", errno, strerror(errno));
+    }
+    return ret;
+}
+
+ssize_t UdpSocket::Recv(uint8_t *buff, size_t length)
+{
+    ssize_t ret = ::recv(socket_, buff, length, 0);
+    if (ret < RET_OK && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) {
+        return RET_OK;
+    }
+    return ret;
+}
+
+ssize_t UdpSocket::RecvFrom(uint8_t *buff, size_t length, sockaddr_in &peer)
+{
+    socklen_t addrLen = sizeof(peer);
+    ssize_t ret = ::recvfrom(socket_, buff, length, 0, reinterpret_cast<struct sockaddr *>(&peer), &addrLen);
+    if (ret < RET_OK && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) {
+        return RET_OK;
+    }
+    return ret;
+}
+
+void UdpSocket::Shutdown()
+{
+    if (socket_ > INVALID_SOCKET) {
+        ::shutdown(socket_, SHUT_RDWR);
+    }
+}
+
+bool UdpSocket::SetRecvTimeout(int timeoutMs)
+{
+    struct timeval timeout{};
+    timeout.tv_sec = timeoutMs / MS_PER_SECOND;
+    timeout.tv_usec = (timeoutMs % MS_PER_SECOND) * US_PER_MS;
+    if (setsockopt(socket_, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout)) < RET_OK) {
+        CLOGE("Socket SO_RCVTIMEO error: errno = %{public}d, errmsg = %{public}s.", errno, strerror(errno));
+        return false;
+    }
+    return true;
+}
+
+bool UdpSocket::SetSendBufferSize(int size)
+{
+    if (setsockopt(socket_, SOL_SOCKET, SO_SNDBUF, &size, sizeof(size)) < RET_OK) {
+        CLOGE("Socket SetSendBufferSize error: errno = %{public}d, errmsg = %{public}s.", errno, strerror(errno));
+        return false;
+    }
+    return true;
+}
+
+bool UdpSocket::SetRecvBufferSize(int size)
+{
+    if (setsockopt(socket_, SOL_SOCKET, SO_RCVBUF, &size, sizeof(size)) < RET_OK) {
+        CLOGE("Socket SetRecvBufferSize error: errno = %{public}d, errmsg = %{public}s.", errno, strerror(errno));
+        return false;
+    }
+    return true;
+}
+
+bool UdpSocket::SetIPTOS()
+{
+    // Same WMM voice access category as the tcp media channel.
+    int tos = IPTOS_LOWDELAY;
+    if (setsockopt(socket_, IPPROTO_IP, IP_TOS, &tos, sizeof(tos)) < RET_OK) {
+        CLOGE("Socket IP_TOS error: errno = %{public}d, errmsg = %{public}s.", errno, strerror(errno));
+        return false;
+    }
+    return true;
+}
+} // namespace CastEngineService
+} // namespace CastEngine
+} // namespace OHOS
@@ -0,0 +1,67 @@
+/*
+ * Copyright (C) 2023-2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * Description: udp socket of the vtp media transport.
+ * Author: zhangge
+ * Create: 2023-06-05
+ */
+
+#ifndef UDP_SOCKET_H
+#define UDP_SOCKET_H
+
+#include <arpa/inet.h>
+#include <cstring>
+#include <netinet/in.h>
+#include <string>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace OHOS {
+namespace CastEngine {
+namespace CastEngineService {
+class UdpSocket {
+public:
+    UdpSocket();
+    ~UdpSocket();
+
+    int Bind(const std::string &ip, int port);
+    bool Connect(const std::string &ip, int port);
+    bool Connect(const sockaddr_in &peer);
+    ssize_t Send(const uint8_t *buff, size_t length);
+    // Returns 0 when nothing arrived within the receive timeout.
+    ssize_t Recv(uint8_t *buff, size_t length);
+    ssize_t RecvFrom(uint8_t *buff, size_t length, sockaddr_in &peer);
+    // Wakes up a blocked Recv; the descriptor itself is closed by the destructor, once no thread can use it.
+    void Shutdown();
+    bool SetRecvTimeout(int timeoutMs);
+    bool SetSendBufferSize(int size);
+    bool SetRecvBufferSize(int size);
+    bool SetIPTOS();
+
+private:
+    static constexpr int RANDOM_PORT = 0;
+    static constexpr int INVALID_PORT = -1;
+    static constexpr int INVALID_SOCKET = -1;
+    static constexpr int IPTOS_LOWDELAY = 0xBC;
+    static constexpr int RET_OK = 0;
+    static constexpr int RET_ERR = -1;
+    static constexpr int MS_PER_SECOND = 1000;
+    static constexpr int US_PER_MS = 1000;
+
+    int socket_;
+};
+} // namespace CastEngineService
+} // namespace CastEngine
+} // namespace OHOS
+
+#endif
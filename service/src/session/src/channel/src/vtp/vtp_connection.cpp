@@ -0,0 +1,403 @@
+/*
+ * Copyright (C) 2023-2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * Description: vtp media transport over udp, with pacing, xor fec and nack based retransmission.
+ * Author: zhangge
+ * Create: 2023-06-05
+ */
+
+#include "vtp_connection.h"
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+#include "cast_engine_log.h"
+#include "cast_engine_metrics.h"
+#include "cast_trace.h"
+#include "parameters.h"
+#include "utils.h"
+
+namespace OHOS {
+namespace CastEngine {
+namespace CastEngineService {
+DEFINE_CAST_ENGINE_LABEL("Cast-VtpConnection");
+
+VtpConnection::VtpConnection()
+    : config_(LoadConfig()),
+      sender_(config_, [this](const uint8_t *buf, size_t length) { return Output(buf, length); }),
+      receiver_(config_, [this](const uint8_t *buf, size_t length) { HandleFrame(buf, length); },
+          [this](const std::vector<uint32_t> &seqs) { SendNack(seqs); })
+{
+}
+
+VtpConnection::~VtpConnection()
+{
+    CLOGD("Enter.");
+}
+
+VtpConfig VtpConnection::LoadConfig()
+{
+    VtpConfig config;
+    config.fecGroupSize = static_cast<uint32_t>(std::clamp(OHOS::system::GetIntParameter<int>(
+        "persist.cast.vtp.fec_group", static_cast<int>(config.fecGroupSize)), 0,
+        static_cast<int>(VtpPacket::MAX_FEC_GROUP_SIZE)));
+    config.latencyBudgetMs = std::max(OHOS::system::GetIntParameter<int>("persist.cast.vtp.latency_ms",
+        config.latencyBudgetMs), config.nackIntervalMs);
+    config.pacingRateKbps = std::max<int64_t>(OHOS::system::GetIntParameter<int64_t>("persist.cast.vtp.pacing_kbps",
+        config.pacingRateKbps), 0);
+    CLOGI("fec group %{public}u, latency budget %{public}d ms, pacing %{public}lld kbps", config.fecGroupSize,
+        config.latencyBudgetMs, static_cast<long long>(config.pacingRateKbps));
+    return config;
+}
+
+void VtpConnection::ConfigSocket()
+{
+    socket_.SetSendBufferSize(SOCKET_SEND_BUFFER_SIZE);
+    socket_.SetRecvBufferSize(SOCKET_RECV_BUFFER_SIZE);
+    socket_.SetIPTOS();
+}
+
+int VtpConnection::StartConnection(const ChannelRequest &request, std::shared_ptr<IChannelListener> channelListener)
+{
+    CLOGD("Vtp Start Connection Enter.");
+
+    ConfigSocket();
+    StashRequest(request);
+    SetRequest(request);
+    SetListener(channelListener);
+    isReceiving_ = true;
+    auto vtpConnection = shared_from_this();
+    std::thread([vtpConnection] {
+        Utils::SetThreadName("VtpConnect");
+        vtpConnection->Connect();
+    }).detach();
+
+    return RET_OK;
+}
+
+void VtpConnection::Connect()
+{
+    CLOGD("Vtp Connect Enter.");
+    std::shared_ptr<ConnectionListener> listener = listener_;
+    if (!listener) {
+        CLOGE("listener_ is nullptr.");
+        return;
+    }
+    if (channelRequest_.remoteDeviceInfo.ipAddress.empty() || channelRequest_.remotePort == INVALID_PORT) {
+        listener->OnConnectionConnectFailed(channelRequest_, RET_ERR);
+        return;
+    }
+
+    int port = socket_.Bind(channelRequest_.localDeviceInfo.ipAddress, channelRequest_.localPort);
+    CLOGI("Start client socket, bindPort:%{public}s", Utils::Mask(std::to_string(port)).c_str());
+    if (port == INVALID_PORT ||
+        !socket_.Connect(channelRequest_.remoteDeviceInfo.ipAddress, channelRequest_.remotePort)) {
+        listener->OnConnectionConnectFailed(channelRequest_, RET_ERR);
+        return;
+    }
+
+    socket_.SetRecvTimeout(HELLO_RETRY_MS);
+    uint8_t buf[VtpPacket::MAX_PACKET_LEN];
+    for (int i = 0; i < HELLO_RETRIES && isReceiving_; i++) {
+        SendControl(VtpPacketType::HELLO);
+        ssize_t length = socket_.Recv(buf, sizeof(buf));
+        VtpHeader header;
+        const uint8_t *payload = nullptr;
+        if (length > 0 && VtpPacket::Parse(buf, static_cast<size_t>(length), header, payload) &&
+            header.type == VtpPacketType::HELLO_ACK) {
+            CLOGI("Open Session Succ, sessionId = %{public}d, moduleType = %{public}d",
+                channelRequest_.remoteDeviceInfo.sessionId, channelRequest_.moduleType);
+            OnOpened(listener);
+            return;
+        }
+    }
+
+    CLOGE("Vtp Connect Failed, no answer from the peer.");
+    listener->OnConnectionConnectFailed(channelRequest_, RET_ERR);
+}
+
+int VtpConnection::StartListen(const ChannelRequest &request, std::shared_ptr<IChannelListener> channelListener)
+{
+    CLOGD("Vtp Start Listen Enter.");
+
+    ConfigSocket();
+    StashRequest(request);
+    SetRequest(request);
+    SetListener(channelListener);
+
+    int port = socket_.Bind(request.localDeviceInfo.ipAddress, request.localPort);
+    CLOGI("Start server socket, bindPort:%{public}s", Utils::Mask(std::to_string(port)).c_str());
+    if (port == INVALID_PORT) {
+        return INVALID_PORT;
+    }
+    isReceiving_ = true;
+    auto vtpConnection = shared_from_this();
+    std::thread([vtpConnection] {
+        Utils::SetThreadName("VtpAccept");
+        vtpConnection->Accept();
+    }).detach();
+
+    return port;
+}
+
+void VtpConnection::Accept()
+{
+    CLOGD("Vtp Accept Enter.");
+    std::shared_ptr<ConnectionListener> listener = listener_;
+    if (!listener) {
+        CLOGE("listener_ is nullptr.");
+        return;
+    }
+
+    static auto &rejectedHellos = CastEngineMetrics::GetInstance().RegisterCounter(METRIC_VTP_HELLOS_REJECTED);
+    // Like a tcp accept, waits for the peer until the connection is closed.
+    socket_.SetRecvTimeout(HELLO_RETRY_MS);
+    uint8_t buf[VtpPacket::MAX_PACKET_LEN];
+    while (isReceiving_) {
+        sockaddr_in peer{};
+        ssize_t length = socket_.RecvFrom(buf, sizeof(buf), peer);
+        if (length < RET_OK) {
+            CLOGE("Open Session Failed, sessionId = %{public}d, moduleType = %{public}d",
+                channelRequest_.remoteDeviceInfo.sessionId, channelRequest_.moduleType);
+            listener->OnConnectionConnectFailed(channelRequest_, static_cast<int>(length));
+            return;
+        }
+        VtpHeader header;
+        const uint8_t *payload = nullptr;
+        if (length == 0 || !VtpPacket::Parse(buf, static_cast<size_t>(length), header, payload) ||
+            header.type != VtpPacketType::HELLO) {
+            continue;
+        }
+        // The port is open to the whole network, only the device the session negotiated with may take it.
+        if (!IsExpectedPeer(peer)) {
+            rejectedHellos.Add();
+            continue;
+        }
+        if (!socket_.Connect(peer)) {
+            listener->OnConnectionConnectFailed(channelRequest_, RET_ERR);
+            return;
+        }
+        SendControl(VtpPacketType::HELLO_ACK);
+        CLOGI("Open Session Succ, sessionId = %{public}d, moduleType = %{public}d",
+            channelRequest_.remoteDeviceInfo.sessionId, channelRequest_.moduleType);
+        OnOpened(listener);
+        return;
+    }
+    CLOGD("Vtp Accept out.");
+}
+
+bool VtpConnection::IsExpectedPeer(const sockaddr_in &peer)
+{
+    char address[INET_ADDRSTRLEN] = { 0 };
+    if (inet_ntop(AF_INET, &peer.sin_addr, address, sizeof(address)) == nullptr) {
+        return false;
+    }
+    if (channelRequest_.remoteDeviceInfo.ipAddress != address) {
+        CLOGW("Drop HELLO from unexpected peer %{public}s", Utils::Mask(address).c_str());
+        return false;
+    }
+    return true;
+}
+
+void VtpConnection::OnOpened(std::shared_ptr<ConnectionListener> listener)
+{
+    isOpened_ = true;
+    sender_.Start();
+    listener->OnConnectionOpened(shared_from_this());
+    // Both ends read: the sink for the media, the source for the nacks of the sink.
+    socket_.SetRecvTimeout(TICK_MS);
+    ReadLooper(listener);
+}
+
+void VtpConnection::ReadLooper(std::shared_ptr<ConnectionListener> listener)
+{
+    CLOGD("Vtp Read Looper Enter.");
+    static auto &rxErrors = CastEngineMetrics::GetInstance().RegisterCounter(METRIC_CHANNEL_RX_ERRORS);
+    uint8_t buf[VtpPacket::MAX_PACKET_LEN];
+    std::vector<uint8_t> delayed;
+    auto lastTick = std::chrono::steady_clock::now();
+    while (isReceiving_) {
+        ssize_t length = socket_.Recv(buf, sizeof(buf));
+        if (!isReceiving_) {
+            break;
+        }
+        if (length < RET_OK) {
+            CLOGE("Receive data error.");
+            rxErrors.Add();
+            listener->OnConnectionError(shared_from_this(), static_cast<int>(length));
+            return;
+        }
+        if (length > 0) {
+            if (faultInjector_.IsEnabled()) {
+                faultInjector_.Push(buf, static_cast<size_t>(length));
+            } else {
+                HandlePacket(buf, static_cast<size_t>(length));
+            }
+        }
+        while (faultInjector_.Pop(delayed)) {
+            HandlePacket(delayed.data(), delayed.size());
+        }
+        if (isPeerClosed_) {
+            CLOGI("Peer closed the channel.");
+            listener->OnConnectionError(shared_from_this(), RET_ERR);
+            return;
+        }
+        auto now = std::chrono::steady_clock::now();
+        if (now - lastTick >= std::chrono::milliseconds(TICK_MS)) {
+            receiver_.OnTick();
+            lastTick = now;
+        }
+    }
+    CLOGI("ReadLooper Out.");
+}
+
+void VtpConnection::HandlePacket(const uint8_t *buf, size_t length)
+{
+    VtpHeader header;
+    const uint8_t *payload = nullptr;
+    if (!VtpPacket::Parse(buf, length, header, payload)) {
+        CLOGW("Drop malformed packet, length = %{public}zu", length);
+        return;
+    }
+    switch (header.type) {
+        case VtpPacketType::DATA:
+            receiver_.OnData(header, payload);
+            break;
+        case VtpPacketType::FEC:
+            receiver_.OnFec(header, payload);
+            break;
+        case VtpPacketType::NACK:
+            sender_.OnNack(header, payload);
+            break;
+        case VtpPacketType::HELLO:
+            // Our HELLO_ACK was lost, the peer is still knocking.
+            SendControl(VtpPacketType::HELLO_ACK);
+            break;
+        case VtpPacketType::BYE:
+            isPeerClosed_ = true;
+            break;
+        default:
+            break;
+    }
+}
+
+void VtpConnection::HandleFrame(const uint8_t *buf, size_t length)
+{
+    static auto &rxBytes = CastEngineMetrics::GetInstance().RegisterCounter(METRIC_CHANNEL_RX_BYTES);
+    static auto &rxFrames = CastEngineMetrics::GetInstance().RegisterCounter(METRIC_CHANNEL_RX_FRAMES);
+    if (!channelRequest_.isReceiver) {
+        return;
+    }
+    rxFrames.Add();
+    rxBytes.Add(static_cast<int64_t>(length));
+    CastTraceRecorder::GetInstance().Record(TraceRecordType::CHANNEL_RX,
+        static_cast<uint16_t>(channelRequest_.moduleType), buf, static_cast<uint32_t>(length));
+    if (GetListener()) {
+        GetListener()->OnDataReceived(buf, static_cast<int>(length), 0);
+    }
+}
+
+bool VtpConnection::SendControl(VtpPacketType type)
+{
+    VtpHeader header;
+    header.type = type;
+    auto packet = VtpPacket::Build(header, nullptr);
+    return Output(packet.data(), packet.size());
+}
+
+void VtpConnection::SendNack(const std::vector<uint32_t> &seqs)
+{
+    std::vector<uint8_t> payload(seqs.size() * sizeof(uint32_t));
+    for (size_t i = 0; i < seqs.size(); i++) {
+        VtpPacket::WriteUint32(&payload[i * sizeof(uint32_t)], seqs[i]);
+    }
+    VtpHeader header;
+    header.type = VtpPacketType::NACK;
+    header.seq = static_cast<uint32_t>(seqs.size());
+    header.payloadLength = static_cast<uint16_t>(payload.size());
+    auto packet = VtpPacket::Build(header, payload.data());
+    Output(packet.data(), packet.size());
+}
+
+bool VtpConnection::Output(const uint8_t *buf, size_t length)
+{
+    static auto &txErrors = CastEngineMetrics::GetInstance().RegisterCounter(METRIC_CHANNEL_TX_ERRORS);
+    // A lost datagram is repaired by the fec or a retransmission, so a failed send is counted but never fatal.
+    if (socket_.Send(buf, length) < RET_OK) {
+        txErrors.Add();
+        return false;
+    }
+    return true;
+}
+
+void VtpConnection::CloseConnection()
+{
+    CLOGI("Vtp Close Enter.");
+    std::lock_guard<std::mutex> lg(connectionMtx_);
+    isReceiving_.store(false);
+    if (isOpened_.exchange(false) && !isPeerClosed_) {
+        SendControl(VtpPacketType::BYE);
+    }
+    sender_.Stop();
+    socket_.Shutdown();
+    if (listener_) {
+        listener_->OnConnectionClosed(shared_from_this());
+    }
+    CLOGI("Vtp Close Out.");
+}
+
+bool VtpConnection::Send(const uint8_t *buf, int bufLen)
+{
+    CLOGV("Vtp Send Enter, len = %{public}d", bufLen);
+    if (buf == nullptr || bufLen <= 0) {
+        CLOGE("Data or length is illegal.");
+        return false;
+    }
+
+    static auto &txBytes = CastEngineMetrics::GetInstance().RegisterCounter(METRIC_CHANNEL_TX_BYTES);
+    static auto &txFrames = CastEngineMetrics::GetInstance().RegisterCounter(METRIC_CHANNEL_TX_FRAMES);
+    static auto &txErrors = CastEngineMetrics::GetInstance().RegisterCounter(METRIC_CHANNEL_TX_ERRORS);
+    static auto &sendTime = CastEngineMetrics::GetInstance().RegisterHistogram(METRIC_CHANNEL_SEND_US);
+    bool ret;
+    {
+        MetricScopedTimer timer(sendTime);
+        ret = sender_.SendFrame(buf, static_cast<size_t>(bufLen));
+    }
+    if (!ret) {
+        txErrors.Add();
+        return false;
+    }
+    txFrames.Add();
+    txBytes.Add(bufLen);
+    CastTraceRecorder::GetInstance().Record(TraceRecordType::CHANNEL_TX,
+        static_cast<uint16_t>(channelRequest_.moduleType), buf, static_cast<uint32_t>(bufLen));
+    return true;
+}
+
+size_t VtpConnection::GetSendQueueDepth()
+{
+    return sender_.GetQueuedBytes();
+}
+
+bool VtpConnection::GetLinkStats(ChannelLinkStats &stats)
+{
+    if (!isOpened_) {
+        return false;
+    }
+    sender_.GetLinkStats(stats);
+    return true;
+}
+} // namespace CastEngineService
+} // namespace CastEngine
+} // namespace OHOS
@@ -0,0 +1,103 @@
+/*
+ * Copyright (C) 2023-2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * Description: vtp media transport over udp, with pacing, xor fec and nack based retransmission.
+ * Author: zhangge
+ * Create: 2023-06-05
+ */
+
+#ifndef VTP_CONNECTION_H
+#define VTP_CONNECTION_H
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "connection.h"
+#include "channel.h"
+#include "udp_socket.h"
+#include "vtp_fault_injector.h"
+#include "vtp_packet.h"
+#include "vtp_receiver.h"
+#include "vtp_sender.h"
+
+namespace OHOS {
+namespace CastEngine {
+namespace CastEngineService {
+/*
+ * Media channel negotiated as vtp: the sink listens and the source connects, as for tcp, but the frames travel in
+ * paced udp datagrams, so that a lost packet is repaired by the xor parity or one retransmission within the latency
+ * budget instead of blocking every frame behind it. The handshake is a HELLO repeated until the listener answers
+ * HELLO_ACK, after which the socket is connected to that peer only; a HELLO from any other address than the one of
+ * the negotiated device is ignored. BYE tells the peer the channel is closed.
+ * The fec group, the latency budget and the pacing rate come from the persist.cast.vtp.* parameters.
+ */
+class VtpConnection : public Connection, public Channel, public std::enable_shared_from_this<VtpConnection> {
+public:
+    using Connection::channelRequest_;
+
+    VtpConnection();
+    ~VtpConnection() override;
+
+    int StartConnection(const ChannelRequest &request, std::shared_ptr<IChannelListener> channelListener) override;
+    int StartListen(const ChannelRequest &request, std::shared_ptr<IChannelListener> channelListener) override;
+    void CloseConnection() override;
+    bool Send(const uint8_t *buf, int bufLen) override;
+    size_t GetSendQueueDepth() override;
+    bool GetLinkStats(ChannelLinkStats &stats) override;
+    std::string GetType() override
+    {
+        return "VTP";
+    }
+
+private:
+    static VtpConfig LoadConfig();
+    void ConfigSocket();
+    void Connect();
+    void Accept();
+    bool IsExpectedPeer(const sockaddr_in &peer);
+    void OnOpened(std::shared_ptr<ConnectionListener> listener);
+    void ReadLooper(std::shared_ptr<ConnectionListener> listener);
+    void HandlePacket(const uint8_t *buf, size_t length);
+    void HandleFrame(const uint8_t *buf, size_t length);
+    bool SendControl(VtpPacketType type);
+    void SendNack(const std::vector<uint32_t> &seqs);
+    bool Output(const uint8_t *buf, size_t length);
+
+    static constexpr int RET_ERR = -1;
+    static constexpr int RET_OK = 0;
+    // Period of the nack and frame expiry checks, also the receive timeout of the read thread.
+    static constexpr int TICK_MS = 5;
+    static constexpr int HELLO_RETRY_MS = 100;
+    static constexpr int HELLO_RETRIES = 30;
+    static constexpr int SOCKET_SEND_BUFFER_SIZE = 512 * 1024;
+    static constexpr int SOCKET_RECV_BUFFER_SIZE = 10 * 1024 * 1024;
+
+    std::atomic<bool> isReceiving_{ false };
+    std::atomic<bool> isOpened_{ false };
+    std::atomic<bool> isPeerClosed_{ false };
+    UdpSocket socket_;
+    VtpConfig config_;
+    // Declared after socket_: the pacer thread sends on it until the sender is destroyed.
+    VtpSender sender_;
+    VtpReceiver receiver_;
+    VtpFaultInjector faultInjector_;
+    std::mutex connectionMtx_;
+};
+} // namespace CastEngineService
+} // namespace CastEngine
+} // namespace OHOS
+
+#endif
@@ -0,0 +1,60 @@
+/*
+ * Copyright (C) 2023-2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * Description: debug only loss and jitter injection on the receive path of the vtp media transport.
+ * Author: zhangge
+ * Create: 2023-06-05
+ */
+
+#include "vtp_fault_injector.h"
+
+#include <algorithm>
+
+#include "cast_engine_log.h"
+#include "parameters.h"
+
+namespace OHOS {
+namespace CastEngine {
+namespace CastEngineService {
+DEFINE_CAST_ENGINE_LABEL("Cast-VtpFaultInjector");
+
+VtpFaultInjector::VtpFaultInjector() : random_(std::random_device{}())
+{
+    lossPercent_ = std::clamp(OHOS::system::GetIntParameter<int>("debug.cast.vtp.loss_percent", 0), 0, MAX_PERCENT);
+    jitterMs_ = std::max(OHOS::system::GetIntParameter<int>("debug.cast.vtp.jitter_ms", 0), 0);
+    if (IsEnabled()) {
+        CLOGW("Fault injection on, loss = %{public}d%%, jitter = %{public}d ms", lossPercent_, jitterMs_);
+    }
+}
+
+void VtpFaultInjector::Push(const uint8_t *buf, size_t length)
+{
+    if (lossPercent_ > 0 && static_cast<int>(random_() % MAX_PERCENT) < lossPercent_) {
+        return;
+    }
+    int delayMs = jitterMs_ > 0 ? static_cast<int>(random_() % static_cast<uint32_t>(jitterMs_ + 1)) : 0;
+    delayed_.emplace(Clock::now() + std::chrono::milliseconds(delayMs), std::vector<uint8_t>(buf, buf + length));
+}
+
+bool VtpFaultInjector::Pop(std::vector<uint8_t> &packet)
+{
+    if (delayed_.empty() || delayed_.begin()->first > Clock::now()) {
+        return false;
+    }
+    packet = std::move(delayed_.begin()->second);
+    delayed_.erase(delayed_.begin());
+    return true;
+}
+} // namespace CastEngineService
+} // namespace CastEngine
+} // namespace OHOS
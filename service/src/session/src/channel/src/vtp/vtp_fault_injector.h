@@ -0,0 +1,62 @@
+/*
+ * Copyright (C) 2023-2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * Description: debug only loss and jitter injection on the receive path of the vtp media transport.
+ * Author: zhangge
+ * Create: 2023-06-05
+ */
+
+#ifndef VTP_FAULT_INJECTOR_H
+#define VTP_FAULT_INJECTOR_H
+
+#include <chrono>
+#include <map>
+#include <random>
+#include <vector>
+
+namespace OHOS {
+namespace CastEngine {
+namespace CastEngineService {
+/*
+ * Emulates a lossy link the way netem does, for a loopback or bench session: every received datagram is dropped
+ * with debug.cast.vtp.loss_percent probability, and the others are held for a random delay of up to
+ * debug.cast.vtp.jitter_ms, which also reorders them. Both parameters default to 0, in which case the datagrams
+ * pass straight through.
+ */
+class VtpFaultInjector {
+public:
+    VtpFaultInjector();
+    ~VtpFaultInjector() = default;
+
+    bool IsEnabled() const
+    {
+        return lossPercent_ > 0 || jitterMs_ > 0;
+    }
+    void Push(const uint8_t *buf, size_t length);
+    bool Pop(std::vector<uint8_t> &packet);
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr int MAX_PERCENT = 100;
+
+    int lossPercent_{ 0 };
+    int jitterMs_{ 0 };
+    std::minstd_rand random_;
+    std::multimap<Clock::time_point, std::vector<uint8_t>> delayed_;
+};
+} // namespace CastEngineService
+} // namespace CastEngine
+} // namespace OHOS
+
+#endif
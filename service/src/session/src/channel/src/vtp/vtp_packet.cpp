@@ -0,0 +1,147 @@
+/*
+ * Copyright (C) 2023-2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * Description: wire format, configuration and xor parity of the vtp media transport.
+ * Author: zhangge
+ * Create: 2023-06-05
+ */
+
+#include "vtp_packet.h"
+
+#include <algorithm>
+
+namespace OHOS {
+namespace CastEngine {
+namespace CastEngineService {
+namespace {
+constexpr size_t VERSION_OFFSET = 0;
+constexpr size_t TYPE_OFFSET = 1;
+constexpr size_t LENGTH_OFFSET = 2;
+constexpr size_t SEQ_OFFSET = 4;
+constexpr size_t FRAME_ID_OFFSET = 8;
+constexpr size_t FRAG_INDEX_OFFSET = 12;
+constexpr size_t FRAG_COUNT_OFFSET = 14;
+constexpr int BYTE_BITS = 8;
+constexpr int SHORT_BITS = 16;
+constexpr int THREE_BYTES_BITS = 24;
+constexpr uint32_t BYTE_MASK = 0xFF;
+
+// Offsets inside a fec body.
+constexpr size_t BODY_LENGTH_OFFSET = 0;
+constexpr size_t BODY_FRAME_ID_OFFSET = 2;
+constexpr size_t BODY_FRAG_INDEX_OFFSET = 6;
+constexpr size_t BODY_FRAG_COUNT_OFFSET = 8;
+} // namespace
+
+void VtpPacket::WriteUint16(uint8_t *buf, uint16_t value)
+{
+    buf[0] = static_cast<uint8_t>((value >> BYTE_BITS) & BYTE_MASK);
+    buf[1] = static_cast<uint8_t>(value & BYTE_MASK);
+}
+
+void VtpPacket::WriteUint32(uint8_t *buf, uint32_t value)
+{
+    WriteUint16(buf, static_cast<uint16_t>(value >> SHORT_BITS));
+    WriteUint16(buf + sizeof(uint16_t), static_cast<uint16_t>(value));
+}
+
+uint16_t VtpPacket::ReadUint16(const uint8_t *buf)
+{
+    return static_cast<uint16_t>((buf[0] << BYTE_BITS) | buf[1]);
+}
+
+uint32_t VtpPacket::ReadUint32(const uint8_t *buf)
+{
+    return (static_cast<uint32_t>(buf[0]) << THREE_BYTES_BITS) | (static_cast<uint32_t>(buf[1]) << SHORT_BITS) |
+        (static_cast<uint32_t>(buf[2]) << BYTE_BITS) | buf[3];
+}
+
+std::vector<uint8_t> VtpPacket::Build(const VtpHeader &header, const uint8_t *payload)
+{
+    std::vector<uint8_t> packet(HEADER_LEN + header.payloadLength);
+    packet[VERSION_OFFSET] = VERSION;
+    packet[TYPE_OFFSET] = static_cast<uint8_t>(header.type);
+    WriteUint16(&packet[LENGTH_OFFSET], header.payloadLength);
+    WriteUint32(&packet[SEQ_OFFSET], header.seq);
+    WriteUint32(&packet[FRAME_ID_OFFSET], header.frameId);
+    WriteUint16(&packet[FRAG_INDEX_OFFSET], header.fragIndex);
+    WriteUint16(&packet[FRAG_COUNT_OFFSET], header.fragCount);
+    if (payload != nullptr && header.payloadLength > 0) {
+        std::copy(payload, payload + header.payloadLength, packet.begin() + HEADER_LEN);
+    }
+    return packet;
+}
+
+bool VtpPacket::Parse(const uint8_t *buf, size_t length, VtpHeader &header, const uint8_t *&payload)
+{
+    if (buf == nullptr || length < HEADER_LEN || buf[VERSION_OFFSET] != VERSION) {
+        return false;
+    }
+    header.type = static_cast<VtpPacketType>(buf[TYPE_OFFSET]);
+    header.payloadLength = ReadUint16(buf + LENGTH_OFFSET);
+    header.seq = ReadUint32(buf + SEQ_OFFSET);
+    header.frameId = ReadUint32(buf + FRAME_ID_OFFSET);
+    header.fragIndex = ReadUint16(buf + FRAG_INDEX_OFFSET);
+    header.fragCount = ReadUint16(buf + FRAG_COUNT_OFFSET);
+    if (HEADER_LEN + header.payloadLength > length) {
+        return false;
+    }
+    payload = buf + HEADER_LEN;
+    return true;
+}
+
+std::vector<uint8_t> VtpPacket::GetFecBody(const VtpHeader &header, const uint8_t *payload)
+{
+    std::vector<uint8_t> body(FEC_FIELDS_LEN + header.payloadLength);
+    WriteUint16(&body[BODY_LENGTH_OFFSET], header.payloadLength);
+    WriteUint32(&body[BODY_FRAME_ID_OFFSET], header.frameId);
+    WriteUint16(&body[BODY_FRAG_INDEX_OFFSET], header.fragIndex);
+    WriteUint16(&body[BODY_FRAG_COUNT_OFFSET], header.fragCount);
+    if (payload != nullptr && header.payloadLength > 0) {
+        std::copy(payload, payload + header.payloadLength, body.begin() + FEC_FIELDS_LEN);
+    }
+    return body;
+}
+
+bool VtpPacket::ParseFecBody(uint32_t seq, const std::vector<uint8_t> &body, VtpHeader &header,
+    const uint8_t *&payload)
+{
+    if (body.size() < FEC_FIELDS_LEN) {
+        return false;
+    }
+    header.type = VtpPacketType::DATA;
+    header.seq = seq;
+    header.payloadLength = ReadUint16(&body[BODY_LENGTH_OFFSET]);
+    header.frameId = ReadUint32(&body[BODY_FRAME_ID_OFFSET]);
+    header.fragIndex = ReadUint16(&body[BODY_FRAG_INDEX_OFFSET]);
+    header.fragCount = ReadUint16(&body[BODY_FRAG_COUNT_OFFSET]);
+    // The parity is as long as the longest body of its group, a shorter recovered body is zero padded.
+    if (FEC_FIELDS_LEN + header.payloadLength > body.size() || header.fragIndex >= header.fragCount) {
+        return false;
+    }
+    payload = body.data() + FEC_FIELDS_LEN;
+    return true;
+}
+
+void VtpPacket::XorInto(std::vector<uint8_t> &parity, const std::vector<uint8_t> &body)
+{
+    if (parity.size() < body.size()) {
+        parity.resize(body.size(), 0);
+    }
+    for (size_t i = 0; i < body.size(); i++) {
+        parity[i] ^= body[i];
+    }
+}
+} // namespace CastEngineService
+} // namespace CastEngine
+} // namespace OHOS
@@ -0,0 +1,99 @@
+/*
+ * Copyright (C) 2023-2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * Description: wire format, configuration and xor parity of the vtp media transport.
+ * Author: zhangge
+ * Create: 2023-06-05
+ */
+
+#ifndef VTP_PACKET_H
+#define VTP_PACKET_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace OHOS {
+namespace CastEngine {
+namespace CastEngineService {
+enum class VtpPacketType : uint8_t {
+    HELLO = 1,
+    HELLO_ACK = 2,
+    DATA = 3,
+    FEC = 4,
+    NACK = 5,
+    BYE = 6,
+};
+
+/*
+ * Every datagram starts with this header, big endian:
+ * version(1) type(1) payloadLength(2) seq(4) frameId(4) fragIndex(2) fragCount(2)
+ * DATA carries one fragment of a frame under a per packet sequence number. FEC reuses seq as the first sequence
+ * number of the data packets it protects and frameId as their count. NACK reuses seq as the number of sequence
+ * numbers listed in its payload.
+ */
+struct VtpHeader {
+    VtpPacketType type{ VtpPacketType::DATA };
+    uint16_t payloadLength{ 0 };
+    uint32_t seq{ 0 };
+    uint32_t frameId{ 0 };
+    uint16_t fragIndex{ 0 };
+    uint16_t fragCount{ 0 };
+};
+
+struct VtpConfig {
+    // Data packets protected by one xor parity packet, 0 disables the FEC.
+    uint32_t fecGroupSize{ 8 };
+    // How long a lost packet is worth recovering; older frames are dropped instead of stalling the stream.
+    int latencyBudgetMs{ 120 };
+    int nackIntervalMs{ 20 };
+    // Pacing rate of the sender, 0 sends as fast as the socket takes it.
+    int64_t pacingRateKbps{ 60000 };
+    uint32_t pacingBurstPackets{ 8 };
+};
+
+class VtpPacket {
+public:
+    static constexpr uint8_t VERSION = 1;
+    static constexpr size_t HEADER_LEN = 16;
+    // Stays below the path mtu of wifi and p2p links once the ip and udp headers are added.
+    static constexpr size_t MAX_PACKET_LEN = 1400;
+    static constexpr size_t MAX_PAYLOAD_LEN = MAX_PACKET_LEN - HEADER_LEN;
+    // The parity covers the header fields after seq, so that a recovered packet is complete, plus the payload.
+    static constexpr size_t FEC_FIELDS_LEN = 10;
+    static constexpr size_t MAX_FEC_BODY_LEN = FEC_FIELDS_LEN + MAX_PAYLOAD_LEN;
+    static constexpr uint32_t MAX_FEC_GROUP_SIZE = 32;
+    static constexpr size_t MAX_NACK_SEQS = MAX_PAYLOAD_LEN / sizeof(uint32_t);
+    // Largest frame the sender takes, which bounds what a receiver allocates for the fragment count of a header.
+    static constexpr size_t MAX_FRAME_LEN = 4 * 1024 * 1024;
+    static constexpr uint16_t MAX_FRAG_COUNT = (MAX_FRAME_LEN + MAX_PAYLOAD_LEN - 1) / MAX_PAYLOAD_LEN;
+
+    static std::vector<uint8_t> Build(const VtpHeader &header, const uint8_t *payload);
+    static bool Parse(const uint8_t *buf, size_t length, VtpHeader &header, const uint8_t *&payload);
+
+    static std::vector<uint8_t> GetFecBody(const VtpHeader &header, const uint8_t *payload);
+    static bool ParseFecBody(uint32_t seq, const std::vector<uint8_t> &body, VtpHeader &header,
+        const uint8_t *&payload);
+    // parity ^= body, growing parity with zeros to the longer of the two.
+    static void XorInto(std::vector<uint8_t> &parity, const std::vector<uint8_t> &body);
+
+    static void WriteUint16(uint8_t *buf, uint16_t value);
+    static void WriteUint32(uint8_t *buf, uint32_t value);
+    static uint16_t ReadUint16(const uint8_t *buf);
+    static uint32_t ReadUint32(const uint8_t *buf);
+};
+} // namespace CastEngineService
+} // namespace CastEngine
+} // namespace OHOS
+
+#endif
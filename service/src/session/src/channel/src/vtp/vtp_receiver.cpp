@@ -0,0 +1,250 @@
+/*
+ * Copyright (C) 2023-2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * Description: reordering receiver of the vtp media transport, with fec recovery and nack feedback.
+ * Author: zhangge
+ * Create: 2023-06-05
+ */
+
+#include "vtp_receiver.h"
+
+#include "cast_engine_log.h"
+#include "cast_engine_metrics.h"
+
+namespace OHOS {
+namespace CastEngine {
+namespace CastEngineService {
+DEFINE_CAST_ENGINE_LABEL("Cast-VtpReceiver");
+
+VtpReceiver::VtpReceiver(const VtpConfig &config, FrameCallback onFrame, NackCallback onNack)
+    : config_(config), onFrame_(std::move(onFrame)), onNack_(std::move(onNack))
+{
+}
+
+void VtpReceiver::OnData(const VtpHeader &header, const uint8_t *payload)
+{
+    if (header.fragCount == 0 || header.fragCount > VtpPacket::MAX_FRAG_COUNT || header.fragIndex >= header.fragCount) {
+        return;
+    }
+    auto now = Clock::now();
+    AcceptData(header, payload, now);
+    DeliverFrames(now);
+}
+
+void VtpReceiver::AcceptData(const VtpHeader &header, const uint8_t *payload, Clock::time_point now)
+{
+    if (bodies_.count(header.seq) != 0 || (hasSeq_ && header.seq + RECV_WINDOW < highestSeq_)) {
+        return;
+    }
+    bodies_[header.seq] = VtpPacket::GetFecBody(header, payload);
+    while (bodies_.size() > RECV_WINDOW) {
+        bodies_.erase(bodies_.begin());
+    }
+    TrackSeq(header.seq, now);
+    AddFragment(header, payload, now);
+    ResolveFecs(header.seq, now);
+}
+
+void VtpReceiver::TrackSeq(uint32_t seq, Clock::time_point now)
+{
+    if (!hasSeq_ || seq > highestSeq_ + MAX_TRACKED_GAP) {
+        hasSeq_ = true;
+        highestSeq_ = seq;
+        missing_.clear();
+        return;
+    }
+    if (seq <= highestSeq_) {
+        missing_.erase(seq);
+        return;
+    }
+    for (uint32_t lost = highestSeq_ + 1; lost < seq; lost++) {
+        missing_[lost] = Missing{ now, now, false };
+    }
+    highestSeq_ = seq;
+}
+
+void VtpReceiver::AddFragment(const VtpHeader &header, const uint8_t *payload, Clock::time_point now)
+{
+    if (!hasFrame_) {
+        hasFrame_ = true;
+        nextFrameId_ = header.frameId;
+    }
+    if (header.frameId < nextFrameId_) {
+        return;
+    }
+    if (header.frameId - nextFrameId_ >= MAX_PENDING_FRAMES) {
+        // Far ahead of anything in flight: the sender restarted, start over from its frame.
+        CLOGW("Frame %{public}u far ahead of %{public}u, resync", header.frameId, nextFrameId_);
+        frames_.clear();
+        nextFrameId_ = header.frameId;
+    }
+    auto &frame = frames_[header.frameId];
+    if (frame.fragCount == 0) {
+        frame.fragCount = header.fragCount;
+        frame.frags.resize(header.fragCount);
+        frame.firstSeen = now;
+    }
+    if (frame.fragCount != header.fragCount || !frame.frags[header.fragIndex].empty()) {
+        return;
+    }
+    frame.frags[header.fragIndex].assign(payload, payload + header.payloadLength);
+    frame.received++;
+}
+
+void VtpReceiver::OnFec(const VtpHeader &header, const uint8_t *payload)
+{
+    uint32_t base = header.seq;
+    uint32_t count = header.frameId;
+    if (count == 0 || count > VtpPacket::MAX_FEC_GROUP_SIZE ||
+        (hasSeq_ && base + count + RECV_WINDOW < highestSeq_)) {
+        return;
+    }
+    auto now = Clock::now();
+    PendingFec fec{ count, std::vector<uint8_t>(payload, payload + header.payloadLength), now };
+    if (!TryRecover(base, fec, now)) {
+        pendingFecs_[base] = std::move(fec);
+    }
+    DeliverFrames(now);
+}
+
+void VtpReceiver::ResolveFecs(uint32_t seq, Clock::time_point now)
+{
+    std::vector<uint32_t> bases;
+    for (const auto &[base, fec] : pendingFecs_) {
+        if (base <= seq && seq < base + fec.count) {
+            bases.push_back(base);
+        }
+    }
+    // A recovery accepts one more packet and so may resolve other groups re-entrantly, look every group up again.
+    for (uint32_t base : bases) {
+        auto it = pendingFecs_.find(base);
+        if (it == pendingFecs_.end()) {
+            continue;
+        }
+        PendingFec fec = it->second;
+        if (TryRecover(base, fec, now)) {
+            pendingFecs_.erase(base);
+        }
+    }
+}
+
+bool VtpReceiver::TryRecover(uint32_t base, const PendingFec &fec, Clock::time_point now)
+{
+    uint32_t missingCount = 0;
+    uint32_t missingSeq = 0;
+    for (uint32_t seq = base; seq < base + fec.count; seq++) {
+        if (bodies_.count(seq) == 0) {
+            missingCount++;
+            missingSeq = seq;
+        }
+    }
+    if (missingCount == 0) {
+        return true;
+    }
+    if (missingCount > 1) {
+        return false;
+    }
+
+    std::vector<uint8_t> body = fec.parity;
+    for (uint32_t seq = base; seq < base + fec.count; seq++) {
+        if (seq != missingSeq) {
+            VtpPacket::XorInto(body, bodies_[seq]);
+        }
+    }
+    VtpHeader header;
+    const uint8_t *payload = nullptr;
+    if (!VtpPacket::ParseFecBody(missingSeq, body, header, payload)) {
+        CLOGW("Recovered packet is malformed, seq = %{public}u", missingSeq);
+        return true;
+    }
+    static auto &recovered = CastEngineMetrics::GetInstance().RegisterCounter(METRIC_VTP_FEC_RECOVERED);
+    recovered.Add();
+    pendingFecs_.erase(base);
+    AcceptData(header, payload, now);
+    return true;
+}
+
+void VtpReceiver::OnTick()
+{
+    auto now = Clock::now();
+    auto budget = std::chrono::milliseconds(config_.latencyBudgetMs);
+    for (auto it = pendingFecs_.begin(); it != pendingFecs_.end();) {
+        it = now - it->second.received > budget ? pendingFecs_.erase(it) : std::next(it);
+    }
+    SendNacks(now);
+    DeliverFrames(now);
+}
+
+void VtpReceiver::SendNacks(Clock::time_point now)
+{
+    auto budget = std::chrono::milliseconds(config_.latencyBudgetMs);
+    auto nackDelay = std::chrono::milliseconds(NACK_DELAY_MS);
+    auto nackInterval = std::chrono::milliseconds(config_.nackIntervalMs);
+    std::vector<uint32_t> seqs;
+    for (auto it = missing_.begin(); it != missing_.end();) {
+        auto &missing = it->second;
+        if (now - missing.detected > budget) {
+            it = missing_.erase(it);
+            continue;
+        }
+        bool isDue = missing.isNacked ? now - missing.lastNack >= nackInterval : now - missing.detected >= nackDelay;
+        if (isDue && seqs.size() < VtpPacket::MAX_NACK_SEQS) {
+            seqs.push_back(it->first);
+            missing.isNacked = true;
+            missing.lastNack = now;
+        }
+        ++it;
+    }
+    if (!seqs.empty() && onNack_) {
+        static auto &nacks = CastEngineMetrics::GetInstance().RegisterCounter(METRIC_VTP_NACKS_SENT);
+        nacks.Add();
+        onNack_(seqs);
+    }
+}
+
+void VtpReceiver::DeliverFrames(Clock::time_point now)
+{
+    static auto &dropped = CastEngineMetrics::GetInstance().RegisterCounter(METRIC_VTP_FRAMES_DROPPED);
+    auto budget = std::chrono::milliseconds(config_.latencyBudgetMs);
+    while (!frames_.empty()) {
+        auto it = frames_.begin();
+        if (it->first < nextFrameId_) {
+            frames_.erase(it);
+            continue;
+        }
+        auto &frame = it->second;
+        if (it->first == nextFrameId_ && frame.received == frame.fragCount) {
+            std::vector<uint8_t> data;
+            for (const auto &frag : frame.frags) {
+                data.insert(data.end(), frag.begin(), frag.end());
+            }
+            frames_.erase(it);
+            nextFrameId_++;
+            if (onFrame_) {
+                onFrame_(data.data(), data.size());
+            }
+            continue;
+        }
+        // The next frame is incomplete, or not seen at all while a later one is: wait for it within the budget.
+        if (now - frame.firstSeen <= budget) {
+            break;
+        }
+        uint32_t skipTo = it->first == nextFrameId_ ? nextFrameId_ + 1 : it->first;
+        dropped.Add(skipTo - nextFrameId_);
+        CLOGW("Drop frames [%{public}u, %{public}u) past the latency budget", nextFrameId_, skipTo);
+        nextFrameId_ = skipTo;
+    }
+}
+} // namespace CastEngineService
+} // namespace CastEngine
+} // namespace OHOS
@@ -0,0 +1,105 @@
+/*
+ * Copyright (C) 2023-2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * Description: reordering receiver of the vtp media transport, with fec recovery and nack feedback.
+ * Author: zhangge
+ * Create: 2023-06-05
+ */
+
+#ifndef VTP_RECEIVER_H
+#define VTP_RECEIVER_H
+
+#include <chrono>
+#include <functional>
+#include <map>
+#include <vector>
+
+#include "vtp_packet.h"
+
+namespace OHOS {
+namespace CastEngine {
+namespace CastEngineService {
+/*
+ * Reassembles the frames and hands them out in frame order. A packet missing from the sequence is first looked for
+ * in the xor parity of its group, then asked again with a NACK every nackIntervalMs. Once a frame has waited
+ * latencyBudgetMs it is dropped, so that one lost packet costs a frame instead of stalling the stream.
+ * Not thread safe, driven by the read thread of the connection only.
+ */
+class VtpReceiver {
+public:
+    using FrameCallback = std::function<void(const uint8_t *buf, size_t length)>;
+    using NackCallback = std::function<void(const std::vector<uint32_t> &seqs)>;
+
+    VtpReceiver(const VtpConfig &config, FrameCallback onFrame, NackCallback onNack);
+    ~VtpReceiver() = default;
+
+    void OnData(const VtpHeader &header, const uint8_t *payload);
+    void OnFec(const VtpHeader &header, const uint8_t *payload);
+    void OnTick();
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Frame {
+        uint16_t fragCount{ 0 };
+        uint16_t received{ 0 };
+        std::vector<std::vector<uint8_t>> frags;
+        Clock::time_point firstSeen;
+    };
+
+    struct Missing {
+        Clock::time_point detected;
+        Clock::time_point lastNack;
+        bool isNacked{ false };
+    };
+
+    struct PendingFec {
+        uint32_t count{ 0 };
+        std::vector<uint8_t> parity;
+        Clock::time_point received;
+    };
+
+    // Packets kept for duplicate detection and fec recovery.
+    static constexpr uint32_t RECV_WINDOW = 2048;
+    // A larger jump of the sequence is a restart of the sender rather than a loss.
+    static constexpr uint32_t MAX_TRACKED_GAP = 512;
+    // Frames reassembled at the same time, together with MAX_FRAG_COUNT this bounds the memory a peer can pin.
+    static constexpr uint32_t MAX_PENDING_FRAMES = 64;
+    // Gives a reordered packet a moment to arrive before it is reported lost.
+    static constexpr int NACK_DELAY_MS = 5;
+
+    void AcceptData(const VtpHeader &header, const uint8_t *payload, Clock::time_point now);
+    void TrackSeq(uint32_t seq, Clock::time_point now);
+    void AddFragment(const VtpHeader &header, const uint8_t *payload, Clock::time_point now);
+    void ResolveFecs(uint32_t seq, Clock::time_point now);
+    bool TryRecover(uint32_t base, const PendingFec &fec, Clock::time_point now);
+    void DeliverFrames(Clock::time_point now);
+    void SendNacks(Clock::time_point now);
+
+    VtpConfig config_;
+    FrameCallback onFrame_;
+    NackCallback onNack_;
+    bool hasSeq_{ false };
+    uint32_t highestSeq_{ 0 };
+    std::map<uint32_t, std::vector<uint8_t>> bodies_;
+    std::map<uint32_t, Missing> missing_;
+    std::map<uint32_t, PendingFec> pendingFecs_;
+    bool hasFrame_{ false };
+    uint32_t nextFrameId_{ 0 };
+    std::map<uint32_t, Frame> frames_;
+};
+} // namespace CastEngineService
+} // namespace CastEngine
+} // namespace OHOS
+
+#endif
@@ -0,0 +1,251 @@
+/*
+ * Copyright (C) 2023-2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * Description: paced sender of the vtp media transport, with fec and nack driven retransmission.
+ * Author: zhangge
+ * Create: 2023-06-05
+ */
+
+#include "vtp_sender.h"
+
+#include <algorithm>
+
+#include "cast_engine_log.h"
+#include "cast_engine_metrics.h"
+#include "utils.h"
+
+namespace OHOS {
+namespace CastEngine {
+namespace CastEngineService {
+DEFINE_CAST_ENGINE_LABEL("Cast-VtpSender");
+
+VtpSender::VtpSender(const VtpConfig &config, Output output) : config_(config), output_(std::move(output))
+{
+    config_.fecGroupSize = std::min(config_.fecGroupSize, VtpPacket::MAX_FEC_GROUP_SIZE);
+    config_.pacingBurstPackets = std::max<uint32_t>(config_.pacingBurstPackets, 1);
+}
+
+VtpSender::~VtpSender()
+{
+    Stop();
+}
+
+void VtpSender::Start()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (isRunning_) {
+        return;
+    }
+    isRunning_ = true;
+    tokens_ = static_cast<double>(config_.pacingBurstPackets * VtpPacket::MAX_PACKET_LEN);
+    lastRefill_ = Clock::now();
+    pacer_ = std::thread([this] {
+        Utils::SetThreadName("VtpPacer");
+        PaceLoop();
+    });
+}
+
+void VtpSender::Stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        isRunning_ = false;
+        queue_.clear();
+        retransmitQueue_.clear();
+        queuedBytes_ = 0;
+        history_.clear();
+        cond_.notify_all();
+    }
+    if (pacer_.joinable() && pacer_.get_id() != std::this_thread::get_id()) {
+        pacer_.join();
+    }
+}
+
+bool VtpSender::SendFrame(const uint8_t *buf, size_t length)
+{
+    if (buf == nullptr || length == 0) {
+        return false;
+    }
+    size_t fragCount = (length + VtpPacket::MAX_PAYLOAD_LEN - 1) / VtpPacket::MAX_PAYLOAD_LEN;
+    if (length > VtpPacket::MAX_FRAME_LEN) {
+        CLOGE("Frame too large, length = %{public}zu", length);
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!isRunning_) {
+        return false;
+    }
+    if (queuedBytes_ + length > MAX_QUEUED_BYTES) {
+        // The link can not keep up; dropping here keeps the delay bounded, the decoder recovers at the next key frame.
+        static auto &dropped = CastEngineMetrics::GetInstance().RegisterCounter(METRIC_VTP_FRAMES_DROPPED);
+        dropped.Add();
+        CLOGW("Send queue full, drop frame, queued = %{public}zu", queuedBytes_);
+        return false;
+    }
+
+    auto now = Clock::now();
+    VtpHeader header;
+    header.type = VtpPacketType::DATA;
+    header.frameId = nextFrameId_++;
+    header.fragCount = static_cast<uint16_t>(fragCount);
+    for (size_t i = 0; i < fragCount; i++) {
+        size_t offset = i * VtpPacket::MAX_PAYLOAD_LEN;
+        header.seq = nextSeq_++;
+        header.fragIndex = static_cast<uint16_t>(i);
+        header.payloadLength = static_cast<uint16_t>(std::min(VtpPacket::MAX_PAYLOAD_LEN, length - offset));
+        auto packet = std::make_shared<std::vector<uint8_t>>(VtpPacket::Build(header, buf + offset));
+        AddToHistoryLocked(header.seq, packet, now);
+        queuedBytes_ += packet->size();
+        queue_.push_back(packet);
+        // After the packet, so that a full group queues its parity behind the last packet it covers.
+        AddToFecGroupLocked(header, buf + offset);
+    }
+    if (fecCount_ >= MIN_FEC_FLUSH_PACKETS) {
+        FlushFecGroupLocked();
+    }
+    cond_.notify_one();
+    return true;
+}
+
+void VtpSender::AddToHistoryLocked(uint32_t seq, const Packet &packet, Clock::time_point now)
+{
+    auto budget = std::chrono::milliseconds(config_.latencyBudgetMs);
+    while (!history_.empty() &&
+        (history_.size() >= MAX_HISTORY_PACKETS || now - history_.begin()->second.time > budget)) {
+        history_.erase(history_.begin());
+    }
+    history_[seq] = SentPacket{ packet, now };
+}
+
+void VtpSender::AddToFecGroupLocked(const VtpHeader &header, const uint8_t *payload)
+{
+    if (config_.fecGroupSize == 0) {
+        return;
+    }
+    if (fecCount_ == 0) {
+        fecBase_ = header.seq;
+        fecParity_.clear();
+    }
+    VtpPacket::XorInto(fecParity_, VtpPacket::GetFecBody(header, payload));
+    if (++fecCount_ >= config_.fecGroupSize) {
+        FlushFecGroupLocked();
+    }
+}
+
+void VtpSender::FlushFecGroupLocked()
+{
+    if (fecCount_ == 0) {
+        return;
+    }
+    VtpHeader header;
+    header.type = VtpPacketType::FEC;
+    header.seq = fecBase_;
+    header.frameId = fecCount_;
+    header.payloadLength = static_cast<uint16_t>(fecParity_.size());
+    auto packet = std::make_shared<std::vector<uint8_t>>(VtpPacket::Build(header, fecParity_.data()));
+    queuedBytes_ += packet->size();
+    queue_.push_back(packet);
+    fecCount_ = 0;
+}
+
+void VtpSender::OnNack(const VtpHeader &header, const uint8_t *payload)
+{
+    static auto &retransmits = CastEngineMetrics::GetInstance().RegisterCounter(METRIC_VTP_RETRANSMITS);
+    size_t count = std::min<size_t>({ header.seq, header.payloadLength / sizeof(uint32_t), VtpPacket::MAX_NACK_SEQS });
+    auto now = Clock::now();
+    auto budget = std::chrono::milliseconds(config_.latencyBudgetMs);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!isRunning_) {
+        return;
+    }
+    nackedPackets_ += count;
+    for (size_t i = 0; i < count; i++) {
+        uint32_t seq = VtpPacket::ReadUint32(payload + i * sizeof(uint32_t));
+        auto it = history_.find(seq);
+        // Too late to be played anyway, the receiver has given up on it too.
+        if (it == history_.end() || now - it->second.time > budget) {
+            continue;
+        }
+        retransmitQueue_.push_back(it->second.packet);
+        retransmits.Add();
+    }
+    cond_.notify_one();
+}
+
+bool VtpSender::WaitForTokensLocked(std::unique_lock<std::mutex> &lock, size_t length)
+{
+    if (config_.pacingRateKbps <= 0) {
+        return true;
+    }
+    double bytesPerUs = static_cast<double>(config_.pacingRateKbps) / BITS_PER_BYTE / US_PER_MS;
+    double burst = static_cast<double>(config_.pacingBurstPackets * VtpPacket::MAX_PACKET_LEN);
+    auto now = Clock::now();
+    auto elapsedUs = std::chrono::duration_cast<std::chrono::microseconds>(now - lastRefill_).count();
+    tokens_ = std::min(burst, tokens_ + elapsedUs * bytesPerUs);
+    lastRefill_ = now;
+    if (tokens_ >= static_cast<double>(length)) {
+        tokens_ -= static_cast<double>(length);
+        return true;
+    }
+    auto waitUs = static_cast<int64_t>((static_cast<double>(length) - tokens_) / bytesPerUs) + 1;
+    cond_.wait_for(lock, std::chrono::microseconds(waitUs));
+    return false;
+}
+
+size_t VtpSender::GetQueuedBytes()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return queuedBytes_;
+}
+
+void VtpSender::GetLinkStats(ChannelLinkStats &stats)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats.sentBytes = sentBytes_;
+    stats.sentPackets = sentPackets_;
+    stats.lostPackets = nackedPackets_;
+}
+
+void VtpSender::PaceLoop()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        cond_.wait(lock, [this] { return !isRunning_ || !queue_.empty() || !retransmitQueue_.empty(); });
+        if (!isRunning_) {
+            break;
+        }
+        bool isRetransmit = !retransmitQueue_.empty();
+        Packet packet = isRetransmit ? retransmitQueue_.front() : queue_.front();
+        // Woken up early or short of tokens: look at the queues again, a retransmission may have come in.
+        if (!WaitForTokensLocked(lock, packet->size())) {
+            continue;
+        }
+        if (isRetransmit) {
+            retransmitQueue_.pop_front();
+        } else {
+            queue_.pop_front();
+            queuedBytes_ -= packet->size();
+        }
+        sentBytes_ += packet->size();
+        sentPackets_++;
+        lock.unlock();
+        output_(packet->data(), packet->size());
+        lock.lock();
+    }
+    CLOGI("Pacer out.");
+}
+} // namespace CastEngineService
+} // namespace CastEngine
+} // namespace OHOS
@@ -0,0 +1,107 @@
+/*
+ * Copyright (C) 2023-2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * Description: paced sender of the vtp media transport, with fec and nack driven retransmission.
+ * Author: zhangge
+ * Create: 2023-06-05
+ */
+
+#ifndef VTP_SENDER_H
+#define VTP_SENDER_H
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "channel.h"
+#include "vtp_packet.h"
+
+namespace OHOS {
+namespace CastEngine {
+namespace CastEngineService {
+/*
+ * Splits every frame into sequence numbered data packets, follows each group of fecGroupSize of them with one xor
+ * parity packet, and hands them to the socket from a pacer thread at pacingRateKbps with a burst of
+ * pacingBurstPackets, so that a key frame does not overflow the queue of the wifi driver at once.
+ * The sent packets are kept for latencyBudgetMs, so that the ones the receiver reports lost are retransmitted ahead
+ * of the new ones.
+ */
+class VtpSender {
+public:
+    using Output = std::function<bool(const uint8_t *buf, size_t length)>;
+
+    VtpSender(const VtpConfig &config, Output output);
+    ~VtpSender();
+
+    void Start();
+    void Stop();
+    bool SendFrame(const uint8_t *buf, size_t length);
+    void OnNack(const VtpHeader &header, const uint8_t *payload);
+    size_t GetQueuedBytes();
+    // Each sequence number nacked by the receiver counts as a lost packet, whether it is retransmitted or not.
+    void GetLinkStats(ChannelLinkStats &stats);
+
+private:
+    using Clock = std::chrono::steady_clock;
+    using Packet = std::shared_ptr<std::vector<uint8_t>>;
+
+    struct SentPacket {
+        Packet packet;
+        Clock::time_point time;
+    };
+
+    static constexpr size_t MAX_QUEUED_BYTES = 4 * 1024 * 1024;
+    static constexpr size_t MAX_HISTORY_PACKETS = 4096;
+    // A parity packet for a single data packet is a plain copy, so a frame end only closes groups of two or more.
+    static constexpr uint32_t MIN_FEC_FLUSH_PACKETS = 2;
+    static constexpr int64_t BITS_PER_BYTE = 8;
+    static constexpr int64_t US_PER_MS = 1000;
+
+    void PaceLoop();
+    bool WaitForTokensLocked(std::unique_lock<std::mutex> &lock, size_t length);
+    void AddToFecGroupLocked(const VtpHeader &header, const uint8_t *payload);
+    void FlushFecGroupLocked();
+    void AddToHistoryLocked(uint32_t seq, const Packet &packet, Clock::time_point now);
+
+    VtpConfig config_;
+    Output output_;
+    std::mutex mutex_;
+    std::condition_variable cond_;
+    bool isRunning_{ false };
+    std::thread pacer_;
+    std::deque<Packet> queue_;
+    std::deque<Packet> retransmitQueue_;
+    size_t queuedBytes_{ 0 };
+    uint64_t sentBytes_{ 0 };
+    uint64_t sentPackets_{ 0 };
+    uint64_t nackedPackets_{ 0 };
+    uint32_t nextSeq_{ 0 };
+    uint32_t nextFrameId_{ 0 };
+    std::map<uint32_t, SentPacket> history_;
+    uint32_t fecBase_{ 0 };
+    uint32_t fecCount_{ 0 };
+    std::vector<uint8_t> fecParity_;
+    double tokens_{ 0 };
+    Clock::time_point lastRefill_;
+};
+} // namespace CastEngineService
+} // namespace CastEngine
+} // namespace OHOS
+
+#endif
@@ -22,6 +22,7 @@
 #include <mutex>
 #include "permission.h"
 #include "cast_session_impl.h"
+#include "mirror_input_ring.h"
 #include "oh_remote_control_event.h"
 #include "mirror_player_impl_stub.h"
 
@@ -41,8 +42,12 @@ public:
     int32_t Release() override;
     int32_t GetDisplayId(std::string &displayId) override;
     int32_t ResizeVirtualScreen(uint32_t width, uint32_t height) override;
+    int32_t SetupInputRing(sptr<Ashmem> &ashmem) override;
+    int32_t DrainInputRing() override;
 private:
     wptr<CastSessionImpl> session_;
+    std::mutex inputRingMutex_;
+    std::shared_ptr<MirrorInputRing> inputRing_;
 };
 } // namespace CastEngineService
 } // namespace CastEngine
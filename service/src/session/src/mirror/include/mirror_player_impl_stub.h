@@ -43,6 +43,8 @@ private:
     int32_t DoRelease(MessageParcel &data, MessageParcel &reply);
     int32_t DoGetDisplayId(MessageParcel &data, MessageParcel &reply);
     int32_t DoResizeVirtualScreen(MessageParcel &data, MessageParcel &reply);
+    int32_t DoSetupInputRing(MessageParcel &data, MessageParcel &reply);
+    int32_t DoDrainInputRing(MessageParcel &data, MessageParcel &reply);
 };
 } // namespace CastEngineService
 } // namespace CastEngine
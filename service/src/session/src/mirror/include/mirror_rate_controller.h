@@ -0,0 +1,149 @@
+/*
+ * Copyright (C) 2023-2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * Description: link estimate and hysteresis controller for the bitrate and fps of the mirror encoder.
+ * Author: zhangge
+ * Create: 2023-06-05
+ */
+
+#ifndef MIRROR_RATE_CONTROLLER_H
+#define MIRROR_RATE_CONTROLLER_H
+
+#include <cstdint>
+
+#include "channel.h"
+
+namespace OHOS {
+namespace CastEngine {
+namespace CastEngineService {
+// One periodic look at the video channel; the link counters are cumulative.
+struct MirrorRateSample {
+    int64_t timeMs{ 0 };
+    size_t queuedBytes{ 0 };
+    bool hasLinkStats{ false };
+    ChannelLinkStats linkStats;
+};
+
+enum class LinkState {
+    CLEAR,
+    HOLD,
+    CONGESTED,
+};
+
+struct LinkEstimate {
+    LinkState state{ LinkState::HOLD };
+    uint64_t throughputBps{ 0 };
+    // cwnd over rtt, 0 when the link does not report them.
+    uint64_t capacityBps{ 0 };
+    int64_t queueDelayMs{ 0 };
+    int64_t rttInflationMs{ 0 };
+    uint32_t lossPermille{ 0 };
+};
+
+/*
+ * Turns the samples into a link state from three signals: the time the queued bytes need at the measured
+ * throughput, the rtt above the lowest one seen in the last MIN_RTT_WINDOW_MS, and the share of packets the link
+ * lost or the receiver nacked. Any one of them past its congested threshold makes the link CONGESTED; it is CLEAR
+ * only while all of them are under their clear threshold, and HOLD in between.
+ */
+class MirrorBandwidthEstimator {
+public:
+    MirrorBandwidthEstimator() = default;
+    ~MirrorBandwidthEstimator() = default;
+
+    LinkEstimate Update(const MirrorRateSample &sample, uint64_t targetBps);
+
+private:
+    static constexpr double THROUGHPUT_GAIN = 0.25;
+    static constexpr int64_t MIN_RTT_WINDOW_MS = 10000;
+    static constexpr int64_t MAX_QUEUE_DELAY_MS = 10000;
+    static constexpr uint64_t MIN_LOSS_PACKETS = 20;
+    static constexpr int64_t CONGESTED_QUEUE_DELAY_MS = 100;
+    static constexpr int64_t CONGESTED_RTT_INFLATION_MS = 60;
+    static constexpr uint32_t CONGESTED_LOSS_PERMILLE = 50;
+    static constexpr int64_t CLEAR_QUEUE_DELAY_MS = 20;
+    static constexpr int64_t CLEAR_RTT_INFLATION_MS = 15;
+    static constexpr uint32_t CLEAR_LOSS_PERMILLE = 10;
+
+    bool hasLast_{ false };
+    MirrorRateSample last_;
+    double throughputBps_{ 0 };
+    uint32_t minRttUs_{ 0 };
+    int64_t minRttTimeMs_{ 0 };
+};
+
+/*
+ * Drives the encoder rate from the link state with asymmetric hysteresis: a congested link cuts the bitrate at once,
+ * to DECREASE_FACTOR of it or to below the measured throughput by enough to drain the queue, and again within
+ * DECREASE_INTERVAL_MS only if the queue kept growing, so that one queue is not answered twice. A clear link raises
+ * it only after it stayed clear for INCREASE_HOLD_MS, by FAST_INCREASE_FACTOR while the congestion window over the
+ * rtt is at least twice the bitrate, by INCREASE_FACTOR otherwise, and not at all while it is below the bitrate.
+ * Once the bitrate is at its floor the fps gives way, and it is given back before the bitrate rises again.
+ */
+class MirrorRateController {
+public:
+    struct Rate {
+        uint32_t bitrate{ 0 };
+        uint32_t fps{ 0 };
+    };
+
+    MirrorRateController(uint32_t minBitrate, uint32_t maxBitrate, uint32_t startBitrate, uint32_t minFps,
+        uint32_t maxFps);
+    ~MirrorRateController() = default;
+
+    // Returns true when the rate to apply has changed.
+    bool OnSample(const MirrorRateSample &sample);
+    Rate GetRate() const
+    {
+        return rate_;
+    }
+    const LinkEstimate &GetEstimate() const
+    {
+        return estimate_;
+    }
+
+private:
+    static constexpr double DECREASE_FACTOR = 0.8;
+    static constexpr double INCREASE_FACTOR = 1.08;
+    static constexpr double FAST_INCREASE_FACTOR = 1.25;
+    static constexpr uint64_t FAST_INCREASE_HEADROOM = 2;
+    static constexpr double CAPACITY_HEADROOM = 0.9;
+    static constexpr int64_t DECREASE_INTERVAL_MS = 1000;
+    static constexpr double QUEUE_DRAIN_MS = 2000;
+    static constexpr double DRAIN_SHARE = 0.5;
+    static constexpr int64_t INCREASE_HOLD_MS = 3000;
+    static constexpr int64_t INCREASE_INTERVAL_MS = 1000;
+    static constexpr uint32_t FPS_STEP_NUM = 3;
+    static constexpr uint32_t FPS_STEP_DEN = 4;
+
+    bool Decrease(int64_t nowMs, size_t queuedBytes);
+    bool Increase(int64_t nowMs);
+
+    uint32_t minBitrate_;
+    uint32_t maxBitrate_;
+    uint32_t minFps_;
+    uint32_t maxFps_;
+    Rate rate_;
+    MirrorBandwidthEstimator estimator_;
+    LinkEstimate estimate_;
+    int64_t lastChangeMs_{ 0 };
+    int64_t lastDecreaseMs_{ 0 };
+    int64_t lastDecreaseQueueDelayMs_{ 0 };
+    int64_t clearSinceMs_{ -1 };
+    bool hasDecreased_{ false };
+};
+} // namespace CastEngineService
+} // namespace CastEngine
+} // namespace OHOS
+
+#endif
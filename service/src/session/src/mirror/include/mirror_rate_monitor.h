@@ -0,0 +1,66 @@
+/*
+ * Copyright (C) 2023-2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * Description: samples the video channel of a mirror source and adapts the encoder rate to it.
+ * Author: zhangge
+ * Create: 2023-06-05
+ */
+
+#ifndef MIRROR_RATE_MONITOR_H
+#define MIRROR_RATE_MONITOR_H
+
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+
+#include "channel.h"
+#include "mirror_rate_controller.h"
+
+namespace OHOS {
+namespace CastEngine {
+namespace CastEngineService {
+/*
+ * Looks at the video channel every SAMPLE_INTERVAL_MS on its own thread and reports each rate the controller
+ * settles on. The thread holds the monitor until Stop, the channel only weakly, so a monitor left running ends
+ * with its channel.
+ */
+class MirrorRateMonitor : public std::enable_shared_from_this<MirrorRateMonitor> {
+public:
+    using RateListener = std::function<void(const MirrorRateController::Rate &rate)>;
+
+    static constexpr int64_t SAMPLE_INTERVAL_MS = 200;
+
+    MirrorRateMonitor(std::shared_ptr<Channel> channel, const MirrorRateController &controller,
+        RateListener listener);
+    ~MirrorRateMonitor() = default;
+
+    void Start();
+    void Stop();
+
+private:
+    void Run();
+    bool Sample(MirrorRateSample &sample);
+
+    std::weak_ptr<Channel> channel_;
+    MirrorRateController controller_;
+    RateListener listener_;
+    std::mutex mutex_;
+    std::condition_variable cond_;
+    bool isRunning_{ false };
+};
+} // namespace CastEngineService
+} // namespace CastEngine
+} // namespace OHOS
+
+#endif
@@ -19,6 +19,7 @@
 #include "mirror_player_impl.h"
 #include "cast_engine_errors.h"
 #include "cast_engine_log.h"
+#include "cast_engine_metrics.h"
 
 namespace OHOS {
 namespace CastEngine {
@@ -124,6 +125,51 @@ int32_t MirrorPlayerImpl::ResizeVirtualScreen(uint32_t width, uint32_t height)
     }
     return session->ResizeVirtualScreen(width, height);
 }
+
+int32_t MirrorPlayerImpl::SetupInputRing(sptr<Ashmem> &ashmem)
+{
+    CLOGD("SetupInputRing in");
+    std::lock_guard<std::mutex> lock(inputRingMutex_);
+    if (!inputRing_) {
+        inputRing_ = MirrorInputRing::Create();
+        if (!inputRing_) {
+            return CAST_ENGINE_ERROR;
+        }
+    }
+    ashmem = inputRing_->GetAshmem();
+    return CAST_ENGINE_SUCCESS;
+}
+
+int32_t MirrorPlayerImpl::DrainInputRing()
+{
+    static auto &events = CastEngineMetrics::GetInstance().RegisterCounter(METRIC_MIRROR_INPUT_EVENTS);
+    static auto &drains = CastEngineMetrics::GetInstance().RegisterCounter(METRIC_MIRROR_INPUT_DRAINS);
+    static auto &queuedUs = CastEngineMetrics::GetInstance().RegisterHistogram(METRIC_MIRROR_INPUT_QUEUED_US);
+
+    std::shared_ptr<MirrorInputRing> ring;
+    {
+        std::lock_guard<std::mutex> lock(inputRingMutex_);
+        ring = inputRing_;
+    }
+    auto session = session_.promote();
+    if (!ring || !session) {
+        CLOGE("input ring or session is nullptr");
+        return CAST_ENGINE_ERROR;
+    }
+
+    size_t count = ring->Drain([&session](MirrorInputRing::EventKind kind, const OHRemoteControlEvent &event,
+        int64_t queuedTimeUs) {
+        queuedUs.Record(static_cast<uint64_t>(queuedTimeUs));
+        int32_t ret = kind == MirrorInputRing::EventKind::INJECT ? session->InjectEvent(event) :
+            session->DeliverInputEvent(event);
+        if (ret != CAST_ENGINE_SUCCESS) {
+            CLOGE("Failed to handle input event %{public}d, ret:%{public}d", event.eventType, ret);
+        }
+    });
+    events.Add(static_cast<int64_t>(count));
+    drains.Add();
+    return CAST_ENGINE_SUCCESS;
+}
 } // namespace CastEngineService
 } // namespace CastEngine
 } // namespace OHOS
\ No newline at end of file
@@ -18,6 +18,7 @@
 
 #include "mirror_player_impl_stub.h"
 #include "cast_engine_common_helper.h"
+#include "cast_engine_errors.h"
 #include "permission.h"
 
 namespace OHOS {
@@ -43,6 +44,8 @@ MirrorPlayerImplStub::MirrorPlayerImplStub()
     FILL_SINGLE_STUB_TASK(SET_APP_INFO, &MirrorPlayerImplStub::DoSetAppInfo);
     FILL_SINGLE_STUB_TASK(GET_DISPLAYID, &MirrorPlayerImplStub::DoGetDisplayId);
     FILL_SINGLE_STUB_TASK(RESIZE_VIRTUAL_SCREEN, &MirrorPlayerImplStub::DoResizeVirtualScreen);
+    FILL_SINGLE_STUB_TASK(SETUP_INPUT_RING, &MirrorPlayerImplStub::DoSetupInputRing);
+    FILL_SINGLE_STUB_TASK(DRAIN_INPUT_RING, &MirrorPlayerImplStub::DoDrainInputRing);
 }
 
 int32_t MirrorPlayerImplStub::DoPlayTask(MessageParcel &data, MessageParcel &reply)
@@ -206,6 +209,42 @@ int32_t MirrorPlayerImplStub::DoResizeVirtualScreen(MessageParcel &data, Message
 
     return ERR_NONE;
 }
+
+int32_t MirrorPlayerImplStub::DoSetupInputRing(MessageParcel &data, MessageParcel &reply)
+{
+    if (!Permission::CheckMirrorPermission()) {
+        return ERR_UNKNOWN_TRANSACTION;
+    }
+
+    static_cast<void>(data);
+    sptr<Ashmem> ashmem;
+    int32_t ret = SetupInputRing(ashmem);
+    if (!reply.WriteInt32(ret)) {
+        CLOGE("Failed to write ret:%{public}d", ret);
+        return IPC_STUB_WRITE_PARCEL_ERR;
+    }
+    if (ret == CAST_ENGINE_SUCCESS && !reply.WriteAshmem(ashmem)) {
+        CLOGE("Failed to write the input ring");
+        return IPC_STUB_WRITE_PARCEL_ERR;
+    }
+
+    return ERR_NONE;
+}
+
+int32_t MirrorPlayerImplStub::DoDrainInputRing(MessageParcel &data, MessageParcel &reply)
+{
+    if (!Permission::CheckMirrorPermission()) {
+        return ERR_UNKNOWN_TRANSACTION;
+    }
+
+    static_cast<void>(data);
+    if (!reply.WriteInt32(DrainInputRing())) {
+        CLOGE("Failed to write int value");
+        return IPC_STUB_WRITE_PARCEL_ERR;
+    }
+
+    return ERR_NONE;
+}
 } // namespace CastEngineService
 } // namespace CastEngine
 } // namespace OHOS
@@ -0,0 +1,165 @@
+/*
+ * Copyright (C) 2023-2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * Description: link estimate and hysteresis controller for the bitrate and fps of the mirror encoder.
+ * Author: zhangge
+ * Create: 2023-06-05
+ */
+
+#include "mirror_rate_controller.h"
+
+#include <algorithm>
+
+namespace OHOS {
+namespace CastEngine {
+namespace CastEngineService {
+namespace {
+constexpr double BITS_PER_BYTE = 8;
+constexpr double MS_PER_SECOND = 1000;
+constexpr double US_PER_SECOND = 1000000;
+constexpr int64_t US_PER_MS = 1000;
+constexpr uint32_t PERMILLE = 1000;
+} // namespace
+
+LinkEstimate MirrorBandwidthEstimator::Update(const MirrorRateSample &sample, uint64_t targetBps)
+{
+    LinkEstimate estimate;
+    const auto &stats = sample.linkStats;
+    if (hasLast_ && last_.hasLinkStats && sample.hasLinkStats && sample.timeMs > last_.timeMs &&
+        stats.sentBytes >= last_.linkStats.sentBytes) {
+        double bps = static_cast<double>(stats.sentBytes - last_.linkStats.sentBytes) * BITS_PER_BYTE *
+            MS_PER_SECOND / static_cast<double>(sample.timeMs - last_.timeMs);
+        throughputBps_ = throughputBps_ <= 0 ? bps : throughputBps_ + THROUGHPUT_GAIN * (bps - throughputBps_);
+
+        uint64_t sent = stats.sentPackets > last_.linkStats.sentPackets ?
+            stats.sentPackets - last_.linkStats.sentPackets : 0;
+        uint64_t lost = stats.lostPackets > last_.linkStats.lostPackets ?
+            stats.lostPackets - last_.linkStats.lostPackets : 0;
+        if (sent >= MIN_LOSS_PACKETS) {
+            estimate.lossPermille = static_cast<uint32_t>(std::min<uint64_t>(lost * PERMILLE / sent, PERMILLE));
+        }
+    }
+    estimate.throughputBps = static_cast<uint64_t>(throughputBps_);
+
+    // Before the first throughput is known the queue drains at the rate it is filled with.
+    double drainBps = throughputBps_ > 0 ? throughputBps_ : static_cast<double>(targetBps);
+    if (drainBps > 0) {
+        estimate.queueDelayMs = std::min(MAX_QUEUE_DELAY_MS, static_cast<int64_t>(
+            static_cast<double>(sample.queuedBytes) * BITS_PER_BYTE * MS_PER_SECOND / drainBps));
+    }
+
+    if (sample.hasLinkStats && stats.rttUs > 0) {
+        if (minRttUs_ == 0 || stats.rttUs <= minRttUs_ || sample.timeMs - minRttTimeMs_ > MIN_RTT_WINDOW_MS) {
+            minRttUs_ = stats.rttUs;
+            minRttTimeMs_ = sample.timeMs;
+        }
+        estimate.rttInflationMs = static_cast<int64_t>(stats.rttUs - minRttUs_) / US_PER_MS;
+        estimate.capacityBps = static_cast<uint64_t>(static_cast<double>(stats.cwndBytes) * BITS_PER_BYTE *
+            US_PER_SECOND / stats.rttUs);
+    }
+
+    if (estimate.queueDelayMs >= CONGESTED_QUEUE_DELAY_MS || estimate.rttInflationMs >= CONGESTED_RTT_INFLATION_MS ||
+        estimate.lossPermille >= CONGESTED_LOSS_PERMILLE) {
+        estimate.state = LinkState::CONGESTED;
+    } else if (estimate.queueDelayMs < CLEAR_QUEUE_DELAY_MS && estimate.rttInflationMs < CLEAR_RTT_INFLATION_MS &&
+        estimate.lossPermille < CLEAR_LOSS_PERMILLE) {
+        estimate.state = LinkState::CLEAR;
+    } else {
+        estimate.state = LinkState::HOLD;
+    }
+    last_ = sample;
+    hasLast_ = true;
+    return estimate;
+}
+
+MirrorRateController::MirrorRateController(uint32_t minBitrate, uint32_t maxBitrate, uint32_t startBitrate,
+    uint32_t minFps, uint32_t maxFps)
+    : minBitrate_(minBitrate), maxBitrate_(std::max(minBitrate, maxBitrate)), minFps_(std::min(minFps, maxFps)),
+      maxFps_(maxFps)
+{
+    rate_.bitrate = std::clamp(startBitrate, minBitrate_, maxBitrate_);
+    rate_.fps = maxFps_;
+}
+
+bool MirrorRateController::OnSample(const MirrorRateSample &sample)
+{
+    estimate_ = estimator_.Update(sample, rate_.bitrate);
+    switch (estimate_.state) {
+        case LinkState::CONGESTED:
+            clearSinceMs_ = -1;
+            return Decrease(sample.timeMs, sample.queuedBytes);
+        case LinkState::CLEAR:
+            if (clearSinceMs_ < 0) {
+                clearSinceMs_ = sample.timeMs;
+            }
+            return Increase(sample.timeMs);
+        default:
+            clearSinceMs_ = -1;
+            return false;
+    }
+}
+
+bool MirrorRateController::Decrease(int64_t nowMs, size_t queuedBytes)
+{
+    // Within the interval only a queue that still grows asks for another cut.
+    if (hasDecreased_ && nowMs - lastDecreaseMs_ < DECREASE_INTERVAL_MS &&
+        estimate_.queueDelayMs <= lastDecreaseQueueDelayMs_) {
+        return false;
+    }
+    Rate rate = rate_;
+    if (rate.bitrate > minBitrate_) {
+        double target = rate.bitrate * DECREASE_FACTOR;
+        // The queue drains at the throughput, asking for more than that only keeps it growing; leave room for what
+        // is already queued to go within QUEUE_DRAIN_MS, but never give up more than DRAIN_SHARE of the throughput.
+        if (estimate_.throughputBps > 0) {
+            double throughput = static_cast<double>(estimate_.throughputBps);
+            double drainBps = static_cast<double>(queuedBytes) * BITS_PER_BYTE * MS_PER_SECOND / QUEUE_DRAIN_MS;
+            target = std::min(target, std::max(throughput * CAPACITY_HEADROOM - drainBps, throughput * DRAIN_SHARE));
+        }
+        rate.bitrate = target > minBitrate_ ? static_cast<uint32_t>(target) : minBitrate_;
+    } else if (rate.fps > minFps_) {
+        rate.fps = std::max(minFps_, rate.fps * FPS_STEP_NUM / FPS_STEP_DEN);
+    } else {
+        return false;
+    }
+    hasDecreased_ = true;
+    lastDecreaseMs_ = nowMs;
+    lastDecreaseQueueDelayMs_ = estimate_.queueDelayMs;
+    lastChangeMs_ = nowMs;
+    rate_ = rate;
+    return true;
+}
+
+bool MirrorRateController::Increase(int64_t nowMs)
+{
+    if (nowMs - clearSinceMs_ < INCREASE_HOLD_MS || nowMs - lastChangeMs_ < INCREASE_INTERVAL_MS) {
+        return false;
+    }
+    Rate rate = rate_;
+    if (rate.fps < maxFps_) {
+        rate.fps = std::min(maxFps_, rate.fps * FPS_STEP_DEN / FPS_STEP_NUM + 1);
+    } else if (rate.bitrate < maxBitrate_ &&
+        (estimate_.capacityBps == 0 || estimate_.capacityBps >= static_cast<uint64_t>(rate.bitrate))) {
+        double factor = estimate_.capacityBps >= FAST_INCREASE_HEADROOM * rate.bitrate ?
+            FAST_INCREASE_FACTOR : INCREASE_FACTOR;
+        rate.bitrate = static_cast<uint32_t>(std::min<double>(maxBitrate_, rate.bitrate * factor));
+    } else {
+        return false;
+    }
+    lastChangeMs_ = nowMs;
+    rate_ = rate;
+    return true;
+}
+} // namespace CastEngineService
+} // namespace CastEngine
+} // namespace OHOS
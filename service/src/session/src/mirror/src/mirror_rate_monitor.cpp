@@ -0,0 +1,111 @@
+/*
+ * Copyright (C) 2023-2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * Description: samples the video channel of a mirror source and adapts the encoder rate to it.
+ * Author: zhangge
+ * Create: 2023-06-05
+ */
+
+#include "mirror_rate_monitor.h"
+
+#include <cinttypes>
+#include <thread>
+
+#include "cast_engine_log.h"
+#include "cast_engine_metrics.h"
+#include "utils.h"
+
+namespace OHOS {
+namespace CastEngine {
+namespace CastEngineService {
+DEFINE_CAST_ENGINE_LABEL("Cast-MirrorRateMonitor");
+
+MirrorRateMonitor::MirrorRateMonitor(std::shared_ptr<Channel> channel, const MirrorRateController &controller,
+    RateListener listener)
+    : channel_(channel), controller_(controller), listener_(std::move(listener))
+{
+}
+
+void MirrorRateMonitor::Start()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (isRunning_) {
+            return;
+        }
+        isRunning_ = true;
+    }
+    auto monitor = shared_from_this();
+    std::thread([monitor] {
+        Utils::SetThreadName("MirrorRateMonitor");
+        monitor->Run();
+    }).detach();
+}
+
+void MirrorRateMonitor::Stop()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    isRunning_ = false;
+    cond_.notify_all();
+}
+
+bool MirrorRateMonitor::Sample(MirrorRateSample &sample)
+{
+    auto channel = channel_.lock();
+    if (!channel) {
+        return false;
+    }
+    sample.timeMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+    sample.queuedBytes = channel->GetSendQueueDepth();
+    sample.hasLinkStats = channel->GetLinkStats(sample.linkStats);
+    return true;
+}
+
+void MirrorRateMonitor::Run()
+{
+    static auto &rateChanges = CastEngineMetrics::GetInstance().RegisterCounter(METRIC_MIRROR_RATE_CHANGES);
+    static auto &bitrateGauge = CastEngineMetrics::GetInstance().RegisterGauge(METRIC_MIRROR_BITRATE);
+    bitrateGauge.Set(controller_.GetRate().bitrate);
+    CLOGI("Start, bitrate %{public}u fps %{public}u", controller_.GetRate().bitrate, controller_.GetRate().fps);
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            if (cond_.wait_for(lock, std::chrono::milliseconds(SAMPLE_INTERVAL_MS), [this] { return !isRunning_; })) {
+                break;
+            }
+        }
+        MirrorRateSample sample;
+        if (!Sample(sample)) {
+            break;
+        }
+        if (!controller_.OnSample(sample)) {
+            continue;
+        }
+        auto rate = controller_.GetRate();
+        const auto &estimate = controller_.GetEstimate();
+        rateChanges.Add();
+        bitrateGauge.Set(rate.bitrate);
+        CLOGI("Rate %{public}u bps %{public}u fps, link %{public}d: throughput %{public}" PRIu64 " queue "
+            "%{public}" PRId64 " ms rtt +%{public}" PRId64 " ms loss %{public}u permille", rate.bitrate, rate.fps,
+            static_cast<int>(estimate.state), estimate.throughputBps, estimate.queueDelayMs, estimate.rttInflationMs,
+            estimate.lossPermille);
+        if (listener_) {
+            listener_(rate);
+        }
+    }
+    CLOGI("Out.");
+}
+} // namespace CastEngineService
+} // namespace CastEngine
+} // namespace OHOS
@@ -51,7 +51,7 @@ public:
     virtual bool SendEventChange(int moduleId, int event, const std::string &param) = 0;
     virtual void SetupPort(int serverPort, int remotectlPort, int cpPort) = 0;
     virtual void SendCastRenderReadyOption(int isReady) = 0;
-    virtual void DetectKeepAliveFeature() const = 0;
+    virtual void DetectKeepAliveFeature() = 0;
     virtual void ModuleCustomParamsNegotiationDone() = 0;
 
     virtual void SetNegotiatedMediaCapability(const std::string &negotiationMediaParams) = 0;
@@ -37,6 +37,22 @@ enum class ActionType {
     SEND_EVENT_CHANGE
 };
 
+// Method of a received message, recognized once by the parser.
+enum class RtspMethod : uint8_t {
+    UNKNOWN,
+    RESPONSE,
+    ANNOUNCE,
+    OPTIONS,
+    SETUP,
+    PLAY,
+    PAUSE,
+    TEARDOWN,
+    RENDER_READY,
+    SET_PARAMETER,
+    GET_PARAMETER,
+    METHOD_MAX
+};
+
 const std::vector<std::string> ACTION_TYPE_STR = {
     "SETUP", "PLAY", "PAUSE", "TEARDOWN", "VIDEO_START", "VIDEO_STOP", "SEND_EVENT_CHANGE"
 };
@@ -53,7 +69,10 @@ enum class WaitResponse {
     WAITING_RSP_TEARDOWN_M8 = 0x08,
     WAITING_RSP_PAUSE_M9 = 0x09,
     WAITING_RSP_KA = 0x0A,
-    WAITING_RSP_ANNOUNCE = 0x0B
+    WAITING_RSP_ANNOUNCE = 0x0B,
+    WAITING_RSP_EVENT_CHANGE = 0x0C,
+    WAITING_RSP_RENDER_READY = 0x0D,
+    WAITING_RSP_SETUP_TRIGGER_M5 = 0x0E
 };
 
 static const std::string COMMON_SEPARATOR = ";";
@@ -122,6 +122,8 @@ public:
     static const int FEATURE_STOP_CHANNEL = FEATURE_BASE + 104;
     static const int FEATURE_AGGR_SEND = FEATURE_BASE + 105;
     static const int FEATURE_MIRROR_STREAM_SWITCH = FEATURE_BASE + 106;
+    static const int FEATURE_CHANNEL_MUX = FEATURE_BASE + 107;
+    static const int FEATURE_UDP_VTP = FEATURE_BASE + 108;
 
     // remote control feature
     static const int FEATURE_FINE_STYLUS = FEATURE_BASE + 201;
@@ -19,6 +19,8 @@
 #include "rtsp_channel_manager.h"
 
 #include "cast_engine_log.h"
+#include "cast_engine_metrics.h"
+#include "cast_trace.h"
 #include "encrypt_decrypt.h"
 #include "rtsp_basetype.h"
 #include "securec.h"
@@ -32,7 +34,7 @@ DEFINE_CAST_ENGINE_LABEL("Cast-Rtsp-Net-Manager");
 
 void RtspChannelManager::ChannelListener::OnDataReceived(const uint8_t *buffer, unsigned int length, long timeCost)
 {
-    CLOGD("==============Received data length %{public}u timeCost %{public}ld================", length, timeCost);
+    CLOGV("==============Received data length %{public}u timeCost %{public}ld================", length, timeCost);
 
     auto channelManager = channelManager_.lock();
     if (channelManager == nullptr) {
@@ -41,8 +43,8 @@ void RtspChannelManager::ChannelListener::OnDataReceived(const uint8_t *buffer,
     }
     if (!((channelManager->algorithmId_ > 0) &&
         !Utils::IsArrayAllZero(channelManager->sessionKeys_, SESSION_KEY_LENGTH))) {
-        CLOGD("==============Not Authed Recv Msg ================");
-        CLOGD("Algorithm id %{public}d, length %{public}u.", channelManager->algorithmId_, length);
+        CLOGV("==============Not Authed Recv Msg ================");
+        CLOGV("Algorithm id %{public}d, length %{public}u.", channelManager->algorithmId_, length);
         channelManager->OnData(buffer, length);
     } else {
         int decryptDataLen = 0;
@@ -50,16 +52,19 @@ void RtspChannelManager::ChannelListener::OnDataReceived(const uint8_t *buffer,
             EncryptDecrypt::GetInstance().DecryptData(channelManager->algorithmId_, { channelManager->sessionKeys_,
             channelManager->sessionKeyLength_ }, { buffer, static_cast<int>(length) }, decryptDataLen);
         if (!decryContent) {
+            static auto &decryptErrors = CastEngineMetrics::GetInstance().RegisterCounter(METRIC_RTSP_DECRYPT_ERRORS);
+            decryptErrors.Add();
             CLOGE("ERROR: decode fail, length[%{public}u]", length);
             return;
         }
-        CLOGD("==============Authed Recv Msg ================, decryContent length %{public}u", length);
+        CLOGV("==============Authed Recv Msg ================, decryContent length %{public}u", length);
         channelManager->OnData(decryContent.get(), decryptDataLen);
     }
 }
 
-RtspChannelManager::RtspChannelManager(std::shared_ptr<RtspListenerInner> listener, ProtocolType protocolType)
-    : listener_(listener), protocolType_(protocolType)
+RtspChannelManager::RtspChannelManager(std::shared_ptr<RtspListenerInner> listener, ProtocolType protocolType,
+    EndType endType)
+    : listener_(listener), protocolType_(protocolType), endType_(endType)
 {
     CLOGI("Out, ProtocolType:%{public}d", protocolType_);
 }
@@ -143,15 +148,24 @@ void RtspChannelManager::OnConnected(ChannelLinkType channelLinkType)
 void RtspChannelManager::OnData(const uint8_t *data, unsigned int length)
 {
     std::string str(reinterpret_cast<const char *>(data), length);
-    CLOGD("In, %{public}s %{public}s", (str.find("RTSP/") == 0) ? "Response...\r\n" : "Request...\r\n", str.c_str());
     auto listener = listener_.lock();
     if (!listener) {
         CLOGE("listener is nullptr");
         return;
     }
+    static auto &rxMessages = CastEngineMetrics::GetInstance().RegisterCounter(METRIC_RTSP_RX_MESSAGES);
+    static auto &parseTime = CastEngineMetrics::GetInstance().RegisterHistogram(METRIC_RTSP_PARSE_US);
+    rxMessages.Add();
+    CastTraceRecorder::GetInstance().Record(TraceRecordType::RTSP_RX, static_cast<uint16_t>(endType_), data, length);
     RtspParse msg;
-    RtspParse::ParseMsg(str, msg);
-    if (Utils::StartWith(str, "RTSP/")) {
+    {
+        MetricScopedTimer timer(parseTime);
+        RtspParse::ParseMsg(str, msg);
+    }
+    // The parser already told a response from a request by the first line.
+    bool isResponse = msg.GetMethod() == RtspMethod::RESPONSE;
+    CLOGV("In, %{public}s %{public}s", isResponse ? "Response...\r\n" : "Request...\r\n", str.c_str());
+    if (isResponse) {
         listener->OnResponse(msg);
     } else {
         listener->OnRequest(msg);
@@ -190,7 +204,7 @@ bool RtspChannelManager::SendData(const std::string &dataFrame)
     size_t pktlen = dataFrame.size();
     if (channel->GetRequest().linkType == ChannelLinkType::SOFT_BUS ||
         Utils::IsArrayAllZero(sessionKeys_, SESSION_KEY_LENGTH) || algorithmId_ <= 0) {
-        CLOGD("SendData, get data finish.");
+        CLOGV("SendData, get data finish.");
         return channel->Send(reinterpret_cast<const uint8_t *>(dataFrame.c_str()), pktlen);
     }
     int encryptedDataLen = 0;
@@ -200,9 +214,7 @@ bool RtspChannelManager::SendData(const std::string &dataFrame)
         CLOGE("Encrypt data failed, pktlen: %{public}zu", pktlen);
         return false;
     }
-    CLOGD("SendData, encrypt data finish.");
-
-    CLOGD("SendData, encryptedDataLen %{public}d pktlen %{public}zu.", encryptedDataLen, pktlen);
+    CLOGV("SendData, encryptedDataLen %{public}d pktlen %{public}zu.", encryptedDataLen, pktlen);
     return channel->Send(encryptedData.get(), encryptedDataLen);
 }
 
@@ -214,12 +226,22 @@ bool RtspChannelManager::SendRtspData(const std::string &request)
         return false;
     }
 
+    static auto &txMessages = CastEngineMetrics::GetInstance().RegisterCounter(METRIC_RTSP_TX_MESSAGES);
+    static auto &txErrors = CastEngineMetrics::GetInstance().RegisterCounter(METRIC_RTSP_TX_ERRORS);
     if (!isSessionActive_) {
         CLOGE("IsSessionActive_ %{public}d SendRtspData... %{public}zu", isSessionActive_, request.length());
+        txErrors.Add();
         return false;
     }
 
-    return SendData(request);
+    if (!SendData(request)) {
+        txErrors.Add();
+        return false;
+    }
+    txMessages.Add();
+    CastTraceRecorder::GetInstance().Record(TraceRecordType::RTSP_TX, static_cast<uint16_t>(endType_),
+        reinterpret_cast<const uint8_t *>(request.c_str()), static_cast<uint32_t>(request.size()));
+    return true;
 }
 
 void RtspChannelManager::SetNegAlgorithmId(int algorithmId)
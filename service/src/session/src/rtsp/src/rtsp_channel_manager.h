@@ -31,7 +31,7 @@ namespace CastEngineService {
 namespace CastSessionRtsp {
 class RtspChannelManager : public Message, public std::enable_shared_from_this<RtspChannelManager> {
 public:
-    RtspChannelManager(std::shared_ptr<RtspListenerInner> listener, ProtocolType protocolType);
+    RtspChannelManager(std::shared_ptr<RtspListenerInner> listener, ProtocolType protocolType, EndType endType);
     ~RtspChannelManager();
 
     void OnConnected(ChannelLinkType channelLinkType);
@@ -85,6 +85,7 @@ private:
     std::shared_ptr<ChannelListener> channelListener_;
     int algorithmId_{ 0 };
     ProtocolType protocolType_;
+    EndType endType_;
     std::mutex mutex_;
 };
 } // namespace CastSessionRtsp
@@ -22,6 +22,7 @@
 
 #include "cast_device_data_manager.h"
 #include "cast_engine_log.h"
+#include "cast_engine_metrics.h"
 #include "encrypt_decrypt.h"
 #include "rtsp_package.h"
 #include "utils.h"
@@ -55,13 +56,12 @@ RtspController::RtspController(std::shared_ptr<IRtspListener> listener, Protocol
 RtspController::~RtspController()
 {
     CLOGI("~RtspController in.");
+    requestTimer_.Stop();
 }
 
 void RtspController::Init()
 {
-    rtspNetManager_ = std::make_shared<RtspChannelManager>(shared_from_this(), protocolType_);
-    ResponseFuncMapInit();
-    RequestFuncMapInit();
+    rtspNetManager_ = std::make_shared<RtspChannelManager>(shared_from_this(), protocolType_, endType_);
 }
 
 std::shared_ptr<IChannelListener> RtspController::GetChannelListener()
@@ -93,6 +93,14 @@ bool RtspController::Start(const ParamInfo &sourceParam, const uint8_t *sessionK
         return false;
     }
     state_ = RtspEngineState::STATE_STARTED;
+    {
+        std::lock_guard<std::mutex> lock(transactionMutex_);
+        pendingRequests_.clear();
+    }
+    requestTimer_.Start([this]() {
+        CheckRequestTimeout();
+        CheckLiveness();
+    }, REQUEST_CHECK_INTERVAL_MS);
     CLOGD("Out");
 
     return true;
@@ -104,26 +112,28 @@ bool RtspController::Action(ActionType actionType)
     CLOGD("Action in %{public}s endType %{public}d", ACTION_TYPE_STR[action].c_str(), endType_);
 
     std::string requestStr;
+    int cseq = ++currentSeq_;
+    WaitResponse waitRsp = WaitResponse::WAITING_RSP_NONE;
     // Source端同Sink端携带字段有差异，兼容处理;
     if (endType_ == EndType::CAST_SOURCE) {
-        requestStr = RtspEncap::EncapActionRequest(actionType, paramInfo_.GetVersion(), ++currentSeq_);
-        waitRsp_ = WaitResponse::WAITING_RSP_SET_PARAM_M5;
+        requestStr = RtspEncap::EncapActionRequest(actionType, paramInfo_.GetVersion(), cseq);
+        waitRsp = WaitResponse::WAITING_RSP_SET_PARAM_M5;
     } else {
         if (actionType >= ActionType::SETUP && actionType <= ActionType::SEND_EVENT_CHANGE) {
             CLOGD("ActionType::%{public}d", actionType);
         }
         switch (actionType) {
             case ActionType::PLAY:
-                requestStr = RtspEncap::EncapPlayRequest(++currentSeq_, "", INVALID_VALUE);
-                waitRsp_ = WaitResponse::WAITING_RSP_PLAY_M7;
+                requestStr = RtspEncap::EncapPlayRequest(cseq, "", INVALID_VALUE);
+                waitRsp = WaitResponse::WAITING_RSP_PLAY_M7;
                 break;
             case ActionType::PAUSE:
-                requestStr = RtspEncap::EncapPauseRequest(++currentSeq_, "");
-                waitRsp_ = WaitResponse::WAITING_RSP_PAUSE_M9;
+                requestStr = RtspEncap::EncapPauseRequest(cseq, "");
+                waitRsp = WaitResponse::WAITING_RSP_PAUSE_M9;
                 break;
             case ActionType::TEARDOWN:
-                requestStr = RtspEncap::EncapTearDownRequest(++currentSeq_, "");
-                waitRsp_ = WaitResponse::WAITING_RSP_TEARDOWN_M8;
+                requestStr = RtspEncap::EncapTearDownRequest(cseq, "");
+                waitRsp = WaitResponse::WAITING_RSP_TEARDOWN_M8;
                 break;
 
             default:
@@ -131,7 +141,7 @@ bool RtspController::Action(ActionType actionType)
                 return false;
         }
     }
-    rtspNetManager_->SendRtspData(requestStr);
+    SendRequest(requestStr, cseq, waitRsp);
     if (actionType == ActionType::TEARDOWN) {
         CLOGD("ActionType::TEARDOWN, stop engine.");
         StopEngine();
@@ -142,25 +152,28 @@ bool RtspController::Action(ActionType actionType)
 bool RtspController::SendAction(ActionType type)
 {
     CLOGD("Send action method is %{public}d", type);
-    std::string request = RtspEncap::EncapActionRequest(type, paramInfo_.GetVersion(), ++currentSeq_);
+    int cseq = ++currentSeq_;
+    std::string request = RtspEncap::EncapActionRequest(type, paramInfo_.GetVersion(), cseq);
     if (request.empty()) {
         CLOGE("SendAction request is null.");
         return false;
     }
-    return rtspNetManager_->SendRtspData(request);
+    // The setup trigger is the last step of the negotiation, other actions only drive an established session.
+    return SendRequest(request, cseq, type == ActionType::SETUP ? WaitResponse::WAITING_RSP_SETUP_TRIGGER_M5 :
+        WaitResponse::WAITING_RSP_SET_PARAM_M5);
 }
 
 bool RtspController::SendEventChange(int moduleId, int event, const std::string &param)
 {
     CLOGD("Module %{public}d send event %{public}d param %{public}s", moduleId, event, param.c_str());
-    std::string request =
-        RtspEncap::EncapEventChangeRequest(moduleId, event, param, paramInfo_.GetVersion(), ++currentSeq_);
+    int cseq = ++currentSeq_;
+    std::string request = RtspEncap::EncapEventChangeRequest(moduleId, event, param, paramInfo_.GetVersion(), cseq);
     if (request.empty()) {
         CLOGE("Send event change message is null.");
         return false;
     }
 
-    return rtspNetManager_->SendRtspData(request);
+    return SendRequest(request, cseq, WaitResponse::WAITING_RSP_EVENT_CHANGE);
 }
 
 void RtspController::OnPeerReady(bool isSoftbus)
@@ -173,8 +186,7 @@ void RtspController::OnPeerReady(bool isSoftbus)
     bool isSendSuccess = true;
 
     if (isSoftbus) {
-        isSendSuccess = SendOptionM1M2();
-        waitRsp_ = WaitResponse::WAITING_RSP_OPT_M2;
+        isSendSuccess = SendOptionM1M2(WaitResponse::WAITING_RSP_OPT_M2);
     } else {
         EncryptDecrypt &instance = EncryptDecrypt::GetInstance();
         auto algStr = instance.GetEncryptInfo();
@@ -184,9 +196,9 @@ void RtspController::OnPeerReady(bool isSoftbus)
         int version = instance.GetVersion();
         CLOGD("AuthNeg: Get algStr is %{public}s version %{public}d", algStr.c_str(), version);
 
-        std::string req = RtspEncap::EncapAnnounce(algStr, ++currentSeq_, version);
-        isSendSuccess = rtspNetManager_->SendRtspData(req);
-        waitRsp_ = WaitResponse::WAITING_RSP_ANNOUNCE;
+        int cseq = ++currentSeq_;
+        std::string req = RtspEncap::EncapAnnounce(algStr, cseq, version);
+        isSendSuccess = SendRequest(req, cseq, WaitResponse::WAITING_RSP_ANNOUNCE);
     }
 
     if (!isSendSuccess) {
@@ -197,17 +209,12 @@ void RtspController::OnPeerReady(bool isSoftbus)
 
 bool RtspController::OnRequest(RtspParse &request)
 {
+    liveness_.OnPeerActivity();
     bool isSuccess = true;
-    bool isMethodSupport = false;
-    for (auto &func : requestFuncMap_) {
-        if (Utils::StartWith(request.GetFirstLine(), func.first)) {
-            isSuccess = (this->*requestFuncMap_[func.first])(request);
-            isMethodSupport = true;
-            break;
-        }
-    }
-
-    if (!isMethodSupport) {
+    RequestFunc func = GetRequestFunc(request.GetMethod());
+    if (func != nullptr) {
+        isSuccess = (this->*func)(request);
+    } else {
         isSuccess = SendErrorResponse(request, "405 Method Not Allowed");
     }
 
@@ -221,37 +228,147 @@ bool RtspController::OnRequest(RtspParse &request)
 
 bool RtspController::OnResponse(RtspParse &response)
 {
+    liveness_.OnPeerActivity();
+    int cseq = response.GetSeq();
+    RtspTransaction transaction;
+    if (!TakeTransaction(cseq, transaction)) {
+        CLOGE("No request is waiting for the response, cseq %{public}d", cseq);
+        return true;
+    }
+
+    static auto &transactionTime = CastEngineMetrics::GetInstance().RegisterHistogram(METRIC_RTSP_TRANSACTION_US);
+    int64_t rttUs = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - transaction.sendTime).count();
+    transactionTime.Record(static_cast<uint64_t>(rttUs));
+    liveness_.OnRttSample(rttUs);
+    CLOGD("OnResponse cseq %{public}d, waitRsp %{public}d", cseq, transaction.type);
+
     bool isSuccess = true;
-    bool isMethodSupport = false;
-    CLOGD("OnResponse in State:%{public}d", waitRsp_);
+    ResponseFunc func = GetResponseFunc(transaction.type);
+    if (func != nullptr) {
+        isSuccess = (this->*func)(response);
+    } else {
+        CLOGE("Response state, waitRsp is %{public}d", transaction.type);
+    }
+    if (transaction.onComplete) {
+        transaction.onComplete(&response);
+    }
+
+    if (!isSuccess && (listener_ != nullptr)) {
+        CLOGE("OnResponse error in State %{public}d", transaction.type);
+        listener_->OnError(ERROR_CODE_DEFAULT);
+    }
+    return isSuccess;
+}
 
-    if (RtspParse::ParseIntSafe(response.GetHeader()["cseq"]) == currentKeepAliveCseq_) {
-        CLOGD("ProcessKaResponse");
-        return ProcessCommonResponse(response);
+bool RtspController::SendRequest(const std::string &request, int cseq, WaitResponse type, int timeoutMs,
+    CompleteFunc onComplete)
+{
+    auto now = std::chrono::steady_clock::now();
+    {
+        std::lock_guard<std::mutex> lock(transactionMutex_);
+        pendingRequests_[cseq] = { type, now, now + std::chrono::milliseconds(timeoutMs), std::move(onComplete) };
+    }
+    if (!rtspNetManager_->SendRtspData(request)) {
+        std::lock_guard<std::mutex> lock(transactionMutex_);
+        pendingRequests_.erase(cseq);
+        return false;
     }
+    return true;
+}
 
-    for (auto &func : responseFuncMap_) {
-        if (waitRsp_ == func.first) {
-            isSuccess = (this->*responseFuncMap_[waitRsp_])(response);
-            isMethodSupport = true;
-            break;
+bool RtspController::TakeTransaction(int cseq, RtspTransaction &transaction)
+{
+    std::lock_guard<std::mutex> lock(transactionMutex_);
+    auto iter = pendingRequests_.find(cseq);
+    if (iter == pendingRequests_.end()) {
+        return false;
+    }
+    transaction = std::move(iter->second);
+    pendingRequests_.erase(iter);
+    return true;
+}
+
+void RtspController::CheckRequestTimeout()
+{
+    std::map<int, RtspTransaction> expired;
+    {
+        std::lock_guard<std::mutex> lock(transactionMutex_);
+        auto now = std::chrono::steady_clock::now();
+        for (auto iter = pendingRequests_.begin(); iter != pendingRequests_.end();) {
+            if (iter->second.deadline > now) {
+                ++iter;
+                continue;
+            }
+            expired.insert(pendingRequests_.extract(iter++));
         }
     }
+    for (const auto &[cseq, transaction] : expired) {
+        OnRequestTimeout(cseq, transaction);
+    }
+}
 
-    if (!isMethodSupport) {
-        CLOGE("Response state, waitRsp is %{public}d", waitRsp_);
+void RtspController::OnRequestTimeout(int cseq, const RtspTransaction &transaction)
+{
+    static auto &timeouts = CastEngineMetrics::GetInstance().RegisterCounter(METRIC_RTSP_TIMEOUTS);
+    timeouts.Add();
+    CLOGE("Request timeout, cseq %{public}d, waitRsp %{public}d", cseq, transaction.type);
+    if (transaction.onComplete) {
+        transaction.onComplete(nullptr);
     }
 
-    if (!isSuccess && (listener_ != nullptr)) {
-        CLOGE("OnResponse error in State %{public}d", waitRsp_);
-        listener_->OnError(ERROR_CODE_DEFAULT);
+    switch (transaction.type) {
+        case WaitResponse::WAITING_RSP_OPT_M1:
+        case WaitResponse::WAITING_RSP_OPT_M2:
+        case WaitResponse::WAITING_RSP_GET_PARAM_M3:
+        case WaitResponse::WAITING_RSP_SET_PARAM_M4:
+        case WaitResponse::WAITING_RSP_SETUP_TRIGGER_M5:
+        case WaitResponse::WAITING_RSP_SETUP_M6:
+        case WaitResponse::WAITING_RSP_ANNOUNCE:
+            // The session can not be set up without the negotiation.
+            if (listener_ != nullptr) {
+                listener_->OnError(ERROR_CODE_DEFAULT);
+            }
+            return;
+        default:
+            // A control action or a notification, the session goes on and the liveness check tells a gone peer.
+            CLOGE("Give up waiting for the response, cseq %{public}d", cseq);
+            return;
     }
-    return isSuccess;
 }
 
-void RtspController::DetectKeepAliveFeature() const
+void RtspController::CheckLiveness()
 {
-    CLOGD("Detect keep alive feature, set cast keep alive interval.");
+    switch (liveness_.Check()) {
+        case RtspLiveness::Action::PROBE:
+            SendKeepAliveRequest();
+            return;
+        case RtspLiveness::Action::PEER_GONE: {
+            static auto &peerGone = CastEngineMetrics::GetInstance().RegisterCounter(METRIC_RTSP_PEER_GONE);
+            peerGone.Add();
+            CLOGE("No response from peer, keep alive lost %{public}d times", RtspLiveness::MAX_LOST_PROBES);
+            OnPeerGone();
+            return;
+        }
+        default:
+            return;
+    }
+}
+
+bool RtspController::IsKeepAliveNegotiated()
+{
+    const auto &featureSet = negotiatedParamInfo_.GetFeatureSet();
+    return featureSet.find(ParamInfo::FEATURE_KEEP_ALIVE) != featureSet.end();
+}
+
+void RtspController::DetectKeepAliveFeature()
+{
+    if (!IsKeepAliveNegotiated()) {
+        CLOGI("Peer does not support keep alive.");
+        return;
+    }
+    CLOGD("Detect keep alive feature, start probing the peer when it goes quiet.");
+    liveness_.Start();
 }
 
 void RtspController::SetupPort(int serverPort, int remotectlPort, int cpPort)
@@ -260,6 +377,7 @@ void RtspController::SetupPort(int serverPort, int remotectlPort, int cpPort)
     std::string rsp = RtspEncap::EncapSetupResponse(paramInfo_, currentSetUpSeq_, serverPort, remotectlPort, cpPort);
     bool isSuccess = rtspNetManager_->SendRtspData(rsp);
     state_ = RtspEngineState::STATE_ESTABLISHED;
+    DetectKeepAliveFeature();
     if (!isSuccess && (listener_ != nullptr)) {
         CLOGE("Send setup response error.");
         listener_->OnError(ERROR_CODE_DEFAULT);
@@ -271,14 +389,13 @@ void RtspController::SetupPort(int serverPort, int remotectlPort, int cpPort)
 void RtspController::SendCastRenderReadyOption(int isReady)
 {
     CLOGD("RenderReady: isReady %{public}d", isReady);
-    std::string rsp = RtspEncap::EncapCastRenderReadyRequest(++currentSeq_, "", isReady);
-    bool isSuccess = rtspNetManager_->SendRtspData(rsp);
+    int cseq = ++currentSeq_;
+    std::string rsp = RtspEncap::EncapCastRenderReadyRequest(cseq, "", isReady);
+    bool isSuccess = SendRequest(rsp, cseq, WaitResponse::WAITING_RSP_RENDER_READY);
     if (!isSuccess && (listener_ != nullptr)) {
         CLOGE("Send Cast Render Ready request error.");
         listener_->OnError(ERROR_CODE_DEFAULT);
-        return;
     }
-    waitRsp_ = WaitResponse::WAITING_RSP_NONE;
 }
 
 bool RtspController::DealAnnounceRequest(RtspParse &response)
@@ -288,8 +405,7 @@ bool RtspController::DealAnnounceRequest(RtspParse &response)
     }
     rtspNetManager_->SetNegAlgorithmId(negotiatedParamInfo_.GetEncryptionParamInfo().controlChannelAlgId);
 
-    SendOptionM1M2();
-    waitRsp_ = WaitResponse::WAITING_RSP_OPT_M1;
+    SendOptionM1M2(WaitResponse::WAITING_RSP_OPT_M1);
 
     CLOGI("Out, SendOptionM1M2.");
     return true;
@@ -316,6 +432,8 @@ bool RtspController::StopEngine()
 {
     CLOGD("StopEngine");
     state_ = RtspEngineState::STATE_STOPPED;
+    liveness_.Stop();
+    requestTimer_.Stop();
     rtspNetManager_->StopSession();
     return true;
 }
@@ -383,9 +501,9 @@ bool RtspController::ProcessAnnounceRequest(RtspParse &request)
             }
             sendStr += ", " + cipher;
         }
-        std::string req = RtspEncap::EncapAnnounce(sendStr, ++currentSeq_, version);
-        rtspNetManager_->SendRtspData(req);
-        waitRsp_ = WaitResponse::WAITING_RSP_ANNOUNCE;
+        int cseq = ++currentSeq_;
+        std::string req = RtspEncap::EncapAnnounce(sendStr, cseq, version);
+        SendRequest(req, cseq, WaitResponse::WAITING_RSP_ANNOUNCE);
     } else {
         std::string rsp = RtspEncap::EncapCommonResponse(request, STATUS_OK_STR);
         rtspNetManager_->SendRtspData(rsp);
@@ -409,10 +527,8 @@ bool RtspController::ProcessOptionRequest(RtspParse &request)
 
     if (endType_ == EndType::CAST_SOURCE) {
         SendGetParamM3();
-        waitRsp_ = WaitResponse::WAITING_RSP_GET_PARAM_M3;
     } else {
-        SendOptionM1M2();
-        waitRsp_ = WaitResponse::WAITING_RSP_OPT_M2;
+        SendOptionM1M2(WaitResponse::WAITING_RSP_OPT_M2);
     }
 
     return true;
@@ -498,7 +614,9 @@ bool RtspController::ProcessPlayRequest(RtspParse &request)
         return (listener_ != nullptr) && listener_->OnPlay(negotiatedParamInfo_, port, deviceId_) && isSuccess;
     }
     std::string rsp = RtspEncap::EncapCommonResponse(request, STATUS_OK_STR);
-    rsp.append("Session: timeout=30").append("\n");
+    // A peer that probes us keeps the session alive within the detection bound, any other one keeps the old timeout.
+    int sessionTimeoutS = IsKeepAliveNegotiated() ? SESSION_TIMEOUT_S : LEGACY_SESSION_TIMEOUT_S;
+    rsp.append("Session: timeout=").append(std::to_string(sessionTimeoutS)).append("\n");
     rsp.append("Range: npt=now-").append("\n");
 
     isSuccess = rtspNetManager_->SendRtspData(rsp);
@@ -592,9 +710,9 @@ void RtspController::ProcessTriggerMethod(RtspParse &request, const std::string
             port = listener_->StartMediaVtp(negotiatedParamInfo_);
             CLOGD("Encap Setup, StartMediaVtp result is %{public}d", port);
         }
-        std::string requestStr = RtspEncap::EncapSetupRequest(++currentSeq_, "", port);
-        rtspNetManager_->SendRtspData(requestStr);
-        waitRsp_ = WaitResponse::WAITING_RSP_SETUP_M6;
+        int cseq = ++currentSeq_;
+        std::string requestStr = RtspEncap::EncapSetupRequest(cseq, "", port);
+        SendRequest(requestStr, cseq, WaitResponse::WAITING_RSP_SETUP_M6);
     } else if (triggerMethod == ACTION_TYPE_STR[static_cast<int>(ActionType::PLAY)]) {
         CLOGD("Trigger method is %{public}s", triggerMethod.c_str());
         listener_->OnPlay(negotiatedParamInfo_, 0, deviceId_);
@@ -766,14 +884,12 @@ bool RtspController::ProcessSetParamM4Response(RtspParse &response)
         return false;
     }
     ret = SendAction(ActionType::SETUP);
-    waitRsp_ = WaitResponse::WAITING_RSP_SET_PARAM_M5;
     return ret;
 }
 
 bool RtspController::ProcessSetParamM5Response(RtspParse &response)
 {
     CLOGD("Process SetParam M5 response in.");
-    waitRsp_ = WaitResponse::WAITING_RSP_NONE;
     if (response.GetStatusCode() != STATUS_OK) {
         CLOGE("Send common response status is not 200 ok, status code is %{public}d", response.GetStatusCode());
         return false;
@@ -816,20 +932,21 @@ bool RtspController::ProcessSetupM6Response(RtspParse &response)
     }
     CLOGD("Media server port: %{public}d, remotectl server port: %{public}d", serverPort, remoteCtlPort);
     listener_->OnSetup(negotiatedParamInfo_, serverPort, remoteCtlPort, deviceId_);
+    state_ = RtspEngineState::STATE_ESTABLISHED;
+    DetectKeepAliveFeature();
 
     return true;
 }
 
 bool RtspController::ProcessPlayM7Response(RtspParse &response)
 {
-    CLOGD("WaitRsp state %{public}d receive play response, status %{public}d.", waitRsp_, response.GetStatusCode());
-    waitRsp_ = WaitResponse::WAITING_RSP_NONE;
+    CLOGD("Receive play response, status %{public}d.", response.GetStatusCode());
     return true;
 }
 
 bool RtspController::ProcessTearDownM8Response(RtspParse &response)
 {
-    CLOGI("WaitRsp state %{public}d receive teardown response, status %{public}d.", waitRsp_, response.GetStatusCode());
+    CLOGI("Receive teardown response, status %{public}d.", response.GetStatusCode());
     listener_->OnTearDown();
 
     return true;
@@ -837,15 +954,22 @@ bool RtspController::ProcessTearDownM8Response(RtspParse &response)
 
 bool RtspController::ProcessPauseM9Response(RtspParse &response)
 {
-    CLOGD("WaitRsp state %{public}d receive pause response, status %{public}d.", waitRsp_, response.GetStatusCode());
+    CLOGD("Receive pause response, status %{public}d.", response.GetStatusCode());
     listener_->OnPause();
     return true;
 }
 
 bool RtspController::ProcessKaResponse(RtspParse &response)
 {
-    CLOGD("WaitRsp state %{public}d receive ka response, status %{public}d.", waitRsp_, response.GetStatusCode());
-    waitRsp_ = WaitResponse::WAITING_RSP_NONE;
+    CLOGD("Receive ka response, status %{public}d.", response.GetStatusCode());
+    return true;
+}
+
+bool RtspController::ProcessNotifyResponse(RtspParse &response)
+{
+    if (response.GetStatusCode() != STATUS_OK) {
+        CLOGW("Notify response status is not 200 ok, status code is %{public}d", response.GetStatusCode());
+    }
     return true;
 }
 
@@ -1276,53 +1400,64 @@ void RtspController::ProcessModuleCustomParams(const std::string &mediaParams, c
     listener_->NotifyModuleCustomParamsNegotiation(mediaParamsProcessed, controllerParamsProcessed);
 }
 
-bool RtspController::SendOptionM1M2()
+bool RtspController::SendOptionM1M2(WaitResponse waitRsp)
 {
     CLOGD("Send Option M1M2");
-    std::string request = RtspEncap::EncapRequestOption(++currentSeq_);
+    int cseq = ++currentSeq_;
+    std::string request = RtspEncap::EncapRequestOption(cseq);
     if (request.empty()) {
         CLOGE("SendM1 request std::string is empty");
         return false;
     }
-    return rtspNetManager_->SendRtspData(request);
+    return SendRequest(request, cseq, waitRsp);
 }
 
 bool RtspController::SendGetParamM3()
 {
     CLOGD("Send GetParam M3");
-    std::string request = RtspEncap::EncapRequestGetParameter(paramInfo_, ++currentSeq_);
+    int cseq = ++currentSeq_;
+    std::string request = RtspEncap::EncapRequestGetParameter(paramInfo_, cseq);
     if (request.empty()) {
         CLOGE("SendM3 request std::string is empty");
         return false;
     }
-    return rtspNetManager_->SendRtspData(request);
+    return SendRequest(request, cseq, WaitResponse::WAITING_RSP_GET_PARAM_M3);
 }
 
 bool RtspController::SendSetParamM4()
 {
     CLOGD("Send SetParam M4");
-    std::string req =
-        RtspEncap::EncapSetParameterM4Request(negotiatedParamInfo_, paramInfo_.GetVersion(), "", ++currentSeq_);
+    int cseq = ++currentSeq_;
+    std::string req = RtspEncap::EncapSetParameterM4Request(negotiatedParamInfo_, paramInfo_.GetVersion(), "", cseq);
     if (req.empty()) {
         CLOGE("SendM4 request std::string is empty");
         return false;
     }
-    return rtspNetManager_->SendRtspData(req);
+    return SendRequest(req, cseq, WaitResponse::WAITING_RSP_SET_PARAM_M4);
 }
 
 bool RtspController::SendKeepAliveRequest()
 {
     CLOGD("Send KeepAlive request");
-    std::string request = RtspEncap::EncapKeepAliveRequest(++currentSeq_, paramInfo_.GetVersion());
+    int cseq = ++currentSeq_;
+    std::string request = RtspEncap::EncapKeepAliveRequest(cseq, paramInfo_.GetVersion());
     if (request.empty()) {
         CLOGE("SendM10 keep alive request std::string is empty");
         return false;
     }
-    currentKeepAliveCseq_ = currentSeq_;
-    CLOGD("SendM10, currentKeepAliveCseq :%{public}d", currentKeepAliveCseq_);
-    bool isSuccess = rtspNetManager_->SendRtspData(request);
-    waitRsp_ = WaitResponse::WAITING_RSP_KA;
-
+    CLOGD("SendM10, cseq :%{public}d", cseq);
+    liveness_.OnProbeSent();
+    bool isSuccess = SendRequest(request, cseq, WaitResponse::WAITING_RSP_KA, liveness_.GetProbeTimeoutMs(),
+        [this](RtspParse *response) {
+            if (response != nullptr) {
+                liveness_.OnProbeAcked();
+            } else {
+                liveness_.OnProbeLost();
+            }
+        });
+    if (!isSuccess) {
+        liveness_.OnProbeLost();
+    }
     return isSuccess;
 }
 
@@ -1343,7 +1478,6 @@ void RtspController::ModuleCustomParamsNegotiationDone()
 {
     CLOGD("Module custom params negotiation done, send M4 request.");
     SendSetParamM4();
-    waitRsp_ = WaitResponse::WAITING_RSP_SET_PARAM_M4;
 }
 
 bool RtspController::UnOrderedMapContains(std::unordered_map<std::string, std::string> map,
@@ -1399,32 +1533,63 @@ int RtspController::ProcessGetPort(RtspParse &request) const
     return port;
 }
 
-void RtspController::ResponseFuncMapInit()
-{
-    responseFuncMap_[WaitResponse::WAITING_RSP_OPT_M1] = &RtspController::ProcessCommonResponse;
-    responseFuncMap_[WaitResponse::WAITING_RSP_OPT_M2] = &RtspController::ProcessCommonResponse;
-    responseFuncMap_[WaitResponse::WAITING_RSP_GET_PARAM_M3] = &RtspController::ProcessGetParamM3Response;
-    responseFuncMap_[WaitResponse::WAITING_RSP_SET_PARAM_M4] = &RtspController::ProcessSetParamM4Response;
-    responseFuncMap_[WaitResponse::WAITING_RSP_SET_PARAM_M5] = &RtspController::ProcessSetParamM5Response;
-    responseFuncMap_[WaitResponse::WAITING_RSP_SETUP_M6] = &RtspController::ProcessSetupM6Response;
-    responseFuncMap_[WaitResponse::WAITING_RSP_PLAY_M7] = &RtspController::ProcessPlayM7Response;
-    responseFuncMap_[WaitResponse::WAITING_RSP_TEARDOWN_M8] = &RtspController::ProcessTearDownM8Response;
-    responseFuncMap_[WaitResponse::WAITING_RSP_PAUSE_M9] = &RtspController::ProcessPauseM9Response;
-    responseFuncMap_[WaitResponse::WAITING_RSP_KA] = &RtspController::ProcessKaResponse;
-    responseFuncMap_[WaitResponse::WAITING_RSP_ANNOUNCE] = &RtspController::DealAnnounceRequest;
-}
-
-void RtspController::RequestFuncMapInit()
-{
-    requestFuncMap_["ANNOUNCE"] = &RtspController::ProcessAnnounceRequest;
-    requestFuncMap_["OPTIONS"] = &RtspController::ProcessOptionRequest;
-    requestFuncMap_["SETUP"] = &RtspController::ProcessSetupRequest;
-    requestFuncMap_["PLAY"] = &RtspController::ProcessPlayRequest;
-    requestFuncMap_["PAUSE"] = &RtspController::ProcessPauseRequest;
-    requestFuncMap_["TEARDOWN"] = &RtspController::ProcessTearDownRequest;
-    requestFuncMap_["RENDER_READY"] = &RtspController::ProcessRenderReadyRequest;
-    requestFuncMap_["SET_PARAMETER"] = &RtspController::ProcessSetParamRequest;
-    requestFuncMap_["GET_PARAMETER"] = &RtspController::ProcessGetParameterRequestM3;
+RtspController::ResponseFunc RtspController::GetResponseFunc(WaitResponse type)
+{
+    switch (type) {
+        case WaitResponse::WAITING_RSP_OPT_M1:
+        case WaitResponse::WAITING_RSP_OPT_M2:
+            return &RtspController::ProcessCommonResponse;
+        case WaitResponse::WAITING_RSP_GET_PARAM_M3:
+            return &RtspController::ProcessGetParamM3Response;
+        case WaitResponse::WAITING_RSP_SET_PARAM_M4:
+            return &RtspController::ProcessSetParamM4Response;
+        case WaitResponse::WAITING_RSP_SET_PARAM_M5:
+        case WaitResponse::WAITING_RSP_SETUP_TRIGGER_M5:
+            return &RtspController::ProcessSetParamM5Response;
+        case WaitResponse::WAITING_RSP_SETUP_M6:
+            return &RtspController::ProcessSetupM6Response;
+        case WaitResponse::WAITING_RSP_PLAY_M7:
+            return &RtspController::ProcessPlayM7Response;
+        case WaitResponse::WAITING_RSP_TEARDOWN_M8:
+            return &RtspController::ProcessTearDownM8Response;
+        case WaitResponse::WAITING_RSP_PAUSE_M9:
+            return &RtspController::ProcessPauseM9Response;
+        case WaitResponse::WAITING_RSP_KA:
+            return &RtspController::ProcessKaResponse;
+        case WaitResponse::WAITING_RSP_ANNOUNCE:
+            return &RtspController::DealAnnounceRequest;
+        case WaitResponse::WAITING_RSP_EVENT_CHANGE:
+        case WaitResponse::WAITING_RSP_RENDER_READY:
+            return &RtspController::ProcessNotifyResponse;
+        default:
+            return nullptr;
+    }
+}
+
+RtspController::RequestFunc RtspController::GetRequestFunc(RtspMethod method)
+{
+    switch (method) {
+        case RtspMethod::ANNOUNCE:
+            return &RtspController::ProcessAnnounceRequest;
+        case RtspMethod::OPTIONS:
+            return &RtspController::ProcessOptionRequest;
+        case RtspMethod::SETUP:
+            return &RtspController::ProcessSetupRequest;
+        case RtspMethod::PLAY:
+            return &RtspController::ProcessPlayRequest;
+        case RtspMethod::PAUSE:
+            return &RtspController::ProcessPauseRequest;
+        case RtspMethod::TEARDOWN:
+            return &RtspController::ProcessTearDownRequest;
+        case RtspMethod::RENDER_READY:
+            return &RtspController::ProcessRenderReadyRequest;
+        case RtspMethod::SET_PARAMETER:
+            return &RtspController::ProcessSetParamRequest;
+        case RtspMethod::GET_PARAMETER:
+            return &RtspController::ProcessGetParameterRequestM3;
+        default:
+            return nullptr;
+    }
 }
 } // namespace CastSessionRtsp
 } // namespace CastEngineService
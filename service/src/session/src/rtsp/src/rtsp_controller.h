@@ -18,11 +18,17 @@
 #ifndef LIBCASTENGINE_RTSP_CONTROLLER_H
 #define LIBCASTENGINE_RTSP_CONTROLLER_H
 
+#include <atomic>
+#include <chrono>
+#include <functional>
 #include <list>
+#include <mutex>
+#include "cast_timer.h"
 #include "channel.h"
 #include "rtsp_listener.h"
 #include "rtsp_listener_inner.h"
 #include "rtsp_channel_manager.h"
+#include "rtsp_liveness.h"
 #include "i_rtsp_controller.h"
 #include "nlohmann/json.hpp"
 
@@ -52,7 +58,7 @@ public:
     void SetupPort(int serverPort, int remotectlPort, int cpPort) override;
     void SendCastRenderReadyOption(int isReady) override;
     const std::set<int> &GetNegotiatedFeatureSet() override;
-    void DetectKeepAliveFeature() const override;
+    void DetectKeepAliveFeature() override;
     void ModuleCustomParamsNegotiationDone() override;
     void SetNegotiatedMediaCapability(const std::string &negotiationMediaParams) override;
     void SetNegotiatedPlayerControllerCapability(const std::string &negotiationParams) override;
@@ -69,6 +75,31 @@ private:
 
     using ResponseFunc = bool (RtspController::*)(RtspParse &);
     using RequestFunc = bool (RtspController::*)(RtspParse &);
+    // Called once the transaction completes, with nullptr when it timed out.
+    using CompleteFunc = std::function<void(RtspParse *response)>;
+
+    // A request waiting for its response, keyed by CSeq in pendingRequests_.
+    struct RtspTransaction {
+        WaitResponse type{ WaitResponse::WAITING_RSP_NONE };
+        std::chrono::steady_clock::time_point sendTime;
+        std::chrono::steady_clock::time_point deadline;
+        CompleteFunc onComplete;
+    };
+
+    static constexpr int REQUEST_TIMEOUT_MS = 10000;
+    static constexpr int REQUEST_CHECK_INTERVAL_MS = 200;
+    // Advertised to the peer in the PLAY response, it never waits longer than the liveness detection bound.
+    static constexpr int SESSION_TIMEOUT_S = RtspLiveness::DETECTION_BOUND_MS / 1000 + 1;
+    // Advertised to a peer that did not negotiate the keep alive, as before it existed.
+    static constexpr int LEGACY_SESSION_TIMEOUT_S = 30;
+
+    bool SendRequest(const std::string &request, int cseq, WaitResponse type, int timeoutMs = REQUEST_TIMEOUT_MS,
+        CompleteFunc onComplete = nullptr);
+    bool TakeTransaction(int cseq, RtspTransaction &transaction);
+    void CheckRequestTimeout();
+    void OnRequestTimeout(int cseq, const RtspTransaction &transaction);
+    void CheckLiveness();
+    bool IsKeepAliveNegotiated();
     bool ProcessAnnounceRequest(RtspParse &request);
     bool ProcessCommonResponse(RtspParse &response);
     bool ProcessGetParamM3Response(RtspParse &response);
@@ -79,6 +110,7 @@ private:
     bool ProcessTearDownM8Response(RtspParse &response);
     bool ProcessPauseM9Response(RtspParse &response);
     bool ProcessKaResponse(RtspParse &response);
+    bool ProcessNotifyResponse(RtspParse &response);
     bool SendAction(ActionType type);
     void ProcessSinkDeviceType(const std::string &content);
     bool StopEngine();
@@ -109,7 +141,7 @@ private:
     void ProcessSinkVtp(const std::string &content);
     void ProcessProjectionMode(const std::string &content);
     void ProcessModuleCustomParams(const std::string &mediaParams, const std::string &controllerParams);
-    bool SendOptionM1M2();
+    bool SendOptionM1M2(WaitResponse waitRsp);
     bool SendGetParamM3();
     bool SendSetParamM4();
     bool SendKeepAliveRequest();
@@ -118,24 +150,24 @@ private:
     bool UnOrderedMapContains(std::unordered_map<std::string, std::string> map, const std::string &key) const;
     void ProcessSourceDeviceType(const std::string &content);
     void ProcessTriggerMethod(RtspParse &request, const std::string &triggerMethod);
-    void ResponseFuncMapInit();
-    void RequestFuncMapInit();
+    static ResponseFunc GetResponseFunc(WaitResponse type);
+    static RequestFunc GetRequestFunc(RtspMethod method);
     void AddScreenParam();
 
     const ProtocolType protocolType_;
     std::shared_ptr<IRtspListener> listener_;
     EndType endType_;
-    int currentSeq_{ 0 };
+    std::atomic<int> currentSeq_{ 0 };
     int currentSetUpSeq_{ 0 };
-    int currentKeepAliveCseq_{ 0 };
-    WaitResponse waitRsp_{ WaitResponse::WAITING_RSP_NONE };
+    std::mutex transactionMutex_;
+    std::map<int, RtspTransaction> pendingRequests_;
+    CastTimer requestTimer_;
+    RtspLiveness liveness_;
     std::shared_ptr<RtspChannelManager> rtspNetManager_;
     ParamInfo paramInfo_{};
     ParamInfo negotiatedParamInfo_{};
     RtspEngineState state_{ RtspEngineState::STATE_STOPPED };
     std::string deviceId_;
-    std::map<WaitResponse, ResponseFunc> responseFuncMap_;
-    std::map<std::string, RequestFunc> requestFuncMap_;
     nlohmann::json screenParam_;
 };
 } // namespace CastSessionRtsp
@@ -0,0 +1,133 @@
+/*
+ * Copyright (C) 2023-2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * Description: rtsp peer liveness, rtt estimation and keep alive probing.
+ * Author: zhangge
+ * Create: 2023-06-05
+ */
+
+#include "rtsp_liveness.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+#include "cast_engine_log.h"
+#include "cast_engine_metrics.h"
+
+namespace OHOS {
+namespace CastEngine {
+namespace CastEngineService {
+namespace CastSessionRtsp {
+DEFINE_CAST_ENGINE_LABEL("Cast-Rtsp-Liveness");
+
+void RtspLiveness::Start()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    isStarted_ = true;
+    isProbing_ = false;
+    lostProbes_ = 0;
+    lastActivity_ = std::chrono::steady_clock::now();
+    CLOGI("Start, peer gone within %{public}d ms", DETECTION_BOUND_MS);
+}
+
+void RtspLiveness::Stop()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    isStarted_ = false;
+}
+
+bool RtspLiveness::IsStarted() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return isStarted_;
+}
+
+void RtspLiveness::OnPeerActivity()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    lastActivity_ = std::chrono::steady_clock::now();
+    lostProbes_ = 0;
+}
+
+void RtspLiveness::OnRttSample(int64_t rttUs)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!hasRttSample_) {
+        srttUs_ = rttUs;
+        rttVarUs_ = rttUs / 2;
+        hasRttSample_ = true;
+        return;
+    }
+    // RTTVAR = 3/4 * RTTVAR + 1/4 * |SRTT - R|, SRTT = 7/8 * SRTT + 1/8 * R
+    rttVarUs_ += (std::abs(srttUs_ - rttUs) - rttVarUs_) >> RTTVAR_GAIN_SHIFT;
+    srttUs_ += (rttUs - srttUs_) >> RTT_GAIN_SHIFT;
+}
+
+void RtspLiveness::OnProbeSent()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    isProbing_ = true;
+}
+
+void RtspLiveness::OnProbeAcked()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    isProbing_ = false;
+}
+
+void RtspLiveness::OnProbeLost()
+{
+    static auto &lostProbes = CastEngineMetrics::GetInstance().RegisterCounter(METRIC_RTSP_KEEP_ALIVE_LOST);
+    lostProbes.Add();
+    std::lock_guard<std::mutex> lock(mutex_);
+    isProbing_ = false;
+    lostProbes_++;
+    CLOGW("Keep alive lost %{public}d times", lostProbes_);
+}
+
+RtspLiveness::Action RtspLiveness::Check()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!isStarted_) {
+        return Action::NONE;
+    }
+    if (lostProbes_ >= MAX_LOST_PROBES) {
+        isStarted_ = false;
+        return Action::PEER_GONE;
+    }
+    if (isProbing_) {
+        return Action::NONE;
+    }
+    // Retry at once after a lost probe, otherwise wait until the peer has been quiet for a while.
+    if (lostProbes_ > 0 ||
+        std::chrono::steady_clock::now() - lastActivity_ >= std::chrono::milliseconds(IDLE_PROBE_INTERVAL_MS)) {
+        return Action::PROBE;
+    }
+    return Action::NONE;
+}
+
+int RtspLiveness::GetProbeTimeoutMs() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    int64_t timeoutMs = INITIAL_PROBE_TIMEOUT_MS;
+    if (hasRttSample_) {
+        timeoutMs = std::max<int64_t>((srttUs_ + RTTVAR_FACTOR * rttVarUs_) / US_PER_MS, MIN_PROBE_TIMEOUT_MS);
+    }
+    // A probe lost to congestion must not be chased by another one with the same timeout.
+    timeoutMs <<= std::min(lostProbes_, MAX_LOST_PROBES);
+    return static_cast<int>(std::min<int64_t>(timeoutMs, MAX_PROBE_TIMEOUT_MS));
+}
+} // namespace CastSessionRtsp
+} // namespace CastEngineService
+} // namespace CastEngine
+} // namespace OHOS
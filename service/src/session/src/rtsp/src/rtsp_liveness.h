@@ -0,0 +1,88 @@
+/*
+ * Copyright (C) 2023-2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * Description: rtsp peer liveness, rtt estimation and keep alive probing.
+ * Author: zhangge
+ * Create: 2023-06-05
+ */
+#ifndef LIBCASTENGINE_RTSP_LIVENESS_H
+#define LIBCASTENGINE_RTSP_LIVENESS_H
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+
+namespace OHOS {
+namespace CastEngine {
+namespace CastEngineService {
+namespace CastSessionRtsp {
+/*
+ * Decides when to probe the peer and when to give it up. Every completed transaction is an RTT sample, and the probe
+ * timeout follows SRTT + 4 * RTTVAR as in RFC 6298. Once nothing has been heard from the peer for
+ * IDLE_PROBE_INTERVAL_MS a keep alive is probed, a lost probe is retried at once with its timeout doubled (RFC 6298
+ * 5.5, capped at MAX_PROBE_TIMEOUT_MS), and MAX_LOST_PROBES lost in a row declare the peer gone, so a dead peer is
+ * detected within DETECTION_BOUND_MS of its last message.
+ */
+class RtspLiveness {
+public:
+    enum class Action {
+        NONE,
+        PROBE,
+        PEER_GONE,
+    };
+
+    static constexpr int IDLE_PROBE_INTERVAL_MS = 2000;
+    static constexpr int MIN_PROBE_TIMEOUT_MS = 300;
+    static constexpr int MAX_PROBE_TIMEOUT_MS = 3000;
+    static constexpr int MAX_LOST_PROBES = 3;
+    static constexpr int DETECTION_BOUND_MS = IDLE_PROBE_INTERVAL_MS + MAX_LOST_PROBES * MAX_PROBE_TIMEOUT_MS;
+
+    RtspLiveness() = default;
+    ~RtspLiveness() = default;
+
+    void Start();
+    void Stop();
+    bool IsStarted() const;
+
+    // Anything received from the peer proves it is alive.
+    void OnPeerActivity();
+    void OnRttSample(int64_t rttUs);
+    void OnProbeSent();
+    void OnProbeAcked();
+    void OnProbeLost();
+    // Called periodically, tells the caller what to do next.
+    Action Check();
+    int GetProbeTimeoutMs() const;
+
+private:
+    static constexpr int INITIAL_PROBE_TIMEOUT_MS = 1000;
+    static constexpr int64_t US_PER_MS = 1000;
+    static constexpr int64_t RTT_GAIN_SHIFT = 3;
+    static constexpr int64_t RTTVAR_GAIN_SHIFT = 2;
+    static constexpr int64_t RTTVAR_FACTOR = 4;
+
+    mutable std::mutex mutex_;
+    bool isStarted_{ false };
+    bool isProbing_{ false };
+    int lostProbes_{ 0 };
+    bool hasRttSample_{ false };
+    int64_t srttUs_{ 0 };
+    int64_t rttVarUs_{ 0 };
+    std::chrono::steady_clock::time_point lastActivity_;
+};
+} // namespace CastSessionRtsp
+} // namespace CastEngineService
+} // namespace CastEngine
+} // namespace OHOS
+
+#endif // LIBCASTENGINE_RTSP_LIVENESS_H
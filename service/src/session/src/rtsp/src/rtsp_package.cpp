@@ -699,7 +699,7 @@ std::string RtspEncap::GetNowDate()
     }
 
     char tmp[DATE_ARRAY_LEN] = {0};
-    if (strftime(tmp, sizeof(tmp), "%Y-%m-%{public}d %H:%M:%{public}s", &nowTime) == 0) {
+    if (strftime(tmp, sizeof(tmp), "%Y-%m-%d %H:%M:%S", &nowTime) == 0) {
         return "";
     }
 
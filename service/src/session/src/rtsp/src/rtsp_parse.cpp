@@ -18,8 +18,10 @@
 
 #include "rtsp_parse.h"
 
+#include <array>
+#include <string_view>
+
 #include "cast_engine_log.h"
-#include "rtsp_basetype.h"
 #include "utils.h"
 
 namespace OHOS {
@@ -28,6 +30,16 @@ namespace CastEngineService {
 namespace CastSessionRtsp {
 DEFINE_CAST_ENGINE_LABEL("Cast-Rtsp-Parse");
 
+namespace {
+constexpr std::string_view RESPONSE_PREFIX = "RTSP/";
+
+// Indexed by RtspMethod.
+constexpr std::array<std::string_view, static_cast<size_t>(RtspMethod::METHOD_MAX)> METHOD_TOKENS = {
+    "", "", "ANNOUNCE", "OPTIONS", "SETUP", "PLAY", "PAUSE", "TEARDOWN", "RENDER_READY", "SET_PARAMETER",
+    "GET_PARAMETER",
+};
+} // namespace
+
 int RtspParse::GetSeq()
 {
     std::unordered_map<std::string, std::string>::const_iterator got = headers_.find("cseq");
@@ -42,7 +54,7 @@ int RtspParse::GetSeq()
 
 void RtspParse::ParseMsg(const std::string &str, RtspParse &msg)
 {
-    CLOGD("In %{public}s", str.c_str());
+    CLOGV("In %{public}s", str.c_str());
     std::string unmatched;
     std::vector<std::string> spiltStrings;
     Utils::SplitString(str, spiltStrings, MSG_SEPARATOR);
@@ -52,6 +64,7 @@ void RtspParse::ParseMsg(const std::string &str, RtspParse &msg)
     }
 
     msg.firstLine_ = spiltStrings[0];
+    msg.method_ = ParseMethod(msg.firstLine_);
     msg.statusCode_ = (msg.firstLine_.find(STATUS_OK_STR) != std::string::npos) ? STATUS_OK : 0;
 
     // Parsing headers of the request
@@ -69,24 +82,69 @@ void RtspParse::ParseMsg(const std::string &str, RtspParse &msg)
         } else {
             subStrL = spiltStrings[index].substr(0, dotPos);
             subStrR = spiltStrings[index].substr(dotPos + 1);
-            CLOGD("Parse msg subStrL %{public}s subStrR %{public}s", subStrL.c_str(), subStrR.c_str());
+            CLOGV("Parse msg subStrL %{public}s subStrR %{public}s", subStrL.c_str(), subStrR.c_str());
         }
 
         if ((subStrL.length() == 0) || (subStrR.length() == 0)) {
-            CLOGD("Parsed Length error %{public}zu", subStrL.length());
+            CLOGV("Parsed Length error %{public}zu", subStrL.length());
             continue;
         }
-        CLOGD("Parse msg headers_ %{public}s %{public}s", Utils::Trim(Utils::ToLower(subStrL)).c_str(),
+        CLOGV("Parse msg headers_ %{public}s %{public}s", Utils::Trim(Utils::ToLower(subStrL)).c_str(),
             Utils::Trim(subStrR).c_str());
         msg.headers_.insert(std::make_pair(Utils::Trim(Utils::ToLower(subStrL)), Utils::Trim(subStrR)));
     }
     msg.unmatchedString_ = unmatched;
     if (msg.unmatchedString_.length() > 0) {
-        CLOGD("parsed Header's unmatched str = %{public}s", msg.unmatchedString_.c_str());
+        CLOGV("parsed Header's unmatched str = %{public}s", msg.unmatchedString_.c_str());
     }
     CLOGD("FirstLine_ %{public}s", msg.firstLine_.c_str());
 }
 
+/*
+ * The first character, and the second one for PLAY and PAUSE, selects the only candidate method, so recognizing the
+ * token costs a single string compare whatever the method is.
+ */
+RtspMethod RtspParse::ParseMethod(const std::string &firstLine)
+{
+    std::string_view line(firstLine);
+    if (line.substr(0, RESPONSE_PREFIX.size()) == RESPONSE_PREFIX) {
+        return RtspMethod::RESPONSE;
+    }
+    std::string_view token = line.substr(0, line.find(' '));
+    if (token.empty()) {
+        return RtspMethod::UNKNOWN;
+    }
+
+    RtspMethod candidate;
+    switch (token[0]) {
+        case 'A':
+            candidate = RtspMethod::ANNOUNCE;
+            break;
+        case 'O':
+            candidate = RtspMethod::OPTIONS;
+            break;
+        case 'S':
+            candidate = (token.size() == METHOD_TOKENS[static_cast<size_t>(RtspMethod::SETUP)].size()) ?
+                RtspMethod::SETUP : RtspMethod::SET_PARAMETER;
+            break;
+        case 'P':
+            candidate = (token.size() > 1 && token[1] == 'L') ? RtspMethod::PLAY : RtspMethod::PAUSE;
+            break;
+        case 'T':
+            candidate = RtspMethod::TEARDOWN;
+            break;
+        case 'R':
+            candidate = RtspMethod::RENDER_READY;
+            break;
+        case 'G':
+            candidate = RtspMethod::GET_PARAMETER;
+            break;
+        default:
+            return RtspMethod::UNKNOWN;
+    }
+    return (token == METHOD_TOKENS[static_cast<size_t>(candidate)]) ? candidate : RtspMethod::UNKNOWN;
+}
+
 /*
     statement:
     1. INVALID_VALUE(-1) is global error value
@@ -21,6 +21,8 @@
 #include <unordered_map>
 #include <string>
 
+#include "rtsp_basetype.h"
+
 namespace OHOS {
 namespace CastEngine {
 namespace CastEngineService {
@@ -50,9 +52,15 @@ public:
         return statusCode_;
     }
 
+    RtspMethod GetMethod() const
+    {
+        return method_;
+    }
+
     int GetSeq();
 
     static void ParseMsg(const std::string &str, RtspParse &msg);
+    static RtspMethod ParseMethod(const std::string &firstLine);
     static int ParseIntSafe(const std::string &str);
     static uint32_t ParseUint32Safe(const std::string &str);
     static double ParseDoubleSafe(const std::string &str);
@@ -64,6 +72,7 @@ private:
     std::string firstLine_;
     std::unordered_map<std::string, std::string> headers_;
     int statusCode_{ 0 };
+    RtspMethod method_{ RtspMethod::UNKNOWN };
     int sequence_{ 0 };
 };
 } // namespace CastSessionRtsp
@@ -47,6 +47,7 @@ public:
     void OnEvent(EventId eventId, const std::string &data) override;
     bool NotifyPeerLoad(const MediaInfo &mediaInfo) override;
     bool NotifyPeerPlay(const MediaInfo &mediaInfo) override;
+    bool NotifyPeerPlayIndex(int index) override;
     bool NotifyPeerPause() override;
     bool NotifyPeerResume() override;
     bool NotifyPeerStop() override;
@@ -114,6 +115,8 @@ private:
 
     std::shared_ptr<RemotePlayerController> player_;
     std::mutex eventMutex_;
+    // The list last sent in a load or play action, which Play(index) picks from.
+    std::vector<MediaInfo> sentMediaInfoList_;
     std::shared_ptr<CastTimer> timer_;
     PlayerStates currentState_ = PlayerStates::PLAYER_IDLE;
     int currentPosition_{ CAST_STREAM_INT_INVALID };
@@ -54,6 +54,7 @@ public:
     bool NotifyPeerCreateChannel() override;
     void OnEvent(EventId eventId, const std::string &data) override;
     void OnRenderReady(bool isReady) override;
+    bool PostTask(const std::function<void(void)> &task) override;
     bool PlayAfterSwitchToStream() override;
 
 private:
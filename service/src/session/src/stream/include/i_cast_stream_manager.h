@@ -19,6 +19,8 @@
 #ifndef I_CAST_STREAM_MANAGER_H
 #define I_CAST_STREAM_MANAGER_H
 
+#include <atomic>
+#include <functional>
 #include <thread>
 #include <mutex>
 #include <queue>
@@ -70,6 +72,8 @@ protected:
     const std::string KEY_MEDIA_URL = "MEDIA_URL";
     const std::string KEY_MEDIA_TYPE = "MEDIA_TYPE";
     const std::string KEY_MEDIA_SIZE = "MEDIA_SIZE";
+    const std::string KEY_MEDIA_HEAD = "MEDIA_HEAD";
+    const std::string KEY_MEDIA_MULTI_RANGE = "MEDIA_MULTI_RANGE";
     const std::string KEY_START_POSITION = "START_POSITION";
     const std::string KEY_DURATION = "DURATION";
     const std::string KEY_CLOSING_CREDITS_POSITION = "CLOSING_CREDITS_POSITION";
@@ -113,6 +117,9 @@ protected:
     const std::string KEY_CAPABILITY_SUPPORT_DRM = "DRM_CAPABILITY";
     const std::string KEY_CAPABILITY_DRM_PROPERTIES = "DRM_PROPERTIES_CAPABILITY";
     const std::string KEY_CAPABILITY_SUPPOR_ALBUM_COVER = "SUPPOR_ALBUM_COVER";
+    const std::string KEY_CAPABILITY_SUPPORT_ARTWORK_DELTA = "SUPPORT_ARTWORK_DELTA";
+    const std::string KEY_CAPABILITY_SUPPORT_FILE_LENGTH_REQUEST = "SUPPORT_FILE_LENGTH_REQUEST";
+    const std::string KEY_CAPABILITY_SUPPORT_PLAY_INDEX = "SUPPORT_PLAY_INDEX";
     const std::string KEY_UX_ADAPT_MODE = "UX_ADAPT_MODE";
     const std::string KEY_REQUEST_KEY = "REQUEST_KEY";
     const std::string KEY_RESPONSE_KEY = "RESPONSE_KEY";
@@ -148,10 +155,14 @@ protected:
     const std::string ACTION_KEY_REQUEST = "onKeyRequest";
 
     void Handle();
+    bool EnqueueTask(const std::function<void(void)> &task);
     bool SendControlAction(const std::string &action, const json &dataBody = "{}");
     bool SendCallbackAction(const std::string &action, const json &dataBody = "{}");
     bool ParseMediaInfo(const json &data, MediaInfo &MediaInfo, bool isDoubleFrame);
     void EncapMediaInfo(const MediaInfo &mediaInfo, json &data, bool isDoubleFrame);
+    void OnMediaInfoSent(const MediaInfo &mediaInfo, bool isDoubleFrame);
+    void EncapPreloadData(const MediaInfo &mediaInfo, json &data);
+    void ParsePreloadData(const json &data, const MediaInfo &mediaInfo);
     bool ParseStreamCapability(const json &data, StreamCapability &streamCapability);
     void EncapStreamCapability(const StreamCapability &streamCapability, json &data);
 
@@ -173,6 +184,18 @@ protected:
     int currentVolume_{ CAST_STREAM_INT_INVALID };
     int maxVolume_{ DEFAULT_MAX_VOLUME };
     bool isSupportAlbumCover_ { false };
+    // A sink that announces it asks for the length of a local file itself when the load action comes without it.
+    bool isSupportFileLengthRequest_ { false };
+    // A sink that announces it plays an item of its loaded list from an ACTION_PLAY carrying only the index.
+    bool isSupportPlayIndex_ { false };
+    // When the peer supports it, an artwork url equal to the previous one is left out of the media info and the
+    // receiver reuses the one it kept.
+    std::mutex artworkMutex_;
+    bool isSupportArtworkDelta_ { false };
+    std::string sentAlbumCoverUrl_;
+    std::string sentAppIconUrl_;
+    std::string receivedAlbumCoverUrl_;
+    std::string receivedAppIconUrl_;
     bool isMute_ = false;
 };
 } // namespace CastEngineService
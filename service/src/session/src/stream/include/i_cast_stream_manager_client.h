@@ -32,6 +32,7 @@ public:
     virtual bool UnregisterListener() = 0;
     virtual bool NotifyPeerLoad(const MediaInfo &mediaInfo) = 0;
     virtual bool NotifyPeerPlay(const MediaInfo &mediaInfo) = 0;
+    virtual bool NotifyPeerPlayIndex(int index) = 0;
     virtual bool NotifyPeerPause() = 0;
     virtual bool NotifyPeerResume() = 0;
     virtual bool NotifyPeerStop() = 0;
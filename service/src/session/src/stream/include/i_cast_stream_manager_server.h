@@ -19,6 +19,7 @@
 #ifndef I_CAST_STREAM_MANAGER_SERVER_H
 #define I_CAST_STREAM_MANAGER_SERVER_H
 
+#include <functional>
 #include "i_stream_player_impl.h"
 
 namespace OHOS {
@@ -43,6 +44,8 @@ public:
     virtual bool NotifyPeerCreateChannel() = 0;
     virtual void OnEvent(EventId eventId, const std::string &data) = 0;
     virtual void OnRenderReady(bool isReady) = 0;
+    // Runs work of the player on the handler thread of the stream manager, after the actions queued before it.
+    virtual bool PostTask(const std::function<void(void)> &task) = 0;
 };
 } // namespace CastEngineService
 } // namespace CastEngine
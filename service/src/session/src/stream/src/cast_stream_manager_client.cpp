@@ -131,6 +131,7 @@ bool CastStreamManagerClient::NotifyPeerLoad(const MediaInfo &mediaInfo)
     size_t mediaInfoListSize = 1;
     {
         std::lock_guard<std::mutex> lock(eventMutex_);
+        sentMediaInfoList_ = { mediaInfo };
         startPosition_ = mediaInfo.startPosition;
         currentPosition_ = CAST_STREAM_INT_INVALID;
         currentDuration_ = CAST_STREAM_INT_INVALID;
@@ -143,7 +144,11 @@ bool CastStreamManagerClient::NotifyPeerLoad(const MediaInfo &mediaInfo)
     }
     body[KEY_LIST] = list;
     CLOGD("list size:%{public}zu ", list.size());
-    return SendControlAction(ACTION_LOAD, body);
+    if (!SendControlAction(ACTION_LOAD, body)) {
+        return false;
+    }
+    OnMediaInfoSent(mediaInfo, IsDoubleFrame());
+    return true;
 }
 
 bool CastStreamManagerClient::NotifyPeerPlay(const MediaInfo &mediaInfo)
@@ -156,6 +161,7 @@ bool CastStreamManagerClient::NotifyPeerPlay(const MediaInfo &mediaInfo)
     size_t mediaInfoListSize = 1;
     {
         std::lock_guard<std::mutex> lock(eventMutex_);
+        sentMediaInfoList_ = { mediaInfo };
         startPosition_ = mediaInfo.startPosition;
         currentPosition_ = CAST_STREAM_INT_INVALID;
         currentDuration_ = CAST_STREAM_INT_INVALID;
@@ -168,7 +174,47 @@ bool CastStreamManagerClient::NotifyPeerPlay(const MediaInfo &mediaInfo)
     }
     body[KEY_LIST] = list;
     CLOGD("list size:%{public}zu ", list.size());
-    return SendControlAction(ACTION_PLAY, body);
+    if (!SendControlAction(ACTION_PLAY, body)) {
+        return false;
+    }
+    OnMediaInfoSent(mediaInfo, IsDoubleFrame());
+    return true;
+}
+
+bool CastStreamManagerClient::NotifyPeerPlayIndex(int index)
+{
+    CLOGD("NotifyPeerPlayIndex in");
+    json body;
+    body[KEY_CURRENT_INDEX] = index;
+    body[KEY_PROGRESS_INTERVAL] = 0;
+    bool isSupportPlayIndex = false;
+    {
+        std::lock_guard<std::mutex> lock(dataMutex_);
+        isSupportPlayIndex = isSupportPlayIndex_;
+    }
+    if (isSupportPlayIndex) {
+        return SendControlAction(ACTION_PLAY, body);
+    }
+
+    // An older sink plays the first item of the list it gets, so it is sent the chosen item in full.
+    MediaInfo mediaInfo;
+    {
+        std::lock_guard<std::mutex> lock(eventMutex_);
+        if (index < 0 || static_cast<size_t>(index) >= sentMediaInfoList_.size()) {
+            CLOGE("Invalid index %{public}d, list size %{public}zu", index, sentMediaInfoList_.size());
+            return false;
+        }
+        mediaInfo = sentMediaInfoList_[index];
+    }
+    json info;
+    EncapMediaInfo(mediaInfo, info, IsDoubleFrame());
+    body[KEY_CURRENT_INDEX] = 0;
+    body[KEY_LIST] = json::array({ info });
+    if (!SendControlAction(ACTION_PLAY, body)) {
+        return false;
+    }
+    OnMediaInfoSent(mediaInfo, IsDoubleFrame());
+    return true;
 }
 
 bool CastStreamManagerClient::NotifyPeerPause()
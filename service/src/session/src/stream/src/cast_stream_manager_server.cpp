@@ -134,7 +134,11 @@ bool CastStreamManagerServer::NotifyPeerMediaItemChanged(const MediaInfo &mediaI
     CLOGD("NotifyPeerMediaItemChanged in");
     json body;
     EncapMediaInfo(mediaInfo, body, false);
-    return SendCallbackAction(ACTION_MEDIA_ITEM_CHANGED, body);
+    if (!SendCallbackAction(ACTION_MEDIA_ITEM_CHANGED, body)) {
+        return false;
+    }
+    OnMediaInfoSent(mediaInfo, false);
+    return true;
 }
 
 bool CastStreamManagerServer::NotifyPeerVolumeChanged(int volume, int maxVolume)
@@ -186,7 +190,11 @@ bool CastStreamManagerServer::NotifyPeerPlayRequest(const MediaInfo &mediaInfo)
     }
     body[KEY_LIST] = list;
     CLOGD("list size:%{public}zu ", list.size());
-    return SendControlAction(ACTION_PLAY_REQUEST, body);
+    if (!SendControlAction(ACTION_PLAY_REQUEST, body)) {
+        return false;
+    }
+    OnMediaInfoSent(mediaInfo, false);
+    return true;
 }
 
 bool CastStreamManagerServer::NotifyPeerCreateChannel()
@@ -219,6 +227,11 @@ void CastStreamManagerServer::OnRenderReady(bool isReady)
     streamListener_->OnRenderReady(isReady);
 }
 
+bool CastStreamManagerServer::PostTask(const std::function<void(void)> &task)
+{
+    return EnqueueTask(task);
+}
+
 bool CastStreamManagerServer::PlayAfterSwitchToStream()
 {
     CLOGE("Don't support PlayAfterSwitchToStream in CastStreamManagerServer");
@@ -268,7 +281,7 @@ bool CastStreamManagerServer::ProcessActionLoad(const json &data)
         CLOGE("ParseMediaInfoHolder failed");
         return false;
     }
-    return player->Load(mediaInfoHolder.mediaInfoList.front());
+    return player->Load(mediaInfoHolder);
 }
 
 bool CastStreamManagerServer::ProcessActionPlay(const json &data)
@@ -279,12 +292,18 @@ bool CastStreamManagerServer::ProcessActionPlay(const json &data)
         CLOGE("player is nullptr");
         return false;
     }
+    if (!data.contains(KEY_LIST)) {
+        // Play another item of the loaded list.
+        int index = 0;
+        RETURN_FALSE_IF_PARSE_NUMBER_WRONG(index, data, KEY_CURRENT_INDEX);
+        return player->Play(index);
+    }
     MediaInfoHolder mediaInfoHolder = MediaInfoHolder{};
     if (!ParseMediaInfoHolder(data, mediaInfoHolder)) {
         CLOGE("ParseMediaInfoHolder failed");
         return false;
     }
-    return player->InnerPlay(mediaInfoHolder.mediaInfoList.front());
+    return player->InnerPlay(mediaInfoHolder);
 }
 
 bool CastStreamManagerServer::ProcessActionPause(const json &data)
@@ -19,6 +19,7 @@
 
 #include "i_cast_stream_manager.h"
 #include "cast_engine_log.h"
+#include "cast_engine_metrics.h"
 #include "remote_player_controller.h"
 #include "cast_local_file_channel_client.h"
 #include "cast_local_file_channel_server.h"
@@ -67,6 +68,7 @@ ICastStreamManager::~ICastStreamManager()
 void ICastStreamManager::Handle()
 {
     CLOGD("in");
+    static auto &handleTime = CastEngineMetrics::GetInstance().RegisterHistogram(METRIC_STREAM_ACTION_HANDLE_US);
     while (isRunning_.load()) {
         std::pair<json, StreamActionProcessor> work;
         {
@@ -80,11 +82,26 @@ void ICastStreamManager::Handle()
             work = workQueue_.front();
             workQueue_.pop();
         }
+        MetricScopedTimer timer(handleTime);
         (work.second)(work.first);
     }
     CLOGD("out");
 }
 
+bool ICastStreamManager::EnqueueTask(const std::function<void(void)> &task)
+{
+    if (!task || !isRunning_.load()) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(queueMutex_);
+    workQueue_.push(std::pair<json, StreamActionProcessor> { json {}, [task](const json &data) {
+        task();
+        return true;
+    } });
+    condition_.notify_all();
+    return true;
+}
+
 void ICastStreamManager::ProcessActionsEvent(int event, const std::string &param)
 {
     CLOGD("in");
@@ -93,7 +110,12 @@ void ICastStreamManager::ProcessActionsEvent(int event, const std::string &param
         CLOGE("something wrong for the json data!");
         return;
     }
-    json data = json::parse(param, nullptr, false);
+    static auto &decodeTime = CastEngineMetrics::GetInstance().RegisterHistogram(METRIC_STREAM_ACTION_DECODE_US);
+    json data;
+    {
+        MetricScopedTimer timer(decodeTime);
+        data = json::parse(param, nullptr, false);
+    }
     if (!data.contains(KEY_DATA)) {
         CLOGE("json object have no data");
         return;
@@ -106,11 +128,15 @@ void ICastStreamManager::ProcessActionsEvent(int event, const std::string &param
         keyAction = KEY_CALLBACK_ACTION;
     }
 
+    static auto &rxActions = CastEngineMetrics::GetInstance().RegisterCounter(METRIC_STREAM_RX_ACTIONS);
+    static auto &droppedActions = CastEngineMetrics::GetInstance().RegisterCounter(METRIC_STREAM_DROPPED_ACTIONS);
+    rxActions.Add();
     std::string action;
     RETURN_VOID_IF_PARSE_STRING_WRONG(action, data, keyAction);
     auto iter = streamActionProcessor_.find(action);
     if (iter == streamActionProcessor_.end()) {
         CLOGE("unsupport action %{public}s", action.c_str());
+        droppedActions.Add();
         return;
     }
 
@@ -178,10 +204,16 @@ void ICastStreamManager::EncapMediaInfo(const MediaInfo &mediaInfo, json &data,
     data[KEY_MEDIA_ARTIST] = mediaInfo.mediaArtist;
     data[KEY_APP_NAME] = mediaInfo.appName;
     if (!isDoubleFrame) {
-        data[KEY_ALBUM_COVER_URL] = mediaInfo.albumCoverUrl;
+        EncapPreloadData(mediaInfo, data);
         data[KEY_LRC_URL] = mediaInfo.lrcUrl;
         data[KEY_LRC_CONTENT] = mediaInfo.lrcContent;
-        data[KEY_APP_ICON_URL] = mediaInfo.appIconUrl;
+        std::lock_guard<std::mutex> lock(artworkMutex_);
+        if (!isSupportArtworkDelta_ || mediaInfo.albumCoverUrl != sentAlbumCoverUrl_) {
+            data[KEY_ALBUM_COVER_URL] = mediaInfo.albumCoverUrl;
+        }
+        if (!isSupportArtworkDelta_ || mediaInfo.appIconUrl != sentAppIconUrl_) {
+            data[KEY_APP_ICON_URL] = mediaInfo.appIconUrl;
+        }
     } else {
         data[KEY_UX_ADAPT_MODE] = 1;
         if (isSupportAlbumCover_) {
@@ -190,6 +222,17 @@ void ICastStreamManager::EncapMediaInfo(const MediaInfo &mediaInfo, json &data,
     }
 }
 
+void ICastStreamManager::OnMediaInfoSent(const MediaInfo &mediaInfo, bool isDoubleFrame)
+{
+    if (isDoubleFrame) {
+        return;
+    }
+    // Only what the peer actually got can be left out of the next media info.
+    std::lock_guard<std::mutex> lock(artworkMutex_);
+    sentAlbumCoverUrl_ = mediaInfo.albumCoverUrl;
+    sentAppIconUrl_ = mediaInfo.appIconUrl;
+}
+
 bool ICastStreamManager::ParseMediaInfo(const json &data, MediaInfo &mediaInfo, bool isDoubleFrame)
 {
     RETURN_FALSE_IF_PARSE_STRING_WRONG(mediaInfo.mediaId, data, KEY_MEDIA_ID);
@@ -205,16 +248,80 @@ bool ICastStreamManager::ParseMediaInfo(const json &data, MediaInfo &mediaInfo,
         RETURN_FALSE_IF_PARSE_NUMBER_WRONG(mediaInfo.startPosition, data, KEY_START_POSITION);
         RETURN_FALSE_IF_PARSE_NUMBER_WRONG(mediaInfo.duration, data, KEY_DURATION);
         RETURN_FALSE_IF_PARSE_NUMBER_WRONG(mediaInfo.closingCreditsPosition, data, KEY_CLOSING_CREDITS_POSITION);
-        RETURN_FALSE_IF_PARSE_STRING_WRONG(mediaInfo.albumCoverUrl, data, KEY_ALBUM_COVER_URL);
+        ParsePreloadData(data, mediaInfo);
         RETURN_FALSE_IF_PARSE_STRING_WRONG(mediaInfo.lrcContent, data, KEY_LRC_CONTENT);
-        RETURN_FALSE_IF_PARSE_STRING_WRONG(mediaInfo.appIconUrl, data, KEY_APP_ICON_URL);
         RETURN_FALSE_IF_PARSE_STRING_WRONG(mediaInfo.lrcUrl, data, KEY_LRC_URL);
+        std::lock_guard<std::mutex> lock(artworkMutex_);
+        if (data.contains(KEY_ALBUM_COVER_URL)) {
+            RETURN_FALSE_IF_PARSE_STRING_WRONG(mediaInfo.albumCoverUrl, data, KEY_ALBUM_COVER_URL);
+            receivedAlbumCoverUrl_ = mediaInfo.albumCoverUrl;
+        } else {
+            mediaInfo.albumCoverUrl = receivedAlbumCoverUrl_;
+        }
+        if (data.contains(KEY_APP_ICON_URL)) {
+            RETURN_FALSE_IF_PARSE_STRING_WRONG(mediaInfo.appIconUrl, data, KEY_APP_ICON_URL);
+            receivedAppIconUrl_ = mediaInfo.appIconUrl;
+        } else {
+            mediaInfo.appIconUrl = receivedAppIconUrl_;
+        }
     } else {
         mediaInfo.mediaUrl = "DOUBLE_FRAME";
     }
     return true;
 }
 
+/*
+ * A local file goes out with its length and first bytes, so that the sink can start probing the container without
+ * waiting on the file channel. Peers that do not know the head simply ignore it, and the ones that cannot ask for
+ * the length themselves always get it, even if the probe is slow.
+ */
+void ICastStreamManager::EncapPreloadData(const MediaInfo &mediaInfo, json &data)
+{
+    std::shared_ptr<ICastLocalFileChannel> localFileChannel;
+    bool isLengthRequired = true;
+    {
+        std::lock_guard<std::mutex> lock(dataMutex_);
+        localFileChannel = localFileChannel_;
+        isLengthRequired = !isSupportFileLengthRequest_;
+    }
+    LocalFilePreload preload;
+    if (!localFileChannel || !localFileChannel->GetPreloadData(mediaInfo.mediaUrl, isLengthRequired, preload)) {
+        return;
+    }
+    if (preload.isMultiRangeSupported) {
+        data[KEY_MEDIA_MULTI_RANGE] = STREM_ADVANCED_FEATURE_SUPPORTED;
+    }
+    if (preload.fileLen <= 0) {
+        return;
+    }
+    data[KEY_MEDIA_SIZE] = preload.fileLen;
+    std::string encodedHead;
+    if (!preload.head.empty() && Utils::Base64Encode(preload.head, encodedHead)) {
+        data[KEY_MEDIA_HEAD] = encodedHead;
+    }
+}
+
+void ICastStreamManager::ParsePreloadData(const json &data, const MediaInfo &mediaInfo)
+{
+    LocalFilePreload preload;
+    preload.fileLen = static_cast<int64_t>(mediaInfo.mediaSize);
+    if (data.contains(KEY_MEDIA_HEAD) && data[KEY_MEDIA_HEAD].is_string() &&
+        !Utils::Base64Decode(data[KEY_MEDIA_HEAD].get<std::string>(), preload.head)) {
+        CLOGW("Invalid media head");
+        preload.head.clear();
+    }
+    preload.isMultiRangeSupported = data.contains(KEY_MEDIA_MULTI_RANGE) && data[KEY_MEDIA_MULTI_RANGE].is_number() &&
+        data[KEY_MEDIA_MULTI_RANGE] == STREM_ADVANCED_FEATURE_SUPPORTED;
+    std::shared_ptr<ICastLocalFileChannel> localFileChannel;
+    {
+        std::lock_guard<std::mutex> lock(dataMutex_);
+        localFileChannel = localFileChannel_;
+    }
+    if (localFileChannel) {
+        localFileChannel->SetPreloadData(mediaInfo.mediaUrl, preload);
+    }
+}
+
 void ICastStreamManager::EncapStreamCapability(const StreamCapability &streamCapability, json &data)
 {
     data[KEY_SUPPORT_PLAY] = streamCapability.isPlaySupported;
@@ -256,7 +363,14 @@ bool ICastStreamManager::SendControlAction(const std::string &action, const json
     json data;
     data[KEY_ACTION] = action;
     data[KEY_DATA] = dataBody;
-    std::string dataStr = data.dump(-1, ' ', false, json::error_handler_t::ignore);
+    static auto &encodeTime = CastEngineMetrics::GetInstance().RegisterHistogram(METRIC_STREAM_ACTION_ENCODE_US);
+    static auto &txActions = CastEngineMetrics::GetInstance().RegisterCounter(METRIC_STREAM_TX_ACTIONS);
+    std::string dataStr;
+    {
+        MetricScopedTimer timer(encodeTime);
+        dataStr = data.dump(-1, ' ', false, json::error_handler_t::ignore);
+    }
+    txActions.Add();
     return streamListener_->SendActionToPeers(MODULE_EVENT_ID_CONTROL_EVENT, dataStr);
 }
 
@@ -269,7 +383,14 @@ bool ICastStreamManager::SendCallbackAction(const std::string &action, const jso
     json data;
     data[KEY_CALLBACK_ACTION] = action;
     data[KEY_DATA] = dataBody;
-    std::string dataStr = data.dump(-1, ' ', false, json::error_handler_t::ignore);
+    static auto &encodeTime = CastEngineMetrics::GetInstance().RegisterHistogram(METRIC_STREAM_ACTION_ENCODE_US);
+    static auto &txActions = CastEngineMetrics::GetInstance().RegisterCounter(METRIC_STREAM_TX_ACTIONS);
+    std::string dataStr;
+    {
+        MetricScopedTimer timer(encodeTime);
+        dataStr = data.dump(-1, ' ', false, json::error_handler_t::ignore);
+    }
+    txActions.Add();
     return streamListener_->SendActionToPeers(MODULE_EVENT_ID_CALLBACK_EVENT, dataStr);
 }
 
@@ -284,6 +405,9 @@ std::string ICastStreamManager::GetStreamPlayerCapability()
     data[KEY_CAPABILITY_SUPPORT_DRM] = CAST_STREAM_INT_INVALID;
     data[KEY_CAPABILITY_DRM_PROPERTIES] = CAST_STREAM_INT_INVALID;
     data[KEY_CAPABILITY_SUPPOR_ALBUM_COVER] = CAST_STREAM_INT_INVALID;
+    data[KEY_CAPABILITY_SUPPORT_ARTWORK_DELTA] = STREM_ADVANCED_FEATURE_SUPPORTED;
+    data[KEY_CAPABILITY_SUPPORT_FILE_LENGTH_REQUEST] = STREM_ADVANCED_FEATURE_SUPPORTED;
+    data[KEY_CAPABILITY_SUPPORT_PLAY_INDEX] = STREM_ADVANCED_FEATURE_SUPPORTED;
 
     return data.dump();
 }
@@ -303,6 +427,21 @@ std::string ICastStreamManager::HandleCustomNegotiationParams(const std::string
         isSupportAlbumCover_ = (albumCover == STREM_ADVANCED_FEATURE_SUPPORTED) ? true : false;
         CLOGI("supportAlbumCover is %{public}d", isSupportAlbumCover_);
     }
+    if (data.contains(KEY_CAPABILITY_SUPPORT_ARTWORK_DELTA) && data[KEY_CAPABILITY_SUPPORT_ARTWORK_DELTA].is_number()) {
+        std::lock_guard<std::mutex> artworkLock(artworkMutex_);
+        isSupportArtworkDelta_ = data[KEY_CAPABILITY_SUPPORT_ARTWORK_DELTA] == STREM_ADVANCED_FEATURE_SUPPORTED;
+        CLOGI("supportArtworkDelta is %{public}d", isSupportArtworkDelta_);
+    }
+    if (data.contains(KEY_CAPABILITY_SUPPORT_FILE_LENGTH_REQUEST) &&
+        data[KEY_CAPABILITY_SUPPORT_FILE_LENGTH_REQUEST].is_number()) {
+        isSupportFileLengthRequest_ =
+            data[KEY_CAPABILITY_SUPPORT_FILE_LENGTH_REQUEST] == STREM_ADVANCED_FEATURE_SUPPORTED;
+        CLOGI("supportFileLengthRequest is %{public}d", isSupportFileLengthRequest_);
+    }
+    if (data.contains(KEY_CAPABILITY_SUPPORT_PLAY_INDEX) && data[KEY_CAPABILITY_SUPPORT_PLAY_INDEX].is_number()) {
+        isSupportPlayIndex_ = data[KEY_CAPABILITY_SUPPORT_PLAY_INDEX] == STREM_ADVANCED_FEATURE_SUPPORTED;
+        CLOGI("supportPlayIndex is %{public}d", isSupportPlayIndex_);
+    }
 
     CLOGI("hcurrentVolume: %{public}d, maxVolume: %{public}d.", currentVolume_, maxVolume_);
     return "";
@@ -19,10 +19,12 @@
 #ifndef CAST_LOCAL_FILE_CHANNEL_CLIENT_H
 #define CAST_LOCAL_FILE_CHANNEL_CLIENT_H
 
+#include <atomic>
 #include <string>
 #include <map>
 #include <list>
 #include <condition_variable>
+#include <vector>
 
 #include "cast_engine_common.h"
 #include "channel_listener.h"
@@ -45,11 +47,16 @@ public:
     void AddChannel(std::shared_ptr<Channel> channel) override;
     void RemoveChannel(std::shared_ptr<Channel> channel) override;
     void SetParamInfo(CastSessionRtsp::ParamInfo &paramInfo, const CastInnerRemoteDevice &remote) override;
+    void SetPreloadData(const std::string &fileId, const LocalFilePreload &preload) override;
 
     void OnDataReceived(const uint8_t *buffer, unsigned int length, long timeCost) override;
 
     void RequestByteData(int64_t start, int64_t end, const std::string &fileId);
+    // One round trip for all the ranges when the source takes range lists, one request per range otherwise.
+    void RequestByteRanges(const std::vector<ByteRange> &ranges, const std::string &fileId);
     int64_t RequestFileLength(const std::string &fileId);
+    // Hands out the head that came with the load action, once.
+    bool TakePreloadHead(const std::string &fileId, std::string &head);
 
     void NotifyCreateChannel();
     void WaitCreateChannel();
@@ -70,8 +77,17 @@ private:
     std::mutex chLock_;
     std::mutex listenerLock_;
 
+    std::mutex preloadLock_;
+    std::condition_variable fileLengthCond_;
+    std::map<std::string, int64_t> fileLengths_;
+    std::map<std::string, std::string> preloadHeads_;
+    std::atomic<bool> isMultiRangeSupported_{ false };
+
     bool ProcessServerResponse(const uint8_t *buffer, unsigned int length, std::map<std::string, std::string> &response,
         size_t &dataOffset);
+    void ProcessFileLengthResponse(std::map<std::string, std::string> &response);
+    bool SendRequest(const std::string &fileId, const std::string &range);
+    void NotifyDataListeners(const std::string &fileName, const uint8_t *bytes, int64_t start, int64_t length);
 };
 } // namespace CastEngineService
 } // namespace CastEngine
@@ -19,9 +19,13 @@
 #ifndef CAST_LOCAL_FILE_CHANNEL_SERVER_H
 #define CAST_LOCAL_FILE_CHANNEL_SERVER_H
 
+#include <condition_variable>
+#include <deque>
 #include <string>
 #include <map>
+#include <memory>
 #include <mutex>
+#include <vector>
 
 #include "cast_engine_common.h"
 #include "channel_listener.h"
@@ -46,15 +50,40 @@ public:
     void AddChannel(std::shared_ptr<Channel> channel) override;
     void RemoveChannel(std::shared_ptr<Channel> channel) override;
     void SetParamInfo(CastSessionRtsp::ParamInfo &paramInfo, const CastInnerRemoteDevice &remote) override;
+    bool GetPreloadData(const std::string &fileId, bool isLengthRequired, LocalFilePreload &preload) override;
 
     void OnDataReceived(const uint8_t *buffer, unsigned int length, long timeCost) override;
+    void OnSendQueueWatermark(bool isAboveHighWatermark, size_t queuedBytes) override;
 
 private:
+    /*
+     * Length, head and tail of a registered file, filled in by a probe thread so that a slow provider behind the fd
+     * never blocks the load path. The length is published as soon as it is known, the rest once isDone is set.
+     */
+    struct FileProbe {
+        std::mutex mutex;
+        std::condition_variable cond;
+        bool isLengthKnown = false;
+        bool isDone = false;
+        int64_t fileLen = 0;
+        std::string head;
+        int64_t tailStart = 0;
+        std::string tail;
+    };
+
     struct LocalFileInfo {
         std::string encodedUrl;
         std::string localFile;
         int fd = INVALID_VALUE;
-        int64_t fileLen = 0;
+        std::shared_ptr<FileProbe> probe;
+    };
+
+    struct PendingRequest {
+        std::string uri;
+        int64_t start = 0;
+        int64_t end = 0;
+        // Parts of a multi-range request, start and end are unused then.
+        std::vector<ByteRange> ranges;
     };
 
     constexpr static int SESSION_KEY_LENGTH = 16;
@@ -68,7 +97,20 @@ private:
     std::mutex chLock_;
     std::mutex mapLock_;
 
-    int64_t GetFileLengthByFd(int fd);
+    // Requests held back while the channel has more queued than its high watermark.
+    std::mutex requestLock_;
+    std::deque<PendingRequest> pendingRequests_;
+    bool isSendBlocked_ = false;
+    bool isDraining_ = false;
+
+    // Gaps up to this length between requested parts are read and dropped, saving a syscall per part.
+    constexpr static int64_t MAX_READ_GAP_LEN = 64 * 1024;
+
+    static int64_t GetFileLengthByFd(int fd);
+    static void ProbeFile(int fd, std::shared_ptr<FileProbe> probe);
+    static bool WaitFileProbe(const std::shared_ptr<FileProbe> &probe, int timeoutMs);
+    static int64_t WaitFileLength(const LocalFileInfo &data, int timeoutMs);
+    static bool ReadProbedData(const std::shared_ptr<FileProbe> &probe, int64_t start, int64_t sendLen, uint8_t *ptr);
     int64_t GetFileLengthByFileName(const std::string &file);
     int FindLocalFd(const std::string &encodedUri);
     struct LocalFileInfo FindLocalFileInfo(const std::string &encodedUri);
@@ -79,9 +121,15 @@ private:
     void ResponseFileLengthRequest(const std::string &uri, int64_t fileLen);
     void ResponseFileDataRequest(const std::string &uri, int64_t fileLen, int64_t start, int64_t end);
     void ResponseFileRequest(const std::string &uri, int64_t start, int64_t end);
+    void ResponseFileRangesRequest(const std::string &uri, const std::vector<ByteRange> &ranges);
+    void ResponseRequest(const PendingRequest &request);
+    bool ReadFileRanges(const struct LocalFileInfo &data, const std::vector<ByteRange> &parts, uint8_t *ptr);
+    void ServePendingRequests();
+    void ClearPendingRequests();
     void SendData(const uint8_t *buffer, int length);
     void ClearAllMapInfo();
-    int ReadFileDataByFd(int fd, int64_t start, int sendLen, uint8_t *buffer);
+    static int ReadFileDataByFd(int fd, int64_t start, int sendLen, uint8_t *buffer);
+    static bool ReadFileSpanByFd(int fd, const ByteRange *parts, size_t count, uint8_t *buffer);
 };
 
 } // namespace CastEngineService
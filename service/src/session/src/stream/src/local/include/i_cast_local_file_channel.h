@@ -19,6 +19,8 @@
 #ifndef I_CAST_LOCAL_FILE_CHANNEL_H
 #define I_CAST_LOCAL_FILE_CHANNEL_H
 
+#include <string>
+
 #include "channel.h"
 #include "rtsp_param_info.h"
 
@@ -26,6 +28,19 @@ namespace OHOS {
 namespace CastEngine {
 namespace CastEngineService {
 
+// [start, end) of a file.
+struct ByteRange {
+    int64_t start = 0;
+    int64_t end = 0;
+};
+
+// What the sink learns about a local file from the load action, ahead of any request on the file channel.
+struct LocalFilePreload {
+    int64_t fileLen = 0;
+    std::string head;
+    bool isMultiRangeSupported = false;
+};
+
 class ICastLocalFileChannel {
 public:
     virtual ~ICastLocalFileChannel() = default;
@@ -33,6 +48,14 @@ public:
     virtual void AddChannel(std::shared_ptr<Channel> channel) = 0;
     virtual void RemoveChannel(std::shared_ptr<Channel> channel) = 0;
     virtual void SetParamInfo(CastSessionRtsp::ParamInfo &paramInfo, const CastInnerRemoteDevice &remote) = 0;
+    // Source side, the length and the first bytes of a registered file, sent along with the load action. The length
+    // is always filled in when isLengthRequired is set, the head only if the file has been probed in time.
+    virtual bool GetPreloadData(const std::string &fileId, bool isLengthRequired, LocalFilePreload &preload)
+    {
+        return false;
+    }
+    // Sink side, keeps what came with the load action until the data source of the file takes it.
+    virtual void SetPreloadData(const std::string &fileId, const LocalFilePreload &preload) {}
 };
 } // namespace CastEngineService
 } // namespace CastEngine
@@ -19,7 +19,9 @@
 #ifndef DATA_SOURCE_BUFFER_H
 #define DATA_SOURCE_BUFFER_H
 
+#include <atomic>
 #include <mutex>
+#include <vector>
 #include <condition_variable>
 #include "cast_local_file_channel_client.h"
 #include "cast_stream_common.h"
@@ -37,7 +39,7 @@ public:
     bool Write(const uint8_t *data, int64_t offset, int64_t length);
     bool IsMatch(int64_t pos);
     bool IsValid();
-    int IsNeedReqData(int64_t &start, int64_t &end);
+    int IsNeedReqData(int64_t &start, int64_t &end, int64_t maxLength = SINGLE_REQUEST_MAX_SIZE);
     void Reset(int64_t pos);
     int64_t GetUsedTime();
 
@@ -85,15 +87,22 @@ public:
     int32_t ReadBuffer(uint8_t *data, uint32_t length, int64_t pos);
     bool Start();
     bool Stop();
+    // Requests the head and the tail of the file ahead of the first read, starting from what came with the load
+    // action. Most containers keep their index at one of the two ends.
+    void Prefetch();
 
 private:
     std::shared_ptr<Cache> GetBestCache(int64_t pos);
     void SolveReqData(std::shared_ptr<Cache> cache, int64_t pos);
 
     static const int MAX_CACHE_COUNT = 4; // total cache: 4 * 5 = 20MB
+    // Together below the 2MB the source sends at one time, so both come back in one response.
+    static const int PREFETCH_HEAD_SIZE = 1 * 1024 * 1024; // 1MB
+    static const int PREFETCH_TAIL_SIZE = 512 * 1024;      // 512KB
 
     std::string fileId_;
-    int64_t fileLength_{ 0 };
+    // Zero until the source sent it, either with the load action or on request.
+    std::atomic<int64_t> fileLength_{ 0 };
 
     std::mutex dataMutex_;
     std::vector<std::shared_ptr<Cache>> lruCache_;
@@ -26,6 +26,7 @@
 #include <cinttypes>
 
 #include "cast_engine_log.h"
+#include "cast_engine_metrics.h"
 #include "cast_local_file_channel_common.h"
 #include "securec.h"
 
@@ -35,6 +36,9 @@ namespace CastEngineService {
 DEFINE_CAST_ENGINE_LABEL("Cast-Localfile-Client");
 
 static const int CREATE_CHANNEL_TIMEOUT = 10 * 1000;
+static const int REQUEST_FILE_LENGTH_TIMEOUT = 5 * 1000;
+// Only the files of the latest load are of interest.
+static const size_t MAX_PRELOAD_COUNT = 8;
 
 CastLocalFileChannelClient::CastLocalFileChannelClient(std::shared_ptr<ICastStreamManagerServer> callback)
 {
@@ -129,28 +133,102 @@ void CastLocalFileChannelClient::SetParamInfo(CastSessionRtsp::ParamInfo &param,
 
 void CastLocalFileChannelClient::RequestByteData(int64_t start, int64_t end, const std::string &fileId)
 {
+    CLOGD("request data: %s len %{public}" PRId64 "-%{public}" PRId64, fileId.c_str(), start, end);
+    SendRequest(fileId, std::to_string(start) + "-" + std::to_string(end));
+}
+
+void CastLocalFileChannelClient::RequestByteRanges(const std::vector<ByteRange> &ranges, const std::string &fileId)
+{
+    if (ranges.size() == 1 || !isMultiRangeSupported_) {
+        for (const auto &range : ranges) {
+            RequestByteData(range.start, range.end, fileId);
+        }
+        return;
+    }
+    for (size_t i = 0; i < ranges.size(); i += MAX_RANGE_COUNT) {
+        std::vector<ByteRange> batch(ranges.begin() + i, ranges.begin() + std::min(ranges.size(), i + MAX_RANGE_COUNT));
+        std::string rangeList = FormatByteRanges(batch);
+        CLOGD("request ranges: %s %{public}s", fileId.c_str(), rangeList.c_str());
+        SendRequest(fileId, rangeList);
+    }
+}
+
+bool CastLocalFileChannelClient::SendRequest(const std::string &fileId, const std::string &range)
+{
+    static auto &requests = CastEngineMetrics::GetInstance().RegisterCounter(METRIC_DATA_SOURCE_REQUESTS);
     std::shared_ptr<Channel> channel;
     {
         std::unique_lock<std::mutex> lock(chLock_);
         if (!channel_) {
             CLOGE("channel is not created.");
-            return;
+            return false;
         }
         channel = channel_;
     }
     // Make http request header
     std::string req("GET ");
     req.append(fileId);
-    req.append(" HTTP/1.1\r\nRange: bytes=" + std::to_string(start) + "-" + std::to_string(end) + "\r\n\r\n");
+    req.append(" HTTP/1.1\r\nRange: bytes=" + range + "\r\n\r\n");
 
-    CLOGD("request data: %s len %{public}" PRId64 "-%{public}" PRId64, fileId.c_str(), start, end);
+    requests.Add();
+    return channel->Send(reinterpret_cast<uint8_t *>(const_cast<char *>(req.data())), req.size());
+}
 
-    channel->Send(reinterpret_cast<uint8_t *>(const_cast<char *>(req.data())), req.size());
+void CastLocalFileChannelClient::SetPreloadData(const std::string &fileId, const LocalFilePreload &preload)
+{
+    // The flag describes the source rather than the file, so a remote url in the same list does not clear it.
+    if (preload.isMultiRangeSupported) {
+        isMultiRangeSupported_ = true;
+    }
+    std::lock_guard<std::mutex> lock(preloadLock_);
+    if (fileLengths_.size() >= MAX_PRELOAD_COUNT) {
+        fileLengths_.clear();
+    }
+    if (preloadHeads_.size() >= MAX_PRELOAD_COUNT) {
+        preloadHeads_.clear();
+    }
+    if (preload.fileLen > 0) {
+        fileLengths_[fileId] = preload.fileLen;
+    }
+    if (!preload.head.empty()) {
+        preloadHeads_[fileId] = preload.head;
+    }
+    CLOGD("file %s len %{public}" PRId64 " head %{public}zu multi range %{public}d", fileId.c_str(), preload.fileLen,
+        preload.head.size(), preload.isMultiRangeSupported);
+}
+
+bool CastLocalFileChannelClient::TakePreloadHead(const std::string &fileId, std::string &head)
+{
+    std::lock_guard<std::mutex> lock(preloadLock_);
+    auto it = preloadHeads_.find(fileId);
+    if (it == preloadHeads_.end()) {
+        return false;
+    }
+    head = std::move(it->second);
+    preloadHeads_.erase(it);
+    return true;
 }
 
 int64_t CastLocalFileChannelClient::RequestFileLength(const std::string &fileId)
 {
-    return 0;
+    {
+        std::lock_guard<std::mutex> lock(preloadLock_);
+        auto it = fileLengths_.find(fileId);
+        if (it != fileLengths_.end()) {
+            return it->second;
+        }
+    }
+
+    // A zero range is answered with the length only, see CastLocalFileChannelServer::ResponseFileRequest.
+    RequestByteData(0, 0, fileId);
+    std::unique_lock<std::mutex> lock(preloadLock_);
+    bool isReceived = fileLengthCond_.wait_for(lock, std::chrono::milliseconds(REQUEST_FILE_LENGTH_TIMEOUT),
+        [this, &fileId] { return fileLengths_.count(fileId) != 0; });
+    if (!isReceived) {
+        CLOGE("request file length timeout, %s", fileId.c_str());
+        return 0;
+    }
+    return fileLengths_[fileId];
 }
 
 void CastLocalFileChannelClient::AddDataListener(std::shared_ptr<IDataListener> dataListener)
@@ -194,6 +272,20 @@ bool CastLocalFileChannelClient::ProcessServerResponse(const uint8_t *buffer, un
     return true;
 }
 
+void CastLocalFileChannelClient::ProcessFileLengthResponse(std::map<std::string, std::string> &response)
+{
+    int64_t fileLen = 0;
+    if (!ParseStringToInt64(response[HTTP_RSP_CONTENT_RANGE_TOTAL], fileLen) || fileLen <= 0) {
+        CLOGE("Invalid file length response");
+        return;
+    }
+    const std::string &fileName = response[HTTP_RSP_CONTENT_DISPOSITION];
+    CLOGD("URL %s file length %{public}" PRId64, fileName.c_str(), fileLen);
+    std::lock_guard<std::mutex> lock(preloadLock_);
+    fileLengths_[fileName] = fileLen;
+    fileLengthCond_.notify_all();
+}
+
 void CastLocalFileChannelClient::OnDataReceived(const uint8_t *buffer, unsigned int length, long timeCost)
 {
     CLOGD("buffer length %{public}u", length);
@@ -210,6 +302,10 @@ void CastLocalFileChannelClient::OnDataReceived(const uint8_t *buffer, unsigned
     int64_t contentLen = 0;
     int64_t start = 0;
     ret = ParseStringToInt64(response[HTTP_RSP_CONTENT_LENGTH], contentLen);
+    if (ret && contentLen == 0) {
+        ProcessFileLengthResponse(response);
+        return;
+    }
     ret = ret && ParseStringToInt64(response[HTTP_RSP_CONTENT_RANGE_START], start);
     if (!ret || contentLen <= 0 || contentLen > static_cast<int64_t>(length - dataOffset) || start <= INVALID_END_POS) {
         CLOGE("Invalid response, len:%{public}" PRId64 ", start: %{public}" PRId64, contentLen, start);
@@ -220,16 +316,44 @@ void CastLocalFileChannelClient::OnDataReceived(const uint8_t *buffer, unsigned
     CLOGD("headerLen %{public}zu URL %s start %{public}" PRId64 " content %{public}" PRId64, dataOffset,
         fileName.c_str(), start, contentLen);
 
-    // Notify data to listener
+    if (response.count(HTTP_RSP_CONTENT_RANGES) == 0) {
+        NotifyDataListeners(fileName, buffer + dataOffset, start, contentLen);
+        CLOGD("End");
+        return;
+    }
+
+    // Range list response, the parts follow each other in the body in the order of the list.
+    std::vector<ByteRange> parts;
+    int64_t partsLen = 0;
+    if (ParseByteRanges(response[HTTP_RSP_CONTENT_RANGES], parts)) {
+        for (const auto &part : parts) {
+            partsLen += part.end - part.start;
+        }
+    }
+    if (parts.empty() || partsLen != contentLen) {
+        CLOGE("Invalid content ranges %{public}s, len:%{public}" PRId64, response[HTTP_RSP_CONTENT_RANGES].c_str(),
+            contentLen);
+        return;
+    }
+    const uint8_t *part = buffer + dataOffset;
+    for (const auto &range : parts) {
+        NotifyDataListeners(fileName, part, range.start, range.end - range.start);
+        part += range.end - range.start;
+    }
+    CLOGD("End");
+}
+
+void CastLocalFileChannelClient::NotifyDataListeners(const std::string &fileName, const uint8_t *bytes, int64_t start,
+    int64_t length)
+{
     std::lock_guard<std::mutex> lock(listenerLock_);
     for (auto it = dataListeners_.begin(); it != dataListeners_.end(); it++) {
-        bool ret = (*it)->OnBytesReceived(fileName, buffer + dataOffset, start, contentLen);
+        bool ret = (*it)->OnBytesReceived(fileName, bytes, start, length);
         if (ret) {
             CLOGD("data uploaded");
             break;
         }
     }
-    CLOGD("End");
 }
 } // namespace CastEngineService
 } // namespace CastEngine
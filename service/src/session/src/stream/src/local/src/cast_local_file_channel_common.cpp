@@ -18,6 +18,8 @@
 
 #include "cast_local_file_channel_common.h"
 
+#include <algorithm>
+#include <cctype>
 #include <cinttypes>
 #include <map>
 #include <optional>
@@ -45,6 +47,10 @@ const std::string CONTENT_TYPE_TEXT = "Content-Type";
 const std::string CONTENT_LENGTH = "Content-Length";
 const std::string CONTENT_RANGE = "Content-Range";
 const std::string CONTENT_DISPOSITION = "Content-Disposition";
+const std::string CONTENT_RANGES = "Content-Ranges";
+const std::string RANGE_UNIT_PREFIX = "bytes=";
+const std::string RANGE_SEPARATOR = ",";
+const std::string RANGE_BOUND_SEPARATOR = "-";
 const std::string STATUS_OK_STR = "200 OK";
 
 const int RANGE_START_IDX = 1;
@@ -109,8 +115,8 @@ bool ParseHttpRangeHeader(std::string &range, int64_t &start, int64_t &end)
     /* Parse Range
         Range: <unit>=<range-start>-
         Range: <unit>=<range-start>-<range-end>
-        Range: <unit>=<range-start>-<range-end>, <range-start>-<range-end> # not support
-        Range: <unit>=<range-start>-<range-end>, <range-start>-<range-end>, <range-start>-<range-end> # not support
+        Range: <unit>=<range-start>-<range-end>, <range-start>-<range-end> # first range, all in ParseByteRanges
+        Range: <unit>=<range-start>-<range-end>, <range-start>-<range-end>, <range-start>-<range-end> # same
     */
     std::regex regex("bytes=(\\d+)-(\\d+)?");
     std::smatch matches;
@@ -242,6 +248,10 @@ bool ParseHttpRequest(const uint8_t *buffer, int length, std::map<std::string, s
     }
     request.insert({ HTTP_REQ_RANGE_START, std::to_string(start) });
     request.insert({ HTTP_REQ_RANGE_END, std::to_string(end) });
+    const std::string &range = request[HTTP_HEADER_RANGE];
+    if (range.find(RANGE_SEPARATOR) != std::string::npos && range.find(RANGE_UNIT_PREFIX) == 0) {
+        request.insert({ HTTP_REQ_RANGES, range.substr(RANGE_UNIT_PREFIX.size()) });
+    }
 
     return true;
 }
@@ -294,11 +304,57 @@ bool ParseHttpResponse(const uint8_t *buffer, int length, std::map<std::string,
         return false;
     }
     response.insert({ HTTP_RSP_CONTENT_DISPOSITION, matches[1].str() });
+    if (response.find(CONTENT_RANGES) != response.end()) {
+        response.insert({ HTTP_RSP_CONTENT_RANGES, response[CONTENT_RANGES] });
+    }
 
     dataOffset = *offset;
 
     return true;
 }
+
+static bool ParseRangeBound(const std::string &str, int64_t &val)
+{
+    // ParseStringToInt64 takes any numeric prefix, the bounds of a list have nothing else to delimit them.
+    return !str.empty() && std::all_of(str.begin(), str.end(), [](char c) { return std::isdigit(c); }) &&
+        ParseStringToInt64(str, val);
+}
+
+bool ParseByteRanges(const std::string &str, std::vector<ByteRange> &ranges)
+{
+    ranges.clear();
+    std::vector<std::string> rangeList;
+    Utils::SplitString(str, rangeList, RANGE_SEPARATOR);
+    if (rangeList.empty() || rangeList.size() > MAX_RANGE_COUNT) {
+        CLOGE("Invalid range count %{public}zu", rangeList.size());
+        return false;
+    }
+    for (auto &item : rangeList) {
+        std::string range = Utils::Trim(item);
+        auto pos = range.find(RANGE_BOUND_SEPARATOR);
+        ByteRange byteRange;
+        if (pos == std::string::npos || !ParseRangeBound(range.substr(0, pos), byteRange.start) ||
+            !ParseRangeBound(range.substr(pos + RANGE_BOUND_SEPARATOR.size()), byteRange.end) ||
+            byteRange.end < byteRange.start) {
+            CLOGE("Invalid range %{public}s", range.c_str());
+            return false;
+        }
+        ranges.push_back(byteRange);
+    }
+    return true;
+}
+
+std::string FormatByteRanges(const std::vector<ByteRange> &ranges)
+{
+    std::string str;
+    for (const auto &range : ranges) {
+        if (!str.empty()) {
+            str.append(RANGE_SEPARATOR);
+        }
+        str.append(std::to_string(range.start) + RANGE_BOUND_SEPARATOR + std::to_string(range.end));
+    }
+    return str;
+}
 } // namespace CastEngineService
 } // namespace CastEngine
 } // namespace OHOS
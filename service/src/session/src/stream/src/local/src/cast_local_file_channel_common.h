@@ -19,8 +19,12 @@
 #ifndef CAST_LOCAL_FILE_CHANNEL_COMMON_H
 #define CAST_LOCAL_FILE_CHANNEL_COMMON_H
 
+#include <cstdint>
 #include <string>
 #include <map>
+#include <vector>
+
+#include "i_cast_local_file_channel.h"
 
 namespace OHOS {
 namespace CastEngine {
@@ -29,6 +33,7 @@ const std::string HTTP_REQ_METHOD = "method";
 const std::string HTTP_REQ_URI = "uri";
 const std::string HTTP_REQ_RANGE_START = "range_start";
 const std::string HTTP_REQ_RANGE_END = "range_end";
+const std::string HTTP_REQ_RANGES = "ranges";
 const std::string HTTP_RSP_PROTOCOL = "protocol_ver";
 const std::string HTTP_RSP_CODE = "statusCode";
 const std::string HTTP_RSP_CONTENT_LENGTH = "content_length";
@@ -36,8 +41,11 @@ const std::string HTTP_RSP_CONTENT_RANGE_START = "range_start";
 const std::string HTTP_RSP_CONTENT_RANGE_END = "range_end";
 const std::string HTTP_RSP_CONTENT_RANGE_TOTAL = "range_total";
 const std::string HTTP_RSP_CONTENT_DISPOSITION = "disposition";
+const std::string HTTP_RSP_CONTENT_RANGES = "content_ranges";
 
 const int64_t INVALID_END_POS = -1;
+// Most ranges one request may carry, the rest of the list is ignored.
+const size_t MAX_RANGE_COUNT = 16;
 
 int ConvertFileId(const std::string &fileId);
 bool IsLocalFile(const std::string &url);
@@ -46,6 +54,9 @@ bool ParseHttpRequest(const uint8_t *buffer, int length, std::map<std::string, s
 bool ParseStringToInt64(const std::string &str, int64_t &val);
 bool ParseHttpResponse(const uint8_t *buffer, int length, std::map<std::string, std::string> &response,
     size_t &dataOffset);
+// "start-end,start-end", the format of both the range list of a request and the part list of a response.
+bool ParseByteRanges(const std::string &str, std::vector<ByteRange> &ranges);
+std::string FormatByteRanges(const std::vector<ByteRange> &ranges);
 } // namespace CastEngineService
 } // namespace CastEngine
 } // namespace OHOS
@@ -25,10 +25,12 @@
 #include <algorithm>
 #include <mutex>
 #include <cinttypes>
+#include <thread>
 
 #include <securec.h>
 #include <sys/stat.h>
 #include <sys/types.h>
+#include <sys/uio.h>
 #include <unistd.h>
 #include <fcntl.h>
 
@@ -44,6 +46,13 @@ DEFINE_CAST_ENGINE_LABEL("Cast-Localfile-Server");
 
 // DSoftbus, sendByte limit max data 2M at one time. Reserve 1KB for http header
 static const int64_t MAX_READ_LEN = 2 * 1024 * 1024 - 1024;
+// Head and tail kept in memory, where the container headers and indexes usually are.
+static const int64_t PROBE_RANGE_LEN = 64 * 1024;
+// Part of the head sent along with the load action.
+static const int64_t PRELOAD_HEAD_LEN = 16 * 1024;
+// The load action does not wait for a slow probe, the sink then asks for the length itself.
+static const int PRELOAD_WAIT_MS = 100;
+static const int PROBE_WAIT_MS = 5000;
 
 CastLocalFileChannelServer::CastLocalFileChannelServer()
 {
@@ -82,6 +91,7 @@ std::shared_ptr<IChannelListener> CastLocalFileChannelServer::GetChannelListener
 void CastLocalFileChannelServer::AddChannel(std::shared_ptr<Channel> channel)
 {
     CLOGI("in");
+    ClearPendingRequests();
     std::unique_lock<std::mutex> lock(chLock_);
     channel_ = channel;
     CLOGI("out");
@@ -90,6 +100,7 @@ void CastLocalFileChannelServer::AddChannel(std::shared_ptr<Channel> channel)
 void CastLocalFileChannelServer::RemoveChannel(std::shared_ptr<Channel> channel)
 {
     CLOGI("in");
+    ClearPendingRequests();
     std::unique_lock<std::mutex> lock(chLock_);
     channel_ = nullptr;
     CLOGI("out");
@@ -140,23 +151,132 @@ bool CastLocalFileChannelServer::AddLocalFileInfo(MediaInfo &mediaInfo)
         // local fd
         data.fd = ConvertFileId(mediaInfo.mediaUrl);
         data.localFile = "";
-        data.fileLen = GetFileLengthByFd(data.fd);
     } else {
         // local file url
         CLOGE("not support local file url");
         return false;
     }
-    CLOGD("encoded url %s, Local fd: %{public}d, len: %{public}" PRId64, encodedFileId.c_str(), data.fd, data.fileLen);
+    // The probe works on its own fd, the registered one may be closed by a new load while the probe still runs.
+    int probeFd = dup(data.fd);
+    if (probeFd < 0) {
+        CLOGE("dup fd %{public}d fail, errno %{public}s", data.fd, strerror(errno));
+        return false;
+    }
+    data.probe = std::make_shared<FileProbe>();
+    std::thread([probeFd, probe = data.probe] {
+        Utils::SetThreadName("LocalFileProbe");
+        ProbeFile(probeFd, probe);
+        close(probeFd);
+    }).detach();
+    CLOGD("encoded url %s, Local fd: %{public}d", encodedFileId.c_str(), data.fd);
 
     // Add to local map for feature use.
     AddFileInfoToMap(encodedFileId, data);
 
-    // Modify mediaUrl with encoded string and updata mediaSize.
+    // Modify mediaUrl with encoded string, the size is filled in with the load action once probed.
     mediaInfo.mediaUrl = encodedFileId;
-    mediaInfo.mediaSize = static_cast<size_t>(data.fileLen);
+    mediaInfo.mediaSize = 0;
+    return true;
+}
+
+bool CastLocalFileChannelServer::GetPreloadData(const std::string &fileId, bool isLengthRequired,
+    LocalFilePreload &preload)
+{
+    LocalFileInfo data = FindLocalFileInfo(fileId);
+    if (!data.probe) {
+        return false;
+    }
+    preload.isMultiRangeSupported = true;
+    if (!WaitFileProbe(data.probe, PRELOAD_WAIT_MS)) {
+        CLOGW("file %s is still being probed", fileId.c_str());
+        // A sink that cannot ask for the length needs it now, the preload wait was all the probe gets: a length it
+        // has not found yet is read from the fd right away, as the load path did before the probe.
+        if (isLengthRequired) {
+            preload.fileLen = WaitFileLength(data, 0);
+        }
+        return true;
+    }
+    preload.fileLen = data.probe->fileLen;
+    preload.head = data.probe->head.substr(0, PRELOAD_HEAD_LEN);
     return true;
 }
 
+void CastLocalFileChannelServer::ProbeFile(int fd, std::shared_ptr<FileProbe> probe)
+{
+    int64_t fileLen = GetFileLengthByFd(fd);
+    {
+        std::lock_guard<std::mutex> lock(probe->mutex);
+        probe->fileLen = fileLen;
+        probe->isLengthKnown = true;
+        probe->cond.notify_all();
+    }
+    std::string head;
+    std::string tail;
+    int64_t tailStart = 0;
+    if (fileLen > 0) {
+        head.resize(static_cast<size_t>(std::min(fileLen, PROBE_RANGE_LEN)));
+        head.resize(ReadFileDataByFd(fd, 0, static_cast<int>(head.size()), reinterpret_cast<uint8_t *>(head.data())));
+        tailStart = std::max(static_cast<int64_t>(head.size()), fileLen - PROBE_RANGE_LEN);
+        tail.resize(static_cast<size_t>(fileLen - tailStart));
+        tail.resize(ReadFileDataByFd(fd, tailStart, static_cast<int>(tail.size()),
+            reinterpret_cast<uint8_t *>(tail.data())));
+    }
+
+    std::lock_guard<std::mutex> lock(probe->mutex);
+    probe->head = std::move(head);
+    probe->tailStart = tailStart;
+    probe->tail = std::move(tail);
+    probe->isDone = true;
+    probe->cond.notify_all();
+}
+
+bool CastLocalFileChannelServer::WaitFileProbe(const std::shared_ptr<FileProbe> &probe, int timeoutMs)
+{
+    if (!probe) {
+        return false;
+    }
+    std::unique_lock<std::mutex> lock(probe->mutex);
+    return probe->cond.wait_for(lock, std::chrono::milliseconds(timeoutMs), [&probe] { return probe->isDone; });
+}
+
+/*
+ * The probe may be stuck behind a slow provider, the length is then read from the registered fd here, as the load
+ * path did before the probe existed.
+ */
+int64_t CastLocalFileChannelServer::WaitFileLength(const LocalFileInfo &data, int timeoutMs)
+{
+    if (data.probe) {
+        std::unique_lock<std::mutex> lock(data.probe->mutex);
+        if (data.probe->cond.wait_for(lock, std::chrono::milliseconds(timeoutMs),
+            [&data] { return data.probe->isLengthKnown; })) {
+            return data.probe->fileLen;
+        }
+    }
+    CLOGW("probe of fd %{public}d timed out, get the length directly", data.fd);
+    return data.fd == INVALID_VALUE ? 0 : GetFileLengthByFd(data.fd);
+}
+
+bool CastLocalFileChannelServer::ReadProbedData(const std::shared_ptr<FileProbe> &probeHolder, int64_t start,
+    int64_t sendLen, uint8_t *ptr)
+{
+    if (!probeHolder || !WaitFileProbe(probeHolder, 0)) {
+        return false;
+    }
+    const FileProbe &probe = *probeHolder;
+    const std::string *range = nullptr;
+    int64_t rangeStart = 0;
+    int64_t tailEnd = probe.tailStart + static_cast<int64_t>(probe.tail.size());
+    if (start + sendLen <= static_cast<int64_t>(probe.head.size())) {
+        range = &probe.head;
+    } else if (start >= probe.tailStart && start + sendLen <= tailEnd) {
+        range = &probe.tail;
+        rangeStart = probe.tailStart;
+    } else {
+        return false;
+    }
+    return memcpy_s(ptr, sendLen, range->data() + (start - rangeStart), sendLen) == EOK;
+}
+
 void CastLocalFileChannelServer::ClearAllLocalFileInfo()
 {
     CLOGI("in");
@@ -191,16 +311,74 @@ void CastLocalFileChannelServer::ProcessRequestData(const uint8_t *buffer, int l
     }
 
     // Response
-    int64_t start = 0;
-    int64_t end = 0;
-    bool ret = ParseStringToInt64(request[HTTP_REQ_RANGE_START], start);
-    ret = ret && ParseStringToInt64(request[HTTP_REQ_RANGE_END], end);
-    if (!ret || start <= INVALID_END_POS) {
-        CLOGE("Invalid request param, start:%{public}" PRId64 ", end: %{public}" PRId64, start, end);
+    PendingRequest pending;
+    pending.uri = request[HTTP_REQ_URI];
+    auto iter = request.find(HTTP_REQ_RANGES);
+    if (iter != request.end()) {
+        if (!ParseByteRanges(iter->second, pending.ranges)) {
+            CLOGE("Invalid request ranges %{public}s", iter->second.c_str());
+            return;
+        }
+    } else {
+        bool ret = ParseStringToInt64(request[HTTP_REQ_RANGE_START], pending.start);
+        ret = ret && ParseStringToInt64(request[HTTP_REQ_RANGE_END], pending.end);
+        if (!ret || pending.start <= INVALID_END_POS) {
+            CLOGE("Invalid request param, start:%{public}" PRId64 ", end: %{public}" PRId64, pending.start,
+                pending.end);
+            return;
+        }
+    }
+
+    {
+        // Read no more of the file than the channel can take, the request is served once it drained.
+        std::lock_guard<std::mutex> lock(requestLock_);
+        if (isSendBlocked_ || isDraining_) {
+            CLOGD("channel busy, defer request, pending %{public}zu", pendingRequests_.size());
+            pendingRequests_.push_back(std::move(pending));
+            return;
+        }
+    }
+    ResponseRequest(pending);
+}
+
+void CastLocalFileChannelServer::OnSendQueueWatermark(bool isAboveHighWatermark, size_t queuedBytes)
+{
+    CLOGD("above high watermark %{public}d, queued %{public}zu", isAboveHighWatermark, queuedBytes);
+    std::lock_guard<std::mutex> lock(requestLock_);
+    isSendBlocked_ = isAboveHighWatermark;
+    if (isSendBlocked_ || isDraining_ || pendingRequests_.empty()) {
         return;
     }
+    // Called on the sending thread of the channel, which must not wait for the file reads.
+    isDraining_ = true;
+    std::thread([server = shared_from_this()] {
+        Utils::SetThreadName("LocalFileDrain");
+        server->ServePendingRequests();
+    }).detach();
+}
 
-    ResponseFileRequest(request[HTTP_REQ_URI], start, end);
+void CastLocalFileChannelServer::ServePendingRequests()
+{
+    while (true) {
+        PendingRequest request;
+        {
+            std::lock_guard<std::mutex> lock(requestLock_);
+            if (isSendBlocked_ || pendingRequests_.empty()) {
+                isDraining_ = false;
+                return;
+            }
+            request = std::move(pendingRequests_.front());
+            pendingRequests_.pop_front();
+        }
+        ResponseRequest(request);
+    }
+}
+
+void CastLocalFileChannelServer::ClearPendingRequests()
+{
+    std::lock_guard<std::mutex> lock(requestLock_);
+    pendingRequests_.clear();
+    isSendBlocked_ = false;
 }
 
 struct CastLocalFileChannelServer::LocalFileInfo CastLocalFileChannelServer::FindLocalFileInfo(
@@ -246,12 +424,7 @@ int64_t CastLocalFileChannelServer::GetFileLengthByFileName(const std::string &f
 
 int64_t CastLocalFileChannelServer::FindFileLengthByUri(const std::string &encodeUri)
 {
-    std::lock_guard<std::mutex> lock(mapLock_);
-    auto it = fileMap_.find(encodeUri);
-    if (it == fileMap_.end()) {
-        return 0;
-    }
-    return (it->second).fileLen;
+    return WaitFileLength(FindLocalFileInfo(encodeUri), PROBE_WAIT_MS);
 }
 
 void CastLocalFileChannelServer::ResponseFileLengthRequest(const std::string &uri, int64_t fileLen)
@@ -331,7 +504,9 @@ void CastLocalFileChannelServer::ResponseFileDataRequest(const std::string &uri,
 
     LocalFileInfo data = FindLocalFileInfo(uri);
     uint8_t *ptr = buffer.get() + offset;
-    int readLen = ReadFileData(data, start, sendLen, ptr);
+    // Served from the probe only once it is done, a slow probe falls back to reading the fd.
+    int readLen = ReadProbedData(data.probe, start, sendLen, ptr) ? sendLen :
+        ReadFileData(data, start, sendLen, ptr);
     if (readLen > 0) {
         // Send response
         SendData(buffer.get(), sendLen + offset);
@@ -361,6 +536,142 @@ void CastLocalFileChannelServer::ResponseFileRequest(const std::string &uri, int
     }
 }
 
+void CastLocalFileChannelServer::ResponseRequest(const PendingRequest &request)
+{
+    if (request.ranges.empty()) {
+        ResponseFileRequest(request.uri, request.start, request.end);
+    } else {
+        ResponseFileRangesRequest(request.uri, request.ranges);
+    }
+}
+
+void CastLocalFileChannelServer::ResponseFileRangesRequest(const std::string &uri,
+    const std::vector<ByteRange> &ranges)
+{
+    CLOGD("file: %s ranges: %{public}zu", uri.c_str(), ranges.size());
+
+    int64_t fileLen = uri.empty() ? 0 : FindFileLengthByUri(uri);
+    if (fileLen <= 0) {
+        CLOGE("Invalid file: %s, len %{public}" PRId64, uri.c_str(), fileLen);
+        return;
+    }
+
+    // Sorted, clipped to the file and with overlapping parts merged, so every byte is read and sent once.
+    std::vector<ByteRange> sorted = ranges;
+    std::sort(sorted.begin(), sorted.end(),
+        [](const ByteRange &lhs, const ByteRange &rhs) { return lhs.start < rhs.start; });
+    std::vector<ByteRange> parts;
+    int64_t sendLen = 0;
+    for (const auto &range : sorted) {
+        int64_t start = parts.empty() ? range.start : std::max(range.start, parts.back().end);
+        int64_t end = std::min({ range.end, fileLen, start + MAX_READ_LEN - sendLen });
+        if (start >= end) {
+            continue;
+        }
+        if (!parts.empty() && start == parts.back().end) {
+            parts.back().end = end;
+        } else {
+            parts.push_back({ start, end });
+        }
+        sendLen += end - start;
+    }
+    if (parts.empty()) {
+        CLOGE("No valid range in %{public}zu ranges, len %{public}" PRId64, ranges.size(), fileLen);
+        return;
+    }
+
+    // Content-Range spans all the parts for a peer that only reads it, Content-Ranges lists the parts laid out
+    // back to back in the body.
+    std::string rsp("HTTP/1.1 200 OK\r\n"
+        "Accept-Ranges: bytes\r\n"
+        "Content-Length: ");
+    rsp.append(std::to_string(sendLen) + "\r\n");
+    rsp.append("Content-Range: bytes " + std::to_string(parts.front().start) + "-" +
+        std::to_string(parts.back().end) + "/" + std::to_string(fileLen) + "\r\n");
+    rsp.append("Content-Ranges: " + FormatByteRanges(parts) + "\r\n");
+    rsp.append("Content-Disposition: attachment; filename=" + uri + "\r\n\r\n");
+
+    size_t offset = rsp.size();
+    std::unique_ptr<uint8_t[]> buffer = std::make_unique<uint8_t[]>(sendLen + offset);
+    if (memcpy_s(buffer.get(), sendLen + offset, rsp.data(), rsp.size()) != EOK) {
+        CLOGE("memcpy_s fail");
+        return;
+    }
+
+    LocalFileInfo data = FindLocalFileInfo(uri);
+    if (!ReadFileRanges(data, parts, buffer.get() + offset)) {
+        return;
+    }
+    SendData(buffer.get(), static_cast<int>(sendLen + offset));
+    CLOGD("send out parts:%{public}zu len:%{public}" PRId64, parts.size(), sendLen);
+}
+
+bool CastLocalFileChannelServer::ReadFileRanges(const struct LocalFileInfo &data, const std::vector<ByteRange> &parts,
+    uint8_t *ptr)
+{
+    if (data.fd == INVALID_VALUE) {
+        CLOGE("Invalid file info");
+        return false;
+    }
+    size_t first = 0;
+    while (first < parts.size()) {
+        int64_t len = parts[first].end - parts[first].start;
+        if (ReadProbedData(data.probe, parts[first].start, len, ptr)) {
+            ptr += len;
+            first++;
+            continue;
+        }
+        // Parts close to each other are read by one preadv over the span they cover.
+        size_t last = first;
+        int64_t spanLen = len;
+        while (last + 1 < parts.size() && parts[last + 1].start - parts[last].end <= MAX_READ_GAP_LEN) {
+            last++;
+            spanLen += parts[last].end - parts[last].start;
+        }
+        if (!ReadFileSpanByFd(data.fd, &parts[first], last - first + 1, ptr)) {
+            return false;
+        }
+        ptr += spanLen;
+        first = last + 1;
+    }
+    return true;
+}
+
+bool CastLocalFileChannelServer::ReadFileSpanByFd(int fd, const ByteRange *parts, size_t count, uint8_t *buffer)
+{
+    // The gaps between the parts all land in one scratch buffer.
+    static thread_local std::unique_ptr<uint8_t[]> gap = std::make_unique<uint8_t[]>(MAX_READ_GAP_LEN);
+    std::vector<struct iovec> iov;
+    iov.reserve(count * 2);
+    uint8_t *ptr = buffer;
+    for (size_t i = 0; i < count; i++) {
+        if (i > 0 && parts[i].start > parts[i - 1].end) {
+            iov.push_back({ gap.get(), static_cast<size_t>(parts[i].start - parts[i - 1].end) });
+        }
+        size_t len = static_cast<size_t>(parts[i].end - parts[i].start);
+        iov.push_back({ ptr, len });
+        ptr += len;
+    }
+    int64_t total = parts[count - 1].end - parts[0].start;
+
+    ssize_t nread = preadv64(fd, iov.data(), static_cast<int>(iov.size()), parts[0].start);
+    if (nread == total) {
+        return true;
+    }
+    // Short or failed vectored read, finish part by part.
+    CLOGW("preadv %{public}zd of %{public}" PRId64 ", errno = %{public}s", nread, total, strerror(errno));
+    ptr = buffer;
+    for (size_t i = 0; i < count; i++) {
+        int len = static_cast<int>(parts[i].end - parts[i].start);
+        if (ReadFileDataByFd(fd, parts[i].start, len, ptr) != len) {
+            CLOGE("read part %{public}" PRId64 "-%{public}" PRId64 " fail", parts[i].start, parts[i].end);
+            return false;
+        }
+        ptr += len;
+    }
+    return true;
+}
+
 void CastLocalFileChannelServer::SendData(const uint8_t *buffer, int length)
 {
     if (!buffer || length <= 0) {
@@ -381,19 +692,18 @@ void CastLocalFileChannelServer::SendData(const uint8_t *buffer, int length)
 
 int CastLocalFileChannelServer::ReadFileDataByFd(int fd, int64_t start, int sendLen, uint8_t *buffer)
 {
-    // seek to start, read data
-    if (start != lseek64(fd, start, SEEK_SET)) {
-        CLOGE("lseek64 fail, start:%{public}" PRId64 " errno = %{public}s", start, strerror(errno));
-        return 0;
-    }
-
-    int nread = 0;
+    // Positional reads, the probe fd shares its file offset with the registered one.
     int total = 0;
-    nread = read(fd, buffer + total, sendLen - total);
-    while (total < sendLen && nread > 0) {
-        total += nread;
-        nread = read(fd, buffer + total, sendLen - total);
-    };
+    while (total < sendLen) {
+        ssize_t nread = pread64(fd, buffer + total, sendLen - total, start + total);
+        if (nread <= 0) {
+            if (nread < 0) {
+                CLOGE("pread64 fail, start:%{public}" PRId64 " errno = %{public}s", start + total, strerror(errno));
+            }
+            break;
+        }
+        total += static_cast<int>(nread);
+    }
 
     return total;
 }
@@ -17,9 +17,11 @@
  */
 
 #include "local_data_source.h"
+#include <algorithm>
 #include <cinttypes>
 #include <securec.h>
 #include "cast_engine_log.h"
+#include "cast_engine_metrics.h"
 #include "media_errors.h"
 
 namespace OHOS {
@@ -52,6 +54,41 @@ bool LocalDataSource::Stop()
     return true;
 }
 
+void LocalDataSource::Prefetch()
+{
+    CLOGD("in");
+    auto cache = GetBestCache(0);
+    if (!cache) {
+        return;
+    }
+    std::string head;
+    if (channelClient_ && channelClient_->TakePreloadHead(fileId_, head)) {
+        CLOGD("preloaded head %{public}zu", head.size());
+        cache->Write(reinterpret_cast<const uint8_t *>(head.data()), 0, static_cast<int64_t>(head.size()));
+    }
+
+    std::vector<ByteRange> ranges;
+    int64_t start;
+    int64_t end;
+    if (cache->IsNeedReqData(start, end, PREFETCH_HEAD_SIZE) == Cache::NEED_REQ_IN_CURR_CACHE) {
+        ranges.push_back({ start, end });
+    }
+    // Unknown here when the source was slow to probe the file, the tail is then read on demand.
+    int64_t fileLength = fileLength_.load();
+    if (fileLength > PREFETCH_HEAD_SIZE + PREFETCH_TAIL_SIZE) {
+        auto tailCache = GetBestCache(fileLength - PREFETCH_TAIL_SIZE);
+        if (tailCache && tailCache != cache &&
+            tailCache->IsNeedReqData(start, end, PREFETCH_TAIL_SIZE) == Cache::NEED_REQ_IN_CURR_CACHE) {
+            ranges.push_back({ start, std::min(end, fileLength) });
+        }
+    }
+    if (ranges.empty() || !channelClient_) {
+        return;
+    }
+    CLOGD("prefetch %{public}zu ranges, fileLength:%{public}" PRId64, ranges.size(), fileLength);
+    channelClient_->RequestByteRanges(ranges, fileId_);
+}
+
 std::shared_ptr<Cache> LocalDataSource::GetBestCache(int64_t pos)
 {
     std::unique_lock<std::mutex> lock(dataMutex_);
@@ -91,6 +128,11 @@ void LocalDataSource::SolveReqData(std::shared_ptr<Cache> cache, int64_t pos)
     if (isNeedReq == Cache::NO_NEED_REQ) {
         return;
     }
+    // The read ahead stops at the end of the file, the source would only answer a range past it with an error.
+    int64_t fileLength = fileLength_.load();
+    if (fileLength > 0 && start >= fileLength) {
+        return;
+    }
 
     if (isNeedReq == Cache::NEED_REQ_IN_NEXT_CACHE) {
         cache = GetBestCache(start);
@@ -107,6 +149,9 @@ void LocalDataSource::SolveReqData(std::shared_ptr<Cache> cache, int64_t pos)
         return;
     }
 
+    if (fileLength > 0) {
+        end = std::min(end, fileLength);
+    }
     CLOGD("request data, start:%{public}" PRId64 " end:%{public}" PRId64 " pos:%{public}" PRId64, start, end, pos);
     channelClient_->RequestByteData(start, end, fileId_);
 }
@@ -128,10 +173,12 @@ int32_t LocalDataSource::ReadAt(uint32_t length, const std::shared_ptr<Media::AV
 
 int32_t LocalDataSource::ReadBuffer(uint8_t *data, uint32_t length, int64_t pos)
 {
-    CLOGD("ReadBuffer length = %{public}d pos = %{public}" PRId64, length, pos);
+    CLOGV("ReadBuffer length = %{public}u pos = %{public}" PRId64, length, pos);
 
-    if (pos >= fileLength_) {
-        CLOGE("ReadAt EOF, pos:%{public}" PRId64 " fileLength_:%{public}" PRId64, pos, fileLength_);
+    int64_t fileLength = 0;
+    GetSize(fileLength);
+    if (pos >= fileLength) {
+        CLOGE("ReadAt EOF, pos:%{public}" PRId64 " fileLength:%{public}" PRId64, pos, fileLength);
         return Media::SOURCE_ERROR_EOF;
     }
     if (pos < 0) {
@@ -139,6 +186,9 @@ int32_t LocalDataSource::ReadBuffer(uint8_t *data, uint32_t length, int64_t pos)
         return Media::SOURCE_ERROR_IO;
     }
 
+    static auto &readTime = CastEngineMetrics::GetInstance().RegisterHistogram(METRIC_DATA_SOURCE_READ_US);
+    static auto &readBytesTotal = CastEngineMetrics::GetInstance().RegisterCounter(METRIC_DATA_SOURCE_READ_BYTES);
+    MetricScopedTimer timer(readTime);
     auto cache = GetBestCache(pos);
     if (!cache) {
         return Media::SOURCE_ERROR_IO;
@@ -148,25 +198,30 @@ int32_t LocalDataSource::ReadBuffer(uint8_t *data, uint32_t length, int64_t pos)
     int32_t readBytes = static_cast<int32_t>(cache->Read(data, length, pos));
     // cache data may be not enoungh after reading, req data in advance for next reading
     SolveReqData(cache, pos);
+    if (readBytes > 0) {
+        readBytesTotal.Add(readBytes);
+    }
     return readBytes;
 }
 
 int32_t LocalDataSource::GetSize(int64_t &size)
 {
-    if (fileLength_ > 0) {
-        size = fileLength_;
+    size = fileLength_.load();
+    if (size > 0) {
         return 0; //  MSERR_OK 值为0
     }
     // requestLength
-    fileLength_ = channelClient_->RequestFileLength(fileId_);
-    size = fileLength_;
+    if (channelClient_) {
+        size = channelClient_->RequestFileLength(fileId_);
+        fileLength_ = size;
+    }
     return 0; // MSERR_OK 值为0
 }
 
 bool LocalDataSource::OnBytesReceived(const std::string &fileId, const uint8_t *bytes, int64_t offset, int64_t length)
 {
     if (fileId.compare(fileId_) != 0) {
-        CLOGE("fileId:%{public}s is not match fileId_:%{public}s", fileId.c_str(), fileId_.c_str());
+        CLOGD("fileId:%{public}s is not match fileId_:%{public}s", fileId.c_str(), fileId_.c_str());
         return false;
     }
     std::unique_lock<std::mutex> lock(dataMutex_);
@@ -225,7 +280,7 @@ bool Cache::IsValid()
     return (buffer_ != nullptr);
 }
 
-int Cache::IsNeedReqData(int64_t &start, int64_t &end)
+int Cache::IsNeedReqData(int64_t &start, int64_t &end, int64_t maxLength)
 {
     std::unique_lock<std::mutex> lock(dataMutex_);
     int64_t cachedBytes = endPos_ - startPos_;
@@ -243,6 +298,7 @@ int Cache::IsNeedReqData(int64_t &start, int64_t &end)
     if (startPos_ == endPos_) {
         length = FIRST_REQUEST_SIZE;
     }
+    length = std::min(length, maxLength);
     start = endPos_;
     end = endPos_ + length;
     nextEndPos_ = end;
@@ -0,0 +1,76 @@
+/*
+ * Copyright (C) 2023-2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * Description: decoded artwork cache shared by all the stream players of the service.
+ * Author: zhangge
+ * Create: 2023-06-05
+ */
+
+#ifndef ARTWORK_CACHE_H
+#define ARTWORK_CACHE_H
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "pixel_map.h"
+
+namespace OHOS {
+namespace CastEngine {
+namespace CastEngineService {
+/*
+ * Decoded artwork keyed by the hash of its encoded bytes, so that tracks of the same album share one PixelMap.
+ * An entry keeps the encoded bytes as well, a hit is only taken when they match and a hash collision is a miss.
+ * The least recently used entries are evicted once the kept bytes exceed MAX_CACHE_BYTES, and the whole cache is
+ * dropped when the last stream session that uses it ends.
+ */
+class ArtworkCache {
+public:
+    static ArtworkCache &GetInstance();
+
+    static uint64_t HashContent(const uint8_t *data, size_t size);
+    std::shared_ptr<Media::PixelMap> Get(uint64_t key, const uint8_t *data, size_t size);
+    void Put(uint64_t key, const uint8_t *data, size_t size, std::shared_ptr<Media::PixelMap> pixelMap);
+    void Clear();
+    void AddSession();
+    void RemoveSession();
+
+private:
+    ArtworkCache() = default;
+    ~ArtworkCache() = default;
+
+    struct Entry {
+        uint64_t key;
+        std::vector<uint8_t> content;
+        std::shared_ptr<Media::PixelMap> pixelMap;
+        int64_t bytes;
+    };
+
+    void EvictLocked();
+    void ClearLocked();
+
+    static constexpr int64_t MAX_CACHE_BYTES = 32 * 1024 * 1024; // 32MB
+
+    std::mutex mutex_;
+    std::list<Entry> lruList_;
+    std::unordered_map<uint64_t, std::list<Entry>::iterator> entries_;
+    int64_t totalBytes_{ 0 };
+    int sessionCount_{ 0 };
+};
+} // namespace CastEngineService
+} // namespace CastEngine
+} // namespace OHOS
+#endif // ARTWORK_CACHE_H
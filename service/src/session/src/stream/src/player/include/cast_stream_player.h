@@ -19,6 +19,8 @@
 #ifndef CAST_STREAM_PLAYER_H
 #define CAST_STREAM_PLAYER_H
 
+#include <atomic>
+#include <functional>
 #include <map>
 #include <mutex>
 #include <condition_variable>
@@ -73,6 +75,14 @@ public:
     void OnPlayRequest(const MediaInfo &mediaInfo);
     void OnImageChanged(std::shared_ptr<Media::PixelMap> pixelMap);
     void OnAlbumCoverChanged(std::shared_ptr<Media::PixelMap> pixelMap);
+    // An inactive callback belongs to the standby player that prepares the next item, it only tracks the player state
+    // and keeps the album cover or the image until the item becomes the current one.
+    void SetActive(bool isActive);
+    bool IsActive() const;
+    void SetEndOfStreamCallback(const std::function<void(void)> &callback);
+    // The image of an IMAGE item is decoded on its own thread, a failure of the current item is a player error.
+    void SetImageDecodedCallback(const std::function<void(bool)> &callback);
+    void OnImageDecoded(bool isDecoded);
 
 private:
     void OnStateChanged(const PlayerStates playbackState, bool isPlayWhenReady);
@@ -101,6 +111,11 @@ private:
     int endPosition_ = CAST_STREAM_INT_INIT;
     Media::PlaybackRateMode speedMode_ = Media::SPEED_FORWARD_1_00_X;
     std::atomic<bool> isRequestingResource_{ false };
+    std::atomic<bool> isActive_{ true };
+    std::function<void(void)> endOfStreamCallback_;
+    std::function<void(bool)> imageDecodedCallback_;
+    std::shared_ptr<Media::PixelMap> pendingAlbumCover_;
+    std::shared_ptr<Media::PixelMap> pendingImage_;
 };
 
 class CastStreamVolumeCallback : public AudioStandard::VolumeKeyEventCallback,
@@ -110,6 +125,7 @@ public:
     ~CastStreamVolumeCallback() override;
 
     void SetMaxVolume(int maxVolume);
+    void SetCallback(std::shared_ptr<CastStreamPlayerCallback> callback);
     void OnVolumeKeyEvent(AudioStandard::VolumeEvent volumeEvent) override;
 
 private:
@@ -118,12 +134,19 @@ private:
     int maxVolume_ = 0;
 };
 
-class CastStreamPlayer {
+class CastStreamPlayer : public std::enable_shared_from_this<CastStreamPlayer> {
 public:
-    explicit CastStreamPlayer(std::shared_ptr<CastStreamPlayerCallback> callback,
-        std::shared_ptr<CastLocalFileChannelClient> fileChannel);
+    /*
+     * The volume key callback is registered per process, so only the player that owns it registers it, the standby
+     * player of the manager is created without it and takes it over with AttachVolumeCallback when switched to.
+     */
+    CastStreamPlayer(std::shared_ptr<CastStreamPlayerCallback> callback,
+        std::shared_ptr<CastLocalFileChannelClient> fileChannel, bool isVolumeKeyOwner = true);
     ~CastStreamPlayer();
 
+    std::shared_ptr<CastStreamVolumeCallback> DetachVolumeCallback();
+    void AttachVolumeCallback(std::shared_ptr<CastStreamVolumeCallback> volumeCallback);
+
     bool RegisterListener(sptr<IStreamPlayerListenerImpl> listener);
     bool UnregisterListener();
     bool SetSource(const MediaInfo &mediaInfo);
@@ -162,6 +185,8 @@ private:
     bool Release();
     bool SendInitSysVolume();
     bool GetImageResource();
+    std::unique_ptr<Media::PixelMap> DecodeImage(std::shared_ptr<LocalDataSource> dataSource, uint32_t generation);
+    static Media::Size GetImageDecodeSize(const Media::Size &imageSize);
     bool InvokeImageChanged(std::shared_ptr<Media::PixelMap> sharedImg);
     bool ProcessAlbumCover(std::shared_ptr<Media::AVSharedMemory> albumCoverMem);
     std::mutex mutex_;
@@ -173,6 +198,13 @@ private:
     std::shared_ptr<CastLocalFileChannelClient> fileChannelClient_;
     AudioStandard::AudioSystemManager *audioSystemMgr_ = nullptr;
     LoopMode loopMode_ = LoopMode::LOOP_MODE_LIST;
+    // Bumped by every new source, so that an image decoded for an older one is dropped.
+    std::atomic<uint32_t> imageGeneration_{ 0 };
+
+    static constexpr uint32_t IMAGE_READ_CHUNK_SIZE = 256 * 1024;
+    // Between two reads that found no data, a read past the requested range returns at once.
+    static constexpr int IMAGE_READ_RETRY_INTERVAL_MS = 50;
+    static constexpr int32_t IMAGE_MAX_DECODE_EDGE = 3840;
 };
 } // namespace CastEngineService
 } // namespace CastEngine
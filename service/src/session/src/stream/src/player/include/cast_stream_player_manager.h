@@ -19,6 +19,8 @@
 #ifndef CAST_STREAM_PLAYER_MANAGER_H
 #define CAST_STREAM_PLAYER_MANAGER_H
 
+#include <chrono>
+
 #include "cast_stream_player.h"
 #include "i_stream_player_impl.h"
 #include "i_stream_player_listener_impl.h"
@@ -40,8 +42,10 @@ public:
     int32_t UnregisterListener() override;
     int32_t SetSurface(sptr<IBufferProducer> producer) override;
     int32_t Load(const MediaInfo &mediaInfo) override;
+    int32_t Load(const MediaInfoHolder &mediaInfoHolder);
     int32_t Play(const MediaInfo &mediaInfo) override;
     int32_t InnerPlay(const MediaInfo &mediaInfo);
+    int32_t InnerPlay(const MediaInfoHolder &mediaInfoHolder);
     int32_t Play(int index) override;
     int32_t Play() override;
     int32_t Pause() override;
@@ -70,17 +74,60 @@ public:
     int32_t Release() override;
 
 private:
+    static constexpr int INVALID_INDEX = -1;
+
+    std::shared_ptr<CastStreamPlayer> PlayerGetter();
+    std::shared_ptr<CastStreamPlayerCallback> CallbackGetter();
     bool InnerPlayLocked(bool isLoading);
     bool StopLocked();
+    bool SetMediaInfoHolderLocked(const MediaInfoHolder &mediaInfoHolder, MediaInfo &currentMediaInfo);
+    bool IsAutoAdvancedItemLocked(const MediaInfo &mediaInfo);
+    bool IsSameListLocked(const MediaInfoHolder &mediaInfoHolder);
+    int GetNextIndexLocked();
+    bool CreateStandbyLocked();
+    static bool IsPreloadable(const MediaInfo &mediaInfo);
+    void PreloadNextLocked();
+    void PrepareStandby(uint32_t generation, int index, const MediaInfo &mediaInfo);
+    void SetStandbyReady(uint32_t generation, int index, bool isReady);
+    void InvalidateStandbyLocked();
+    void ReleaseStandbyLocked();
+    bool SwitchToStandbyLocked(int index);
+    void OnEndOfStream();
+    void RecordTrackGapLocked();
     PlaybackSpeed ConvertMediaSpeedToPlaybackSpeed(Media::PlaybackRateMode speedMode);
     bool MockPlayerError(int32_t action);
     std::function<void(void)> sessionCallback_;
 
     std::mutex mutex_;
     std::mutex sessionCallbackMutex_;
+    // Guards the swap of player_ and callback_, which only happens with mutex_ held as well.
+    std::mutex playerMutex_;
     std::shared_ptr<CastStreamPlayer> player_;
     std::shared_ptr<CastStreamPlayerCallback> callback_;
+    std::weak_ptr<ICastStreamManagerServer> streamManager_;
+    std::shared_ptr<CastLocalFileChannelClient> fileChannel_;
+    sptr<IStreamPlayerListenerImpl> listener_;
     MediaInfo mediaInfo_{};
+    MediaInfoHolder mediaInfoHolder_{};
+
+    /*
+     * The standby player prepares the item after the current one of the playlist, so that the end of stream switches
+     * to it without a Load round trip to the source. It is prepared on the handler thread of the stream manager, as is
+     * the switch at the end of stream, and standbyGeneration_ discards a preparation that finishes after the playlist
+     * or the current item changed.
+     * It is a second Media::Player of the session, so it only exists while the next item is an audio or image one,
+     * and it never registers the volume key callback, which follows the active player instead.
+     */
+    std::mutex standbyMutex_;
+    std::mutex preloadMutex_;
+    std::shared_ptr<CastStreamPlayer> standbyPlayer_;
+    std::shared_ptr<CastStreamPlayerCallback> standbyCallback_;
+    uint32_t standbyGeneration_{ 0 };
+    int standbyIndex_{ INVALID_INDEX };
+    bool isStandbyReady_{ false };
+    bool isAutoAdvanced_{ false };
+    bool isWaitingNextItem_{ false };
+    std::chrono::steady_clock::time_point endOfStreamTime_;
     std::atomic<bool> isReceiveLoadCommand_{ false };
     std::atomic<bool> isReceivePlayCommand_{ false };
     std::atomic<bool> isReady_{ false };
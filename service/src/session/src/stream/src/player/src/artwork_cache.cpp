@@ -0,0 +1,133 @@
+/*
+ * Copyright (C) 2023-2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * Description: decoded artwork cache shared by all the stream players of the service.
+ * Author: zhangge
+ * Create: 2023-06-05
+ */
+
+#include "artwork_cache.h"
+
+#include <cstring>
+#include <functional>
+#include <string_view>
+
+#include "cast_engine_log.h"
+#include "cast_engine_metrics.h"
+
+namespace OHOS {
+namespace CastEngine {
+namespace CastEngineService {
+DEFINE_CAST_ENGINE_LABEL("Cast-Artwork-Cache");
+
+ArtworkCache &ArtworkCache::GetInstance()
+{
+    static ArtworkCache instance{};
+    return instance;
+}
+
+uint64_t ArtworkCache::HashContent(const uint8_t *data, size_t size)
+{
+    uint64_t hash = std::hash<std::string_view>{}(std::string_view(reinterpret_cast<const char *>(data), size));
+    // Mix in the size, two different artworks are far less likely to collide on both.
+    return hash ^ (static_cast<uint64_t>(size) * 0x9E3779B97F4A7C15ULL);
+}
+
+std::shared_ptr<Media::PixelMap> ArtworkCache::Get(uint64_t key, const uint8_t *data, size_t size)
+{
+    static auto &hits = CastEngineMetrics::GetInstance().RegisterCounter(METRIC_ARTWORK_CACHE_HITS);
+    static auto &misses = CastEngineMetrics::GetInstance().RegisterCounter(METRIC_ARTWORK_CACHE_MISSES);
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto iter = entries_.find(key);
+    if (iter == entries_.end()) {
+        misses.Add();
+        return nullptr;
+    }
+    const auto &content = iter->second->content;
+    if (content.size() != size || (size > 0 && std::memcmp(content.data(), data, size) != 0)) {
+        CLOGW("Artwork hash collision, %{public}zu and %{public}zu bytes", content.size(), size);
+        misses.Add();
+        return nullptr;
+    }
+    hits.Add();
+    lruList_.splice(lruList_.begin(), lruList_, iter->second);
+    return iter->second->pixelMap;
+}
+
+void ArtworkCache::Put(uint64_t key, const uint8_t *data, size_t size, std::shared_ptr<Media::PixelMap> pixelMap)
+{
+    if (!pixelMap || !data) {
+        return;
+    }
+    int64_t bytes = pixelMap->GetByteCount() + static_cast<int64_t>(size);
+    if (pixelMap->GetByteCount() <= 0 || bytes > MAX_CACHE_BYTES) {
+        CLOGW("Not cache artwork of %{public}lld bytes", static_cast<long long>(bytes));
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto iter = entries_.find(key);
+    if (iter != entries_.end()) {
+        totalBytes_ -= iter->second->bytes;
+        lruList_.erase(iter->second);
+        entries_.erase(iter);
+    }
+    lruList_.push_front(Entry{ key, std::vector<uint8_t>(data, data + size), std::move(pixelMap), bytes });
+    entries_[key] = lruList_.begin();
+    totalBytes_ += bytes;
+    EvictLocked();
+}
+
+void ArtworkCache::Clear()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    ClearLocked();
+}
+
+void ArtworkCache::AddSession()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    sessionCount_++;
+}
+
+void ArtworkCache::RemoveSession()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (sessionCount_ > 0 && --sessionCount_ == 0) {
+        CLOGI("Last session ended, drop %{public}zu artworks", entries_.size());
+        ClearLocked();
+    }
+}
+
+void ArtworkCache::ClearLocked()
+{
+    static auto &cacheBytes = CastEngineMetrics::GetInstance().RegisterGauge(METRIC_ARTWORK_CACHE_BYTES);
+    lruList_.clear();
+    entries_.clear();
+    totalBytes_ = 0;
+    cacheBytes.Set(0);
+}
+
+void ArtworkCache::EvictLocked()
+{
+    static auto &cacheBytes = CastEngineMetrics::GetInstance().RegisterGauge(METRIC_ARTWORK_CACHE_BYTES);
+    while (totalBytes_ > MAX_CACHE_BYTES && !lruList_.empty()) {
+        const auto &entry = lruList_.back();
+        totalBytes_ -= entry.bytes;
+        entries_.erase(entry.key);
+        lruList_.pop_back();
+    }
+    cacheBytes.Set(totalBytes_);
+}
+} // namespace CastEngineService
+} // namespace CastEngine
+} // namespace OHOS
@@ -16,11 +16,16 @@
  * Create: 2023-1-11
  */
 
+#include <algorithm>
 #include <chrono>
+#include <cinttypes>
+#include <thread>
 #include <unistd.h>
 #include "image_source.h"
+#include "artwork_cache.h"
 #include "cast_engine_dfx.h"
 #include "cast_engine_log.h"
+#include "cast_engine_metrics.h"
 #include "cast_stream_player.h"
 #include "cast_stream_player_utils.h"
 
@@ -139,6 +144,61 @@ bool CastStreamPlayerCallback::GetSwitching()
     return switchingCount_;
 }
 
+void CastStreamPlayerCallback::SetActive(bool isActive)
+{
+    CLOGD("SetActive in, isActive:%{public}d", isActive);
+    isActive_ = isActive;
+    std::shared_ptr<Media::PixelMap> albumCover;
+    std::shared_ptr<Media::PixelMap> image;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        albumCover = std::move(pendingAlbumCover_);
+        image = std::move(pendingImage_);
+    }
+    if (!isActive) {
+        return;
+    }
+    if (albumCover) {
+        OnAlbumCoverChanged(albumCover);
+    }
+    if (image) {
+        OnImageChanged(image);
+    }
+}
+
+bool CastStreamPlayerCallback::IsActive() const
+{
+    return isActive_;
+}
+
+void CastStreamPlayerCallback::SetEndOfStreamCallback(const std::function<void(void)> &callback)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    endOfStreamCallback_ = callback;
+}
+
+void CastStreamPlayerCallback::SetImageDecodedCallback(const std::function<void(bool)> &callback)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    imageDecodedCallback_ = callback;
+}
+
+void CastStreamPlayerCallback::OnImageDecoded(bool isDecoded)
+{
+    std::function<void(bool)> imageDecodedCallback;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        imageDecodedCallback = imageDecodedCallback_;
+    }
+    if (imageDecodedCallback) {
+        imageDecodedCallback(isDecoded);
+    }
+    // The standby player only reports through the callback, its item falls back to a load from the source.
+    if (!isDecoded && isActive_) {
+        OnPlayerError(ERR_CODE_PLAY_FAILED, PLAYER_ERROR);
+    }
+}
+
 bool CastStreamPlayerCallback::IsPaused()
 {
     std::lock_guard<std::mutex> lock(mutex_);
@@ -220,6 +280,12 @@ sptr<IStreamPlayerListenerImpl> CastStreamPlayerCallback::ListenerGetter()
 void CastStreamPlayerCallback::OnInfo(Media::PlayerOnInfoType type, int32_t extra, const Media::Format &infoBody)
 {
     CLOGI("OnInfo in, playerOnInfoType = %{public}d, extra = %{public}d", static_cast<int32_t>(type), extra);
+    if (!isActive_) {
+        if (type == Media::INFO_TYPE_STATE_CHANGE) {
+            SetState(static_cast<PlayerStates>(extra));
+        }
+        return;
+    }
     switch (type) {
         case Media::INFO_TYPE_SEEKDONE: {
             OnSeekDone(extra);
@@ -269,6 +335,10 @@ void CastStreamPlayerCallback::OnInfo(Media::PlayerOnInfoType type, int32_t extr
 void CastStreamPlayerCallback::OnError(int32_t errorCode, const std::string &errorMsg)
 {
     CLOGE("Player OnError message %{public}s", errorMsg.c_str());
+    if (!isActive_) {
+        SetState(PlayerStates::PLAYER_STATE_ERROR);
+        return;
+    }
     OnPlayerError(errorCode, errorMsg);
 }
 
@@ -458,6 +528,11 @@ void CastStreamPlayerCallback::OnRenderReady(bool isReady)
 void CastStreamPlayerCallback::OnImageChanged(std::shared_ptr<Media::PixelMap> pixelMap)
 {
     CLOGD("OnImageChanged in");
+    if (!isActive_) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        pendingImage_ = pixelMap;
+        return;
+    }
     auto listener = ListenerGetter();
     if (!listener) {
         CLOGE("StreamPlayerListener is null");
@@ -489,6 +564,9 @@ void CastStreamPlayerCallback::OnPlayerError(int errorCode, const std::string &e
 void CastStreamPlayerCallback::OnLoopModeChanged(const LoopMode loopMode)
 {
     CLOGD("OnLoopModeChanged in");
+    if (!isActive_) {
+        return;
+    }
     auto listener = ListenerGetter();
     if (!listener) {
         CLOGE("StreamPlayerListener is null");
@@ -536,6 +614,11 @@ void CastStreamPlayerCallback::OnAlbumCoverChanged(std::shared_ptr<Media::PixelM
         CLOGE("pixelMap is null");
         return;
     }
+    if (!isActive_) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        pendingAlbumCover_ = pixelMap;
+        return;
+    }
     auto listener = ListenerGetter();
     if (!listener) {
         CLOGE("StreamPlayerListener is null");
@@ -611,6 +694,14 @@ void CastStreamPlayerCallback::OnSeekDone(int position)
 void CastStreamPlayerCallback::OnEndOfStream(int isLooping)
 {
     CLOGD("OnEndOfStream in");
+    std::function<void(void)> endOfStreamCallback;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        endOfStreamCallback = endOfStreamCallback_;
+    }
+    if (!isLooping && endOfStreamCallback) {
+        endOfStreamCallback();
+    }
     auto listener = ListenerGetter();
     if (!listener) {
         CLOGE("StreamPlayerListener is null");
@@ -669,7 +760,7 @@ bool CastStreamPlayerCallback::AutoSyncPosition()
 }
 
 CastStreamPlayer::CastStreamPlayer(std::shared_ptr<CastStreamPlayerCallback> callback,
-    std::shared_ptr<CastLocalFileChannelClient> fileChannel)
+    std::shared_ptr<CastLocalFileChannelClient> fileChannel, bool isVolumeKeyOwner)
 {
     CLOGD("CastStreamPlayer in");
     player_ = Media::PlayerFactory::CreatePlayer();
@@ -684,22 +775,25 @@ CastStreamPlayer::CastStreamPlayer(std::shared_ptr<CastStreamPlayerCallback> cal
         Release();
         return;
     }
-    // In current audioStandard structure, all type will be converted into STREAM_MUSIC.
-    auto streamType = AudioStandard::AudioVolumeType::STREAM_MUSIC;
-    castStreamVolumeCallback_ = std::make_shared<CastStreamVolumeCallback>(callback);
-    if (castStreamVolumeCallback_ == nullptr) {
-        CLOGE("Volume callback is null");
-        Release();
-        return;
-    }
-    castStreamVolumeCallback_->SetMaxVolume(audioSystemMgr_->GetMaxVolume(streamType));
-    int32_t audioSystemRet = audioSystemMgr_->RegisterVolumeKeyEventCallback(getpid(), castStreamVolumeCallback_);
-    if (audioSystemRet != MSERR_OK) {
-        CLOGE("Register volume callback failed");
-        Release();
-        return;
+    if (isVolumeKeyOwner) {
+        // In current audioStandard structure, all type will be converted into STREAM_MUSIC.
+        auto streamType = AudioStandard::AudioVolumeType::STREAM_MUSIC;
+        castStreamVolumeCallback_ = std::make_shared<CastStreamVolumeCallback>(callback);
+        if (castStreamVolumeCallback_ == nullptr) {
+            CLOGE("Volume callback is null");
+            Release();
+            return;
+        }
+        castStreamVolumeCallback_->SetMaxVolume(audioSystemMgr_->GetMaxVolume(streamType));
+        int32_t audioSystemRet = audioSystemMgr_->RegisterVolumeKeyEventCallback(getpid(), castStreamVolumeCallback_);
+        if (audioSystemRet != MSERR_OK) {
+            CLOGE("Register volume callback failed");
+            castStreamVolumeCallback_ = nullptr;
+            Release();
+            return;
+        }
+        SendInitSysVolume();
     }
-    SendInitSysVolume();
     callback_ = callback;
     if (callback_ == nullptr) {
         CLOGE("CreatePlayerCallback failed");
@@ -726,6 +820,24 @@ CastStreamPlayer::~CastStreamPlayer()
     Release();
 }
 
+std::shared_ptr<CastStreamVolumeCallback> CastStreamPlayer::DetachVolumeCallback()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto volumeCallback = castStreamVolumeCallback_;
+    castStreamVolumeCallback_ = nullptr;
+    return volumeCallback;
+}
+
+void CastStreamPlayer::AttachVolumeCallback(std::shared_ptr<CastStreamVolumeCallback> volumeCallback)
+{
+    if (!volumeCallback) {
+        return;
+    }
+    volumeCallback->SetCallback(callback_);
+    std::lock_guard<std::mutex> lock(mutex_);
+    castStreamVolumeCallback_ = volumeCallback;
+}
+
 bool CastStreamPlayer::RegisterListener(sptr<IStreamPlayerListenerImpl> listener)
 {
     CLOGD("RegisterListener in");
@@ -765,6 +877,7 @@ bool CastStreamPlayer::SetSource(const MediaInfo &mediaInfo)
         CLOGE("Media player is null");
         return false;
     }
+    imageGeneration_++;
     if (dataSource_) {
         dataSource_->Stop();
         dataSource_ = nullptr;
@@ -782,13 +895,10 @@ bool CastStreamPlayer::SetSource(const MediaInfo &mediaInfo)
         dataSource_ = std::make_shared<LocalDataSource>(mediaInfo.mediaUrl, mediaInfo.mediaSize, fileChannelClient_);
         dataSource_->Start();
         fileChannelClient_->WaitCreateChannel();
+        dataSource_->Prefetch();
         if (mediaInfo.mediaType == "IMAGE") {
             CLOGI("Start to get image resource");
-            if (!GetImageResource()) {
-                return false;
-            }
-            CLOGI("Get image resource successfully");
-            return true;
+            return GetImageResource();
         } else if (mediaInfo.mediaType == "AUDIO" && avMetadataHelper_) {
             CLOGD("Start to get album cover");
             avMetadataHelper_->SetSource(dataSource_);
@@ -831,49 +941,110 @@ bool CastStreamPlayer::SetPlayRangeWithMode(int32_t start)
 
 bool CastStreamPlayer::GetImageResource()
 {
-    int64_t imageSize;
     if (!dataSource_) {
         return false;
     }
-    dataSource_->GetSize(imageSize);
-    std::unique_ptr<uint8_t[]> buffer = std::make_unique<uint8_t[]>(imageSize);
-    if (!buffer) {
-        return false;
+    static auto &firstPixelTime = CastEngineMetrics::GetInstance().RegisterHistogram(METRIC_STREAM_IMAGE_FIRST_PIXEL_US);
+    uint32_t generation = imageGeneration_;
+    auto dataSource = dataSource_;
+    std::weak_ptr<CastStreamPlayer> weakPlayer = weak_from_this();
+    // Decode off the caller, which holds the player manager lock, and let a newer source cancel it.
+    std::thread([weakPlayer, dataSource, generation]() {
+        auto player = weakPlayer.lock();
+        if (!player) {
+            return;
+        }
+        MetricScopedTimer timer(firstPixelTime);
+        auto pixelMap = player->DecodeImage(dataSource, generation);
+        // A newer source owns the result, including the failure of an image that was cancelled for it.
+        if (generation != player->imageGeneration_) {
+            return;
+        }
+        auto callback = player->callback_;
+        if (!callback) {
+            CLOGE("callback_ is null");
+            return;
+        }
+        if (!pixelMap) {
+            CLOGE("Get image resource failed");
+            callback->OnImageDecoded(false);
+            return;
+        }
+        player->InvokeImageChanged(std::move(pixelMap));
+        callback->OnImageDecoded(true);
+        CLOGI("Get image resource successfully");
+    }).detach();
+    return true;
+}
+
+std::unique_ptr<Media::PixelMap> CastStreamPlayer::DecodeImage(std::shared_ptr<LocalDataSource> dataSource,
+    uint32_t generation)
+{
+    int64_t imageSize = 0;
+    dataSource->GetSize(imageSize);
+    if (imageSize <= 0) {
+        CLOGE("invalid image size %{public}" PRId64, imageSize);
+        return nullptr;
     }
-    uint8_t *currDstPos = buffer.get();
-    int32_t sumReadBytes = CAST_STREAM_INT_INIT;
-    int32_t readSize = imageSize;
+    Media::IncrementalSourceOptions options;
+    uint32_t errCode = 0;
+    std::unique_ptr<Media::ImageSource> imageSource = Media::ImageSource::CreateIncrementalImageSource(options, errCode);
+    if (imageSource == nullptr) {
+        CLOGE("imageSource is null, errCode = %{public}d", errCode);
+        return nullptr;
+    }
+
+    // Feed the image source chunk by chunk as the bytes arrive. ReadBuffer waits a while for data already requested,
+    // but returns at once when the request is still to be sent, so a failed read backs off before the next try.
+    auto chunk = std::make_unique<uint8_t[]>(IMAGE_READ_CHUNK_SIZE);
+    int64_t sumReadBytes = CAST_STREAM_INT_INIT;
     int32_t tryTimes = CAST_STREAM_INT_INIT;
     while (tryTimes < CAST_STREAM_MAX_TIMES && sumReadBytes < imageSize) {
-        int32_t curReadBytes = dataSource_->ReadBuffer(currDstPos, readSize, sumReadBytes);
-        currDstPos += curReadBytes;
-        sumReadBytes += curReadBytes;
-        readSize -= curReadBytes;
+        if (generation != imageGeneration_) {
+            CLOGI("image source changed, stop decoding");
+            return nullptr;
+        }
+        uint32_t readSize = static_cast<uint32_t>(std::min<int64_t>(IMAGE_READ_CHUNK_SIZE, imageSize - sumReadBytes));
+        int32_t curReadBytes = dataSource->ReadBuffer(chunk.get(), readSize, sumReadBytes);
         if (curReadBytes <= 0) {
             tryTimes++;
-            std::this_thread::sleep_for(std::chrono::milliseconds(CAST_STREAM_WAIT_TIME));
+            std::this_thread::sleep_for(std::chrono::milliseconds(IMAGE_READ_RETRY_INTERVAL_MS));
+            continue;
         }
+        sumReadBytes += curReadBytes;
+        imageSource->UpdateData(chunk.get(), static_cast<uint32_t>(curReadBytes), sumReadBytes == imageSize);
     }
     if (sumReadBytes != imageSize) {
         CLOGE("read image bytes failed");
-        return false;
+        return nullptr;
     }
 
-    Media::SourceOptions options;
-    uint32_t errCode;
-    std::unique_ptr<Media::ImageSource> imageSource
-        = Media::ImageSource::CreateImageSource(buffer.get(), imageSize, options, errCode);
-    if (imageSource == nullptr) {
-        CLOGE("imageSource is null, errCode = %{public}d", errCode);
-        return false;
-    }
     Media::DecodeOptions decodeParam;
+    Media::ImageInfo imageInfo;
+    if (imageSource->GetImageInfo(0, imageInfo) == 0) {
+        decodeParam.desiredSize = GetImageDecodeSize(imageInfo.size);
+    }
     auto pixelMap = imageSource->CreatePixelMap(0, decodeParam, errCode);
     if (pixelMap == nullptr || errCode != 0) {
         CLOGE("pixelMap is null, errCode = %{public}d", errCode);
-        return false;
+        return nullptr;
     }
-    return InvokeImageChanged(std::move(pixelMap));
+    return pixelMap;
+}
+
+// Keeps the aspect ratio and bounds the longer edge, a photo is never shown larger than a 4K screen.
+Media::Size CastStreamPlayer::GetImageDecodeSize(const Media::Size &imageSize)
+{
+    int32_t longEdge = std::max(imageSize.width, imageSize.height);
+    if (longEdge <= IMAGE_MAX_DECODE_EDGE) {
+        return imageSize;
+    }
+    Media::Size decodeSize;
+    decodeSize.width = static_cast<int32_t>(static_cast<int64_t>(imageSize.width) * IMAGE_MAX_DECODE_EDGE / longEdge);
+    decodeSize.height = static_cast<int32_t>(static_cast<int64_t>(imageSize.height) * IMAGE_MAX_DECODE_EDGE / longEdge);
+    CLOGI("decode %{public}dx%{public}d image at %{public}dx%{public}d", imageSize.width, imageSize.height,
+        decodeSize.width, decodeSize.height);
+    return decodeSize;
 }
 
 bool CastStreamPlayer::InvokeImageChanged(std::shared_ptr<Media::PixelMap> sharedImg)
@@ -893,6 +1064,19 @@ bool CastStreamPlayer::ProcessAlbumCover(std::shared_ptr<Media::AVSharedMemory>
         return false;
     }
     CLOGI("Get album cover successfully, album size: %d", albumCoverMem->GetSize());
+    const uint8_t *albumCoverData = albumCoverMem->GetBase();
+    size_t albumCoverSize = static_cast<size_t>(albumCoverMem->GetSize());
+    uint64_t artworkKey = ArtworkCache::HashContent(albumCoverData, albumCoverSize);
+    std::shared_ptr<Media::PixelMap> cachedAlbumCover =
+        ArtworkCache::GetInstance().Get(artworkKey, albumCoverData, albumCoverSize);
+    if (cachedAlbumCover) {
+        if (!callback_) {
+            CLOGE("callback_ is null");
+            return false;
+        }
+        callback_->OnAlbumCoverChanged(cachedAlbumCover);
+        return true;
+    }
     Media::SourceOptions options;
     uint32_t errCode;
     std::unique_ptr<Media::ImageSource> imageSource
@@ -908,6 +1092,7 @@ bool CastStreamPlayer::ProcessAlbumCover(std::shared_ptr<Media::AVSharedMemory>
         return false;
     }
     std::shared_ptr<Media::PixelMap> sharedAlbumCover = std::move(pixelMap);
+    ArtworkCache::GetInstance().Put(artworkKey, albumCoverData, albumCoverSize, sharedAlbumCover);
     if (!callback_) {
         CLOGE("callback_ is null");
         return false;
@@ -1058,6 +1243,7 @@ bool CastStreamPlayer::Reset()
         CLOGE("Media player is null");
         return false;
     }
+    imageGeneration_++;
     int32_t ret = player_->Reset();
     if (ret != MSERR_OK) {
         CLOGE("Media player reset failed");
@@ -1069,12 +1255,16 @@ bool CastStreamPlayer::Reset()
 bool CastStreamPlayer::Release()
 {
     CLOGD("Release in");
-    if (audioSystemMgr_) {
-        audioSystemMgr_->UnregisterVolumeKeyEventCallback(getpid());
-        audioSystemMgr_ = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        // The registration is per process, a player that handed it over must not drop it for the new owner.
+        if (audioSystemMgr_ && castStreamVolumeCallback_) {
+            audioSystemMgr_->UnregisterVolumeKeyEventCallback(getpid());
+        }
+        castStreamVolumeCallback_ = nullptr;
     }
+    audioSystemMgr_ = nullptr;
     callback_ = nullptr;
-    castStreamVolumeCallback_ = nullptr;
     if (!player_) {
         CLOGE("Media player is null");
         return false;
@@ -1414,6 +1604,12 @@ void CastStreamVolumeCallback::SetMaxVolume(int maxVolume)
     CLOGI("SetMaxVolume out");
 }
 
+void CastStreamVolumeCallback::SetCallback(std::shared_ptr<CastStreamPlayerCallback> callback)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    callback_ = callback;
+}
+
 void CastStreamVolumeCallback::OnVolumeKeyEvent(AudioStandard::VolumeEvent volumeEvent)
 {
     if (volumeEvent.volumeType != AudioStandard::AudioStreamType::STREAM_MUSIC) {
@@ -1421,11 +1617,11 @@ void CastStreamVolumeCallback::OnVolumeKeyEvent(AudioStandard::VolumeEvent volum
         return;
     }
     CLOGI("OnVolumeKeyEvent input %{public}d", volumeEvent.volume);
+    std::lock_guard<std::mutex> lock(mutex_);
     if (!callback_) {
         CLOGE("StreamPlayerCallback is null");
         return;
     }
-    std::lock_guard<std::mutex> lock(mutex_);
     if (maxVolume_ <= 0) {
         CLOGE("maxVolume_ <= 0");
         return;
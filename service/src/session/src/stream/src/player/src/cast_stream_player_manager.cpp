@@ -16,10 +16,12 @@
  * Create: 2023-1-11
  */
 
+#include "artwork_cache.h"
 #include "cast_engine_errors.h"
 #include "cast_engine_log.h"
 #include "cast_stream_player_manager.h"
 #include "cast_engine_dfx.h"
+#include "cast_engine_metrics.h"
 
 namespace OHOS {
 namespace CastEngine {
@@ -30,6 +32,9 @@ CastStreamPlayerManager::CastStreamPlayerManager(std::shared_ptr<ICastStreamMana
     std::shared_ptr<CastLocalFileChannelClient> fileChannel)
 {
     CLOGD("CastStreamPlayerManager in");
+    ArtworkCache::GetInstance().AddSession();
+    streamManager_ = callback;
+    fileChannel_ = fileChannel;
     callback_ = std::make_shared<CastStreamPlayerCallback>(callback);
     if (!callback_) {
         CLOGE("callback_ is null");
@@ -49,6 +54,19 @@ CastStreamPlayerManager::CastStreamPlayerManager(std::shared_ptr<ICastStreamMana
 CastStreamPlayerManager::~CastStreamPlayerManager()
 {
     CLOGD("~CastStreamPlayerManager in");
+    ArtworkCache::GetInstance().RemoveSession();
+}
+
+std::shared_ptr<CastStreamPlayer> CastStreamPlayerManager::PlayerGetter()
+{
+    std::lock_guard<std::mutex> lock(playerMutex_);
+    return player_;
+}
+
+std::shared_ptr<CastStreamPlayerCallback> CastStreamPlayerManager::CallbackGetter()
+{
+    std::lock_guard<std::mutex> lock(playerMutex_);
+    return callback_;
 }
 
 void CastStreamPlayerManager::SetSessionCallbackForRelease(const std::function<void(void)> &callback)
@@ -60,14 +78,20 @@ void CastStreamPlayerManager::SetSessionCallbackForRelease(const std::function<v
 int32_t CastStreamPlayerManager::RegisterListener(sptr<IStreamPlayerListenerImpl> listener)
 {
     CLOGD("RegisterListener in");
-    if (!player_) {
+    auto player = PlayerGetter();
+    if (!player) {
         CLOGE("player_ is null");
         return CAST_ENGINE_ERROR;
     }
-    if (!player_->RegisterListener(listener)) {
+    if (!player->RegisterListener(listener)) {
         CLOGE("Register listener failed");
         return CAST_ENGINE_ERROR;
     }
+    std::lock_guard<std::mutex> lock(standbyMutex_);
+    listener_ = listener;
+    if (standbyPlayer_) {
+        standbyPlayer_->RegisterListener(listener);
+    }
     CLOGD("RegisterListener out");
     return CAST_ENGINE_SUCCESS;
 }
@@ -75,13 +99,19 @@ int32_t CastStreamPlayerManager::RegisterListener(sptr<IStreamPlayerListenerImpl
 int32_t CastStreamPlayerManager::UnregisterListener()
 {
     CLOGD("UnregisterListener in");
-    if (!player_) {
+    auto player = PlayerGetter();
+    if (!player) {
         CLOGE("player_ is null");
         return CAST_ENGINE_ERROR;
     }
-    if (!player_->UnregisterListener()) {
+    if (!player->UnregisterListener()) {
         return CAST_ENGINE_ERROR;
     }
+    std::lock_guard<std::mutex> lock(standbyMutex_);
+    listener_ = nullptr;
+    if (standbyPlayer_) {
+        standbyPlayer_->UnregisterListener();
+    }
     return CAST_ENGINE_SUCCESS;
 }
 
@@ -93,11 +123,11 @@ int32_t CastStreamPlayerManager::SetSurface(sptr<IBufferProducer> producer)
         CLOGE("surface is null.");
         return CAST_ENGINE_ERROR;
     }
+    std::lock_guard<std::mutex> lock(mutex_);
     if (!callback_) {
         CLOGE("callback_ is null");
         return CAST_ENGINE_ERROR;
     }
-    std::lock_guard<std::mutex> lock(mutex_);
     surface_ = surface;
     if (!isReady_) {
         callback_->OnRenderReady(true);
@@ -119,8 +149,16 @@ int32_t CastStreamPlayerManager::SetSurface(sptr<IBufferProducer> producer)
 }
 
 int32_t CastStreamPlayerManager::Load(const MediaInfo &mediaInfo)
+{
+    return Load(MediaInfoHolder{ 0, { mediaInfo }, 0 });
+}
+
+int32_t CastStreamPlayerManager::Load(const MediaInfoHolder &mediaInfoHolder)
 {
     CLOGI("Load in");
+    MOCK_TEST_PLAYER_ERROR(static_cast<int>(StreamActionId::LOAD));
+    // player_ and callback_ are swapped under mutex_ when the standby takes over.
+    std::lock_guard<std::mutex> lock(mutex_);
     if (!player_) {
         CLOGE("player_ is null");
         return CAST_ENGINE_ERROR;
@@ -129,8 +167,21 @@ int32_t CastStreamPlayerManager::Load(const MediaInfo &mediaInfo)
         CLOGE("callback_ is null");
         return CAST_ENGINE_ERROR;
     }
-    MOCK_TEST_PLAYER_ERROR(static_cast<int>(StreamActionId::LOAD));
-    std::lock_guard<std::mutex> lock(mutex_);
+    MediaInfo mediaInfo;
+    if (!SetMediaInfoHolderLocked(mediaInfoHolder, mediaInfo)) {
+        return CAST_ENGINE_ERROR;
+    }
+    if (IsAutoAdvancedItemLocked(mediaInfo)) {
+        CLOGI("Load out: %{public}s is already playing", mediaInfo.mediaId.c_str());
+        isAutoAdvanced_ = false;
+        return CAST_ENGINE_SUCCESS;
+    }
+    isAutoAdvanced_ = false;
+    // Loading an image shows it, so a slideshow moves on to the preloaded one at once.
+    if (mediaInfo.mediaType == "IMAGE" && SwitchToStandbyLocked(static_cast<int>(mediaInfoHolder_.currentIndex))) {
+        PreloadNextLocked();
+        return CAST_ENGINE_SUCCESS;
+    }
     if (callback_->IsNeededToReset()) {
         callback_->SetSwitching();
         StopLocked();
@@ -155,19 +206,40 @@ int32_t CastStreamPlayerManager::Load(const MediaInfo &mediaInfo)
 
 int32_t CastStreamPlayerManager::Play(int index)
 {
-    CLOGW("Don't support play index");
-    return CAST_ENGINE_SUCCESS;
+    CLOGD("Play index %{public}d in", index);
+    MediaInfoHolder mediaInfoHolder;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (index < 0 || static_cast<size_t>(index) >= mediaInfoHolder_.mediaInfoList.size()) {
+            CLOGE("Invalid index %{public}d, list size %{public}zu", index, mediaInfoHolder_.mediaInfoList.size());
+            return CAST_ENGINE_ERROR;
+        }
+        if (isAutoAdvanced_ && static_cast<uint32_t>(index) == mediaInfoHolder_.currentIndex) {
+            CLOGI("Play index out: item %{public}d is already playing", index);
+            isAutoAdvanced_ = false;
+            return CAST_ENGINE_SUCCESS;
+        }
+        isAutoAdvanced_ = false;
+        if (SwitchToStandbyLocked(index)) {
+            PreloadNextLocked();
+            return CAST_ENGINE_SUCCESS;
+        }
+        mediaInfoHolder = mediaInfoHolder_;
+        mediaInfoHolder.currentIndex = static_cast<uint32_t>(index);
+    }
+    return InnerPlay(mediaInfoHolder);
 }
 
 // Play request from sink.
 int32_t CastStreamPlayerManager::Play(const MediaInfo &mediaInfo)
 {
     CLOGD("Play in");
-    if (!callback_) {
+    auto callback = CallbackGetter();
+    if (!callback) {
         CLOGE("callback_ is null");
         return CAST_ENGINE_ERROR;
     }
-    callback_->OnPlayRequest(mediaInfo);
+    callback->OnPlayRequest(mediaInfo);
     return CAST_ENGINE_SUCCESS;
 }
 
@@ -189,6 +261,7 @@ bool CastStreamPlayerManager::InnerPlayLocked(bool isLoading)
         return false;
     }
     if (mediaInfo_.mediaType == "IMAGE") {
+        PreloadNextLocked();
         return true;
     }
     if (!player_->SetVideoSurface(surface_)) {
@@ -209,6 +282,8 @@ bool CastStreamPlayerManager::InnerPlayLocked(bool isLoading)
             return false;
         }
     }
+    RecordTrackGapLocked();
+    PreloadNextLocked();
 
     CLOGD("InnerPlayLocked out");
     return true;
@@ -216,8 +291,14 @@ bool CastStreamPlayerManager::InnerPlayLocked(bool isLoading)
 
 // Start media, when play media first time.
 int32_t CastStreamPlayerManager::InnerPlay(const MediaInfo &mediaInfo)
+{
+    return InnerPlay(MediaInfoHolder{ 0, { mediaInfo }, 0 });
+}
+
+int32_t CastStreamPlayerManager::InnerPlay(const MediaInfoHolder &mediaInfoHolder)
 {
     CLOGI("InnerPlay in");
+    std::lock_guard<std::mutex> lock(mutex_);
     if (!player_) {
         CLOGE("player_ is null");
         return CAST_ENGINE_ERROR;
@@ -226,8 +307,20 @@ int32_t CastStreamPlayerManager::InnerPlay(const MediaInfo &mediaInfo)
         CLOGE("callback_ is null");
         return CAST_ENGINE_ERROR;
     }
-
-    std::lock_guard<std::mutex> lock(mutex_);
+    MediaInfo mediaInfo;
+    if (!SetMediaInfoHolderLocked(mediaInfoHolder, mediaInfo)) {
+        return CAST_ENGINE_ERROR;
+    }
+    if (IsAutoAdvancedItemLocked(mediaInfo)) {
+        CLOGI("InnerPlay out: %{public}s is already playing", mediaInfo.mediaId.c_str());
+        isAutoAdvanced_ = false;
+        return CAST_ENGINE_SUCCESS;
+    }
+    isAutoAdvanced_ = false;
+    if (SwitchToStandbyLocked(static_cast<int>(mediaInfoHolder_.currentIndex))) {
+        PreloadNextLocked();
+        return CAST_ENGINE_SUCCESS;
+    }
     if (callback_->IsNeededToReset()) {
         callback_->SetSwitching();
         StopLocked();
@@ -258,12 +351,13 @@ PlaybackSpeed CastStreamPlayerManager::ConvertMediaSpeedToPlaybackSpeed(Media::P
 int32_t CastStreamPlayerManager::Pause()
 {
     CLOGD("Pause in");
-    if (!player_) {
+    auto player = PlayerGetter();
+    if (!player) {
         CLOGE("player_ is null");
         return CAST_ENGINE_ERROR;
     }
     MOCK_TEST_PLAYER_ERROR(static_cast<int>(StreamActionId::PAUSE));
-    if (!player_->Pause()) {
+    if (!player->Pause()) {
         CLOGE("StreamPlayer Pause failed");
         return CAST_ENGINE_ERROR;
     }
@@ -273,12 +367,13 @@ int32_t CastStreamPlayerManager::Pause()
 int32_t CastStreamPlayerManager::Play()
 {
     CLOGD("Play in");
-    if (!player_) {
+    auto player = PlayerGetter();
+    if (!player) {
         CLOGE("player_ is null");
         return CAST_ENGINE_ERROR;
     }
     MOCK_TEST_PLAYER_ERROR(static_cast<int>(StreamActionId::PLAY));
-    if (!player_->Play()) {
+    if (!player->Play()) {
         CLOGE("StreamPlayer Play failed");
         return CAST_ENGINE_ERROR;
     }
@@ -288,11 +383,14 @@ int32_t CastStreamPlayerManager::Play()
 int32_t CastStreamPlayerManager::Stop()
 {
     CLOGD("Stop in");
+    std::lock_guard<std::mutex> lock(mutex_);
     if (!callback_) {
         CLOGE("callback_ is null");
         return CAST_ENGINE_ERROR;
     }
-    std::lock_guard<std::mutex> lock(mutex_);
+    ReleaseStandbyLocked();
+    isAutoAdvanced_ = false;
+    isWaitingNextItem_ = false;
     if (!StopLocked()) {
         CLOGE("Stop locked failed");
         return CAST_ENGINE_ERROR;
@@ -328,12 +426,13 @@ bool CastStreamPlayerManager::StopLocked()
 int32_t CastStreamPlayerManager::Next()
 {
     CLOGD("Next in");
-    if (!callback_) {
+    auto callback = CallbackGetter();
+    if (!callback) {
         CLOGE("callback_ is null");
         return CAST_ENGINE_ERROR;
     }
     MOCK_TEST_PLAYER_ERROR(static_cast<int>(StreamActionId::NEXT));
-    callback_->OnNextRequest();
+    callback->OnNextRequest();
     CLOGD("Next out");
     return CAST_ENGINE_SUCCESS;
 }
@@ -341,12 +440,13 @@ int32_t CastStreamPlayerManager::Next()
 int32_t CastStreamPlayerManager::Previous()
 {
     CLOGD("Previous in");
-    if (!callback_) {
+    auto callback = CallbackGetter();
+    if (!callback) {
         CLOGE("callback_ is null");
         return CAST_ENGINE_ERROR;
     }
     MOCK_TEST_PLAYER_ERROR(static_cast<int>(StreamActionId::PREVIOUS));
-    callback_->OnPreviousRequest();
+    callback->OnPreviousRequest();
     CLOGD("Previous out");
     return CAST_ENGINE_SUCCESS;
 }
@@ -354,12 +454,13 @@ int32_t CastStreamPlayerManager::Previous()
 int32_t CastStreamPlayerManager::Seek(int position)
 {
     CLOGD("Seek in");
-    if (!player_) {
+    auto player = PlayerGetter();
+    if (!player) {
         CLOGE("player_ is null");
         return CAST_ENGINE_ERROR;
     }
     MOCK_TEST_PLAYER_ERROR(static_cast<int>(StreamActionId::SEEK));
-    if (!player_->Seek(position, Media::SEEK_PREVIOUS_SYNC)) {
+    if (!player->Seek(position, Media::SEEK_PREVIOUS_SYNC)) {
         CLOGE("StreamPlayer Seek failed");
         return CAST_ENGINE_ERROR;
     }
@@ -370,7 +471,8 @@ int32_t CastStreamPlayerManager::Seek(int position)
 int32_t CastStreamPlayerManager::FastForward(int delta)
 {
     CLOGD("FastForWard in");
-    if (!player_) {
+    auto player = PlayerGetter();
+    if (!player) {
         CLOGE("player_ is null");
         return CAST_ENGINE_ERROR;
     }
@@ -381,7 +483,7 @@ int32_t CastStreamPlayerManager::FastForward(int delta)
         CLOGE("GetPosition failed");
         return ret;
     }
-    if (!player_->Seek(curPosition + delta, Media::SEEK_PREVIOUS_SYNC)) {
+    if (!player->Seek(curPosition + delta, Media::SEEK_PREVIOUS_SYNC)) {
         CLOGE("StreamPlayer Seek failed");
         return CAST_ENGINE_ERROR;
     }
@@ -392,7 +494,8 @@ int32_t CastStreamPlayerManager::FastForward(int delta)
 int32_t CastStreamPlayerManager::FastRewind(int delta)
 {
     CLOGD("FastForRewind in");
-    if (!player_) {
+    auto player = PlayerGetter();
+    if (!player) {
         CLOGE("player_ is null");
         return CAST_ENGINE_ERROR;
     }
@@ -403,7 +506,7 @@ int32_t CastStreamPlayerManager::FastRewind(int delta)
         CLOGE("GetPosition failed");
         return ret;
     }
-    if (!player_->Seek(curPosition - delta, Media::SEEK_PREVIOUS_SYNC)) {
+    if (!player->Seek(curPosition - delta, Media::SEEK_PREVIOUS_SYNC)) {
         CLOGE("StreamPlayer Seek failed");
         return CAST_ENGINE_ERROR;
     }
@@ -414,12 +517,13 @@ int32_t CastStreamPlayerManager::FastRewind(int delta)
 int32_t CastStreamPlayerManager::SetVolume(int volume)
 {
     CLOGD("SetVolume in");
-    if (!player_) {
+    auto player = PlayerGetter();
+    if (!player) {
         CLOGE("player_ is null");
         return CAST_ENGINE_ERROR;
     }
     MOCK_TEST_PLAYER_ERROR(static_cast<int>(StreamActionId::SET_VOLUME));
-    if (!player_->SetVolume(volume)) {
+    if (!player->SetVolume(volume)) {
         CLOGE("StreamPlayer SetVolume failed");
         return CAST_ENGINE_ERROR;
     }
@@ -430,12 +534,13 @@ int32_t CastStreamPlayerManager::SetVolume(int volume)
 int32_t CastStreamPlayerManager::SetMute(bool mute)
 {
     CLOGD("SetMute in");
-    if (!player_) {
+    auto player = PlayerGetter();
+    if (!player) {
         CLOGE("player_ is null");
         return CAST_ENGINE_ERROR;
     }
     MOCK_TEST_PLAYER_ERROR(static_cast<int>(StreamActionId::SET_MUTE));
-    if (!player_->SetMute(mute)) {
+    if (!player->SetMute(mute)) {
         CLOGE("StreamPlayer SetMute failed");
         return CAST_ENGINE_ERROR;
     }
@@ -446,12 +551,13 @@ int32_t CastStreamPlayerManager::SetMute(bool mute)
 int32_t CastStreamPlayerManager::SetLoopMode(const LoopMode mode)
 {
     CLOGD("SetLoopMode in");
-    if (!player_) {
+    auto player = PlayerGetter();
+    if (!player) {
         CLOGE("player_ is null");
         return CAST_ENGINE_ERROR;
     }
     MOCK_TEST_PLAYER_ERROR(static_cast<int>(StreamActionId::SET_LOOP_MODE));
-    if (!player_->SetLoopMode(mode)) {
+    if (!player->SetLoopMode(mode)) {
         CLOGE("StreamPlayer SetLoopMode failed");
         return CAST_ENGINE_ERROR;
     }
@@ -462,11 +568,12 @@ int32_t CastStreamPlayerManager::SetLoopMode(const LoopMode mode)
 int32_t CastStreamPlayerManager::InnerSetAvailableCapability(const StreamCapability &streamCapability)
 {
     CLOGD("InnerSetAvailableCapability in");
-    if (!callback_) {
+    auto callback = CallbackGetter();
+    if (!callback) {
         CLOGE("callback_ is null");
         return CAST_ENGINE_ERROR;
     }
-    callback_->OnAvailableCapabilityChanged(streamCapability);
+    callback->OnAvailableCapabilityChanged(streamCapability);
     std::lock_guard<std::mutex> lock(mutex_);
     availableCapability_ = streamCapability;
     CLOGD("InnerSetAvailableCapability out");
@@ -482,17 +589,18 @@ int32_t CastStreamPlayerManager::SetAvailableCapability(const StreamCapability &
 int32_t CastStreamPlayerManager::SetSpeed(const PlaybackSpeed speed)
 {
     CLOGD("SetSpeed in");
+    auto player = PlayerGetter();
     auto iter = g_doubleToModeTypeMap.find(speed);
     if (iter == g_doubleToModeTypeMap.end()) {
         CLOGE("ConvertDoubleToSpeedMode, unknown event keyCode");
         return CAST_ENGINE_ERROR;
     }
     auto mode = static_cast<Media::PlaybackRateMode>(iter->second);
-    if (!player_) {
+    if (!player) {
         CLOGE("player_ is null");
         return CAST_ENGINE_ERROR;
     }
-    if (!player_->SetPlaybackSpeed(mode)) {
+    if (!player->SetPlaybackSpeed(mode)) {
         CLOGE("StreamPlayer SetSpeed failed");
         return CAST_ENGINE_ERROR;
     }
@@ -503,25 +611,28 @@ int32_t CastStreamPlayerManager::SetSpeed(const PlaybackSpeed speed)
 int32_t CastStreamPlayerManager::GetPlayerStatus(PlayerStates &playerStates)
 {
     CLOGD("GetPlayerStatus in");
+    auto player = PlayerGetter();
+    auto callback = CallbackGetter();
     playerStates = PlayerStates::PLAYER_STATE_ERROR;
-    if (!player_) {
+    if (!player) {
         CLOGE("player_ is null");
         return CAST_ENGINE_ERROR;
     }
     CLOGD("GetPlayerStatus out");
-    playerStates = callback_->GetPlayerStatus();
+    playerStates = callback->GetPlayerStatus();
     return CAST_ENGINE_SUCCESS;
 }
 
 int32_t CastStreamPlayerManager::GetPosition(int &position)
 {
     CLOGD("GetPosition in");
+    auto player = PlayerGetter();
     position = CAST_STREAM_INT_INVALID;
-    if (!player_) {
+    if (!player) {
         CLOGE("player_ is null");
         return CAST_ENGINE_ERROR;
     }
-    if (!player_->GetCurrentTime(position)) {
+    if (!player->GetCurrentTime(position)) {
         CLOGE("StreamPlayer GetPosition failed");
         return CAST_ENGINE_ERROR;
     }
@@ -532,12 +643,13 @@ int32_t CastStreamPlayerManager::GetPosition(int &position)
 int32_t CastStreamPlayerManager::GetDuration(int &duration)
 {
     CLOGD("GetDuration in");
+    auto player = PlayerGetter();
     duration = CAST_STREAM_INT_INVALID;
-    if (!player_) {
+    if (!player) {
         CLOGE("player_ is null");
         return CAST_ENGINE_ERROR;
     }
-    duration = player_->GetDuration();
+    duration = player->GetDuration();
     CLOGD("GetDuration out");
     return CAST_ENGINE_SUCCESS;
 }
@@ -545,13 +657,14 @@ int32_t CastStreamPlayerManager::GetDuration(int &duration)
 int32_t CastStreamPlayerManager::GetVolume(int &volume, int &maxVolume)
 {
     CLOGD("GetVolume in");
+    auto player = PlayerGetter();
     volume = CAST_STREAM_INT_INVALID;
     maxVolume = CAST_STREAM_INT_INVALID;
-    if (!player_) {
+    if (!player) {
         CLOGE("player_ is null");
         return CAST_ENGINE_ERROR;
     }
-    if (!player_->GetVolume(volume, maxVolume)) {
+    if (!player->GetVolume(volume, maxVolume)) {
         return CAST_ENGINE_ERROR;
     }
     return CAST_ENGINE_SUCCESS;
@@ -560,30 +673,33 @@ int32_t CastStreamPlayerManager::GetVolume(int &volume, int &maxVolume)
 int32_t CastStreamPlayerManager::GetMute(bool &mute)
 {
     CLOGD("GetMute in");
-    if (!player_) {
+    auto player = PlayerGetter();
+    if (!player) {
         CLOGE("player_ is null");
         return CAST_ENGINE_ERROR;
     }
-    mute = player_->GetMute();
+    mute = player->GetMute();
     return CAST_ENGINE_SUCCESS;
 }
 
 int32_t CastStreamPlayerManager::GetLoopMode(LoopMode &loopMode)
 {
     CLOGD("GetLoopMode in");
+    auto player = PlayerGetter();
     loopMode = LoopMode::LOOP_MODE_LIST;
-    if (!player_) {
+    if (!player) {
         CLOGE("player_ is null");
         return CAST_ENGINE_ERROR;
     }
-    loopMode = player_->GetLoopMode();
+    loopMode = player->GetLoopMode();
     return CAST_ENGINE_SUCCESS;
 }
 
 int32_t CastStreamPlayerManager::GetAvailableCapability(StreamCapability &streamCapability)
 {
     CLOGD("GetAvailableCapability in");
-    if (!player_) {
+    auto player = PlayerGetter();
+    if (!player) {
         CLOGE("player_ is null");
         return CAST_ENGINE_ERROR;
     }
@@ -595,13 +711,14 @@ int32_t CastStreamPlayerManager::GetAvailableCapability(StreamCapability &stream
 int32_t CastStreamPlayerManager::GetPlaySpeed(PlaybackSpeed &playbackSpeed)
 {
     CLOGD("GetPlaySpeed in");
+    auto player = PlayerGetter();
     playbackSpeed = PlaybackSpeed::SPEED_FORWARD_1_00_X;
-    if (!player_) {
+    if (!player) {
         CLOGE("player_ is null");
         return CAST_ENGINE_ERROR;
     }
     Media::PlaybackRateMode ret = Media::SPEED_FORWARD_1_00_X;
-    if (!player_->GetPlaybackSpeed(ret)) {
+    if (!player->GetPlaybackSpeed(ret)) {
         CLOGE("StreamPlayer GetPlaybackSpeed failed");
         return CAST_ENGINE_ERROR;
     }
@@ -612,8 +729,14 @@ int32_t CastStreamPlayerManager::GetPlaySpeed(PlaybackSpeed &playbackSpeed)
 
 int32_t CastStreamPlayerManager::GetMediaInfoHolder(MediaInfoHolder &mediaInfoHolder)
 {
-    CLOGW("Don't support GetMediaInfoHolder");
-    return CAST_ENGINE_ERROR;
+    CLOGD("GetMediaInfoHolder in");
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (mediaInfoHolder_.mediaInfoList.empty()) {
+        CLOGE("No media is loaded");
+        return CAST_ENGINE_ERROR;
+    }
+    mediaInfoHolder = mediaInfoHolder_;
+    return CAST_ENGINE_SUCCESS;
 }
 
 int32_t CastStreamPlayerManager::ProvideKeyResponse(const std::string &mediaId, const std::vector<uint8_t> &response)
@@ -634,11 +757,330 @@ int32_t CastStreamPlayerManager::Release()
     return CAST_ENGINE_SUCCESS;
 }
 
+bool CastStreamPlayerManager::SetMediaInfoHolderLocked(const MediaInfoHolder &mediaInfoHolder,
+    MediaInfo &currentMediaInfo)
+{
+    if (mediaInfoHolder.mediaInfoList.empty()) {
+        CLOGE("Media info list is empty");
+        return false;
+    }
+    uint32_t index = mediaInfoHolder.currentIndex;
+    if (index >= mediaInfoHolder.mediaInfoList.size()) {
+        CLOGW("Invalid index %{public}u, play the first item", index);
+        index = 0;
+    }
+    currentMediaInfo = mediaInfoHolder.mediaInfoList[index];
+    if (IsAutoAdvancedItemLocked(currentMediaInfo)) {
+        // The source follows an item the sink has already switched to, keep the preload of the one after it.
+        return true;
+    }
+    bool isSameList = IsSameListLocked(mediaInfoHolder);
+    mediaInfoHolder_ = mediaInfoHolder;
+    mediaInfoHolder_.currentIndex = index;
+    if (!isSameList) {
+        InvalidateStandbyLocked();
+    }
+    return true;
+}
+
+bool CastStreamPlayerManager::IsSameListLocked(const MediaInfoHolder &mediaInfoHolder)
+{
+    const auto &list = mediaInfoHolder.mediaInfoList;
+    const auto &currentList = mediaInfoHolder_.mediaInfoList;
+    if (list.size() != currentList.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < list.size(); i++) {
+        if (list[i].mediaId != currentList[i].mediaId || list[i].mediaUrl != currentList[i].mediaUrl) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool CastStreamPlayerManager::IsAutoAdvancedItemLocked(const MediaInfo &mediaInfo)
+{
+    return isAutoAdvanced_ && mediaInfo.mediaId == mediaInfo_.mediaId && mediaInfo.mediaUrl == mediaInfo_.mediaUrl;
+}
+
+int CastStreamPlayerManager::GetNextIndexLocked()
+{
+    int size = static_cast<int>(mediaInfoHolder_.mediaInfoList.size());
+    int index = static_cast<int>(mediaInfoHolder_.currentIndex);
+    if (size <= 1 || !player_) {
+        return INVALID_INDEX;
+    }
+    switch (player_->GetLoopMode()) {
+        case LoopMode::LOOP_MODE_LIST:
+            return (index + 1) % size;
+        case LoopMode::LOOP_MODE_SEQUENCE:
+            return index + 1 < size ? index + 1 : INVALID_INDEX;
+        default:
+            // Single repeats the current item, shuffle is decided by the source.
+            return INVALID_INDEX;
+    }
+}
+
+bool CastStreamPlayerManager::CreateStandbyLocked()
+{
+    if (standbyPlayer_) {
+        return true;
+    }
+    auto streamManager = streamManager_.lock();
+    if (!streamManager || !callback_) {
+        CLOGE("streamManager or callback_ is null");
+        return false;
+    }
+    standbyCallback_ = std::make_shared<CastStreamPlayerCallback>(streamManager);
+    standbyCallback_->SetActive(false);
+    standbyPlayer_ = std::make_shared<CastStreamPlayer>(standbyCallback_, fileChannel_, false);
+    standbyCallback_->SetPlayer(standbyPlayer_);
+    if (listener_) {
+        standbyPlayer_->RegisterListener(listener_);
+    }
+
+    std::weak_ptr<CastStreamPlayerManager> weakManager = weak_from_this();
+    auto onEndOfStream = [weakManager]() {
+        auto manager = weakManager.lock();
+        if (manager) {
+            manager->OnEndOfStream();
+        }
+    };
+    standbyCallback_->SetEndOfStreamCallback(onEndOfStream);
+    callback_->SetEndOfStreamCallback(onEndOfStream);
+    CLOGI("Standby player created");
+    return true;
+}
+
+bool CastStreamPlayerManager::IsPreloadable(const MediaInfo &mediaInfo)
+{
+    // A video item needs the surface that the current player still renders to, so it gains nothing from a preload.
+    return mediaInfo.mediaUrl != "http:" && (mediaInfo.mediaType == "AUDIO" || mediaInfo.mediaType == "IMAGE");
+}
+
+void CastStreamPlayerManager::PreloadNextLocked()
+{
+    int index = GetNextIndexLocked();
+    if (index == INVALID_INDEX || !IsPreloadable(mediaInfoHolder_.mediaInfoList[index])) {
+        ReleaseStandbyLocked();
+        return;
+    }
+    MediaInfo mediaInfo = mediaInfoHolder_.mediaInfoList[index];
+    uint32_t generation;
+    {
+        std::lock_guard<std::mutex> lock(standbyMutex_);
+        if (!CreateStandbyLocked()) {
+            return;
+        }
+        generation = ++standbyGeneration_;
+        standbyIndex_ = index;
+        isStandbyReady_ = false;
+    }
+
+    auto streamManager = streamManager_.lock();
+    if (!streamManager) {
+        CLOGE("streamManager is null");
+        return;
+    }
+    std::weak_ptr<CastStreamPlayerManager> weakManager = weak_from_this();
+    streamManager->PostTask([weakManager, generation, index, mediaInfo]() {
+        auto manager = weakManager.lock();
+        if (manager) {
+            manager->PrepareStandby(generation, index, mediaInfo);
+        }
+    });
+}
+
+void CastStreamPlayerManager::PrepareStandby(uint32_t generation, int index, const MediaInfo &mediaInfo)
+{
+    std::lock_guard<std::mutex> preloadLock(preloadMutex_);
+    std::shared_ptr<CastStreamPlayer> player;
+    std::shared_ptr<CastStreamPlayerCallback> callback;
+    {
+        std::lock_guard<std::mutex> lock(standbyMutex_);
+        if (generation != standbyGeneration_ || !standbyPlayer_ || !standbyCallback_) {
+            return;
+        }
+        player = standbyPlayer_;
+        callback = standbyCallback_;
+    }
+
+    CLOGI("Preload item %{public}d, %{public}s", index, mediaInfo.mediaId.c_str());
+    player->Stop();
+    player->Reset();
+    // Drops whatever the previous item left behind after it was switched away from.
+    callback->SetActive(false);
+    bool isImage = mediaInfo.mediaType == "IMAGE";
+    if (isImage) {
+        std::weak_ptr<CastStreamPlayerManager> weakManager = weak_from_this();
+        callback->SetImageDecodedCallback([weakManager, generation, index](bool isDecoded) {
+            auto manager = weakManager.lock();
+            if (manager) {
+                manager->SetStandbyReady(generation, index, isDecoded);
+            }
+        });
+    }
+    // An image is decoded on its own thread and kept by the inactive callback until the switch, the item is only
+    // ready once that decode succeeded.
+    bool isReady = player->SetSource(mediaInfo);
+    if (isReady && mediaInfo.mediaType == "AUDIO") {
+        isReady = player->Prepare();
+    }
+    if (isImage && isReady) {
+        return;
+    }
+    SetStandbyReady(generation, index, isReady);
+}
+
+void CastStreamPlayerManager::SetStandbyReady(uint32_t generation, int index, bool isReady)
+{
+    std::lock_guard<std::mutex> lock(standbyMutex_);
+    if (generation != standbyGeneration_) {
+        CLOGD("Preload of item %{public}d is outdated", index);
+        return;
+    }
+    isStandbyReady_ = isReady;
+    CLOGI("Preload item %{public}d %{public}s", index, isReady ? "ready" : "failed");
+}
+
+void CastStreamPlayerManager::InvalidateStandbyLocked()
+{
+    std::lock_guard<std::mutex> lock(standbyMutex_);
+    ++standbyGeneration_;
+    standbyIndex_ = INVALID_INDEX;
+    isStandbyReady_ = false;
+}
+
+void CastStreamPlayerManager::ReleaseStandbyLocked()
+{
+    std::shared_ptr<CastStreamPlayer> player;
+    std::shared_ptr<CastStreamPlayerCallback> callback;
+    {
+        std::lock_guard<std::mutex> lock(standbyMutex_);
+        ++standbyGeneration_;
+        standbyIndex_ = INVALID_INDEX;
+        isStandbyReady_ = false;
+        player = std::move(standbyPlayer_);
+        callback = std::move(standbyCallback_);
+    }
+    if (player) {
+        // Releasing the media player blocks, so it is not done under standbyMutex_.
+        player->UnregisterListener();
+        CLOGI("Standby player released");
+    }
+}
+
+bool CastStreamPlayerManager::SwitchToStandbyLocked(int index)
+{
+    std::shared_ptr<CastStreamPlayer> oldPlayer = player_;
+    std::shared_ptr<CastStreamPlayerCallback> oldCallback = callback_;
+    std::shared_ptr<CastStreamPlayer> newPlayer;
+    std::shared_ptr<CastStreamPlayerCallback> newCallback;
+    {
+        std::lock_guard<std::mutex> lock(standbyMutex_);
+        if (!isStandbyReady_ || standbyIndex_ != index || !oldPlayer || !oldCallback) {
+            return false;
+        }
+        ++standbyGeneration_;
+        standbyIndex_ = INVALID_INDEX;
+        isStandbyReady_ = false;
+        newPlayer = standbyPlayer_;
+        newCallback = standbyCallback_;
+        standbyPlayer_ = oldPlayer;
+        standbyCallback_ = oldCallback;
+    }
+
+    CLOGI("Switch to the preloaded item %{public}d", index);
+    static auto &gaplessSwitches = CastEngineMetrics::GetInstance().RegisterCounter(METRIC_STREAM_GAPLESS_SWITCHES);
+    LoopMode loopMode = oldPlayer->GetLoopMode();
+    bool isMute = oldPlayer->GetMute();
+    Media::PlaybackRateMode speedMode = Media::SPEED_FORWARD_1_00_X;
+    oldPlayer->GetPlaybackSpeed(speedMode);
+    oldCallback->SetActive(false);
+    {
+        std::lock_guard<std::mutex> lock(playerMutex_);
+        player_ = newPlayer;
+        callback_ = newCallback;
+    }
+    newPlayer->AttachVolumeCallback(oldPlayer->DetachVolumeCallback());
+    newCallback->SetActive(true);
+    oldPlayer->Stop();
+
+    mediaInfoHolder_.currentIndex = static_cast<uint32_t>(index);
+    mediaInfo_ = mediaInfoHolder_.mediaInfoList[index];
+    isReceiveLoadCommand_ = false;
+    isReceivePlayCommand_ = true;
+    newCallback->OnMediaItemChanged(mediaInfo_);
+    if (newPlayer->GetLoopMode() != loopMode) {
+        newPlayer->SetLoopMode(loopMode);
+    }
+    if (newPlayer->GetMute() != isMute) {
+        newPlayer->SetMute(isMute);
+    }
+    if (mediaInfo_.mediaType == "IMAGE") {
+        gaplessSwitches.Add();
+        return true;
+    }
+    if (!newPlayer->Play()) {
+        CLOGE("StreamPlayer Play failed");
+        newCallback->OnPlayerError(ERR_CODE_PLAY_FAILED, PLAYER_ERROR);
+        return true;
+    }
+    if (speedMode != Media::SPEED_FORWARD_1_00_X) {
+        newPlayer->SetPlaybackSpeed(speedMode);
+    }
+    gaplessSwitches.Add();
+    return true;
+}
+
+void CastStreamPlayerManager::OnEndOfStream()
+{
+    auto endOfStreamTime = std::chrono::steady_clock::now();
+    auto streamManager = streamManager_.lock();
+    if (!streamManager) {
+        CLOGE("streamManager is null");
+        return;
+    }
+    std::weak_ptr<CastStreamPlayerManager> weakManager = weak_from_this();
+    // The end of stream comes on the media player's callback thread, which must not reset that player.
+    streamManager->PostTask([weakManager, endOfStreamTime]() {
+        auto manager = weakManager.lock();
+        if (!manager) {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(manager->mutex_);
+        manager->endOfStreamTime_ = endOfStreamTime;
+        manager->isWaitingNextItem_ = true;
+        int index = manager->GetNextIndexLocked();
+        if (index == INVALID_INDEX || !manager->SwitchToStandbyLocked(index)) {
+            CLOGI("Next item is not preloaded, wait for the source");
+            return;
+        }
+        manager->isAutoAdvanced_ = true;
+        manager->RecordTrackGapLocked();
+        manager->PreloadNextLocked();
+    });
+}
+
+void CastStreamPlayerManager::RecordTrackGapLocked()
+{
+    if (!isWaitingNextItem_) {
+        return;
+    }
+    isWaitingNextItem_ = false;
+    auto gapUs = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - endOfStreamTime_).count();
+    static auto &trackGap = CastEngineMetrics::GetInstance().RegisterHistogram(METRIC_STREAM_TRACK_GAP_US);
+    trackGap.Record(static_cast<uint64_t>(gapUs));
+    CLOGI("Track gap %{public}lld us", static_cast<long long>(gapUs));
+}
+
 // Used for mock tests
 bool CastStreamPlayerManager::MockPlayerError(int32_t action)
 {
     CLOGI("MockPlayerError MockErrorCode_%{public}s, action %{public}d", MockErrorCode_.c_str(), action);
-    if (MockErrorCode_.empty() || !callback_) {
+    auto callback = CallbackGetter();
+    if (MockErrorCode_.empty() || !callback) {
         return false;
     }
     std::string param = OHOS::system::GetParameter("debug.cast.stream.error", "");
@@ -647,7 +1089,7 @@ bool CastStreamPlayerManager::MockPlayerError(int32_t action)
     if (!jsonObj.is_discarded()) {
         if (jsonObj.contains(errormsg) && jsonObj[errormsg].is_string()) {
             int32_t errorCode = std::atoi(jsonObj[errormsg].get<std::string>().c_str());
-            callback_->OnPlayerError(errorCode, errormsg);
+            callback->OnPlayerError(errorCode, errormsg);
             return true;
         }
     }
@@ -171,9 +171,17 @@ int32_t RemotePlayerController::Play(const MediaInfo &mediaInfo)
 
 int32_t RemotePlayerController::Play(int index)
 {
-    CLOGE("Don't support Play index remotely");
-    static_cast<void>(index);
-    return CAST_ENGINE_ERROR;
+    CLOGI("Play index %{public}d in", index);
+    std::shared_ptr<ICastStreamManagerClient> targetCallback = callback_.lock();
+    if (!targetCallback) {
+        CLOGE("ICastStreamManagerClient is null");
+        return CAST_ENGINE_ERROR;
+    }
+    if (!targetCallback->NotifyPeerPlayIndex(index)) {
+        CLOGE("NotifyPeerPlayIndex failed");
+        return CAST_ENGINE_ERROR;
+    }
+    return CAST_ENGINE_SUCCESS;
 }
 
 int32_t RemotePlayerController::Play()
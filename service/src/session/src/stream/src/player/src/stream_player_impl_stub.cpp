@@ -121,13 +121,13 @@ int32_t StreamPlayerImplStub::DoSetSurface(MessageParcel &data, MessageParcel &r
 
 int32_t StreamPlayerImplStub::DoLoadTask(MessageParcel &data, MessageParcel &reply)
 {
-    auto mediaInfo = ReadMediaInfo(data);
-    if (mediaInfo == nullptr) {
+    MediaInfo mediaInfo;
+    if (!ReadMediaInfo(data, mediaInfo)) {
         CLOGE("Invalid remote device object comes");
         return ERR_INVALID_DATA;
     }
 
-    if (!reply.WriteInt32(Load(*mediaInfo))) {
+    if (!reply.WriteInt32(Load(mediaInfo))) {
         CLOGE("Failed to write int value");
         return IPC_STUB_WRITE_PARCEL_ERR;
     }
@@ -137,13 +137,13 @@ int32_t StreamPlayerImplStub::DoLoadTask(MessageParcel &data, MessageParcel &rep
 
 int32_t StreamPlayerImplStub::DoStartTask(MessageParcel &data, MessageParcel &reply)
 {
-    auto mediaInfo = ReadMediaInfo(data);
-    if (mediaInfo == nullptr) {
+    MediaInfo mediaInfo;
+    if (!ReadMediaInfo(data, mediaInfo)) {
         CLOGE("Invalid remote device object comes");
         return ERR_INVALID_DATA;
     }
 
-    if (!reply.WriteInt32(Play(*mediaInfo))) {
+    if (!reply.WriteInt32(Play(mediaInfo))) {
         CLOGE("Failed to write int value");
         return IPC_STUB_WRITE_PARCEL_ERR;
     }
@@ -469,7 +469,7 @@ int32_t StreamPlayerImplStub::DoProvideKeyResponseTask(MessageParcel &data, Mess
     std::string mediaId = data.ReadString();
     std::vector<uint8_t> response;
     int32_t responseSize = data.ReadInt32();
-    const uint8_t *responseBuf = data.ReadBuffer(static_cast<size_t>(responseSize));
+    const auto *responseBuf = static_cast<const uint8_t *>(data.ReadRawData(static_cast<size_t>(responseSize)));
     if (responseSize == 0 || responseBuf == nullptr) {
         CLOGE("invalid buffer, len = %{public}d", responseSize);
         return ERR_NULL_OBJECT;
@@ -364,7 +364,7 @@ void StreamPlayerListenerImplProxy::OnKeyRequest(const std::string &mediaId, con
     }
 
     if (len != 0) {
-        if (!data.WriteBuffer(keyRequestData.data(), len)) {
+        if (!data.WriteRawData(keyRequestData.data(), len)) {
             CLOGE("write keyRequestData failed");
             return;
         }
@@ -0,0 +1,135 @@
+/*
+ * Copyright (C) 2023-2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * Description: cast session trace, records channel bytes, rtsp messages, handler messages and session states
+ * into a compact binary file, and reads them back for replay with a virtual clock.
+ * Author: zhangge
+ * Create: 2023-06-05
+ */
+
+#ifndef CAST_TRACE_H
+#define CAST_TRACE_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "utils.h"
+
+namespace OHOS {
+namespace CastEngine {
+namespace CastEngineService {
+inline constexpr char PARAM_SESSION_TRACE[] = "debug.cast.session.trace";
+inline constexpr char PARAM_SESSION_TRACE_PATH[] = "debug.cast.session.trace.path";
+
+enum class TraceRecordType : uint8_t {
+    CHANNEL_RX = 1,
+    CHANNEL_TX,
+    RTSP_RX,
+    RTSP_TX,
+    HANDLER_MESSAGE,
+    SESSION_STATE,
+};
+
+/*
+ * One record of the trace file. On disk it is a packed little endian header (type, tag, timestamp, length)
+ * followed by length bytes of payload.
+ *  - CHANNEL_RX/TX: tag is the ModuleType, payload the frame without the length header.
+ *  - RTSP_RX/TX: tag is the EndType of the controller that received or sent it, payload the plain text message.
+ *  - HANDLER_MESSAGE: tag is unused, payload is what_, arg1_, arg2_ as three int32.
+ *  - SESSION_STATE: tag is the entered SessionState, no payload.
+ */
+struct TraceRecord {
+    TraceRecordType type{ TraceRecordType::CHANNEL_RX };
+    uint16_t tag{ 0 };
+    uint64_t timestampUs{ 0 };
+    std::vector<uint8_t> payload;
+};
+
+/*
+ * Records only in builds with cast_engine_session_trace (CAST_ENGINE_SESSION_TRACE) and PARAM_SESSION_TRACE set,
+ * the trace holds the plain payloads of the session. Everywhere else every call is a no-op.
+ */
+class CastTraceRecorder {
+public:
+    static CastTraceRecorder &GetInstance();
+
+    bool IsEnabled() const
+    {
+        return enabled_.load(std::memory_order_relaxed);
+    }
+
+    void Record(TraceRecordType type, uint16_t tag, const uint8_t *data, uint32_t length);
+    void RecordMessage(int what, int arg1, int arg2);
+    void RecordState(uint16_t state);
+    void Stop();
+
+private:
+    CastTraceRecorder();
+    ~CastTraceRecorder();
+
+    std::atomic<bool> enabled_{ false };
+    std::mutex mutex_;
+    FILE *file_{ nullptr };
+    uint64_t size_{ 0 };
+    std::chrono::steady_clock::time_point start_;
+    DISALLOW_EVIL_CONSTRUCTORS(CastTraceRecorder);
+};
+
+/*
+ * Reads a trace back and replays it against a virtual clock: records are handed out in capture order and the clock
+ * jumps to each record's timestamp instead of sleeping, so a replay is deterministic and runs as fast as the
+ * consumer. The consumer decides what to do with a record, cast_trace_replay for one hands the RTSP_RX payloads of
+ * one end to the channel listener of a fresh RtspController and compares what it sends with the RTSP_TX records.
+ * Tasks put on the clock with Schedule() fire between the records in timestamp order; timers the component under
+ * test runs by itself stay on the real clock.
+ */
+class CastTraceReplayer {
+public:
+    explicit CastTraceReplayer(const std::string &path) : path_(path) {}
+    ~CastTraceReplayer() = default;
+
+    bool Load();
+    // Tasks due up to drainUs after the last record still fire, later ones are dropped.
+    void Replay(const std::function<void(const TraceRecord &record)> &consumer, uint64_t drainUs = 0);
+    // Runs the task once the virtual clock reaches atUs, may be called from the consumer or from another task.
+    void Schedule(uint64_t atUs, std::function<void()> task);
+    uint64_t Now() const
+    {
+        return nowUs_;
+    }
+
+    // Time spent in each session state, keyed by SessionState.
+    std::map<uint16_t, uint64_t> GetStateDwellTimeUs() const;
+    // Time from the first RTSP message to the given session state, 0 if the trace never reaches it.
+    uint64_t GetNegotiationTimeUs(uint16_t targetState) const;
+
+private:
+    void RunTasksUntil(uint64_t timeUs);
+
+    std::string path_;
+    std::vector<TraceRecord> records_;
+    std::multimap<uint64_t, std::function<void()>> tasks_;
+    uint64_t nowUs_{ 0 };
+};
+} // namespace CastEngineService
+} // namespace CastEngine
+} // namespace OHOS
+
+#endif
@@ -119,6 +119,9 @@ inline constexpr char USED_AGGR_SEND[] = "debug.cast.aggr.send";
 inline constexpr char PARAM_VTP_SUPPORT[] = "debug.cast.vtp.support";
 inline constexpr char PARAM_YUV_SUPPORT[] = "debug.cast.yuv.support";
 inline constexpr char FLASH_LIGHT[] = "debug.cast.flash.light";
+inline constexpr char PARAM_CONNECT_PARALLEL[] = "debug.cast.connect.parallel";
+inline constexpr char PARAM_CHANNEL_MUX[] = "debug.cast.channel.mux";
+inline constexpr char PARAM_VTP_UDP[] = "debug.cast.vtp.udp";
 } // namespace CastEngineService
 } // namespace CastEngine
 } // namespace OHOS
@@ -0,0 +1,285 @@
+/*
+ * Copyright (C) 2023-2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * Description: cast session trace, records channel bytes, rtsp messages, handler messages and session states
+ * into a compact binary file, and reads them back for replay with a virtual clock.
+ * Author: zhangge
+ * Create: 2023-06-05
+ */
+
+#include "cast_trace.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cinttypes>
+#include <cstring>
+
+#include "cast_engine_log.h"
+#include "parameters.h"
+#include "securec.h"
+
+namespace OHOS {
+namespace CastEngine {
+namespace CastEngineService {
+DEFINE_CAST_ENGINE_LABEL("Cast-Trace");
+
+namespace {
+constexpr uint8_t TRACE_MAGIC[] = { 'C', 'T', 'R', 'C' };
+constexpr uint8_t TRACE_VERSION = 1;
+// type(1) + tag(2) + timestamp(8) + length(4)
+constexpr size_t RECORD_HEADER_LEN = 15;
+constexpr size_t MESSAGE_PAYLOAD_LEN = 3 * sizeof(int32_t);
+constexpr unsigned int BYTE_BITS = 8;
+constexpr uint64_t MAX_TRACE_SIZE = 64 * 1024 * 1024;
+
+void PutLe(uint8_t *dst, uint64_t value, size_t bytes)
+{
+    for (size_t i = 0; i < bytes; i++) {
+        dst[i] = static_cast<uint8_t>(value >> (i * BYTE_BITS));
+    }
+}
+
+uint64_t GetLe(const uint8_t *src, size_t bytes)
+{
+    uint64_t value = 0;
+    for (size_t i = 0; i < bytes; i++) {
+        value |= static_cast<uint64_t>(src[i]) << (i * BYTE_BITS);
+    }
+    return value;
+}
+} // namespace
+
+CastTraceRecorder &CastTraceRecorder::GetInstance()
+{
+    static CastTraceRecorder instance{};
+    return instance;
+}
+
+CastTraceRecorder::CastTraceRecorder() : start_(std::chrono::steady_clock::now())
+{
+#ifdef CAST_ENGINE_SESSION_TRACE
+    if (!system::GetBoolParameter(PARAM_SESSION_TRACE, false)) {
+        return;
+    }
+
+    std::string path =
+        system::GetParameter(PARAM_SESSION_TRACE_PATH, std::string(SANDBOX_PATH) + "/cast_session.trace");
+    file_ = fopen(path.c_str(), "wb");
+    if (file_ == nullptr) {
+        CLOGE("open trace file failed, errno = %{public}d", errno);
+        return;
+    }
+    uint8_t header[sizeof(TRACE_MAGIC) + 1] = {};
+    if (memcpy_s(header, sizeof(header), TRACE_MAGIC, sizeof(TRACE_MAGIC)) != EOK) {
+        fclose(file_);
+        file_ = nullptr;
+        return;
+    }
+    header[sizeof(TRACE_MAGIC)] = TRACE_VERSION;
+    size_ = fwrite(header, 1, sizeof(header), file_);
+    enabled_ = true;
+    CLOGI("session trace enabled");
+#endif
+}
+
+CastTraceRecorder::~CastTraceRecorder()
+{
+    Stop();
+}
+
+void CastTraceRecorder::Stop()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    enabled_ = false;
+    if (file_ != nullptr) {
+        fclose(file_);
+        file_ = nullptr;
+    }
+}
+
+void CastTraceRecorder::Record(TraceRecordType type, uint16_t tag, const uint8_t *data, uint32_t length)
+{
+    if (!IsEnabled()) {
+        return;
+    }
+    if (data == nullptr) {
+        length = 0;
+    }
+
+    uint64_t timestamp = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start_).count());
+    uint8_t header[RECORD_HEADER_LEN];
+    header[0] = static_cast<uint8_t>(type);
+    PutLe(header + 1, tag, sizeof(uint16_t));
+    PutLe(header + 1 + sizeof(uint16_t), timestamp, sizeof(uint64_t));
+    PutLe(header + 1 + sizeof(uint16_t) + sizeof(uint64_t), length, sizeof(uint32_t));
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (file_ == nullptr) {
+        return;
+    }
+    if (size_ + RECORD_HEADER_LEN + length > MAX_TRACE_SIZE) {
+        CLOGW("trace file is full, stop recording");
+        enabled_ = false;
+        fclose(file_);
+        file_ = nullptr;
+        return;
+    }
+    size_ += fwrite(header, 1, RECORD_HEADER_LEN, file_);
+    if (length > 0) {
+        size_ += fwrite(data, 1, length, file_);
+    }
+}
+
+void CastTraceRecorder::RecordMessage(int what, int arg1, int arg2)
+{
+    if (!IsEnabled()) {
+        return;
+    }
+    uint8_t payload[MESSAGE_PAYLOAD_LEN];
+    PutLe(payload, static_cast<uint32_t>(what), sizeof(int32_t));
+    PutLe(payload + sizeof(int32_t), static_cast<uint32_t>(arg1), sizeof(int32_t));
+    PutLe(payload + 2 * sizeof(int32_t), static_cast<uint32_t>(arg2), sizeof(int32_t));
+    Record(TraceRecordType::HANDLER_MESSAGE, 0, payload, MESSAGE_PAYLOAD_LEN);
+}
+
+void CastTraceRecorder::RecordState(uint16_t state)
+{
+    Record(TraceRecordType::SESSION_STATE, state, nullptr, 0);
+}
+
+bool CastTraceReplayer::Load()
+{
+    FILE *file = fopen(path_.c_str(), "rb");
+    if (file == nullptr) {
+        CLOGE("open trace file failed, errno = %{public}d", errno);
+        return false;
+    }
+
+    // Bound every record by what is left of the file, a corrupt length must not turn into a huge allocation.
+    int64_t fileSize = -1;
+    if (fseek(file, 0, SEEK_END) == 0) {
+        fileSize = ftell(file);
+    }
+    if (fileSize < 0 || static_cast<uint64_t>(fileSize) > MAX_TRACE_SIZE || fseek(file, 0, SEEK_SET) != 0) {
+        CLOGE("invalid trace file size %{public}" PRId64, fileSize);
+        fclose(file);
+        return false;
+    }
+
+    uint8_t header[sizeof(TRACE_MAGIC) + 1] = {};
+    if (fread(header, 1, sizeof(header), file) != sizeof(header) ||
+        memcmp(header, TRACE_MAGIC, sizeof(TRACE_MAGIC)) != 0 || header[sizeof(TRACE_MAGIC)] != TRACE_VERSION) {
+        CLOGE("invalid trace file");
+        fclose(file);
+        return false;
+    }
+
+    records_.clear();
+    uint64_t offset = sizeof(header);
+    uint8_t recordHeader[RECORD_HEADER_LEN];
+    while (fread(recordHeader, 1, RECORD_HEADER_LEN, file) == RECORD_HEADER_LEN) {
+        offset += RECORD_HEADER_LEN;
+        TraceRecord record;
+        record.type = static_cast<TraceRecordType>(recordHeader[0]);
+        record.tag = static_cast<uint16_t>(GetLe(recordHeader + 1, sizeof(uint16_t)));
+        record.timestampUs = GetLe(recordHeader + 1 + sizeof(uint16_t), sizeof(uint64_t));
+        auto length = static_cast<uint32_t>(GetLe(recordHeader + 1 + sizeof(uint16_t) + sizeof(uint64_t),
+            sizeof(uint32_t)));
+        if (length > static_cast<uint64_t>(fileSize) - offset) {
+            CLOGW("truncated trace record, length %{public}u, stop loading", length);
+            break;
+        }
+        record.payload.resize(length);
+        if (length > 0 && fread(record.payload.data(), 1, length, file) != length) {
+            CLOGW("truncated trace record, stop loading");
+            break;
+        }
+        offset += length;
+        records_.push_back(std::move(record));
+    }
+    fclose(file);
+    CLOGI("load %{public}zu trace records", records_.size());
+    return true;
+}
+
+void CastTraceReplayer::Replay(const std::function<void(const TraceRecord &record)> &consumer, uint64_t drainUs)
+{
+    nowUs_ = 0;
+    for (const auto &record : records_) {
+        RunTasksUntil(record.timestampUs);
+        nowUs_ = std::max(nowUs_, record.timestampUs);
+        if (consumer) {
+            consumer(record);
+        }
+    }
+    RunTasksUntil(nowUs_ + drainUs);
+    tasks_.clear();
+}
+
+void CastTraceReplayer::Schedule(uint64_t atUs, std::function<void()> task)
+{
+    if (!task) {
+        return;
+    }
+    // Equal times keep the order they were scheduled in.
+    tasks_.emplace(std::max(atUs, nowUs_), std::move(task));
+}
+
+void CastTraceReplayer::RunTasksUntil(uint64_t timeUs)
+{
+    while (!tasks_.empty() && tasks_.begin()->first <= timeUs) {
+        auto iter = tasks_.begin();
+        nowUs_ = iter->first;
+        auto task = std::move(iter->second);
+        tasks_.erase(iter);
+        task();
+    }
+}
+
+std::map<uint16_t, uint64_t> CastTraceReplayer::GetStateDwellTimeUs() const
+{
+    std::map<uint16_t, uint64_t> dwellTime;
+    const TraceRecord *current = nullptr;
+    for (const auto &record : records_) {
+        if (record.type != TraceRecordType::SESSION_STATE) {
+            continue;
+        }
+        if (current != nullptr) {
+            dwellTime[current->tag] += record.timestampUs - current->timestampUs;
+        }
+        current = &record;
+    }
+    if (current != nullptr && !records_.empty()) {
+        dwellTime[current->tag] += records_.back().timestampUs - current->timestampUs;
+    }
+    return dwellTime;
+}
+
+uint64_t CastTraceReplayer::GetNegotiationTimeUs(uint16_t targetState) const
+{
+    const TraceRecord *firstRtsp = nullptr;
+    for (const auto &record : records_) {
+        bool isRtsp = record.type == TraceRecordType::RTSP_RX || record.type == TraceRecordType::RTSP_TX;
+        if (firstRtsp == nullptr && isRtsp) {
+            firstRtsp = &record;
+        }
+        if (firstRtsp != nullptr && record.type == TraceRecordType::SESSION_STATE && record.tag == targetState) {
+            return record.timestampUs - firstRtsp->timestampUs;
+        }
+    }
+    return 0;
+}
+} // namespace CastEngineService
+} // namespace CastEngine
+} // namespace OHOS
@@ -21,6 +21,7 @@
 #include <cstdint>
 #include "securec.h"
 #include "cast_engine_log.h"
+#include "cast_engine_metrics.h"
 
 namespace OHOS {
 namespace CastEngine {
@@ -398,6 +399,10 @@ std::unique_ptr<uint8_t[]> EncryptDecrypt::EncryptData(int algCode, ConstPacketD
         CLOGE("encrypt not CTR for extension");
         return nullptr;
     }
+    static auto &encryptTime = CastEngineMetrics::GetInstance().RegisterHistogram(METRIC_CRYPTO_ENCRYPT_US);
+    static auto &cryptoBytes = CastEngineMetrics::GetInstance().RegisterCounter(METRIC_CRYPTO_BYTES);
+    MetricScopedTimer timer(encryptTime);
+    cryptoBytes.Add(inputData.length);
     uint8_t sessionIV[AES_IV_LEN] = {0};
     GetAESIv(sessionIV, AES_IV_LEN);
 
@@ -450,6 +455,10 @@ std::unique_ptr<uint8_t[]> EncryptDecrypt::DecryptData(int algCode, ConstPacketD
         CLOGE("decrypt para error, length:%{public}d", inputData.length);
         return nullptr;
     }
+    static auto &decryptTime = CastEngineMetrics::GetInstance().RegisterHistogram(METRIC_CRYPTO_DECRYPT_US);
+    static auto &cryptoBytes = CastEngineMetrics::GetInstance().RegisterCounter(METRIC_CRYPTO_BYTES);
+    MetricScopedTimer timer(decryptTime);
+    cryptoBytes.Add(inputData.length);
     int32_t ret = memcpy_s(sessionIV, AES_IV_LEN, inputData.data, AES_KEY_SIZE);
     if (ret != 0) {
         CLOGE("memcpy_s failed");
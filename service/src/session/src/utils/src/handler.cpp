@@ -17,6 +17,8 @@
  */
 
 #include "handler.h"
+#include "cast_engine_metrics.h"
+#include "cast_trace.h"
 #include "utils.h"
 
 namespace OHOS {
@@ -26,6 +28,9 @@ Handler::Handler() : stop_(false), stopWhenEmpty_(false)
 {
     looper_ = std::thread([this]() {
         Utils::SetThreadName("Handler");
+        auto &messages = CastEngineMetrics::GetInstance().RegisterCounter(METRIC_HANDLER_MESSAGES);
+        auto &latency = CastEngineMetrics::GetInstance().RegisterHistogram(METRIC_HANDLER_LATENCY_US);
+        auto &handleTime = CastEngineMetrics::GetInstance().RegisterHistogram(METRIC_HANDLER_HANDLE_US);
         for (;;) {
             Message msg;
             {
@@ -55,6 +60,12 @@ Handler::Handler() : stop_(false), stopWhenEmpty_(false)
                     continue;
                 }
             }
+            auto lateness = std::chrono::system_clock::now() - msg.when_;
+            messages.Add();
+            latency.Record(static_cast<uint64_t>(std::max<int64_t>(0,
+                std::chrono::duration_cast<std::chrono::microseconds>(lateness).count())));
+            CastTraceRecorder::GetInstance().RecordMessage(msg.what_, msg.arg1_, msg.arg2_);
+            MetricScopedTimer timer(handleTime);
             this->HandleMessageInner(msg);
         }
     });
@@ -22,6 +22,7 @@
 #include <openssl/bio.h>
 #include <openssl/evp.h>
 #include <openssl/buffer.h>
+#include <sstream>
 #include <sys/prctl.h>
 #include <sys/time.h>
 
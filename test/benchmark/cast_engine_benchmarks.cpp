@@ -0,0 +1,1119 @@
+/*
+ * Copyright (C) 2023-2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * Description: host benchmarks of the platform independent hot paths of the cast engine service, with json output.
+ * Author: zhangge
+ * Create: 2023-06-05
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+
+#include "cast_engine_common_helper.h"
+#include "cast_engine_errors.h"
+#include "cast_engine_metrics.h"
+#include "cast_local_file_channel_client.h"
+#include "cast_local_file_channel_server.h"
+#include "encrypt_decrypt.h"
+#include "handler.h"
+#include "i_cast_stream_manager.h"
+#include "json.hpp"
+#include "local_data_source.h"
+#include "message_parcel.h"
+#include "rtsp_package.h"
+#include "rtsp_parse.h"
+#include "stream_player_impl_proxy.h"
+#include "stream_player_state_mirror.h"
+#include "tcp_connection.h"
+
+namespace OHOS {
+namespace CastEngine {
+namespace CastEngineService {
+namespace {
+using nlohmann::json;
+using Clock = std::chrono::steady_clock;
+using CastSessionRtsp::ParamInfo;
+using CastSessionRtsp::RtspEncap;
+using CastSessionRtsp::RtspParse;
+
+constexpr int WAIT_TIMEOUT_MS = 5000;
+constexpr char LOOPBACK_IP[] = "127.0.0.1";
+
+struct BenchOptions {
+    bool isQuick{ false };
+    std::string filter;
+    std::string outFile;
+};
+
+struct BenchResult {
+    std::string name;
+    bool isOk{ true };
+    uint64_t iterations{ 0 };
+    double nsPerOp{ 0 };
+    // 0 when the benchmark does not move payload.
+    double mbPerSec{ 0 };
+    json extra = json::object();
+};
+
+double ElapsedNs(Clock::time_point start)
+{
+    return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count());
+}
+
+BenchResult MakeResult(const std::string &name, uint64_t iterations, double elapsedNs, uint64_t bytes = 0)
+{
+    BenchResult result;
+    result.name = name;
+    result.iterations = iterations;
+    result.nsPerOp = iterations == 0 ? 0 : elapsedNs / static_cast<double>(iterations);
+    if (bytes > 0 && elapsedNs > 0) {
+        result.mbPerSec = static_cast<double>(bytes) / (1024.0 * 1024.0) / (elapsedNs / 1e9);
+    }
+    return result;
+}
+
+BenchResult MakeFailure(const std::string &name, const std::string &reason)
+{
+    BenchResult result;
+    result.name = name;
+    result.isOk = false;
+    result.extra["error"] = reason;
+    return result;
+}
+
+// Runs the body iterations times and keeps the compiler from dropping it through the returned checksum.
+template<typename Body>
+BenchResult RunLoop(const std::string &name, uint64_t iterations, uint64_t bytesPerOp, Body body)
+{
+    uint64_t checksum = 0;
+    auto start = Clock::now();
+    for (uint64_t i = 0; i < iterations; i++) {
+        checksum += body(i);
+    }
+    auto result = MakeResult(name, iterations, ElapsedNs(start), bytesPerOp * iterations);
+    result.extra["checksum"] = checksum;
+    return result;
+}
+
+/*
+ * rtsp
+ */
+void BenchRtsp(const BenchOptions &options, std::vector<BenchResult> &results)
+{
+    uint64_t iterations = options.isQuick ? 2000 : 200000;
+    ParamInfo param;
+    param.SetVersion(1.0);
+
+    results.push_back(RunLoop("rtsp.encode.set_parameter_m4", iterations, 0, [&param](uint64_t i) {
+        return RtspEncap::EncapSetParameterM4Request(param, 1.0, LOOPBACK_IP, static_cast<int>(i)).size();
+    }));
+    results.push_back(RunLoop("rtsp.encode.play", iterations, 0, [](uint64_t i) {
+        return RtspEncap::EncapPlayRequest(static_cast<int>(i), "rtsp://localhost/hisight", 5000).size();
+    }));
+
+    const std::string m4 = RtspEncap::EncapSetParameterM4Request(param, 1.0, LOOPBACK_IP, 4);
+    results.push_back(RunLoop("rtsp.parse.set_parameter_m4", iterations, m4.size(), [&m4](uint64_t) {
+        RtspParse msg;
+        RtspParse::ParseMsg(m4, msg);
+        return static_cast<uint64_t>(msg.GetSeq());
+    }));
+    const std::string option = RtspEncap::EncapResponseOption(1.0, 1);
+    results.push_back(RunLoop("rtsp.parse.option_response", iterations, option.size(), [&option](uint64_t) {
+        RtspParse msg;
+        RtspParse::ParseMsg(option, msg);
+        return static_cast<uint64_t>(msg.GetStatusCode());
+    }));
+}
+
+/*
+ * crypto
+ */
+void BenchCipher(const std::string &name, int algCode, size_t size, uint64_t iterations,
+    std::vector<BenchResult> &results)
+{
+    std::vector<uint8_t> key(EncryptDecrypt::AES_KEY_LEN, 0x5a);
+    std::vector<uint8_t> plain(size);
+    for (size_t i = 0; i < size; i++) {
+        plain[i] = static_cast<uint8_t>(i * 31);
+    }
+    auto &crypto = EncryptDecrypt::GetInstance();
+    ConstPacketData keyData = { key.data(), static_cast<int>(key.size()) };
+    ConstPacketData plainData = { plain.data(), static_cast<int>(plain.size()) };
+
+    int cipherLen = 0;
+    auto cipher = crypto.EncryptData(algCode, keyData, plainData, cipherLen);
+    int decryptedLen = 0;
+    auto decrypted = cipher ?
+        crypto.DecryptData(algCode, keyData, { cipher.get(), cipherLen }, decryptedLen) : nullptr;
+    if (!decrypted || decryptedLen != static_cast<int>(size) || memcmp(decrypted.get(), plain.data(), size) != 0) {
+        results.push_back(MakeFailure(name, "round trip mismatch"));
+        return;
+    }
+
+    results.push_back(RunLoop(name + ".encrypt", iterations, size, [&](uint64_t) {
+        int outLen = 0;
+        auto out = crypto.EncryptData(algCode, keyData, plainData, outLen);
+        return static_cast<uint64_t>(out ? outLen : 0);
+    }));
+    ConstPacketData cipherData = { cipher.get(), cipherLen };
+    results.push_back(RunLoop(name + ".decrypt", iterations, size, [&](uint64_t) {
+        int outLen = 0;
+        auto out = crypto.DecryptData(algCode, keyData, cipherData, outLen);
+        return static_cast<uint64_t>(out ? outLen : 0);
+    }));
+}
+
+void BenchCrypto(const BenchOptions &options, std::vector<BenchResult> &results)
+{
+    constexpr size_t smallSize = 1024;
+    constexpr size_t largeSize = 64 * 1024;
+    uint64_t smallIterations = options.isQuick ? 1000 : 100000;
+    uint64_t largeIterations = options.isQuick ? 100 : 10000;
+    BenchCipher("crypto.aes_ctr.1k", EncryptDecrypt::CTR_CODE, smallSize, smallIterations, results);
+    BenchCipher("crypto.aes_ctr.64k", EncryptDecrypt::CTR_CODE, largeSize, largeIterations, results);
+    BenchCipher("crypto.aes_gcm.1k", EncryptDecrypt::GCM_CODE, smallSize, smallIterations, results);
+    BenchCipher("crypto.aes_gcm.64k", EncryptDecrypt::GCM_CODE, largeSize, largeIterations, results);
+}
+
+/*
+ * handler
+ */
+class CountingHandler : public Handler {
+public:
+    void HandleMessage(const Message &msg) override
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        handled_++;
+        cond_.notify_all();
+    }
+
+    bool WaitHandled(uint64_t count)
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        return cond_.wait_for(lock, std::chrono::milliseconds(WAIT_TIMEOUT_MS),
+            [this, count] { return handled_ >= count; });
+    }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable cond_;
+    uint64_t handled_{ 0 };
+};
+
+void BenchHandler(const BenchOptions &options, std::vector<BenchResult> &results)
+{
+    uint64_t iterations = options.isQuick ? 500 : 20000;
+    {
+        // One message in flight at a time: the cost of a post and the wake up of the looper.
+        CountingHandler handler;
+        auto start = Clock::now();
+        for (uint64_t i = 1; i <= iterations; i++) {
+            handler.SendCastMessage(static_cast<int>(i));
+            if (!handler.WaitHandled(i)) {
+                results.push_back(MakeFailure("handler.ping_pong", "message not handled"));
+                return;
+            }
+        }
+        results.push_back(MakeResult("handler.ping_pong", iterations, ElapsedNs(start)));
+    }
+    {
+        // Distinct messages, equal ones replace each other in the queue.
+        CountingHandler handler;
+        uint64_t burst = options.isQuick ? 200 : 2000;
+        auto start = Clock::now();
+        for (uint64_t i = 1; i <= burst; i++) {
+            handler.SendCastMessage(static_cast<int>(i));
+        }
+        if (!handler.WaitHandled(burst)) {
+            results.push_back(MakeFailure("handler.burst", "messages not handled"));
+            return;
+        }
+        results.push_back(MakeResult("handler.burst", burst, ElapsedNs(start)));
+    }
+}
+
+/*
+ * tcp loopback
+ */
+class OpenedConnectionListener : public ConnectionListener {
+public:
+    bool OnConnectionOpened(std::shared_ptr<Channel> channel) override
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        channel_ = channel;
+        cond_.notify_all();
+        return true;
+    }
+
+    std::shared_ptr<Channel> WaitChannel()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cond_.wait_for(lock, std::chrono::milliseconds(WAIT_TIMEOUT_MS), [this] { return channel_ != nullptr; });
+        return channel_;
+    }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable cond_;
+    std::shared_ptr<Channel> channel_;
+};
+
+// A listening and a connecting TcpConnection on the loopback, both receiving.
+class TcpLoopback {
+public:
+    ~TcpLoopback()
+    {
+        if (client_) {
+            client_->CloseConnection();
+        }
+        if (server_) {
+            server_->CloseConnection();
+        }
+    }
+
+    bool Open(std::shared_ptr<IChannelListener> serverListener, std::shared_ptr<IChannelListener> clientListener)
+    {
+        ChannelRequest request;
+        request.moduleType = ModuleType::STREAM;
+        request.linkType = ChannelLinkType::TCP;
+        request.isReceiver = true;
+        request.localDeviceInfo.ipAddress = LOOPBACK_IP;
+        request.remoteDeviceInfo.ipAddress = LOOPBACK_IP;
+
+        server_ = std::make_shared<TcpConnection>();
+        server_->SetConnectionListener(serverOpened_);
+        int port = server_->StartListen(request, serverListener);
+        if (port <= 0) {
+            return false;
+        }
+        request.remotePort = port;
+        client_ = std::make_shared<TcpConnection>();
+        client_->SetConnectionListener(clientOpened_);
+        client_->StartConnection(request, clientListener);
+        serverChannel_ = serverOpened_->WaitChannel();
+        clientChannel_ = clientOpened_->WaitChannel();
+        return serverChannel_ != nullptr && clientChannel_ != nullptr;
+    }
+
+    std::shared_ptr<Channel> GetServerChannel() const
+    {
+        return serverChannel_;
+    }
+
+    std::shared_ptr<Channel> GetClientChannel() const
+    {
+        return clientChannel_;
+    }
+
+private:
+    std::shared_ptr<OpenedConnectionListener> serverOpened_ = std::make_shared<OpenedConnectionListener>();
+    std::shared_ptr<OpenedConnectionListener> clientOpened_ = std::make_shared<OpenedConnectionListener>();
+    std::shared_ptr<TcpConnection> server_;
+    std::shared_ptr<TcpConnection> client_;
+    std::shared_ptr<Channel> serverChannel_;
+    std::shared_ptr<Channel> clientChannel_;
+};
+
+class ByteCountingListener : public IChannelListener {
+public:
+    void OnDataReceived(const uint8_t *buffer, unsigned int length, long timeCost) override
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        bytes_ += length;
+        frames_++;
+        cond_.notify_all();
+    }
+
+    bool WaitFrames(uint64_t frames)
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        return cond_.wait_for(lock, std::chrono::milliseconds(WAIT_TIMEOUT_MS),
+            [this, frames] { return frames_ >= frames; });
+    }
+
+    uint64_t GetBytes()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return bytes_;
+    }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable cond_;
+    uint64_t bytes_{ 0 };
+    uint64_t frames_{ 0 };
+};
+
+// Sends every frame back on the channel it is given once the connection is up.
+class EchoListener : public IChannelListener {
+public:
+    void SetChannel(std::shared_ptr<Channel> channel)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        channel_ = channel;
+    }
+
+    void OnDataReceived(const uint8_t *buffer, unsigned int length, long timeCost) override
+    {
+        std::shared_ptr<Channel> channel;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            channel = channel_;
+        }
+        if (channel) {
+            channel->Send(buffer, static_cast<int>(length));
+        }
+    }
+
+private:
+    std::mutex mutex_;
+    std::shared_ptr<Channel> channel_;
+};
+
+void BenchTcpThroughput(const std::string &name, size_t frameSize, uint64_t totalBytes,
+    std::vector<BenchResult> &results)
+{
+    auto receiver = std::make_shared<ByteCountingListener>();
+    TcpLoopback loopback;
+    if (!loopback.Open(receiver, std::make_shared<IChannelListener>())) {
+        results.push_back(MakeFailure(name, "loopback not connected"));
+        return;
+    }
+    std::vector<uint8_t> frame(frameSize, 0xa5);
+    uint64_t frames = std::max<uint64_t>(1, totalBytes / frameSize);
+    auto start = Clock::now();
+    for (uint64_t i = 0; i < frames; i++) {
+        if (!loopback.GetClientChannel()->Send(frame.data(), static_cast<int>(frame.size()))) {
+            results.push_back(MakeFailure(name, "send failed"));
+            return;
+        }
+    }
+    if (!receiver->WaitFrames(frames)) {
+        results.push_back(MakeFailure(name, "frames not received"));
+        return;
+    }
+    results.push_back(MakeResult(name, frames, ElapsedNs(start), receiver->GetBytes()));
+}
+
+void BenchTcp(const BenchOptions &options, std::vector<BenchResult> &results)
+{
+    uint64_t totalBytes = options.isQuick ? 8 * 1024 * 1024 : 512 * 1024 * 1024;
+    BenchTcpThroughput("tcp.loopback.throughput.1k", 1024, totalBytes / 8, results);
+    BenchTcpThroughput("tcp.loopback.throughput.64k", 64 * 1024, totalBytes, results);
+
+    const std::string name = "tcp.loopback.round_trip.64b";
+    auto echo = std::make_shared<EchoListener>();
+    auto receiver = std::make_shared<ByteCountingListener>();
+    TcpLoopback loopback;
+    if (!loopback.Open(echo, receiver)) {
+        results.push_back(MakeFailure(name, "loopback not connected"));
+        return;
+    }
+    echo->SetChannel(loopback.GetServerChannel());
+    std::vector<uint8_t> frame(64, 0x3c);
+    uint64_t iterations = options.isQuick ? 200 : 20000;
+    auto start = Clock::now();
+    for (uint64_t i = 1; i <= iterations; i++) {
+        loopback.GetClientChannel()->Send(frame.data(), static_cast<int>(frame.size()));
+        if (!receiver->WaitFrames(i)) {
+            results.push_back(MakeFailure(name, "echo not received"));
+            return;
+        }
+    }
+    results.push_back(MakeResult(name, iterations, ElapsedNs(start)));
+}
+
+/*
+ * local data source: LocalDataSource -> file channel client -> tcp loopback -> file channel server -> fd
+ */
+class TempFile {
+public:
+    explicit TempFile(size_t size)
+    {
+        char path[] = "/tmp/cast_engine_benchmark_XXXXXX";
+        fd_ = mkstemp(path);
+        if (fd_ < 0) {
+            return;
+        }
+        unlink(path);
+        std::vector<uint8_t> block(1024 * 1024);
+        for (size_t offset = 0; offset < size; offset += block.size()) {
+            size_t len = std::min(block.size(), size - offset);
+            for (size_t i = 0; i < len; i++) {
+                block[i] = PatternAt(offset + i);
+            }
+            if (write(fd_, block.data(), len) != static_cast<ssize_t>(len)) {
+                close(fd_);
+                fd_ = -1;
+                return;
+            }
+        }
+    }
+
+    ~TempFile()
+    {
+        if (fd_ >= 0) {
+            close(fd_);
+        }
+    }
+
+    static uint8_t PatternAt(size_t offset)
+    {
+        return static_cast<uint8_t>((offset * 131) >> 3);
+    }
+
+    int GetFd() const
+    {
+        return fd_;
+    }
+
+private:
+    int fd_{ -1 };
+};
+
+void BenchLocalDataSource(const BenchOptions &options, std::vector<BenchResult> &results)
+{
+    const std::string name = "local_data_source.sequential_read.256k";
+    size_t fileSize = options.isQuick ? 8 * 1024 * 1024 : 128 * 1024 * 1024;
+    TempFile file(fileSize);
+    if (file.GetFd() < 0) {
+        results.push_back(MakeFailure(name, "temp file not created"));
+        return;
+    }
+
+    auto server = std::make_shared<CastLocalFileChannelServer>();
+    auto client = std::make_shared<CastLocalFileChannelClient>(nullptr);
+    MediaInfo mediaInfo;
+    mediaInfo.mediaUrl = std::to_string(file.GetFd());
+    if (!server->AddLocalFileInfo(mediaInfo)) {
+        results.push_back(MakeFailure(name, "file not registered"));
+        return;
+    }
+    TcpLoopback loopback;
+    if (!loopback.Open(server->GetChannelListener(), client->GetChannelListener())) {
+        results.push_back(MakeFailure(name, "loopback not connected"));
+        return;
+    }
+    server->AddChannel(loopback.GetServerChannel());
+    client->AddChannel(loopback.GetClientChannel());
+
+    auto source = std::make_shared<LocalDataSource>(mediaInfo.mediaUrl, static_cast<int64_t>(fileSize), client);
+    source->Start();
+    constexpr uint32_t readSize = 256 * 1024;
+    std::vector<uint8_t> buffer(readSize);
+    uint64_t reads = 0;
+    uint64_t misses = 0;
+    auto start = Clock::now();
+    for (int64_t pos = 0; pos < static_cast<int64_t>(fileSize);) {
+        int32_t readBytes = source->ReadBuffer(buffer.data(), readSize, pos);
+        reads++;
+        if (readBytes <= 0) {
+            // Nothing cached yet, the read waited for the data it requested.
+            if (++misses > fileSize / readSize * 4 + 100) {
+                results.push_back(MakeFailure(name, "data not received"));
+                source->Stop();
+                return;
+            }
+            continue;
+        }
+        for (int32_t i = 0; i < readBytes; i += 4096) {
+            if (buffer[i] != TempFile::PatternAt(static_cast<size_t>(pos + i))) {
+                results.push_back(MakeFailure(name, "data mismatch"));
+                source->Stop();
+                return;
+            }
+        }
+        pos += readBytes;
+    }
+    auto result = MakeResult(name, reads, ElapsedNs(start), fileSize);
+    result.extra["empty_reads"] = misses;
+    results.push_back(result);
+    source->Stop();
+    server->RemoveChannel(loopback.GetServerChannel());
+    client->RemoveChannel(loopback.GetClientChannel());
+}
+
+/*
+ * local file prepare: the reads a demuxer makes to open a local file, counted in file channel round trips
+ */
+struct ProbeRead {
+    // From the end of the file when negative.
+    int64_t offset;
+    uint32_t length;
+};
+
+struct ProbePattern {
+    const char *name;
+    std::vector<ProbeRead> reads;
+};
+
+// MP4 with the moov box at the end, as most recorders write it, and MKV with the cues behind the clusters.
+const std::vector<ProbePattern> PROBE_PATTERNS = {
+    { "mp4", { { 0, 4096 }, { 4096, 16 }, { -256 * 1024, 256 * 1024 }, { 40 * 1024, 64 * 1024 } } },
+    { "mkv", { { 0, 4096 }, { 4096, 64 * 1024 }, { -64 * 1024, 64 * 1024 }, { 128 * 1024, 256 * 1024 } } },
+};
+
+bool ReadChecked(LocalDataSource &source, int64_t pos, uint32_t length, uint64_t &emptyReads)
+{
+    std::vector<uint8_t> buffer(length);
+    for (uint32_t done = 0; done < length;) {
+        int32_t readBytes = source.ReadBuffer(buffer.data() + done, length - done, pos + done);
+        if (readBytes <= 0) {
+            if (++emptyReads > WAIT_TIMEOUT_MS) {
+                return false;
+            }
+            continue;
+        }
+        for (int32_t i = 0; i < readBytes; i++) {
+            if (buffer[done + i] != TempFile::PatternAt(static_cast<size_t>(pos + done + i))) {
+                return false;
+            }
+        }
+        done += static_cast<uint32_t>(readBytes);
+    }
+    return true;
+}
+
+// Per range is the sink against a source that does not take range lists, each range then costs its own request.
+void BenchLocalFilePrepare(const ProbePattern &pattern, bool isRangeList, uint64_t iterations,
+    std::vector<BenchResult> &results)
+{
+    const std::string name = std::string("local_data_source.prepare.") + pattern.name +
+        (isRangeList ? ".range_list" : ".per_range");
+    constexpr size_t fileSize = 16 * 1024 * 1024;
+    TempFile file(fileSize);
+    if (file.GetFd() < 0) {
+        results.push_back(MakeFailure(name, "temp file not created"));
+        return;
+    }
+    auto server = std::make_shared<CastLocalFileChannelServer>();
+    auto client = std::make_shared<CastLocalFileChannelClient>(nullptr);
+    MediaInfo mediaInfo;
+    mediaInfo.mediaUrl = std::to_string(file.GetFd());
+    if (!server->AddLocalFileInfo(mediaInfo)) {
+        results.push_back(MakeFailure(name, "file not registered"));
+        return;
+    }
+    TcpLoopback loopback;
+    if (!loopback.Open(server->GetChannelListener(), client->GetChannelListener())) {
+        results.push_back(MakeFailure(name, "loopback not connected"));
+        return;
+    }
+    server->AddChannel(loopback.GetServerChannel());
+    client->AddChannel(loopback.GetClientChannel());
+
+    auto &requests = CastEngineMetrics::GetInstance().RegisterCounter(METRIC_DATA_SOURCE_REQUESTS);
+    uint64_t roundTrips = 0;
+    uint64_t emptyReads = 0;
+    bool isOk = true;
+    auto start = Clock::now();
+    for (uint64_t i = 0; i < iterations && isOk; i++) {
+        LocalFilePreload preload;
+        server->GetPreloadData(mediaInfo.mediaUrl, true, preload);
+        preload.isMultiRangeSupported = isRangeList;
+        client->SetPreloadData(mediaInfo.mediaUrl, preload);
+        // A new source per prepare, as the player makes one per item.
+        auto source = std::make_shared<LocalDataSource>(mediaInfo.mediaUrl, static_cast<int64_t>(fileSize), client);
+        source->Start();
+        int64_t requestsBefore = requests.Value();
+        source->Prefetch();
+        for (const auto &read : pattern.reads) {
+            int64_t pos = read.offset < 0 ? static_cast<int64_t>(fileSize) + read.offset : read.offset;
+            if (!ReadChecked(*source, pos, read.length, emptyReads)) {
+                isOk = false;
+                break;
+            }
+        }
+        roundTrips += static_cast<uint64_t>(requests.Value() - requestsBefore);
+        source->Stop();
+    }
+    if (isOk) {
+        auto result = MakeResult(name, iterations, ElapsedNs(start));
+        result.extra["round_trips_per_prepare"] = static_cast<double>(roundTrips) / static_cast<double>(iterations);
+        result.extra["empty_reads"] = emptyReads;
+        results.push_back(result);
+    } else {
+        results.push_back(MakeFailure(name, "probe read failed"));
+    }
+    server->RemoveChannel(loopback.GetServerChannel());
+    client->RemoveChannel(loopback.GetClientChannel());
+}
+
+void BenchLocalFilePrepare(const BenchOptions &options, std::vector<BenchResult> &results)
+{
+    uint64_t iterations = options.isQuick ? 3 : 50;
+    for (const auto &pattern : PROBE_PATTERNS) {
+        BenchLocalFilePrepare(pattern, false, iterations, results);
+        BenchLocalFilePrepare(pattern, true, iterations, results);
+    }
+}
+
+/*
+ * json codecs of the stream actions
+ */
+class CapturingStreamListener : public ICastStreamListener {
+public:
+    bool SendActionToPeers(int action, const std::string &param) override
+    {
+        lastAction_ = param;
+        return true;
+    }
+    bool TransferToStreamMode() override
+    {
+        return true;
+    }
+    bool DisconnectSession(std::string deviceId) override
+    {
+        return true;
+    }
+    void OnRenderReady(bool isReady) override {}
+    void OnEvent(EventId eventId, const std::string &data) override {}
+
+    std::string lastAction_;
+};
+
+class BenchStreamManager : public ICastStreamManager {
+public:
+    explicit BenchStreamManager(std::shared_ptr<ICastStreamListener> listener)
+    {
+        streamListener_ = listener;
+        streamActionProcessor_[ACTION_LOAD] = [this](const json &data) {
+            MediaInfo mediaInfo;
+            bool isOk = ParseMediaInfo(data, mediaInfo, false);
+            std::lock_guard<std::mutex> lock(mutex_);
+            handled_++;
+            parsed_ += isOk ? 1 : 0;
+            cond_.notify_all();
+            return isOk;
+        };
+    }
+
+    sptr<IStreamPlayerIpc> CreateStreamPlayer(const std::function<void(void)> &releaseCallback) override
+    {
+        return nullptr;
+    }
+
+    bool PlayAfterSwitchToStream() override
+    {
+        return true;
+    }
+
+    bool SendLoad(const MediaInfo &mediaInfo)
+    {
+        json data;
+        EncapMediaInfo(mediaInfo, data, false);
+        return SendControlAction(ACTION_LOAD, data);
+    }
+
+    bool WaitHandled(uint64_t count)
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        return cond_.wait_for(lock, std::chrono::milliseconds(WAIT_TIMEOUT_MS),
+            [this, count] { return handled_ >= count; });
+    }
+
+    uint64_t GetParsed()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return parsed_;
+    }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable cond_;
+    uint64_t handled_{ 0 };
+    uint64_t parsed_{ 0 };
+};
+
+MediaInfo MakeMediaInfo()
+{
+    MediaInfo mediaInfo;
+    mediaInfo.mediaId = "media-0001";
+    mediaInfo.mediaName = "A fairly ordinary track name";
+    mediaInfo.mediaUrl = "https://media.example.com/library/album/track-0001.flac?token=0123456789abcdef";
+    mediaInfo.mediaType = "AUDIO";
+    mediaInfo.mediaSize = 31457280;
+    mediaInfo.duration = 245000;
+    mediaInfo.albumCoverUrl = "https://media.example.com/library/album/cover-1024.jpg";
+    mediaInfo.albumTitle = "Album title";
+    mediaInfo.mediaArtist = "Artist";
+    mediaInfo.lrcUrl = "https://media.example.com/library/album/track-0001.lrc";
+    mediaInfo.lrcContent = std::string(2048, 'l');
+    mediaInfo.appIconUrl = "https://media.example.com/app/icon-192.png";
+    mediaInfo.appName = "Player";
+    return mediaInfo;
+}
+
+void BenchJson(const BenchOptions &options, std::vector<BenchResult> &results)
+{
+    uint64_t iterations = options.isQuick ? 500 : 50000;
+    auto listener = std::make_shared<CapturingStreamListener>();
+    BenchStreamManager manager(listener);
+    MediaInfo mediaInfo = MakeMediaInfo();
+
+    results.push_back(RunLoop("json.encode.load_action", iterations, 0, [&manager, &listener, &mediaInfo](uint64_t) {
+        manager.SendLoad(mediaInfo);
+        return listener->lastAction_.size();
+    }));
+
+    const std::string action = listener->lastAction_;
+    auto start = Clock::now();
+    for (uint64_t i = 0; i < iterations; i++) {
+        manager.ProcessActionsEvent(ICastStreamManager::MODULE_EVENT_ID_CONTROL_EVENT, action);
+    }
+    if (!manager.WaitHandled(iterations) || manager.GetParsed() != iterations) {
+        results.push_back(MakeFailure("json.decode.load_action", "actions not parsed"));
+        return;
+    }
+    auto decode = MakeResult("json.decode.load_action", iterations, ElapsedNs(start), action.size() * iterations);
+    decode.extra["action_bytes"] = action.size();
+    results.push_back(decode);
+}
+
+/*
+ * parcel
+ */
+template<typename Write, typename Read>
+void BenchParcelRoundTrip(const std::string &name, uint64_t iterations, Write write, Read read,
+    std::vector<BenchResult> &results)
+{
+    MessageParcel probe;
+    if (!write(probe) || !read(probe) || probe.GetReadableBytes() != 0) {
+        results.push_back(MakeFailure(name, "round trip mismatch"));
+        return;
+    }
+    size_t wireBytes = probe.GetDataSize();
+    auto result = RunLoop(name, iterations, wireBytes, [&write, &read](uint64_t) {
+        MessageParcel parcel;
+        return static_cast<uint64_t>(write(parcel) && read(parcel));
+    });
+    result.extra["wire_bytes"] = wireBytes;
+    results.push_back(result);
+}
+
+bool IsSameMediaInfo(const MediaInfo &left, const MediaInfo &right)
+{
+    return left.mediaId == right.mediaId && left.mediaName == right.mediaName && left.mediaUrl == right.mediaUrl &&
+        left.mediaType == right.mediaType && left.mediaSize == right.mediaSize && left.duration == right.duration &&
+        left.albumCoverUrl == right.albumCoverUrl && left.lrcContent == right.lrcContent &&
+        left.appName == right.appName;
+}
+
+void BenchParcel(const BenchOptions &options, std::vector<BenchResult> &results)
+{
+    constexpr size_t longLyricsSize = 64 * 1024;
+    constexpr size_t holderLyricsSize = 2 * 1024;
+    constexpr size_t holderItems = 20;
+    uint64_t iterations = options.isQuick ? 500 : 100000;
+
+    MediaInfo plain = MakeMediaInfo();
+    plain.lrcContent.clear();
+    BenchParcelRoundTrip("parcel.media_info.no_lyrics", iterations,
+        [&plain](MessageParcel &parcel) { return WriteMediaInfo(parcel, plain); },
+        [&plain](MessageParcel &parcel) {
+            MediaInfo out;
+            return ReadMediaInfo(parcel, out) && IsSameMediaInfo(out, plain);
+        }, results);
+
+    MediaInfo lyrics = MakeMediaInfo();
+    lyrics.lrcContent = std::string(longLyricsSize, 'l');
+    BenchParcelRoundTrip("parcel.media_info.lyrics_64k", iterations,
+        [&lyrics](MessageParcel &parcel) { return WriteMediaInfo(parcel, lyrics); },
+        [&lyrics](MessageParcel &parcel) {
+            MediaInfo out;
+            return ReadMediaInfo(parcel, out) && IsSameMediaInfo(out, lyrics);
+        }, results);
+
+    // 20 items of 2KB lyrics each, more than 32KB in all, so that the list goes over the inline limit of a blob.
+    MediaInfoHolder holder{ 0, {}, 1000 };
+    for (size_t i = 0; i < holderItems; i++) {
+        MediaInfo item = MakeMediaInfo();
+        item.mediaId = "media-" + std::to_string(i);
+        item.lrcContent = std::string(holderLyricsSize, static_cast<char>('a' + i));
+        holder.mediaInfoList.push_back(item);
+    }
+    BenchParcelRoundTrip("parcel.media_info_holder.20_items", iterations / 10,
+        [&holder](MessageParcel &parcel) { return WriteMediaInfoHolder(parcel, holder); },
+        [&holder](MessageParcel &parcel) {
+            auto out = ReadMediaInfoHolder(parcel);
+            return out != nullptr && out->mediaInfoList.size() == holder.mediaInfoList.size() &&
+                IsSameMediaInfo(out->mediaInfoList.back(), holder.mediaInfoList.back());
+        }, results);
+
+    CastRemoteDevice device{};
+    device.deviceId = "0123456789abcdef0123456789abcdef";
+    device.deviceName = "Living room screen";
+    device.deviceType = DeviceType::DEVICE_CAST_PLUS;
+    device.ipAddress = "192.168.1.20";
+    device.networkId = "fedcba9876543210fedcba9876543210";
+    device.localIpAddress = "192.168.1.10";
+    device.modelName = "Model";
+    device.manufacturerName = "Manufacturer";
+    device.drmCapabilities = { "clearkey", "widevine" };
+    BenchParcelRoundTrip("parcel.cast_remote_device", iterations,
+        [&device](MessageParcel &parcel) { return WriteCastRemoteDevice(parcel, device); },
+        [&device](MessageParcel &parcel) {
+            CastRemoteDevice out;
+            return ReadCastRemoteDevice(parcel, out) && out.deviceId == device.deviceId &&
+                out.deviceName == device.deviceName && out.drmCapabilities == device.drmCapabilities;
+        }, results);
+}
+
+/*
+ * player getters
+ */
+using CastEngineClient::StreamPlayerImplProxy;
+using CastEngineClient::StreamPlayerStateMirror;
+
+constexpr int PLAYER_POSITION = 1000;
+constexpr int PLAYER_DURATION = 245000;
+
+/*
+ * Stand-in for the remote object of the service side player. It answers every request with a success and the one
+ * value it was given, either on the calling thread, which leaves only the marshalling of the proxy, or on a service
+ * thread of its own, which adds the thread hop every binder call has. Neither has the kernel transaction of a real
+ * binder call.
+ */
+class PlayerRemoteStandIn : public IRemoteObject {
+public:
+    explicit PlayerRemoteStandIn(bool isServiceThread)
+    {
+        if (isServiceThread) {
+            thread_ = std::thread([this] { Loop(); });
+        }
+    }
+
+    ~PlayerRemoteStandIn() override
+    {
+        if (thread_.joinable()) {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                isStopped_ = true;
+            }
+            cond_.notify_all();
+            thread_.join();
+        }
+    }
+
+    void SetAnswer(int32_t answer)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        answer_ = answer;
+    }
+
+    int SendRequest(uint32_t code, MessageParcel &data, MessageParcel &reply, MessageOption &option) override
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (!thread_.joinable()) {
+            Serve(data, reply);
+            return ERR_NONE;
+        }
+        request_ = { &data, &reply };
+        isRequested_ = true;
+        cond_.notify_all();
+        cond_.wait(lock, [this] { return !isRequested_; });
+        return ERR_NONE;
+    }
+
+private:
+    struct Request {
+        MessageParcel *data;
+        MessageParcel *reply;
+    };
+
+    void Serve(MessageParcel &data, MessageParcel &reply)
+    {
+        data.ReadInterfaceToken();
+        reply.WriteInt32(CAST_ENGINE_SUCCESS);
+        reply.WriteInt32(answer_);
+    }
+
+    void Loop()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (true) {
+            cond_.wait(lock, [this] { return isStopped_ || isRequested_; });
+            if (isStopped_) {
+                return;
+            }
+            Serve(*request_.data, *request_.reply);
+            isRequested_ = false;
+            cond_.notify_all();
+        }
+    }
+
+    std::thread thread_;
+    std::mutex mutex_;
+    std::condition_variable cond_;
+    Request request_{};
+    bool isRequested_{ false };
+    bool isStopped_{ false };
+    int32_t answer_{ 0 };
+};
+
+void BenchPlayerProxyGetters(const std::string &name, bool isServiceThread, uint64_t iterations,
+    std::vector<BenchResult> &results)
+{
+    auto remote = std::make_shared<PlayerRemoteStandIn>(isServiceThread);
+    StreamPlayerImplProxy proxy(remote);
+    remote->SetAnswer(PLAYER_POSITION);
+    int position = 0;
+    if (proxy.GetPosition(position) != CAST_ENGINE_SUCCESS || position != PLAYER_POSITION) {
+        results.push_back(MakeFailure(name, "proxy getters failed"));
+        return;
+    }
+    results.push_back(RunLoop(name + ".get_position", iterations, 0, [&proxy](uint64_t) {
+        int value = 0;
+        proxy.GetPosition(value);
+        return static_cast<uint64_t>(value);
+    }));
+    remote->SetAnswer(static_cast<int32_t>(PlayerStates::PLAYER_STARTED));
+    results.push_back(RunLoop(name + ".get_player_status", iterations, 0, [&proxy](uint64_t) {
+        PlayerStates value = PlayerStates::PLAYER_IDLE;
+        proxy.GetPlayerStatus(value);
+        return static_cast<uint64_t>(value);
+    }));
+}
+
+// The getters of StreamPlayer answer from the mirror once the listener stub has fed it, and go to the proxy before.
+void BenchPlayerGetters(const BenchOptions &options, std::vector<BenchResult> &results)
+{
+    uint64_t iterations = options.isQuick ? 1000 : 200000;
+    StreamPlayerStateMirror mirror;
+    mirror.OnStateChanged(PlayerStates::PLAYER_STARTED);
+    mirror.OnPositionChanged(PLAYER_POSITION, PLAYER_DURATION);
+    int position = 0;
+    PlayerStates state = PlayerStates::PLAYER_IDLE;
+    if (!mirror.GetPosition(position) || position < PLAYER_POSITION || !mirror.GetPlayerStatus(state) ||
+        state != PlayerStates::PLAYER_STARTED) {
+        results.push_back(MakeFailure("player_getters.mirror", "mirror getters failed"));
+        return;
+    }
+    results.push_back(RunLoop("player_getters.mirror.get_position", iterations, 0, [&mirror](uint64_t) {
+        int value = 0;
+        mirror.GetPosition(value);
+        return static_cast<uint64_t>(value);
+    }));
+    results.push_back(RunLoop("player_getters.mirror.get_player_status", iterations, 0, [&mirror](uint64_t) {
+        PlayerStates value = PlayerStates::PLAYER_IDLE;
+        mirror.GetPlayerStatus(value);
+        return static_cast<uint64_t>(value);
+    }));
+    BenchPlayerProxyGetters("player_getters.ipc_same_thread", false, iterations, results);
+    BenchPlayerProxyGetters("player_getters.ipc_service_thread", true, iterations / 10, results);
+}
+
+struct Benchmark {
+    const char *group;
+    void (*run)(const BenchOptions &options, std::vector<BenchResult> &results);
+};
+
+const Benchmark BENCHMARKS[] = {
+    { "rtsp", BenchRtsp },
+    { "crypto", BenchCrypto },
+    { "handler", BenchHandler },
+    { "tcp", BenchTcp },
+    { "local_data_source", BenchLocalDataSource },
+    { "local_data_source", BenchLocalFilePrepare },
+    { "json", BenchJson },
+    { "parcel", BenchParcel },
+    { "player_getters", BenchPlayerGetters },
+};
+
+json ToJson(const BenchResult &result)
+{
+    json item;
+    item["name"] = result.name;
+    item["status"] = result.isOk ? "ok" : "failed";
+    item["iterations"] = result.iterations;
+    item["ns_per_op"] = result.nsPerOp;
+    item["mb_per_s"] = result.mbPerSec;
+    item["extra"] = result.extra;
+    return item;
+}
+
+bool ParseOptions(int argc, char *argv[], BenchOptions &options)
+{
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--quick") {
+            options.isQuick = true;
+        } else if (arg == "--filter" && i + 1 < argc) {
+            options.filter = argv[++i];
+        } else if (arg == "--out" && i + 1 < argc) {
+            options.outFile = argv[++i];
+        } else {
+            std::cerr << "usage: " << argv[0] << " [--quick] [--filter <group>] [--out <file>]" << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+} // namespace
+
+int RunBenchmarks(int argc, char *argv[])
+{
+    BenchOptions options;
+    if (!ParseOptions(argc, argv, options)) {
+        return EXIT_FAILURE;
+    }
+    CastEngineMetrics::GetInstance().RegisterDefaultMetrics();
+
+    std::vector<BenchResult> results;
+    for (const auto &benchmark : BENCHMARKS) {
+        if (options.filter.empty() || options.filter == benchmark.group) {
+            benchmark.run(options, results);
+        }
+    }
+
+    json report;
+    report["schema_version"] = 1;
+    report["quick"] = options.isQuick;
+    report["results"] = json::array();
+    bool isAllOk = true;
+    for (const auto &result : results) {
+        report["results"].push_back(ToJson(result));
+        isAllOk = isAllOk && result.isOk;
+    }
+    report["metrics"] = json::parse(CastEngineMetrics::GetInstance().Dump(), nullptr, false);
+
+    std::string text = report.dump(2);
+    if (options.outFile.empty()) {
+        std::cout << text << std::endl;
+    } else {
+        std::ofstream(options.outFile) << text << std::endl;
+    }
+    return isAllOk ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+} // namespace CastEngineService
+} // namespace CastEngine
+} // namespace OHOS
+
+int main(int argc, char *argv[])
+{
+    return OHOS::CastEngine::CastEngineService::RunBenchmarks(argc, argv);
+}
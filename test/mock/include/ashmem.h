@@ -0,0 +1,77 @@
+/*
+ * Copyright (C) 2023-2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * Description: host stand-in for the c_utils ashmem, backed by a memfd.
+ * Author: zhangge
+ * Create: 2023-06-05
+ */
+
+#ifndef CAST_ENGINE_MOCK_ASHMEM_H
+#define CAST_ENGINE_MOCK_ASHMEM_H
+
+#include <cstdint>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "refbase.h"
+
+namespace OHOS {
+class Ashmem : public RefBase {
+public:
+    Ashmem(int fd, int32_t size) : fd_(fd), size_(size) {}
+    ~Ashmem() override
+    {
+        CloseAshmem();
+    }
+
+    static sptr<Ashmem> CreateAshmem(const char *name, int32_t size)
+    {
+        if (size <= 0) {
+            return nullptr;
+        }
+        int fd = memfd_create(name, MFD_CLOEXEC);
+        if (fd < 0) {
+            return nullptr;
+        }
+        if (ftruncate(fd, size) != 0) {
+            close(fd);
+            return nullptr;
+        }
+        return MakeSptr<Ashmem>(fd, size);
+    }
+
+    int GetAshmemFd() const
+    {
+        return fd_;
+    }
+
+    int32_t GetAshmemSize() const
+    {
+        return size_;
+    }
+
+    void CloseAshmem()
+    {
+        if (fd_ >= 0) {
+            close(fd_);
+            fd_ = -1;
+        }
+    }
+
+private:
+    int fd_;
+    int32_t size_;
+};
+} // namespace OHOS
+
+#endif // CAST_ENGINE_MOCK_ASHMEM_H
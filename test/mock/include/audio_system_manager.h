@@ -0,0 +1,94 @@
+/*
+ * Copyright (C) 2023-2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * Description: host stand-in for the audio system manager, no audio service is present.
+ * Author: zhangge
+ * Create: 2023-06-05
+ */
+
+#ifndef CAST_ENGINE_MOCK_AUDIO_SYSTEM_MANAGER_H
+#define CAST_ENGINE_MOCK_AUDIO_SYSTEM_MANAGER_H
+
+#include <cstdint>
+#include <memory>
+
+namespace OHOS {
+namespace AudioStandard {
+enum AudioVolumeType {
+    STREAM_DEFAULT = -1,
+    STREAM_VOICE_CALL = 0,
+    STREAM_MUSIC = 1,
+};
+using AudioStreamType = AudioVolumeType;
+
+enum InterruptHint {
+    INTERRUPT_HINT_NONE = 0,
+    INTERRUPT_HINT_RESUME,
+    INTERRUPT_HINT_PAUSE,
+    INTERRUPT_HINT_STOP,
+};
+
+struct VolumeEvent {
+    AudioVolumeType volumeType;
+    int32_t volume;
+    bool updateUi;
+};
+
+class VolumeKeyEventCallback {
+public:
+    virtual ~VolumeKeyEventCallback() = default;
+    virtual void OnVolumeKeyEvent(VolumeEvent volumeEvent) = 0;
+};
+
+class AudioSystemManager {
+public:
+    static constexpr int32_t MAX_VOLUME = 15;
+
+    static AudioSystemManager *GetInstance()
+    {
+        static AudioSystemManager instance;
+        return &instance;
+    }
+    int32_t GetVolume(AudioVolumeType volumeType) const
+    {
+        return 0;
+    }
+    int32_t GetMaxVolume(AudioVolumeType volumeType)
+    {
+        return MAX_VOLUME;
+    }
+    int32_t SetVolume(AudioVolumeType volumeType, int32_t volume)
+    {
+        return 0;
+    }
+    int32_t SetMute(AudioVolumeType volumeType, bool mute)
+    {
+        return 0;
+    }
+    bool IsStreamMute(AudioVolumeType volumeType) const
+    {
+        return false;
+    }
+    int32_t RegisterVolumeKeyEventCallback(int32_t clientPid, const std::shared_ptr<VolumeKeyEventCallback> &callback)
+    {
+        return 0;
+    }
+    int32_t UnregisterVolumeKeyEventCallback(int32_t clientPid)
+    {
+        return 0;
+    }
+};
+} // namespace AudioStandard
+} // namespace OHOS
+
+#endif
@@ -0,0 +1,51 @@
+/*
+ * Copyright (C) 2023-2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * Description: host stand-in for the multimedia metadata helper, it finds no album cover.
+ * Author: zhangge
+ * Create: 2023-06-05
+ */
+
+#ifndef CAST_ENGINE_MOCK_AVMETADATAHELPER_H
+#define CAST_ENGINE_MOCK_AVMETADATAHELPER_H
+
+#include <cstdint>
+#include <memory>
+
+#include "media_data_source.h"
+
+namespace OHOS {
+namespace Media {
+class AVMetadataHelper {
+public:
+    int32_t SetSource(const std::shared_ptr<IMediaDataSource> &dataSrc)
+    {
+        return 0;
+    }
+    std::shared_ptr<AVSharedMemory> FetchArtPicture()
+    {
+        return nullptr;
+    }
+};
+
+class AVMetadataHelperFactory {
+public:
+    static std::shared_ptr<AVMetadataHelper> CreateAVMetadataHelper()
+    {
+        return std::make_shared<AVMetadataHelper>();
+    }
+};
+} // namespace Media
+} // namespace OHOS
+
+#endif
@@ -0,0 +1,59 @@
+/*
+ * Copyright (C) 2023-2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * Description: host stand-in for the DeviceManager client, every device list is empty.
+ * Author: zhangge
+ * Create: 2023-06-05
+ */
+
+#ifndef CAST_ENGINE_MOCK_DEVICE_MANAGER_H
+#define CAST_ENGINE_MOCK_DEVICE_MANAGER_H
+
+#include <string>
+#include <vector>
+
+#include "dm_device_info.h"
+
+namespace OHOS {
+namespace DistributedHardware {
+class DeviceManager {
+public:
+    static DeviceManager &GetInstance()
+    {
+        static DeviceManager instance;
+        return instance;
+    }
+
+    int32_t GetTrustedDeviceList(const std::string &pkgName, const std::string &extra,
+        std::vector<DmDeviceInfo> &deviceList)
+    {
+        deviceList.clear();
+        return DM_OK;
+    }
+
+    int32_t GetLocalDeviceInfo(const std::string &pkgName, DmDeviceInfo &deviceInfo)
+    {
+        deviceInfo = DmDeviceInfo {};
+        return DM_OK;
+    }
+
+    int32_t GetLocalDeviceNetWorkId(const std::string &pkgName, std::string &networkId)
+    {
+        networkId.clear();
+        return DM_OK;
+    }
+};
+} // namespace DistributedHardware
+} // namespace OHOS
+
+#endif
@@ -0,0 +1,34 @@
+/*
+ * Copyright (C) 2023-2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * Description: host stand-in for the DeviceManager constants.
+ * Author: zhangge
+ * Create: 2023-06-05
+ */
+
+#ifndef CAST_ENGINE_MOCK_DM_CONSTANTS_H
+#define CAST_ENGINE_MOCK_DM_CONSTANTS_H
+
+#include "dm_device_info.h"
+
+namespace OHOS {
+namespace DistributedHardware {
+const std::string PARAM_KEY_META_TYPE = "META_TYPE";
+const std::string PARAM_KEY_BR_MAC = "BR_MAC";
+const std::string PARAM_KEY_BLE_MAC = "BLE_MAC";
+const std::string PARAM_KEY_WIFI_IP = "WIFI_IP";
+const std::string PARAM_KEY_WIFI_PORT = "WIFI_PORT";
+} // namespace DistributedHardware
+} // namespace OHOS
+
+#endif
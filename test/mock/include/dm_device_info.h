@@ -0,0 +1,59 @@
+/*
+ * Copyright (C) 2023-2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * Description: host stand-in for the DeviceManager device descriptors.
+ * Author: zhangge
+ * Create: 2023-06-05
+ */
+
+#ifndef CAST_ENGINE_MOCK_DM_DEVICE_INFO_H
+#define CAST_ENGINE_MOCK_DM_DEVICE_INFO_H
+
+#include <cstdint>
+#include <string>
+
+namespace OHOS {
+namespace DistributedHardware {
+constexpr int DM_OK = 0;
+constexpr int DM_MAX_DEVICE_ID_LEN = 96;
+constexpr int DM_MAX_DEVICE_NAME_LEN = 128;
+
+enum DmAuthForm : int32_t {
+    INVALID_TYPE = -1,
+    PEER_TO_PEER = 0,
+    IDENTICAL_ACCOUNT = 1,
+    ACROSS_ACCOUNT = 2,
+};
+
+struct DmDeviceInfo {
+    char deviceId[DM_MAX_DEVICE_ID_LEN] = { 0 };
+    char deviceName[DM_MAX_DEVICE_NAME_LEN] = { 0 };
+    uint16_t deviceTypeId { 0 };
+    char networkId[DM_MAX_DEVICE_ID_LEN] = { 0 };
+    int32_t range { 0 };
+    int32_t networkType { 0 };
+    DmAuthForm authForm { INVALID_TYPE };
+    std::string extraData;
+};
+
+struct PeerTargetId {
+    std::string deviceId;
+    std::string brMac;
+    std::string bleMac;
+    std::string wifiIp;
+    uint16_t wifiPort { 0 };
+};
+} // namespace DistributedHardware
+} // namespace OHOS
+
+#endif
@@ -0,0 +1,32 @@
+/*
+ * Copyright (C) 2023-2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * Description: host stand-in for the c_utils error codes.
+ * Author: zhangge
+ * Create: 2023-06-05
+ */
+
+#ifndef CAST_ENGINE_MOCK_ERRORS_H
+#define CAST_ENGINE_MOCK_ERRORS_H
+
+#include <cstdint>
+
+namespace OHOS {
+using ErrCode = int32_t;
+constexpr ErrCode ERR_OK = 0;
+constexpr ErrCode ERR_INVALID_VALUE = 22;
+constexpr ErrCode ERR_INVALID_DATA = 61;
+constexpr ErrCode ERR_NO_INIT = 19;
+} // namespace OHOS
+
+#endif
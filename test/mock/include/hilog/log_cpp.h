@@ -0,0 +1,58 @@
+/*
+ * Copyright (C) 2023-2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * Description: host stand-in for hilog, prints to stderr with the privacy markers of the format stripped.
+ * Author: zhangge
+ * Create: 2023-06-05
+ */
+
+#ifndef CAST_ENGINE_MOCK_HILOG_LOG_CPP_H
+#define CAST_ENGINE_MOCK_HILOG_LOG_CPP_H
+
+#include <cstdarg>
+#include <cstdio>
+#include <string>
+
+#define LOG_CORE 3
+
+namespace OHOS {
+namespace HiviewDFX {
+struct HiLogLabel {
+    int type;
+    unsigned int domain;
+    const char *tag;
+};
+
+class HiLog {
+public:
+    static int Error(const HiLogLabel &label, const char *format, ...)
+    {
+        std::string plain(format);
+        for (const char *marker : { "{public}", "{private}" }) {
+            for (size_t pos = plain.find(marker); pos != std::string::npos; pos = plain.find(marker, pos)) {
+                plain.erase(pos, std::char_traits<char>::length(marker));
+            }
+        }
+        va_list args;
+        va_start(args, format);
+        fprintf(stderr, "%s ", label.tag);
+        int ret = vfprintf(stderr, plain.c_str(), args);
+        fputc('\n', stderr);
+        va_end(args);
+        return ret;
+    }
+};
+} // namespace HiviewDFX
+} // namespace OHOS
+
+#endif
@@ -0,0 +1,55 @@
+/*
+ * Copyright (C) 2023-2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * Description: host stand-in for HiSysEvent, events are counted and dropped.
+ * Author: zhangge
+ * Create: 2023-06-05
+ */
+
+#ifndef CAST_ENGINE_MOCK_HISYSEVENT_H
+#define CAST_ENGINE_MOCK_HISYSEVENT_H
+
+#include <atomic>
+#include <string>
+
+namespace OHOS {
+namespace HiviewDFX {
+class HiSysEvent {
+public:
+    enum EventType {
+        FAULT = 1,
+        STATISTIC = 2,
+        SECURITY = 3,
+        BEHAVIOR = 4,
+    };
+
+    template<typename... Types>
+    static int Write(const std::string &domain, const std::string &eventName, EventType type, Types... keyValues)
+    {
+        GetWriteCount()++;
+        return 0;
+    }
+
+    static std::atomic<uint64_t> &GetWriteCount()
+    {
+        static std::atomic<uint64_t> count{ 0 };
+        return count;
+    }
+};
+} // namespace HiviewDFX
+} // namespace OHOS
+
+#define HiSysEventWrite(domain, eventName, type, ...) \
+    OHOS::HiviewDFX::HiSysEvent::Write(domain, eventName, type, ##__VA_ARGS__)
+
+#endif
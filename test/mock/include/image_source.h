@@ -0,0 +1,72 @@
+/*
+ * Copyright (C) 2023-2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * Description: host stand-in for the image source, nothing is decoded.
+ * Author: zhangge
+ * Create: 2023-06-05
+ */
+
+#ifndef CAST_ENGINE_MOCK_IMAGE_SOURCE_H
+#define CAST_ENGINE_MOCK_IMAGE_SOURCE_H
+
+#include <cstdint>
+#include <memory>
+
+#include "pixel_map.h"
+
+namespace OHOS {
+namespace Media {
+struct ImageInfo {
+    Size size;
+};
+
+struct SourceOptions {};
+
+struct IncrementalSourceOptions {};
+
+struct DecodeOptions {
+    Size desiredSize;
+};
+
+class ImageSource {
+public:
+    static std::unique_ptr<ImageSource> CreateImageSource(const uint8_t *data, uint32_t size,
+        const SourceOptions &opts, uint32_t &errorCode)
+    {
+        errorCode = 1;
+        return nullptr;
+    }
+    static std::unique_ptr<ImageSource> CreateIncrementalImageSource(const IncrementalSourceOptions &opts,
+        uint32_t &errorCode)
+    {
+        errorCode = 1;
+        return nullptr;
+    }
+    uint32_t UpdateData(const uint8_t *data, uint32_t size, bool isCompleted)
+    {
+        return 0;
+    }
+    uint32_t GetImageInfo(uint32_t index, ImageInfo &imageInfo)
+    {
+        return 1;
+    }
+    std::unique_ptr<PixelMap> CreatePixelMap(uint32_t index, const DecodeOptions &opts, uint32_t &errorCode)
+    {
+        errorCode = 1;
+        return nullptr;
+    }
+};
+} // namespace Media
+} // namespace OHOS
+
+#endif
@@ -0,0 +1,60 @@
+/*
+ * Copyright (C) 2023-2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * Description: host stand-in for the ipc skeleton, every call comes from this process.
+ * Author: zhangge
+ * Create: 2023-06-05
+ */
+
+#ifndef CAST_ENGINE_MOCK_IPC_SKELETON_H
+#define CAST_ENGINE_MOCK_IPC_SKELETON_H
+
+#include <cstdint>
+#include <string>
+#include <unistd.h>
+
+namespace OHOS {
+class IPCSkeleton {
+public:
+    static pid_t GetCallingPid()
+    {
+        return getpid();
+    }
+    static pid_t GetCallingUid()
+    {
+        return getuid();
+    }
+    static uint32_t GetCallingTokenID()
+    {
+        return 0;
+    }
+    static uint64_t GetCallingFullTokenID()
+    {
+        return 0;
+    }
+    static uint32_t GetSelfTokenID()
+    {
+        return 0;
+    }
+    static std::string ResetCallingIdentity()
+    {
+        return "";
+    }
+    static bool SetCallingIdentity(const std::string &identity)
+    {
+        return true;
+    }
+};
+} // namespace OHOS
+
+#endif
@@ -0,0 +1,32 @@
+/*
+ * Copyright (C) 2023-2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * Description: host stand-in for the ipc error codes.
+ * Author: zhangge
+ * Create: 2023-06-05
+ */
+
+#ifndef CAST_ENGINE_MOCK_IPC_TYPES_H
+#define CAST_ENGINE_MOCK_IPC_TYPES_H
+
+namespace OHOS {
+enum {
+    ERR_NONE = 0,
+    ERR_UNKNOWN_TRANSACTION = 1,
+    IPC_PROXY_ERR = 29189,
+    IPC_STUB_ERR = 29289,
+    IPC_STUB_WRITE_PARCEL_ERR = 29290,
+};
+} // namespace OHOS
+
+#endif
@@ -0,0 +1,65 @@
+/*
+ * Copyright (C) 2023-2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * Description: host stand-in for the IPC remote broker.
+ * Author: zhangge
+ * Create: 2023-06-05
+ */
+
+#ifndef CAST_ENGINE_MOCK_IREMOTE_BROKER_H
+#define CAST_ENGINE_MOCK_IREMOTE_BROKER_H
+
+#include <string>
+
+#include "message_parcel.h"
+#include "refbase.h"
+
+namespace OHOS {
+class IRemoteObject : public RefBase {
+public:
+    class DeathRecipient : public RefBase {
+    public:
+        virtual void OnRemoteDied(const wptr<IRemoteObject> &object) = 0;
+    };
+
+    virtual int SendRequest(uint32_t code, MessageParcel &data, MessageParcel &reply, MessageOption &option)
+    {
+        return 0;
+    }
+    virtual bool AddDeathRecipient(const sptr<DeathRecipient> &recipient)
+    {
+        return true;
+    }
+    virtual bool RemoveDeathRecipient(const sptr<DeathRecipient> &recipient)
+    {
+        return true;
+    }
+};
+
+class IRemoteBroker : public virtual RefBase {
+public:
+    virtual sptr<IRemoteObject> AsObject()
+    {
+        return nullptr;
+    }
+};
+
+#define DECLARE_INTERFACE_DESCRIPTOR(DESCRIPTOR)              \
+    static inline const std::u16string metaDescriptor_ = { DESCRIPTOR }; \
+    static inline const std::u16string &GetDescriptor()        \
+    {                                                          \
+        return metaDescriptor_;                                \
+    }
+} // namespace OHOS
+
+#endif
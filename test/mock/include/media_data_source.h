@@ -0,0 +1,52 @@
+/*
+ * Copyright (C) 2023-2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * Description: host stand-in for the multimedia data source interface.
+ * Author: zhangge
+ * Create: 2023-06-05
+ */
+
+#ifndef CAST_ENGINE_MOCK_MEDIA_DATA_SOURCE_H
+#define CAST_ENGINE_MOCK_MEDIA_DATA_SOURCE_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace OHOS {
+namespace Media {
+enum MediaDataSourceError : int32_t {
+    SOURCE_ERROR_IO = -2,
+    SOURCE_ERROR_EOF = -1,
+};
+
+class AVSharedMemory {
+public:
+    virtual ~AVSharedMemory() = default;
+    virtual uint8_t *GetBase() const = 0;
+    virtual int32_t GetSize() const = 0;
+    virtual uint32_t GetFlags() const = 0;
+};
+
+class IMediaDataSource {
+public:
+    virtual ~IMediaDataSource() = default;
+    virtual int32_t ReadAt(const std::shared_ptr<AVSharedMemory> &mem, uint32_t length, int64_t pos = -1) = 0;
+    virtual int32_t ReadAt(int64_t pos, uint32_t length, const std::shared_ptr<AVSharedMemory> &mem) = 0;
+    virtual int32_t ReadAt(uint32_t length, const std::shared_ptr<AVSharedMemory> &mem) = 0;
+    virtual int32_t GetSize(int64_t &size) = 0;
+};
+} // namespace Media
+} // namespace OHOS
+
+#endif
@@ -0,0 +1,94 @@
+/*
+ * Copyright (C) 2023-2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * Description: host stand-in for the IPC message parcel.
+ * Author: zhangge
+ * Create: 2023-06-05
+ */
+
+#ifndef CAST_ENGINE_MOCK_MESSAGE_PARCEL_H
+#define CAST_ENGINE_MOCK_MESSAGE_PARCEL_H
+
+#include "parcel.h"
+#include "refbase.h"
+
+namespace OHOS {
+class IRemoteObject;
+
+class MessageParcel : public Parcel {
+public:
+    bool WriteFileDescriptor(int fd)
+    {
+        return WriteInt32(fd);
+    }
+    int ReadFileDescriptor()
+    {
+        return ReadInt32();
+    }
+    bool WriteRawData(const void *data, size_t size)
+    {
+        return WriteUint32(static_cast<uint32_t>(size)) && WriteBuffer(data, size);
+    }
+    const void *ReadRawData(size_t size)
+    {
+        return ReadUint32() == size ? ReadBuffer(size) : nullptr;
+    }
+    // Only whether there was an object travels, a read gives it back as null.
+    bool WriteRemoteObject(const sptr<IRemoteObject> &object)
+    {
+        return WriteBool(object != nullptr);
+    }
+    sptr<IRemoteObject> ReadRemoteObject()
+    {
+        ReadBool();
+        return nullptr;
+    }
+    bool WriteInterfaceToken(const std::u16string &name)
+    {
+        return WriteUint32(static_cast<uint32_t>(name.size()));
+    }
+    std::u16string ReadInterfaceToken()
+    {
+        ReadUint32();
+        return std::u16string();
+    }
+    size_t GetDataCapacity() const
+    {
+        return dataCapacity_;
+    }
+    bool SetDataCapacity(size_t capacity)
+    {
+        dataCapacity_ = capacity;
+        return true;
+    }
+    bool SetMaxCapacity(size_t capacity)
+    {
+        return true;
+    }
+
+private:
+    size_t dataCapacity_{ 0 };
+};
+
+class MessageOption {
+public:
+    enum { TF_SYNC = 0, TF_ASYNC = 1 };
+    explicit MessageOption(int flags = TF_SYNC) : flags_(flags) {}
+    int GetFlags() const { return flags_; }
+
+private:
+    int flags_;
+};
+} // namespace OHOS
+
+#endif
@@ -0,0 +1,177 @@
+/*
+ * Copyright (C) 2023-2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * Description: host stand-in for the napi subset used by the js kit, see napi_callback_bench for a runtime.
+ * Author: zhangge
+ * Create: 2023-06-05
+ */
+
+#ifndef CAST_ENGINE_MOCK_NAPI_NATIVE_API_H
+#define CAST_ENGINE_MOCK_NAPI_NATIVE_API_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "native_common.h"
+
+typedef struct napi_env__ *napi_env;
+typedef struct napi_value__ *napi_value;
+typedef struct napi_ref__ *napi_ref;
+typedef struct napi_handle_scope__ *napi_handle_scope;
+typedef struct napi_callback_info__ *napi_callback_info;
+typedef struct napi_deferred__ *napi_deferred;
+typedef struct napi_async_work__ *napi_async_work;
+typedef struct napi_threadsafe_function__ *napi_threadsafe_function;
+
+typedef enum {
+    napi_ok,
+    napi_invalid_arg,
+    napi_object_expected,
+    napi_string_expected,
+    napi_generic_failure,
+    napi_closing,
+    napi_pending_exception,
+} napi_status;
+
+typedef enum {
+    napi_undefined,
+    napi_null,
+    napi_boolean,
+    napi_number,
+    napi_string,
+    napi_symbol,
+    napi_object,
+    napi_function,
+    napi_external,
+    napi_bigint,
+} napi_valuetype;
+
+typedef enum {
+    napi_default = 0,
+    napi_writable = 1 << 0,
+    napi_enumerable = 1 << 1,
+    napi_configurable = 1 << 2,
+    napi_static = 1 << 10,
+} napi_property_attributes;
+
+typedef enum { napi_tsfn_release, napi_tsfn_abort } napi_threadsafe_function_release_mode;
+typedef enum { napi_tsfn_nonblocking, napi_tsfn_blocking } napi_threadsafe_function_call_mode;
+typedef enum { napi_uint8_array } napi_typedarray_type;
+
+typedef napi_value (*napi_callback)(napi_env env, napi_callback_info info);
+typedef void (*napi_finalize)(napi_env env, void *data, void *hint);
+typedef void (*napi_async_execute_callback)(napi_env env, void *data);
+typedef void (*napi_async_complete_callback)(napi_env env, napi_status status, void *data);
+typedef void (*napi_threadsafe_function_call_js)(napi_env env, napi_value jsCallback, void *context, void *data);
+
+typedef struct {
+    const char *utf8name;
+    napi_value name;
+    napi_callback method;
+    napi_callback getter;
+    napi_callback setter;
+    napi_value value;
+    napi_property_attributes attributes;
+    void *data;
+} napi_property_descriptor;
+
+typedef struct {
+    const char *error_message;
+    void *engine_reserved;
+    uint32_t engine_error_code;
+    napi_status error_code;
+} napi_extended_error_info;
+
+typedef struct {
+    int nm_version;
+    unsigned int nm_flags;
+    const char *nm_filename;
+    napi_value (*nm_register_func)(napi_env env, napi_value exports);
+    const char *nm_modname;
+    void *nm_priv;
+    void *reserved[4];
+} napi_module;
+
+#define NAPI_AUTO_LENGTH SIZE_MAX
+
+// Only declared, a host tool that calls one of them has to define it as part of its fake runtime.
+napi_status napi_create_string_utf8(napi_env env, const char *str, size_t length, napi_value *result);
+napi_status napi_create_int32(napi_env env, int32_t value, napi_value *result);
+napi_status napi_create_uint32(napi_env env, uint32_t value, napi_value *result);
+napi_status napi_create_int64(napi_env env, int64_t value, napi_value *result);
+napi_status napi_create_double(napi_env env, double value, napi_value *result);
+napi_status napi_get_boolean(napi_env env, bool value, napi_value *result);
+napi_status napi_create_object(napi_env env, napi_value *result);
+napi_status napi_create_array(napi_env env, napi_value *result);
+napi_status napi_create_array_with_length(napi_env env, size_t length, napi_value *result);
+napi_status napi_set_element(napi_env env, napi_value object, uint32_t index, napi_value value);
+napi_status napi_get_element(napi_env env, napi_value object, uint32_t index, napi_value *result);
+napi_status napi_is_array(napi_env env, napi_value value, bool *result);
+napi_status napi_get_array_length(napi_env env, napi_value value, uint32_t *result);
+napi_status napi_set_named_property(napi_env env, napi_value object, const char *name, napi_value value);
+napi_status napi_get_named_property(napi_env env, napi_value object, const char *name, napi_value *result);
+napi_status napi_has_named_property(napi_env env, napi_value object, const char *name, bool *result);
+napi_status napi_get_property(napi_env env, napi_value object, napi_value key, napi_value *result);
+napi_status napi_set_property(napi_env env, napi_value object, napi_value key, napi_value value);
+napi_status napi_has_property(napi_env env, napi_value object, napi_value key, bool *result);
+napi_status napi_define_properties(napi_env env, napi_value object, size_t count,
+    const napi_property_descriptor *properties);
+napi_status napi_typeof(napi_env env, napi_value value, napi_valuetype *result);
+napi_status napi_get_value_int32(napi_env env, napi_value value, int32_t *result);
+napi_status napi_get_value_uint32(napi_env env, napi_value value, uint32_t *result);
+napi_status napi_get_value_int64(napi_env env, napi_value value, int64_t *result);
+napi_status napi_get_value_double(napi_env env, napi_value value, double *result);
+napi_status napi_get_value_bool(napi_env env, napi_value value, bool *result);
+napi_status napi_get_value_string_utf8(napi_env env, napi_value value, char *buf, size_t size, size_t *result);
+napi_status napi_get_undefined(napi_env env, napi_value *result);
+napi_status napi_get_null(napi_env env, napi_value *result);
+napi_status napi_get_global(napi_env env, napi_value *result);
+napi_status napi_get_cb_info(napi_env env, napi_callback_info info, size_t *argc, napi_value *argv,
+    napi_value *thisArg, void **data);
+napi_status napi_create_reference(napi_env env, napi_value value, uint32_t count, napi_ref *result);
+napi_status napi_delete_reference(napi_env env, napi_ref ref);
+napi_status napi_get_reference_value(napi_env env, napi_ref ref, napi_value *result);
+napi_status napi_reference_ref(napi_env env, napi_ref ref, uint32_t *result);
+napi_status napi_reference_unref(napi_env env, napi_ref ref, uint32_t *result);
+napi_status napi_strict_equals(napi_env env, napi_value lhs, napi_value rhs, bool *result);
+napi_status napi_call_function(napi_env env, napi_value recv, napi_value func, size_t argc, const napi_value *argv,
+    napi_value *result);
+napi_status napi_open_handle_scope(napi_env env, napi_handle_scope *result);
+napi_status napi_close_handle_scope(napi_env env, napi_handle_scope scope);
+napi_status napi_throw_error(napi_env env, const char *code, const char *msg);
+napi_status napi_get_last_error_info(napi_env env, const napi_extended_error_info **result);
+napi_status napi_is_exception_pending(napi_env env, bool *result);
+napi_status napi_get_uv_event_loop(napi_env env, struct uv_loop_s **loop);
+napi_status napi_add_env_cleanup_hook(napi_env env, void (*fun)(void *arg), void *arg);
+napi_status napi_remove_env_cleanup_hook(napi_env env, void (*fun)(void *arg), void *arg);
+napi_status napi_wrap(napi_env env, napi_value object, void *nativeObject, napi_finalize finalizeCb, void *hint,
+    napi_ref *result);
+napi_status napi_unwrap(napi_env env, napi_value object, void **result);
+napi_status napi_create_arraybuffer(napi_env env, size_t length, void **data, napi_value *result);
+napi_status napi_get_arraybuffer_info(napi_env env, napi_value arraybuffer, void **data, size_t *length);
+napi_status napi_create_typedarray(napi_env env, napi_typedarray_type type, size_t length, napi_value arraybuffer,
+    size_t offset, napi_value *result);
+napi_status napi_get_typedarray_info(napi_env env, napi_value typedarray, napi_typedarray_type *type, size_t *length,
+    void **data, napi_value *arraybuffer, size_t *offset);
+napi_status napi_is_typedarray(napi_env env, napi_value value, bool *result);
+napi_status napi_create_threadsafe_function(napi_env env, napi_value func, napi_value asyncResource,
+    napi_value asyncResourceName, size_t maxQueueSize, size_t initialThreadCount, void *threadFinalizeData,
+    napi_finalize threadFinalizeCb, void *context, napi_threadsafe_function_call_js callJsCb,
+    napi_threadsafe_function *result);
+napi_status napi_call_threadsafe_function(napi_threadsafe_function func, void *data,
+    napi_threadsafe_function_call_mode isBlocking);
+napi_status napi_release_threadsafe_function(napi_threadsafe_function func,
+    napi_threadsafe_function_release_mode mode);
+napi_status napi_unref_threadsafe_function(napi_env env, napi_threadsafe_function func);
+
+#endif // CAST_ENGINE_MOCK_NAPI_NATIVE_API_H
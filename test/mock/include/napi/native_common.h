@@ -0,0 +1,44 @@
+/*
+ * Copyright (C) 2023-2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * Description: host stand-in for the napi helper macros.
+ * Author: zhangge
+ * Create: 2023-06-05
+ */
+
+#ifndef CAST_ENGINE_MOCK_NAPI_NATIVE_COMMON_H
+#define CAST_ENGINE_MOCK_NAPI_NATIVE_COMMON_H
+
+#define NAPI_CALL_BASE(env, theCall, retVal) \
+    do {                                     \
+        if ((theCall) != napi_ok) {          \
+            return retVal;                   \
+        }                                    \
+    } while (0)
+
+#define NAPI_CALL(env, theCall) NAPI_CALL_BASE(env, theCall, nullptr)
+#define NAPI_CALL_RETURN_VOID(env, theCall) NAPI_CALL_BASE(env, theCall, )
+
+#define NAPI_ASSERT(env, assertion, message) \
+    do {                                     \
+        if (!(assertion)) {                  \
+            return nullptr;                  \
+        }                                    \
+    } while (0)
+
+#define DECLARE_NAPI_FUNCTION(name, func) { (name), nullptr, (func), nullptr, nullptr, nullptr, napi_default, nullptr }
+#define DECLARE_NAPI_STATIC_FUNCTION(name, func) \
+    { (name), nullptr, (func), nullptr, nullptr, nullptr, napi_static, nullptr }
+#define DECLARE_NAPI_PROPERTY(name, val) { (name), nullptr, nullptr, nullptr, nullptr, val, napi_default, nullptr }
+
+#endif // CAST_ENGINE_MOCK_NAPI_NATIVE_COMMON_H
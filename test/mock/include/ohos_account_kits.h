@@ -0,0 +1,48 @@
+/*
+ * Copyright (C) 2023-2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * Description: host stand-in for the distributed account kits, there is no account on the host.
+ * Author: zhangge
+ * Create: 2023-06-05
+ */
+
+#ifndef CAST_ENGINE_MOCK_OHOS_ACCOUNT_KITS_H
+#define CAST_ENGINE_MOCK_OHOS_ACCOUNT_KITS_H
+
+#include <string>
+
+#include "errors.h"
+
+namespace OHOS {
+namespace AccountSA {
+struct OhosAccountInfo {
+    std::string name_;
+    std::string uid_;
+};
+
+class OhosAccountKits {
+public:
+    static OhosAccountKits &GetInstance()
+    {
+        static OhosAccountKits instance;
+        return instance;
+    }
+    ErrCode GetOhosAccountInfo(OhosAccountInfo &info)
+    {
+        return ERR_INVALID_VALUE;
+    }
+};
+} // namespace AccountSA
+} // namespace OHOS
+
+#endif
@@ -0,0 +1,64 @@
+/*
+ * Copyright (C) 2023-2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * Description: host stand-in for the system parameters, read from the environment variable of the same name.
+ * Author: zhangge
+ * Create: 2023-06-05
+ */
+
+#ifndef CAST_ENGINE_MOCK_PARAMETERS_H
+#define CAST_ENGINE_MOCK_PARAMETERS_H
+
+#include <cstdlib>
+#include <string>
+
+namespace OHOS {
+namespace system {
+inline std::string GetParameter(const std::string &key, const std::string &def)
+{
+    const char *value = std::getenv(key.c_str());
+    return value == nullptr ? def : std::string(value);
+}
+
+inline bool GetBoolParameter(const std::string &key, bool def)
+{
+    std::string value = GetParameter(key, "");
+    if (value == "1" || value == "true" || value == "on") {
+        return true;
+    }
+    if (value == "0" || value == "false" || value == "off") {
+        return false;
+    }
+    return def;
+}
+
+template<typename T>
+T GetIntParameter(const std::string &key, T def)
+{
+    std::string value = GetParameter(key, "");
+    if (value.empty()) {
+        return def;
+    }
+    char *end = nullptr;
+    long long result = std::strtoll(value.c_str(), &end, 0);
+    return (end == nullptr || *end != '\0') ? def : static_cast<T>(result);
+}
+
+inline bool SetParameter(const std::string &key, const std::string &value)
+{
+    return setenv(key.c_str(), value.c_str(), 1) == 0;
+}
+} // namespace system
+} // namespace OHOS
+
+#endif
@@ -0,0 +1,106 @@
+/*
+ * Copyright (C) 2023-2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * Description: host stand-in for the c_utils parcel, values are appended to and read from an in-memory buffer.
+ * Author: zhangge
+ * Create: 2023-06-05
+ */
+
+#ifndef CAST_ENGINE_MOCK_PARCEL_H
+#define CAST_ENGINE_MOCK_PARCEL_H
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace OHOS {
+class Parcel {
+public:
+    virtual ~Parcel() = default;
+
+    bool WriteBool(bool value) { return WritePod(value); }
+    bool WriteUint8(uint8_t value) { return WritePod(value); }
+    bool WriteUint16(uint16_t value) { return WritePod(value); }
+    bool WriteInt32(int32_t value) { return WritePod(value); }
+    bool WriteUint32(uint32_t value) { return WritePod(value); }
+    bool WriteInt64(int64_t value) { return WritePod(value); }
+    bool WriteUint64(uint64_t value) { return WritePod(value); }
+    bool WriteFloat(float value) { return WritePod(value); }
+    bool WriteDouble(double value) { return WritePod(value); }
+    bool WriteString(const std::string &value)
+    {
+        return WriteUint32(static_cast<uint32_t>(value.size())) && WriteBuffer(value.data(), value.size());
+    }
+    bool WriteBuffer(const void *data, size_t size)
+    {
+        size_t offset = buffer_.size();
+        buffer_.resize(offset + size);
+        if (size > 0) {
+            std::memcpy(buffer_.data() + offset, data, size);
+        }
+        return true;
+    }
+
+    bool ReadBool() { return ReadPod<bool>(); }
+    uint8_t ReadUint8() { return ReadPod<uint8_t>(); }
+    uint16_t ReadUint16() { return ReadPod<uint16_t>(); }
+    int32_t ReadInt32() { return ReadPod<int32_t>(); }
+    uint32_t ReadUint32() { return ReadPod<uint32_t>(); }
+    int64_t ReadInt64() { return ReadPod<int64_t>(); }
+    uint64_t ReadUint64() { return ReadPod<uint64_t>(); }
+    float ReadFloat() { return ReadPod<float>(); }
+    double ReadDouble() { return ReadPod<double>(); }
+    std::string ReadString()
+    {
+        uint32_t size = ReadUint32();
+        const uint8_t *data = ReadBuffer(size);
+        return data == nullptr ? std::string() : std::string(reinterpret_cast<const char *>(data), size);
+    }
+    const uint8_t *ReadBuffer(size_t size)
+    {
+        if (size > buffer_.size() - readPos_) {
+            return nullptr;
+        }
+        const uint8_t *data = buffer_.data() + readPos_;
+        readPos_ += size;
+        return data;
+    }
+
+    size_t GetDataSize() const { return buffer_.size(); }
+    size_t GetReadableBytes() const { return buffer_.size() - readPos_; }
+
+private:
+    template<typename T>
+    bool WritePod(T value)
+    {
+        return WriteBuffer(&value, sizeof(value));
+    }
+
+    template<typename T>
+    T ReadPod()
+    {
+        T value{};
+        const uint8_t *data = ReadBuffer(sizeof(value));
+        if (data != nullptr) {
+            std::memcpy(&value, data, sizeof(value));
+        }
+        return value;
+    }
+
+    std::vector<uint8_t> buffer_;
+    size_t readPos_{ 0 };
+};
+} // namespace OHOS
+
+#endif
@@ -0,0 +1,58 @@
+/*
+ * Copyright (C) 2023-2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * Description: host stand-in for the multimedia pixel map.
+ * Author: zhangge
+ * Create: 2023-06-05
+ */
+
+#ifndef CAST_ENGINE_MOCK_PIXEL_MAP_H
+#define CAST_ENGINE_MOCK_PIXEL_MAP_H
+
+#include <cstdint>
+#include <memory>
+
+#include "parcel.h"
+
+namespace OHOS {
+namespace Media {
+struct Size {
+    int32_t width = 0;
+    int32_t height = 0;
+};
+
+class PixelMap {
+public:
+    virtual ~PixelMap() = default;
+    bool Marshalling(Parcel &parcel) const
+    {
+        return parcel.WriteInt32(0);
+    }
+    static PixelMap *Unmarshalling(Parcel &parcel)
+    {
+        parcel.ReadInt32();
+        return new PixelMap();
+    }
+    const uint8_t *GetPixels() const
+    {
+        return nullptr;
+    }
+    int32_t GetByteCount() const
+    {
+        return 0;
+    }
+};
+} // namespace Media
+} // namespace OHOS
+
+#endif
@@ -0,0 +1,163 @@
+/*
+ * Copyright (C) 2023-2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * Description: host stand-in for the multimedia player, the host tools install the player they drive.
+ * Author: zhangge
+ * Create: 2023-06-05
+ */
+
+#ifndef CAST_ENGINE_MOCK_PLAYER_H
+#define CAST_ENGINE_MOCK_PLAYER_H
+
+#include <climits>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "media_data_source.h"
+#include "media_errors.h"
+#include "surface_utils.h"
+
+namespace OHOS {
+namespace Media {
+enum PlaybackRateMode : int32_t {
+    SPEED_FORWARD_0_75_X,
+    SPEED_FORWARD_1_00_X,
+    SPEED_FORWARD_1_25_X,
+    SPEED_FORWARD_1_75_X,
+    SPEED_FORWARD_2_00_X,
+    SPEED_FORWARD_0_50_X,
+    SPEED_FORWARD_1_50_X,
+};
+
+enum PlayerSeekMode : int32_t {
+    SEEK_NEXT_SYNC = 0,
+    SEEK_PREVIOUS_SYNC,
+    SEEK_CLOSEST_SYNC,
+    SEEK_CLOSEST,
+};
+
+enum PlayerOnInfoType : int32_t {
+    INFO_TYPE_SEEKDONE = 1,
+    INFO_TYPE_SPEEDDONE,
+    INFO_TYPE_BITRATEDONE,
+    INFO_TYPE_EOS,
+    INFO_TYPE_STATE_CHANGE,
+    INFO_TYPE_POSITION_UPDATE,
+    INFO_TYPE_MESSAGE,
+    INFO_TYPE_RESOLUTION_CHANGE,
+    INFO_TYPE_VOLUME_CHANGE,
+    INFO_TYPE_BITRATE_COLLECT,
+    INFO_TYPE_BUFFERING_UPDATE,
+    INFO_TYPE_INTERRUPT_EVENT,
+    INFO_TYPE_DURATION_UPDATE,
+};
+
+class PlayerKeys {
+public:
+    static constexpr std::string_view PLAYER_BUFFERING_START = "buffering_start";
+    static constexpr std::string_view PLAYER_BUFFERING_END = "buffering_end";
+    static constexpr std::string_view PLAYER_CACHED_DURATION = "cached_duration";
+    static constexpr std::string_view PLAYER_WIDTH = "width";
+    static constexpr std::string_view PLAYER_HEIGHT = "height";
+    static constexpr std::string_view AUDIO_INTERRUPT_HINT = "audio_interrupt_hint";
+};
+
+class Format {
+public:
+    bool PutIntValue(const std::string &key, int32_t value)
+    {
+        intValues_[key] = value;
+        return true;
+    }
+    bool GetIntValue(const std::string &key, int32_t &value) const
+    {
+        auto iter = intValues_.find(key);
+        if (iter == intValues_.end()) {
+            return false;
+        }
+        value = iter->second;
+        return true;
+    }
+    bool ContainKey(const std::string &key) const
+    {
+        return intValues_.count(key) != 0;
+    }
+
+private:
+    std::map<std::string, int32_t> intValues_;
+};
+
+class PlayerCallback {
+public:
+    virtual ~PlayerCallback() = default;
+    virtual void OnInfo(PlayerOnInfoType type, int32_t extra, const Format &infoBody) = 0;
+    virtual void OnError(int32_t errorCode, const std::string &errorMsg) = 0;
+};
+
+class Player {
+public:
+    virtual ~Player() = default;
+    virtual int32_t SetSource(const std::string &url) = 0;
+    virtual int32_t SetSource(const std::shared_ptr<IMediaDataSource> &dataSrc) = 0;
+    virtual int32_t Play() = 0;
+    virtual int32_t Prepare() = 0;
+    virtual int32_t PrepareAsync() = 0;
+    virtual int32_t Pause() = 0;
+    virtual int32_t Stop() = 0;
+    virtual int32_t Reset() = 0;
+    virtual int32_t Release() = 0;
+    virtual int32_t Seek(int32_t mSeconds, PlayerSeekMode mode) = 0;
+    virtual int32_t SetVolume(float leftVolume, float rightVolume) = 0;
+    virtual int32_t GetCurrentTime(int32_t &currentTime) = 0;
+    virtual int32_t GetVideoTrackInfo(std::vector<Format> &videoTrack) = 0;
+    virtual int32_t GetAudioTrackInfo(std::vector<Format> &audioTrack) = 0;
+    virtual int32_t GetVideoWidth() = 0;
+    virtual int32_t GetVideoHeight() = 0;
+    virtual int32_t SetPlaybackSpeed(PlaybackRateMode mode) = 0;
+    virtual int32_t GetPlaybackSpeed(PlaybackRateMode &mode) = 0;
+    virtual int32_t SelectBitRate(uint32_t bitRate) = 0;
+    virtual int32_t GetDuration(int32_t &duration) = 0;
+    virtual int32_t SetVideoSurface(sptr<Surface> surface) = 0;
+    virtual bool IsPlaying() = 0;
+    virtual bool IsLooping() = 0;
+    virtual int32_t SetLooping(bool loop) = 0;
+    virtual int32_t SetPlayerCallback(const std::shared_ptr<PlayerCallback> &callback) = 0;
+    virtual int32_t SetParameter(const Format &param) = 0;
+    virtual int32_t SetPlayRangeWithMode(int64_t start, int64_t end) = 0;
+};
+
+class PlayerFactory {
+public:
+    using Creator = std::function<std::shared_ptr<Player>(void)>;
+
+    // No player exists on the host until a tool installs the one it drives.
+    static std::shared_ptr<Player> CreatePlayer()
+    {
+        Creator &creator = GetCreator();
+        return creator ? creator() : nullptr;
+    }
+    static Creator &GetCreator()
+    {
+        static Creator creator;
+        return creator;
+    }
+};
+} // namespace Media
+} // namespace OHOS
+
+#endif
@@ -0,0 +1,65 @@
+/*
+ * Copyright (C) 2023-2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * Description: host stand-in for the power manager client, the host screen is always on.
+ * Author: zhangge
+ * Create: 2023-06-05
+ */
+
+#ifndef CAST_ENGINE_MOCK_POWER_MGR_CLIENT_H
+#define CAST_ENGINE_MOCK_POWER_MGR_CLIENT_H
+
+#include <string>
+
+namespace OHOS {
+namespace PowerMgr {
+enum class PowerErrors : int32_t {
+    ERR_OK = 0,
+};
+
+enum class WakeupDeviceType : uint32_t {
+    WAKEUP_DEVICE_APPLICATION = 1,
+};
+
+class PowerMgrClient {
+public:
+    static PowerMgrClient &GetInstance()
+    {
+        static PowerMgrClient instance;
+        return instance;
+    }
+    bool SetForceTimingOut(bool enabled)
+    {
+        return true;
+    }
+    bool LockScreenAfterTimingOut(bool enabledLockScreen, bool checkLock, bool sendScreenOffEvent)
+    {
+        return true;
+    }
+    bool IsScreenOn()
+    {
+        return true;
+    }
+    PowerErrors WakeupDevice(WakeupDeviceType reason, const std::string &detail)
+    {
+        return PowerErrors::ERR_OK;
+    }
+    PowerErrors SuspendDevice()
+    {
+        return PowerErrors::ERR_OK;
+    }
+};
+} // namespace PowerMgr
+} // namespace OHOS
+
+#endif
@@ -0,0 +1,44 @@
+/*
+ * Copyright (C) 2023-2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * Description: host stand-in for the c_utils reference counted objects, sptr is a std::shared_ptr alias.
+ * Author: zhangge
+ * Create: 2023-06-05
+ */
+
+#ifndef CAST_ENGINE_MOCK_REFBASE_H
+#define CAST_ENGINE_MOCK_REFBASE_H
+
+#include <memory>
+#include <utility>
+
+namespace OHOS {
+class RefBase : public std::enable_shared_from_this<RefBase> {
+public:
+    virtual ~RefBase() = default;
+};
+
+template<typename T>
+using sptr = std::shared_ptr<T>;
+
+template<typename T>
+using wptr = std::weak_ptr<T>;
+
+template<typename T, typename... Args>
+sptr<T> MakeSptr(Args &&...args)
+{
+    return std::make_shared<T>(std::forward<Args>(args)...);
+}
+} // namespace OHOS
+
+#endif
@@ -0,0 +1,94 @@
+/*
+ * Copyright (C) 2023-2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * Description: host stand-in for the bounds checking functions used by the cast engine.
+ * Author: zhangge
+ * Create: 2023-06-05
+ */
+
+#ifndef CAST_ENGINE_MOCK_SECUREC_H
+#define CAST_ENGINE_MOCK_SECUREC_H
+
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+
+#ifndef EOK
+#define EOK 0
+#endif
+#define ERANGE_AND_RESET 162
+
+typedef int errno_t;
+
+inline errno_t memcpy_s(void *dest, size_t destMax, const void *src, size_t count)
+{
+    if (dest == nullptr || src == nullptr || count > destMax) {
+        return ERANGE_AND_RESET;
+    }
+    memmove(dest, src, count);
+    return EOK;
+}
+
+inline errno_t memmove_s(void *dest, size_t destMax, const void *src, size_t count)
+{
+    return memcpy_s(dest, destMax, src, count);
+}
+
+inline errno_t memset_s(void *dest, size_t destMax, int c, size_t count)
+{
+    if (dest == nullptr || count > destMax) {
+        return ERANGE_AND_RESET;
+    }
+    memset(dest, c, count);
+    return EOK;
+}
+
+inline errno_t strcpy_s(char *dest, size_t destMax, const char *src)
+{
+    if (dest == nullptr || src == nullptr || strlen(src) >= destMax) {
+        return ERANGE_AND_RESET;
+    }
+    memcpy(dest, src, strlen(src) + 1);
+    return EOK;
+}
+
+inline errno_t strncpy_s(char *dest, size_t destMax, const char *src, size_t count)
+{
+    if (dest == nullptr || src == nullptr || count >= destMax) {
+        return ERANGE_AND_RESET;
+    }
+    size_t len = strnlen(src, count);
+    memcpy(dest, src, len);
+    dest[len] = '\0';
+    return EOK;
+}
+
+inline int sprintf_s(char *dest, size_t destMax, const char *format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    int ret = vsnprintf(dest, destMax, format, args);
+    va_end(args);
+    return (ret < 0 || static_cast<size_t>(ret) >= destMax) ? -1 : ret;
+}
+
+inline int snprintf_s(char *dest, size_t destMax, size_t count, const char *format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    int ret = vsnprintf(dest, destMax, format, args);
+    va_end(args);
+    return (ret < 0 || static_cast<size_t>(ret) >= destMax) ? -1 : ret;
+}
+
+#endif
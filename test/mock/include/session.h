@@ -0,0 +1,177 @@
+/*
+ * Copyright (C) 2023-2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * Description: host stand-in for the SoftBus session API, sessions can never be opened on the host.
+ * Author: zhangge
+ * Create: 2023-06-05
+ */
+
+#ifndef CAST_ENGINE_MOCK_SESSION_H
+#define CAST_ENGINE_MOCK_SESSION_H
+
+#include <cstdint>
+
+#define LINK_TYPE_MAX 9
+
+typedef enum {
+    TYPE_MESSAGE = 1,
+    TYPE_BYTES,
+    TYPE_FILE,
+    TYPE_STREAM,
+    TYPE_BUTT,
+} SessionType;
+
+typedef enum {
+    INVALID = -1,
+    RAW_STREAM,
+    COMMON_VIDEO_STREAM,
+    COMMON_AUDIO_STREAM,
+    VIDEO_SLICE_STREAM,
+} StreamType;
+
+typedef enum {
+    LINK_TYPE_WIFI_WLAN_5G = 1,
+    LINK_TYPE_WIFI_WLAN_2G = 2,
+    LINK_TYPE_WIFI_P2P = 3,
+    LINK_TYPE_BR = 4,
+    LINK_TYPE_BLE = 5,
+    LINK_TYPE_WIFI_P2P_REUSE = 6,
+    LINK_TYPE_BLE_DIRECT = 7,
+    LINK_TYPE_COC = 8,
+    LINK_TYPE_COC_DIRECT = 9,
+} LinkType;
+
+typedef struct {
+    int dataType;
+    int linkTypeNum;
+    LinkType linkType[LINK_TYPE_MAX];
+    union {
+        struct StreamAttr {
+            int streamType;
+        } streamAttr;
+    } attr;
+    uint8_t *fastTransData;
+    uint16_t fastTransDataSize;
+} SessionAttribute;
+
+typedef struct {
+    char *buf;
+    int bufLen;
+} StreamData;
+
+typedef struct {
+    int type;
+    int64_t value;
+} TV;
+
+typedef struct {
+    int frameType;
+    int64_t timeStamp;
+    int seqNum;
+    int seqSubNum;
+    int level;
+    int bitMap;
+    int tvCount;
+    TV *tvList;
+} StreamFrameInfo;
+
+typedef struct {
+    int type;
+    int value;
+} QosTv;
+
+typedef struct {
+    int (*OnSessionOpened)(int sessionId, int result);
+    void (*OnSessionClosed)(int sessionId);
+    void (*OnBytesReceived)(int sessionId, const void *data, unsigned int dataLen);
+    void (*OnMessageReceived)(int sessionId, const void *data, unsigned int dataLen);
+    void (*OnStreamReceived)(int sessionId, const StreamData *data, const StreamData *ext,
+        const StreamFrameInfo *param);
+    void (*OnQosEvent)(int sessionId, int eventId, int tvCount, const QosTv *tvList);
+} ISessionListener;
+
+typedef struct {
+    int (*OnSendFileProcess)(int sessionId, uint64_t bytesUpload, uint64_t bytesTotal);
+    int (*OnSendFileFinished)(int sessionId, const char *firstFile);
+    void (*OnFileTransError)(int sessionId);
+} IFileSendListener;
+
+typedef struct {
+    int (*OnReceiveFileStarted)(int sessionId, const char *files, int fileCnt);
+    int (*OnReceiveFileProcess)(int sessionId, const char *firstFile, uint64_t bytesUpload, uint64_t bytesTotal);
+    void (*OnReceiveFileFinished)(int sessionId, const char *files, int fileCnt);
+    void (*OnFileTransError)(int sessionId);
+} IFileReceiveListener;
+
+constexpr int CAST_ENGINE_MOCK_SOFTBUS_ERR = -1;
+
+inline int CreateSessionServer(const char *pkgName, const char *sessionName, const ISessionListener *listener)
+{
+    return CAST_ENGINE_MOCK_SOFTBUS_ERR;
+}
+
+inline int RemoveSessionServer(const char *pkgName, const char *sessionName)
+{
+    return 0;
+}
+
+inline int OpenSession(const char *mySessionName, const char *peerSessionName, const char *peerNetworkId,
+    const char *groupId, const SessionAttribute *attr)
+{
+    return CAST_ENGINE_MOCK_SOFTBUS_ERR;
+}
+
+inline void CloseSession(int sessionId) {}
+
+inline int SendBytes(int sessionId, const void *data, unsigned int len)
+{
+    return CAST_ENGINE_MOCK_SOFTBUS_ERR;
+}
+
+inline int SendStream(int sessionId, const StreamData *data, const StreamData *ext, const StreamFrameInfo *param)
+{
+    return CAST_ENGINE_MOCK_SOFTBUS_ERR;
+}
+
+inline int SendFile(int sessionId, const char *sFileList[], const char *dFileList[], uint32_t fileCnt)
+{
+    return CAST_ENGINE_MOCK_SOFTBUS_ERR;
+}
+
+inline int GetMySessionName(int sessionId, char *sessionName, unsigned int len)
+{
+    return CAST_ENGINE_MOCK_SOFTBUS_ERR;
+}
+
+inline int GetPeerSessionName(int sessionId, char *sessionName, unsigned int len)
+{
+    return CAST_ENGINE_MOCK_SOFTBUS_ERR;
+}
+
+inline int GetPeerDeviceId(int sessionId, char *networkId, unsigned int len)
+{
+    return CAST_ENGINE_MOCK_SOFTBUS_ERR;
+}
+
+inline int SetFileSendListener(const char *pkgName, const char *sessionName, const IFileSendListener *sendListener)
+{
+    return 0;
+}
+
+inline int SetFileReceiveListener(const char *pkgName, const char *sessionName,
+    const IFileReceiveListener *recvListener, const char *rootDir)
+{
+    return 0;
+}
+
+#endif
@@ -0,0 +1,68 @@
+/*
+ * Copyright (C) 2023-2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * Description: host stand-in for the c_utils singleton helpers.
+ * Author: zhangge
+ * Create: 2023-06-05
+ */
+
+#ifndef CAST_ENGINE_MOCK_SINGLETON_H
+#define CAST_ENGINE_MOCK_SINGLETON_H
+
+#include <memory>
+#include <mutex>
+
+namespace OHOS {
+#define DECLARE_SINGLETON(MyClass)            \
+public:                                       \
+    MyClass(const MyClass &) = delete;        \
+    MyClass &operator=(const MyClass &) = delete; \
+                                              \
+private:                                      \
+    friend class Singleton<MyClass>;          \
+    MyClass();                                \
+    ~MyClass();
+
+#define DECLARE_DELAYED_SINGLETON(MyClass)    \
+public:                                       \
+    MyClass(const MyClass &) = delete;        \
+    MyClass &operator=(const MyClass &) = delete; \
+    ~MyClass();                               \
+                                              \
+private:                                      \
+    friend class DelayedSingleton<MyClass>;   \
+    MyClass();
+
+template<typename T>
+class Singleton {
+public:
+    static T &GetInstance()
+    {
+        static T instance;
+        return instance;
+    }
+};
+
+template<typename T>
+class DelayedSingleton {
+public:
+    static std::shared_ptr<T> GetInstance()
+    {
+        static std::shared_ptr<T> instance(new T(), [](T *p) { delete p; });
+        return instance;
+    }
+    static void DestroyInstance() {}
+};
+} // namespace OHOS
+
+#endif
@@ -0,0 +1,47 @@
+/*
+ * Copyright (C) 2023-2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * Description: host stand-in for the SoftBus socket API types.
+ * Author: zhangge
+ * Create: 2023-06-05
+ */
+
+#ifndef CAST_ENGINE_MOCK_SOCKET_H
+#define CAST_ENGINE_MOCK_SOCKET_H
+
+#include <cstdint>
+
+#include "session.h"
+
+typedef enum {
+    FILE_EVENT_SEND_PROCESS,
+    FILE_EVENT_SEND_FINISH,
+    FILE_EVENT_SEND_ERROR,
+    FILE_EVENT_RECV_UPDATE_PATH,
+    FILE_EVENT_RECV_START,
+    FILE_EVENT_RECV_PROCESS,
+    FILE_EVENT_RECV_FINISH,
+    FILE_EVENT_RECV_ERROR,
+    FILE_EVENT_BUTT,
+} FileEventType;
+
+typedef struct {
+    FileEventType type;
+    const char **files;
+    uint32_t fileCnt;
+    uint64_t bytesProcessed;
+    uint64_t bytesTotal;
+    const char *(*UpdateRecvPath)();
+} FileEvent;
+
+#endif
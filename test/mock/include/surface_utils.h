@@ -0,0 +1,52 @@
+/*
+ * Copyright (C) 2023-2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * Description: host stand-in for the graphic surface utilities.
+ * Author: zhangge
+ * Create: 2023-06-05
+ */
+
+#ifndef CAST_ENGINE_MOCK_SURFACE_UTILS_H
+#define CAST_ENGINE_MOCK_SURFACE_UTILS_H
+
+#include <cstdint>
+
+#include "iremote_broker.h"
+#include "refbase.h"
+
+namespace OHOS {
+class IBufferProducer : public IRemoteBroker {};
+
+class Surface : public RefBase {
+public:
+    static sptr<Surface> CreateSurfaceAsProducer(sptr<IBufferProducer> &producer)
+    {
+        return producer ? std::make_shared<Surface>() : nullptr;
+    }
+};
+
+class SurfaceUtils {
+public:
+    static SurfaceUtils *GetInstance()
+    {
+        static SurfaceUtils instance;
+        return &instance;
+    }
+    sptr<Surface> GetSurface(uint64_t uniqueId)
+    {
+        return nullptr;
+    }
+};
+} // namespace OHOS
+
+#endif
@@ -0,0 +1,29 @@
+/*
+ * Copyright (C) 2023-2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * Description: host stand-in for the system ability ids used by the cast engine.
+ * Author: zhangge
+ * Create: 2023-06-05
+ */
+
+#ifndef CAST_ENGINE_MOCK_SYSTEM_ABILITY_DEFINITION_H
+#define CAST_ENGINE_MOCK_SYSTEM_ABILITY_DEFINITION_H
+
+namespace OHOS {
+enum {
+    WIFI_DEVICE_ABILITY_ID = 1120,
+    CAST_ENGINE_SA_ID = 5526,
+};
+} // namespace OHOS
+
+#endif
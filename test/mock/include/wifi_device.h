@@ -0,0 +1,53 @@
+/*
+ * Copyright (C) 2023-2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * Description: host stand-in for the wifi device client, there is never a wifi ip on the host.
+ * Author: zhangge
+ * Create: 2023-06-05
+ */
+
+#ifndef CAST_ENGINE_MOCK_WIFI_DEVICE_H
+#define CAST_ENGINE_MOCK_WIFI_DEVICE_H
+
+#include <memory>
+
+#include "errors.h"
+#include "system_ability_definition.h"
+
+namespace OHOS {
+namespace Wifi {
+constexpr int BITS_8 = 8;
+constexpr int BITS_16 = 16;
+constexpr int BITS_24 = 24;
+constexpr ErrCode WIFI_OPT_SUCCESS = 0;
+constexpr ErrCode WIFI_OPT_FAILED = 1;
+
+struct IpInfo {
+    unsigned int ipAddress = 0;
+};
+
+class WifiDevice {
+public:
+    static std::shared_ptr<WifiDevice> GetInstance(int systemAbilityId)
+    {
+        return nullptr;
+    }
+    ErrCode GetIpInfo(IpInfo &info)
+    {
+        return WIFI_OPT_FAILED;
+    }
+};
+} // namespace Wifi
+} // namespace OHOS
+
+#endif
@@ -0,0 +1,368 @@
+/*
+ * Copyright (C) 2023-2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * Description: replays a session trace against a virtual clock and reports the session timings as json.
+ * Author: zhangge
+ * Create: 2023-06-05
+ */
+
+#include <algorithm>
+#include <cstdlib>
+#include <deque>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+
+#include "cast_session_common.h"
+#include "cast_trace.h"
+#include "json.hpp"
+#include "parameters.h"
+#include "rtsp_controller.h"
+#include "rtsp_parse.h"
+#include "rtsp_session_pair.h"
+
+namespace OHOS {
+namespace CastEngine {
+namespace CastEngineService {
+namespace {
+using nlohmann::json;
+using CastSessionRtsp::IRtspController;
+using CastSessionRtsp::RtspController;
+using CastSessionRtsp::RtspParse;
+
+// Same as RtspController::REQUEST_TIMEOUT_MS, a request without a response after this long counts as timed out.
+constexpr int DEFAULT_REQUEST_TIMEOUT_MS = 10000;
+constexpr uint64_t US_PER_MS = 1000;
+// The rtt of the link the sample is recorded on and how long any step of it may take.
+constexpr int64_t SAMPLE_RTT_MS = 20;
+constexpr int SAMPLE_TIMEOUT_MS = 5000;
+// Only the source end of a trace is replayed, the records of a sink recorded alongside it are left out.
+constexpr uint16_t REPLAYED_END = static_cast<uint16_t>(EndType::CAST_SOURCE);
+
+struct ReplayOptions {
+    std::string recordSample;
+    std::string tracePath;
+    int requestTimeoutMs{ DEFAULT_REQUEST_TIMEOUT_MS };
+};
+
+struct RtspStats {
+    uint64_t requests{ 0 };
+    uint64_t responses{ 0 };
+    uint64_t timeouts{ 0 };
+    uint64_t unmatched{ 0 };
+    uint64_t maxResponseUs{ 0 };
+    uint64_t totalResponseUs{ 0 };
+};
+
+struct ControllerStats {
+    uint64_t fed{ 0 };
+    uint64_t matched{ 0 };
+    uint64_t redriven{ 0 };
+    uint64_t divergences{ 0 };
+    uint64_t negotiationUs{ 0 };
+    json firstDivergence;
+};
+
+// Keeps what the replayed controller sends until the trace tells what the recorded one sent at that point.
+class CaptureChannel : public Channel {
+public:
+    CaptureChannel()
+    {
+        ChannelRequest request;
+        request.linkType = ChannelLinkType::TCP;
+        request.moduleType = ModuleType::RTSP;
+        SetRequest(request);
+    }
+
+    bool Send(const uint8_t *buffer, int length) override
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        sent_.emplace_back(reinterpret_cast<const char *>(buffer), length);
+        return true;
+    }
+
+    bool Take(std::string &msg)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (sent_.empty()) {
+            return false;
+        }
+        msg = std::move(sent_.front());
+        sent_.pop_front();
+        return true;
+    }
+
+private:
+    std::mutex mutex_;
+    std::deque<std::string> sent_;
+};
+
+const char *TypeName(TraceRecordType type)
+{
+    switch (type) {
+        case TraceRecordType::CHANNEL_RX:
+            return "channel_rx";
+        case TraceRecordType::CHANNEL_TX:
+            return "channel_tx";
+        case TraceRecordType::RTSP_RX:
+            return "rtsp_rx";
+        case TraceRecordType::RTSP_TX:
+            return "rtsp_tx";
+        case TraceRecordType::HANDLER_MESSAGE:
+            return "handler_message";
+        case TraceRecordType::SESSION_STATE:
+            return "session_state";
+        default:
+            return "unknown";
+    }
+}
+
+std::string StateName(uint16_t state)
+{
+    static const char *const names[] = { "DEFAULT", "DISCONNECTED", "CONNECTING", "CONNECTED", "PLAYING", "PAUSED",
+        "DISCONNECTING", "STREAM", "AUTHING", "MIRROR_TO_STREAM", "STREAM_TO_MIRROR" };
+    return state < sizeof(names) / sizeof(names[0]) ? names[state] : std::to_string(state);
+}
+
+// The first line and the CSeq, the rest carries dates and negotiated values that differ from run to run.
+std::string Summarize(const std::string &msg)
+{
+    RtspParse parsed;
+    RtspParse::ParseMsg(msg, parsed);
+    return parsed.GetFirstLine() + " CSeq " + std::to_string(parsed.GetSeq());
+}
+
+/*
+ * Runs a source and a sink RtspController against each other through the real recorder: the negotiation, a PLAY from
+ * the sink and a keep alive the sink never gets because the link to it went down. The session states come from here,
+ * in place of the session state machine.
+ */
+int RecordSample(const std::string &path)
+{
+    system::SetParameter(PARAM_SESSION_TRACE, "true");
+    system::SetParameter(PARAM_SESSION_TRACE_PATH, path);
+    auto &recorder = CastTraceRecorder::GetInstance();
+    if (!recorder.IsEnabled()) {
+        std::cerr << "session trace is not compiled in or the trace file can not be opened" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    RtspSessionPair pair({ SAMPLE_RTT_MS * static_cast<int64_t>(US_PER_MS), 0, 1 });
+    recorder.RecordState(static_cast<uint16_t>(SessionState::CONNECTING));
+    bool isRecorded = pair.Start() && pair.WaitEstablished(SAMPLE_TIMEOUT_MS) >= 0;
+    if (isRecorded) {
+        recorder.RecordState(static_cast<uint16_t>(SessionState::CONNECTED));
+        isRecorded = pair.GetSink()->Action(CastSessionRtsp::ActionType::PLAY) &&
+            pair.GetSourceListener()->WaitPlay(SAMPLE_TIMEOUT_MS);
+    }
+    if (isRecorded) {
+        recorder.RecordState(static_cast<uint16_t>(SessionState::PLAYING));
+        pair.GetSourceToSink()->SetDown(true);
+        std::static_pointer_cast<RtspController>(pair.GetSource())->OnTimeKeepAlive();
+    }
+    pair.Stop();
+    recorder.Stop();
+    if (!isRecorded) {
+        std::cerr << "the controllers did not get to play" << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
+
+// Pairs the requests and responses of the recorded end on the virtual clock.
+void TrackTransaction(CastTraceReplayer &replayer, const TraceRecord &record, RtspParse &msg,
+    uint64_t timeoutUs, std::map<std::pair<bool, int>, uint64_t> &pending, RtspStats &stats)
+{
+    bool isTx = record.type == TraceRecordType::RTSP_TX;
+    int cseq = msg.GetSeq();
+    if (msg.GetMethod() != CastSessionRtsp::RtspMethod::RESPONSE) {
+        stats.requests++;
+        auto key = std::make_pair(isTx, cseq);
+        pending[key] = replayer.Now();
+        replayer.Schedule(replayer.Now() + timeoutUs, [&pending, &stats, key] {
+            if (pending.erase(key) > 0) {
+                stats.timeouts++;
+            }
+        });
+        return;
+    }
+    // A response answers the request of the other side.
+    auto iter = pending.find(std::make_pair(!isTx, cseq));
+    if (iter == pending.end()) {
+        stats.unmatched++;
+        return;
+    }
+    uint64_t elapsed = replayer.Now() - iter->second;
+    stats.responses++;
+    stats.totalResponseUs += elapsed;
+    stats.maxResponseUs = std::max(stats.maxResponseUs, elapsed);
+    pending.erase(iter);
+}
+
+void CheckSent(const std::string &recorded, RtspParse &msg, uint64_t nowUs,
+    const std::shared_ptr<RtspController> &controller, CaptureChannel &channel, ControllerStats &stats)
+{
+    std::string replayed;
+    if (!channel.Take(replayed) && msg.GetMethod() == CastSessionRtsp::RtspMethod::GET_PARAMETER) {
+        // Nothing fed in so far made the controller send it, so a timer did, and the keep alive is the only request
+        // one sends. Its timers run on the real clock, the replay sends it at the recorded time instead.
+        controller->OnTimeKeepAlive();
+        stats.redriven++;
+        channel.Take(replayed);
+    }
+    if (Summarize(replayed) == Summarize(recorded)) {
+        stats.matched++;
+        return;
+    }
+    if (stats.divergences++ == 0) {
+        stats.firstDivergence = { { "at_us", nowUs }, { "recorded", Summarize(recorded) },
+            { "replayed", replayed.empty() ? "" : Summarize(replayed) } };
+    }
+}
+
+int Replay(const ReplayOptions &options)
+{
+    CastTraceReplayer replayer(options.tracePath);
+    if (!replayer.Load()) {
+        std::cerr << "can not load " << options.tracePath << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // The trace holds the plain messages, so the controller runs without a session key.
+    auto listener = std::make_shared<RtspEndListener>(EndType::CAST_SOURCE);
+    auto controller = std::static_pointer_cast<RtspController>(IRtspController::GetInstance(listener,
+        ProtocolType::CAST_PLUS_MIRROR, EndType::CAST_SOURCE));
+    listener->SetController(controller);
+    auto channel = std::make_shared<CaptureChannel>();
+    if (!controller->Start(CastSessionRtsp::ParamInfo(), nullptr, 0)) {
+        std::cerr << "can not start the controller" << std::endl;
+        return EXIT_FAILURE;
+    }
+    CastInnerRemoteDevice sink;
+    sink.deviceId = "replayed-sink";
+    sink.channelType = ChannelType::LEGACY_CHANNEL;
+    controller->AddChannel(channel, sink);
+
+    const uint64_t timeoutUs = static_cast<uint64_t>(options.requestTimeoutMs) * US_PER_MS;
+    std::map<std::string, uint64_t> counts;
+    // Outstanding requests keyed by (sent by us, CSeq), the two sides number their requests independently.
+    std::map<std::pair<bool, int>, uint64_t> pending;
+    RtspStats stats;
+    ControllerStats controllerStats;
+    uint64_t records = 0;
+    uint64_t firstRtspUs = 0;
+    bool isRtspSeen = false;
+    replayer.Replay([&](const TraceRecord &record) {
+        records++;
+        counts[TypeName(record.type)]++;
+        bool isRtsp = record.type == TraceRecordType::RTSP_RX || record.type == TraceRecordType::RTSP_TX;
+        if (!isRtsp || record.tag != REPLAYED_END) {
+            return;
+        }
+        if (!isRtspSeen) {
+            isRtspSeen = true;
+            firstRtspUs = replayer.Now();
+        }
+        std::string payload(record.payload.begin(), record.payload.end());
+        RtspParse msg;
+        RtspParse::ParseMsg(payload, msg);
+        TrackTransaction(replayer, record, msg, timeoutUs, pending, stats);
+        if (record.type == TraceRecordType::RTSP_TX) {
+            CheckSent(payload, msg, replayer.Now(), controller, *channel, controllerStats);
+            return;
+        }
+        controller->GetChannelListener()->OnDataReceived(record.payload.data(),
+            static_cast<unsigned int>(record.payload.size()), 0);
+        controllerStats.fed++;
+        if (controllerStats.negotiationUs == 0 && listener->WaitSetup(0)) {
+            controllerStats.negotiationUs = replayer.Now() - firstRtspUs;
+        }
+    }, timeoutUs);
+    // Whatever the controller sent beyond the trace diverges as well.
+    for (std::string extra; channel->Take(extra);) {
+        controllerStats.divergences++;
+    }
+
+    json result;
+    result["trace"] = options.tracePath;
+    result["records"] = records;
+    result["duration_us"] = replayer.Now();
+    result["counts"] = counts;
+    json dwell = json::object();
+    for (const auto &[state, timeUs] : replayer.GetStateDwellTimeUs()) {
+        dwell[StateName(state)] = timeUs;
+    }
+    result["state_dwell_us"] = dwell;
+    result["negotiation_us"] = replayer.GetNegotiationTimeUs(static_cast<uint16_t>(SessionState::PLAYING));
+    result["controller"] = {
+        { "end", "source" },
+        { "fed", controllerStats.fed },
+        { "matched", controllerStats.matched },
+        { "redriven", controllerStats.redriven },
+        { "divergences", controllerStats.divergences },
+        { "negotiation_us", controllerStats.negotiationUs },
+    };
+    if (controllerStats.divergences > 0) {
+        result["controller"]["first_divergence"] = controllerStats.firstDivergence;
+    }
+    result["rtsp"] = {
+        { "requests", stats.requests },
+        { "responses", stats.responses },
+        { "timeouts", stats.timeouts },
+        { "unmatched_responses", stats.unmatched },
+        { "max_response_us", stats.maxResponseUs },
+        { "avg_response_us", stats.responses == 0 ? 0 : stats.totalResponseUs / stats.responses },
+    };
+    std::cout << result.dump(2) << std::endl;
+    return controllerStats.divergences == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+bool ParseOptions(int argc, char *argv[], ReplayOptions &options)
+{
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--record-sample" && i + 1 < argc) {
+            options.recordSample = argv[++i];
+        } else if (arg == "--request-timeout-ms" && i + 1 < argc) {
+            options.requestTimeoutMs = std::atoi(argv[++i]);
+        } else if (!arg.empty() && arg[0] != '-' && options.tracePath.empty()) {
+            options.tracePath = arg;
+        } else {
+            return false;
+        }
+    }
+    return !options.recordSample.empty() || (!options.tracePath.empty() && options.requestTimeoutMs > 0);
+}
+} // namespace
+
+int RunTraceReplay(int argc, char *argv[])
+{
+    ReplayOptions options;
+    if (!ParseOptions(argc, argv, options)) {
+        std::cerr << "usage: cast_trace_replay [--request-timeout-ms <ms>] <trace>" << std::endl;
+        std::cerr << "       cast_trace_replay --record-sample <trace>" << std::endl;
+        return EXIT_FAILURE;
+    }
+    return options.recordSample.empty() ? Replay(options) : RecordSample(options.recordSample);
+}
+} // namespace CastEngineService
+} // namespace CastEngine
+} // namespace OHOS
+
+int main(int argc, char *argv[])
+{
+    return OHOS::CastEngine::CastEngineService::RunTraceReplay(argc, argv);
+}
@@ -0,0 +1,147 @@
+/*
+ * Copyright (C) 2023-2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * Description: measures the cost of the per-header logs of the rtsp receive path, compiled out, compiled in but filtered at runtime and emitted, with json output.
+ * Author: zhangge
+ * Create: 2023-06-05
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include "cast_engine_log.h"
+#include "json.hpp"
+#include "rtsp_parse.h"
+
+namespace OHOS {
+namespace CastEngine {
+namespace CastEngineService {
+namespace {
+using nlohmann::json;
+using CastSessionRtsp::RtspParse;
+
+// An M4 request of a source, the longest message a sink parses during the negotiation.
+constexpr char M4_REQUEST[] = "SET_PARAMETER rtsp://localhost/wfd1.0 RTSP/1.0\r\n"
+    "CSeq: 4\r\n"
+    "Content-Type: text/parameters\r\n"
+    "Content-Length: 396\r\n"
+    "\r\n"
+    "wfd_video_formats: 00 00 02 10 0001ffff 1fffffff 00001fff 00 0000 0000 00 none none\r\n"
+    "wfd_audio_codecs: AAC 00000001 00\r\n"
+    "wfd_presentation_URL: rtsp://192.168.1.20/wfd1.0/streamid=0 none\r\n"
+    "wfd_client_rtp_ports: RTP/AVP/UDP;unicast 19000 0 mode=play\r\n"
+    "wfd_vnd_cast_version: 1.0\r\n"
+    "wfd_vnd_cast_keep_alive: 1\r\n"
+    "wfd_vnd_cast_mux: 0\r\n";
+
+struct BenchOptions {
+    int iterations{ 200000 };
+    std::string verboseBuild;
+};
+
+json Measure(int iterations)
+{
+    const std::string message = M4_REQUEST;
+    uint64_t checksum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        RtspParse msg;
+        RtspParse::ParseMsg(message, msg);
+        checksum += static_cast<uint64_t>(msg.GetSeq());
+    }
+    double elapsedNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    return { { "log_min_level", CAST_LOG_MIN_LEVEL }, { "log_runtime_level", CastLogRuntimeLevel() },
+        { "ns_per_parse", elapsedNs / iterations }, { "parsed", checksum == 4ULL * iterations } };
+}
+
+// Runs the build with the logs compiled in at the given runtime level, with whatever it logs thrown away.
+json RunVerboseBuild(const BenchOptions &options, int runtimeLevel)
+{
+    std::string command = "env " + std::string(CAST_LOG_LEVEL_PARAM) + "=" + std::to_string(runtimeLevel) + " '" +
+        options.verboseBuild + "' --iterations " + std::to_string(options.iterations) + " 2>/dev/null";
+    FILE *pipe = popen(command.c_str(), "r");
+    if (pipe == nullptr) {
+        return json();
+    }
+    std::string output;
+    char buf[256];
+    size_t size = 0;
+    while ((size = fread(buf, 1, sizeof(buf), pipe)) > 0) {
+        output.append(buf, size);
+    }
+    return pclose(pipe) == 0 ? json::parse(output, nullptr, false) : json();
+}
+
+bool IsMeasured(const json &result)
+{
+    return result.is_object() && result.value("parsed", false);
+}
+
+bool ParseOptions(int argc, char *argv[], BenchOptions &options)
+{
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string arg = argv[i];
+        if (arg == "--iterations") {
+            options.iterations = std::atoi(argv[i + 1]);
+        } else if (arg == "--verbose-build") {
+            options.verboseBuild = argv[i + 1];
+        } else {
+            return false;
+        }
+    }
+    return argc % 2 == 1 && options.iterations > 0;
+}
+} // namespace
+
+/*
+ * Without --verbose-build it only measures its own build. With it, it compares its own build, where the verbose logs
+ * are compiled out, against the given build of this tool with every log compiled in, once filtered at runtime and
+ * once emitted.
+ */
+int RunLogOverheadBench(int argc, char *argv[])
+{
+    BenchOptions options;
+    if (!ParseOptions(argc, argv, options)) {
+        std::cerr << "usage: log_overhead_bench [--iterations <n>] [--verbose-build <path>]" << std::endl;
+        return EXIT_FAILURE;
+    }
+    json own = Measure(options.iterations);
+    if (options.verboseBuild.empty()) {
+        std::cout << own.dump(4) << std::endl;
+        return IsMeasured(own) ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+    json filtered = RunVerboseBuild(options, CAST_LOG_LEVEL_ERROR);
+    json emitted = RunVerboseBuild(options, CAST_LOG_LEVEL_VERBOSE);
+    bool isPassed = IsMeasured(own) && IsMeasured(filtered) && IsMeasured(emitted) &&
+        own["log_min_level"].get<int>() > CAST_LOG_LEVEL_VERBOSE && filtered["log_min_level"] == CAST_LOG_LEVEL_VERBOSE;
+    json result = { { "compiled_out", own }, { "runtime_filtered", filtered }, { "emitted", emitted },
+        { "passed", isPassed } };
+    if (isPassed) {
+        double base = own["ns_per_parse"].get<double>();
+        result["runtime_filtered_overhead_pct"] = (filtered["ns_per_parse"].get<double>() / base - 1) * 100;
+        result["emitted_overhead_pct"] = (emitted["ns_per_parse"].get<double>() / base - 1) * 100;
+    }
+    std::cout << result.dump(4) << std::endl;
+    return isPassed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+} // namespace CastEngineService
+} // namespace CastEngine
+} // namespace OHOS
+
+int main(int argc, char *argv[])
+{
+    return OHOS::CastEngine::CastEngineService::RunLogOverheadBench(argc, argv);
+}
@@ -0,0 +1,220 @@
+/*
+ * Copyright (C) 2023-2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * Description: pushes mirror input events through MirrorInputRing over two mappings of one memfd, off the device.
+ * Author: zhangge
+ * Create: 2023-06-05
+ */
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "cast_engine_metrics.h"
+#include "json.hpp"
+#include "mirror_input_ring.h"
+
+namespace OHOS {
+namespace CastEngine {
+namespace {
+using nlohmann::json;
+
+struct RingOptions {
+    int events{ 200000 };
+    int handleUs{ 0 };
+};
+
+/*
+ * The service end: a doorbell stands for the one-way DRAIN_INPUT_RING request and is handled on its own thread, the
+ * way the binder thread of the service runs MirrorPlayerImpl::DrainInputRing. The ring it drains is its own mapping.
+ */
+class RingService {
+public:
+    RingService(std::shared_ptr<MirrorInputRing> ring, const RingOptions &options)
+        : ring_(std::move(ring)), options_(options), thread_([this] { Loop(); }) {}
+
+    ~RingService()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            isStopped_ = true;
+        }
+        cond_.notify_all();
+        thread_.join();
+    }
+
+    void RingDoorbell()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            doorbells_++;
+            pendingDoorbells_++;
+        }
+        cond_.notify_all();
+    }
+
+    // The synchronous drain of the client when the ring is full, it runs on the calling thread.
+    void Drain()
+    {
+        ring_->Drain([this](MirrorInputRing::EventKind kind, const OHRemoteControlEvent &event, int64_t queuedUs) {
+            OnEvent(event, queuedUs);
+        });
+    }
+
+    bool WaitForEvents(int count)
+    {
+        constexpr int waitTimeoutMs = 10000;
+        std::unique_lock<std::mutex> lock(mutex_);
+        return cond_.wait_for(lock, std::chrono::milliseconds(waitTimeoutMs),
+            [this, count] { return received_ >= count; });
+    }
+
+    json GetResult() const
+    {
+        auto snapshot = queuedUs_.GetSnapshot();
+        return { { "received", received_ }, { "in_order", isInOrder_ }, { "doorbells", doorbells_ },
+            { "events_per_doorbell", doorbells_ > 0 ? static_cast<double>(received_) / doorbells_ : 0.0 },
+            { "queued_us", { { "p50", snapshot.p50 }, { "p99", snapshot.p99 }, { "max", snapshot.max } } } };
+    }
+
+    bool IsInOrder() const
+    {
+        return isInOrder_;
+    }
+
+private:
+    void Loop()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (true) {
+            cond_.wait(lock, [this] { return isStopped_ || pendingDoorbells_ > 0; });
+            if (isStopped_) {
+                return;
+            }
+            pendingDoorbells_--;
+            lock.unlock();
+            Drain();
+            lock.lock();
+        }
+    }
+
+    void OnEvent(const OHRemoteControlEvent &event, int64_t queuedUs)
+    {
+        if (options_.handleUs > 0) {
+            std::this_thread::sleep_for(std::chrono::microseconds(options_.handleUs));
+        }
+        queuedUs_.Record(static_cast<uint64_t>(queuedUs));
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (static_cast<int>(event.mouseEvent.x) != received_) {
+            isInOrder_ = false;
+        }
+        received_++;
+        cond_.notify_all();
+    }
+
+    std::shared_ptr<MirrorInputRing> ring_;
+    const RingOptions &options_;
+    std::mutex mutex_;
+    std::condition_variable cond_;
+    int pendingDoorbells_{ 0 };
+    int doorbells_{ 0 };
+    int received_{ 0 };
+    bool isInOrder_{ true };
+    bool isStopped_{ false };
+    MetricHistogram queuedUs_;
+    std::thread thread_;
+};
+
+OHRemoteControlEvent MakeMouseMove(int index)
+{
+    OHRemoteControlEvent event{};
+    event.eventType = XcomponentEventType::REMOTECONTROL_MOUSE;
+    event.mouseEvent.x = static_cast<float>(index);
+    event.mouseEvent.action = OH_NATIVEXCOMPONENT_MOUSE_MOVE;
+    event.mouseEvent.button = OH_NATIVEXCOMPONENT_LEFT_BUTTON;
+    return event;
+}
+
+bool ParseOptions(int argc, char *argv[], RingOptions &options)
+{
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string arg = argv[i];
+        int value = std::atoi(argv[i + 1]);
+        if (arg == "--events") {
+            options.events = value;
+        } else if (arg == "--handle-us") {
+            options.handleUs = value;
+        } else {
+            return false;
+        }
+    }
+    return argc % 2 == 1 && options.events > 0 && options.handleUs >= 0;
+}
+} // namespace
+
+// Follows MirrorPlayerImplProxy::QueueInputEvent on the client mapping, the service drains its own one.
+int RunMirrorInputRingBench(int argc, char *argv[])
+{
+    RingOptions options;
+    if (!ParseOptions(argc, argv, options)) {
+        std::cerr << "usage: mirror_input_ring_bench [--events <n>] [--handle-us <us>]" << std::endl;
+        return EXIT_FAILURE;
+    }
+    auto serviceRing = MirrorInputRing::Create();
+    auto clientRing = serviceRing ? MirrorInputRing::Attach(serviceRing->GetAshmem()) : nullptr;
+    if (!clientRing) {
+        std::cerr << "input ring setup failed" << std::endl;
+        return EXIT_FAILURE;
+    }
+    RingService service(serviceRing, options);
+    int fullDrains = 0;
+    auto startTime = std::chrono::steady_clock::now();
+    for (int i = 0; i < options.events; i++) {
+        auto event = MakeMouseMove(i);
+        auto result = clientRing->Push(MirrorInputRing::EventKind::DELIVER, event);
+        if (result == MirrorInputRing::PushResult::FULL) {
+            fullDrains++;
+            service.Drain();
+            result = clientRing->Push(MirrorInputRing::EventKind::DELIVER, event);
+        }
+        if (result == MirrorInputRing::PushResult::FULL) {
+            std::cerr << "input ring is still full after a drain" << std::endl;
+            return EXIT_FAILURE;
+        }
+        if (result == MirrorInputRing::PushResult::NOTIFY) {
+            service.RingDoorbell();
+        }
+    }
+    bool isComplete = service.WaitForEvents(options.events);
+    auto elapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - startTime).count();
+
+    json result = service.GetResult();
+    result["sent"] = options.events;
+    result["full_drains"] = fullDrains;
+    result["elapsed_ms"] = elapsedMs;
+    std::cout << result.dump(4) << std::endl;
+    return isComplete && service.IsInOrder() ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+} // namespace CastEngine
+} // namespace OHOS
+
+int main(int argc, char *argv[])
+{
+    return OHOS::CastEngine::RunMirrorInputRingBench(argc, argv);
+}
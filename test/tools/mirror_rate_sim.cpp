@@ -0,0 +1,103 @@
+/*
+ * Copyright (C) 2023-2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * Description: replays a bandwidth trace through the mirror rate controller, off the device.
+ * Author: zhangge
+ * Create: 2023-06-05
+ */
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "mirror_rate_simulator.h"
+#include "rtsp_basetype.h"
+
+namespace OHOS {
+namespace CastEngine {
+namespace CastEngineService {
+namespace {
+constexpr int TRACE_INDEX = 1;
+constexpr int MIN_INDEX = 2;
+constexpr int MAX_INDEX = 3;
+constexpr int FPS_INDEX = 4;
+constexpr uint32_t BPS_PER_KBPS = 1000;
+constexpr uint32_t DEFAULT_MAX_BITRATE = 12000000;
+constexpr uint32_t DEFAULT_START_BITRATE = 8000000;
+
+bool GetPositiveArg(int argc, char *argv[], int index, uint32_t &value)
+{
+    if (argc <= index) {
+        return false;
+    }
+    int arg = std::atoi(argv[index]);
+    if (arg <= 0) {
+        return false;
+    }
+    value = static_cast<uint32_t>(arg);
+    return true;
+}
+} // namespace
+
+// <trace> [minKbps maxKbps maxFps], the defaults are those of a mirror session without a negotiated rate.
+int RunMirrorRateSim(int argc, char *argv[])
+{
+    if (argc <= TRACE_INDEX) {
+        std::cerr << "usage: mirror_rate_sim <trace> [minKbps maxKbps maxFps], one "
+            "\"durationMs,capacityKbps,baseRttMs,lossPercent\" segment per line" << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::ifstream file(argv[TRACE_INDEX]);
+    if (!file.is_open()) {
+        std::cerr << "cannot open " << argv[TRACE_INDEX] << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::stringstream text;
+    text << file.rdbuf();
+    std::vector<MirrorRateTraceSegment> trace;
+    if (!MirrorRateSimulator::ParseTrace(text.str(), trace)) {
+        std::cerr << "invalid trace " << argv[TRACE_INDEX] << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    MirrorRateSimConfig config{ static_cast<uint32_t>(CastSessionRtsp::VIDEO_BITRATE_MIN), DEFAULT_MAX_BITRATE,
+        DEFAULT_START_BITRATE, static_cast<uint32_t>(CastSessionRtsp::VIDEO_FPS_MIN),
+        static_cast<uint32_t>(CastSessionRtsp::VIDEO_FPS_60) };
+    uint32_t value = 0;
+    if (GetPositiveArg(argc, argv, MIN_INDEX, value)) {
+        config.minBitrate = value * BPS_PER_KBPS;
+    }
+    if (GetPositiveArg(argc, argv, MAX_INDEX, value)) {
+        config.maxBitrate = value * BPS_PER_KBPS;
+    }
+    if (GetPositiveArg(argc, argv, FPS_INDEX, value)) {
+        config.maxFps = value;
+    }
+    config.startBitrate = std::clamp(config.startBitrate, config.minBitrate, std::max(config.minBitrate,
+        config.maxBitrate));
+    config.minFps = std::min(config.minFps, config.maxFps);
+    std::cout << MirrorRateSimulator::Run(trace, config);
+    return EXIT_SUCCESS;
+}
+} // namespace CastEngineService
+} // namespace CastEngine
+} // namespace OHOS
+
+int main(int argc, char *argv[])
+{
+    return OHOS::CastEngine::CastEngineService::RunMirrorRateSim(argc, argv);
+}
@@ -0,0 +1,191 @@
+/*
+ * Copyright (C) 2023-2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * Description: replays a bandwidth trace through the mirror rate controller and reports how it behaved.
+ * Author: zhangge
+ * Create: 2023-06-05
+ */
+
+#include "mirror_rate_simulator.h"
+
+#include <algorithm>
+#include <cinttypes>
+#include <cmath>
+#include <cstdio>
+#include <deque>
+#include <sstream>
+
+#include "mirror_rate_controller.h"
+#include "mirror_rate_monitor.h"
+
+namespace OHOS {
+namespace CastEngine {
+namespace CastEngineService {
+namespace {
+constexpr double BITS_PER_BYTE = 8;
+constexpr double MS_PER_SECOND = 1000;
+constexpr uint64_t BPS_PER_KBPS = 1000;
+constexpr double PERCENT = 100;
+constexpr double MS_PER_MINUTE = 60000;
+constexpr double MBPS = 1000000;
+constexpr double P50 = 0.5;
+constexpr double P95 = 0.95;
+constexpr double P99 = 0.99;
+
+struct PendingFrame {
+    int64_t captureMs;
+    double remainingBytes;
+};
+
+int64_t Percentile(std::vector<int64_t> &values, double quantile)
+{
+    if (values.empty()) {
+        return 0;
+    }
+    size_t index = std::min(values.size() - 1, static_cast<size_t>(quantile * values.size()));
+    std::nth_element(values.begin(), values.begin() + index, values.end());
+    return values[index];
+}
+} // namespace
+
+bool MirrorRateSimulator::ParseTrace(const std::string &text, std::vector<MirrorRateTraceSegment> &trace)
+{
+    std::istringstream lines(text);
+    std::string line;
+    while (std::getline(lines, line)) {
+        if (line.empty() || line[0] == '#' || line[0] == '\r') {
+            continue;
+        }
+        long long durationMs = 0;
+        long long capacityKbps = 0;
+        long long baseRttMs = 0;
+        double lossPercent = 0;
+        if (sscanf(line.c_str(), "%lld,%lld,%lld,%lf", &durationMs, &capacityKbps, &baseRttMs, &lossPercent) != 4 ||
+            durationMs <= 0 || capacityKbps <= 0 || baseRttMs < 0 || lossPercent < 0 || lossPercent >= PERCENT) {
+            return false;
+        }
+        trace.push_back({ durationMs, static_cast<uint64_t>(capacityKbps) * BPS_PER_KBPS, baseRttMs, lossPercent });
+    }
+    return !trace.empty();
+}
+
+std::string MirrorRateSimulator::Run(const std::vector<MirrorRateTraceSegment> &trace,
+    const MirrorRateSimConfig &config)
+{
+    MirrorRateController controller(config.minBitrate, config.maxBitrate, config.startBitrate, config.minFps,
+        config.maxFps);
+    std::deque<PendingFrame> frames;
+    std::vector<int64_t> latencies;
+    std::vector<double> bitrates;
+    ChannelLinkStats stats;
+    double sentBytes = 0;
+    double lostPackets = 0;
+    double backlog = 0;
+    double capacityBits = 0;
+    double deliveredBits = 0;
+    double fpsSum = 0;
+    uint32_t minFps = config.maxFps;
+    int rateChanges = 0;
+    int congestedSamples = 0;
+    int64_t nowMs = 0;
+    double nextFrameMs = 0;
+    int64_t nextSampleMs = MirrorRateMonitor::SAMPLE_INTERVAL_MS;
+
+    for (const auto &segment : trace) {
+        double bytesPerStep = static_cast<double>(segment.capacityBps) / BITS_PER_BYTE * STEP_MS / MS_PER_SECOND;
+        for (int64_t endMs = nowMs + segment.durationMs; nowMs < endMs; nowMs += STEP_MS) {
+            auto rate = controller.GetRate();
+            while (nextFrameMs <= nowMs && rate.fps > 0) {
+                double frameBytes = static_cast<double>(rate.bitrate) / BITS_PER_BYTE / rate.fps;
+                frames.push_back({ nowMs, frameBytes });
+                backlog += frameBytes;
+                nextFrameMs += MS_PER_SECOND / rate.fps;
+            }
+
+            double budget = bytesPerStep;
+            capacityBits += budget * BITS_PER_BYTE;
+            double networkQueue = std::min(backlog, NETWORK_QUEUE_BYTES);
+            int64_t rttMs = segment.baseRttMs + static_cast<int64_t>(networkQueue * BITS_PER_BYTE * MS_PER_SECOND /
+                static_cast<double>(segment.capacityBps));
+            while (budget > 0 && !frames.empty()) {
+                auto &frame = frames.front();
+                double sent = std::min(budget, frame.remainingBytes);
+                frame.remainingBytes -= sent;
+                budget -= sent;
+                backlog -= sent;
+                sentBytes += sent;
+                deliveredBits += sent * BITS_PER_BYTE;
+                lostPackets += sent / PACKET_BYTES * segment.lossPercent / PERCENT;
+                if (frame.remainingBytes <= 0) {
+                    latencies.push_back(nowMs + STEP_MS - frame.captureMs + rttMs / 2);
+                    frames.pop_front();
+                }
+            }
+
+            if (nowMs + STEP_MS < nextSampleMs) {
+                continue;
+            }
+            nextSampleMs += MirrorRateMonitor::SAMPLE_INTERVAL_MS;
+            stats.sentBytes = static_cast<uint64_t>(sentBytes);
+            stats.sentPackets = static_cast<uint64_t>(sentBytes / PACKET_BYTES);
+            stats.lostPackets = static_cast<uint64_t>(lostPackets);
+            stats.rttUs = static_cast<uint32_t>(rttMs * MS_PER_SECOND);
+            // A saturated tcp settles at the bandwidth delay product.
+            stats.cwndBytes = static_cast<uint64_t>(static_cast<double>(segment.capacityBps) / BITS_PER_BYTE *
+                static_cast<double>(rttMs) / MS_PER_SECOND);
+            size_t queuedBytes = backlog > NETWORK_QUEUE_BYTES ? static_cast<size_t>(backlog - NETWORK_QUEUE_BYTES) : 0;
+            MirrorRateSample sample{ nowMs + STEP_MS, queuedBytes, true, stats };
+            if (controller.OnSample(sample)) {
+                rateChanges++;
+            }
+            if (controller.GetEstimate().state == LinkState::CONGESTED) {
+                congestedSamples++;
+            }
+            bitrates.push_back(controller.GetRate().bitrate);
+            fpsSum += controller.GetRate().fps;
+            minFps = std::min(minFps, controller.GetRate().fps);
+        }
+    }
+
+    double mean = 0;
+    for (double bitrate : bitrates) {
+        mean += bitrate;
+    }
+    mean = bitrates.empty() ? 0 : mean / bitrates.size();
+    double variance = 0;
+    for (double bitrate : bitrates) {
+        variance += (bitrate - mean) * (bitrate - mean);
+    }
+    variance = bitrates.empty() ? 0 : variance / bitrates.size();
+    size_t samples = std::max<size_t>(bitrates.size(), 1);
+    size_t frameCount = latencies.size();
+    int64_t p50 = Percentile(latencies, P50);
+    int64_t p95 = Percentile(latencies, P95);
+    int64_t p99 = Percentile(latencies, P99);
+    int64_t maxLatency = latencies.empty() ? 0 : *std::max_element(latencies.begin(), latencies.end());
+
+    char report[512] = {};
+    int ret = snprintf(report, sizeof(report),
+        "mirror rate simulation: %" PRId64 " ms, %zu segments, %zu samples\n"
+        "bitrate: mean %.2f Mbps, cv %.3f, %d changes (%.1f/min); fps: mean %.1f, min %u\n"
+        "link: utilization %.2f, congested in %.1f%% of the samples\n"
+        "latency: p50 %" PRId64 " ms, p95 %" PRId64 " ms, p99 %" PRId64 " ms, max %" PRId64 " ms over %zu frames\n",
+        nowMs, trace.size(), bitrates.size(), mean / MBPS, mean > 0 ? std::sqrt(variance) / mean : 0, rateChanges,
+        rateChanges * MS_PER_MINUTE / std::max<int64_t>(nowMs, 1), fpsSum / samples, minFps,
+        capacityBits > 0 ? deliveredBits / capacityBits : 0, congestedSamples * PERCENT / samples, p50, p95, p99,
+        maxLatency, frameCount);
+    return ret > 0 ? std::string(report) : std::string();
+}
+} // namespace CastEngineService
+} // namespace CastEngine
+} // namespace OHOS
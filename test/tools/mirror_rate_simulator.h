@@ -0,0 +1,65 @@
+/*
+ * Copyright (C) 2023-2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * Description: replays a bandwidth trace through the mirror rate controller and reports how it behaved.
+ * Author: zhangge
+ * Create: 2023-06-05
+ */
+
+#ifndef MIRROR_RATE_SIMULATOR_H
+#define MIRROR_RATE_SIMULATOR_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace OHOS {
+namespace CastEngine {
+namespace CastEngineService {
+struct MirrorRateTraceSegment {
+    int64_t durationMs{ 0 };
+    uint64_t capacityBps{ 0 };
+    int64_t baseRttMs{ 0 };
+    double lossPercent{ 0 };
+};
+
+struct MirrorRateSimConfig {
+    uint32_t minBitrate{ 0 };
+    uint32_t maxBitrate{ 0 };
+    uint32_t startBitrate{ 0 };
+    uint32_t minFps{ 0 };
+    uint32_t maxFps{ 0 };
+};
+
+/*
+ * Runs the real MirrorRateController against a single bottleneck link whose capacity, base rtt and loss follow the
+ * trace, one "durationMs,capacityKbps,baseRttMs,lossPercent" segment per line. The encoder emits evenly sized
+ * frames at the controlled rate; up to NETWORK_QUEUE_BYTES of the backlog sit in the network and add to the rtt,
+ * the rest is what the channel reports as queued. The report gives the stability of the rate and the latency of the
+ * frames from capture to arrival.
+ */
+class MirrorRateSimulator {
+public:
+    static bool ParseTrace(const std::string &text, std::vector<MirrorRateTraceSegment> &trace);
+    static std::string Run(const std::vector<MirrorRateTraceSegment> &trace, const MirrorRateSimConfig &config);
+
+private:
+    static constexpr int64_t STEP_MS = 5;
+    static constexpr double NETWORK_QUEUE_BYTES = 64 * 1024;
+    static constexpr double PACKET_BYTES = 1400;
+};
+} // namespace CastEngineService
+} // namespace CastEngine
+} // namespace OHOS
+
+#endif
@@ -0,0 +1,519 @@
+/*
+ * Copyright (C) 2023-2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * Description: two mux transports on the loopback, channel setup time, stream windows and stream reopen as json.
+ * Author: zhangge
+ * Create: 2023-06-05
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "json.hpp"
+#include "mux_connection.h"
+#include "mux_transport.h"
+#include "tcp_connection.h"
+
+namespace OHOS {
+namespace CastEngine {
+namespace CastEngineService {
+namespace {
+using nlohmann::json;
+using Clock = std::chrono::steady_clock;
+
+constexpr int WAIT_TIMEOUT_MS = 5000;
+// How long the bytes sent on a stalled stream have to stay put to count as held by the window.
+constexpr int SETTLE_MS = 200;
+constexpr char LOOPBACK_IP[] = "127.0.0.1";
+// The channels of a mirroring session that ride the mux, see CastSessionImpl::CreateChannelRequest.
+constexpr ModuleType MUX_MODULES[] = {
+    ModuleType::AUTH, ModuleType::RTCP, ModuleType::VIDEO, ModuleType::STREAM, ModuleType::UI_FILES,
+    ModuleType::UI_BYTES
+};
+constexpr size_t MODULE_COUNT = sizeof(MUX_MODULES) / sizeof(MUX_MODULES[0]);
+// MuxTransport::STREAM_WINDOW and MuxTransport::MAX_FRAME_PAYLOAD.
+constexpr uint64_t STREAM_WINDOW = 1024 * 1024;
+constexpr int MESSAGE_LEN = 64 * 1024;
+// Three windows, so the sender runs out of credit while the consumer is stalled.
+constexpr int WINDOW_MESSAGES = 48;
+constexpr int CONTROL_MESSAGE_LEN = 200;
+constexpr size_t INDEX_LEN = sizeof(uint32_t);
+
+struct LoopbackOptions {
+    int rounds{ 20 };
+};
+
+int64_t ElapsedUs(Clock::time_point start)
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count();
+}
+
+// Message index, the rest a pattern derived from it.
+std::vector<uint8_t> MakeMessage(uint32_t index, size_t length)
+{
+    std::vector<uint8_t> message(std::max(length, INDEX_LEN));
+    for (size_t i = 0; i < INDEX_LEN; i++) {
+        message[i] = static_cast<uint8_t>(index >> (i * 8));
+    }
+    for (size_t i = INDEX_LEN; i < message.size(); i++) {
+        message[i] = static_cast<uint8_t>(index + i);
+    }
+    return message;
+}
+
+uint32_t GetIndex(const uint8_t *message)
+{
+    uint32_t index = 0;
+    for (size_t i = 0; i < INDEX_LEN; i++) {
+        index |= static_cast<uint32_t>(message[i]) << (i * 8);
+    }
+    return index;
+}
+
+class ReadyListener : public ConnectionListener {
+public:
+    bool OnConnectionOpened(std::shared_ptr<Channel> channel) override
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        channels_[channel->GetRequest().moduleType] = channel;
+        opened_++;
+        cond_.notify_all();
+        return true;
+    }
+
+    void OnConnectionError(std::shared_ptr<Channel> channel, int errorCode) override
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ModuleType moduleType = channel->GetRequest().moduleType;
+        errors_[moduleType]++;
+        if (channels_[moduleType] == channel) {
+            channels_.erase(moduleType);
+        }
+        cond_.notify_all();
+    }
+
+    bool WaitOpened(size_t count)
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        return cond_.wait_for(lock, std::chrono::milliseconds(WAIT_TIMEOUT_MS), [this, count] {
+            return opened_ >= count;
+        });
+    }
+
+    bool WaitError(ModuleType moduleType)
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        return cond_.wait_for(lock, std::chrono::milliseconds(WAIT_TIMEOUT_MS), [this, moduleType] {
+            return errors_[moduleType] > 0;
+        });
+    }
+
+    std::shared_ptr<Channel> GetChannel(ModuleType moduleType)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = channels_.find(moduleType);
+        return it == channels_.end() ? nullptr : it->second;
+    }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable cond_;
+    size_t opened_{ 0 };
+    std::map<ModuleType, std::shared_ptr<Channel>> channels_;
+    std::map<ModuleType, int> errors_;
+};
+
+// Checks the messages of one stream: intact and in order. Optionally holds the first one until released, which
+// holds the reader thread of the transport and with it the credit of the stream.
+class MessageListener : public IChannelListener {
+public:
+    explicit MessageListener(bool isStalled = false) : isStalled_(isStalled) {}
+
+    void OnDataReceived(const uint8_t *buffer, unsigned int length, long timeCost) override
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cond_.wait(lock, [this] { return !isStalled_; });
+        uint32_t index = length < INDEX_LEN ? received_ + 1 : GetIndex(buffer);
+        std::vector<uint8_t> expected = MakeMessage(index, length);
+        if (index != received_ || expected.size() != length || !std::equal(buffer, buffer + length, expected.begin())) {
+            isIntact_ = false;
+        }
+        received_++;
+        cond_.notify_all();
+    }
+
+    void Release()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        isStalled_ = false;
+        cond_.notify_all();
+    }
+
+    bool WaitReceived(uint32_t count)
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        return cond_.wait_for(lock, std::chrono::milliseconds(WAIT_TIMEOUT_MS), [this, count] {
+            return received_ >= count;
+        });
+    }
+
+    uint32_t GetReceived()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return received_;
+    }
+
+    bool IsIntact()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return isIntact_;
+    }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable cond_;
+    bool isStalled_;
+    bool isIntact_{ true };
+    uint32_t received_{ 0 };
+};
+
+ChannelRequest MakeRequest(ModuleType moduleType, bool isReceiver, ChannelLinkType linkType, int remotePort)
+{
+    ChannelRequest request;
+    request.moduleType = moduleType;
+    request.linkType = linkType;
+    request.isReceiver = isReceiver;
+    request.localDeviceInfo.ipAddress = LOOPBACK_IP;
+    request.remoteDeviceInfo.ipAddress = LOOPBACK_IP;
+    request.remotePort = remotePort;
+    return request;
+}
+
+// Both ends of one mux transport, the sink listens and the source connects like in a mirroring session.
+class MuxPair {
+public:
+    MuxPair() : server_(std::make_shared<MuxTransport>()), client_(std::make_shared<MuxTransport>()) {}
+
+    ~MuxPair()
+    {
+        client_->Close();
+        server_->Close();
+    }
+
+    bool Listen(ModuleType moduleType, std::shared_ptr<IChannelListener> channelListener)
+    {
+        auto connection = std::make_shared<MuxConnection>(server_);
+        connection->SetConnectionListener(serverReady_);
+        int port = connection->StartListen(MakeRequest(moduleType, true, ChannelLinkType::MUX, INVALID_PORT),
+            channelListener);
+        if (port == INVALID_PORT) {
+            return false;
+        }
+        port_ = port;
+        return true;
+    }
+
+    std::shared_ptr<MuxConnection> Connect(ModuleType moduleType)
+    {
+        auto connection = std::make_shared<MuxConnection>(client_);
+        connection->SetConnectionListener(clientReady_);
+        if (connection->StartConnection(MakeRequest(moduleType, false, ChannelLinkType::MUX, port_),
+            std::make_shared<IChannelListener>()) != 0) {
+            return nullptr;
+        }
+        return connection;
+    }
+
+    bool WaitOpened(size_t count)
+    {
+        return serverReady_->WaitOpened(count) && clientReady_->WaitOpened(count);
+    }
+
+    std::shared_ptr<ReadyListener> GetServerReady()
+    {
+        return serverReady_;
+    }
+
+    std::shared_ptr<ReadyListener> GetClientReady()
+    {
+        return clientReady_;
+    }
+
+private:
+    std::shared_ptr<MuxTransport> server_;
+    std::shared_ptr<MuxTransport> client_;
+    std::shared_ptr<ReadyListener> serverReady_{ std::make_shared<ReadyListener>() };
+    std::shared_ptr<ReadyListener> clientReady_{ std::make_shared<ReadyListener>() };
+    int port_{ INVALID_PORT };
+};
+
+// Time until every channel is open on both ends, all of them on one mux transport.
+int64_t MeasureMuxReady()
+{
+    auto start = Clock::now();
+    MuxPair pair;
+    for (ModuleType moduleType : MUX_MODULES) {
+        if (!pair.Listen(moduleType, std::make_shared<IChannelListener>())) {
+            return -1;
+        }
+    }
+    for (ModuleType moduleType : MUX_MODULES) {
+        if (pair.Connect(moduleType) == nullptr) {
+            return -1;
+        }
+    }
+    return pair.WaitOpened(MODULE_COUNT) ? ElapsedUs(start) : -1;
+}
+
+// The same with one tcp connection per channel, as without FEATURE_CHANNEL_MUX.
+int64_t MeasureTcpReady()
+{
+    auto start = Clock::now();
+    auto serverReady = std::make_shared<ReadyListener>();
+    auto clientReady = std::make_shared<ReadyListener>();
+    std::vector<std::shared_ptr<TcpConnection>> connections;
+    std::vector<int> ports;
+    for (ModuleType moduleType : MUX_MODULES) {
+        auto server = std::make_shared<TcpConnection>();
+        server->SetConnectionListener(serverReady);
+        ports.push_back(server->StartListen(MakeRequest(moduleType, true, ChannelLinkType::TCP, INVALID_PORT),
+            std::make_shared<IChannelListener>()));
+        connections.push_back(server);
+    }
+    for (size_t i = 0; i < MODULE_COUNT; i++) {
+        auto client = std::make_shared<TcpConnection>();
+        client->SetConnectionListener(clientReady);
+        client->StartConnection(MakeRequest(MUX_MODULES[i], false, ChannelLinkType::TCP, ports[i]),
+            std::make_shared<IChannelListener>());
+        connections.push_back(client);
+    }
+    bool isReady = std::find(ports.begin(), ports.end(), INVALID_PORT) == ports.end() &&
+        serverReady->WaitOpened(MODULE_COUNT) && clientReady->WaitOpened(MODULE_COUNT);
+    int64_t elapsedUs = ElapsedUs(start);
+    for (auto &connection : connections) {
+        connection->CloseConnection();
+    }
+    return isReady ? elapsedUs : -1;
+}
+
+json ReportReady(std::vector<int64_t> &samples)
+{
+    std::sort(samples.begin(), samples.end());
+    int64_t sum = 0;
+    for (int64_t sample : samples) {
+        sum += sample;
+    }
+    return {
+        { "mean_us", samples.empty() ? 0 : sum / static_cast<int64_t>(samples.size()) },
+        { "p50_us", samples.empty() ? 0 : samples[samples.size() / 2] },
+        { "max_us", samples.empty() ? 0 : samples.back() },
+    };
+}
+
+bool CheckReady(const LoopbackOptions &options, json &report)
+{
+    std::vector<int64_t> mux;
+    std::vector<int64_t> tcp;
+    for (int i = 0; i < options.rounds; i++) {
+        int64_t muxUs = MeasureMuxReady();
+        if (muxUs < 0) {
+            report["channels_ready"] = { { "failed_mux_round", i } };
+            return false;
+        }
+        mux.push_back(muxUs);
+    }
+    for (int i = 0; i < options.rounds; i++) {
+        int64_t tcpUs = MeasureTcpReady();
+        if (tcpUs < 0) {
+            report["channels_ready"] = { { "failed_tcp_round", i } };
+            return false;
+        }
+        tcp.push_back(tcpUs);
+    }
+    report["channels_ready"] = {
+        { "channels", MODULE_COUNT },
+        { "rounds", options.rounds },
+        { "mux", ReportReady(mux) },
+        { "tcp", ReportReady(tcp) },
+    };
+    return true;
+}
+
+uint64_t GetSentBytes(std::shared_ptr<MuxConnection> connection)
+{
+    ChannelLinkStats stats;
+    return connection->GetLinkStats(stats) ? stats.sentBytes : 0;
+}
+
+// Bytes sent on the stream once they no longer grow.
+uint64_t WaitSentSettled(std::shared_ptr<MuxConnection> connection)
+{
+    uint64_t sent = GetSentBytes(connection);
+    auto deadline = Clock::now() + std::chrono::milliseconds(WAIT_TIMEOUT_MS);
+    while (Clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(SETTLE_MS));
+        uint64_t now = GetSentBytes(connection);
+        if (now == sent) {
+            break;
+        }
+        sent = now;
+    }
+    return sent;
+}
+
+/*
+ * A stalled video consumer may hold at most one window of video on the link, the rest stays queued at the source
+ * while a control message on the same transport still goes out. Once the consumer goes on, the window updates let
+ * the rest through, intact and in order.
+ */
+bool CheckWindow(json &report)
+{
+    MuxPair pair;
+    auto video = std::make_shared<MessageListener>(true);
+    auto control = std::make_shared<MessageListener>();
+    if (!pair.Listen(ModuleType::VIDEO, video) || !pair.Listen(ModuleType::RTCP, control)) {
+        return false;
+    }
+    auto videoConn = pair.Connect(ModuleType::VIDEO);
+    auto controlConn = pair.Connect(ModuleType::RTCP);
+    if (videoConn == nullptr || controlConn == nullptr || !pair.WaitOpened(2)) {
+        video->Release();
+        return false;
+    }
+
+    for (int i = 0; i < WINDOW_MESSAGES; i++) {
+        std::vector<uint8_t> message = MakeMessage(static_cast<uint32_t>(i), MESSAGE_LEN);
+        videoConn->Send(message.data(), static_cast<int>(message.size()));
+    }
+    uint64_t stalledSent = WaitSentSettled(videoConn);
+    std::vector<uint8_t> message = MakeMessage(0, CONTROL_MESSAGE_LEN);
+    controlConn->Send(message.data(), static_cast<int>(message.size()));
+    uint64_t controlSent = WaitSentSettled(controlConn);
+    size_t stalledQueued = videoConn->GetSendQueueDepth();
+
+    auto start = Clock::now();
+    video->Release();
+    bool isDelivered = video->WaitReceived(WINDOW_MESSAGES) && control->WaitReceived(1);
+    int64_t drainUs = ElapsedUs(start);
+    uint64_t total = static_cast<uint64_t>(WINDOW_MESSAGES) * MESSAGE_LEN;
+    bool isWindowHeld = stalledSent >= STREAM_WINDOW && stalledSent < STREAM_WINDOW + MESSAGE_LEN;
+    bool isControlSent = controlSent == CONTROL_MESSAGE_LEN;
+    report["flow_control"] = {
+        { "window_bytes", STREAM_WINDOW },
+        { "stalled_sent_bytes", stalledSent },
+        { "stalled_queued_bytes", stalledQueued },
+        { "window_held", isWindowHeld },
+        { "control_sent_while_stalled", isControlSent },
+        { "drain_us", drainUs },
+        { "delivered", video->GetReceived() },
+        { "sent_bytes", GetSentBytes(videoConn) },
+        { "intact", video->IsIntact() && control->IsIntact() },
+    };
+    return isWindowHeld && isControlSent && isDelivered && GetSentBytes(videoConn) == total && video->IsIntact() &&
+        control->IsIntact();
+}
+
+/*
+ * A stream closed right after a send still delivers that message before the peer sees the close, and reopens on the
+ * same transport: the source sends its OPEN before the sink has the channel again, the way a reconnect races.
+ */
+bool CheckCloseReopen(json &report)
+{
+    MuxPair pair;
+    auto first = std::make_shared<MessageListener>();
+    if (!pair.Listen(ModuleType::STREAM, first) ||
+        !pair.Listen(ModuleType::RTCP, std::make_shared<IChannelListener>())) {
+        return false;
+    }
+    auto streamConn = pair.Connect(ModuleType::STREAM);
+    auto controlConn = pair.Connect(ModuleType::RTCP);
+    if (streamConn == nullptr || controlConn == nullptr || !pair.WaitOpened(2)) {
+        return false;
+    }
+
+    std::vector<uint8_t> message = MakeMessage(0, MESSAGE_LEN);
+    streamConn->Send(message.data(), static_cast<int>(message.size()));
+    streamConn->CloseConnection();
+    bool isPeerClosed = pair.GetServerReady()->WaitError(ModuleType::STREAM);
+    bool isFlushed = first->GetReceived() == 1;
+
+    auto start = Clock::now();
+    auto reopened = pair.Connect(ModuleType::STREAM);
+    auto second = std::make_shared<MessageListener>();
+    // OPEN first, the sink channel only after it.
+    std::this_thread::sleep_for(std::chrono::milliseconds(SETTLE_MS));
+    bool isReopened = reopened != nullptr && pair.Listen(ModuleType::STREAM, second) && pair.WaitOpened(3);
+    int64_t reopenUs = ElapsedUs(start);
+    if (isReopened) {
+        reopened->Send(message.data(), static_cast<int>(message.size()));
+    }
+    bool isDelivered = isReopened && second->WaitReceived(1) && second->IsIntact();
+    bool isOtherOpen = pair.GetClientReady()->GetChannel(ModuleType::RTCP) != nullptr &&
+        pair.GetServerReady()->GetChannel(ModuleType::RTCP) != nullptr;
+    report["close_reopen"] = {
+        { "peer_closed", isPeerClosed },
+        { "flushed_before_close", isFlushed },
+        { "reopened", isReopened },
+        { "reopen_us", reopenUs - SETTLE_MS * 1000 },
+        { "delivered_after_reopen", isDelivered },
+        { "other_stream_open", isOtherOpen },
+    };
+    return isPeerClosed && isFlushed && isDelivered && isOtherOpen && first->GetReceived() == 1;
+}
+
+bool ParseOptions(int argc, char *argv[], LoopbackOptions &options)
+{
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string arg = argv[i];
+        if (arg == "--rounds") {
+            options.rounds = std::atoi(argv[i + 1]);
+        } else {
+            return false;
+        }
+    }
+    return argc % 2 == 1 && options.rounds > 0;
+}
+} // namespace
+
+int RunMuxLoopback(int argc, char *argv[])
+{
+    LoopbackOptions options;
+    if (!ParseOptions(argc, argv, options)) {
+        std::cerr << "usage: mux_loopback [--rounds <n>]" << std::endl;
+        return EXIT_FAILURE;
+    }
+    json report;
+    bool isReady = CheckReady(options, report);
+    bool isWindowed = CheckWindow(report);
+    bool isReopened = CheckCloseReopen(report);
+    report["passed"] = isReady && isWindowed && isReopened;
+    std::cout << report.dump(2) << std::endl;
+    return isReady && isWindowed && isReopened ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+} // namespace CastEngineService
+} // namespace CastEngine
+} // namespace OHOS
+
+int main(int argc, char *argv[])
+{
+    return OHOS::CastEngine::CastEngineService::RunMuxLoopback(argc, argv);
+}
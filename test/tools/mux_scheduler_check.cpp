@@ -0,0 +1,183 @@
+/*
+ * Copyright (C) 2023-2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * Description: checks the send order of the mux scheduler: strict priority between classes and deficit round robin inside one.
+ * Author: zhangge
+ * Create: 2023-06-05
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "json.hpp"
+#include "mux_send_scheduler.h"
+
+namespace OHOS {
+namespace CastEngine {
+namespace CastEngineService {
+namespace {
+using nlohmann::json;
+using Priority = MuxSendScheduler::Priority;
+
+constexpr size_t QUANTUM = 1000;
+
+MuxSendScheduler::Frame MakeFrame(size_t size)
+{
+    MuxSendScheduler::Frame frame;
+    frame.bytes.resize(size);
+    frame.credit = static_cast<uint32_t>(size);
+    return frame;
+}
+
+bool IsAlwaysSendable(uint8_t streamId, const MuxSendScheduler::Frame &frame)
+{
+    return true;
+}
+
+bool CheckModulePriority()
+{
+    return MuxSendScheduler::GetPriority(ModuleType::AUTH) == Priority::CONTROL &&
+        MuxSendScheduler::GetPriority(ModuleType::RTCP) == Priority::CONTROL &&
+        MuxSendScheduler::GetPriority(ModuleType::AUDIO) == Priority::AUDIO &&
+        MuxSendScheduler::GetPriority(ModuleType::VIDEO) == Priority::VIDEO &&
+        MuxSendScheduler::GetPriority(ModuleType::STREAM) == Priority::BULK &&
+        MuxSendScheduler::GetPriority(ModuleType::UI_FILES) == Priority::BULK;
+}
+
+// Queued lowest class first, sent transport frames first and then CONTROL, AUDIO, VIDEO, BULK.
+bool CheckClassOrder()
+{
+    MuxSendScheduler scheduler(QUANTUM);
+    const std::vector<std::pair<uint8_t, Priority>> streams = {
+        { 4, Priority::BULK }, { 3, Priority::VIDEO }, { 2, Priority::AUDIO }, { 1, Priority::CONTROL }
+    };
+    for (const auto &[streamId, priority] : streams) {
+        scheduler.Push(streamId, priority, MakeFrame(100));
+        scheduler.Push(streamId, priority, MakeFrame(100));
+    }
+    scheduler.PushUrgent(MakeFrame(8));
+
+    std::vector<int> order;
+    MuxSendScheduler::Popped popped;
+    while (scheduler.Pop(IsAlwaysSendable, popped)) {
+        order.push_back(popped.hasStream ? popped.streamId : 0);
+    }
+    return order == std::vector<int>{ 0, 1, 1, 2, 2, 3, 3, 4, 4 };
+}
+
+// A class blocked by flow control gives way to the next one without losing its place.
+bool CheckBlockedClass()
+{
+    MuxSendScheduler scheduler(QUANTUM);
+    scheduler.Push(1, Priority::CONTROL, MakeFrame(100));
+    scheduler.Push(2, Priority::AUDIO, MakeFrame(100));
+    bool isControlBlocked = true;
+    auto isSendable = [&isControlBlocked](uint8_t streamId, const MuxSendScheduler::Frame &frame) {
+        return streamId != 1 || !isControlBlocked;
+    };
+    MuxSendScheduler::Popped popped;
+    if (!scheduler.Pop(isSendable, popped) || popped.streamId != 2 || scheduler.Pop(isSendable, popped)) {
+        return false;
+    }
+    isControlBlocked = false;
+    return scheduler.HasSendable(isSendable) && scheduler.Pop(isSendable, popped) && popped.streamId == 1;
+}
+
+/*
+ * Three always busy streams of one class with frames of 1000, 300 and 64 bytes: every stream gets about a quantum
+ * per round whatever its frame size, so the bytes sent differ by at most one quantum plus one frame.
+ */
+bool CheckDeficitRoundRobin(json &bytesPerStream)
+{
+    MuxSendScheduler scheduler(QUANTUM);
+    const std::map<uint8_t, size_t> frameSizes = { { 5, 1000 }, { 6, 300 }, { 7, 64 } };
+    constexpr int rounds = 50;
+    for (const auto &[streamId, frameSize] : frameSizes) {
+        for (size_t queued = 0; queued < QUANTUM * rounds * 2; queued += frameSize) {
+            scheduler.Push(streamId, Priority::VIDEO, MakeFrame(frameSize));
+        }
+    }
+    std::map<uint8_t, size_t> sent;
+    MuxSendScheduler::Popped popped;
+    for (size_t total = 0; total < QUANTUM * rounds * frameSizes.size() && scheduler.Pop(IsAlwaysSendable, popped);) {
+        sent[popped.streamId] += popped.frame.bytes.size();
+        total += popped.frame.bytes.size();
+    }
+    size_t minSent = SIZE_MAX;
+    size_t maxSent = 0;
+    for (const auto &[streamId, bytes] : sent) {
+        bytesPerStream[std::to_string(streamId)] = bytes;
+        minSent = std::min(minSent, bytes);
+        maxSent = std::max(maxSent, bytes);
+    }
+    return sent.size() == frameSizes.size() && maxSent - minSent <= QUANTUM * 2;
+}
+
+bool CheckWatermarks()
+{
+    MuxSendScheduler scheduler(QUANTUM);
+    constexpr size_t frameSize = 64 * 1024;
+    bool isHighReported = false;
+    size_t pushed = 0;
+    while (!isHighReported) {
+        isHighReported = scheduler.Push(1, Priority::BULK, MakeFrame(frameSize));
+        pushed++;
+        if (pushed * frameSize > MuxSendScheduler::HIGH_WATERMARK + frameSize) {
+            return false;
+        }
+    }
+    // Crossing once is reported once.
+    if (scheduler.Push(1, Priority::BULK, MakeFrame(frameSize))) {
+        return false;
+    }
+    MuxSendScheduler::Popped popped;
+    while (scheduler.Pop(IsAlwaysSendable, popped)) {
+        if (popped.isBelowLowWatermark) {
+            return scheduler.GetQueuedBytes(1) <= MuxSendScheduler::LOW_WATERMARK;
+        }
+    }
+    return false;
+}
+} // namespace
+
+int RunMuxSchedulerCheck()
+{
+    json fairness = json::object();
+    json result = {
+        { "module_priority", CheckModulePriority() },
+        { "class_order", CheckClassOrder() },
+        { "blocked_class", CheckBlockedClass() },
+        { "drr_fairness", CheckDeficitRoundRobin(fairness) },
+        { "watermarks", CheckWatermarks() },
+    };
+    bool isAllPassed = true;
+    for (const auto &item : result.items()) {
+        isAllPassed = isAllPassed && item.value().get<bool>();
+    }
+    result["drr_bytes_per_stream"] = fairness;
+    std::cout << result.dump(4) << std::endl;
+    return isAllPassed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+} // namespace CastEngineService
+} // namespace CastEngine
+} // namespace OHOS
+
+int main()
+{
+    return OHOS::CastEngine::CastEngineService::RunMuxSchedulerCheck();
+}
@@ -0,0 +1,432 @@
+/*
+ * Copyright (C) 2023-2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * Description: delivers events through the js kit NapiCallback on a fake napi runtime and checks order and coalescing.
+ * Author: zhangge
+ * Create: 2023-06-05
+ */
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <deque>
+#include <functional>
+#include <iostream>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "cast_engine_metrics.h"
+#include "json.hpp"
+#include "napi/native_api.h"
+#include "napi_callback.h"
+#include "napi_castengine_utils.h"
+
+// The fake runtime: a value is either an int32 or a function, a reference only counts.
+struct napi_value__ {
+    int32_t number{ 0 };
+    std::function<void(size_t argc, const napi_value *argv)> function;
+};
+
+struct napi_ref__ {
+    napi_value value;
+    uint32_t count;
+};
+
+namespace OHOS {
+namespace CastEngine {
+namespace CastEngineClient {
+namespace {
+using nlohmann::json;
+
+struct ThreadsafeFunction {
+    void *context;
+    void *finalizeData;
+    napi_finalize finalizeCb;
+    napi_threadsafe_function_call_js callJsCb;
+    bool isClosed{ false };
+};
+
+/*
+ * Single JS thread running the posted tasks in order, each one followed by the time the app spends on its own work,
+ * so that the producers run ahead of it the way they do on a busy device.
+ */
+class JsThread {
+public:
+    static JsThread &GetInstance()
+    {
+        static JsThread instance;
+        return instance;
+    }
+
+    void Start(int busyUs)
+    {
+        busyUs_ = busyUs;
+        thread_ = std::thread([this] { Loop(); });
+    }
+
+    void Stop()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            isStopped_ = true;
+        }
+        cond_.notify_all();
+        thread_.join();
+    }
+
+    void Post(std::function<void()> task)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            tasks_.push_back(std::move(task));
+        }
+        cond_.notify_all();
+    }
+
+    // Runs the task on the JS thread and waits until it and everything posted before it ran.
+    void Run(std::function<void()> task)
+    {
+        std::mutex doneMutex;
+        std::condition_variable doneCond;
+        bool isDone = false;
+        Post([&] {
+            task();
+            std::lock_guard<std::mutex> lock(doneMutex);
+            isDone = true;
+            doneCond.notify_all();
+        });
+        std::unique_lock<std::mutex> lock(doneMutex);
+        doneCond.wait(lock, [&isDone] { return isDone; });
+    }
+
+    std::atomic<int> wakeups{ 0 };
+    napi_env env = reinterpret_cast<napi_env>(this);
+
+private:
+    void Loop()
+    {
+        while (true) {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                cond_.wait(lock, [this] { return isStopped_ || !tasks_.empty(); });
+                if (tasks_.empty()) {
+                    return;
+                }
+                task = std::move(tasks_.front());
+                tasks_.pop_front();
+            }
+            task();
+            std::this_thread::sleep_for(std::chrono::microseconds(busyUs_));
+        }
+    }
+
+    int busyUs_{ 0 };
+    std::thread thread_;
+    std::mutex mutex_;
+    std::condition_variable cond_;
+    std::deque<std::function<void()>> tasks_;
+    bool isStopped_{ false };
+};
+
+// Values created while a callback runs live until its handle scope closes, as they do in the engine.
+std::deque<napi_value__> g_scopeValues;
+
+struct BenchOptions {
+    int positions{ 20000 };
+    int states{ 2000 };
+    int busyUs{ 50 };
+};
+
+struct Listener {
+    explicit Listener(std::vector<int32_t> &received)
+        : value{ 0, [&received](size_t argc, const napi_value *argv) {
+            if (argc > 0) {
+                received.push_back(argv[0]->number);
+            }
+        } } {}
+
+    napi_value Get() { return &value; }
+
+    napi_value__ value;
+};
+
+NapiCallback::NapiArgsGetter MakeGetter(int32_t number)
+{
+    return [number](napi_env env, int &argc, napi_value *argv) {
+        argc = 1;
+        napi_create_int32(env, number, &argv[0]);
+    };
+}
+
+bool IsSequence(const std::vector<int32_t> &values, int32_t count)
+{
+    if (values.size() != static_cast<size_t>(count)) {
+        return false;
+    }
+    for (int32_t i = 0; i < count; i++) {
+        if (values[i] != i) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool IsIncreasing(const std::vector<int32_t> &values)
+{
+    for (size_t i = 1; i < values.size(); i++) {
+        if (values[i] <= values[i - 1]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool ParseOptions(int argc, char *argv[], BenchOptions &options)
+{
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string arg = argv[i];
+        int value = std::atoi(argv[i + 1]);
+        if (arg == "--positions") {
+            options.positions = value;
+        } else if (arg == "--states") {
+            options.states = value;
+        } else if (arg == "--busy-us") {
+            options.busyUs = value;
+        } else {
+            return false;
+        }
+    }
+    return argc % 2 == 1 && options.positions > 0 && options.states > 0 && options.busyUs >= 0;
+}
+} // namespace
+
+// Stand-in for the one in napi_castengine_utils.cpp, which needs the whole kit.
+napi_status GetRefByCallback(napi_env env, std::list<napi_ref> &refList, napi_value callback, napi_ref &callbackRef)
+{
+    callbackRef = nullptr;
+    for (auto ref : refList) {
+        if (ref->value == callback) {
+            callbackRef = ref;
+            break;
+        }
+    }
+    return napi_ok;
+}
+
+/*
+ * Two producers, as the player and the session listener threads: one sends positions handled as latest only, the
+ * other states that every listener has to see complete and in order. Events left once the callback is destroyed
+ * must never reach JS.
+ */
+int RunNapiCallbackBench(int argc, char *argv[])
+{
+    constexpr int32_t positionEvent = 1;
+    constexpr int32_t stateEvent = 2;
+    BenchOptions options;
+    if (!ParseOptions(argc, argv, options)) {
+        std::cerr << "usage: napi_callback_bench [--positions <n>] [--states <n>] [--busy-us <us>]" << std::endl;
+        return EXIT_FAILURE;
+    }
+    auto &js = JsThread::GetInstance();
+    js.Start(options.busyUs);
+
+    std::vector<int32_t> positions;
+    std::vector<int32_t> states;
+    std::vector<int32_t> otherStates;
+    Listener positionListener(positions);
+    Listener stateListener(states);
+    Listener otherStateListener(otherStates);
+    auto callback = std::make_shared<NapiCallback>(js.env);
+    js.Run([&] {
+        callback->AddCallback(js.env, positionEvent, positionListener.Get());
+        callback->AddCallback(js.env, stateEvent, stateListener.Get());
+        callback->AddCallback(js.env, stateEvent, otherStateListener.Get());
+    });
+
+    auto startTime = std::chrono::steady_clock::now();
+    std::thread positionProducer([&] {
+        for (int32_t i = 0; i < options.positions; i++) {
+            auto getter = MakeGetter(i);
+            callback->HandleEvent(positionEvent, getter, true);
+        }
+    });
+    std::thread stateProducer([&] {
+        for (int32_t i = 0; i < options.states; i++) {
+            auto getter = MakeGetter(i);
+            callback->HandleEvent(stateEvent, getter);
+        }
+    });
+    positionProducer.join();
+    stateProducer.join();
+    // The last wakeup was posted before this task, so everything queued has been delivered once it ran.
+    js.Run([] {});
+    auto elapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - startTime).count();
+
+    size_t statesBeforeDestroy = states.size();
+    auto getter = MakeGetter(options.states);
+    callback->HandleEvent(stateEvent, getter);
+    callback.reset();
+    js.Run([] {});
+    bool isDroppedAfterDestroy = states.size() == statesBeforeDestroy;
+    js.Stop();
+
+    bool isStatesOrdered = IsSequence(states, options.states) && otherStates == states;
+    bool isPositionsLatest = IsIncreasing(positions) && !positions.empty() &&
+        positions.back() == options.positions - 1;
+    auto waitUs = CastEngineMetrics::GetInstance().RegisterHistogram(METRIC_NAPI_CALLBACK_WAIT_US).GetSnapshot();
+    json result = {
+        { "positions_sent", options.positions }, { "positions_delivered", positions.size() },
+        { "states_sent", options.states }, { "states_delivered", states.size() },
+        { "tsfn_wakeups", js.wakeups.load() }, { "elapsed_ms", elapsedMs },
+        { "wait_us", { { "p50", waitUs.p50 }, { "p99", waitUs.p99 }, { "max", waitUs.max } } },
+        { "coalesced", CastEngineMetrics::GetInstance().RegisterCounter(METRIC_NAPI_CALLBACK_COALESCED).Value() },
+        { "states_ordered", isStatesOrdered }, { "positions_latest", isPositionsLatest },
+        { "dropped_after_destroy", isDroppedAfterDestroy }
+    };
+    std::cout << result.dump(4) << std::endl;
+    return isStatesOrdered && isPositionsLatest && isDroppedAfterDestroy ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+} // namespace CastEngineClient
+} // namespace CastEngine
+} // namespace OHOS
+
+using OHOS::CastEngine::CastEngineClient::JsThread;
+using OHOS::CastEngine::CastEngineClient::ThreadsafeFunction;
+using OHOS::CastEngine::CastEngineClient::g_scopeValues;
+
+napi_status napi_create_string_utf8(napi_env env, const char *str, size_t length, napi_value *result)
+{
+    g_scopeValues.emplace_back();
+    *result = &g_scopeValues.back();
+    return napi_ok;
+}
+
+napi_status napi_create_int32(napi_env env, int32_t value, napi_value *result)
+{
+    g_scopeValues.push_back({ value, nullptr });
+    *result = &g_scopeValues.back();
+    return napi_ok;
+}
+
+napi_status napi_get_undefined(napi_env env, napi_value *result)
+{
+    static napi_value__ undefined;
+    *result = &undefined;
+    return napi_ok;
+}
+
+napi_status napi_open_handle_scope(napi_env env, napi_handle_scope *result)
+{
+    return napi_ok;
+}
+
+napi_status napi_close_handle_scope(napi_env env, napi_handle_scope scope)
+{
+    g_scopeValues.clear();
+    return napi_ok;
+}
+
+napi_status napi_call_function(napi_env env, napi_value recv, napi_value func, size_t argc, const napi_value *argv,
+    napi_value *result)
+{
+    if (!func->function) {
+        return napi_invalid_arg;
+    }
+    func->function(argc, argv);
+    return napi_ok;
+}
+
+napi_status napi_create_reference(napi_env env, napi_value value, uint32_t count, napi_ref *result)
+{
+    *result = new napi_ref__{ value, count };
+    return napi_ok;
+}
+
+napi_status napi_delete_reference(napi_env env, napi_ref ref)
+{
+    delete ref;
+    return napi_ok;
+}
+
+napi_status napi_get_reference_value(napi_env env, napi_ref ref, napi_value *result)
+{
+    *result = ref->value;
+    return napi_ok;
+}
+
+napi_status napi_reference_ref(napi_env env, napi_ref ref, uint32_t *result)
+{
+    *result = ++ref->count;
+    return napi_ok;
+}
+
+napi_status napi_reference_unref(napi_env env, napi_ref ref, uint32_t *result)
+{
+    *result = --ref->count;
+    return napi_ok;
+}
+
+napi_status napi_create_threadsafe_function(napi_env env, napi_value func, napi_value asyncResource,
+    napi_value asyncResourceName, size_t maxQueueSize, size_t initialThreadCount, void *threadFinalizeData,
+    napi_finalize threadFinalizeCb, void *context, napi_threadsafe_function_call_js callJsCb,
+    napi_threadsafe_function *result)
+{
+    *result = reinterpret_cast<napi_threadsafe_function>(
+        new ThreadsafeFunction{ context, threadFinalizeData, threadFinalizeCb, callJsCb });
+    return napi_ok;
+}
+
+napi_status napi_unref_threadsafe_function(napi_env env, napi_threadsafe_function func)
+{
+    return napi_ok;
+}
+
+napi_status napi_call_threadsafe_function(napi_threadsafe_function func, void *data,
+    napi_threadsafe_function_call_mode isBlocking)
+{
+    auto *tsfn = reinterpret_cast<ThreadsafeFunction *>(func);
+    auto &js = JsThread::GetInstance();
+    js.wakeups++;
+    js.Post([tsfn, data, &js] {
+        if (!tsfn->isClosed) {
+            tsfn->callJsCb(js.env, nullptr, tsfn->context, data);
+        }
+    });
+    return napi_ok;
+}
+
+// Calls queued before the release still run, in order, ahead of the finalizer.
+napi_status napi_release_threadsafe_function(napi_threadsafe_function func,
+    napi_threadsafe_function_release_mode mode)
+{
+    auto *tsfn = reinterpret_cast<ThreadsafeFunction *>(func);
+    auto &js = JsThread::GetInstance();
+    js.Post([tsfn, &js] {
+        tsfn->isClosed = true;
+        tsfn->finalizeCb(js.env, tsfn->finalizeData, nullptr);
+        delete tsfn;
+    });
+    return napi_ok;
+}
+
+int main(int argc, char *argv[])
+{
+    return OHOS::CastEngine::CastEngineClient::RunNapiCallbackBench(argc, argv);
+}
@@ -0,0 +1,507 @@
+/*
+ * Copyright (C) 2023-2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * Description: converts device lists and media infos between C++ and JS through the napi utils of the js kit on a fake napi runtime, with json output.
+ * Author: zhangge
+ * Create: 2023-06-05
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "json.hpp"
+#include "napi/native_api.h"
+#include "napi_castengine_utils.h"
+
+// The fake runtime: a value is a plain tagged struct, an object maps names to values and an array holds its elements.
+struct napi_value__ {
+    napi_valuetype type{ napi_undefined };
+    double number{ 0 };
+    bool flag{ false };
+    std::string str;
+    std::unordered_map<std::string, napi_value> properties;
+    std::vector<napi_value> elements;
+    bool isArray{ false };
+    // Referenced values outlive their handle scope until the last reference goes.
+    uint32_t refs{ 0 };
+    bool isInScope{ true };
+};
+
+struct napi_ref__ {
+    napi_value value;
+};
+
+namespace OHOS {
+namespace CastEngine {
+namespace CastEngineClient {
+namespace {
+using nlohmann::json;
+using Clock = std::chrono::steady_clock;
+
+struct CleanupHook {
+    void (*fun)(void *arg);
+    void *arg;
+};
+
+// Values created since the innermost open scope, released when it closes as the engine does.
+std::vector<napi_value> g_scopeValues;
+std::vector<size_t> g_scopeMarks;
+std::vector<CleanupHook> g_cleanupHooks;
+uint64_t g_stringsCreated = 0;
+napi_env g_env = reinterpret_cast<napi_env>(&g_scopeValues);
+
+struct BenchOptions {
+    int devices{ 100 };
+    int iterations{ 2000 };
+};
+
+class HandleScope {
+public:
+    HandleScope() { napi_open_handle_scope(g_env, &scope_); }
+    ~HandleScope() { napi_close_handle_scope(g_env, scope_); }
+
+private:
+    napi_handle_scope scope_{ nullptr };
+};
+
+std::vector<CastRemoteDevice> MakeDevices(int count)
+{
+    std::vector<CastRemoteDevice> devices(count);
+    for (int i = 0; i < count; i++) {
+        devices[i].deviceId = "device-" + std::to_string(i) + "-0123456789abcdef0123456789abcdef";
+        devices[i].deviceName = "Living room screen " + std::to_string(i);
+        devices[i].deviceType = DeviceType::DEVICE_CAST_PLUS;
+        devices[i].subDeviceType = SubDeviceType::SUB_DEVICE_DEFAULT;
+        devices[i].ipAddress = "192.168.1." + std::to_string(i % 250 + 2);
+        devices[i].channelType = ChannelType::SOFT_BUS;
+        devices[i].networkId = "fedcba9876543210fedcba9876543210";
+    }
+    return devices;
+}
+
+MediaInfo MakeMediaInfo(int index)
+{
+    MediaInfo mediaInfo;
+    mediaInfo.mediaId = "media-" + std::to_string(index);
+    mediaInfo.mediaName = "A fairly ordinary track name";
+    mediaInfo.mediaUrl = "https://media.example.com/library/album/track.flac?token=0123456789abcdef";
+    mediaInfo.mediaType = "AUDIO";
+    mediaInfo.mediaSize = 31457280;
+    mediaInfo.duration = 245000;
+    mediaInfo.albumCoverUrl = "https://media.example.com/library/album/cover-1024.jpg";
+    mediaInfo.albumTitle = "Album title";
+    mediaInfo.mediaArtist = "Artist";
+    mediaInfo.lrcUrl = "https://media.example.com/library/album/track.lrc";
+    mediaInfo.lrcContent = std::string(2048, 'l');
+    mediaInfo.appIconUrl = "https://media.example.com/app/icon-192.png";
+    mediaInfo.appName = "Player";
+    return mediaInfo;
+}
+
+bool IsSameMediaInfo(const MediaInfo &left, const MediaInfo &right)
+{
+    return left.mediaId == right.mediaId && left.mediaName == right.mediaName && left.mediaUrl == right.mediaUrl &&
+        left.mediaType == right.mediaType && left.mediaSize == right.mediaSize && left.duration == right.duration &&
+        left.albumCoverUrl == right.albumCoverUrl && left.lrcContent == right.lrcContent &&
+        left.appName == right.appName;
+}
+
+bool IsDeviceListConverted(napi_value list, const std::vector<CastRemoteDevice> &devices)
+{
+    if (list == nullptr || list->elements.size() != devices.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < devices.size(); i++) {
+        napi_value device = list->elements[i];
+        if (device == nullptr || device->properties["deviceId"]->str != devices[i].deviceId ||
+            device->properties["deviceName"]->str != devices[i].deviceName) {
+            return false;
+        }
+    }
+    return true;
+}
+
+double PerSecond(int count, Clock::time_point start)
+{
+    double elapsedS = std::chrono::duration<double>(Clock::now() - start).count();
+    return elapsedS > 0 ? count / elapsedS : 0;
+}
+
+bool ParseOptions(int argc, char *argv[], BenchOptions &options)
+{
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string arg = argv[i];
+        int value = std::atoi(argv[i + 1]);
+        if (arg == "--devices") {
+            options.devices = value;
+        } else if (arg == "--iterations") {
+            options.iterations = value;
+        } else {
+            return false;
+        }
+    }
+    return argc % 2 == 1 && options.devices > 0 && options.iterations > 0;
+}
+} // namespace
+
+/*
+ * Converts a list of devices to JS, and a list of media infos from JS, once per iteration inside its own handle
+ * scope, the way a callback or a call of the kit does. The property keys are created on the first conversion and
+ * reused by all the later ones, so only the values are created per conversion.
+ */
+int RunNapiConvertBench(int argc, char *argv[])
+{
+    BenchOptions options;
+    if (!ParseOptions(argc, argv, options)) {
+        std::cerr << "usage: napi_convert_bench [--devices <n>] [--iterations <n>]" << std::endl;
+        return EXIT_FAILURE;
+    }
+    auto devices = MakeDevices(options.devices);
+    bool isDevicesOk = true;
+    uint64_t stringsBefore = g_stringsCreated;
+    {
+        HandleScope scope;
+        isDevicesOk = IsDeviceListConverted(ConvertDeviceListToJS(g_env, devices), devices);
+    }
+    uint64_t firstListStrings = g_stringsCreated - stringsBefore;
+    stringsBefore = g_stringsCreated;
+    auto start = Clock::now();
+    for (int i = 0; i < options.iterations; i++) {
+        HandleScope scope;
+        isDevicesOk = ConvertDeviceListToJS(g_env, devices) != nullptr && isDevicesOk;
+    }
+    double listsPerS = PerSecond(options.iterations, start);
+    uint64_t listStrings = (g_stringsCreated - stringsBefore) / options.iterations;
+
+    std::vector<MediaInfo> mediaInfos;
+    for (int i = 0; i < options.devices; i++) {
+        mediaInfos.push_back(MakeMediaInfo(i));
+    }
+    bool isMediaInfosOk = true;
+    double mediaInfosPerS = 0;
+    {
+        HandleScope outer;
+        std::vector<napi_value> jsMediaInfos;
+        for (const auto &mediaInfo : mediaInfos) {
+            jsMediaInfos.push_back(ConvertMediaInfoToJS(g_env, mediaInfo));
+        }
+        start = Clock::now();
+        for (int i = 0; i < options.iterations; i++) {
+            HandleScope scope;
+            for (size_t j = 0; j < jsMediaInfos.size(); j++) {
+                MediaInfo mediaInfo;
+                isMediaInfosOk = GetMediaInfoFromJS(g_env, jsMediaInfos[j], mediaInfo) &&
+                    (i != 0 || IsSameMediaInfo(mediaInfo, mediaInfos[j])) && isMediaInfosOk;
+            }
+        }
+        mediaInfosPerS = PerSecond(options.iterations * options.devices, start);
+    }
+
+    for (const auto &hook : g_cleanupHooks) {
+        hook.fun(hook.arg);
+    }
+    g_cleanupHooks.clear();
+    json result = {
+        { "devices", options.devices }, { "iterations", options.iterations },
+        { "device_lists_per_s", listsPerS }, { "devices_per_s", listsPerS * options.devices },
+        { "strings_first_list", firstListStrings }, { "strings_per_list", listStrings },
+        { "media_infos_from_js_per_s", mediaInfosPerS },
+        { "round_trip_ok", isDevicesOk && isMediaInfosOk }
+    };
+    std::cout << result.dump(4) << std::endl;
+    return isDevicesOk && isMediaInfosOk ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+} // namespace CastEngineClient
+} // namespace CastEngine
+} // namespace OHOS
+
+using OHOS::CastEngine::CastEngineClient::CleanupHook;
+using OHOS::CastEngine::CastEngineClient::g_cleanupHooks;
+using OHOS::CastEngine::CastEngineClient::g_scopeMarks;
+using OHOS::CastEngine::CastEngineClient::g_scopeValues;
+using OHOS::CastEngine::CastEngineClient::g_stringsCreated;
+
+namespace {
+napi_value NewValue(napi_valuetype type)
+{
+    auto value = new napi_value__;
+    value->type = type;
+    g_scopeValues.push_back(value);
+    return value;
+}
+
+napi_value GetUndefined()
+{
+    static napi_value__ undefined;
+    return &undefined;
+}
+} // namespace
+
+napi_status napi_open_handle_scope(napi_env env, napi_handle_scope *result)
+{
+    g_scopeMarks.push_back(g_scopeValues.size());
+    return napi_ok;
+}
+
+napi_status napi_close_handle_scope(napi_env env, napi_handle_scope scope)
+{
+    if (g_scopeMarks.empty()) {
+        return napi_invalid_arg;
+    }
+    for (size_t i = g_scopeMarks.back(); i < g_scopeValues.size(); i++) {
+        napi_value value = g_scopeValues[i];
+        value->isInScope = false;
+        if (value->refs == 0) {
+            delete value;
+        }
+    }
+    g_scopeValues.resize(g_scopeMarks.back());
+    g_scopeMarks.pop_back();
+    return napi_ok;
+}
+
+napi_status napi_create_string_utf8(napi_env env, const char *str, size_t length, napi_value *result)
+{
+    g_stringsCreated++;
+    *result = NewValue(napi_string);
+    (*result)->str = length == NAPI_AUTO_LENGTH ? std::string(str) : std::string(str, length);
+    return napi_ok;
+}
+
+napi_status napi_create_int32(napi_env env, int32_t value, napi_value *result)
+{
+    *result = NewValue(napi_number);
+    (*result)->number = value;
+    return napi_ok;
+}
+
+napi_status napi_create_uint32(napi_env env, uint32_t value, napi_value *result)
+{
+    *result = NewValue(napi_number);
+    (*result)->number = value;
+    return napi_ok;
+}
+
+napi_status napi_get_boolean(napi_env env, bool value, napi_value *result)
+{
+    *result = NewValue(napi_boolean);
+    (*result)->flag = value;
+    return napi_ok;
+}
+
+napi_status napi_create_object(napi_env env, napi_value *result)
+{
+    *result = NewValue(napi_object);
+    return napi_ok;
+}
+
+napi_status napi_create_array_with_length(napi_env env, size_t length, napi_value *result)
+{
+    *result = NewValue(napi_object);
+    (*result)->isArray = true;
+    (*result)->elements.resize(length, nullptr);
+    return napi_ok;
+}
+
+napi_status napi_set_element(napi_env env, napi_value object, uint32_t index, napi_value value)
+{
+    if (object == nullptr || value == nullptr || !object->isArray) {
+        return napi_invalid_arg;
+    }
+    if (index >= object->elements.size()) {
+        object->elements.resize(index + 1, nullptr);
+    }
+    object->elements[index] = value;
+    return napi_ok;
+}
+
+napi_status napi_get_element(napi_env env, napi_value object, uint32_t index, napi_value *result)
+{
+    if (object == nullptr || !object->isArray) {
+        return napi_invalid_arg;
+    }
+    *result = index < object->elements.size() && object->elements[index] != nullptr ?
+        object->elements[index] : GetUndefined();
+    return napi_ok;
+}
+
+napi_status napi_is_array(napi_env env, napi_value value, bool *result)
+{
+    *result = value != nullptr && value->isArray;
+    return napi_ok;
+}
+
+napi_status napi_get_array_length(napi_env env, napi_value value, uint32_t *result)
+{
+    if (value == nullptr || !value->isArray) {
+        return napi_invalid_arg;
+    }
+    *result = static_cast<uint32_t>(value->elements.size());
+    return napi_ok;
+}
+
+napi_status napi_define_properties(napi_env env, napi_value object, size_t count,
+    const napi_property_descriptor *properties)
+{
+    if (object == nullptr || object->type != napi_object) {
+        return napi_object_expected;
+    }
+    for (size_t i = 0; i < count; i++) {
+        if (properties[i].name == nullptr && properties[i].utf8name == nullptr) {
+            return napi_invalid_arg;
+        }
+        std::string name = properties[i].name != nullptr ? properties[i].name->str : properties[i].utf8name;
+        object->properties[name] = properties[i].value;
+    }
+    return napi_ok;
+}
+
+napi_status napi_get_named_property(napi_env env, napi_value object, const char *name, napi_value *result)
+{
+    if (object == nullptr || object->type != napi_object) {
+        return napi_object_expected;
+    }
+    auto property = object->properties.find(name);
+    *result = property != object->properties.end() ? property->second : GetUndefined();
+    return napi_ok;
+}
+
+napi_status napi_get_property(napi_env env, napi_value object, napi_value key, napi_value *result)
+{
+    if (key == nullptr || key->type != napi_string) {
+        return napi_string_expected;
+    }
+    return napi_get_named_property(env, object, key->str.c_str(), result);
+}
+
+napi_status napi_typeof(napi_env env, napi_value value, napi_valuetype *result)
+{
+    if (value == nullptr) {
+        return napi_invalid_arg;
+    }
+    *result = value->type;
+    return napi_ok;
+}
+
+napi_status napi_get_value_string_utf8(napi_env env, napi_value value, char *buf, size_t size, size_t *result)
+{
+    if (value == nullptr || value->type != napi_string) {
+        return napi_string_expected;
+    }
+    if (buf == nullptr) {
+        *result = value->str.size();
+        return napi_ok;
+    }
+    size_t copied = size == 0 ? 0 : std::min(size - 1, value->str.size());
+    if (size > 0) {
+        std::memcpy(buf, value->str.data(), copied);
+        buf[copied] = '\0';
+    }
+    *result = copied;
+    return napi_ok;
+}
+
+napi_status napi_get_value_int32(napi_env env, napi_value value, int32_t *result)
+{
+    *result = static_cast<int32_t>(value->number);
+    return napi_ok;
+}
+
+napi_status napi_get_value_uint32(napi_env env, napi_value value, uint32_t *result)
+{
+    *result = static_cast<uint32_t>(value->number);
+    return napi_ok;
+}
+
+napi_status napi_get_value_int64(napi_env env, napi_value value, int64_t *result)
+{
+    *result = static_cast<int64_t>(value->number);
+    return napi_ok;
+}
+
+napi_status napi_get_value_double(napi_env env, napi_value value, double *result)
+{
+    *result = value->number;
+    return napi_ok;
+}
+
+napi_status napi_get_value_bool(napi_env env, napi_value value, bool *result)
+{
+    *result = value->flag;
+    return napi_ok;
+}
+
+napi_status napi_get_undefined(napi_env env, napi_value *result)
+{
+    *result = GetUndefined();
+    return napi_ok;
+}
+
+napi_status napi_create_reference(napi_env env, napi_value value, uint32_t count, napi_ref *result)
+{
+    value->refs++;
+    *result = new napi_ref__{ value };
+    return napi_ok;
+}
+
+napi_status napi_delete_reference(napi_env env, napi_ref ref)
+{
+    if (--ref->value->refs == 0 && !ref->value->isInScope) {
+        delete ref->value;
+    }
+    delete ref;
+    return napi_ok;
+}
+
+napi_status napi_get_reference_value(napi_env env, napi_ref ref, napi_value *result)
+{
+    *result = ref->value;
+    return napi_ok;
+}
+
+napi_status napi_strict_equals(napi_env env, napi_value lhs, napi_value rhs, bool *result)
+{
+    *result = lhs == rhs;
+    return napi_ok;
+}
+
+napi_status napi_add_env_cleanup_hook(napi_env env, void (*fun)(void *arg), void *arg)
+{
+    g_cleanupHooks.push_back(CleanupHook{ fun, arg });
+    return napi_ok;
+}
+
+// The kit calls and callbacks are not part of the conversions, the utils only need them to link.
+napi_status napi_call_function(napi_env env, napi_value recv, napi_value func, size_t argc, const napi_value *argv,
+    napi_value *result)
+{
+    return napi_generic_failure;
+}
+
+napi_status napi_get_cb_info(napi_env env, napi_callback_info info, size_t *argc, napi_value *argv,
+    napi_value *thisArg, void **data)
+{
+    return napi_generic_failure;
+}
+
+int main(int argc, char *argv[])
+{
+    return OHOS::CastEngine::CastEngineClient::RunNapiConvertBench(argc, argv);
+}
@@ -0,0 +1,222 @@
+/*
+ * Copyright (C) 2023-2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * Description: a source and a sink rtsp controller negotiating over a delayed link, negotiation time as json.
+ * Author: zhangge
+ * Create: 2023-06-05
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "cast_engine_metrics.h"
+#include "json.hpp"
+#include "rtsp_liveness.h"
+#include "rtsp_param_info.h"
+#include "rtsp_session_pair.h"
+
+namespace OHOS {
+namespace CastEngine {
+namespace CastEngineService {
+namespace {
+using nlohmann::json;
+using CastSessionRtsp::ParamInfo;
+using CastSessionRtsp::RtspLiveness;
+using Clock = std::chrono::steady_clock;
+
+// Well past the six round trips of the negotiation on any link the tests use, short of the request timeout.
+constexpr int NEGOTIATION_TIMEOUT_MS = 8000;
+// The liveness of the source is checked on the 200 ms timer of the controller, once more for every probe.
+constexpr int DETECTION_SLACK_MS = 200 * (RtspLiveness::MAX_LOST_PROBES + 1);
+// Long enough for the idle source to probe the sink a few times.
+constexpr int SOAK_MS = 4 * RtspLiveness::IDLE_PROBE_INTERVAL_MS;
+// A link whose delay often doubles from one message to the next.
+constexpr int64_t LIVENESS_RTT_MS = 100;
+constexpr int64_t LIVENESS_JITTER_MS = 150;
+
+struct LoopbackOptions {
+    int64_t rttMs{ 200 };
+    int64_t jitterMs{ 0 };
+    int rounds{ 3 };
+};
+
+/*
+ * From the sink's ANNOUNCE to both ends set up: ANNOUNCE and OPTIONS both ways, GET_PARAMETER, SET_PARAMETER, the
+ * SETUP trigger and the SETUP. Every step waits for the answer to the one before, twelve legs or six round trips.
+ */
+bool CheckNegotiation(const LoopbackOptions &options, json &report)
+{
+    std::vector<int64_t> negotiationUs;
+    uint32_t messages = 0;
+    int errors = 0;
+    for (int round = 0; round < options.rounds; round++) {
+        RtspLinkConfig config{ options.rttMs * 1000, options.jitterMs * 1000, static_cast<uint32_t>(round + 1) };
+        RtspSessionPair pair(config);
+        if (!pair.Start()) {
+            report["negotiation"] = { { "error", "controller start failed" } };
+            return false;
+        }
+        int64_t elapsedUs = pair.WaitEstablished(NEGOTIATION_TIMEOUT_MS);
+        pair.Stop();
+        errors += pair.GetSourceListener()->GetErrors() + pair.GetSinkListener()->GetErrors();
+        if (elapsedUs < 0) {
+            report["negotiation"] = { { "error", "not established" }, { "round", round } };
+            return false;
+        }
+        negotiationUs.push_back(elapsedUs);
+        messages = pair.GetSourceToSink()->GetDelivered() + pair.GetSinkToSource()->GetDelivered();
+    }
+    std::sort(negotiationUs.begin(), negotiationUs.end());
+    int64_t sum = 0;
+    for (auto us : negotiationUs) {
+        sum += us;
+    }
+    int64_t p50 = negotiationUs[negotiationUs.size() / 2];
+    double roundTrips = options.rttMs > 0 ? static_cast<double>(p50) / (options.rttMs * 1000) : 0;
+    report["negotiation"] = {
+        { "rtt_ms", options.rttMs },
+        { "jitter_ms", options.jitterMs },
+        { "rounds", options.rounds },
+        { "mean_us", sum / static_cast<int64_t>(negotiationUs.size()) },
+        { "p50_us", p50 },
+        { "max_us", negotiationUs.back() },
+        { "round_trips", roundTrips },
+        { "messages", messages },
+        { "errors", errors },
+    };
+    return errors == 0;
+}
+
+int64_t ElapsedMs(Clock::time_point start)
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - start).count();
+}
+
+bool StartKeepAlivePair(RtspSessionPair &pair, const char *check, json &report)
+{
+    if (!pair.Start()) {
+        report[check] = { { "error", "controller start failed" } };
+        return false;
+    }
+    if (pair.WaitEstablished(NEGOTIATION_TIMEOUT_MS) < 0) {
+        report[check] = { { "error", "not established" } };
+        pair.Stop();
+        return false;
+    }
+    return true;
+}
+
+// Once the probes of the source stop reaching the sink, and with them the answers to the sink's own probes, both ends
+// must give the other up within the detection bound.
+bool CheckPeerGone(json &report)
+{
+    static auto &peerGone = CastEngineMetrics::GetInstance().RegisterCounter(METRIC_RTSP_PEER_GONE);
+    RtspSessionPair pair(RtspLinkConfig{ LIVENESS_RTT_MS * 1000, 0, 1 }, { ParamInfo::FEATURE_KEEP_ALIVE });
+    if (!StartKeepAlivePair(pair, "peer_gone", report)) {
+        return false;
+    }
+    constexpr int boundMs = RtspLiveness::DETECTION_BOUND_MS + DETECTION_SLACK_MS;
+    int64_t peerGoneBefore = peerGone.Value();
+    auto downTime = Clock::now();
+    pair.GetSourceToSink()->SetDown(true);
+    bool isSourceDetected = pair.GetSourceListener()->WaitError(boundMs);
+    int64_t sourceDetectionMs = ElapsedMs(downTime);
+    bool isSinkDetected = pair.GetSinkListener()->WaitError(static_cast<int>(std::max<int64_t>(
+        boundMs - ElapsedMs(downTime), 0)));
+    int64_t sinkDetectionMs = ElapsedMs(downTime);
+    pair.Stop();
+    int64_t peerGoneCount = peerGone.Value() - peerGoneBefore;
+    report["peer_gone"] = {
+        { "rtt_ms", LIVENESS_RTT_MS },
+        { "bound_ms", RtspLiveness::DETECTION_BOUND_MS },
+        { "source_detected", isSourceDetected },
+        { "source_detection_ms", sourceDetectionMs },
+        { "sink_detected", isSinkDetected },
+        { "sink_detection_ms", sinkDetectionMs },
+        { "peer_gone", peerGoneCount },
+    };
+    return isSourceDetected && isSinkDetected && peerGoneCount == 2;
+}
+
+// A healthy link with a jittery delay must never be taken for a dead peer.
+bool CheckJitterSoak(json &report)
+{
+    static auto &lostProbes = CastEngineMetrics::GetInstance().RegisterCounter(METRIC_RTSP_KEEP_ALIVE_LOST);
+    RtspSessionPair pair(RtspLinkConfig{ LIVENESS_RTT_MS * 1000, LIVENESS_JITTER_MS * 1000, 1 },
+        { ParamInfo::FEATURE_KEEP_ALIVE });
+    if (!StartKeepAlivePair(pair, "jitter_soak", report)) {
+        return false;
+    }
+    int64_t lostBefore = lostProbes.Value();
+    uint32_t deliveredBefore = pair.GetSourceToSink()->GetDelivered();
+    bool isFalsePositive = pair.GetSourceListener()->WaitError(SOAK_MS);
+    uint32_t probes = pair.GetSourceToSink()->GetDelivered() - deliveredBefore;
+    pair.Stop();
+    report["jitter_soak"] = {
+        { "rtt_ms", LIVENESS_RTT_MS },
+        { "jitter_ms", LIVENESS_JITTER_MS },
+        { "soak_ms", SOAK_MS },
+        { "probes", probes },
+        { "lost_probes", lostProbes.Value() - lostBefore },
+        { "errors", pair.GetSourceListener()->GetErrors() + pair.GetSinkListener()->GetErrors() },
+    };
+    return !isFalsePositive && probes > 0 && pair.GetSinkListener()->GetErrors() == 0;
+}
+
+bool ParseOptions(int argc, char *argv[], LoopbackOptions &options)
+{
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string arg = argv[i];
+        if (arg == "--rtt-ms") {
+            options.rttMs = std::atoll(argv[i + 1]);
+        } else if (arg == "--jitter-ms") {
+            options.jitterMs = std::atoll(argv[i + 1]);
+        } else if (arg == "--rounds") {
+            options.rounds = std::atoi(argv[i + 1]);
+        } else {
+            return false;
+        }
+    }
+    return argc % 2 == 1 && options.rttMs >= 0 && options.jitterMs >= 0 && options.rounds > 0;
+}
+} // namespace
+
+int RunRtspLoopback(int argc, char *argv[])
+{
+    LoopbackOptions options;
+    if (!ParseOptions(argc, argv, options)) {
+        std::cerr << "usage: rtsp_loopback [--rtt-ms <ms>] [--jitter-ms <ms>] [--rounds <n>]" << std::endl;
+        return EXIT_FAILURE;
+    }
+    json report;
+    bool isNegotiated = CheckNegotiation(options, report);
+    bool isPeerGoneDetected = CheckPeerGone(report);
+    bool isJitterTolerated = CheckJitterSoak(report);
+    bool isPassed = isNegotiated && isPeerGoneDetected && isJitterTolerated;
+    report["passed"] = isPassed;
+    std::cout << report.dump(2) << std::endl;
+    return isPassed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+} // namespace CastEngineService
+} // namespace CastEngine
+} // namespace OHOS
+
+int main(int argc, char *argv[])
+{
+    return OHOS::CastEngine::CastEngineService::RunRtspLoopback(argc, argv);
+}
@@ -0,0 +1,286 @@
+/*
+ * Copyright (C) 2023-2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * Description: a source and a sink rtsp controller negotiating over an in-process link with delay, jitter and loss.
+ * Author: zhangge
+ * Create: 2023-06-05
+ */
+
+#include "rtsp_session_pair.h"
+
+#include <algorithm>
+
+namespace OHOS {
+namespace CastEngine {
+namespace CastEngineService {
+using namespace CastSessionRtsp;
+using Clock = std::chrono::steady_clock;
+
+namespace {
+constexpr char SOURCE_DEVICE_ID[] = "rtsp-pair-source";
+constexpr char SINK_DEVICE_ID[] = "rtsp-pair-sink";
+// What CastSessionImpl answers the SETUP with once the media channels listen.
+constexpr int MEDIA_PORT = 7236;
+constexpr int REMOTE_CONTROL_PORT = 7237;
+// CastSessionImpl::CAST_VERSION.
+constexpr double CAST_VERSION = 1.0;
+} // namespace
+
+RtspLink::RtspLink(const RtspLinkConfig &config, uint32_t seed) : config_(config), random_(seed)
+{
+    ChannelRequest request;
+    request.linkType = ChannelLinkType::TCP;
+    request.moduleType = ModuleType::RTSP;
+    SetRequest(request);
+}
+
+RtspLink::~RtspLink()
+{
+    Stop();
+}
+
+void RtspLink::Connect(std::shared_ptr<IChannelListener> receiver)
+{
+    receiver_ = receiver;
+    thread_ = std::thread(&RtspLink::Deliver, this);
+}
+
+void RtspLink::Stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        isStopped_ = true;
+    }
+    cond_.notify_all();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+bool RtspLink::Send(const uint8_t *buffer, int length)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (isStopped_) {
+        return false;
+    }
+    if (isDown_) {
+        return true;
+    }
+    int64_t delayUs = config_.rttUs / 2;
+    if (config_.jitterUs > 0) {
+        delayUs += std::uniform_int_distribution<int64_t>(0, config_.jitterUs)(random_);
+    }
+    // A stream link, nothing overtakes what was sent before it.
+    lastDue_ = std::max(lastDue_, Clock::now() + std::chrono::microseconds(delayUs));
+    queue_.push_back({ lastDue_, std::vector<uint8_t>(buffer, buffer + length) });
+    cond_.notify_all();
+    return true;
+}
+
+void RtspLink::Deliver()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!isStopped_) {
+        if (queue_.empty()) {
+            cond_.wait(lock);
+            continue;
+        }
+        if (Clock::now() < queue_.front().due) {
+            cond_.wait_until(lock, queue_.front().due);
+            continue;
+        }
+        auto data = std::move(queue_.front().data);
+        queue_.pop_front();
+        // The receiver answers from here, which sends on the other link and may take its lock.
+        lock.unlock();
+        receiver_->OnDataReceived(data.data(), static_cast<unsigned int>(data.size()), 0);
+        delivered_++;
+        lock.lock();
+    }
+}
+
+bool RtspEndListener::WaitSetup(int timeoutMs)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    return cond_.wait_for(lock, std::chrono::milliseconds(timeoutMs), [this] { return isSetup_; });
+}
+
+bool RtspEndListener::WaitPlay(int timeoutMs)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    return cond_.wait_for(lock, std::chrono::milliseconds(timeoutMs), [this] { return isPlaying_; });
+}
+
+bool RtspEndListener::WaitError(int timeoutMs)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    return cond_.wait_for(lock, std::chrono::milliseconds(timeoutMs), [this] { return errors_ > 0; });
+}
+
+Clock::time_point RtspEndListener::GetSetupTime()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return setupTime_;
+}
+
+void RtspEndListener::OnSetup(const ParamInfo &param, int tsPort, int rcPort, const std::string &deviceId)
+{
+    if (endType_ == EndType::CAST_SOURCE) {
+        // The source is set up once its answer to the SETUP is out.
+        if (auto controller = controller_.lock()) {
+            controller->SetupPort(MEDIA_PORT, REMOTE_CONTROL_PORT, INVALID_PORT);
+        }
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        isSetup_ = true;
+        setupTime_ = Clock::now();
+    }
+    cond_.notify_all();
+}
+
+bool RtspEndListener::OnPlayerReady(const ParamInfo &clientParam, const std::string &deviceId, int readyFlag)
+{
+    return true;
+}
+
+bool RtspEndListener::OnPlay(const ParamInfo &param, int port, const std::string &deviceId)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        isPlaying_ = true;
+    }
+    cond_.notify_all();
+    return true;
+}
+
+bool RtspEndListener::OnPause()
+{
+    return true;
+}
+
+void RtspEndListener::OnTearDown() {}
+
+void RtspEndListener::OnError(int errCode)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        errors_++;
+    }
+    cond_.notify_all();
+}
+
+void RtspEndListener::NotifyTrigger(int trigger) {}
+
+void RtspEndListener::NotifyEventChange(int moduleId, int event, const std::string &param) {}
+
+void RtspEndListener::NotifyModuleCustomParamsNegotiation(const std::string &mediaParams,
+    const std::string &controllerParams)
+{
+    if (endType_ != EndType::CAST_SOURCE) {
+        return;
+    }
+    if (auto controller = controller_.lock()) {
+        controller->ModuleCustomParamsNegotiationDone();
+    }
+}
+
+int RtspEndListener::StartMediaVtp(const ParamInfo &param)
+{
+    return INVALID_PORT;
+}
+
+bool RtspEndListener::NotifyEvent(int event)
+{
+    return true;
+}
+
+void RtspEndListener::ProcessStreamMode(const ParamInfo &param, const std::string &deviceId) {}
+
+void RtspEndListener::NotifyScreenParam(const std::string &screenParam) {}
+
+RtspSessionPair::RtspSessionPair(const RtspLinkConfig &config, const std::set<int> &featureSet)
+    : featureSet_(featureSet),
+      sourceListener_(std::make_shared<RtspEndListener>(EndType::CAST_SOURCE)),
+      sinkListener_(std::make_shared<RtspEndListener>(EndType::CAST_SINK)),
+      sourceToSink_(std::make_shared<RtspLink>(config, config.seed)),
+      sinkToSource_(std::make_shared<RtspLink>(config, config.seed + 1))
+{
+    source_ = IRtspController::GetInstance(sourceListener_, ProtocolType::CAST_PLUS_MIRROR, EndType::CAST_SOURCE);
+    sink_ = IRtspController::GetInstance(sinkListener_, ProtocolType::CAST_PLUS_MIRROR, EndType::CAST_SINK);
+    sourceListener_->SetController(source_);
+    sinkListener_->SetController(sink_);
+}
+
+RtspSessionPair::~RtspSessionPair()
+{
+    Stop();
+}
+
+ParamInfo RtspSessionPair::BuildParamInfo() const
+{
+    ParamInfo param;
+    param.SetVersion(CAST_VERSION);
+    VideoProperty video{};
+    video.videoWidth = 1920;
+    video.videoHeight = 1080;
+    video.fps = 60;
+    video.codecType = VideoCodecType::H264;
+    param.SetVideoProperty(video);
+    param.SetFeatureSet(featureSet_);
+    return param;
+}
+
+bool RtspSessionPair::Start(const uint8_t *sessionKey, uint32_t sessionKeyLength)
+{
+    ParamInfo param = BuildParamInfo();
+    if (!source_ || !sink_ || !source_->Start(param, sessionKey, sessionKeyLength) ||
+        !sink_->Start(param, sessionKey, sessionKeyLength)) {
+        return false;
+    }
+    sourceToSink_->Connect(sink_->GetChannelListener());
+    sinkToSource_->Connect(source_->GetChannelListener());
+
+    CastInnerRemoteDevice sinkDevice;
+    sinkDevice.deviceId = SINK_DEVICE_ID;
+    sinkDevice.channelType = ChannelType::LEGACY_CHANNEL;
+    CastInnerRemoteDevice sourceDevice = sinkDevice;
+    sourceDevice.deviceId = SOURCE_DEVICE_ID;
+    startTime_ = Clock::now();
+    source_->AddChannel(sourceToSink_, sinkDevice);
+    sink_->AddChannel(sinkToSource_, sourceDevice);
+    return true;
+}
+
+int64_t RtspSessionPair::WaitEstablished(int timeoutMs)
+{
+    auto deadline = startTime_ + std::chrono::milliseconds(timeoutMs);
+    auto remainingMs = [deadline]() {
+        return static_cast<int>(std::max<int64_t>(0,
+            std::chrono::duration_cast<std::chrono::milliseconds>(deadline - Clock::now()).count()));
+    };
+    if (!sourceListener_->WaitSetup(remainingMs()) || !sinkListener_->WaitSetup(remainingMs())) {
+        return -1;
+    }
+    auto established = std::max(sourceListener_->GetSetupTime(), sinkListener_->GetSetupTime());
+    return std::chrono::duration_cast<std::chrono::microseconds>(established - startTime_).count();
+}
+
+void RtspSessionPair::Stop()
+{
+    sourceToSink_->Stop();
+    sinkToSource_->Stop();
+}
+} // namespace CastEngineService
+} // namespace CastEngine
+} // namespace OHOS
@@ -0,0 +1,199 @@
+/*
+ * Copyright (C) 2023-2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * Description: a source and a sink rtsp controller negotiating over an in-process link with delay, jitter and loss.
+ * Author: zhangge
+ * Create: 2023-06-05
+ */
+
+#ifndef RTSP_SESSION_PAIR_H
+#define RTSP_SESSION_PAIR_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include "channel.h"
+#include "i_rtsp_controller.h"
+
+namespace OHOS {
+namespace CastEngine {
+namespace CastEngineService {
+struct RtspLinkConfig {
+    int64_t rttUs{ 0 };
+    // Each message is delayed by up to this much on top of half the rtt, without overtaking the one before it.
+    int64_t jitterUs{ 0 };
+    uint32_t seed{ 1 };
+};
+
+/*
+ * One direction of the link between the controllers, the channel the sending controller writes to. A message is
+ * handed to the channel listener of the receiving controller on the link's own thread once it is due, so the two
+ * controllers run as concurrently as over a socket. A link that is down drops what is sent on it without telling the
+ * sender, the way a peer vanishing from the Wi-Fi looks like.
+ */
+class RtspLink : public Channel {
+public:
+    RtspLink(const RtspLinkConfig &config, uint32_t seed);
+    ~RtspLink() override;
+
+    void Connect(std::shared_ptr<IChannelListener> receiver);
+    void Stop();
+    void SetDown(bool isDown)
+    {
+        isDown_ = isDown;
+    }
+    uint32_t GetDelivered() const
+    {
+        return delivered_;
+    }
+
+    bool Send(const uint8_t *buffer, int length) override;
+
+private:
+    struct Pending {
+        std::chrono::steady_clock::time_point due;
+        std::vector<uint8_t> data;
+    };
+
+    void Deliver();
+
+    RtspLinkConfig config_;
+    std::mt19937 random_;
+    std::shared_ptr<IChannelListener> receiver_;
+    std::mutex mutex_;
+    std::condition_variable cond_;
+    std::deque<Pending> queue_;
+    std::chrono::steady_clock::time_point lastDue_{};
+    bool isStopped_{ false };
+    std::atomic<bool> isDown_{ false };
+    std::atomic<uint32_t> delivered_{ 0 };
+    std::thread thread_;
+};
+
+/*
+ * Stands in for CastSessionImpl on one end: the source finishes the custom parameter negotiation and answers the
+ * SETUP with ports right away, both ends note when they are set up and how often the controller gave up.
+ */
+class RtspEndListener : public CastSessionRtsp::IRtspListener {
+public:
+    explicit RtspEndListener(EndType endType) : endType_(endType) {}
+
+    void SetController(std::weak_ptr<CastSessionRtsp::IRtspController> controller)
+    {
+        controller_ = controller;
+    }
+    bool WaitSetup(int timeoutMs);
+    bool WaitPlay(int timeoutMs);
+    bool WaitError(int timeoutMs);
+    std::chrono::steady_clock::time_point GetSetupTime();
+    int GetErrors() const
+    {
+        return errors_;
+    }
+
+    void OnSetup(const CastSessionRtsp::ParamInfo &param, int tsPort, int rcPort,
+        const std::string &deviceId) override;
+    bool OnPlayerReady(const CastSessionRtsp::ParamInfo &clientParam, const std::string &deviceId,
+        int readyFlag) override;
+    bool OnPlay(const CastSessionRtsp::ParamInfo &param, int port, const std::string &deviceId) override;
+    bool OnPause() override;
+    void OnTearDown() override;
+    void OnError(int errCode) override;
+    void NotifyTrigger(int trigger) override;
+    void NotifyEventChange(int moduleId, int event, const std::string &param) override;
+    void NotifyModuleCustomParamsNegotiation(const std::string &mediaParams,
+        const std::string &controllerParams) override;
+    int StartMediaVtp(const CastSessionRtsp::ParamInfo &param) override;
+    bool NotifyEvent(int event) override;
+    void ProcessStreamMode(const CastSessionRtsp::ParamInfo &param, const std::string &deviceId) override;
+    void NotifyScreenParam(const std::string &screenParam) override;
+
+private:
+    EndType endType_;
+    std::weak_ptr<CastSessionRtsp::IRtspController> controller_;
+    std::mutex mutex_;
+    std::condition_variable cond_;
+    bool isSetup_{ false };
+    bool isPlaying_{ false };
+    std::chrono::steady_clock::time_point setupTime_{};
+    std::atomic<int> errors_{ 0 };
+};
+
+/*
+ * A phone (source) and a TV (sink) on the tcp link of a mirroring session. Start() hands both controllers their link,
+ * the sink opens with its ANNOUNCE and the negotiation runs through to the SETUP on its own.
+ */
+class RtspSessionPair {
+public:
+    explicit RtspSessionPair(const RtspLinkConfig &config, const std::set<int> &featureSet = {});
+    ~RtspSessionPair();
+
+    bool Start(const uint8_t *sessionKey = SESSION_KEY, uint32_t sessionKeyLength = sizeof(SESSION_KEY));
+    // Time from Start() until both ends are set up, -1 if that did not happen within the timeout.
+    int64_t WaitEstablished(int timeoutMs);
+    void Stop();
+
+    std::shared_ptr<CastSessionRtsp::IRtspController> GetSource() const
+    {
+        return source_;
+    }
+    std::shared_ptr<CastSessionRtsp::IRtspController> GetSink() const
+    {
+        return sink_;
+    }
+    std::shared_ptr<RtspEndListener> GetSourceListener() const
+    {
+        return sourceListener_;
+    }
+    std::shared_ptr<RtspEndListener> GetSinkListener() const
+    {
+        return sinkListener_;
+    }
+    std::shared_ptr<RtspLink> GetSourceToSink() const
+    {
+        return sourceToSink_;
+    }
+    std::shared_ptr<RtspLink> GetSinkToSource() const
+    {
+        return sinkToSource_;
+    }
+
+    static constexpr uint8_t SESSION_KEY[16] = { 0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6, 0xab, 0xf7, 0x15,
+        0x88, 0x09, 0xcf, 0x4f, 0x3c };
+
+private:
+    CastSessionRtsp::ParamInfo BuildParamInfo() const;
+
+    std::set<int> featureSet_;
+    std::shared_ptr<RtspEndListener> sourceListener_;
+    std::shared_ptr<RtspEndListener> sinkListener_;
+    std::shared_ptr<CastSessionRtsp::IRtspController> source_;
+    std::shared_ptr<CastSessionRtsp::IRtspController> sink_;
+    std::shared_ptr<RtspLink> sourceToSink_;
+    std::shared_ptr<RtspLink> sinkToSource_;
+    std::chrono::steady_clock::time_point startTime_{};
+};
+} // namespace CastEngineService
+} // namespace CastEngine
+} // namespace OHOS
+
+#endif
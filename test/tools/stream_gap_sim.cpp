@@ -0,0 +1,491 @@
+/*
+ * Copyright (C) 2023-2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * Description: measures the end of stream to next item gap of the stream player, off the device.
+ * Author: zhangge
+ * Create: 2023-06-05
+ */
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <future>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "cast_engine_errors.h"
+#include "cast_engine_metrics.h"
+#include "cast_stream_player_manager.h"
+#include "i_cast_stream_manager.h"
+#include "json.hpp"
+#include "player.h"
+
+namespace OHOS {
+namespace CastEngine {
+namespace CastEngineService {
+namespace {
+using nlohmann::json;
+using Clock = std::chrono::steady_clock;
+
+constexpr int WAIT_TIMEOUT_MS = 10000;
+
+struct GapOptions {
+    int items{ 10 };
+    int itemMs{ 200 };
+    int setSourceMs{ 20 };
+    int prepareMs{ 120 };
+    int playMs{ 10 };
+    int stopMs{ 5 };
+    int sourceRttMs{ 40 };
+};
+
+void SleepMs(int ms)
+{
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+// What the media players of one run share: the end of stream of the current item and the start of the next one.
+class PlaybackLog {
+public:
+    void OnEndOfStream()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        endOfStreamTime_ = Clock::now();
+        isWaitingNextItem_ = true;
+    }
+
+    void OnStarted()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (isWaitingNextItem_) {
+            isWaitingNextItem_ = false;
+            gaps_.Record(static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - endOfStreamTime_).count()));
+        }
+        startedItems_++;
+        cond_.notify_all();
+    }
+
+    bool WaitStarted(int items)
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        return cond_.wait_for(lock, std::chrono::milliseconds(WAIT_TIMEOUT_MS),
+            [this, items] { return startedItems_ >= items; });
+    }
+
+    MetricHistogram::Snapshot GetGaps() const
+    {
+        return gaps_.GetSnapshot();
+    }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable cond_;
+    Clock::time_point endOfStreamTime_;
+    bool isWaitingNextItem_{ false };
+    int startedItems_{ 0 };
+    MetricHistogram gaps_;
+};
+
+/*
+ * Stand-in for the media service player: every call takes the time the service needs for it, and an item that
+ * plays reaches its end of stream itemMs later, reported from the player's own thread as the service does.
+ */
+class FakePlayer : public Media::Player {
+public:
+    FakePlayer(const GapOptions &options, std::shared_ptr<PlaybackLog> log) : options_(options), log_(log) {}
+    ~FakePlayer() override
+    {
+        Cancel();
+    }
+
+    int32_t SetSource(const std::string &url) override
+    {
+        Cancel();
+        SleepMs(options_.setSourceMs);
+        NotifyState(PlayerStates::PLAYER_INITIALIZED);
+        return Media::MSERR_OK;
+    }
+    int32_t SetSource(const std::shared_ptr<Media::IMediaDataSource> &dataSrc) override
+    {
+        return SetSource(std::string());
+    }
+    int32_t Prepare() override
+    {
+        SleepMs(options_.prepareMs);
+        NotifyState(PlayerStates::PLAYER_PREPARED);
+        return Media::MSERR_OK;
+    }
+    int32_t PrepareAsync() override
+    {
+        return Prepare();
+    }
+    int32_t Play() override
+    {
+        Cancel();
+        SleepMs(options_.playMs);
+        log_->OnStarted();
+        NotifyState(PlayerStates::PLAYER_STARTED);
+        std::lock_guard<std::mutex> lock(mutex_);
+        isCancelled_ = false;
+        playback_ = std::thread([this] { PlayToEnd(); });
+        return Media::MSERR_OK;
+    }
+    int32_t Pause() override
+    {
+        Cancel();
+        return Media::MSERR_OK;
+    }
+    int32_t Stop() override
+    {
+        Cancel();
+        SleepMs(options_.stopMs);
+        NotifyState(PlayerStates::PLAYER_STOPPED);
+        return Media::MSERR_OK;
+    }
+    int32_t Reset() override
+    {
+        Cancel();
+        NotifyState(PlayerStates::PLAYER_IDLE);
+        return Media::MSERR_OK;
+    }
+    int32_t Release() override
+    {
+        Cancel();
+        return Media::MSERR_OK;
+    }
+    int32_t Seek(int32_t mSeconds, Media::PlayerSeekMode mode) override { return Media::MSERR_OK; }
+    int32_t SetVolume(float leftVolume, float rightVolume) override { return Media::MSERR_OK; }
+    int32_t GetCurrentTime(int32_t &currentTime) override { return Media::MSERR_OK; }
+    int32_t GetVideoTrackInfo(std::vector<Media::Format> &videoTrack) override { return Media::MSERR_OK; }
+    int32_t GetAudioTrackInfo(std::vector<Media::Format> &audioTrack) override { return Media::MSERR_OK; }
+    int32_t GetVideoWidth() override { return 0; }
+    int32_t GetVideoHeight() override { return 0; }
+    int32_t SetPlaybackSpeed(Media::PlaybackRateMode mode) override { return Media::MSERR_OK; }
+    int32_t GetPlaybackSpeed(Media::PlaybackRateMode &mode) override
+    {
+        mode = Media::SPEED_FORWARD_1_00_X;
+        return Media::MSERR_OK;
+    }
+    int32_t SelectBitRate(uint32_t bitRate) override { return Media::MSERR_OK; }
+    int32_t GetDuration(int32_t &duration) override
+    {
+        duration = options_.itemMs;
+        return Media::MSERR_OK;
+    }
+    int32_t SetVideoSurface(sptr<Surface> surface) override { return Media::MSERR_OK; }
+    bool IsPlaying() override { return false; }
+    bool IsLooping() override { return false; }
+    int32_t SetLooping(bool loop) override { return Media::MSERR_OK; }
+    int32_t SetPlayerCallback(const std::shared_ptr<Media::PlayerCallback> &callback) override
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        callback_ = callback;
+        return Media::MSERR_OK;
+    }
+    int32_t SetParameter(const Media::Format &param) override { return Media::MSERR_OK; }
+    int32_t SetPlayRangeWithMode(int64_t start, int64_t end) override { return Media::MSERR_OK; }
+
+private:
+    void PlayToEnd()
+    {
+        std::shared_ptr<Media::PlayerCallback> callback;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            if (cond_.wait_for(lock, std::chrono::milliseconds(options_.itemMs), [this] { return isCancelled_; })) {
+                return;
+            }
+            callback = callback_;
+        }
+        log_->OnEndOfStream();
+        if (callback) {
+            callback->OnInfo(Media::INFO_TYPE_STATE_CHANGE, static_cast<int32_t>(PlayerStates::PLAYER_PLAYBACK_COMPLETE),
+                Media::Format());
+            callback->OnInfo(Media::INFO_TYPE_EOS, 0, Media::Format());
+        }
+    }
+
+    void Cancel()
+    {
+        std::thread playback;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            isCancelled_ = true;
+            playback.swap(playback_);
+        }
+        cond_.notify_all();
+        if (!playback.joinable()) {
+            return;
+        }
+        if (playback.get_id() == std::this_thread::get_id()) {
+            playback.detach();
+            return;
+        }
+        playback.join();
+    }
+
+    void NotifyState(PlayerStates state)
+    {
+        std::shared_ptr<Media::PlayerCallback> callback;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            callback = callback_;
+        }
+        if (callback) {
+            callback->OnInfo(Media::INFO_TYPE_STATE_CHANGE, static_cast<int32_t>(state), Media::Format());
+        }
+    }
+
+    const GapOptions &options_;
+    std::shared_ptr<PlaybackLog> log_;
+    std::mutex mutex_;
+    std::condition_variable cond_;
+    std::shared_ptr<Media::PlayerCallback> callback_;
+    std::thread playback_;
+    bool isCancelled_{ false };
+};
+
+class NullPlayerListener : public IStreamPlayerListenerImpl {
+public:
+    void OnStateChanged(const PlayerStates playbackState, bool isPlayWhenReady) override {}
+    void OnPositionChanged(int position, int bufferPosition, int duration) override {}
+    void OnMediaItemChanged(const MediaInfo &mediaInfo) override {}
+    void OnVolumeChanged(int volume, int maxVolume) override {}
+    void OnPlayerError(int errorCode, const std::string &errorMsg) override {}
+    void OnVideoSizeChanged(int width, int height) override {}
+    void OnLoopModeChanged(const LoopMode loopMode) override {}
+    void OnPlaySpeedChanged(const PlaybackSpeed speed) override {}
+    void OnNextRequest() override {}
+    void OnPreviousRequest() override {}
+    void OnSeekDone(int position) override {}
+    void OnEndOfStream(int isLooping) override {}
+    void OnPlayRequest(const MediaInfo &mediaInfo) override {}
+    void OnImageChanged(std::shared_ptr<Media::PixelMap> pixelMap) override {}
+    void OnAlbumCoverChanged(std::shared_ptr<Media::PixelMap> pixelMap) override {}
+    void OnKeyRequest(const std::string &mediaId, const std::vector<uint8_t> &keyRequestData) override {}
+    void OnAvailableCapabilityChanged(const StreamCapability &streamCapability) override {}
+};
+
+/*
+ * Stands in for CastStreamManagerServer on the sink, with its handler thread, and for the source at the other end
+ * of the channel: the end of stream reaches the source sourceRttMs / 2 later, and its play of the next index comes
+ * back through the handler thread after as long again.
+ */
+class SimStreamManager : public ICastStreamManager, public ICastStreamManagerServer {
+public:
+    explicit SimStreamManager(const GapOptions &options) : options_(options)
+    {
+        streamActionProcessor_ = {
+            { ACTION_PLAY, [this](const json &data) { return ProcessActionPlay(data); } },
+        };
+    }
+
+    ~SimStreamManager() override
+    {
+        JoinSource();
+    }
+
+    void SetPlayer(std::shared_ptr<CastStreamPlayerManager> player)
+    {
+        player_ = player;
+    }
+
+    // The source answers from threads of its own, they are joined before the manager goes away.
+    void JoinSource()
+    {
+        std::vector<std::thread> source;
+        {
+            std::lock_guard<std::mutex> lock(sourceMutex_);
+            source.swap(source_);
+        }
+        for (auto &thread : source) {
+            thread.join();
+        }
+    }
+
+    // Returns once the handler thread ran everything queued before the call.
+    void WaitIdle()
+    {
+        auto done = std::make_shared<std::promise<void>>();
+        std::future<void> future = done->get_future();
+        if (EnqueueTask([done] { done->set_value(); })) {
+            future.wait();
+        }
+    }
+
+    sptr<IStreamPlayerIpc> CreateStreamPlayer(const std::function<void(void)> &releaseCallback) override
+    {
+        return nullptr;
+    }
+    bool PlayAfterSwitchToStream() override
+    {
+        return false;
+    }
+
+    bool NotifyPeerEndOfStream(int isLooping) override
+    {
+        std::lock_guard<std::mutex> lock(sourceMutex_);
+        int index = ++sourceIndex_;
+        source_.emplace_back([this, index] {
+            SleepMs(options_.sourceRttMs);
+            json action = { { KEY_ACTION, ACTION_PLAY }, { KEY_DATA, { { KEY_CURRENT_INDEX, index } } } };
+            ProcessActionsEvent(MODULE_EVENT_ID_CONTROL_EVENT, action.dump());
+        });
+        return true;
+    }
+    bool PostTask(const std::function<void(void)> &task) override
+    {
+        return EnqueueTask(task);
+    }
+    bool NotifyPeerPlayerStatusChanged(const PlayerStates playbackState, bool isPlayWhenReady) override
+    {
+        return true;
+    }
+    bool NotifyPeerPositionChanged(int position, int bufferPosition, int duration) override { return true; }
+    bool NotifyPeerMediaItemChanged(const MediaInfo &mediaInfo) override { return true; }
+    bool NotifyPeerVolumeChanged(int volume, int maxVolume) override { return true; }
+    bool NotifyPeerRepeatModeChanged(const LoopMode loopMode) override { return true; }
+    bool NotifyPeerPlaySpeedChanged(const PlaybackSpeed speed) override { return true; }
+    bool NotifyPeerPlayerError(int errorCode, const std::string &errorMsg) override { return true; }
+    bool NotifyPeerNextRequest() override { return true; }
+    bool NotifyPeerPreviousRequest() override { return true; }
+    bool NotifyPeerSeekDone(int position) override { return true; }
+    bool NotifyPeerPlayRequest(const MediaInfo &mediaInfo) override { return true; }
+    bool NotifyPeerCreateChannel() override { return true; }
+    void OnEvent(EventId eventId, const std::string &data) override {}
+    void OnRenderReady(bool isReady) override {}
+
+private:
+    bool ProcessActionPlay(const json &data)
+    {
+        auto player = player_.lock();
+        if (!player || !data.contains(KEY_CURRENT_INDEX)) {
+            return false;
+        }
+        return player->Play(data[KEY_CURRENT_INDEX].get<int>()) == CAST_ENGINE_SUCCESS;
+    }
+
+    const GapOptions &options_;
+    std::weak_ptr<CastStreamPlayerManager> player_;
+    std::mutex sourceMutex_;
+    std::vector<std::thread> source_;
+    int sourceIndex_{ 0 };
+};
+
+struct GapResult {
+    bool isDone{ false };
+    int64_t switches{ 0 };
+    MetricHistogram::Snapshot gaps;
+
+    json ToJson(int items) const
+    {
+        return { { "switches", switches }, { "reloads", items - 1 - switches }, { "p50_us", gaps.p50 },
+            { "p99_us", gaps.p99 }, { "max_us", gaps.max } };
+    }
+};
+
+/*
+ * Plays a list of items through CastStreamPlayerManager. Audio items are preloaded on the standby player and
+ * switched to at the end of stream, video ones are not, so they wait for the source to play the next index.
+ * The gap runs from the end of stream until the next item plays.
+ */
+GapResult RunPlaylist(const GapOptions &options, const std::string &mediaType)
+{
+    auto log = std::make_shared<PlaybackLog>();
+    Media::PlayerFactory::GetCreator() = [&options, log]() { return std::make_shared<FakePlayer>(options, log); };
+    static auto &gaplessSwitches = CastEngineMetrics::GetInstance().RegisterCounter(METRIC_STREAM_GAPLESS_SWITCHES);
+    int64_t switchesBefore = gaplessSwitches.Value();
+
+    auto streamManager = std::make_shared<SimStreamManager>(options);
+    auto player = std::make_shared<CastStreamPlayerManager>(streamManager, nullptr);
+    streamManager->SetPlayer(player);
+    player->RegisterListener(std::make_shared<NullPlayerListener>());
+    player->SetSurface(std::make_shared<IBufferProducer>());
+    player->SetLoopMode(LoopMode::LOOP_MODE_SEQUENCE);
+
+    MediaInfoHolder holder;
+    for (int i = 0; i < options.items; i++) {
+        MediaInfo mediaInfo;
+        mediaInfo.mediaId = "item" + std::to_string(i);
+        mediaInfo.mediaUrl = "http://sim/" + mediaInfo.mediaId;
+        mediaInfo.mediaType = mediaType;
+        holder.mediaInfoList.push_back(mediaInfo);
+    }
+    GapResult result;
+    result.isDone = player->InnerPlay(holder) == CAST_ENGINE_SUCCESS && log->WaitStarted(options.items);
+    streamManager->JoinSource();
+    streamManager->WaitIdle();
+    player->Stop();
+    result.switches = gaplessSwitches.Value() - switchesBefore;
+    result.gaps = log->GetGaps();
+    player = nullptr;
+    streamManager = nullptr;
+    Media::PlayerFactory::GetCreator() = nullptr;
+    return result;
+}
+
+bool ParseOptions(int argc, char *argv[], GapOptions &options)
+{
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string arg = argv[i];
+        int value = std::atoi(argv[i + 1]);
+        if (arg == "--items") {
+            options.items = value;
+        } else if (arg == "--item-ms") {
+            options.itemMs = value;
+        } else if (arg == "--prepare-ms") {
+            options.prepareMs = value;
+        } else if (arg == "--source-rtt-ms") {
+            options.sourceRttMs = value;
+        } else {
+            return false;
+        }
+    }
+    return argc % 2 == 1 && options.items > 1 && options.itemMs > 0 && options.prepareMs >= 0 &&
+        options.sourceRttMs >= 0;
+}
+} // namespace
+
+int RunStreamGapSim(int argc, char *argv[])
+{
+    GapOptions options;
+    if (!ParseOptions(argc, argv, options)) {
+        std::cerr << "usage: stream_gap_sim [--items <n>] [--item-ms <ms>] [--prepare-ms <ms>] "
+            "[--source-rtt-ms <ms>]" << std::endl;
+        return EXIT_FAILURE;
+    }
+    GapResult gapless = RunPlaylist(options, "AUDIO");
+    GapResult reload = RunPlaylist(options, "VIDEO");
+    if (!gapless.isDone || !reload.isDone) {
+        std::cerr << "the next item never started" << std::endl;
+        return EXIT_FAILURE;
+    }
+    // Only meaningful while an item plays longer than the standby takes to prepare, otherwise both reload.
+    bool isGaplessFaster = gapless.gaps.p99 < reload.gaps.p50;
+    json result = { { "items", options.items }, { "gapless", gapless.ToJson(options.items) },
+        { "reload", reload.ToJson(options.items) }, { "gapless_faster", isGaplessFaster } };
+    std::cout << result.dump(4) << std::endl;
+    return EXIT_SUCCESS;
+}
+} // namespace CastEngineService
+} // namespace CastEngine
+} // namespace OHOS
+
+int main(int argc, char *argv[])
+{
+    return OHOS::CastEngine::CastEngineService::RunStreamGapSim(argc, argv);
+}
@@ -0,0 +1,340 @@
+/*
+ * Copyright (C) 2023-2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * Description: two vtp connections on the loopback with netem like loss and jitter, reports delivery and latency as json.
+ * Author: zhangge
+ * Create: 2023-06-05
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "cast_engine_metrics.h"
+#include "json.hpp"
+#include "parameters.h"
+#include "vtp_connection.h"
+
+namespace OHOS {
+namespace CastEngine {
+namespace CastEngineService {
+namespace {
+using nlohmann::json;
+using Clock = std::chrono::steady_clock;
+
+constexpr int WAIT_TIMEOUT_MS = 5000;
+constexpr int HELLO_CHECK_MS = 300;
+constexpr char LOOPBACK_IP[] = "127.0.0.1";
+// Any other loopback address, the listener expects the peer there and has to ignore the HELLOs from LOOPBACK_IP.
+constexpr char OTHER_LOOPBACK_IP[] = "127.0.0.2";
+// Frame id and send time, the rest of the frame is a pattern derived from the id.
+constexpr size_t FRAME_HEADER_LEN = sizeof(uint32_t) + sizeof(int64_t);
+constexpr size_t KEY_FRAME_LEN = 60000;
+constexpr size_t MIN_FRAME_LEN = 200;
+constexpr size_t MAX_FRAME_EXTRA_LEN = 8000;
+constexpr int KEY_FRAME_INTERVAL = 30;
+constexpr int PERCENTILE_50 = 50;
+constexpr int PERCENTILE_99 = 99;
+constexpr int MAX_PERCENT = 100;
+
+struct LoopbackOptions {
+    int lossPercent{ 0 };
+    int jitterMs{ 0 };
+    int frames{ 600 };
+    int fps{ 60 };
+    // Fails the run when fewer frames arrive, 0 only checks that what arrives is intact and in order.
+    int minDeliveredPercent{ 0 };
+};
+
+int64_t NowUs()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(Clock::now().time_since_epoch()).count();
+}
+
+void PutUint(uint8_t *buf, uint64_t value, size_t length)
+{
+    for (size_t i = 0; i < length; i++) {
+        buf[i] = static_cast<uint8_t>(value >> (i * 8));
+    }
+}
+
+uint64_t GetUint(const uint8_t *buf, size_t length)
+{
+    uint64_t value = 0;
+    for (size_t i = 0; i < length; i++) {
+        value |= static_cast<uint64_t>(buf[i]) << (i * 8);
+    }
+    return value;
+}
+
+std::vector<uint8_t> MakeFrame(uint32_t id)
+{
+    size_t length = id % KEY_FRAME_INTERVAL == 0 ? KEY_FRAME_LEN : MIN_FRAME_LEN + (id * 7919) % MAX_FRAME_EXTRA_LEN;
+    std::vector<uint8_t> frame(length);
+    PutUint(frame.data(), id, sizeof(uint32_t));
+    PutUint(frame.data() + sizeof(uint32_t), static_cast<uint64_t>(NowUs()), sizeof(int64_t));
+    for (size_t i = FRAME_HEADER_LEN; i < length; i++) {
+        frame[i] = static_cast<uint8_t>(id + i);
+    }
+    return frame;
+}
+
+class OpenedConnectionListener : public ConnectionListener {
+public:
+    bool OnConnectionOpened(std::shared_ptr<Channel> channel) override
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        channel_ = channel;
+        cond_.notify_all();
+        return true;
+    }
+
+    std::shared_ptr<Channel> WaitChannel(int timeoutMs)
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cond_.wait_for(lock, std::chrono::milliseconds(timeoutMs), [this] { return channel_ != nullptr; });
+        return channel_;
+    }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable cond_;
+    std::shared_ptr<Channel> channel_;
+};
+
+// Checks every frame the sink delivers: intact, never older than the one before, and how late.
+class CheckingListener : public IChannelListener {
+public:
+    void OnDataReceived(const uint8_t *buffer, unsigned int length, long timeCost) override
+    {
+        int64_t now = NowUs();
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (length < FRAME_HEADER_LEN) {
+            corrupt_++;
+            return;
+        }
+        auto id = static_cast<uint32_t>(GetUint(buffer, sizeof(uint32_t)));
+        auto sentUs = static_cast<int64_t>(GetUint(buffer + sizeof(uint32_t), sizeof(int64_t)));
+        std::vector<uint8_t> expected = MakeFrame(id);
+        if (expected.size() != length || !std::equal(buffer + FRAME_HEADER_LEN, buffer + length,
+            expected.begin() + FRAME_HEADER_LEN)) {
+            corrupt_++;
+            return;
+        }
+        if (hasFrame_ && id <= lastId_) {
+            outOfOrder_++;
+        }
+        hasFrame_ = true;
+        lastId_ = id;
+        delivered_++;
+        latenciesUs_.push_back(now - sentUs);
+    }
+
+    json Report()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::sort(latenciesUs_.begin(), latenciesUs_.end());
+        auto percentile = [this](int percent) -> int64_t {
+            if (latenciesUs_.empty()) {
+                return 0;
+            }
+            return latenciesUs_[std::min(latenciesUs_.size() - 1, latenciesUs_.size() * percent / MAX_PERCENT)];
+        };
+        return {
+            { "delivered", delivered_ },
+            { "corrupt", corrupt_ },
+            { "out_of_order", outOfOrder_ },
+            { "latency_p50_us", percentile(PERCENTILE_50) },
+            { "latency_p99_us", percentile(PERCENTILE_99) },
+            { "latency_max_us", latenciesUs_.empty() ? 0 : latenciesUs_.back() },
+        };
+    }
+
+    uint64_t GetDelivered()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return delivered_;
+    }
+
+    bool IsIntact()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return corrupt_ == 0 && outOfOrder_ == 0;
+    }
+
+private:
+    std::mutex mutex_;
+    uint64_t delivered_{ 0 };
+    uint64_t corrupt_{ 0 };
+    uint64_t outOfOrder_{ 0 };
+    bool hasFrame_{ false };
+    uint32_t lastId_{ 0 };
+    std::vector<int64_t> latenciesUs_;
+};
+
+ChannelRequest MakeRequest(bool isReceiver, const std::string &remoteIp)
+{
+    ChannelRequest request;
+    request.moduleType = ModuleType::VIDEO;
+    request.linkType = ChannelLinkType::VTP;
+    request.isReceiver = isReceiver;
+    request.localDeviceInfo.ipAddress = LOOPBACK_IP;
+    request.remoteDeviceInfo.ipAddress = remoteIp;
+    return request;
+}
+
+// A listener that expects another device must not open for the HELLOs of this one.
+bool CheckForeignHelloRejected()
+{
+    auto &rejected = CastEngineMetrics::GetInstance().RegisterCounter(METRIC_VTP_HELLOS_REJECTED);
+    int64_t rejectedBefore = rejected.Value();
+    auto serverOpened = std::make_shared<OpenedConnectionListener>();
+    auto server = std::make_shared<VtpConnection>();
+    server->SetConnectionListener(serverOpened);
+    ChannelRequest request = MakeRequest(true, OTHER_LOOPBACK_IP);
+    int port = server->StartListen(request, std::make_shared<IChannelListener>());
+    if (port <= 0) {
+        return false;
+    }
+    request = MakeRequest(false, LOOPBACK_IP);
+    request.remotePort = port;
+    auto client = std::make_shared<VtpConnection>();
+    client->SetConnectionListener(std::make_shared<OpenedConnectionListener>());
+    client->StartConnection(request, std::make_shared<IChannelListener>());
+    bool isOpened = serverOpened->WaitChannel(HELLO_CHECK_MS) != nullptr;
+    client->CloseConnection();
+    server->CloseConnection();
+    return !isOpened && rejected.Value() > rejectedBefore;
+}
+
+int RunLoopback(const LoopbackOptions &options)
+{
+    // Read by the VtpFaultInjector of both connections, so the nacks suffer the same link as the media.
+    system::SetParameter("debug.cast.vtp.loss_percent", std::to_string(options.lossPercent));
+    system::SetParameter("debug.cast.vtp.jitter_ms", std::to_string(options.jitterMs));
+
+    json report;
+    report["loss_percent"] = options.lossPercent;
+    report["jitter_ms"] = options.jitterMs;
+    bool isHelloRejected = CheckForeignHelloRejected();
+    report["foreign_hello_rejected"] = isHelloRejected;
+
+    auto checker = std::make_shared<CheckingListener>();
+    auto serverOpened = std::make_shared<OpenedConnectionListener>();
+    auto clientOpened = std::make_shared<OpenedConnectionListener>();
+    auto server = std::make_shared<VtpConnection>();
+    auto client = std::make_shared<VtpConnection>();
+    server->SetConnectionListener(serverOpened);
+    client->SetConnectionListener(clientOpened);
+    ChannelRequest request = MakeRequest(true, LOOPBACK_IP);
+    int port = server->StartListen(request, checker);
+    request = MakeRequest(false, LOOPBACK_IP);
+    request.remotePort = port;
+    if (port > 0) {
+        client->StartConnection(request, std::make_shared<IChannelListener>());
+    }
+    auto channel = clientOpened->WaitChannel(WAIT_TIMEOUT_MS);
+    if (port <= 0 || channel == nullptr || serverOpened->WaitChannel(WAIT_TIMEOUT_MS) == nullptr) {
+        std::cerr << "vtp loopback not connected" << std::endl;
+        client->CloseConnection();
+        server->CloseConnection();
+        return EXIT_FAILURE;
+    }
+
+    auto interval = std::chrono::microseconds(std::chrono::seconds(1)) / options.fps;
+    auto start = Clock::now();
+    for (int i = 0; i < options.frames; i++) {
+        std::this_thread::sleep_until(start + interval * i);
+        std::vector<uint8_t> frame = MakeFrame(static_cast<uint32_t>(i));
+        channel->Send(frame.data(), static_cast<int>(frame.size()));
+    }
+    // Let the last frames and their repairs arrive, or expire.
+    auto deadline = Clock::now() + std::chrono::milliseconds(WAIT_TIMEOUT_MS);
+    uint64_t delivered = checker->GetDelivered();
+    while (Clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(HELLO_CHECK_MS));
+        uint64_t now = checker->GetDelivered();
+        if (now == delivered || now == static_cast<uint64_t>(options.frames)) {
+            break;
+        }
+        delivered = now;
+    }
+    client->CloseConnection();
+    server->CloseConnection();
+
+    auto &metrics = CastEngineMetrics::GetInstance();
+    report["frames"] = options.frames;
+    report["receiver"] = checker->Report();
+    report["vtp"] = {
+        { "retransmits", metrics.RegisterCounter(METRIC_VTP_RETRANSMITS).Value() },
+        { "nacks_sent", metrics.RegisterCounter(METRIC_VTP_NACKS_SENT).Value() },
+        { "fec_recovered", metrics.RegisterCounter(METRIC_VTP_FEC_RECOVERED).Value() },
+        { "frames_dropped", metrics.RegisterCounter(METRIC_VTP_FRAMES_DROPPED).Value() },
+    };
+    std::cout << report.dump(2) << std::endl;
+
+    uint64_t minDelivered = static_cast<uint64_t>(options.frames) * options.minDeliveredPercent / MAX_PERCENT;
+    return isHelloRejected && checker->IsIntact() && checker->GetDelivered() >= minDelivered ?
+        EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+bool ParseOptions(int argc, char *argv[], LoopbackOptions &options)
+{
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string arg = argv[i];
+        int value = std::atoi(argv[i + 1]);
+        if (arg == "--loss") {
+            options.lossPercent = value;
+        } else if (arg == "--jitter") {
+            options.jitterMs = value;
+        } else if (arg == "--frames") {
+            options.frames = value;
+        } else if (arg == "--fps") {
+            options.fps = value;
+        } else if (arg == "--min-delivered") {
+            options.minDeliveredPercent = value;
+        } else {
+            return false;
+        }
+    }
+    return argc % 2 == 1 && options.lossPercent >= 0 && options.lossPercent < MAX_PERCENT && options.jitterMs >= 0 &&
+        options.frames > 0 && options.fps > 0 && options.minDeliveredPercent >= 0 &&
+        options.minDeliveredPercent <= MAX_PERCENT;
+}
+} // namespace
+
+int RunVtpLoopback(int argc, char *argv[])
+{
+    LoopbackOptions options;
+    if (!ParseOptions(argc, argv, options)) {
+        std::cerr << "usage: vtp_loopback [--loss <percent>] [--jitter <ms>] [--frames <n>] [--fps <n>] "
+            "[--min-delivered <percent>]" << std::endl;
+        return EXIT_FAILURE;
+    }
+    return RunLoopback(options);
+}
+} // namespace CastEngineService
+} // namespace CastEngine
+} // namespace OHOS
+
+int main(int argc, char *argv[])
+{
+    return OHOS::CastEngine::CastEngineService::RunVtpLoopback(argc, argv);
+}